@@ -0,0 +1,413 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <windows.h>
+
+#include "CallStatistics.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Threading;
+
+namespace SlimDX
+{
+	struct CallSiteCounters
+	{
+		const char* Method;
+		__int64 Calls;
+		__int64 Failures;
+		__int64 Samples;
+		__int64 Histogram[CallStatistics::HistogramBuckets];
+	};
+
+	struct ResultCodeCounters
+	{
+		int Code;
+		bool Used;
+		__int64 Count;
+	};
+
+	ref class ThreadCallCounters sealed
+	{
+	private:
+		// both tables are open addressed and never shrink; the last method slot collects overflow
+		literal int MethodSlots = 2048;
+		literal int ResultSlots = 256;
+
+		CallSiteCounters* m_Methods;
+		ResultCodeCounters* m_Results;
+		Thread^ m_Owner;
+		__int64 m_PendingStart;
+		int m_Countdown;
+
+		CallSiteCounters& FindMethod( const char* method )
+		{
+			size_t hash = reinterpret_cast<size_t>( method ) * 2654435761u;
+			for( int probe = 0; probe < MethodSlots - 1; ++probe )
+			{
+				CallSiteCounters& slot = m_Methods[(hash + probe) % (MethodSlots - 1)];
+				if( slot.Method == method )
+					return slot;
+
+				if( slot.Method == 0 )
+				{
+					slot.Method = method;
+					return slot;
+				}
+			}
+
+			m_Methods[MethodSlots - 1].Method = "<other>";
+			return m_Methods[MethodSlots - 1];
+		}
+
+		void CountResult( int hr )
+		{
+			unsigned int hash = static_cast<unsigned int>( hr ) * 2654435761u;
+			for( int probe = 0; probe < ResultSlots; ++probe )
+			{
+				ResultCodeCounters& slot = m_Results[(hash + probe) & (ResultSlots - 1)];
+				if( !slot.Used )
+				{
+					slot.Code = hr;
+					slot.Used = true;
+				}
+
+				if( slot.Code == hr )
+				{
+					++slot.Count;
+					return;
+				}
+			}
+		}
+
+	public:
+		ThreadCallCounters()
+		{
+			// Manual Allocation: this is fine
+			m_Methods = new CallSiteCounters[MethodSlots];
+			m_Results = new ResultCodeCounters[ResultSlots];
+			memset( m_Methods, 0, MethodSlots * sizeof(CallSiteCounters) );
+			memset( m_Results, 0, ResultSlots * sizeof(ResultCodeCounters) );
+			GC::AddMemoryPressure( MethodSlots * sizeof(CallSiteCounters) + ResultSlots * sizeof(ResultCodeCounters) );
+
+			m_Owner = Thread::CurrentThread;
+		}
+
+		~ThreadCallCounters()
+		{
+			this->!ThreadCallCounters();
+		}
+
+		!ThreadCallCounters()
+		{
+			if( m_Methods != 0 )
+			{
+				delete[] m_Methods;
+				delete[] m_Results;
+				GC::RemoveMemoryPressure( MethodSlots * sizeof(CallSiteCounters) + ResultSlots * sizeof(ResultCodeCounters) );
+				m_Methods = 0;
+				m_Results = 0;
+			}
+		}
+
+		property bool IsOwnerAlive
+		{
+			bool get() { return m_Owner->IsAlive; }
+		}
+
+		void Mark( int interval )
+		{
+			// only the call that immediately follows a sampled mark is timed
+			m_PendingStart = 0;
+			if( --m_Countdown > 0 )
+				return;
+
+			m_Countdown = interval;
+
+			LARGE_INTEGER counter;
+			QueryPerformanceCounter( &counter );
+			m_PendingStart = counter.QuadPart;
+		}
+
+		void Record( const char* method, int hr, __int64 frequency )
+		{
+			CallSiteCounters& counters = FindMethod( method );
+			++counters.Calls;
+
+			if( hr < 0 )
+			{
+				++counters.Failures;
+				CountResult( hr );
+			}
+
+			if( m_PendingStart != 0 )
+			{
+				LARGE_INTEGER counter;
+				QueryPerformanceCounter( &counter );
+
+				// bucket n holds calls that took less than 2^n microseconds
+				__int64 micros = (counter.QuadPart - m_PendingStart) * 1000000 / frequency;
+				int bucket = 0;
+				while( micros > 0 && bucket < CallStatistics::HistogramBuckets - 1 )
+				{
+					micros >>= 1;
+					++bucket;
+				}
+
+				++counters.Samples;
+				++counters.Histogram[bucket];
+				m_PendingStart = 0;
+			}
+		}
+
+		void Collect( Dictionary<String^, array<Int64>^>^ methods, Dictionary<int, Int64>^ results )
+		{
+			for( int i = 0; i < MethodSlots; ++i )
+			{
+				CallSiteCounters& slot = m_Methods[i];
+				if( slot.Method == 0 || slot.Calls == 0 )
+					continue;
+
+				// __FUNCTION__ literals are not pooled across translation units, so merge by name
+				String^ name = gcnew String( slot.Method );
+				array<Int64>^ totals;
+				if( !methods->TryGetValue( name, totals ) )
+				{
+					totals = gcnew array<Int64>( 3 + CallStatistics::HistogramBuckets );
+					methods->Add( name, totals );
+				}
+
+				totals[0] += slot.Calls;
+				totals[1] += slot.Failures;
+				totals[2] += slot.Samples;
+				for( int bucket = 0; bucket < CallStatistics::HistogramBuckets; ++bucket )
+					totals[3 + bucket] += slot.Histogram[bucket];
+			}
+
+			for( int i = 0; i < ResultSlots; ++i )
+			{
+				ResultCodeCounters& slot = m_Results[i];
+				if( !slot.Used || slot.Count == 0 )
+					continue;
+
+				Int64 count;
+				results->TryGetValue( slot.Code, count );
+				results[slot.Code] = count + slot.Count;
+			}
+		}
+
+		void Reset()
+		{
+			// keep the keys so the owning thread never sees a slot vanish underneath it
+			for( int i = 0; i < MethodSlots; ++i )
+			{
+				CallSiteCounters& slot = m_Methods[i];
+				slot.Calls = slot.Failures = slot.Samples = 0;
+				memset( slot.Histogram, 0, sizeof(slot.Histogram) );
+			}
+
+			for( int i = 0; i < ResultSlots; ++i )
+				m_Results[i].Count = 0;
+		}
+	};
+
+	static __int64 s_Frequency;
+
+	static CallStatistics::CallStatistics()
+	{
+		s_Lock = gcnew Object();
+		s_Threads = gcnew List<ThreadCallCounters^>();
+		s_RetiredMethods = gcnew Dictionary<String^, array<Int64>^>();
+		s_RetiredResults = gcnew Dictionary<int, Int64>();
+		s_SampleInterval = 16;
+
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency( &frequency );
+		s_Frequency = frequency.QuadPart;
+	}
+
+	bool CallStatistics::IsAvailable::get()
+	{
+#ifdef SLIMDX_INSTRUMENTATION
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void CallStatistics::LatencySampleInterval::set( int value )
+	{
+		if( value < 1 )
+			throw gcnew ArgumentOutOfRangeException( "value" );
+
+		s_SampleInterval = value;
+	}
+
+	array<double>^ CallStatistics::LatencyBucketBounds::get()
+	{
+		array<double>^ bounds = gcnew array<double>( HistogramBuckets );
+		for( int bucket = 0; bucket < HistogramBuckets - 1; ++bucket )
+			bounds[bucket] = static_cast<double>( 1 << bucket );
+
+		bounds[HistogramBuckets - 1] = Double::PositiveInfinity;
+		return bounds;
+	}
+
+	ThreadCallCounters^ CallStatistics::GetCounters()
+	{
+		ThreadCallCounters^ counters = t_Counters;
+		if( counters == nullptr )
+		{
+			counters = gcnew ThreadCallCounters();
+			t_Counters = counters;
+
+			Monitor::Enter( s_Lock );
+			try
+			{
+				// thread churn would otherwise grow the list without bound if nobody ever reads the statistics
+				RetireDeadThreads();
+				s_Threads->Add( counters );
+			}
+			finally
+			{
+				Monitor::Exit( s_Lock );
+			}
+		}
+
+		return counters;
+	}
+
+	void CallStatistics::RetireDeadThreads()
+	{
+		// a thread that has exited can no longer touch its tables, so they can be folded and freed safely
+		for( int i = s_Threads->Count - 1; i >= 0; --i )
+		{
+			ThreadCallCounters^ counters = s_Threads[i];
+			if( counters->IsOwnerAlive )
+				continue;
+
+			counters->Collect( s_RetiredMethods, s_RetiredResults );
+			s_Threads->RemoveAt( i );
+			delete counters;
+		}
+	}
+
+	void CallStatistics::Collect( Dictionary<String^, array<Int64>^>^ methods, Dictionary<int, Int64>^ results )
+	{
+		RetireDeadThreads();
+
+		for each( KeyValuePair<String^, array<Int64>^> entry in s_RetiredMethods )
+			methods->Add( entry.Key, safe_cast<array<Int64>^>( entry.Value->Clone() ) );
+
+		for each( KeyValuePair<int, Int64> entry in s_RetiredResults )
+			results->Add( entry.Key, entry.Value );
+
+		for each( ThreadCallCounters^ counters in s_Threads )
+			counters->Collect( methods, results );
+	}
+
+	void CallStatistics::MarkCall()
+	{
+		if( !s_Enabled )
+			return;
+
+		GetCounters()->Mark( s_SampleInterval );
+	}
+
+	int CallStatistics::RecordCall( const char* method, int hr )
+	{
+		if( s_Enabled )
+			GetCounters()->Record( method, hr, s_Frequency );
+
+		return hr;
+	}
+
+	array<CallCounter>^ CallStatistics::GetCallCounters()
+	{
+		Dictionary<String^, array<Int64>^>^ methods = gcnew Dictionary<String^, array<Int64>^>();
+		Dictionary<int, Int64>^ results = gcnew Dictionary<int, Int64>();
+
+		Monitor::Enter( s_Lock );
+		try
+		{
+			Collect( methods, results );
+		}
+		finally
+		{
+			Monitor::Exit( s_Lock );
+		}
+
+		array<CallCounter>^ snapshot = gcnew array<CallCounter>( methods->Count );
+		int index = 0;
+		for each( KeyValuePair<String^, array<Int64>^> entry in methods )
+		{
+			array<Int64>^ totals = entry.Value;
+			array<Int64>^ histogram = gcnew array<Int64>( HistogramBuckets );
+			Array::Copy( totals, 3, histogram, 0, HistogramBuckets );
+
+			snapshot[index++] = CallCounter( entry.Key, totals[0], totals[1], totals[2], histogram );
+		}
+
+		return snapshot;
+	}
+
+	array<ResultCounter>^ CallStatistics::GetResultCounters()
+	{
+		Dictionary<String^, array<Int64>^>^ methods = gcnew Dictionary<String^, array<Int64>^>();
+		Dictionary<int, Int64>^ results = gcnew Dictionary<int, Int64>();
+
+		Monitor::Enter( s_Lock );
+		try
+		{
+			Collect( methods, results );
+		}
+		finally
+		{
+			Monitor::Exit( s_Lock );
+		}
+
+		array<ResultCounter>^ snapshot = gcnew array<ResultCounter>( results->Count );
+		int index = 0;
+		for each( KeyValuePair<int, Int64> entry in results )
+			snapshot[index++] = ResultCounter( Result( entry.Key ), entry.Value );
+
+		return snapshot;
+	}
+
+	void CallStatistics::Reset()
+	{
+		Monitor::Enter( s_Lock );
+		try
+		{
+			for each( ThreadCallCounters^ counters in s_Threads )
+				counters->Reset();
+
+			s_RetiredMethods->Clear();
+			s_RetiredResults->Clear();
+		}
+		finally
+		{
+			Monitor::Exit( s_Lock );
+		}
+	}
+}
@@ -0,0 +1,215 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "Result.h"
+
+namespace SlimDX
+{
+	/// <summary>
+	/// Call statistics for a single wrapper method.
+	/// </summary>
+	/// <unmanaged>None</unmanaged>
+	public value class CallCounter
+	{
+	internal:
+		CallCounter( System::String^ method, System::Int64 calls, System::Int64 failures, System::Int64 samples, array<System::Int64>^ histogram )
+		: m_Method( method ), m_Calls( calls ), m_Failures( failures ), m_Samples( samples ), m_Histogram( histogram )
+		{
+		}
+
+	private:
+		System::String^ m_Method;
+		System::Int64 m_Calls;
+		System::Int64 m_Failures;
+		System::Int64 m_Samples;
+		array<System::Int64>^ m_Histogram;
+
+	public:
+		/// <summary>
+		/// Gets the fully qualified name of the wrapper method.
+		/// </summary>
+		property System::String^ Method
+		{
+			System::String^ get() { return m_Method; }
+		}
+
+		/// <summary>
+		/// Gets the number of times the method called into native code.
+		/// </summary>
+		property System::Int64 Calls
+		{
+			System::Int64 get() { return m_Calls; }
+		}
+
+		/// <summary>
+		/// Gets the number of calls that returned a failure code.
+		/// </summary>
+		property System::Int64 Failures
+		{
+			System::Int64 get() { return m_Failures; }
+		}
+
+		/// <summary>
+		/// Gets the number of calls whose latency was sampled.
+		/// </summary>
+		property System::Int64 LatencySamples
+		{
+			System::Int64 get() { return m_Samples; }
+		}
+
+		/// <summary>
+		/// Gets the number of sampled calls in each latency bucket. The upper bound of each bucket is given by
+		/// <see cref="CallStatistics::LatencyBucketBounds"/>.
+		/// </summary>
+		property array<System::Int64>^ LatencyHistogram
+		{
+			array<System::Int64>^ get() { return m_Histogram; }
+		}
+	};
+
+	/// <summary>
+	/// The number of times a particular failure code was returned by wrapper methods.
+	/// </summary>
+	/// <unmanaged>None</unmanaged>
+	public value class ResultCounter
+	{
+	internal:
+		ResultCounter( SlimDX::Result result, System::Int64 count )
+		: m_Result( result ), m_Count( count )
+		{
+		}
+
+	private:
+		SlimDX::Result m_Result;
+		System::Int64 m_Count;
+
+	public:
+		/// <summary>
+		/// Gets the failure code.
+		/// </summary>
+		property SlimDX::Result Result
+		{
+			SlimDX::Result get() { return m_Result; }
+		}
+
+		/// <summary>
+		/// Gets the number of times the code was returned.
+		/// </summary>
+		property System::Int64 Count
+		{
+			System::Int64 get() { return m_Count; }
+		}
+	};
+
+	ref class ThreadCallCounters;
+
+	/// <summary>
+	/// Collects per-method call counts, failure codes and sampled latencies for calls made through the wrapper layer.
+	/// </summary>
+	/// <remarks>
+	/// Statistics are only gathered when SlimDX is built with SLIMDX_INSTRUMENTATION defined; otherwise
+	/// <see cref="IsAvailable"/> is <c>false</c> and the hooks compile to nothing. Each thread counts into
+	/// its own tables without locking, so snapshots taken while other threads are making calls are approximate.
+	/// The tables of threads that have exited are folded into a shared total and freed the next time
+	/// statistics are gathered or a new thread starts counting.
+	/// Latency is measured from the wrapper's access to its native interface pointer until the result is recorded.
+	/// </remarks>
+	/// <unmanaged>None</unmanaged>
+	public ref class CallStatistics sealed
+	{
+	private:
+		static CallStatistics();
+		CallStatistics() { }
+
+		static System::Object^ s_Lock;
+		static System::Collections::Generic::List<ThreadCallCounters^>^ s_Threads;
+		static System::Collections::Generic::Dictionary<System::String^, array<System::Int64>^>^ s_RetiredMethods;
+		static System::Collections::Generic::Dictionary<int, System::Int64>^ s_RetiredResults;
+		static int s_SampleInterval;
+
+		[System::ThreadStatic]
+		static ThreadCallCounters^ t_Counters;
+
+		static ThreadCallCounters^ GetCounters();
+		static void RetireDeadThreads();
+		static void Collect( System::Collections::Generic::Dictionary<System::String^, array<System::Int64>^>^ methods, System::Collections::Generic::Dictionary<int, System::Int64>^ results );
+
+	internal:
+		literal int HistogramBuckets = 20;
+		static bool s_Enabled;
+
+		static void MarkCall();
+		static int RecordCall( const char* method, int hr );
+
+	public:
+		/// <summary>
+		/// Gets a value indicating whether call statistics were compiled into this build.
+		/// </summary>
+		static property bool IsAvailable
+		{
+			bool get();
+		}
+
+		/// <summary>
+		/// Gets or sets a value indicating whether calls are currently being counted.
+		/// </summary>
+		static property bool Enabled
+		{
+			bool get() { return s_Enabled; }
+			void set( bool value ) { s_Enabled = value; }
+		}
+
+		/// <summary>
+		/// Gets or sets how often call latency is sampled; one call in every <c>n</c> is timed.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">The value is less than 1.</exception>
+		static property int LatencySampleInterval
+		{
+			int get() { return s_SampleInterval; }
+			void set( int value );
+		}
+
+		/// <summary>
+		/// Gets the upper bound, in microseconds, of each bucket in <see cref="CallCounter::LatencyHistogram"/>.
+		/// </summary>
+		static property array<double>^ LatencyBucketBounds
+		{
+			array<double>^ get();
+		}
+
+		/// <summary>
+		/// Gets a snapshot of the call counters of every method that has been called, summed across threads.
+		/// </summary>
+		static array<CallCounter>^ GetCallCounters();
+
+		/// <summary>
+		/// Gets a snapshot of the number of times each failure code was returned, summed across threads.
+		/// </summary>
+		static array<ResultCounter>^ GetResultCounters();
+
+		/// <summary>
+		/// Resets all counters to zero.
+		/// </summary>
+		static void Reset();
+	};
+}
@@ -27,7 +27,7 @@
 #define COMOBJECT_BASE(nativeType) \
 	public: \
 		static property System::Guid NativeInterface { System::Guid get() { return Utilities::ConvertNativeGuid( IID_ ## nativeType ); } } \
-		property nativeType* InternalPointer { nativeType* get() new { return static_cast<nativeType*>( UnknownPointer ); } } \
+		property nativeType* InternalPointer { nativeType* get() new { SLIMDX_INSTRUMENT_CALL(); return static_cast<nativeType*>( UnknownPointer ); } } \
 	private:
 
 // This macro provides the basic infrastructure for SlimDX ComObject subclasses. 
@@ -26,6 +26,7 @@
 #include <stdexcept>
 
 #include "DataStream.h"
+#include "DataView.h"
 #include "Utilities.h"
 #include "InternalHelpers.h"
 
@@ -102,6 +103,22 @@ namespace SlimDX
 			GC::SuppressFinalize( this );
 	}
 	
+	DataStream::DataStream( void* buffer, Int64 sizeInBytes, bool canRead, bool canWrite, IDisposable^ owner )
+	{
+		if( sizeInBytes < 1 )
+			throw gcnew ArgumentOutOfRangeException( "sizeInBytes" );
+
+		m_Buffer = static_cast<char*>( buffer );
+		m_Size = sizeInBytes;
+
+		m_CanRead = canRead;
+		m_CanWrite = canWrite;
+
+		// The owner releases the memory; it has its own finalizer if we are never disposed.
+		m_Owner = owner;
+		GC::SuppressFinalize( this );
+	}
+
 	DataStream::DataStream( Int64 sizeInBytes, bool canRead, bool canWrite )
 	{
 		if( sizeInBytes < 1 )
@@ -158,6 +175,24 @@ namespace SlimDX
 		GC::SuppressFinalize( this );
 	}
 
+	DataStream::DataStream( DataStream^ parent, Int64 offset, Int64 sizeInBytes, bool canRead, bool canWrite )
+	{
+		// Views always hang off the stream that actually owns the memory, so that
+		// slicing a slice doesn't build up a chain of parents.
+		char* buffer = parent->m_Buffer + offset;
+		if( parent->m_Parent != nullptr )
+			parent = parent->m_Parent;
+
+		parent->AddView();
+
+		m_Parent = parent;
+		m_Buffer = buffer;
+		m_Size = sizeInBytes;
+
+		m_CanRead = canRead;
+		m_CanWrite = canWrite;
+	}
+
 	DataStream::~DataStream()
 	{
 		Destruct();
@@ -170,6 +205,26 @@ namespace SlimDX
 	}
 
 	void DataStream::Destruct()
+	{
+		if( m_Parent != nullptr )
+		{
+			m_Parent->ReleaseView();
+			m_Parent = nullptr;
+			m_Buffer = 0;
+			return;
+		}
+
+		// The stream holds one reference on its memory and each open view holds another. Dropping ours takes the
+		// count below zero only if no views are left; otherwise the last view to close finishes the job.
+		if( Threading::Interlocked::Exchange( m_Destructed, 1 ) != 0 )
+			return;
+		if( Threading::Interlocked::Decrement( m_ViewCount ) >= 0 )
+			return;
+
+		ReleaseMemory();
+	}
+
+	void DataStream::ReleaseMemory()
 	{
 		if(m_OwnsBuffer)
 		{
@@ -188,10 +243,71 @@ namespace SlimDX
 		{
 			m_GCHandle.Free();
 		}
+
+		if( m_Owner != nullptr )
+		{
+			delete m_Owner;
+			m_Owner = nullptr;
+		}
 		
 		m_Buffer = 0;
 	}
 
+	void DataStream::AddView()
+	{
+		Threading::Interlocked::Increment( m_ViewCount );
+	}
+
+	void DataStream::ReleaseView()
+	{
+		if( Threading::Interlocked::Decrement( m_ViewCount ) < 0 )
+			ReleaseMemory();
+	}
+
+	DataStream^ DataStream::Slice( Int64 offset, Int64 sizeInBytes )
+	{
+		if( m_Buffer == 0 || m_Destructed != 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( offset < 0 )
+			throw gcnew ArgumentOutOfRangeException( "offset" );
+		if( sizeInBytes < 0 )
+			throw gcnew ArgumentOutOfRangeException( "sizeInBytes" );
+		if( offset + sizeInBytes > m_Size )
+			throw gcnew ArgumentException( "The sum of offset and sizeInBytes is greater than the stream length." );
+
+		return gcnew DataStream( this, offset, sizeInBytes, m_CanRead, m_CanWrite );
+	}
+
+	void DataStream::Retarget( const void* buffer, Int64 sizeInBytes )
+	{
+		// only borrowed streams can be pointed somewhere else; anything we'd have to free stays put
+		if( m_OwnsBuffer || m_Owner != nullptr || m_Parent != nullptr || m_ID3DXBuffer != 0 || m_GCHandle.IsAllocated )
+			throw gcnew InvalidOperationException( "Only streams over borrowed memory can be retargeted." );
+		if( sizeInBytes < 1 )
+			throw gcnew ArgumentOutOfRangeException( "sizeInBytes" );
+
+		m_Buffer = static_cast<char*>( const_cast<void*>( buffer ) );
+		m_Size = sizeInBytes;
+		m_Position = 0;
+	}
+
+	DataStream^ DataStream::AsReadOnly()
+	{
+		if( m_Buffer == 0 || m_Destructed != 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		return gcnew DataStream( this, 0, m_Size, m_CanRead, false );
+	}
+
+	generic<typename T> where T : value class
+	DataView<T>^ DataStream::CreateView( Int64 offset, int count )
+	{
+		if( count < 0 )
+			throw gcnew ArgumentOutOfRangeException( "count" );
+
+		return gcnew DataView<T>( Slice( offset, static_cast<Int64>( sizeof(T) ) * count ) );
+	}
+
 	char* DataStream::RawPointer::get()
 	{
 		return m_Buffer;
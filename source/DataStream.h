@@ -29,11 +29,15 @@ using System::ArgumentException;
 using System::ArgumentNullException;
 using System::ArgumentOutOfRangeException;
 using System::NotSupportedException;
+using System::ObjectDisposedException;
 using System::IO::EndOfStreamException;
 #endif
 
 namespace SlimDX
 {
+	generic<typename T> where T : value class
+	ref class DataView;
+
 	/// <summary>
 	/// Provides a stream interface to a buffer located in unmanaged memory.
 	/// </summary>
@@ -53,10 +57,22 @@ namespace SlimDX
 
 		System::Runtime::InteropServices::GCHandle m_GCHandle;
 
+		System::IDisposable^ m_Owner;
+
+		DataStream^ m_Parent;
+		int m_ViewCount;
+		int m_Destructed;
+
+		void AddView();
+		void ReleaseView();
+		void ReleaseMemory();
+
 	internal:
 		DataStream( ID3DXBuffer *buffer );
+		DataStream( DataStream^ parent, System::Int64 offset, System::Int64 sizeInBytes, bool canRead, bool canWrite );
 		DataStream( void* buffer, System::Int64 sizeInBytes, bool canRead, bool canWrite, bool makeCopy );
 		DataStream( const void *buffer, System::Int64 sizeInBytes, bool canRead, bool makeCopy );
+		DataStream( void* buffer, System::Int64 sizeInBytes, bool canRead, bool canWrite, System::IDisposable^ owner );
 
 		property char* RawPointer
 		{
@@ -73,7 +89,13 @@ namespace SlimDX
 			System::Int64 get();
 		}
 
+		property bool IsDisposed
+		{
+			bool get() { return m_Buffer == 0 || m_Destructed != 0; }
+		}
+
 		char* SeekToEnd();
+		void Retarget( const void* buffer, System::Int64 sizeInBytes );
 
 		ID3DXBuffer* GetD3DBuffer();
 		void Destruct();
@@ -121,6 +143,41 @@ namespace SlimDX
 		/// <exception cref="InvalidOperationException">Attempted to seek outside of the bounds of the stream.</exception>
 		virtual System::Int64 Seek( System::Int64 offset, System::IO::SeekOrigin origin ) override;
 
+		/// <summary>
+		/// Creates a new stream that shares a range of the current stream's backing store without copying it.
+		/// </summary>
+		/// <remarks>
+		/// The slice keeps the backing store alive; disposing the current stream while slices are still open
+		/// defers the release of the buffer until the last slice is disposed.
+		/// </remarks>
+		/// <param name="offset">The byte offset within the current stream at which the slice begins.</param>
+		/// <param name="sizeInBytes">The size of the slice, in bytes.</param>
+		/// <returns>A stream over the requested range, with the same read and write permissions as the current stream.</returns>
+		/// <exception cref="ObjectDisposedException">The stream has been disposed.</exception>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="offset" /> or <paramref name="sizeInBytes" /> is negative.</exception>
+		/// <exception cref="ArgumentException">The sum of <paramref name="offset" /> and <paramref name="sizeInBytes" /> is greater than the stream length.</exception>
+		DataStream^ Slice( System::Int64 offset, System::Int64 sizeInBytes );
+
+		/// <summary>
+		/// Creates a read-only stream that shares the current stream's backing store without copying it.
+		/// </summary>
+		/// <returns>A read-only stream over the entire contents of the current stream.</returns>
+		/// <exception cref="ObjectDisposedException">The stream has been disposed.</exception>
+		DataStream^ AsReadOnly();
+
+		/// <summary>
+		/// Creates a typed view over a range of elements in the current stream's backing store without copying it.
+		/// </summary>
+		/// <typeparam name="T">The type of the elements in the view.</typeparam>
+		/// <param name="offset">The byte offset within the current stream at which the first element begins.</param>
+		/// <param name="count">The number of elements in the view.</param>
+		/// <returns>A view over the requested elements.</returns>
+		/// <exception cref="ObjectDisposedException">The stream has been disposed.</exception>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="offset" /> or <paramref name="count" /> is negative.</exception>
+		/// <exception cref="ArgumentException">The requested elements extend past the end of the stream.</exception>
+		generic<typename T> where T : value class
+		DataView<T>^ CreateView( System::Int64 offset, int count );
+
 		/// <summary>
 		/// Writes a single value to the stream, and advances the current position
 		/// within this stream by the number of bytes written.
@@ -0,0 +1,115 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "DataStream.h"
+#include "DataView.h"
+#include "Utilities.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+	generic<typename T> where T : value class
+	DataView<T>::DataView( DataStream^ stream )
+	: m_Stream( stream )
+	{
+		m_Count = static_cast<int>( stream->Length / sizeof(T) );
+	}
+
+	generic<typename T> where T : value class
+	DataView<T>::~DataView()
+	{
+		delete m_Stream;
+	}
+
+	generic<typename T> where T : value class
+	void DataView<T>::CheckRange( int index, int count )
+	{
+		if( index < 0 || index > m_Count )
+			throw gcnew ArgumentOutOfRangeException( "index" );
+		if( count < 0 || index + count > m_Count )
+			throw gcnew ArgumentOutOfRangeException( "count" );
+	}
+
+	generic<typename T> where T : value class
+	void DataView<T>::CopyTo( int index, array<T>^ destination, int destinationIndex, int count )
+	{
+		if( m_Stream->IsDisposed )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( !m_Stream->CanRead )
+			throw gcnew NotSupportedException();
+
+		Utilities::CheckArrayBounds( destination, destinationIndex, count );
+		CheckRange( index, count );
+		if( count == 0 )
+			return;
+
+		pin_ptr<T> pinnedDestination = &destination[destinationIndex];
+		memcpy( pinnedDestination, m_Stream->RawPointer + static_cast<size_t>( index ) * sizeof(T), sizeof(T) * count );
+	}
+
+	generic<typename T> where T : value class
+	void DataView<T>::CopyFrom( array<T>^ source, int sourceIndex, int index, int count )
+	{
+		if( m_Stream->IsDisposed )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( !m_Stream->CanWrite )
+			throw gcnew NotSupportedException();
+
+		Utilities::CheckArrayBounds( source, sourceIndex, count );
+		CheckRange( index, count );
+		if( count == 0 )
+			return;
+
+		pin_ptr<T> pinnedSource = &source[sourceIndex];
+		memcpy( m_Stream->RawPointer + static_cast<size_t>( index ) * sizeof(T), pinnedSource, sizeof(T) * count );
+	}
+
+	generic<typename T> where T : value class
+	T DataView<T>::default::get( int index )
+	{
+		if( m_Stream->IsDisposed )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( !m_Stream->CanRead )
+			throw gcnew NotSupportedException();
+		if( index < 0 || index >= m_Count )
+			throw gcnew ArgumentOutOfRangeException( "index" );
+
+		T result;
+		memcpy( &result, m_Stream->RawPointer + static_cast<size_t>( index ) * sizeof(T), sizeof(T) );
+		return result;
+	}
+
+	generic<typename T> where T : value class
+	void DataView<T>::default::set( int index, T value )
+	{
+		if( m_Stream->IsDisposed )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( !m_Stream->CanWrite )
+			throw gcnew NotSupportedException();
+		if( index < 0 || index >= m_Count )
+			throw gcnew ArgumentOutOfRangeException( "index" );
+
+		memcpy( m_Stream->RawPointer + static_cast<size_t>( index ) * sizeof(T), &value, sizeof(T) );
+	}
+}
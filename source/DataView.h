@@ -0,0 +1,108 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#ifdef XMLDOCS
+using System::ArgumentNullException;
+using System::ArgumentOutOfRangeException;
+using System::NotSupportedException;
+#endif
+
+namespace SlimDX
+{
+	ref class DataStream;
+
+	/// <summary>
+	/// Provides typed, indexed access to a range of elements stored in a <see cref="SlimDX::DataStream"/>
+	/// without copying them.
+	/// </summary>
+	/// <typeparam name="T">The type of the elements in the view.</typeparam>
+	/// <unmanaged>None</unmanaged>
+	generic<typename T> where T : value class
+	public ref class DataView : System::IDisposable
+	{
+	private:
+		DataStream^ m_Stream;
+		int m_Count;
+
+		void CheckRange( int index, int count );
+
+	internal:
+		DataView( DataStream^ stream );
+
+	public:
+		/// <summary>
+		/// Releases all resources used by the <see cref="DataView{T}"/>.
+		/// </summary>
+		~DataView();
+
+		/// <summary>
+		/// Copies a range of elements from the view into an array.
+		/// </summary>
+		/// <param name="index">The index of the first element in the view to copy.</param>
+		/// <param name="destination">The array that receives the elements.</param>
+		/// <param name="destinationIndex">The index in <paramref name="destination"/> at which to begin storing elements.</param>
+		/// <param name="count">The number of elements to copy. If this is zero, the rest of <paramref name="destination"/> is filled.</param>
+		/// <exception cref="ArgumentNullException"><paramref name="destination" /> is a null reference.</exception>
+		/// <exception cref="ArgumentOutOfRangeException">The requested range lies outside the view.</exception>
+		void CopyTo( int index, array<T>^ destination, int destinationIndex, int count );
+
+		/// <summary>
+		/// Copies a range of elements from an array into the view.
+		/// </summary>
+		/// <param name="source">The array that provides the elements.</param>
+		/// <param name="sourceIndex">The index in <paramref name="source"/> of the first element to copy.</param>
+		/// <param name="index">The index in the view at which to begin storing elements.</param>
+		/// <param name="count">The number of elements to copy. If this is zero, the rest of <paramref name="source"/> is copied.</param>
+		/// <exception cref="NotSupportedException">The underlying stream does not support writing.</exception>
+		/// <exception cref="ArgumentNullException"><paramref name="source" /> is a null reference.</exception>
+		/// <exception cref="ArgumentOutOfRangeException">The requested range lies outside the view.</exception>
+		void CopyFrom( array<T>^ source, int sourceIndex, int index, int count );
+
+		/// <summary>
+		/// Gets or sets the element at the specified index.
+		/// </summary>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="index" /> lies outside the view.</exception>
+		/// <exception cref="NotSupportedException">The underlying stream does not support writing.</exception>
+		property T default[int]
+		{
+			T get( int index );
+			void set( int index, T value );
+		}
+
+		/// <summary>
+		/// Gets the number of elements in the view.
+		/// </summary>
+		property int Count
+		{
+			int get() { return m_Count; }
+		}
+
+		/// <summary>
+		/// Gets the stream containing the elements of the view.
+		/// </summary>
+		property DataStream^ Stream
+		{
+			DataStream^ get() { return m_Stream; }
+		}
+	};
+}
@@ -44,6 +44,22 @@ namespace SlimDX
 		DoNotAllowProfiling = 1,
 	};
 
+	/// <summary>
+	/// Specifies the file format used when saving recorded performance events.
+	/// </summary>
+	public enum class PerformanceTraceFormat : System::Int32
+	{
+		/// <summary>
+		/// Chrome trace-event JSON, which can be opened by chrome://tracing and compatible viewers.
+		/// </summary>
+		ChromeJson = 0,
+
+		/// <summary>
+		/// A compact binary format containing the raw timestamped records and a table of event names.
+		/// </summary>
+		Binary = 1,
+	};
+
 	/// <summary>
 	/// Specifies possible behaviors of result watches.
 	/// </summary>
@@ -65,4 +81,21 @@ namespace SlimDX
 		/// </summary>
 		Throw = 2,
 	};
+
+	/// <summary>
+	/// Specifies how many threads may produce data for a <see cref="RingStream"/> at the same time.
+	/// </summary>
+	public enum class RingStreamMode : System::Int32
+	{
+		/// <summary>
+		/// A single thread writes to the stream. Reservations are made without atomic read-modify-write operations.
+		/// </summary>
+		SingleProducer = 0,
+
+		/// <summary>
+		/// Any number of threads may write to the stream. Reservations are claimed atomically and
+		/// published in the order they were made.
+		/// </summary>
+		MultipleProducer = 1,
+	};
 }
\ No newline at end of file
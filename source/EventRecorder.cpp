@@ -0,0 +1,444 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <windows.h>
+#include <vector>
+
+#include "EventRecorder.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Globalization;
+using namespace System::IO;
+using namespace System::Text;
+using namespace System::Threading;
+
+namespace SlimDX
+{
+	ThreadEventBuffer::ThreadEventBuffer( int capacity )
+	{
+		// Manual Allocation: this is fine
+		m_Records = new EventRecord[capacity];
+		m_Mask = capacity - 1;
+		GC::AddMemoryPressure( capacity * sizeof(EventRecord) );
+
+		m_Owner = Thread::CurrentThread;
+		ThreadId = m_Owner->ManagedThreadId;
+		ThreadName = m_Owner->Name;
+		NameCache = gcnew Dictionary<String^, int>();
+	}
+
+	ThreadEventBuffer::~ThreadEventBuffer()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	ThreadEventBuffer::!ThreadEventBuffer()
+	{
+		Destruct();
+	}
+
+	void ThreadEventBuffer::Destruct()
+	{
+		if( m_Records != 0 )
+		{
+			delete[] m_Records;
+			GC::RemoveMemoryPressure( (m_Mask + 1) * sizeof(EventRecord) );
+			m_Records = 0;
+		}
+	}
+
+	int ThreadEventBuffer::Record( EventRecordType type, int nameId, int color )
+	{
+		if( type == EventRecordEnd && m_Depth > 0 )
+			--m_Depth;
+
+		Int64 index = m_Written;
+		EventRecord& record = m_Records[index & m_Mask];
+
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter( &counter );
+
+		record.Timestamp = counter.QuadPart;
+		record.NameId = nameId;
+		record.Color = color;
+		record.Depth = static_cast<short>( m_Depth );
+		record.Type = static_cast<unsigned char>( type );
+		record.Reserved = 0;
+
+		// publish the record; the interlocked write keeps the counter atomic on 32-bit platforms
+		Interlocked::Exchange( m_Written, index + 1 );
+
+		int depth = m_Depth;
+		if( type == EventRecordBegin )
+			++m_Depth;
+
+		return depth;
+	}
+
+	void ThreadEventBuffer::Snapshot( std::vector<EventRecord>& records )
+	{
+		Int64 capacity = m_Mask + 1;
+		Int64 end = Interlocked::Read( m_Written );
+		Int64 start = Math::Max( Interlocked::Read( m_ClearedAt ), end - capacity );
+
+		size_t first = records.size();
+		for( Int64 index = start; index < end; ++index )
+			records.push_back( m_Records[index & m_Mask] );
+
+		// anything the owner lapped while we were copying is garbage; drop it, along with the slot
+		// the owner may be filling right now, which is the oldest one once the ring is full
+		Int64 overwritten = Interlocked::Read( m_Written ) - capacity + 1;
+		if( overwritten > start )
+		{
+			size_t skip = static_cast<size_t>( Math::Min( overwritten, end ) - start );
+			records.erase( records.begin() + first, records.begin() + first + skip );
+		}
+	}
+
+	void ThreadEventBuffer::Clear()
+	{
+		Interlocked::Exchange( m_ClearedAt, Interlocked::Read( m_Written ) );
+	}
+
+	bool ThreadEventBuffer::IsEmpty::get()
+	{
+		return Interlocked::Read( m_Written ) == Interlocked::Read( m_ClearedAt );
+	}
+
+	static EventRecorder::EventRecorder()
+	{
+		s_Lock = gcnew Object();
+		s_Buffers = gcnew List<ThreadEventBuffer^>();
+		s_NameIds = gcnew Dictionary<String^, int>();
+		s_Names = gcnew List<String^>();
+	}
+
+	ThreadEventBuffer^ EventRecorder::GetBuffer()
+	{
+		ThreadEventBuffer^ buffer = t_Buffer;
+		if( buffer != nullptr && t_Generation == s_Generation )
+			return buffer;
+
+		Monitor::Enter( s_Lock );
+		try
+		{
+			// thread churn would otherwise grow the list without bound
+			RetireDeadThreads();
+
+			buffer = gcnew ThreadEventBuffer( s_Capacity );
+			s_Buffers->Add( buffer );
+			t_Generation = s_Generation;
+		}
+		finally
+		{
+			Monitor::Exit( s_Lock );
+		}
+
+		t_Buffer = buffer;
+		return buffer;
+	}
+
+	int EventRecorder::GetNameId( ThreadEventBuffer^ buffer, String^ name )
+	{
+		if( name == nullptr )
+			name = String::Empty;
+
+		int id;
+		if( buffer->NameCache->TryGetValue( name, id ) )
+			return id;
+
+		Monitor::Enter( s_Lock );
+		try
+		{
+			if( !s_NameIds->TryGetValue( name, id ) )
+			{
+				id = s_Names->Count;
+				s_Names->Add( name );
+				s_NameIds->Add( name, id );
+			}
+		}
+		finally
+		{
+			Monitor::Exit( s_Lock );
+		}
+
+		buffer->NameCache->Add( name, id );
+		return id;
+	}
+
+	void EventRecorder::Start( int eventsPerThread )
+	{
+		if( eventsPerThread < 1 || eventsPerThread > (1 << 24) )
+			throw gcnew ArgumentOutOfRangeException( "eventsPerThread" );
+
+		int capacity = 1;
+		while( capacity < eventsPerThread )
+			capacity <<= 1;
+
+		Monitor::Enter( s_Lock );
+		try
+		{
+			// Threads pick up a new buffer on their next event. Old buffers are not freed here
+			// since their owners may be writing to them; the GC reclaims them once dropped.
+			if( capacity != s_Capacity )
+			{
+				s_Capacity = capacity;
+				s_Buffers->Clear();
+				++s_Generation;
+			}
+
+			LARGE_INTEGER counter;
+			QueryPerformanceCounter( &counter );
+			if( s_Frequency == 0 )
+			{
+				LARGE_INTEGER frequency;
+				QueryPerformanceFrequency( &frequency );
+				s_Frequency = frequency.QuadPart;
+				s_Epoch = counter.QuadPart;
+			}
+
+			Enabled = true;
+		}
+		finally
+		{
+			Monitor::Exit( s_Lock );
+		}
+	}
+
+	void EventRecorder::Stop()
+	{
+		Enabled = false;
+	}
+
+	void EventRecorder::Clear()
+	{
+		Monitor::Enter( s_Lock );
+		try
+		{
+			for each( ThreadEventBuffer^ buffer in s_Buffers )
+				buffer->Clear();
+
+			RetireDeadThreads();
+		}
+		finally
+		{
+			Monitor::Exit( s_Lock );
+		}
+	}
+
+	void EventRecorder::RetireDeadThreads()
+	{
+		// a thread that has exited can no longer write to its buffer, so once nothing it recorded
+		// is left to save the buffer can be freed; buffers still holding events wait for the next Clear
+		for( int i = s_Buffers->Count - 1; i >= 0; --i )
+		{
+			ThreadEventBuffer^ buffer = s_Buffers[i];
+			if( buffer->IsOwnerAlive || !buffer->IsEmpty )
+				continue;
+
+			s_Buffers->RemoveAt( i );
+			delete buffer;
+		}
+	}
+
+	int EventRecorder::Begin( int color, String^ name )
+	{
+		ThreadEventBuffer^ buffer = GetBuffer();
+		return buffer->Record( EventRecordBegin, GetNameId( buffer, name ), color );
+	}
+
+	int EventRecorder::End()
+	{
+		return GetBuffer()->Record( EventRecordEnd, -1, 0 );
+	}
+
+	void EventRecorder::Marker( int color, String^ name )
+	{
+		ThreadEventBuffer^ buffer = GetBuffer();
+		buffer->Record( EventRecordMarker, GetNameId( buffer, name ), color );
+	}
+
+	int EventRecorder::CurrentDepth()
+	{
+		ThreadEventBuffer^ buffer = t_Buffer;
+		if( buffer == nullptr || t_Generation != s_Generation )
+			return 0;
+
+		return buffer->Depth;
+	}
+
+	void EventRecorder::Save( Stream^ stream, PerformanceTraceFormat format )
+	{
+		if( stream == nullptr )
+			throw gcnew ArgumentNullException( "stream" );
+		if( !stream->CanWrite )
+			throw gcnew NotSupportedException();
+
+		if( format == PerformanceTraceFormat::Binary )
+			WriteBinaryTrace( stream );
+		else
+			WriteChromeTrace( stream );
+	}
+
+	void EventRecorder::WriteJsonString( TextWriter^ writer, String^ value )
+	{
+		writer->Write( L'"' );
+		for each( wchar_t c in value )
+		{
+			switch( c )
+			{
+			case L'"': writer->Write( "\\\"" ); break;
+			case L'\\': writer->Write( "\\\\" ); break;
+			case L'\n': writer->Write( "\\n" ); break;
+			case L'\r': writer->Write( "\\r" ); break;
+			case L'\t': writer->Write( "\\t" ); break;
+			default:
+				if( c < 0x20 )
+					writer->Write( String::Format( CultureInfo::InvariantCulture, "\\u{0:x4}", static_cast<int>( c ) ) );
+				else
+					writer->Write( c );
+				break;
+			}
+		}
+		writer->Write( L'"' );
+	}
+
+	void EventRecorder::WriteChromeTrace( Stream^ stream )
+	{
+		StreamWriter^ writer = gcnew StreamWriter( stream, gcnew UTF8Encoding( false ) );
+		int processId = Diagnostics::Process::GetCurrentProcess()->Id;
+		double microsecondsPerTick = s_Frequency == 0 ? 0.0 : 1000000.0 / s_Frequency;
+		bool first = true;
+
+		writer->Write( "{\"traceEvents\":[" );
+
+		Monitor::Enter( s_Lock );
+		try
+		{
+			for each( ThreadEventBuffer^ buffer in s_Buffers )
+			{
+				if( buffer->ThreadName != nullptr )
+				{
+					writer->Write( first ? "\n" : ",\n" );
+					writer->Write( String::Format( CultureInfo::InvariantCulture,
+						"{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":{0},\"tid\":{1},\"args\":{{\"name\":", processId, buffer->ThreadId ) );
+					WriteJsonString( writer, buffer->ThreadName );
+					writer->Write( "}}" );
+					first = false;
+				}
+
+				std::vector<EventRecord> records;
+				buffer->Snapshot( records );
+
+				for( size_t i = 0; i < records.size(); ++i )
+				{
+					const EventRecord& record = records[i];
+					double timestamp = ( record.Timestamp - s_Epoch ) * microsecondsPerTick;
+
+					// a record that was torn despite the overwrite check must not take the whole save down
+					if( record.Type != EventRecordEnd && ( record.NameId < 0 || record.NameId >= s_Names->Count ) )
+						continue;
+
+					writer->Write( first ? "\n" : ",\n" );
+					first = false;
+
+					if( record.Type == EventRecordEnd )
+					{
+						writer->Write( String::Format( CultureInfo::InvariantCulture,
+							"{{\"ph\":\"E\",\"ts\":{0:0.###},\"pid\":{1},\"tid\":{2}}}", timestamp, processId, buffer->ThreadId ) );
+						continue;
+					}
+
+					writer->Write( "{\"name\":" );
+					WriteJsonString( writer, s_Names[record.NameId] );
+					writer->Write( String::Format( CultureInfo::InvariantCulture,
+						record.Type == EventRecordBegin ? ",\"ph\":\"B\",\"ts\":{0:0.###},\"pid\":{1},\"tid\":{2}" : ",\"ph\":\"i\",\"s\":\"t\",\"ts\":{0:0.###},\"pid\":{1},\"tid\":{2}",
+						timestamp, processId, buffer->ThreadId ) );
+					writer->Write( String::Format( CultureInfo::InvariantCulture,
+						",\"args\":{{\"color\":\"#{0:X8}\",\"depth\":{1}}}}}", record.Color, record.Depth ) );
+				}
+			}
+		}
+		finally
+		{
+			Monitor::Exit( s_Lock );
+		}
+
+		writer->Write( "\n],\"displayTimeUnit\":\"ms\"}\n" );
+		writer->Flush();
+	}
+
+	void EventRecorder::WriteBinaryTrace( Stream^ stream )
+	{
+		// Layout (little endian):
+		//   'S' 'D' 'X' 'T', int32 version, int64 ticks per second, int64 epoch ticks
+		//   int32 name count, then each name as a BinaryWriter length-prefixed UTF-8 string
+		//   int32 thread count, then per thread: int32 thread id, int32 record count, and
+		//   that many 20-byte records { int64 ticks, int32 name id, int32 color, int16 depth, uint8 type, uint8 reserved }
+		BinaryWriter^ writer = gcnew BinaryWriter( stream, gcnew UTF8Encoding( false ) );
+
+		Monitor::Enter( s_Lock );
+		try
+		{
+			writer->Write( static_cast<Byte>( 'S' ) );
+			writer->Write( static_cast<Byte>( 'D' ) );
+			writer->Write( static_cast<Byte>( 'X' ) );
+			writer->Write( static_cast<Byte>( 'T' ) );
+			writer->Write( 1 );
+			writer->Write( s_Frequency );
+			writer->Write( s_Epoch );
+
+			writer->Write( s_Names->Count );
+			for each( String^ name in s_Names )
+				writer->Write( name );
+
+			writer->Write( s_Buffers->Count );
+			for each( ThreadEventBuffer^ buffer in s_Buffers )
+			{
+				std::vector<EventRecord> records;
+				buffer->Snapshot( records );
+
+				writer->Write( buffer->ThreadId );
+				writer->Write( static_cast<int>( records.size() ) );
+
+				for( size_t i = 0; i < records.size(); ++i )
+				{
+					writer->Write( records[i].Timestamp );
+					writer->Write( records[i].NameId );
+					writer->Write( records[i].Color );
+					writer->Write( records[i].Depth );
+					writer->Write( records[i].Type );
+					writer->Write( records[i].Reserved );
+				}
+			}
+		}
+		finally
+		{
+			Monitor::Exit( s_Lock );
+		}
+
+		writer->Flush();
+	}
+}
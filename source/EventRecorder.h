@@ -0,0 +1,136 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+
+#include "Enums.h"
+
+namespace SlimDX
+{
+	enum EventRecordType
+	{
+		EventRecordBegin = 0,
+		EventRecordEnd = 1,
+		EventRecordMarker = 2,
+	};
+
+	struct EventRecord
+	{
+		__int64 Timestamp;
+		int NameId;
+		int Color;
+		short Depth;
+		unsigned char Type;
+		unsigned char Reserved;
+	};
+
+	// Ring of event records owned by one thread. Only the owning thread writes;
+	// snapshots may be taken from any thread and simply skip records that were
+	// overwritten while they were being copied.
+	ref class ThreadEventBuffer sealed
+	{
+	private:
+		EventRecord* m_Records;
+		int m_Mask;
+		System::Int64 m_Written;
+		System::Int64 m_ClearedAt;
+		int m_Depth;
+		System::Threading::Thread^ m_Owner;
+
+		void Destruct();
+
+	internal:
+		initonly int ThreadId;
+		initonly System::String^ ThreadName;
+		System::Collections::Generic::Dictionary<System::String^, int>^ NameCache;
+
+		ThreadEventBuffer( int capacity );
+		~ThreadEventBuffer();
+		!ThreadEventBuffer();
+
+		int Record( EventRecordType type, int nameId, int color );
+		void Snapshot( std::vector<EventRecord>& records );
+		void Clear();
+
+		property int Depth
+		{
+			int get() { return m_Depth; }
+		}
+
+		property bool IsOwnerAlive
+		{
+			bool get() { return m_Owner->IsAlive; }
+		}
+
+		property bool IsEmpty
+		{
+			bool get();
+		}
+	};
+
+	// Per-thread recorder behind the Performance event API.
+	ref class EventRecorder sealed
+	{
+	private:
+		static EventRecorder();
+		EventRecorder() { }
+
+		static System::Object^ s_Lock;
+		static System::Collections::Generic::List<ThreadEventBuffer^>^ s_Buffers;
+		static System::Collections::Generic::Dictionary<System::String^, int>^ s_NameIds;
+		static System::Collections::Generic::List<System::String^>^ s_Names;
+
+		static int s_Capacity;
+		static System::Int64 s_Epoch;
+		static System::Int64 s_Frequency;
+		static int s_Generation;
+
+		[System::ThreadStatic]
+		static ThreadEventBuffer^ t_Buffer;
+
+		[System::ThreadStatic]
+		static int t_Generation;
+
+		static ThreadEventBuffer^ GetBuffer();
+		static int GetNameId( ThreadEventBuffer^ buffer, System::String^ name );
+		static void RetireDeadThreads();
+
+		static void WriteChromeTrace( System::IO::Stream^ stream );
+		static void WriteBinaryTrace( System::IO::Stream^ stream );
+		static void WriteJsonString( System::IO::TextWriter^ writer, System::String^ value );
+
+	internal:
+		static bool Enabled;
+
+		static void Start( int eventsPerThread );
+		static void Stop();
+		static void Clear();
+
+		static int Begin( int color, System::String^ name );
+		static int End();
+		static void Marker( int color, System::String^ name );
+		static int CurrentDepth();
+
+		static void Save( System::IO::Stream^ stream, PerformanceTraceFormat format );
+	};
+}
@@ -0,0 +1,111 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <windows.h>
+
+#include "DataStream.h"
+#include "MappedFile.h"
+
+using namespace System;
+using namespace System::IO;
+
+namespace SlimDX
+{
+	MappedFile::MappedFile( HANDLE mapping, void* view )
+	: m_Mapping( mapping ), m_View( view )
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	MappedFile::!MappedFile()
+	{
+		Destruct();
+	}
+
+	void MappedFile::Destruct()
+	{
+		if( m_View != NULL )
+		{
+			UnmapViewOfFile( m_View );
+			m_View = NULL;
+		}
+
+		if( m_Mapping != NULL )
+		{
+			CloseHandle( m_Mapping );
+			m_Mapping = NULL;
+		}
+	}
+
+	DataStream^ MappedFile::Map( FileStream^ file, Int64 offset, Int64 length )
+	{
+		if( file == nullptr )
+			throw gcnew ArgumentNullException( "file" );
+		if( offset < 0 || offset > file->Length )
+			throw gcnew ArgumentOutOfRangeException( "offset" );
+		if( length == 0 )
+			length = file->Length - offset;
+		if( length < 1 || offset + length > file->Length )
+			throw gcnew ArgumentOutOfRangeException( "length" );
+
+		HANDLE fileHandle = file->SafeFileHandle->DangerousGetHandle().ToPointer();
+		HANDLE mapping = CreateFileMapping( fileHandle, NULL, PAGE_READONLY, 0, 0, NULL );
+		if( mapping == NULL )
+			return nullptr;
+
+		// Views have to start on an allocation granularity boundary.
+		SYSTEM_INFO info;
+		GetSystemInfo( &info );
+		Int64 alignedOffset = offset - offset % info.dwAllocationGranularity;
+		Int64 delta = offset - alignedOffset;
+
+		void* view = MapViewOfFile( mapping, FILE_MAP_READ, static_cast<DWORD>( alignedOffset >> 32 ),
+			static_cast<DWORD>( alignedOffset & 0xFFFFFFFF ), static_cast<SIZE_T>( delta + length ) );
+		if( view == NULL )
+		{
+			CloseHandle( mapping );
+			return nullptr;
+		}
+
+		MappedFile^ owner = gcnew MappedFile( mapping, view );
+		return gcnew DataStream( static_cast<char*>( view ) + delta, length, true, false, owner );
+	}
+
+	DataStream^ MappedFile::Map( String^ path, Int64 offset, Int64 length )
+	{
+		FileStream^ file = gcnew FileStream( path, FileMode::Open, FileAccess::Read, FileShare::Read );
+		try
+		{
+			return Map( file, offset, length );
+		}
+		finally
+		{
+			delete file;
+		}
+	}
+}
@@ -0,0 +1,61 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	ref class DataStream;
+
+	/// <summary>
+	/// Owns a read-only view of a file mapping. Instances are handed to a <see cref="DataStream"/>
+	/// as its owner, so the view is unmapped when the stream is disposed.
+	/// </summary>
+	ref class MappedFile sealed : System::IDisposable
+	{
+	private:
+		HANDLE m_Mapping;
+		void* m_View;
+
+		void Destruct();
+
+	public:
+		/// <summary>
+		/// Takes ownership of a file mapping and a view of it.
+		/// </summary>
+		MappedFile( HANDLE mapping, void* view );
+
+		~MappedFile();
+		!MappedFile();
+
+		/// <summary>
+		/// Maps a range of an open file into memory. A length of zero maps the rest of the file.
+		/// </summary>
+		/// <returns>A read-only stream over the range, or <c>nullptr</c> if the file could not be mapped.</returns>
+		static DataStream^ Map( System::IO::FileStream^ file, System::Int64 offset, System::Int64 length );
+
+		/// <summary>
+		/// Opens a file and maps a range of it into memory. A length of zero maps the rest of the file.
+		/// </summary>
+		/// <returns>A read-only stream over the range, or <c>nullptr</c> if the file could not be mapped.</returns>
+		static DataStream^ Map( System::String^ path, System::Int64 offset, System::Int64 length );
+	};
+}
@@ -0,0 +1,109 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "ParallelLoop.h"
+
+using namespace System;
+using namespace System::Threading;
+
+namespace SlimDX
+{
+	void ParallelLoop::Work::Run( Object^ )
+	{
+		RunRanges();
+
+		if( Interlocked::Decrement( Pending ) == 0 )
+			Done->Set();
+	}
+
+	void ParallelLoop::Work::RunRanges()
+	{
+		try
+		{
+			while( Error == nullptr )
+			{
+				int begin = Interlocked::Add( Next, Grain ) - Grain;
+				if( begin >= Count )
+					break;
+
+				Body( begin, begin < Count - Grain ? begin + Grain : Count );
+			}
+		}
+		catch( Exception^ e )
+		{
+			Interlocked::CompareExchange<Exception^>( Error, e, nullptr );
+		}
+	}
+
+	void ParallelLoop::For( int count, int grain, ParallelRange^ body )
+	{
+		if( body == nullptr )
+			throw gcnew ArgumentNullException( "body" );
+		if( grain < 1 )
+			throw gcnew ArgumentOutOfRangeException( "grain" );
+		if( count <= 0 )
+			return;
+
+		int ranges = count / grain + (count % grain != 0 ? 1 : 0);
+		int helpers = Math::Min( Environment::ProcessorCount, ranges ) - 1;
+		if( helpers <= 0 )
+		{
+			body( 0, count );
+			return;
+		}
+
+		Work^ work = gcnew Work();
+		work->Body = body;
+		work->Count = count;
+		work->Grain = grain;
+		work->Pending = helpers;
+		work->Done = gcnew ManualResetEvent( false );
+
+		try
+		{
+			int queued = 0;
+			try
+			{
+				for( ; queued < helpers; queued++ )
+					ThreadPool::QueueUserWorkItem( gcnew WaitCallback( work, &Work::Run ) );
+			}
+			catch( Exception^ e )
+			{
+				// stop the helpers that did get queued, and stop waiting for the ones that never will be
+				Interlocked::CompareExchange<Exception^>( work->Error, e, nullptr );
+				if( Interlocked::Add( work->Pending, queued - helpers ) == 0 )
+					work->Done->Set();
+			}
+
+			work->RunRanges();
+			work->Done->WaitOne();
+		}
+		finally
+		{
+			work->Done->Close();
+		}
+
+		if( work->Error != nullptr )
+			throw work->Error;
+	}
+}
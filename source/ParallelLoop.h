@@ -0,0 +1,58 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	delegate void ParallelRange( int begin, int end );
+
+	/// <summary>
+	/// Splits a loop into ranges that run on the calling thread and the thread pool.
+	/// </summary>
+	ref class ParallelLoop sealed
+	{
+	private:
+		ref class Work sealed
+		{
+		public:
+			ParallelRange^ Body;
+			int Count;
+			int Grain;
+			int Next;
+			int Pending;
+			System::Threading::ManualResetEvent^ Done;
+			System::Exception^ Error;
+
+			void Run( System::Object^ state );
+			void RunRanges();
+		};
+
+		ParallelLoop() { }
+
+	public:
+		/// <summary>
+		/// Calls the body for consecutive ranges of at most <paramref name="grain"/> items covering [0, count), and returns
+		/// once every range has run. The first exception thrown by the body stops the loop and is rethrown.
+		/// </summary>
+		static void For( int count, int grain, ParallelRange^ body );
+	};
+}
@@ -25,6 +25,7 @@
 
 #include "math/Color4.h"
 #include "Performance.h"
+#include "EventRecorder.h"
 #include <vcclr.h>
 
 using namespace System;
@@ -34,12 +35,18 @@ namespace SlimDX
 {
 	int Performance::BeginEvent( Color4 color, String^ name )
 	{
+		if( EventRecorder::Enabled )
+			EventRecorder::Begin( static_cast<int>( color ), name );
+
 		pin_ptr<const wchar_t> pinnedName = PtrToStringChars( name );
 		return D3DPERF_BeginEvent( static_cast<int>( color ), pinnedName );
 	}
 
 	int Performance::EndEvent()
 	{
+		if( EventRecorder::Enabled )
+			EventRecorder::End();
+
 		return D3DPERF_EndEvent();
 	}
 
@@ -55,6 +62,9 @@ namespace SlimDX
 
 	void Performance::SetMarker( Color4 color, String^ name )
 	{
+		if( EventRecorder::Enabled )
+			EventRecorder::Marker( static_cast<int>( color ), name );
+
 		pin_ptr<const wchar_t> pinnedName = PtrToStringChars( name );
 		D3DPERF_SetMarker( static_cast<int>( color ), pinnedName );
 	}
@@ -69,4 +79,34 @@ namespace SlimDX
 		pin_ptr<const wchar_t> pinnedName = PtrToStringChars( name );
 		D3DPERF_SetRegion( static_cast<int>( color ), pinnedName );
 	}
+
+	void Performance::StartRecording( int eventsPerThread )
+	{
+		EventRecorder::Start( eventsPerThread );
+	}
+
+	void Performance::StopRecording()
+	{
+		EventRecorder::Stop();
+	}
+
+	void Performance::ClearRecording()
+	{
+		EventRecorder::Clear();
+	}
+
+	void Performance::SaveRecording( System::IO::Stream^ stream, PerformanceTraceFormat format )
+	{
+		EventRecorder::Save( stream, format );
+	}
+
+	bool Performance::IsRecording::get()
+	{
+		return EventRecorder::Enabled;
+	}
+
+	int Performance::RecordingDepth::get()
+	{
+		return EventRecorder::CurrentDepth();
+	}
 }
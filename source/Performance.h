@@ -23,12 +23,23 @@
 
 #include "Enums.h"
 
+#ifdef XMLDOCS
+using System::ArgumentNullException;
+using System::ArgumentOutOfRangeException;
+using System::NotSupportedException;
+#endif
+
 namespace SlimDX
 {
 	/// <summary>
 	/// Provides access to the Direct3D performance API, which allows applications to gather performance
 	/// data and integrate with PIX for Windows in order to perform detailed analysis.
 	/// </summary>
+	/// <remarks>
+	/// Events and markers can also be recorded in-process by calling <see cref="StartRecording"/>, which
+	/// works without PIX or a Direct3D device. Each thread records into its own fixed-size ring buffer, so
+	/// only the most recent events are kept.
+	/// </remarks>
 	/// <unmanaged>D3DPERF</unmanaged>
 	public ref class Performance sealed
 	{
@@ -88,5 +99,47 @@ namespace SlimDX
 		/// <param name="color">Event color. This is the color used to display the event in the event view.</param>
 		/// <param name="name">Event name.</param>
 		static void SetRegion( Color4 color, System::String^ name );
+
+		/// <summary>
+		/// Starts recording events and markers on every thread.
+		/// </summary>
+		/// <param name="eventsPerThread">The number of events to keep per thread. This is rounded up to the next power of two.</param>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="eventsPerThread" /> is less than 1 or greater than 2^24.</exception>
+		static void StartRecording( int eventsPerThread );
+
+		/// <summary>
+		/// Stops recording events. Events that have already been recorded are kept until <see cref="ClearRecording"/> is called.
+		/// </summary>
+		static void StopRecording();
+
+		/// <summary>
+		/// Discards all recorded events.
+		/// </summary>
+		static void ClearRecording();
+
+		/// <summary>
+		/// Writes the recorded events to a stream. Recording may continue while the events are saved.
+		/// </summary>
+		/// <param name="stream">The stream to write to.</param>
+		/// <param name="format">The format in which to write the events.</param>
+		/// <exception cref="ArgumentNullException"><paramref name="stream" /> is a null reference.</exception>
+		/// <exception cref="NotSupportedException"><paramref name="stream" /> does not support writing.</exception>
+		static void SaveRecording( System::IO::Stream^ stream, PerformanceTraceFormat format );
+
+		/// <summary>
+		/// Gets a value indicating whether events are being recorded.
+		/// </summary>
+		static property bool IsRecording
+		{
+			bool get();
+		}
+
+		/// <summary>
+		/// Gets the number of recorded events that are open on the calling thread.
+		/// </summary>
+		static property int RecordingDepth
+		{
+			int get();
+		}
 	};
 }
@@ -175,4 +175,14 @@ namespace SlimDX
 		/// <returns><c>true</c> if <paramref name="value1"/> has the same value as <paramref name="value2"/>; otherwise, <c>false</c>.</returns>
 		static bool Equals( Result% value1, Result% value2 );
 	};
-}
\ No newline at end of file
+}
+
+#ifdef SLIMDX_INSTRUMENTATION
+#include "CallStatistics.h"
+
+#define SLIMDX_INSTRUMENT_CALL() SlimDX::CallStatistics::MarkCall()
+#define SLIMDX_INSTRUMENT_RESULT(x) SlimDX::CallStatistics::RecordCall( __FUNCTION__, (x) )
+#else
+#define SLIMDX_INSTRUMENT_CALL() ((void) 0)
+#define SLIMDX_INSTRUMENT_RESULT(x) (x)
+#endif
\ No newline at end of file
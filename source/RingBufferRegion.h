@@ -0,0 +1,92 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	/// <summary>
+	/// Describes a contiguous range of a <see cref="RingStream"/> that may be split in two where it wraps
+	/// around the end of the underlying buffer.
+	/// </summary>
+	/// <unmanaged>None</unmanaged>
+	public value class RingBufferRegion
+	{
+	private:
+		System::IntPtr m_First;
+		int m_FirstSize;
+		System::IntPtr m_Second;
+		int m_SecondSize;
+		System::Int64 m_Start;
+
+	internal:
+		RingBufferRegion( char* first, int firstSize, char* second, int secondSize, System::Int64 start )
+		: m_First( first ), m_FirstSize( firstSize ), m_Second( second ), m_SecondSize( secondSize ), m_Start( start )
+		{
+		}
+
+		property System::Int64 Start
+		{
+			System::Int64 get() { return m_Start; }
+		}
+
+	public:
+		/// <summary>
+		/// Gets a pointer to the first part of the region.
+		/// </summary>
+		property System::IntPtr First
+		{
+			System::IntPtr get() { return m_First; }
+		}
+
+		/// <summary>
+		/// Gets the size of the first part of the region, in bytes.
+		/// </summary>
+		property int FirstSize
+		{
+			int get() { return m_FirstSize; }
+		}
+
+		/// <summary>
+		/// Gets a pointer to the second part of the region, or <see cref="System::IntPtr::Zero"/> if the region does not wrap.
+		/// </summary>
+		property System::IntPtr Second
+		{
+			System::IntPtr get() { return m_Second; }
+		}
+
+		/// <summary>
+		/// Gets the size of the second part of the region, in bytes.
+		/// </summary>
+		property int SecondSize
+		{
+			int get() { return m_SecondSize; }
+		}
+
+		/// <summary>
+		/// Gets the total size of the region, in bytes.
+		/// </summary>
+		property int Size
+		{
+			int get() { return m_FirstSize + m_SecondSize; }
+		}
+	};
+}
@@ -0,0 +1,453 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <stdexcept>
+
+#include "InternalHelpers.h"
+#include "Utilities.h"
+#include "RingStream.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Threading;
+
+namespace SlimDX
+{
+	RingStream::RingStream( int capacity, RingStreamMode mode )
+	: m_Mode( mode )
+	{
+		if( capacity < 1 || capacity > (1 << 30) )
+			throw gcnew ArgumentOutOfRangeException( "capacity" );
+
+		int size = 1;
+		while( size < capacity )
+			size <<= 1;
+
+		try
+		{
+			// Manual Allocation: this is fine
+			m_Buffer = new char[size];
+			GC::AddMemoryPressure( size );
+		}
+		catch (std::bad_alloc&)
+		{
+			throw gcnew OutOfMemoryException();
+		}
+
+		m_Capacity = size;
+		m_Mask = size - 1;
+
+		m_DataAvailable = gcnew AutoResetEvent( false );
+		m_SpaceAvailable = gcnew AutoResetEvent( false );
+	}
+
+	RingStream::~RingStream()
+	{
+		Destruct();
+
+		// wake anything still waiting so that it can see the stream is gone; the events themselves are
+		// left to be collected, since a waiter may still be on its way out of them
+		m_DataAvailable->Set();
+		m_SpaceAvailable->Set();
+
+		GC::SuppressFinalize( this );
+	}
+
+	RingStream::!RingStream()
+	{
+		Destruct();
+	}
+
+	void RingStream::Destruct()
+	{
+		Interlocked::Exchange( m_Disposed, 1 );
+
+		if( m_Buffer != 0 )
+		{
+			delete[] m_Buffer;
+			GC::RemoveMemoryPressure( m_Capacity );
+			m_Buffer = 0;
+		}
+	}
+
+	RingBufferRegion RingStream::MakeRegion( Int64 start, int size )
+	{
+		int index = static_cast<int>( start & m_Mask );
+		int firstSize = min( size, m_Capacity - index );
+		char* second = size > firstSize ? m_Buffer : 0;
+
+		return RingBufferRegion( m_Buffer + index, firstSize, second, size - firstSize, start );
+	}
+
+	void RingStream::CopyIn( RingBufferRegion region, const char* source )
+	{
+		memcpy( region.First.ToPointer(), source, region.FirstSize );
+		if( region.SecondSize > 0 )
+			memcpy( region.Second.ToPointer(), source + region.FirstSize, region.SecondSize );
+	}
+
+	void RingStream::CopyOut( RingBufferRegion region, char* destination )
+	{
+		memcpy( destination, region.First.ToPointer(), region.FirstSize );
+		if( region.SecondSize > 0 )
+			memcpy( destination + region.FirstSize, region.Second.ToPointer(), region.SecondSize );
+	}
+
+	RingBufferRegion RingStream::ReserveWrite( int count )
+	{
+		if( Thread::VolatileRead( m_Disposed ) != 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( count < 0 )
+			throw gcnew ArgumentOutOfRangeException( "count" );
+		if( Thread::VolatileRead( m_Completed ) != 0 )
+			throw gcnew InvalidOperationException( "Cannot write to a RingStream after writing has been completed." );
+
+		if( m_Mode == RingStreamMode::SingleProducer )
+		{
+			// Only this thread ever moves the reserve cursor, so no atomic update is needed.
+			Int64 start = m_WriteReserve;
+			int size = min( count, m_Capacity - static_cast<int>( start - Interlocked::Read( m_ReadPosition ) ) );
+
+			Interlocked::Exchange( m_WriteReserve, start + size );
+			return MakeRegion( start, size );
+		}
+
+		while( true )
+		{
+			Int64 start = Interlocked::Read( m_WriteReserve );
+			int size = min( count, m_Capacity - static_cast<int>( start - Interlocked::Read( m_ReadPosition ) ) );
+
+			if( size <= 0 )
+				return MakeRegion( start, 0 );
+
+			if( Interlocked::CompareExchange( m_WriteReserve, start + size, start ) == start )
+				return MakeRegion( start, size );
+		}
+	}
+
+	void RingStream::CommitWrite( RingBufferRegion region )
+	{
+		if( Thread::VolatileRead( m_Disposed ) != 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( region.Size == 0 )
+			return;
+
+		Int64 start = region.Start;
+		if( m_Mode == RingStreamMode::MultipleProducer )
+		{
+			// Earlier reservations must be published first, otherwise the consumer could
+			// see a gap of unwritten bytes.
+			int spins = 0;
+			while( Interlocked::Read( m_WriteCommit ) != start )
+			{
+				// a producer that was cut off by Dispose never publishes its reservation
+				if( Thread::VolatileRead( m_Disposed ) != 0 )
+					throw gcnew ObjectDisposedException( GetType()->Name );
+
+				if( ++spins < 64 )
+					Thread::SpinWait( 20 );
+				else
+					Thread::Sleep( 0 );
+			}
+		}
+
+		Int64 end = start + region.Size;
+		Interlocked::Exchange( m_WriteCommit, end );
+
+		Int64 fill = end - Interlocked::Read( m_ReadPosition );
+		Int64 highWaterMark = Interlocked::Read( m_HighWaterMark );
+		while( fill > highWaterMark )
+		{
+			Int64 previous = Interlocked::CompareExchange( m_HighWaterMark, fill, highWaterMark );
+			if( previous == highWaterMark )
+				break;
+			highWaterMark = previous;
+		}
+
+		if( Thread::VolatileRead( m_ConsumerWaiting ) != 0 )
+			m_DataAvailable->Set();
+	}
+
+	RingBufferRegion RingStream::PeekRead( int count )
+	{
+		if( Thread::VolatileRead( m_Disposed ) != 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( count < 0 )
+			throw gcnew ArgumentOutOfRangeException( "count" );
+
+		Int64 start = Interlocked::Read( m_ReadPosition );
+		int size = min( count, static_cast<int>( Interlocked::Read( m_WriteCommit ) - start ) );
+
+		return MakeRegion( start, size );
+	}
+
+	void RingStream::CommitRead( int count )
+	{
+		if( Thread::VolatileRead( m_Disposed ) != 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( count < 0 || count > Count )
+			throw gcnew ArgumentOutOfRangeException( "count" );
+		if( count == 0 )
+			return;
+
+		Interlocked::Exchange( m_ReadPosition, Interlocked::Read( m_ReadPosition ) + count );
+
+		if( Thread::VolatileRead( m_ProducersWaiting ) != 0 )
+			m_SpaceAvailable->Set();
+	}
+
+	int RingStream::TryWrite( array<Byte>^ buffer, int offset, int count )
+	{
+		Utilities::CheckArrayBounds( buffer, offset, count );
+
+		RingBufferRegion region = ReserveWrite( count );
+		if( region.Size == 0 )
+			return 0;
+
+		pin_ptr<Byte> pinnedBuffer = &buffer[offset];
+		CopyIn( region, reinterpret_cast<const char*>( pinnedBuffer ) );
+		CommitWrite( region );
+
+		return region.Size;
+	}
+
+	int RingStream::TryRead( array<Byte>^ buffer, int offset, int count )
+	{
+		Utilities::CheckArrayBounds( buffer, offset, count );
+
+		RingBufferRegion region = PeekRead( count );
+		if( region.Size == 0 )
+			return 0;
+
+		pin_ptr<Byte> pinnedBuffer = &buffer[offset];
+		CopyOut( region, reinterpret_cast<char*>( pinnedBuffer ) );
+		CommitRead( region.Size );
+
+		return region.Size;
+	}
+
+	bool RingStream::WaitForData( int count, int millisecondsTimeout )
+	{
+		if( Thread::VolatileRead( m_Disposed ) != 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( count < 0 || count > m_Capacity )
+			throw gcnew ArgumentOutOfRangeException( "count" );
+
+		if( Count >= count || Thread::VolatileRead( m_Completed ) != 0 )
+			return true;
+
+		Interlocked::Increment( m_ConsumerStalls );
+		int startTime = Environment::TickCount;
+
+		// Publish the flag before re-checking, so that a producer committing in between
+		// is guaranteed to see it and signal the event.
+		Interlocked::Exchange( m_ConsumerWaiting, 1 );
+		try
+		{
+			while( Count < count && Thread::VolatileRead( m_Completed ) == 0 )
+			{
+				if( Thread::VolatileRead( m_Disposed ) != 0 )
+					throw gcnew ObjectDisposedException( GetType()->Name );
+
+				int wait = Timeout::Infinite;
+				if( millisecondsTimeout != Timeout::Infinite )
+				{
+					wait = millisecondsTimeout - ( Environment::TickCount - startTime );
+					if( wait <= 0 )
+						return false;
+				}
+
+				m_DataAvailable->WaitOne( wait, false );
+			}
+		}
+		finally
+		{
+			Interlocked::Exchange( m_ConsumerWaiting, 0 );
+		}
+
+		return true;
+	}
+
+	bool RingStream::WaitForSpace( int count, int millisecondsTimeout )
+	{
+		if( Thread::VolatileRead( m_Disposed ) != 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( count < 0 || count > m_Capacity )
+			throw gcnew ArgumentOutOfRangeException( "count" );
+
+		if( FreeSpace >= count || Thread::VolatileRead( m_Completed ) != 0 )
+			return true;
+
+		Interlocked::Increment( m_ProducerStalls );
+		int startTime = Environment::TickCount;
+
+		Interlocked::Increment( m_ProducersWaiting );
+		try
+		{
+			while( FreeSpace < count && Thread::VolatileRead( m_Completed ) == 0 )
+			{
+				if( Thread::VolatileRead( m_Disposed ) != 0 )
+					throw gcnew ObjectDisposedException( GetType()->Name );
+
+				int wait = Timeout::Infinite;
+				if( millisecondsTimeout != Timeout::Infinite )
+				{
+					wait = millisecondsTimeout - ( Environment::TickCount - startTime );
+					if( wait <= 0 )
+						return false;
+				}
+
+				m_SpaceAvailable->WaitOne( wait, false );
+			}
+		}
+		finally
+		{
+			// The event only releases one waiter at a time; pass the wakeup on to the next producer.
+			if( Interlocked::Decrement( m_ProducersWaiting ) > 0 && ( FreeSpace > 0 || Thread::VolatileRead( m_Disposed ) != 0 ) )
+				m_SpaceAvailable->Set();
+		}
+
+		return true;
+	}
+
+	void RingStream::CompleteWriting()
+	{
+		if( Thread::VolatileRead( m_Disposed ) != 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		Interlocked::Exchange( m_Completed, 1 );
+
+		m_DataAvailable->Set();
+		m_SpaceAvailable->Set();
+	}
+
+	void RingStream::ResetStatistics()
+	{
+		Interlocked::Exchange( m_HighWaterMark, Count );
+		Interlocked::Exchange( m_ProducerStalls, 0 );
+		Interlocked::Exchange( m_ConsumerStalls, 0 );
+	}
+
+	void RingStream::Write( array<Byte>^ buffer, int offset, int count )
+	{
+		Utilities::CheckArrayBounds( buffer, offset, count );
+
+		int written = 0;
+		while( written < count )
+		{
+			int result = TryWrite( buffer, offset + written, count - written );
+			if( result == 0 )
+				WaitForSpace( 1, Timeout::Infinite );
+
+			written += result;
+		}
+	}
+
+	int RingStream::Read( array<Byte>^ buffer, int offset, int count )
+	{
+		Utilities::CheckArrayBounds( buffer, offset, count );
+		if( count == 0 )
+			return 0;
+
+		while( true )
+		{
+			int result = TryRead( buffer, offset, count );
+			if( result > 0 || IsCompleted )
+				return result;
+
+			WaitForData( 1, Timeout::Infinite );
+		}
+	}
+
+	void RingStream::Flush()
+	{
+	}
+
+	Int64 RingStream::Seek( Int64 offset, SeekOrigin origin )
+	{
+		SLIMDX_UNREFERENCED_PARAMETER(offset);
+		SLIMDX_UNREFERENCED_PARAMETER(origin);
+		throw gcnew NotSupportedException("RingStream objects cannot seek.");
+	}
+
+	void RingStream::SetLength( Int64 value )
+	{
+		SLIMDX_UNREFERENCED_PARAMETER(value);
+		throw gcnew NotSupportedException("RingStream objects cannot be resized.");
+	}
+
+	Int64 RingStream::Length::get()
+	{
+		throw gcnew NotSupportedException("RingStream objects do not have a length.");
+	}
+
+	Int64 RingStream::Position::get()
+	{
+		throw gcnew NotSupportedException("RingStream objects cannot seek.");
+	}
+
+	void RingStream::Position::set( Int64 value )
+	{
+		SLIMDX_UNREFERENCED_PARAMETER(value);
+		throw gcnew NotSupportedException("RingStream objects cannot seek.");
+	}
+
+	int RingStream::Count::get()
+	{
+		return static_cast<int>( Interlocked::Read( m_WriteCommit ) - Interlocked::Read( m_ReadPosition ) );
+	}
+
+	int RingStream::FreeSpace::get()
+	{
+		return m_Capacity - static_cast<int>( Interlocked::Read( m_WriteReserve ) - Interlocked::Read( m_ReadPosition ) );
+	}
+
+	bool RingStream::IsCompleted::get()
+	{
+		return Thread::VolatileRead( m_Completed ) != 0 && Count == 0;
+	}
+
+	Int64 RingStream::HighWaterMark::get()
+	{
+		return Interlocked::Read( m_HighWaterMark );
+	}
+
+	Int64 RingStream::TotalBytesWritten::get()
+	{
+		return Interlocked::Read( m_WriteCommit );
+	}
+
+	Int64 RingStream::TotalBytesRead::get()
+	{
+		return Interlocked::Read( m_ReadPosition );
+	}
+
+	Int64 RingStream::ProducerStalls::get()
+	{
+		return Interlocked::Read( m_ProducerStalls );
+	}
+
+	Int64 RingStream::ConsumerStalls::get()
+	{
+		return Interlocked::Read( m_ConsumerStalls );
+	}
+}
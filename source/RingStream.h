@@ -0,0 +1,340 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "Enums.h"
+#include "RingBufferRegion.h"
+
+#ifdef XMLDOCS
+using System::InvalidOperationException;
+using System::ArgumentException;
+using System::ArgumentNullException;
+using System::ArgumentOutOfRangeException;
+using System::NotSupportedException;
+using System::ObjectDisposedException;
+#endif
+
+namespace SlimDX
+{
+	/// <summary>
+	/// Provides a fixed-size circular stream for passing data from producer threads to a single consumer thread
+	/// without locking.
+	/// </summary>
+	/// <remarks>
+	/// Writers either copy data in with <see cref="Write"/> and <see cref="TryWrite"/>, or fill the buffer in place
+	/// by calling <see cref="ReserveWrite"/> followed by <see cref="CommitWrite"/>. The consumer does the same with
+	/// <see cref="Read"/>, <see cref="TryRead"/>, or <see cref="PeekRead"/> and <see cref="CommitRead"/>. In
+	/// <see cref="RingStreamMode::MultipleProducer"/> mode reservations are published in the order they were made,
+	/// so a reservation that is never committed stalls every producer behind it.
+	/// </remarks>
+	/// <unmanaged>None</unmanaged>
+	public ref class RingStream : public System::IO::Stream
+	{
+	private:
+		char* m_Buffer;
+		int m_Capacity;
+		int m_Mask;
+		initonly RingStreamMode m_Mode;
+
+		System::Int64 m_WriteReserve;
+		System::Int64 m_WriteCommit;
+		System::Int64 m_ReadPosition;
+		int m_Completed;
+		int m_Disposed;
+
+		int m_ConsumerWaiting;
+		int m_ProducersWaiting;
+
+		System::Threading::AutoResetEvent^ m_DataAvailable;
+		System::Threading::AutoResetEvent^ m_SpaceAvailable;
+
+		System::Int64 m_HighWaterMark;
+		System::Int64 m_ProducerStalls;
+		System::Int64 m_ConsumerStalls;
+
+		RingBufferRegion MakeRegion( System::Int64 start, int size );
+		void CopyIn( RingBufferRegion region, const char* source );
+		void CopyOut( RingBufferRegion region, char* destination );
+		void Destruct();
+
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="RingStream"/> class.
+		/// </summary>
+		/// <param name="capacity">The minimum capacity of the stream, in bytes. This is rounded up to the next power of two.</param>
+		/// <param name="mode">The number of threads that may write to the stream at the same time.</param>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="capacity" /> is less than 1 or greater than 2^30.</exception>
+		RingStream( int capacity, RingStreamMode mode );
+
+		/// <summary>
+		/// Releases all resources used by the <see cref="RingStream"/>.
+		/// </summary>
+		~RingStream();
+
+		/// <summary>
+		/// Releases unmanaged resources and performs other cleanup operations before the <see cref="RingStream"/> is reclaimed by garbage collection.
+		/// </summary>
+		!RingStream();
+
+		/// <summary>
+		/// Reserves up to the specified number of bytes of free space for writing, without waiting.
+		/// </summary>
+		/// <param name="count">The maximum number of bytes to reserve.</param>
+		/// <returns>The reserved region, which may be smaller than requested or empty if the stream is full.</returns>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="count" /> is negative.</exception>
+		/// <exception cref="InvalidOperationException"><see cref="CompleteWriting"/> has been called.</exception>
+		RingBufferRegion ReserveWrite( int count );
+
+		/// <summary>
+		/// Publishes a region previously obtained from <see cref="ReserveWrite"/> to the consumer.
+		/// </summary>
+		/// <param name="region">The region to publish.</param>
+		void CommitWrite( RingBufferRegion region );
+
+		/// <summary>
+		/// Gets up to the specified number of readable bytes without removing them from the stream.
+		/// </summary>
+		/// <param name="count">The maximum number of bytes to return.</param>
+		/// <returns>The readable region, which may be smaller than requested or empty if no data is available.</returns>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="count" /> is negative.</exception>
+		RingBufferRegion PeekRead( int count );
+
+		/// <summary>
+		/// Removes bytes from the front of the stream, releasing their space to producers.
+		/// </summary>
+		/// <param name="count">The number of bytes to remove.</param>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="count" /> is negative or greater than <see cref="Count"/>.</exception>
+		void CommitRead( int count );
+
+		/// <summary>
+		/// Writes as many bytes as currently fit in the stream, without waiting.
+		/// </summary>
+		/// <param name="buffer">An array of bytes to write.</param>
+		/// <param name="offset">The zero-based byte offset in buffer at which to begin copying bytes.</param>
+		/// <param name="count">The maximum number of bytes to write.</param>
+		/// <returns>The number of bytes written.</returns>
+		/// <exception cref="ArgumentNullException"><paramref name="buffer" /> is a null reference.</exception>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="offset" /> or <paramref name="count" /> is negative.</exception>
+		/// <exception cref="ArgumentException">The sum of <paramref name="offset" /> and <paramref name="count" /> is greater than the buffer length.</exception>
+		/// <exception cref="InvalidOperationException"><see cref="CompleteWriting"/> has been called.</exception>
+		int TryWrite( array<System::Byte>^ buffer, int offset, int count );
+
+		/// <summary>
+		/// Reads as many bytes as are currently available, without waiting.
+		/// </summary>
+		/// <param name="buffer">An array to receive the bytes.</param>
+		/// <param name="offset">The zero-based byte offset in buffer at which to begin storing bytes.</param>
+		/// <param name="count">The maximum number of bytes to read.</param>
+		/// <returns>The number of bytes read.</returns>
+		/// <exception cref="ArgumentNullException"><paramref name="buffer" /> is a null reference.</exception>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="offset" /> or <paramref name="count" /> is negative.</exception>
+		/// <exception cref="ArgumentException">The sum of <paramref name="offset" /> and <paramref name="count" /> is greater than the buffer length.</exception>
+		int TryRead( array<System::Byte>^ buffer, int offset, int count );
+
+		/// <summary>
+		/// Blocks until the specified number of bytes can be read, or writing has completed.
+		/// </summary>
+		/// <param name="count">The number of bytes to wait for.</param>
+		/// <param name="millisecondsTimeout">The number of milliseconds to wait, or <see cref="System::Threading::Timeout::Infinite"/>.</param>
+		/// <returns><c>true</c> if the data is available; otherwise, <c>false</c>.</returns>
+		/// <exception cref="ObjectDisposedException">The stream was disposed, including while waiting.</exception>
+		bool WaitForData( int count, int millisecondsTimeout );
+
+		/// <summary>
+		/// Blocks until the specified number of bytes can be written.
+		/// </summary>
+		/// <param name="count">The number of bytes to wait for.</param>
+		/// <param name="millisecondsTimeout">The number of milliseconds to wait, or <see cref="System::Threading::Timeout::Infinite"/>.</param>
+		/// <returns><c>true</c> if the space is available; otherwise, <c>false</c>.</returns>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="count" /> is greater than <see cref="Capacity"/>.</exception>
+		/// <exception cref="ObjectDisposedException">The stream was disposed, including while waiting.</exception>
+		bool WaitForSpace( int count, int millisecondsTimeout );
+
+		/// <summary>
+		/// Marks the stream as complete. Once the remaining data has been consumed, reads return zero bytes.
+		/// </summary>
+		void CompleteWriting();
+
+		/// <summary>
+		/// Resets the high-water mark and stall counters.
+		/// </summary>
+		void ResetStatistics();
+
+		/// <summary>
+		/// Writes a sequence of bytes to the stream, waiting for space as necessary.
+		/// </summary>
+		/// <param name="buffer">An array of bytes. This method copies count bytes from buffer to the current stream.</param>
+		/// <param name="offset">The zero-based byte offset in buffer at which to begin copying bytes to the current stream.</param>
+		/// <param name="count">The number of bytes to be written to the current stream.</param>
+		/// <exception cref="ArgumentNullException"><paramref name="buffer" /> is a null reference.</exception>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="offset" /> or <paramref name="count" /> is negative.</exception>
+		/// <exception cref="ArgumentException">The sum of <paramref name="offset" /> and <paramref name="count" /> is greater than the buffer length.</exception>
+		/// <exception cref="InvalidOperationException"><see cref="CompleteWriting"/> has been called.</exception>
+		virtual void Write( array<System::Byte>^ buffer, int offset, int count ) override;
+
+		/// <summary>
+		/// Reads a sequence of bytes from the stream, waiting until at least one byte is available or writing has completed.
+		/// </summary>
+		/// <param name="buffer">An array of values to be read from the stream.</param>
+		/// <param name="offset">The zero-based byte offset in buffer at which to begin storing
+		/// the data read from the current stream.</param>
+		/// <param name="count">The maximum number of bytes to be read from the current stream.</param>
+		/// <returns>The number of bytes read from the stream, or zero once writing has completed and the stream is empty.</returns>
+		/// <exception cref="ArgumentNullException"><paramref name="buffer" /> is a null reference.</exception>
+		/// <exception cref="ArgumentOutOfRangeException"><paramref name="offset" /> or <paramref name="count" /> is negative.</exception>
+		/// <exception cref="ArgumentException">The sum of <paramref name="offset" /> and <paramref name="count" /> is greater than the buffer length.</exception>
+		virtual int Read( array<System::Byte>^ buffer, int offset, int count ) override;
+
+		/// <summary>
+		/// Does nothing; data is visible to the consumer as soon as it is written.
+		/// </summary>
+		virtual void Flush() override;
+
+		/// <summary>
+		/// Not supported.
+		/// </summary>
+		/// <exception cref="NotSupportedException">Always thrown.</exception>
+		virtual System::Int64 Seek( System::Int64 offset, System::IO::SeekOrigin origin ) override;
+
+		/// <summary>
+		/// Not supported.
+		/// </summary>
+		/// <exception cref="NotSupportedException">Always thrown.</exception>
+		virtual void SetLength( System::Int64 value ) override;
+
+		/// <summary>Gets a value indicating whether the current stream supports reading.</summary>
+		/// <value>Always <c>true</c>.</value>
+		property bool CanRead
+		{
+			virtual bool get() override { return true; }
+		}
+
+		/// <summary>Gets a value indicating whether the current stream supports seeking.</summary>
+		/// <value>Always <c>false</c>.</value>
+		property bool CanSeek
+		{
+			virtual bool get() override { return false; }
+		}
+
+		/// <summary>Gets a value indicating whether the current stream supports writing.</summary>
+		/// <value><c>true</c> until <see cref="CompleteWriting"/> is called.</value>
+		property bool CanWrite
+		{
+			virtual bool get() override { return m_Completed == 0; }
+		}
+
+		/// <summary>Not supported.</summary>
+		/// <exception cref="NotSupportedException">Always thrown.</exception>
+		property System::Int64 Length
+		{
+			virtual System::Int64 get() override;
+		}
+
+		/// <summary>Not supported.</summary>
+		/// <exception cref="NotSupportedException">Always thrown.</exception>
+		property System::Int64 Position
+		{
+			virtual System::Int64 get() override;
+			virtual void set( System::Int64 ) override;
+		}
+
+		/// <summary>
+		/// Gets the total size of the stream's buffer, in bytes.
+		/// </summary>
+		property int Capacity
+		{
+			int get() { return m_Capacity; }
+		}
+
+		/// <summary>
+		/// Gets the producer mode of the stream.
+		/// </summary>
+		property RingStreamMode Mode
+		{
+			RingStreamMode get() { return m_Mode; }
+		}
+
+		/// <summary>
+		/// Gets the number of bytes that are ready to be read.
+		/// </summary>
+		property int Count
+		{
+			int get();
+		}
+
+		/// <summary>
+		/// Gets the number of bytes that can be reserved for writing.
+		/// </summary>
+		property int FreeSpace
+		{
+			int get();
+		}
+
+		/// <summary>
+		/// Gets a value indicating whether writing has completed and all data has been consumed.
+		/// </summary>
+		property bool IsCompleted
+		{
+			bool get();
+		}
+
+		/// <summary>
+		/// Gets the largest number of bytes that have been waiting to be read at any one time.
+		/// </summary>
+		property System::Int64 HighWaterMark
+		{
+			System::Int64 get();
+		}
+
+		/// <summary>
+		/// Gets the total number of bytes that have been written to the stream.
+		/// </summary>
+		property System::Int64 TotalBytesWritten
+		{
+			System::Int64 get();
+		}
+
+		/// <summary>
+		/// Gets the total number of bytes that have been read from the stream.
+		/// </summary>
+		property System::Int64 TotalBytesRead
+		{
+			System::Int64 get();
+		}
+
+		/// <summary>
+		/// Gets the number of times a producer had to wait for free space.
+		/// </summary>
+		property System::Int64 ProducerStalls
+		{
+			System::Int64 get();
+		}
+
+		/// <summary>
+		/// Gets the number of times the consumer had to wait for data.
+		/// </summary>
+		property System::Int64 ConsumerStalls
+		{
+			System::Int64 get();
+		}
+	};
+}
@@ -25,7 +25,7 @@
 #include "InternalHelpers.h"
 #include "Result.h"
 
-#define RECORD_SDX(x) Result::Record<SlimDXException^>( (x), (nullptr), (nullptr) )
+#define RECORD_SDX(x) Result::Record<SlimDXException^>( SLIMDX_INSTRUMENT_RESULT(x), (nullptr), (nullptr) )
 
 namespace SlimDX
 {
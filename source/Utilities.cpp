@@ -22,6 +22,7 @@
 */
 
 #include "DataStream.h"
+#include "MappedFile.h"
 #include "Utilities.h"
 #include "multimedia/WaveStream.h"
 
@@ -304,6 +305,19 @@ namespace SlimDX
 		dest.right = source.Right;
 	}
 
+	DataStream^ Utilities::AsDataStream( Stream^ stream )
+	{
+		DataStream^ ds = dynamic_cast<DataStream^>( stream );
+		if( ds != nullptr )
+			return ds;
+
+		WaveStream^ ws = dynamic_cast<WaveStream^>( stream );
+		if( ws != nullptr )
+			return ws->InternalMemory;
+
+		return nullptr;
+	}
+
 	array<Byte>^ Utilities::ReadStream( Stream^ stream, DataStream^* dataStream )
 	{
 		int length = 0;
@@ -328,28 +342,24 @@ namespace SlimDX
 			return gcnew array<Byte>( 0 );
 
 		//if we're reading a DataStream, don't return anything and send back the casted DataStream
-		DataStream^ ds = dynamic_cast<DataStream^>( stream );
+		DataStream^ ds = AsDataStream( stream );
 		if( ds != nullptr && dataStream != NULL )
 		{
 			*dataStream = ds;
 			return nullptr;
 		}
 
-		//It turns out this can fail because MemoryStream keeps an exposable parameter, and defaults it to
-		//false, so that most of the time, MemoryStream->GetBuffer() can't be used. We might use reflection
-		//to pull the internal array directly. Until then, MemoryStream can literally GO FUCK ITS OWN INTERFACE.
-		/*//if we're reading an entire memory stream from beginning to end, just return the internal buffer
+		//if we're reading an entire memory stream from beginning to end, just return the internal buffer;
+		//GetBuffer() is refused for streams that weren't created as exposable, so this only works some of the time
 		MemoryStream^ ms = dynamic_cast<MemoryStream^>( stream );
-		if( ms != nullptr && stream->Position == 0 && readLength == stream->Length )
-		{
-		return ms->GetBuffer();
-		}*/
-
-		WaveStream^ ws = dynamic_cast<WaveStream^>( stream );
-		if( ws != nullptr && dataStream != NULL && ws->InternalMemory != nullptr )
+		if( ms != nullptr && stream->Position == 0 )
 		{
-			*dataStream = ws->InternalMemory;
-			return nullptr;
+			array<Byte>^ buffer = TryGetBuffer( ms );
+			if( buffer != nullptr && buffer->Length == readLength )
+			{
+				ms->Position = readLength;
+				return buffer;
+			}
 		}
 
 		array<Byte>^ buffer = gcnew array<Byte>( readLength ); 
@@ -360,6 +370,115 @@ namespace SlimDX
 		return buffer;
 	}
 
+	array<Byte>^ Utilities::TryGetBuffer( MemoryStream^ stream )
+	{
+		try
+		{
+			return stream->GetBuffer();
+		}
+		catch( UnauthorizedAccessException^ )
+		{
+			return nullptr;
+		}
+	}
+
+	DataStream^ Utilities::ReadStreamView( Stream^ stream, int% readLength, bool allowBorrow )
+	{
+		if( stream == nullptr )
+			throw gcnew ArgumentNullException( "stream" );
+		if( !stream->CanRead )
+			throw gcnew NotSupportedException();
+
+		Int64 position = stream->Position;
+		if( readLength > stream->Length - position )
+			throw gcnew ArgumentOutOfRangeException( "readLength" );
+		if( readLength == 0 )
+			readLength = static_cast<int>( stream->Length - position );
+		if( readLength < 0 )
+			throw gcnew ArgumentOutOfRangeException( "readLength" );
+		if( readLength == 0 )
+			return nullptr;
+
+		DataStream^ result = nullptr;
+
+		DataStream^ ds = dynamic_cast<DataStream^>( stream );
+		WaveStream^ ws = dynamic_cast<WaveStream^>( stream );
+		UnmanagedMemoryStream^ ums = dynamic_cast<UnmanagedMemoryStream^>( stream );
+		MemoryStream^ ms = dynamic_cast<MemoryStream^>( stream );
+		FileStream^ fs = dynamic_cast<FileStream^>( stream );
+
+		if( ds != nullptr )
+		{
+			result = ds->Slice( position, readLength );
+		}
+		else if( ws != nullptr && ws->InternalMemory != nullptr )
+		{
+			result = ws->InternalMemory->Slice( position, readLength );
+		}
+		else if( ums != nullptr && allowBorrow )
+		{
+			result = gcnew DataStream( ums->PositionPointer, readLength, true, false, false );
+		}
+		else if( ms != nullptr )
+		{
+			// GetBuffer hands back the whole array, and a stream built over part of an array starts at an origin
+			// we cannot read on this framework. Only a stream whose capacity spans the array provably starts at 0.
+			array<Byte>^ buffer = TryGetBuffer( ms );
+			if( buffer != nullptr && ms->Capacity == buffer->Length )
+			{
+				// the slice keeps the pin alive after we let go of the parent
+				DataStream^ pinned = gcnew DataStream( buffer, true, false );
+				result = pinned->Slice( position, readLength );
+				delete pinned;
+			}
+		}
+		else if( fs != nullptr && readLength >= MapThreshold )
+		{
+			if( fs->CanWrite )
+				fs->Flush();
+
+			result = MappedFile::Map( fs, position, readLength );
+		}
+
+		if( result != nullptr )
+		{
+			stream->Seek( readLength, SeekOrigin::Current );
+			return result;
+		}
+
+		result = gcnew DataStream( readLength, true, true );
+
+		array<Byte>^ chunk = Threading::Interlocked::Exchange( s_TransferBuffer, static_cast<array<Byte>^>( nullptr ) );
+		if( chunk == nullptr )
+			chunk = gcnew array<Byte>( TransferBufferSize );
+
+		try
+		{
+			int bytesRead = 0;
+			while( bytesRead < readLength )
+			{
+				int count = stream->Read( chunk, 0, min( chunk->Length, readLength - bytesRead ) );
+				if( count == 0 )
+					throw gcnew EndOfStreamException();
+
+				result->Write( chunk, 0, count );
+				bytesRead += count;
+			}
+		}
+		catch( Exception^ )
+		{
+			delete result;
+			throw;
+		}
+		finally
+		{
+			s_TransferBuffer = chunk;
+		}
+
+		result->Position = 0;
+		return result;
+	}
+
 	void Utilities::CheckArrayBounds( Array^ data, int offset, int% count )
 	{
 		if( data == nullptr )
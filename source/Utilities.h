@@ -45,6 +45,12 @@ namespace SlimDX
 	{
 	private:
 		Utilities();
+
+		literal int TransferBufferSize = 64 * 1024;
+		literal int MapThreshold = 256 * 1024;
+		static array<System::Byte>^ s_TransferBuffer;
+
+		static array<System::Byte>^ TryGetBuffer( System::IO::MemoryStream^ stream );
 		
 	public:
 		static GUID GetNativeGuidForType( System::Type^ type );
@@ -63,9 +69,25 @@ namespace SlimDX
 		static System::String^ BlobToString( ID3D10Blob *blob );
 		static System::String^ BufferToString( ID3DXBuffer *buffer );
 
+		static DataStream^ AsDataStream( System::IO::Stream^ stream );
 		static array<System::Byte>^ ReadStream( System::IO::Stream^ stream, DataStream^* dataStream );
 		static array<System::Byte>^ ReadStream( System::IO::Stream^ stream, int% readLength, DataStream^* dataStream );
 
+		/// <summary>
+		/// Reads a range of a stream into a <see cref="DataStream"/>, borrowing the source's memory instead of copying it where possible.
+		/// </summary>
+		/// <remarks>
+		/// DataStreams, WaveStreams and MemoryStreams with an exposable buffer are sliced in place, and large FileStreams are
+		/// memory mapped. UnmanagedMemoryStreams are only borrowed when <paramref name="allowBorrow"/> is set, since their memory
+		/// cannot be kept alive on the caller's behalf. Anything else is read in pooled chunks into a single native allocation.
+		/// The source stream is advanced past the range in every case, and the caller owns the returned stream.
+		/// </remarks>
+		/// <param name="stream">The stream to read from.</param>
+		/// <param name="readLength">The number of bytes to read, or zero to read to the end of the stream. Receives the number of bytes read.</param>
+		/// <param name="allowBorrow"><c>true</c> if the result may point directly into memory whose lifetime is controlled by the caller.</param>
+		/// <returns>A stream over the data, or <c>nullptr</c> if there was nothing to read.</returns>
+		static DataStream^ ReadStreamView( System::IO::Stream^ stream, int% readLength, bool allowBorrow );
+
 		generic<typename T> where T : value class
 		static array<T>^ ReadRange( ID3DXBuffer *buffer, int count );
 
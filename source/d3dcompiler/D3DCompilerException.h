@@ -23,7 +23,7 @@
 
 #include "../SlimDXException.h"
 
-#define RECORD_D3DC(x) Result::Record<D3DCompilerException^>( (x), (nullptr), (nullptr) )
+#define RECORD_D3DC(x) Result::Record<D3DCompilerException^>( SLIMDX_INSTRUMENT_RESULT(x), (nullptr), (nullptr) )
 
 namespace SlimDX
 {
@@ -21,7 +21,7 @@
 */
 #pragma once
 
-#define RECORD_D2D(x) Result::Record<Direct2DException^>( (x), (nullptr), (nullptr) )
+#define RECORD_D2D(x) Result::Record<Direct2DException^>( SLIMDX_INSTRUMENT_RESULT(x), (nullptr), (nullptr) )
 
 #include "../SlimDXException.h"
 
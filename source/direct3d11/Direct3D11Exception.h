@@ -23,7 +23,7 @@
 
 #include "../SlimDXException.h"
 
-#define RECORD_D3D11(x) Result::Record<Direct3D11Exception^>( (x), (nullptr), (nullptr) )
+#define RECORD_D3D11(x) Result::Record<Direct3D11Exception^>( SLIMDX_INSTRUMENT_RESULT(x), (nullptr), (nullptr) )
 
 namespace SlimDX
 {
@@ -998,6 +998,24 @@ namespace SlimDX
 			UseLegacyD3DX9_31Dll = D3DXSHADER_USE_LEGACY_D3DX9_31_DLL
 		};
 
+		/// <summary>
+		/// Specifies how <see cref="SkinningEngine"/> blends the bone transforms of a vertex.
+		/// </summary>
+		/// <unmanaged>None</unmanaged>
+		public enum class SkinningMethod : System::Int32
+		{
+			/// <summary>
+			/// The bone matrices are blended linearly, as <see cref="SkinInfo"/>.UpdateSkinnedMesh does.
+			/// </summary>
+			Linear,
+
+			/// <summary>
+			/// The bone transforms are blended as dual quaternions, which keeps volume at twisting joints. Scale in the bone
+			/// matrices is ignored.
+			/// </summary>
+			DualQuaternion
+		};
+
 		/// <summary>
 		/// Flags used to specify sprite rendering options to the flags parameter in the Sprite.Begin method.
 		/// </summary>
@@ -23,7 +23,7 @@
 
 #include "../SlimDXException.h"
 
-#define RECORD_D3D9(x) Result::Record<Direct3D9Exception^>( (x), (nullptr), (nullptr) )
+#define RECORD_D3D9(x) Result::Record<Direct3D9Exception^>( SLIMDX_INSTRUMENT_RESULT(x), (nullptr), (nullptr) )
 
 namespace SlimDX
 {
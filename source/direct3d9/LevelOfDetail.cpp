@@ -0,0 +1,67 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "LevelOfDetail.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+	LevelOfDetail::LevelOfDetail( array<int>^ indices, array<int>^ faceRemap, float geometricError )
+	: indices( indices ), faceRemap( faceRemap ), geometricError( geometricError )
+	{
+	}
+
+	float LevelOfDetail::GetScreenSpaceError( float distance, float verticalFieldOfView, float viewportHeight )
+	{
+		if( !( distance > 0.0f ) )
+			throw gcnew ArgumentOutOfRangeException( "distance" );
+		if( !( verticalFieldOfView > 0.0f ) || verticalFieldOfView >= static_cast<float>( Math::PI ) )
+			throw gcnew ArgumentOutOfRangeException( "verticalFieldOfView" );
+
+		double pixelsPerUnit = viewportHeight / ( 2.0 * distance * Math::Tan( verticalFieldOfView * 0.5 ) );
+		return static_cast<float>( geometricError * pixelsPerUnit );
+	}
+
+	int LevelOfDetail::SelectLevel( array<LevelOfDetail^>^ levels, float distance, float verticalFieldOfView, float viewportHeight, float maximumScreenSpaceError )
+	{
+		if( levels == nullptr )
+			throw gcnew ArgumentNullException( "levels" );
+		if( levels->Length == 0 )
+			throw gcnew ArgumentException( "There must be at least one level.", "levels" );
+
+		// errors only grow down the chain, so the first level that is too coarse ends the search
+		int result = 0;
+		for( int i = 1; i < levels->Length; i++ )
+		{
+			if( levels[i]->GetScreenSpaceError( distance, verticalFieldOfView, viewportHeight ) > maximumScreenSpaceError )
+				break;
+			result = i;
+		}
+
+		return result;
+	}
+}
+}
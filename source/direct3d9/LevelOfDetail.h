@@ -0,0 +1,92 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		/// <summary>
+		/// One level of a chain of simplified versions of a mesh. Every level uses the vertices of the original mesh.
+		/// </summary>
+		/// <unmanaged>None</unmanaged>
+		public ref class LevelOfDetail sealed
+		{
+		private:
+			array<int>^ indices;
+			array<int>^ faceRemap;
+			float geometricError;
+
+		internal:
+			LevelOfDetail( array<int>^ indices, array<int>^ faceRemap, float geometricError );
+
+		public:
+			/// <summary>
+			/// Gets the number of faces in the level.
+			/// </summary>
+			property int FaceCount
+			{
+				int get() { return indices->Length / 3; }
+			}
+
+			/// <summary>
+			/// Gets the largest distance by which the level departs from the original surface, in the units of the vertex positions.
+			/// </summary>
+			property float GeometricError
+			{
+				float get() { return geometricError; }
+			}
+
+			/// <summary>
+			/// Gets the 32-bit indices of the faces of the level, which refer to the original vertices.
+			/// </summary>
+			/// <returns>Three indices per face.</returns>
+			array<int>^ GetIndices() { return indices; }
+
+			/// <summary>
+			/// Gets the original face that each face of the level came from, so that attributes can be carried over.
+			/// </summary>
+			/// <returns>The original face of each face.</returns>
+			array<int>^ GetFaceRemap() { return faceRemap; }
+
+			/// <summary>
+			/// Projects the geometric error of the level onto the screen.
+			/// </summary>
+			/// <param name="distance">The distance from the camera to the mesh.</param>
+			/// <param name="verticalFieldOfView">The vertical field of view of the camera, in radians.</param>
+			/// <param name="viewportHeight">The height of the viewport, in pixels.</param>
+			/// <returns>The error, in pixels.</returns>
+			float GetScreenSpaceError( float distance, float verticalFieldOfView, float viewportHeight );
+
+			/// <summary>
+			/// Picks the coarsest level whose error on screen stays within a limit.
+			/// </summary>
+			/// <param name="levels">The levels, from finest to coarsest.</param>
+			/// <param name="distance">The distance from the camera to the mesh.</param>
+			/// <param name="verticalFieldOfView">The vertical field of view of the camera, in radians.</param>
+			/// <param name="viewportHeight">The height of the viewport, in pixels.</param>
+			/// <param name="maximumScreenSpaceError">The largest error allowed, in pixels.</param>
+			/// <returns>The index of the level to draw.</returns>
+			static int SelectLevel( array<LevelOfDetail^>^ levels, float distance, float verticalFieldOfView, float viewportHeight, float maximumScreenSpaceError );
+		};
+	}
+}
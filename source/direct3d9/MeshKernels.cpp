@@ -0,0 +1,793 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "MeshKernels.h"
+
+#ifdef _MANAGED
+#pragma managed(push, off)
+#endif
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+namespace MeshKernels
+{
+	// the constants from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+	const float CacheDecayPower = 1.5f;
+	const float LastTriangleScore = 0.75f;
+	const float ValenceBoostScale = 2.0f;
+	const float ValenceBoostPower = 0.5f;
+
+	static float VertexScore( int cachePosition, unsigned int liveTriangles )
+	{
+		if( liveTriangles == 0 )
+			return -1.0f;
+
+		float score = 0.0f;
+		if( cachePosition >= 0 )
+		{
+			// the last triangle's vertices get a fixed score, so the next triangle does not simply reuse its edge
+			if( cachePosition < 3 )
+				score = LastTriangleScore;
+			else
+				score = powf( 1.0f - ( cachePosition - 3 ) * ( 1.0f / ( OptimizerCacheSize - 3 ) ), CacheDecayPower );
+		}
+
+		return score + ValenceBoostScale * powf( static_cast<float>( liveTriangles ), -ValenceBoostPower );
+	}
+
+	static void IndexRange( const unsigned int *indices, unsigned int indexCount, unsigned int &first, unsigned int &count )
+	{
+		if( indexCount == 0 )
+		{
+			first = 0;
+			count = 0;
+			return;
+		}
+
+		unsigned int low = indices[0];
+		unsigned int high = indices[0];
+		for( unsigned int i = 1; i < indexCount; i++ )
+		{
+			low = ( std::min )( low, indices[i] );
+			high = ( std::max )( high, indices[i] );
+		}
+
+		first = low;
+		count = high - low + 1;
+	}
+
+	void OptimizeVertexCache( const unsigned int *indices, unsigned int faceCount, unsigned int *order )
+	{
+		if( faceCount == 0 )
+			return;
+
+		// subsets usually use a small window of the vertex buffer, so only that window gets per-vertex state
+		unsigned int base;
+		unsigned int span;
+		IndexRange( indices, faceCount * 3, base, span );
+
+		std::vector<unsigned int> offsets( span + 1, 0 );
+		for( unsigned int i = 0; i < faceCount * 3; i++ )
+			offsets[indices[i] - base + 1]++;
+		for( unsigned int v = 0; v < span; v++ )
+			offsets[v + 1] += offsets[v];
+
+		// each vertex keeps its live triangles at the front of its slice of the adjacency list
+		std::vector<unsigned int> live( span );
+		std::vector<unsigned int> adjacency( faceCount * 3 );
+		for( unsigned int v = 0; v < span; v++ )
+			live[v] = 0;
+		for( unsigned int i = 0; i < faceCount * 3; i++ )
+		{
+			unsigned int v = indices[i] - base;
+			adjacency[offsets[v] + live[v]++] = i / 3;
+		}
+
+		std::vector<int> cachePosition( span, -1 );
+		std::vector<float> vertexScore( span );
+		for( unsigned int v = 0; v < span; v++ )
+			vertexScore[v] = VertexScore( -1, live[v] );
+
+		std::vector<float> faceScore( faceCount );
+		std::vector<bool> emitted( faceCount, false );
+		for( unsigned int f = 0; f < faceCount; f++ )
+			faceScore[f] = vertexScore[indices[f * 3] - base] + vertexScore[indices[f * 3 + 1] - base] + vertexScore[indices[f * 3 + 2] - base];
+
+		unsigned int cache[OptimizerCacheSize + 3];
+		unsigned int cacheCount = 0;
+		unsigned int cursor = 0;
+		int best = -1;
+
+		for( unsigned int output = 0; output < faceCount; output++ )
+		{
+			// nothing in the cache has live faces left, so start again from the first face not yet emitted
+			if( best < 0 )
+			{
+				while( emitted[cursor] )
+					cursor++;
+				best = static_cast<int>( cursor );
+			}
+
+			unsigned int face = static_cast<unsigned int>( best );
+			order[output] = face;
+			emitted[face] = true;
+
+			unsigned int newCache[OptimizerCacheSize + 3];
+			unsigned int newCount = 0;
+			for( unsigned int corner = 0; corner < 3; corner++ )
+			{
+				unsigned int v = indices[face * 3 + corner] - base;
+
+				unsigned int *faces = &adjacency[offsets[v]];
+				for( unsigned int i = 0; i < live[v]; i++ )
+				{
+					if( faces[i] == face )
+					{
+						faces[i] = faces[--live[v]];
+						break;
+					}
+				}
+
+				bool present = false;
+				for( unsigned int i = 0; i < newCount; i++ )
+					present = present || newCache[i] == v;
+				if( !present )
+					newCache[newCount++] = v;
+			}
+
+			for( unsigned int i = 0; i < cacheCount; i++ )
+			{
+				unsigned int v = cache[i];
+				if( v != newCache[0] && ( newCount < 2 || v != newCache[1] ) && ( newCount < 3 || v != newCache[2] ) )
+					newCache[newCount++] = v;
+			}
+
+			// rescore everything that was in the cache, including what just fell out of it, and pass the change on to the faces
+			for( unsigned int i = 0; i < newCount; i++ )
+			{
+				unsigned int v = newCache[i];
+				cachePosition[v] = i < OptimizerCacheSize ? static_cast<int>( i ) : -1;
+
+				float score = VertexScore( cachePosition[v], live[v] );
+				float change = score - vertexScore[v];
+				vertexScore[v] = score;
+
+				const unsigned int *faces = &adjacency[offsets[v]];
+				for( unsigned int j = 0; j < live[v]; j++ )
+					faceScore[faces[j]] += change;
+			}
+
+			cacheCount = ( std::min )( newCount, OptimizerCacheSize );
+			memcpy( cache, newCache, cacheCount * sizeof( unsigned int ) );
+
+			best = -1;
+			float bestScore = -1.0f;
+			for( unsigned int i = 0; i < cacheCount; i++ )
+			{
+				unsigned int v = cache[i];
+				const unsigned int *faces = &adjacency[offsets[v]];
+				for( unsigned int j = 0; j < live[v]; j++ )
+				{
+					if( faceScore[faces[j]] > bestScore )
+					{
+						bestScore = faceScore[faces[j]];
+						best = static_cast<int>( faces[j] );
+					}
+				}
+			}
+		}
+	}
+
+	struct Cluster
+	{
+		unsigned int Start;
+		unsigned int Count;
+		float Sort;
+	};
+
+	static bool FrontToBack( const Cluster &left, const Cluster &right )
+	{
+		return left.Sort > right.Sort;
+	}
+
+	static const float *Position( const unsigned char *positions, unsigned int stride, unsigned int vertex )
+	{
+		return reinterpret_cast<const float*>( positions + static_cast<size_t>( vertex ) * stride );
+	}
+
+	void OptimizeOverdraw( const unsigned int *indices, unsigned int *order, unsigned int faceCount, const unsigned char *positions, unsigned int stride, unsigned int cacheSize )
+	{
+		if( faceCount < 2 )
+			return;
+
+		unsigned int base = indices[order[0] * 3];
+		unsigned int high = base;
+		for( unsigned int f = 0; f < faceCount; f++ )
+		{
+			for( unsigned int corner = 0; corner < 3; corner++ )
+			{
+				base = ( std::min )( base, indices[order[f] * 3 + corner] );
+				high = ( std::max )( high, indices[order[f] * 3 + corner] );
+			}
+		}
+
+		unsigned int span = high - base + 1;
+
+		// a FIFO cache as in SimulateVertexCache; a face that misses on every vertex is where the cache order started over
+		std::vector<unsigned int> stamps( span, 0 );
+		unsigned int time = cacheSize + 1;
+
+		std::vector<Cluster> clusters;
+		for( unsigned int f = 0; f < faceCount; f++ )
+		{
+			unsigned int misses = 0;
+			for( unsigned int corner = 0; corner < 3; corner++ )
+			{
+				unsigned int v = indices[order[f] * 3 + corner] - base;
+				if( time - stamps[v] > cacheSize )
+				{
+					stamps[v] = time++;
+					misses++;
+				}
+			}
+
+			if( f == 0 || misses == 3 )
+			{
+				Cluster cluster = { f, 0, 0.0f };
+				clusters.push_back( cluster );
+			}
+
+			clusters.back().Count++;
+		}
+
+		if( clusters.size() < 2 )
+			return;
+
+		// area weighted centroids and normals for each cluster, and the centroid of the whole subset
+		std::vector<float> centroids( clusters.size() * 3, 0.0f );
+		std::vector<float> normals( clusters.size() * 3, 0.0f );
+		std::vector<float> areas( clusters.size(), 0.0f );
+		float center[3] = { 0.0f, 0.0f, 0.0f };
+		float totalArea = 0.0f;
+
+		for( size_t i = 0; i < clusters.size(); i++ )
+		{
+			for( unsigned int f = clusters[i].Start; f < clusters[i].Start + clusters[i].Count; f++ )
+			{
+				const unsigned int *face = indices + order[f] * 3;
+				const float *a = Position( positions, stride, face[0] );
+				const float *b = Position( positions, stride, face[1] );
+				const float *c = Position( positions, stride, face[2] );
+
+				float u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+				float w[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+				float n[3] = { u[1] * w[2] - u[2] * w[1], u[2] * w[0] - u[0] * w[2], u[0] * w[1] - u[1] * w[0] };
+				float area = sqrtf( n[0] * n[0] + n[1] * n[1] + n[2] * n[2] );
+
+				for( int k = 0; k < 3; k++ )
+				{
+					float mid = ( a[k] + b[k] + c[k] ) * ( 1.0f / 3.0f );
+					centroids[i * 3 + k] += mid * area;
+					normals[i * 3 + k] += n[k];
+					center[k] += mid * area;
+				}
+
+				areas[i] += area;
+				totalArea += area;
+			}
+		}
+
+		if( totalArea > 0.0f )
+		{
+			for( int k = 0; k < 3; k++ )
+				center[k] /= totalArea;
+		}
+
+		for( size_t c = 0; c < clusters.size(); c++ )
+		{
+			const float *n = &normals[c * 3];
+			float length = sqrtf( n[0] * n[0] + n[1] * n[1] + n[2] * n[2] );
+			if( areas[c] <= 0.0f || length <= 0.0f )
+				continue;
+
+			float sort = 0.0f;
+			for( int k = 0; k < 3; k++ )
+				sort += ( centroids[c * 3 + k] / areas[c] - center[k] ) * n[k];
+			clusters[c].Sort = sort / length;
+		}
+
+		std::stable_sort( clusters.begin(), clusters.end(), FrontToBack );
+
+		std::vector<unsigned int> sorted( faceCount );
+		unsigned int output = 0;
+		for( size_t c = 0; c < clusters.size(); c++ )
+		{
+			for( unsigned int f = clusters[c].Start; f < clusters[c].Start + clusters[c].Count; f++ )
+				sorted[output++] = order[f];
+		}
+
+		memcpy( order, &sorted[0], faceCount * sizeof( unsigned int ) );
+	}
+
+	unsigned int BuildFetchOrder( const unsigned int *indices, unsigned int indexCount, unsigned int vertexCount, unsigned int *vertexOrder )
+	{
+		std::vector<bool> used( vertexCount, false );
+		unsigned int count = 0;
+
+		for( unsigned int i = 0; i < indexCount; i++ )
+		{
+			unsigned int v = indices[i];
+			if( !used[v] )
+			{
+				used[v] = true;
+				vertexOrder[count++] = v;
+			}
+		}
+
+		unsigned int result = count;
+		for( unsigned int v = 0; v < vertexCount; v++ )
+		{
+			if( !used[v] )
+				vertexOrder[count++] = v;
+		}
+
+		return result;
+	}
+
+	CacheStatistics SimulateVertexCache( const unsigned int *indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize )
+	{
+		CacheStatistics result = { 0, 0 };
+
+		// a FIFO cache only moves on a miss, so a vertex is still cached while fewer than cacheSize misses followed its own
+		std::vector<unsigned int> stamps( vertexCount, 0 );
+		unsigned int time = cacheSize + 1;
+
+		for( unsigned int i = 0; i < indexCount; i++ )
+		{
+			unsigned int v = indices[i];
+			if( stamps[v] == 0 )
+				result.ReferencedVertices++;
+
+			if( time - stamps[v] > cacheSize )
+			{
+				stamps[v] = time++;
+				result.Misses++;
+			}
+		}
+
+		return result;
+	}
+
+	// the finalizer of MurmurHash3, which spreads every input bit over the whole key
+	static unsigned long long Mix( unsigned long long key )
+	{
+		key ^= key >> 33;
+		key *= 0xff51afd7ed558ccdULL;
+		key ^= key >> 33;
+		key *= 0xc4ceb93e2ddb1a53ULL;
+		key ^= key >> 33;
+		return key;
+	}
+
+	unsigned int HashBucket( unsigned long long key )
+	{
+		return static_cast<unsigned int>( Mix( key ) >> 56 );
+	}
+
+	void PartitionEntries( const HashEntry *entries, unsigned int count, HashEntry *output, unsigned int *bucketStarts )
+	{
+		memset( bucketStarts, 0, ( HashBucketCount + 1 ) * sizeof( unsigned int ) );
+		for( unsigned int i = 0; i < count; i++ )
+			bucketStarts[HashBucket( entries[i].Key ) + 1]++;
+		for( unsigned int b = 0; b < HashBucketCount; b++ )
+			bucketStarts[b + 1] += bucketStarts[b];
+
+		std::vector<unsigned int> next( bucketStarts, bucketStarts + HashBucketCount );
+		for( unsigned int i = 0; i < count; i++ )
+			output[next[HashBucket( entries[i].Key )]++] = entries[i];
+	}
+
+	static bool EntryLess( const HashEntry &left, const HashEntry &right )
+	{
+		return left.Key < right.Key || ( left.Key == right.Key && left.Value < right.Value );
+	}
+
+	void SortEntries( HashEntry *entries, unsigned int count )
+	{
+		std::sort( entries, entries + count, EntryLess );
+	}
+
+	static long long CellCoordinate( float value, float cellSize )
+	{
+		if( value != value )
+			return 0;
+
+		// far enough out that neighbouring cells never wrap around
+		const double Limit = 1e15;
+		double cell = floor( static_cast<double>( value ) / cellSize );
+		return static_cast<long long>( ( std::max )( -Limit, ( std::min )( Limit, cell ) ) );
+	}
+
+	static unsigned int FloatBits( float value )
+	{
+		// negative zero has to land in the same cell as zero
+		if( value == 0.0f )
+			value = 0.0f;
+
+		unsigned int bits;
+		memcpy( &bits, &value, sizeof( bits ) );
+		return bits;
+	}
+
+	static unsigned long long CellKey( long long x, long long y, long long z )
+	{
+		unsigned long long key = Mix( static_cast<unsigned long long>( x ) );
+		key = Mix( key ^ static_cast<unsigned long long>( y ) );
+		return Mix( key ^ static_cast<unsigned long long>( z ) );
+	}
+
+	static unsigned long long PositionKey( const float *position, float cellSize, int x, int y, int z )
+	{
+		if( cellSize <= 0.0f )
+			return CellKey( FloatBits( position[0] ), FloatBits( position[1] ), FloatBits( position[2] ) );
+
+		return CellKey( CellCoordinate( position[0], cellSize ) + x, CellCoordinate( position[1], cellSize ) + y, CellCoordinate( position[2], cellSize ) + z );
+	}
+
+	void HashPositions( const unsigned char *positions, unsigned int stride, float cellSize, unsigned int begin, unsigned int end, HashEntry *entries )
+	{
+		for( unsigned int v = begin; v < end; v++ )
+		{
+			entries[v].Key = PositionKey( Position( positions, stride, v ), cellSize, 0, 0, 0 );
+			entries[v].Value = v;
+		}
+	}
+
+	static bool ComponentMatches( const unsigned char *left, const unsigned char *right, const VertexComponent &component )
+	{
+		left += component.Offset;
+		right += component.Offset;
+
+		switch( component.Kind )
+		{
+		case FloatComponent:
+			for( unsigned int i = 0; i < component.Size / sizeof( float ); i++ )
+			{
+				float a;
+				float b;
+				memcpy( &a, left + i * sizeof( float ), sizeof( float ) );
+				memcpy( &b, right + i * sizeof( float ), sizeof( float ) );
+				if( !( fabsf( a - b ) <= component.Epsilon ) )
+					return false;
+			}
+			return true;
+
+		case ColorComponent:
+			for( unsigned int i = 0; i < component.Size; i++ )
+			{
+				if( abs( left[i] - right[i] ) > component.Epsilon * 255.0f )
+					return false;
+			}
+			return true;
+
+		default:
+			return memcmp( left, right, component.Size ) == 0;
+		}
+	}
+
+	static bool VertexMatches( const unsigned char *left, const unsigned char *right, const VertexComponent *components, unsigned int componentCount )
+	{
+		for( unsigned int c = 0; c < componentCount; c++ )
+		{
+			if( !ComponentMatches( left, right, components[c] ) )
+				return false;
+		}
+
+		return true;
+	}
+
+	void FindMatches( const HashEntry *table, const unsigned int *bucketStarts, const unsigned char *vertices, unsigned int stride, float cellSize,
+		const VertexComponent *components, unsigned int componentCount, unsigned int begin, unsigned int end, unsigned int *matches )
+	{
+		// anything within epsilon is at most one cell away, unless positions have to match exactly
+		int reach = cellSize > 0.0f ? 1 : 0;
+
+		for( unsigned int v = begin; v < end; v++ )
+		{
+			const unsigned char *vertex = vertices + static_cast<size_t>( v ) * stride;
+			const float *position = reinterpret_cast<const float*>( vertex + components[0].Offset );
+			unsigned int best = v;
+
+			for( int z = -reach; z <= reach; z++ )
+			{
+				for( int y = -reach; y <= reach; y++ )
+				{
+					for( int x = -reach; x <= reach; x++ )
+					{
+						HashEntry probe = { PositionKey( position, cellSize, x, y, z ), 0 };
+						unsigned int bucket = HashBucket( probe.Key );
+						const HashEntry *last = table + bucketStarts[bucket + 1];
+
+						// entries are sorted by vertex within a key, so the first match in each cell is its lowest
+						for( const HashEntry *entry = std::lower_bound( table + bucketStarts[bucket], last, probe, EntryLess );
+							entry != last && entry->Key == probe.Key && entry->Value < best; entry++ )
+						{
+							if( VertexMatches( vertex, vertices + static_cast<size_t>( entry->Value ) * stride, components, componentCount ) )
+							{
+								best = entry->Value;
+								break;
+							}
+						}
+					}
+				}
+			}
+
+			matches[v] = best;
+		}
+	}
+
+	void ResolveMatches( unsigned int *matches, unsigned int vertexCount )
+	{
+		// every match is lower than its vertex, so it has already been resolved
+		for( unsigned int v = 0; v < vertexCount; v++ )
+			matches[v] = matches[matches[v]];
+	}
+
+	void CopyPartialMatches( unsigned char *vertices, unsigned int stride, const unsigned int *representatives,
+		const VertexComponent *components, unsigned int componentCount, unsigned int begin, unsigned int end )
+	{
+		for( unsigned int v = begin; v < end; v++ )
+		{
+			unsigned int representative = representatives[v];
+			if( representative == v )
+				continue;
+
+			unsigned char *vertex = vertices + static_cast<size_t>( v ) * stride;
+			const unsigned char *source = vertices + static_cast<size_t>( representative ) * stride;
+			for( unsigned int c = 0; c < componentCount; c++ )
+			{
+				if( ComponentMatches( vertex, source, components[c] ) )
+					memcpy( vertex + components[c].Offset, source + components[c].Offset, components[c].Size );
+			}
+		}
+	}
+
+	const unsigned long long CollapsedEdge = ~0ULL;
+
+	void BuildEdges( const unsigned int *indices, const unsigned int *pointReps, unsigned int begin, unsigned int end, HashEntry *edges )
+	{
+		for( unsigned int f = begin; f < end; f++ )
+		{
+			for( unsigned int e = 0; e < 3; e++ )
+			{
+				unsigned int a = pointReps[indices[f * 3 + e]];
+				unsigned int b = pointReps[indices[f * 3 + ( e + 1 ) % 3]];
+
+				HashEntry &edge = edges[f * 3 + e];
+				edge.Key = a == b ? CollapsedEdge : ( static_cast<unsigned long long>( ( std::min )( a, b ) ) << 32 ) | ( std::max )( a, b );
+				edge.Value = f * 3 + e;
+			}
+		}
+	}
+
+	void PairEdges( const HashEntry *edges, unsigned int count, const unsigned int *indices, const unsigned int *pointReps, unsigned int *adjacency )
+	{
+		const unsigned int Unpaired = 0xffffffff;
+
+		unsigned int start = 0;
+		while( start < count )
+		{
+			unsigned int end = start + 1;
+			while( end < count && edges[end].Key == edges[start].Key )
+				end++;
+
+			for( unsigned int i = start; i < end && edges[i].Key != CollapsedEdge; i++ )
+			{
+				unsigned int edge = edges[i].Value;
+				if( adjacency[edge] != Unpaired )
+					continue;
+
+				// most edges have one partner; past that, the first one running the other way wins
+				unsigned int partner = Unpaired;
+				for( unsigned int j = i + 1; j < end; j++ )
+				{
+					unsigned int other = edges[j].Value;
+					if( adjacency[other] != Unpaired || other / 3 == edge / 3 )
+						continue;
+
+					if( pointReps[indices[edge]] == pointReps[indices[other / 3 * 3 + ( other + 1 ) % 3]] )
+					{
+						partner = other;
+						break;
+					}
+
+					if( partner == Unpaired )
+						partner = other;
+				}
+
+				if( partner != Unpaired )
+				{
+					adjacency[edge] = partner / 3;
+					adjacency[partner] = edge / 3;
+				}
+			}
+
+			start = end;
+		}
+	}
+
+	static unsigned int FindRoot( std::vector<unsigned int> &parents, unsigned int v )
+	{
+		while( parents[v] != v )
+		{
+			parents[v] = parents[parents[v]];
+			v = parents[v];
+		}
+
+		return v;
+	}
+
+	// Merges two vertices, keeping the lower one as the root so the result does not depend on the order of the merges.
+	static bool MergeVertices( std::vector<unsigned int> &parents, unsigned int a, unsigned int b )
+	{
+		a = FindRoot( parents, a );
+		b = FindRoot( parents, b );
+		if( a == b )
+			return false;
+
+		if( a < b )
+			parents[b] = a;
+		else
+			parents[a] = b;
+
+		return true;
+	}
+
+	// Matches edge e of face f against the edges of its neighbour g that point back at f, in both directions, and merges
+	// the ends the best match pairs up. A match counts the ends already known to be the same vertex; a neighbour may be
+	// wound either way and may share more than one edge with f, so only a single best match is trusted. When no end
+	// matches yet, guessing is allowed only for a lone back edge, which is then taken to run the other way, as
+	// consistently wound neighbours do. With positions known, a match has to agree on both of them instead.
+	static bool MatchSharedEdge( const unsigned int *indices, unsigned int f, unsigned int e, unsigned int g, const unsigned int *adjacency,
+		const unsigned int *positionReps, std::vector<unsigned int> &parents, bool guess )
+	{
+		unsigned int ends[2] = { indices[f * 3 + e], indices[f * 3 + ( e + 1 ) % 3] };
+
+		if( positionReps != NULL )
+		{
+			for( unsigned int back = 0; back < 3; back++ )
+			{
+				if( adjacency[g * 3 + back] != f )
+					continue;
+
+				unsigned int start = indices[g * 3 + back];
+				unsigned int finish = indices[g * 3 + ( back + 1 ) % 3];
+				unsigned int candidates[2][2] = { { finish, start }, { start, finish } };
+				for( int c = 0; c < 2; c++ )
+				{
+					if( positionReps[ends[0]] == positionReps[candidates[c][0]] && positionReps[ends[1]] == positionReps[candidates[c][1]] )
+					{
+						bool merged = MergeVertices( parents, ends[0], candidates[c][0] );
+						return MergeVertices( parents, ends[1], candidates[c][1] ) || merged;
+					}
+				}
+			}
+
+			return false;
+		}
+
+		int bestScore = -1;
+		int bestCount = 0;
+		unsigned int best[2] = { 0, 0 };
+		unsigned int backEdges = 0;
+
+		for( unsigned int back = 0; back < 3; back++ )
+		{
+			if( adjacency[g * 3 + back] != f )
+				continue;
+
+			backEdges++;
+			unsigned int start = indices[g * 3 + back];
+			unsigned int finish = indices[g * 3 + ( back + 1 ) % 3];
+
+			// the opposite direction first, so it wins a guess
+			unsigned int candidates[2][2] = { { finish, start }, { start, finish } };
+			for( int c = 0; c < 2; c++ )
+			{
+				int score = ( FindRoot( parents, ends[0] ) == FindRoot( parents, candidates[c][0] ) ? 1 : 0 ) +
+					( FindRoot( parents, ends[1] ) == FindRoot( parents, candidates[c][1] ) ? 1 : 0 );
+
+				if( score > bestScore )
+				{
+					bestScore = score;
+					bestCount = 1;
+					best[0] = candidates[c][0];
+					best[1] = candidates[c][1];
+				}
+				else if( score == bestScore && ( candidates[c][0] != best[0] || candidates[c][1] != best[1] ) )
+				{
+					bestCount++;
+				}
+			}
+		}
+
+		if( backEdges == 0 || bestScore == 2 )
+			return false;
+		if( bestScore == 0 && !( guess && backEdges == 1 ) )
+			return false;
+		if( bestScore == 1 && bestCount > 1 )
+			return false;
+
+		bool merged = MergeVertices( parents, ends[0], best[0] );
+		return MergeVertices( parents, ends[1], best[1] ) || merged;
+	}
+
+	void AdjacencyToPointReps( const unsigned int *indices, unsigned int faceCount, const unsigned int *adjacency, unsigned int vertexCount,
+		const unsigned int *positionReps, unsigned int *pointReps )
+	{
+		std::vector<unsigned int> parents( vertexCount );
+		for( unsigned int v = 0; v < vertexCount; v++ )
+			parents[v] = v;
+
+		// edges whose ends already tell the direction go first, and every merge can settle more of them; only when
+		// nothing else is left does an edge between two unrelated pairs of vertices get the benefit of the doubt
+		bool guess = false;
+		while( true )
+		{
+			bool changed = false;
+			for( unsigned int f = 0; f < faceCount; f++ )
+			{
+				for( unsigned int e = 0; e < 3; e++ )
+				{
+					unsigned int g = adjacency[f * 3 + e];
+					if( g < faceCount && g != f && MatchSharedEdge( indices, f, e, g, adjacency, positionReps, parents, guess ) )
+						changed = true;
+				}
+			}
+
+			if( changed )
+				guess = false;
+			else if( !guess && positionReps == NULL )
+				guess = true;
+			else
+				break;
+		}
+
+		for( unsigned int v = 0; v < vertexCount; v++ )
+			pointReps[v] = FindRoot( parents, v );
+	}
+}
+}
+}
+
+#ifdef _MANAGED
+#pragma managed(pop)
+#endif
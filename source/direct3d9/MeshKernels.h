@@ -0,0 +1,127 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+// Portable mesh processing for indexed triangle lists. Indices are always 32-bit here; callers widen 16-bit
+// index buffers first. Nothing in here depends on Windows or the CLR.
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		namespace MeshKernels
+		{
+			// The cache size modelled when ordering faces. Orders built for this size also do well on smaller caches.
+			const unsigned int OptimizerCacheSize = 32;
+
+			struct CacheStatistics
+			{
+				unsigned int Misses;
+				unsigned int ReferencedVertices;
+			};
+
+			// Orders faces for a post-transform vertex cache with Forsyth's linear-speed algorithm. order receives the
+			// input face for each output face.
+			void OptimizeVertexCache( const unsigned int *indices, unsigned int faceCount, unsigned int *order );
+
+			// Reorders the clusters of a cache-optimized face order so that faces on the outside of the mesh come first,
+			// after Tipsify. A cluster starts wherever the cache order had to start afresh, so the cache behaviour inside
+			// clusters is kept. positions points at the position of vertex 0 and stride is the distance between vertices.
+			void OptimizeOverdraw( const unsigned int *indices, unsigned int *order, unsigned int faceCount, const unsigned char *positions, unsigned int stride, unsigned int cacheSize );
+
+			// Orders vertices by first use in the index list, followed by the unused vertices in their original order.
+			// vertexOrder receives the input vertex for each output vertex. Returns the number of vertices used.
+			unsigned int BuildFetchOrder( const unsigned int *indices, unsigned int indexCount, unsigned int vertexCount, unsigned int *vertexOrder );
+
+			// Runs the index list through a FIFO cache of the given size.
+			CacheStatistics SimulateVertexCache( const unsigned int *indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize );
+
+			// Vertex components compared when welding. Floats are compared element by element and colors channel by
+			// channel against the epsilon; anything else has to match exactly.
+			enum ComponentKind
+			{
+				FloatComponent,
+				ColorComponent,
+				ExactComponent
+			};
+
+			struct VertexComponent
+			{
+				unsigned int Offset;
+				unsigned int Size;
+				ComponentKind Kind;
+				float Epsilon;
+			};
+
+			// An entry in a hash table that is built by sorting rather than by insertion, so it comes out the same
+			// however the work was split up. Value is a vertex for spatial hashes and a face edge for edge maps.
+			struct HashEntry
+			{
+				unsigned long long Key;
+				unsigned int Value;
+			};
+
+			// Entries are spread over this many buckets by key, so each bucket can be sorted on its own.
+			const unsigned int HashBucketCount = 256;
+
+			unsigned int HashBucket( unsigned long long key );
+
+			// Distributes entries into buckets, keeping their order within each bucket. bucketStarts receives
+			// HashBucketCount + 1 offsets into output.
+			void PartitionEntries( const HashEntry *entries, unsigned int count, HashEntry *output, unsigned int *bucketStarts );
+
+			// Sorts entries by key and then by value.
+			void SortEntries( HashEntry *entries, unsigned int count );
+
+			// Keys vertices [begin, end) by the cell of a grid of the given size that holds their position. A cell
+			// size of zero keys them by their exact position instead.
+			void HashPositions( const unsigned char *positions, unsigned int stride, float cellSize, unsigned int begin, unsigned int end, HashEntry *entries );
+
+			// For vertices [begin, end), finds the lowest numbered vertex that matches on every component, or the
+			// vertex itself. components[0] must be the position, and cellSize the one the table was hashed with.
+			void FindMatches( const HashEntry *table, const unsigned int *bucketStarts, const unsigned char *vertices, unsigned int stride, float cellSize,
+				const VertexComponent *components, unsigned int componentCount, unsigned int begin, unsigned int end, unsigned int *matches );
+
+			// Follows the matches of all vertices, in order, so each ends up with the lowest vertex of its group.
+			void ResolveMatches( unsigned int *matches, unsigned int vertexCount );
+
+			// For vertices [begin, end) that are not their own representative, copies every component that is within
+			// epsilon of the representative's.
+			void CopyPartialMatches( unsigned char *vertices, unsigned int stride, const unsigned int *representatives,
+				const VertexComponent *components, unsigned int componentCount, unsigned int begin, unsigned int end );
+
+			// Keys the edges of faces [begin, end) by the point representatives of their ends. Edges that collapse to a
+			// point get a key that never pairs.
+			void BuildEdges( const unsigned int *indices, const unsigned int *pointReps, unsigned int begin, unsigned int end, HashEntry *edges );
+
+			// Pairs up the sorted edges of one bucket into adjacency, preferring edges that run in opposite directions.
+			// Unpaired edges are left alone, so adjacency should start out as 0xffffffff.
+			void PairEdges( const HashEntry *edges, unsigned int count, const unsigned int *indices, const unsigned int *pointReps, unsigned int *adjacency );
+
+			// Merges the vertices at the two ends of every shared edge, leaving each vertex with the lowest numbered
+			// vertex it was merged with. Each edge is matched to the back edge whose ends agree with it, whichever way
+			// the neighbour is wound; an edge whose ends cannot be matched up is left alone. positionReps, if not NULL,
+			// gives the vertices at the same position the same value, and only those are merged.
+			void AdjacencyToPointReps( const unsigned int *indices, unsigned int faceCount, const unsigned int *adjacency, unsigned int vertexCount,
+				const unsigned int *positionReps, unsigned int *pointReps );
+		}
+	}
+}
@@ -0,0 +1,462 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <d3d9.h>
+#include <d3dx9.h>
+#include <string.h>
+#include <vector>
+
+#include "../ComObject.h"
+#include "../DataStream.h"
+#include "../ParallelLoop.h"
+
+#include "Direct3D9Exception.h"
+#include "ResultCode9.h"
+
+#include "Mesh.h"
+#include "MeshStreams.h"
+#include "MeshTopology.h"
+#include "TangentKernels.h"
+#include "MeshNormals.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+	// a face or vertex is a few dozen flops, so hand them out in large ranges
+	const int ElementsPerRange = 2048;
+
+	ref class FrameJob sealed
+	{
+	public:
+		const unsigned int *Indices;
+		unsigned char *Vertices;
+		unsigned int Stride;
+		unsigned int PositionOffset;
+		unsigned int NormalOffset;
+		unsigned int TextureOffset;
+		const TangentKernels::FrameOptions *Options;
+		const TangentKernels::FrameLayout *Layout;
+		const unsigned int *Groups;
+		const unsigned int *Starts;
+		const unsigned int *Corners;
+		TangentKernels::Contribution *Contributions;
+		TangentKernels::Contribution *Positive;
+		TangentKernels::Contribution *Negative;
+		const unsigned int *Splits;
+
+		void FaceNormals( int begin, int end )
+		{
+			TangentKernels::FaceNormals( Indices, Vertices + PositionOffset, Stride, *Options, begin, end, Contributions );
+		}
+
+		void GatherNormals( int begin, int end )
+		{
+			TangentKernels::GatherNormals( Starts, Corners, Contributions, Groups, begin, end, Vertices + NormalOffset, Stride );
+		}
+
+		void FaceTangents( int begin, int end )
+		{
+			TangentKernels::FaceTangents( Indices, Vertices + PositionOffset, Vertices + NormalOffset, Vertices + TextureOffset, Stride, *Options, begin, end, Contributions );
+		}
+
+		void GatherTangents( int begin, int end )
+		{
+			TangentKernels::GatherTangents( Starts, Corners, Contributions, begin, end, Positive, Negative );
+		}
+
+		void WriteFrames( int begin, int end )
+		{
+			TangentKernels::WriteFrames( Vertices, *Layout, Positive, Negative, Splits, *Options, begin, end );
+		}
+	};
+
+	static int RequireElement( array<VertexElement>^ declaration, DeclarationUsage usage, int usageIndex, DeclarationType type, int size, int vertexStride, String^ name )
+	{
+		int offset = FindVertexElement( declaration, usage, usageIndex, type );
+		if( offset < 0 )
+			throw gcnew ArgumentException( String::Format( "The declaration has no {0}.", name ), "declaration" );
+		if( offset + size > vertexStride )
+			throw gcnew ArgumentException( "The declaration does not fit in the vertex stride.", "declaration" );
+
+		return offset;
+	}
+
+	static TangentKernels::FrameOptions MakeOptions( TangentOptions options )
+	{
+		TangentKernels::FrameOptions result;
+		if( ( options & TangentOptions::WeightByArea ) == TangentOptions::WeightByArea )
+			result.Weights = TangentKernels::WeightByArea;
+		else if( ( options & TangentOptions::WeightEqual ) == TangentOptions::WeightEqual )
+			result.Weights = TangentKernels::WeightEqually;
+		else
+			result.Weights = TangentKernels::WeightByAngle;
+
+		result.Clockwise = ( options & TangentOptions::WindCW ) == TangentOptions::WindCW;
+		result.WrapU = ( options & TangentOptions::WrapU ) == TangentOptions::WrapU;
+		result.WrapV = ( options & TangentOptions::WrapV ) == TangentOptions::WrapV;
+		result.Orthogonalize = ( options & TangentOptions::DontOrthogonalize ) != TangentOptions::DontOrthogonalize;
+		return result;
+	}
+
+	static void CheckCounts( int faceCount, int vertexCount, int vertexStride, array<VertexElement>^ declaration )
+	{
+		if( faceCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "faceCount" );
+		if( vertexCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexCount" );
+		if( vertexStride <= 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexStride" );
+		if( declaration == nullptr )
+			throw gcnew ArgumentNullException( "declaration" );
+	}
+
+	static std::vector<unsigned int> ReadPointReps( array<int>^ pointReps, int vertexCount )
+	{
+		std::vector<unsigned int> result;
+		if( pointReps == nullptr )
+			return result;
+
+		if( pointReps->Length < vertexCount )
+			throw gcnew ArgumentException( "There must be a point representative for each vertex.", "pointReps" );
+
+		result.resize( vertexCount );
+		for( int i = 0; i < vertexCount; i++ )
+		{
+			if( pointReps[i] < 0 || pointReps[i] >= vertexCount )
+				throw gcnew ArgumentException( "A point representative refers to a vertex past the end of the vertex data.", "pointReps" );
+			result[i] = pointReps[i];
+		}
+
+		return result;
+	}
+
+	// Faces run in parallel to produce their corner normals, then vertices in parallel to sum the corners of their group.
+	static void RunNormals( FrameJob^ job, int faceCount, int vertexCount, const std::vector<unsigned int> &groups )
+	{
+		std::vector<unsigned int> starts( vertexCount + 1 );
+		std::vector<unsigned int> corners( faceCount * 3 + 1 );
+		std::vector<TangentKernels::Contribution> contributions( faceCount * 3 + 1 );
+
+		job->Groups = groups.empty() ? NULL : &groups[0];
+		job->Starts = &starts[0];
+		job->Corners = &corners[0];
+		job->Contributions = &contributions[0];
+
+		TangentKernels::BuildCornerLists( job->Indices, faceCount, job->Groups, vertexCount, &starts[0], &corners[0] );
+		ParallelLoop::For( faceCount, ElementsPerRange, gcnew ParallelRange( job, &FrameJob::FaceNormals ) );
+		ParallelLoop::For( vertexCount, ElementsPerRange, gcnew ParallelRange( job, &FrameJob::GatherNormals ) );
+	}
+
+	// Fills the index and attribute buffers and the attribute table of a mesh made to hold split vertices.
+	static bool CopyMeshBuffers( Mesh^ mesh, Mesh^ result, DataStream^ indices, int faceCount, int indexBytes )
+	{
+		bool sixteenBitIndices = ( mesh->CreationOptions & MeshFlags::Use32Bit ) != MeshFlags::Use32Bit;
+
+		DataStream^ destination = result->LockIndexBuffer( LockFlags::None );
+		if( destination == nullptr )
+			return false;
+		memcpy( destination->PositionPointer, indices->PositionPointer, indexBytes );
+		result->UnlockIndexBuffer();
+
+		DataStream^ source = mesh->LockAttributeBuffer( LockFlags::ReadOnly );
+		if( source == nullptr )
+			return false;
+
+		try
+		{
+			destination = result->LockAttributeBuffer( LockFlags::None );
+			if( destination == nullptr )
+				return false;
+			memcpy( destination->PositionPointer, source->PositionPointer, faceCount * sizeof( DWORD ) );
+			result->UnlockAttributeBuffer();
+		}
+		finally
+		{
+			mesh->UnlockAttributeBuffer();
+		}
+
+		array<AttributeRange>^ table = mesh->GetAttributeTable();
+		if( table == nullptr )
+			return true;
+
+		UpdateVertexRanges( table, ReadMeshIndices( indices, sixteenBitIndices, faceCount ) );
+		return result->SetAttributeTable( table ).IsSuccess;
+	}
+
+	void MeshNormals::ComputeNormals( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride,
+		array<VertexElement>^ declaration, array<int>^ pointReps, TangentOptions options )
+	{
+		CheckCounts( faceCount, vertexCount, vertexStride, declaration );
+		int positionOffset = RequireElement( declaration, DeclarationUsage::Position, 0, DeclarationType::Float3, 12, vertexStride, "three-component float position" );
+		int normalOffset = RequireElement( declaration, DeclarationUsage::Normal, 0, DeclarationType::Float3, 12, vertexStride, "three-component float normal" );
+
+		std::vector<unsigned int> values = ReadMeshIndices( indices, sixteenBitIndices, faceCount );
+		CheckMeshStream( vertices, static_cast<Int64>( vertexCount ) * vertexStride, "vertices" );
+		CheckMeshIndices( values, vertexCount );
+		std::vector<unsigned int> groups = ReadPointReps( pointReps, vertexCount );
+
+		if( vertexCount == 0 || faceCount == 0 )
+			return;
+
+		TangentKernels::FrameOptions frameOptions = MakeOptions( options );
+
+		FrameJob^ job = gcnew FrameJob();
+		job->Indices = &values[0];
+		job->Vertices = reinterpret_cast<unsigned char*>( vertices->PositionPointer );
+		job->Stride = vertexStride;
+		job->PositionOffset = positionOffset;
+		job->NormalOffset = normalOffset;
+		job->Options = &frameOptions;
+
+		RunNormals( job, faceCount, vertexCount, groups );
+	}
+
+	Result MeshNormals::ComputeNormals( Mesh^ mesh, TangentOptions options )
+	{
+		if( mesh == nullptr )
+			throw gcnew ArgumentNullException( "mesh" );
+
+		int faceCount = mesh->FaceCount;
+		int vertexCount = mesh->VertexCount;
+		bool sixteenBitIndices = ( mesh->CreationOptions & MeshFlags::Use32Bit ) != MeshFlags::Use32Bit;
+		array<VertexElement>^ declaration = mesh->GetDeclaration();
+		array<int>^ adjacency = mesh->GetAdjacency();
+
+		DataStream^ indices = mesh->LockIndexBuffer( LockFlags::ReadOnly );
+		if( indices == nullptr )
+			return RECORD_D3D9( E_FAIL );
+
+		DataStream^ vertices = nullptr;
+		try
+		{
+			vertices = mesh->LockVertexBuffer( LockFlags::None );
+			if( vertices == nullptr )
+				return RECORD_D3D9( E_FAIL );
+
+			array<int>^ pointReps = nullptr;
+			if( adjacency != nullptr )
+				pointReps = MeshTopology::ConvertAdjacencyToPointReps( indices, sixteenBitIndices, faceCount, vertexCount, adjacency );
+
+			ComputeNormals( indices, sixteenBitIndices, faceCount, vertices, vertexCount, mesh->BytesPerVertex, declaration, pointReps, options );
+		}
+		finally
+		{
+			if( vertices != nullptr )
+				mesh->UnlockVertexBuffer();
+			mesh->UnlockIndexBuffer();
+		}
+
+		return ResultCode::Success;
+	}
+
+	int MeshNormals::ComputeTangentFrame( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride,
+		array<VertexElement>^ declaration, int textureIndex, array<int>^ pointReps, TangentOptions options, bool splitDiscontinuities,
+		[Out] array<int>^% vertexMapping )
+	{
+		CheckCounts( faceCount, vertexCount, vertexStride, declaration );
+		if( textureIndex < 0 || textureIndex > 7 )
+			throw gcnew ArgumentOutOfRangeException( "textureIndex" );
+
+		TangentKernels::FrameLayout layout;
+		layout.Stride = vertexStride;
+		layout.NormalOffset = RequireElement( declaration, DeclarationUsage::Normal, 0, DeclarationType::Float3, 12, vertexStride, "three-component float normal" );
+		layout.TangentOffset = FindVertexElement( declaration, DeclarationUsage::Tangent, 0, DeclarationType::Float4 );
+		layout.TangentHasSign = layout.TangentOffset >= 0;
+		if( layout.TangentOffset < 0 )
+			layout.TangentOffset = FindVertexElement( declaration, DeclarationUsage::Tangent, 0, DeclarationType::Float3 );
+		layout.BinormalOffset = FindVertexElement( declaration, DeclarationUsage::Binormal, 0, DeclarationType::Float3 );
+
+		if( layout.TangentOffset < 0 && layout.BinormalOffset < 0 )
+			throw gcnew ArgumentException( "The declaration has neither a float tangent nor a float binormal.", "declaration" );
+		if( layout.TangentOffset + ( layout.TangentHasSign ? 16 : 12 ) > vertexStride || layout.BinormalOffset + 12 > vertexStride )
+			throw gcnew ArgumentException( "The declaration does not fit in the vertex stride.", "declaration" );
+
+		int positionOffset = RequireElement( declaration, DeclarationUsage::Position, 0, DeclarationType::Float3, 12, vertexStride, "three-component float position" );
+		int textureOffset = RequireElement( declaration, DeclarationUsage::TextureCoordinate, textureIndex, DeclarationType::Float2, 8, vertexStride, "two-component float texture coordinate" );
+
+		std::vector<unsigned int> values = ReadMeshIndices( indices, sixteenBitIndices, faceCount );
+		CheckMeshStream( vertices, static_cast<Int64>( vertexCount ) * vertexStride, "vertices" );
+		CheckMeshIndices( values, vertexCount );
+		std::vector<unsigned int> groups = ReadPointReps( pointReps, vertexCount );
+
+		vertexMapping = gcnew array<int>( vertexCount );
+		for( int i = 0; i < vertexCount; i++ )
+			vertexMapping[i] = i;
+
+		if( vertexCount == 0 || faceCount == 0 )
+			return vertexCount;
+
+		TangentKernels::FrameOptions frameOptions = MakeOptions( options );
+		unsigned char *data = reinterpret_cast<unsigned char*>( vertices->PositionPointer );
+
+		FrameJob^ job = gcnew FrameJob();
+		job->Indices = &values[0];
+		job->Vertices = data;
+		job->Stride = vertexStride;
+		job->PositionOffset = positionOffset;
+		job->NormalOffset = layout.NormalOffset;
+		job->TextureOffset = textureOffset;
+		job->Options = &frameOptions;
+		job->Layout = &layout;
+
+		if( ( options & TangentOptions::CalculateNormals ) == TangentOptions::CalculateNormals )
+			RunNormals( job, faceCount, vertexCount, groups );
+
+		// tangents follow the texture mapping, so they are only ever shared by corners of the same vertex
+		std::vector<unsigned int> starts( vertexCount + 1 );
+		std::vector<unsigned int> corners( faceCount * 3 );
+		std::vector<TangentKernels::Contribution> contributions( faceCount * 3 );
+		std::vector<TangentKernels::Contribution> positive( vertexCount );
+		std::vector<TangentKernels::Contribution> negative( vertexCount );
+
+		job->Starts = &starts[0];
+		job->Corners = &corners[0];
+		job->Contributions = &contributions[0];
+		job->Positive = &positive[0];
+		job->Negative = &negative[0];
+
+		TangentKernels::BuildCornerLists( &values[0], faceCount, NULL, vertexCount, &starts[0], &corners[0] );
+		ParallelLoop::For( faceCount, ElementsPerRange, gcnew ParallelRange( job, &FrameJob::FaceTangents ) );
+		ParallelLoop::For( vertexCount, ElementsPerRange, gcnew ParallelRange( job, &FrameJob::GatherTangents ) );
+
+		// the mirrored side of each vertex used both ways gets a new vertex at the end, in vertex order
+		int total = vertexCount;
+		std::vector<unsigned int> splits;
+		if( splitDiscontinuities )
+		{
+			splits.assign( vertexCount, ~0u );
+			for( int v = 0; v < vertexCount; v++ )
+			{
+				if( positive[v].W > 0.0f && negative[v].W > 0.0f )
+					splits[v] = total++;
+			}
+		}
+
+		if( total > vertexCount )
+		{
+			if( sixteenBitIndices && total > 65536 )
+				throw gcnew ArgumentException( "The split vertices cannot be addressed with 16-bit indices.", "indices" );
+			CheckMeshStream( vertices, static_cast<Int64>( total ) * vertexStride, "vertices" );
+
+			vertexMapping = gcnew array<int>( total );
+			for( int v = 0; v < vertexCount; v++ )
+			{
+				vertexMapping[v] = v;
+				if( splits[v] != ~0u )
+				{
+					vertexMapping[splits[v]] = v;
+					memcpy( data + static_cast<size_t>( splits[v] ) * vertexStride, data + static_cast<size_t>( v ) * vertexStride, vertexStride );
+				}
+			}
+
+			job->Splits = &splits[0];
+		}
+
+		ParallelLoop::For( vertexCount, ElementsPerRange, gcnew ParallelRange( job, &FrameJob::WriteFrames ) );
+
+		if( total > vertexCount )
+		{
+			for( size_t i = 0; i < values.size(); i++ )
+			{
+				if( splits[values[i]] != ~0u && contributions[i].W < 0.0f )
+					values[i] = splits[values[i]];
+			}
+
+			WriteMeshIndices( indices, sixteenBitIndices, values );
+		}
+
+		return total;
+	}
+
+	Mesh^ MeshNormals::ComputeTangentFrame( Mesh^ mesh, int textureIndex, TangentOptions options, bool splitDiscontinuities, [Out] array<int>^% vertexMapping )
+	{
+		if( mesh == nullptr )
+			throw gcnew ArgumentNullException( "mesh" );
+
+		vertexMapping = nullptr;
+
+		int faceCount = mesh->FaceCount;
+		int vertexCount = mesh->VertexCount;
+		int vertexStride = mesh->BytesPerVertex;
+		bool sixteenBitIndices = ( mesh->CreationOptions & MeshFlags::Use32Bit ) != MeshFlags::Use32Bit;
+		int indexBytes = faceCount * 3 * ( sixteenBitIndices ? 2 : 4 );
+		array<VertexElement>^ declaration = mesh->GetDeclaration();
+		array<int>^ adjacency = mesh->GetAdjacency();
+
+		// work on copies, with room for every vertex to split, since the mesh cannot grow in place
+		DataStream^ indices = gcnew DataStream( indexBytes, true, true );
+		DataStream^ vertices = gcnew DataStream( static_cast<Int64>( vertexCount ) * vertexStride * 2, true, true );
+
+		DataStream^ source = mesh->LockIndexBuffer( LockFlags::ReadOnly );
+		if( source == nullptr )
+			return nullptr;
+		indices->WriteRange( IntPtr( source->PositionPointer ), indexBytes );
+		mesh->UnlockIndexBuffer();
+		indices->Position = 0;
+
+		source = mesh->LockVertexBuffer( LockFlags::ReadOnly );
+		if( source == nullptr )
+			return nullptr;
+		vertices->WriteRange( IntPtr( source->PositionPointer ), static_cast<Int64>( vertexCount ) * vertexStride );
+		mesh->UnlockVertexBuffer();
+		vertices->Position = 0;
+
+		array<int>^ pointReps = nullptr;
+		if( adjacency != nullptr )
+			pointReps = MeshTopology::ConvertAdjacencyToPointReps( indices, sixteenBitIndices, faceCount, vertexCount, adjacency );
+
+		int total = ComputeTangentFrame( indices, sixteenBitIndices, faceCount, vertices, vertexCount, vertexStride, declaration,
+			textureIndex, pointReps, options, splitDiscontinuities, vertexMapping );
+
+		Mesh^ result = mesh;
+		if( total > vertexCount )
+		{
+			result = gcnew Mesh( mesh->Device, faceCount, total, mesh->CreationOptions, declaration );
+			result->SetAdjacency( adjacency );
+			result->SetMaterials( mesh->GetMaterials() );
+			result->SetEffects( mesh->GetEffects() );
+
+			if( !CopyMeshBuffers( mesh, result, indices, faceCount, indexBytes ) )
+			{
+				delete result;
+				return nullptr;
+			}
+		}
+
+		DataStream^ destination = result->LockVertexBuffer( LockFlags::None );
+		if( destination == nullptr )
+		{
+			if( result != mesh )
+				delete result;
+			return nullptr;
+		}
+		memcpy( destination->PositionPointer, vertices->PositionPointer, static_cast<size_t>( total ) * vertexStride );
+		result->UnlockVertexBuffer();
+
+		return result;
+	}
+}
+}
@@ -0,0 +1,120 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "../DataStream.h"
+
+#include "D3DXEnums.h"
+#include "VertexElement.h"
+
+using System::Runtime::InteropServices::OutAttribute;
+
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		ref class Mesh;
+
+		/// <summary>
+		/// Generates vertex normals and tangent frames for indexed triangle lists without D3DX, spreading the work
+		/// across threads.
+		/// </summary>
+		/// <remarks>
+		/// Normals are weighted by the angle of each face at the vertex unless <see cref="TangentOptions::WeightByArea"/> or
+		/// <see cref="TangentOptions::WeightEqual"/> is given. Tangents follow MikkTSpace: each points along increasing u in
+		/// the plane of the normal, and the bitangent is the cross product of the normal and the tangent multiplied by the
+		/// handedness. <see cref="TangentOptions::WindCW"/>, <see cref="TangentOptions::WrapU"/>, <see cref="TangentOptions::WrapV"/>,
+		/// <see cref="TangentOptions::DontOrthogonalize"/> and <see cref="TangentOptions::CalculateNormals"/> are honoured; other
+		/// options are ignored. Results do not depend on the number of threads.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class MeshNormals sealed
+		{
+		private:
+			MeshNormals() { }
+
+		public:
+			/// <summary>
+			/// Computes a normal for every vertex of a triangle list.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <param name="vertices">The vertex data. The normals are written into it.</param>
+			/// <param name="vertexCount">The number of vertices.</param>
+			/// <param name="vertexStride">The size of a vertex, in bytes.</param>
+			/// <param name="declaration">The layout of the vertices. It must have a three-component float position and normal in stream 0.</param>
+			/// <param name="pointReps">The point representative of each vertex, so that vertices at the same point share a normal, or <c>null</c>.</param>
+			/// <param name="options">The weighting and winding options.</param>
+			static void ComputeNormals( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride,
+				array<VertexElement>^ declaration, array<int>^ pointReps, TangentOptions options );
+
+			/// <summary>
+			/// Computes the vertex normals of a mesh, sharing them across vertices joined by the adjacency of the mesh.
+			/// </summary>
+			/// <param name="mesh">The mesh.</param>
+			/// <param name="options">The weighting and winding options.</param>
+			/// <returns>A <see cref="SlimDX::Result"/> object describing the result of the operation.</returns>
+			static Result ComputeNormals( Mesh^ mesh, TangentOptions options );
+
+			/// <summary>
+			/// Computes a tangent frame for every vertex of a triangle list.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list. Corners that move to split vertices are rewritten.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <param name="vertices">The vertex data. The frames are written into it, and split vertices are added after the existing ones.</param>
+			/// <param name="vertexCount">The number of vertices.</param>
+			/// <param name="vertexStride">The size of a vertex, in bytes.</param>
+			/// <param name="declaration">
+			/// The layout of the vertices. It must have a three-component float position and normal and a two-component float
+			/// texture coordinate in stream 0, and a tangent (three or four floats; the fourth receives the handedness), a binormal
+			/// (three floats), or both.
+			/// </param>
+			/// <param name="textureIndex">The usage index of the texture coordinate to follow.</param>
+			/// <param name="pointReps">The point representative of each vertex, used for normals when <see cref="TangentOptions::CalculateNormals"/> is given, or <c>null</c>.</param>
+			/// <param name="options">The tangent options.</param>
+			/// <param name="splitDiscontinuities">
+			/// <c>true</c> to give a vertex used by both mirrored and unmirrored faces a second copy for the mirrored ones; <c>false</c>
+			/// to give it the frame of whichever is more common. The vertex data must have room for up to <paramref name="vertexCount"/>
+			/// more vertices when splitting.
+			/// </param>
+			/// <param name="vertexMapping">When the method completes, contains the original vertex of each vertex.</param>
+			/// <returns>The number of vertices, including split ones.</returns>
+			static int ComputeTangentFrame( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride,
+				array<VertexElement>^ declaration, int textureIndex, array<int>^ pointReps, TangentOptions options, bool splitDiscontinuities,
+				[Out] array<int>^% vertexMapping );
+
+			/// <summary>
+			/// Computes the tangent frames of a mesh.
+			/// </summary>
+			/// <param name="mesh">The mesh.</param>
+			/// <param name="textureIndex">The usage index of the texture coordinate to follow.</param>
+			/// <param name="options">The tangent options.</param>
+			/// <param name="splitDiscontinuities"><c>true</c> to split vertices used by both mirrored and unmirrored faces.</param>
+			/// <param name="vertexMapping">When the method completes, contains the original vertex of each vertex of the result.</param>
+			/// <returns>The mesh itself, updated in place, if no vertices were split; otherwise a new mesh with the extra vertices, or
+			/// <c>null</c> on failure.</returns>
+			static Mesh^ ComputeTangentFrame( Mesh^ mesh, int textureIndex, TangentOptions options, bool splitDiscontinuities, [Out] array<int>^% vertexMapping );
+		};
+	}
+}
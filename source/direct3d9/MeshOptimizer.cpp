@@ -0,0 +1,394 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <d3d9.h>
+#include <d3dx9.h>
+#include <algorithm>
+#include <vector>
+
+#include "../ComObject.h"
+#include "../DataStream.h"
+#include "../ParallelLoop.h"
+
+#include "Direct3D9Exception.h"
+#include "ResultCode9.h"
+
+#include "Mesh.h"
+#include "MeshKernels.h"
+#include "MeshStreams.h"
+#include "MeshOptimizer.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+	ref class SubsetOptimizeJob sealed
+	{
+	public:
+		const unsigned int *Indices;
+		unsigned int *Order;
+		const unsigned int *Subsets;
+		const unsigned char *Positions;
+		unsigned int Stride;
+		bool Cache;
+		bool Overdraw;
+
+		void Run( int begin, int end )
+		{
+			for( int subset = begin; subset < end; subset++ )
+			{
+				unsigned int start = Subsets[subset * 2];
+				unsigned int count = Subsets[subset * 2 + 1];
+				const unsigned int *indices = Indices + start * 3;
+				unsigned int *order = Order + start;
+
+				if( Cache )
+					MeshKernels::OptimizeVertexCache( indices, count, order );
+				else
+				{
+					for( unsigned int i = 0; i < count; i++ )
+						order[i] = i;
+				}
+
+				if( Overdraw )
+					MeshKernels::OptimizeOverdraw( indices, order, count, Positions, Stride, MeshKernels::OptimizerCacheSize );
+
+				for( unsigned int i = 0; i < count; i++ )
+					order[i] += start;
+			}
+		}
+	};
+
+	static void ReorderVertices( std::vector<unsigned int> &indices, DataStream^ vertices, int vertexCount, int vertexStride, array<int>^ vertexRemap )
+	{
+		if( vertexCount == 0 )
+			return;
+
+		std::vector<unsigned int> order( vertexCount );
+		MeshKernels::BuildFetchOrder( indices.size() > 0 ? &indices[0] : NULL, static_cast<unsigned int>( indices.size() ), vertexCount, &order[0] );
+
+		std::vector<unsigned int> inverse( vertexCount );
+		for( int i = 0; i < vertexCount; i++ )
+		{
+			inverse[order[i]] = i;
+			vertexRemap[i] = order[i];
+		}
+
+		for( size_t i = 0; i < indices.size(); i++ )
+			indices[i] = inverse[indices[i]];
+
+		char *data = vertices->PositionPointer;
+		std::vector<char> copy( data, data + static_cast<size_t>( vertexCount ) * vertexStride );
+		for( int i = 0; i < vertexCount; i++ )
+			memcpy( data + static_cast<size_t>( i ) * vertexStride, &copy[0] + static_cast<size_t>( order[i] ) * vertexStride, vertexStride );
+	}
+
+	array<int>^ MeshOptimizer::OptimizeVertexCache( DataStream^ indices, bool sixteenBitIndices, int faceCount )
+	{
+		if( faceCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "faceCount" );
+
+		std::vector<unsigned int> source = ReadMeshIndices( indices, sixteenBitIndices, faceCount );
+		array<int>^ faceRemap = gcnew array<int>( faceCount );
+		if( faceCount == 0 )
+			return faceRemap;
+
+		std::vector<unsigned int> order( faceCount );
+		MeshKernels::OptimizeVertexCache( &source[0], faceCount, &order[0] );
+
+		std::vector<unsigned int> result( source.size() );
+		for( int i = 0; i < faceCount; i++ )
+		{
+			faceRemap[i] = order[i];
+			for( int corner = 0; corner < 3; corner++ )
+				result[i * 3 + corner] = source[order[i] * 3 + corner];
+		}
+
+		WriteMeshIndices( indices, sixteenBitIndices, result );
+		return faceRemap;
+	}
+
+	array<int>^ MeshOptimizer::OptimizeVertexFetch( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride )
+	{
+		if( faceCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "faceCount" );
+		if( vertexCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexCount" );
+		if( vertexStride <= 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexStride" );
+
+		std::vector<unsigned int> values = ReadMeshIndices( indices, sixteenBitIndices, faceCount );
+		CheckMeshStream( vertices, static_cast<Int64>( vertexCount ) * vertexStride, "vertices" );
+		CheckMeshIndices( values, vertexCount );
+
+		array<int>^ vertexRemap = gcnew array<int>( vertexCount );
+		ReorderVertices( values, vertices, vertexCount, vertexStride, vertexRemap );
+		WriteMeshIndices( indices, sixteenBitIndices, values );
+
+		return vertexRemap;
+	}
+
+	VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache( DataStream^ indices, bool sixteenBitIndices, int faceCount, int vertexCount, int cacheSize )
+	{
+		if( faceCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "faceCount" );
+		if( vertexCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexCount" );
+		if( cacheSize <= 0 )
+			throw gcnew ArgumentOutOfRangeException( "cacheSize" );
+
+		std::vector<unsigned int> values = ReadMeshIndices( indices, sixteenBitIndices, faceCount );
+		CheckMeshIndices( values, vertexCount );
+
+		VertexCacheStatistics result;
+		result.FaceCount = faceCount;
+		if( faceCount == 0 )
+			return result;
+
+		MeshKernels::CacheStatistics statistics = MeshKernels::SimulateVertexCache( &values[0], static_cast<unsigned int>( values.size() ), vertexCount, cacheSize );
+		result.VertexCount = statistics.ReferencedVertices;
+		result.CacheMissCount = statistics.Misses;
+
+		return result;
+	}
+
+	void MeshOptimizer::Optimize( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride, int positionOffset,
+		array<AttributeRange>^ attributeTable, MeshOptimizeFlags flags, bool optimizeOverdraw, [Out] array<int>^% faceRemap, [Out] array<int>^% vertexRemap )
+	{
+		if( faceCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "faceCount" );
+		if( vertexCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexCount" );
+		if( vertexStride <= 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexStride" );
+		if( optimizeOverdraw && ( positionOffset < 0 || positionOffset + 3 * static_cast<int>( sizeof( float ) ) > vertexStride ) )
+			throw gcnew ArgumentOutOfRangeException( "positionOffset" );
+
+		std::vector<unsigned int> source = ReadMeshIndices( indices, sixteenBitIndices, faceCount );
+		CheckMeshStream( vertices, static_cast<Int64>( vertexCount ) * vertexStride, "vertices" );
+		CheckMeshIndices( source, vertexCount );
+
+		// each subset as a face start and count; faces outside every subset stay where they are
+		std::vector<unsigned int> subsets;
+		if( attributeTable == nullptr )
+		{
+			subsets.push_back( 0 );
+			subsets.push_back( faceCount );
+		}
+		else
+		{
+			std::vector<bool> covered( faceCount, false );
+			for( int i = 0; i < attributeTable->Length; i++ )
+			{
+				int start = attributeTable[i].FaceStart;
+				int count = attributeTable[i].FaceCount;
+				if( start < 0 || count < 0 || start > faceCount - count )
+					throw gcnew ArgumentException( "The attribute table refers to faces past the end of the index data.", "attributeTable" );
+
+				for( int face = start; face < start + count; face++ )
+				{
+					if( covered[face] )
+						throw gcnew ArgumentException( "The subsets in the attribute table overlap.", "attributeTable" );
+					covered[face] = true;
+				}
+
+				subsets.push_back( start );
+				subsets.push_back( count );
+			}
+		}
+
+		std::vector<unsigned int> order( faceCount );
+		for( int i = 0; i < faceCount; i++ )
+			order[i] = i;
+
+		bool cache = ( flags & ( MeshOptimizeFlags::VertexCache | MeshOptimizeFlags::StripReorder ) ) != static_cast<MeshOptimizeFlags>( 0 );
+		if( faceCount > 0 && ( cache || optimizeOverdraw ) )
+		{
+			SubsetOptimizeJob^ job = gcnew SubsetOptimizeJob();
+			job->Indices = &source[0];
+			job->Order = &order[0];
+			job->Subsets = subsets.size() > 0 ? &subsets[0] : NULL;
+			job->Positions = reinterpret_cast<const unsigned char*>( vertices->PositionPointer ) + ( optimizeOverdraw ? positionOffset : 0 );
+			job->Stride = vertexStride;
+			job->Cache = cache;
+			job->Overdraw = optimizeOverdraw;
+
+			// subsets are independent and usually few, so each one is a range of its own
+			ParallelLoop::For( static_cast<int>( subsets.size() / 2 ), 1, gcnew ParallelRange( job, &SubsetOptimizeJob::Run ) );
+		}
+
+		faceRemap = gcnew array<int>( faceCount );
+		std::vector<unsigned int> result( source.size() );
+		for( int i = 0; i < faceCount; i++ )
+		{
+			faceRemap[i] = order[i];
+			for( int corner = 0; corner < 3; corner++ )
+				result[i * 3 + corner] = source[order[i] * 3 + corner];
+		}
+
+		vertexRemap = gcnew array<int>( vertexCount );
+		if( ( flags & MeshOptimizeFlags::IgnoreVertices ) == MeshOptimizeFlags::IgnoreVertices )
+		{
+			for( int i = 0; i < vertexCount; i++ )
+				vertexRemap[i] = i;
+		}
+		else
+			ReorderVertices( result, vertices, vertexCount, vertexStride, vertexRemap );
+
+		WriteMeshIndices( indices, sixteenBitIndices, result );
+
+		if( attributeTable != nullptr )
+			UpdateVertexRanges( attributeTable, result );
+	}
+
+	Result MeshOptimizer::OptimizeInPlace( Mesh^ mesh, MeshOptimizeFlags flags, bool optimizeOverdraw, [Out] array<int>^% faceRemap, [Out] array<int>^% vertexRemap )
+	{
+		if( mesh == nullptr )
+			throw gcnew ArgumentNullException( "mesh" );
+
+		faceRemap = nullptr;
+		vertexRemap = nullptr;
+
+		int faceCount = mesh->FaceCount;
+		int vertexCount = mesh->VertexCount;
+		bool sixteenBitIndices = ( mesh->CreationOptions & MeshFlags::Use32Bit ) != MeshFlags::Use32Bit;
+
+		int positionOffset = -1;
+		if( optimizeOverdraw )
+		{
+			positionOffset = FindVertexElement( mesh->GetDeclaration(), DeclarationUsage::Position, 0, DeclarationType::Float3 );
+			if( positionOffset < 0 )
+				throw gcnew ArgumentException( "Overdraw optimization needs a three-component float position in the mesh.", "mesh" );
+		}
+
+		// nothing to reorder, and an attribute table without faces has no ranges to set
+		if( faceCount == 0 )
+		{
+			faceRemap = gcnew array<int>( 0 );
+			vertexRemap = gcnew array<int>( vertexCount );
+			for( int i = 0; i < vertexCount; i++ )
+				vertexRemap[i] = i;
+
+			return ResultCode::Success;
+		}
+
+		DataStream^ attributes = mesh->LockAttributeBuffer( LockFlags::None );
+		if( attributes == nullptr )
+			return RECORD_D3D9( E_FAIL );
+
+		DataStream^ indices = nullptr;
+		DataStream^ vertices = nullptr;
+		array<AttributeRange>^ ranges = nullptr;
+
+		try
+		{
+			indices = mesh->LockIndexBuffer( LockFlags::None );
+			if( indices == nullptr )
+				return RECORD_D3D9( E_FAIL );
+
+			vertices = mesh->LockVertexBuffer( LockFlags::None );
+			if( vertices == nullptr )
+				return RECORD_D3D9( E_FAIL );
+
+			// group the faces by attribute, keeping their order within each group
+			unsigned int *ids = reinterpret_cast<unsigned int*>( attributes->PositionPointer );
+			std::vector<unsigned long long> keys( faceCount );
+			for( int i = 0; i < faceCount; i++ )
+				keys[i] = ( static_cast<unsigned long long>( ids[i] ) << 32 ) | static_cast<unsigned int>( i );
+			std::sort( keys.begin(), keys.end() );
+
+			std::vector<unsigned int> source = ReadMeshIndices( indices, sixteenBitIndices, faceCount );
+			std::vector<unsigned int> sorted( source.size() );
+			std::vector<unsigned int> sortedIds( faceCount );
+			for( int i = 0; i < faceCount; i++ )
+			{
+				unsigned int face = static_cast<unsigned int>( keys[i] );
+				sortedIds[i] = ids[face];
+				for( int corner = 0; corner < 3; corner++ )
+					sorted[i * 3 + corner] = source[face * 3 + corner];
+			}
+
+			List<AttributeRange>^ table = gcnew List<AttributeRange>();
+			for( int i = 0; i < faceCount; i++ )
+			{
+				ids[i] = sortedIds[i];
+				if( i == 0 || sortedIds[i] != sortedIds[i - 1] )
+				{
+					AttributeRange range;
+					range.AttribId = sortedIds[i];
+					range.FaceStart = i;
+					table->Add( range );
+				}
+			}
+
+			WriteMeshIndices( indices, sixteenBitIndices, sorted );
+
+			ranges = table->ToArray();
+			for( int i = 0; i < ranges->Length; i++ )
+				ranges[i].FaceCount = ( i + 1 < ranges->Length ? ranges[i + 1].FaceStart : faceCount ) - ranges[i].FaceStart;
+
+			array<int>^ optimizedFaces;
+			Optimize( indices, sixteenBitIndices, faceCount, vertices, vertexCount, mesh->BytesPerVertex, positionOffset,
+				ranges, flags, optimizeOverdraw, optimizedFaces, vertexRemap );
+
+			// the optimized order refers to the sorted faces, so map it back through the sort
+			for( int i = 0; i < faceCount; i++ )
+				optimizedFaces[i] = static_cast<unsigned int>( keys[optimizedFaces[i]] );
+			faceRemap = optimizedFaces;
+		}
+		finally
+		{
+			if( vertices != nullptr )
+				mesh->UnlockVertexBuffer();
+			if( indices != nullptr )
+				mesh->UnlockIndexBuffer();
+			mesh->UnlockAttributeBuffer();
+		}
+
+		array<int>^ adjacency = mesh->GetAdjacency();
+		if( adjacency != nullptr )
+		{
+			array<int>^ inverse = gcnew array<int>( faceCount );
+			for( int i = 0; i < faceCount; i++ )
+				inverse[faceRemap[i]] = i;
+
+			array<int>^ remapped = gcnew array<int>( faceCount * 3 );
+			for( int i = 0; i < faceCount; i++ )
+			{
+				for( int edge = 0; edge < 3; edge++ )
+				{
+					int neighbor = adjacency[faceRemap[i] * 3 + edge];
+					remapped[i * 3 + edge] = neighbor < 0 ? -1 : inverse[neighbor];
+				}
+			}
+
+			mesh->SetAdjacency( remapped );
+		}
+
+		return mesh->SetAttributeTable( ranges );
+	}
+}
+}
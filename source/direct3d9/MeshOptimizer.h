@@ -0,0 +1,125 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "../DataStream.h"
+
+#include "AttributeRange.h"
+#include "D3DXEnums.h"
+#include "VertexCacheStatistics.h"
+
+using System::Runtime::InteropServices::OutAttribute;
+
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		ref class Mesh;
+
+		/// <summary>
+		/// Optimizes indexed triangle lists for the post-transform vertex cache, overdraw and vertex fetch without D3DX,
+		/// so meshes can be prepared without a device.
+		/// </summary>
+		/// <remarks>
+		/// Index and vertex data are read and rewritten in place, starting at the current position of each stream; the
+		/// positions are left unchanged. Remap arrays have the same meaning as those returned by Mesh.OptimizeInPlace:
+		/// each element holds the original face or vertex that ended up at that position.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class MeshOptimizer sealed
+		{
+		private:
+			MeshOptimizer() { }
+
+		public:
+			/// <summary>
+			/// Reorders faces for the post-transform vertex cache using Forsyth's linear-speed algorithm.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <returns>The face remap.</returns>
+			static array<int>^ OptimizeVertexCache( DataStream^ indices, bool sixteenBitIndices, int faceCount );
+
+			/// <summary>
+			/// Reorders vertices into the order in which the faces first use them, which makes vertex fetches sequential.
+			/// Vertices that no face uses are moved to the end.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list; the indices are rewritten to match the new order.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <param name="vertices">The vertex data.</param>
+			/// <param name="vertexCount">The number of vertices.</param>
+			/// <param name="vertexStride">The size of a vertex, in bytes.</param>
+			/// <returns>The vertex remap.</returns>
+			static array<int>^ OptimizeVertexFetch( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride );
+
+			/// <summary>
+			/// Runs a triangle list through a simulated FIFO vertex cache.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <param name="vertexCount">The number of vertices the indices refer to.</param>
+			/// <param name="cacheSize">The number of entries in the cache.</param>
+			/// <returns>The cache statistics.</returns>
+			static VertexCacheStatistics AnalyzeVertexCache( DataStream^ indices, bool sixteenBitIndices, int faceCount, int vertexCount, int cacheSize );
+
+			/// <summary>
+			/// Optimizes the faces of every subset for the vertex cache and, optionally, overdraw, and then reorders the
+			/// vertices for fetch. Subsets are processed in parallel.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <param name="vertices">The vertex data.</param>
+			/// <param name="vertexCount">The number of vertices.</param>
+			/// <param name="vertexStride">The size of a vertex, in bytes.</param>
+			/// <param name="positionOffset">The offset of a three-component float position within a vertex. Only needed for overdraw optimization.</param>
+			/// <param name="attributeTable">The subsets of the mesh, or <c>null</c> to treat every face as one subset. Faces never move between
+			/// subsets, and the vertex range of each subset is updated to match the new vertex order.</param>
+			/// <param name="flags"><see cref="MeshOptimizeFlags::VertexCache"/> or <see cref="MeshOptimizeFlags::StripReorder"/> enable face
+			/// reordering, and <see cref="MeshOptimizeFlags::IgnoreVertices"/> leaves the vertices where they are. Other flags are ignored.</param>
+			/// <param name="optimizeOverdraw"><c>true</c> to sort the faces of each subset from the outside in after cache optimization.</param>
+			/// <param name="faceRemap">When the method completes, contains the face remap.</param>
+			/// <param name="vertexRemap">When the method completes, contains the vertex remap.</param>
+			static void Optimize( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride, int positionOffset,
+				array<AttributeRange>^ attributeTable, MeshOptimizeFlags flags, bool optimizeOverdraw, [Out] array<int>^% faceRemap, [Out] array<int>^% vertexRemap );
+
+			/// <summary>
+			/// Optimizes a mesh in place without going through D3DX.
+			/// </summary>
+			/// <remarks>
+			/// The vertex and index buffers keep their size, so unused vertices are moved to the end rather than removed.
+			/// The adjacency stored with the mesh, if any, is remapped to the new face order.
+			/// </remarks>
+			/// <param name="mesh">The mesh to optimize.</param>
+			/// <param name="flags">The optimizations to perform, as for <see cref="Optimize"/>. Faces are always grouped by attribute
+			/// first, as if <see cref="MeshOptimizeFlags::AttributeSort"/> were given, and the attribute table is rebuilt.</param>
+			/// <param name="optimizeOverdraw"><c>true</c> to sort the faces of each subset from the outside in after cache optimization.</param>
+			/// <param name="faceRemap">When the method completes, contains the face remap.</param>
+			/// <param name="vertexRemap">When the method completes, contains the vertex remap.</param>
+			/// <returns>A <see cref="SlimDX::Result"/> object describing the result of the operation.</returns>
+			static Result OptimizeInPlace( Mesh^ mesh, MeshOptimizeFlags flags, bool optimizeOverdraw, [Out] array<int>^% faceRemap, [Out] array<int>^% vertexRemap );
+		};
+	}
+}
@@ -0,0 +1,530 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <d3d9.h>
+#include <d3dx9.h>
+#include <string.h>
+#include <vector>
+
+#include "../ComObject.h"
+#include "../DataStream.h"
+#include "../ParallelLoop.h"
+
+#include "Direct3D9Exception.h"
+
+#include "Mesh.h"
+#include "MeshStreams.h"
+#include "SimplifyKernels.h"
+#include "MeshSimplifier.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+	// finding a collapse reads every face around a vertex, so ranges can be smaller than for the per-face kernels
+	const int ElementsPerRange = 1024;
+
+	ref class SimplifyJob sealed
+	{
+	public:
+		SimplifyKernels::Simplifier *Engine;
+
+		void FaceQuadrics( int begin, int end )
+		{
+			Engine->ComputeFaceQuadrics( begin, end );
+		}
+
+		void GatherQuadrics( int begin, int end )
+		{
+			Engine->GatherQuadrics( begin, end );
+		}
+
+		void FindCollapses( int begin, int end )
+		{
+			Engine->FindCollapses( begin, end );
+		}
+
+		void RemapFaces( int begin, int end )
+		{
+			Engine->RemapFaces( begin, end );
+		}
+	};
+
+	static float WeightOf( AttributeWeights weights, DeclarationUsage usage, int usageIndex )
+	{
+		switch( usage )
+		{
+		case DeclarationUsage::Normal:
+			return usageIndex == 0 ? weights.Normal : 0.0f;
+		case DeclarationUsage::Color:
+			return usageIndex == 0 ? weights.Diffuse : ( usageIndex == 1 ? weights.Specular : 0.0f );
+		case DeclarationUsage::Tangent:
+			return usageIndex == 0 ? weights.Tangent : 0.0f;
+		case DeclarationUsage::Binormal:
+			return usageIndex == 0 ? weights.Binormal : 0.0f;
+		case DeclarationUsage::TextureCoordinate:
+			switch( usageIndex )
+			{
+			case 0: return weights.TextureCoordinate1;
+			case 1: return weights.TextureCoordinate2;
+			case 2: return weights.TextureCoordinate3;
+			case 3: return weights.TextureCoordinate4;
+			case 4: return weights.TextureCoordinate5;
+			case 5: return weights.TextureCoordinate6;
+			case 6: return weights.TextureCoordinate7;
+			case 7: return weights.TextureCoordinate8;
+			}
+			break;
+		}
+
+		return 0.0f;
+	}
+
+	// Picks out the components of stream 0 that have a weight and a float or color type; packed types are left out.
+	static std::vector<SimplifyKernels::Attribute> MakeAttributes( array<VertexElement>^ declaration, AttributeWeights weights, int vertexStride )
+	{
+		std::vector<SimplifyKernels::Attribute> result;
+
+		for( int i = 0; i < declaration->Length; i++ )
+		{
+			VertexElement element = declaration[i];
+			if( element.Stream == 255 )
+				break;
+			if( element.Stream != 0 )
+				continue;
+
+			float weight = WeightOf( weights, element.Usage, element.UsageIndex );
+			if( !( weight > 0.0f ) )
+				continue;
+
+			SimplifyKernels::Attribute attribute;
+			attribute.Offset = element.Offset;
+			attribute.Kind = SimplifyKernels::FloatAttribute;
+			attribute.Weight = weight;
+
+			switch( element.Type )
+			{
+			case DeclarationType::Float1: attribute.Count = 1; break;
+			case DeclarationType::Float2: attribute.Count = 2; break;
+			case DeclarationType::Float3: attribute.Count = 3; break;
+			case DeclarationType::Float4: attribute.Count = 4; break;
+			case DeclarationType::Color: attribute.Count = 4; attribute.Kind = SimplifyKernels::ColorAttribute; break;
+			default: continue;
+			}
+
+			int size = attribute.Kind == SimplifyKernels::ColorAttribute ? 4 : attribute.Count * 4;
+			if( element.Offset + size > vertexStride )
+				throw gcnew ArgumentException( "The declaration does not fit in the vertex stride.", "declaration" );
+
+			result.push_back( attribute );
+		}
+
+		return result;
+	}
+
+	static LevelOfDetail^ CaptureLevel( const SimplifyKernels::Simplifier &engine )
+	{
+		int faceCount = engine.FaceCount();
+		array<int>^ indices = gcnew array<int>( faceCount * 3 );
+		array<int>^ faceRemap = gcnew array<int>( faceCount );
+
+		if( faceCount > 0 )
+		{
+			pin_ptr<int> pinnedIndices = &indices[0];
+			pin_ptr<int> pinnedRemap = &faceRemap[0];
+			memcpy( pinnedIndices, engine.Indices(), faceCount * 3 * sizeof( int ) );
+			memcpy( pinnedRemap, engine.FaceIds(), faceCount * sizeof( int ) );
+		}
+
+		return gcnew LevelOfDetail( indices, faceRemap, engine.Error() );
+	}
+
+	// Runs the simplifier down through each target in turn and records a level at each one. The chain stops early once
+	// a target cannot be reached without going over the error limit or making no progress.
+	static List<LevelOfDetail^>^ RunLevels( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount,
+		int vertexStride, array<VertexElement>^ declaration, AttributeWeights weights, array<float>^ vertexWeights, array<int>^ targets,
+		float maximumError, bool lockBorder )
+	{
+		if( faceCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "faceCount" );
+		if( vertexCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexCount" );
+		if( vertexStride <= 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexStride" );
+		if( declaration == nullptr )
+			throw gcnew ArgumentNullException( "declaration" );
+		if( vertexWeights != nullptr && vertexWeights->Length < vertexCount )
+			throw gcnew ArgumentException( "There must be a weight for each vertex.", "vertexWeights" );
+
+		SimplifyKernels::SimplifierSettings settings;
+		int positionOffset = FindVertexElement( declaration, DeclarationUsage::Position, 0, DeclarationType::Float3 );
+		if( positionOffset < 0 )
+			throw gcnew ArgumentException( "The declaration has no three-component float position.", "declaration" );
+		if( positionOffset + 12 > vertexStride )
+			throw gcnew ArgumentException( "The declaration does not fit in the vertex stride.", "declaration" );
+
+		settings.Stride = vertexStride;
+		settings.PositionOffset = positionOffset;
+		settings.PositionWeight = weights.Position;
+		settings.BoundaryWeight = weights.Boundary;
+		settings.LockBorder = lockBorder;
+
+		std::vector<SimplifyKernels::Attribute> attributes = MakeAttributes( declaration, weights, vertexStride );
+		std::vector<unsigned int> values = ReadMeshIndices( indices, sixteenBitIndices, faceCount );
+		CheckMeshStream( vertices, static_cast<Int64>( vertexCount ) * vertexStride, "vertices" );
+		CheckMeshIndices( values, vertexCount );
+
+		std::vector<float> importance;
+		if( vertexWeights != nullptr )
+		{
+			importance.resize( vertexCount );
+			for( int i = 0; i < vertexCount; i++ )
+				importance[i] = vertexWeights[i];
+		}
+
+		List<LevelOfDetail^>^ levels = gcnew List<LevelOfDetail^>();
+		if( faceCount == 0 || vertexCount == 0 )
+			return levels;
+
+		SimplifyJob^ job = gcnew SimplifyJob();
+
+		// Manual Allocation: released in the finally block below
+		job->Engine = new SimplifyKernels::Simplifier( &values[0], faceCount, reinterpret_cast<unsigned char*>( vertices->PositionPointer ),
+			vertexCount, settings, attributes.empty() ? NULL : &attributes[0], static_cast<unsigned int>( attributes.size() ),
+			importance.empty() ? NULL : &importance[0] );
+
+		try
+		{
+			SimplifyKernels::Simplifier &engine = *job->Engine;
+
+			ParallelLoop::For( faceCount, ElementsPerRange, gcnew ParallelRange( job, &SimplifyJob::FaceQuadrics ) );
+			ParallelLoop::For( vertexCount, ElementsPerRange, gcnew ParallelRange( job, &SimplifyJob::GatherQuadrics ) );
+			engine.AddBorderQuadrics();
+
+			for( int i = 0; i < targets->Length; i++ )
+			{
+				unsigned int target = targets[i];
+				unsigned int start = engine.FaceCount();
+
+				while( engine.FaceCount() > target )
+				{
+					engine.BeginPass();
+					ParallelLoop::For( vertexCount, ElementsPerRange, gcnew ParallelRange( job, &SimplifyJob::FindCollapses ) );
+					if( engine.ApplyCollapses( target, maximumError ) == 0 )
+						break;
+
+					ParallelLoop::For( engine.FaceCount(), ElementsPerRange, gcnew ParallelRange( job, &SimplifyJob::RemapFaces ) );
+					engine.EndPass();
+				}
+
+				if( levels->Count > 0 && engine.FaceCount() == start )
+					break;
+
+				levels->Add( CaptureLevel( engine ) );
+			}
+		}
+		finally
+		{
+			delete job->Engine;
+			job->Engine = NULL;
+		}
+
+		return levels;
+	}
+
+	static void CheckLimits( int targetFaceCount, float maximumError )
+	{
+		if( targetFaceCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "targetFaceCount" );
+		if( !( maximumError >= 0.0f ) )
+			throw gcnew ArgumentOutOfRangeException( "maximumError" );
+	}
+
+	static array<int>^ MakeTargets( int faceCount, int levelCount, float reduction )
+	{
+		if( levelCount < 1 )
+			throw gcnew ArgumentOutOfRangeException( "levelCount" );
+		if( !( reduction > 0.0f && reduction < 1.0f ) )
+			throw gcnew ArgumentOutOfRangeException( "reduction" );
+
+		// the first target is the original face count, which records the original as level 0
+		array<int>^ targets = gcnew array<int>( levelCount );
+		double target = faceCount;
+		for( int i = 0; i < levelCount; i++ )
+		{
+			targets[i] = static_cast<int>( target );
+			target *= reduction;
+		}
+
+		return targets;
+	}
+
+	// Copies the vertices of a mesh out, since the simplifier reads them for its whole run.
+	static DataStream^ CopyVertices( Mesh^ mesh )
+	{
+		Int64 size = static_cast<Int64>( mesh->VertexCount ) * mesh->BytesPerVertex;
+
+		DataStream^ source = mesh->LockVertexBuffer( LockFlags::ReadOnly );
+		if( source == nullptr )
+			return nullptr;
+
+		DataStream^ result = nullptr;
+		try
+		{
+			result = gcnew DataStream( size, true, true );
+			result->WriteRange( IntPtr( source->PositionPointer ), size );
+		}
+		finally
+		{
+			mesh->UnlockVertexBuffer();
+		}
+
+		result->Position = 0;
+		return result;
+	}
+
+	static List<LevelOfDetail^>^ RunLevels( Mesh^ mesh, AttributeWeights weights, array<float>^ vertexWeights, array<int>^ targets, float maximumError, bool lockBorder )
+	{
+		bool sixteenBitIndices = ( mesh->CreationOptions & MeshFlags::Use32Bit ) != MeshFlags::Use32Bit;
+
+		DataStream^ vertices = CopyVertices( mesh );
+		if( vertices == nullptr )
+			return nullptr;
+
+		DataStream^ indices = mesh->LockIndexBuffer( LockFlags::ReadOnly );
+		if( indices == nullptr )
+			return nullptr;
+
+		try
+		{
+			return RunLevels( indices, sixteenBitIndices, mesh->FaceCount, vertices, mesh->VertexCount, mesh->BytesPerVertex, mesh->GetDeclaration(),
+				weights, vertexWeights, targets, maximumError, lockBorder );
+		}
+		finally
+		{
+			mesh->UnlockIndexBuffer();
+		}
+	}
+
+	int MeshSimplifier::Simplify( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride,
+		array<VertexElement>^ declaration, AttributeWeights weights, array<float>^ vertexWeights, int targetFaceCount, float maximumError,
+		bool lockBorder, [Out] array<int>^% faceRemap, [Out] float% error )
+	{
+		CheckLimits( targetFaceCount, maximumError );
+
+		faceRemap = nullptr;
+		error = 0.0f;
+
+		List<LevelOfDetail^>^ levels = RunLevels( indices, sixteenBitIndices, faceCount, vertices, vertexCount, vertexStride, declaration,
+			weights, vertexWeights, gcnew array<int> { targetFaceCount }, maximumError, lockBorder );
+
+		if( levels->Count == 0 )
+		{
+			faceRemap = gcnew array<int>( 0 );
+			return faceCount;
+		}
+
+		LevelOfDetail^ level = levels[0];
+		array<int>^ result = level->GetIndices();
+		std::vector<unsigned int> values( result->Length );
+		for( int i = 0; i < result->Length; i++ )
+			values[i] = result[i];
+
+		WriteMeshIndices( indices, sixteenBitIndices, values );
+
+		faceRemap = level->GetFaceRemap();
+		error = level->GeometricError;
+		return level->FaceCount;
+	}
+
+	Mesh^ MeshSimplifier::Simplify( Mesh^ mesh, AttributeWeights weights, array<float>^ vertexWeights, int targetFaceCount, float maximumError, bool lockBorder )
+	{
+		if( mesh == nullptr )
+			throw gcnew ArgumentNullException( "mesh" );
+		CheckLimits( targetFaceCount, maximumError );
+
+		List<LevelOfDetail^>^ levels = RunLevels( mesh, weights, vertexWeights, gcnew array<int> { targetFaceCount }, maximumError, lockBorder );
+		if( levels == nullptr )
+			return nullptr;
+
+		return CreateMesh( mesh, levels[0] );
+	}
+
+	array<LevelOfDetail^>^ MeshSimplifier::GenerateLevels( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount,
+		int vertexStride, array<VertexElement>^ declaration, AttributeWeights weights, array<float>^ vertexWeights, int levelCount, float reduction,
+		bool lockBorder )
+	{
+		array<int>^ targets = MakeTargets( faceCount, levelCount, reduction );
+		return RunLevels( indices, sixteenBitIndices, faceCount, vertices, vertexCount, vertexStride, declaration, weights, vertexWeights,
+			targets, Single::MaxValue, lockBorder )->ToArray();
+	}
+
+	array<LevelOfDetail^>^ MeshSimplifier::GenerateLevels( Mesh^ mesh, AttributeWeights weights, int levelCount, float reduction, bool lockBorder )
+	{
+		if( mesh == nullptr )
+			throw gcnew ArgumentNullException( "mesh" );
+
+		array<int>^ targets = MakeTargets( mesh->FaceCount, levelCount, reduction );
+		List<LevelOfDetail^>^ levels = RunLevels( mesh, weights, nullptr, targets, Single::MaxValue, lockBorder );
+		return levels != nullptr ? levels->ToArray() : nullptr;
+	}
+
+	// Gives each face of the level the attribute of its original face, and builds the attribute table when the faces
+	// still fall in one run per attribute.
+	static bool CopyAttributes( Mesh^ mesh, Mesh^ result, LevelOfDetail^ level )
+	{
+		int faceCount = level->FaceCount;
+		array<int>^ faceRemap = level->GetFaceRemap();
+
+		DataStream^ source = mesh->LockAttributeBuffer( LockFlags::ReadOnly );
+		if( source == nullptr )
+			return false;
+
+		std::vector<unsigned int> ids( faceCount );
+		const unsigned int *sourceIds = reinterpret_cast<const unsigned int*>( source->PositionPointer );
+		for( int i = 0; i < faceCount; i++ )
+			ids[i] = sourceIds[faceRemap[i]];
+		mesh->UnlockAttributeBuffer();
+
+		DataStream^ destination = result->LockAttributeBuffer( LockFlags::None );
+		if( destination == nullptr )
+			return false;
+		memcpy( destination->PositionPointer, &ids[0], faceCount * sizeof( DWORD ) );
+		result->UnlockAttributeBuffer();
+
+		if( mesh->GetAttributeTable() == nullptr )
+			return true;
+
+		List<AttributeRange>^ table = gcnew List<AttributeRange>();
+		for( int i = 0; i < faceCount; i++ )
+		{
+			if( i > 0 && ids[i] == ids[i - 1] )
+				continue;
+
+			for( int j = 0; j < table->Count; j++ )
+			{
+				if( table[j].AttribId == static_cast<int>( ids[i] ) )
+					return true;
+			}
+
+			AttributeRange range;
+			range.AttribId = ids[i];
+			range.FaceStart = i;
+			table->Add( range );
+		}
+
+		array<AttributeRange>^ ranges = table->ToArray();
+		for( int i = 0; i < ranges->Length; i++ )
+			ranges[i].FaceCount = ( i + 1 < ranges->Length ? ranges[i + 1].FaceStart : faceCount ) - ranges[i].FaceStart;
+
+		array<int>^ indices = level->GetIndices();
+		std::vector<unsigned int> values( indices->Length );
+		for( int i = 0; i < indices->Length; i++ )
+			values[i] = indices[i];
+
+		UpdateVertexRanges( ranges, values );
+		return result->SetAttributeTable( ranges ).IsSuccess;
+	}
+
+	Mesh^ MeshSimplifier::CreateMesh( Mesh^ mesh, LevelOfDetail^ level )
+	{
+		if( mesh == nullptr )
+			throw gcnew ArgumentNullException( "mesh" );
+		if( level == nullptr )
+			throw gcnew ArgumentNullException( "level" );
+		if( level->FaceCount == 0 )
+			throw gcnew ArgumentException( "The level has no faces.", "level" );
+
+		int vertexCount = mesh->VertexCount;
+		bool sixteenBitIndices = ( mesh->CreationOptions & MeshFlags::Use32Bit ) != MeshFlags::Use32Bit;
+
+		array<int>^ indices = level->GetIndices();
+		array<int>^ faceRemap = level->GetFaceRemap();
+		for( int i = 0; i < indices->Length; i++ )
+		{
+			if( indices[i] < 0 || indices[i] >= vertexCount )
+				throw gcnew ArgumentException( "The level refers to a vertex past the end of the mesh.", "level" );
+		}
+		for( int i = 0; i < faceRemap->Length; i++ )
+		{
+			if( faceRemap[i] < 0 || faceRemap[i] >= mesh->FaceCount )
+				throw gcnew ArgumentException( "The level refers to a face past the end of the mesh.", "level" );
+		}
+
+		Mesh^ result = gcnew Mesh( mesh->Device, level->FaceCount, vertexCount, mesh->CreationOptions, mesh->GetDeclaration() );
+		result->SetMaterials( mesh->GetMaterials() );
+		result->SetEffects( mesh->GetEffects() );
+
+		DataStream^ source = mesh->LockVertexBuffer( LockFlags::ReadOnly );
+		if( source == nullptr )
+		{
+			delete result;
+			return nullptr;
+		}
+
+		DataStream^ destination = nullptr;
+		try
+		{
+			destination = result->LockVertexBuffer( LockFlags::None );
+			if( destination != nullptr )
+			{
+				memcpy( destination->PositionPointer, source->PositionPointer, static_cast<size_t>( vertexCount ) * mesh->BytesPerVertex );
+				result->UnlockVertexBuffer();
+			}
+		}
+		finally
+		{
+			mesh->UnlockVertexBuffer();
+		}
+
+		if( destination == nullptr )
+		{
+			delete result;
+			return nullptr;
+		}
+
+		destination = result->LockIndexBuffer( LockFlags::None );
+		if( destination == nullptr )
+		{
+			delete result;
+			return nullptr;
+		}
+		std::vector<unsigned int> values( indices->Length );
+		for( int i = 0; i < indices->Length; i++ )
+			values[i] = indices[i];
+		WriteMeshIndices( destination, sixteenBitIndices, values );
+		result->UnlockIndexBuffer();
+
+		if( !CopyAttributes( mesh, result, level ) )
+		{
+			delete result;
+			return nullptr;
+		}
+
+		return result;
+	}
+}
+}
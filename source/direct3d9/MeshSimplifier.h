@@ -0,0 +1,136 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "../DataStream.h"
+
+#include "AttributeWeights.h"
+#include "LevelOfDetail.h"
+#include "VertexElement.h"
+
+using System::Runtime::InteropServices::OutAttribute;
+
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		ref class Mesh;
+
+		/// <summary>
+		/// Simplifies indexed triangle lists by quadric error edge collapse without D3DX, spreading the work across threads.
+		/// </summary>
+		/// <remarks>
+		/// Each pass finds the cheapest collapse of every vertex in parallel, applies a set of collapses that touch no common
+		/// faces, and rewrites the faces in parallel. Vertices are never moved or removed; a simplified mesh only uses fewer of
+		/// them. The cost of a collapse is its quadric error times <see cref="AttributeWeights::Position"/>, plus the difference in
+		/// normals, colors, texture coordinates, tangents and binormals weighted by the matching members of <see cref="AttributeWeights"/>.
+		/// Open edges add quadrics weighted by <see cref="AttributeWeights::Boundary"/>, and the corners of borders and texture
+		/// seams only move along them. Results do not depend on the number of threads.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class MeshSimplifier sealed
+		{
+		private:
+			MeshSimplifier() { }
+
+		public:
+			/// <summary>
+			/// Simplifies a triangle list in place.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list. The remaining faces are written over the start of it.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <param name="vertices">The vertex data.</param>
+			/// <param name="vertexCount">The number of vertices.</param>
+			/// <param name="vertexStride">The size of a vertex, in bytes.</param>
+			/// <param name="declaration">The layout of the vertices. It must have a three-component float position in stream 0.</param>
+			/// <param name="weights">The weights of the vertex components.</param>
+			/// <param name="vertexWeights">The importance of each vertex, or <c>null</c>. A larger weight makes a vertex more expensive to remove.</param>
+			/// <param name="targetFaceCount">The number of faces to stop at.</param>
+			/// <param name="maximumError">The largest distance from the original surface to allow.</param>
+			/// <param name="lockBorder"><c>true</c> to keep every vertex on an open edge.</param>
+			/// <param name="faceRemap">When the method completes, contains the original face of each remaining face.</param>
+			/// <param name="error">When the method completes, contains the largest distance from the original surface.</param>
+			/// <returns>The number of remaining faces.</returns>
+			static int Simplify( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride,
+				array<VertexElement>^ declaration, AttributeWeights weights, array<float>^ vertexWeights, int targetFaceCount, float maximumError,
+				bool lockBorder, [Out] array<int>^% faceRemap, [Out] float% error );
+
+			/// <summary>
+			/// Simplifies a mesh.
+			/// </summary>
+			/// <param name="mesh">The mesh.</param>
+			/// <param name="weights">The weights of the vertex components.</param>
+			/// <param name="vertexWeights">The importance of each vertex, or <c>null</c>.</param>
+			/// <param name="targetFaceCount">The number of faces to stop at.</param>
+			/// <param name="maximumError">The largest distance from the original surface to allow.</param>
+			/// <param name="lockBorder"><c>true</c> to keep every vertex on an open edge.</param>
+			/// <returns>A new mesh sharing the vertices of the original, or <c>null</c> if the buffers could not be locked.</returns>
+			static Mesh^ Simplify( Mesh^ mesh, AttributeWeights weights, array<float>^ vertexWeights, int targetFaceCount, float maximumError, bool lockBorder );
+
+			/// <summary>
+			/// Builds a chain of successively simpler versions of a triangle list, each continuing from the one before.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <param name="vertices">The vertex data.</param>
+			/// <param name="vertexCount">The number of vertices.</param>
+			/// <param name="vertexStride">The size of a vertex, in bytes.</param>
+			/// <param name="declaration">The layout of the vertices. It must have a three-component float position in stream 0.</param>
+			/// <param name="weights">The weights of the vertex components.</param>
+			/// <param name="vertexWeights">The importance of each vertex, or <c>null</c>.</param>
+			/// <param name="levelCount">The largest number of levels, including the original.</param>
+			/// <param name="reduction">The fraction of the faces of each level to keep in the next, between 0 and 1.</param>
+			/// <param name="lockBorder"><c>true</c> to keep every vertex on an open edge.</param>
+			/// <returns>
+			/// The levels, starting with the original. The chain ends early once the triangle list can be simplified no further.
+			/// </returns>
+			static array<LevelOfDetail^>^ GenerateLevels( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount,
+				int vertexStride, array<VertexElement>^ declaration, AttributeWeights weights, array<float>^ vertexWeights, int levelCount, float reduction,
+				bool lockBorder );
+
+			/// <summary>
+			/// Builds a chain of successively simpler versions of a mesh.
+			/// </summary>
+			/// <param name="mesh">The mesh.</param>
+			/// <param name="weights">The weights of the vertex components.</param>
+			/// <param name="levelCount">The largest number of levels, including the original.</param>
+			/// <param name="reduction">The fraction of the faces of each level to keep in the next, between 0 and 1.</param>
+			/// <param name="lockBorder"><c>true</c> to keep every vertex on an open edge.</param>
+			/// <returns>The levels, starting with the original, or <c>null</c> if the buffers could not be locked.</returns>
+			static array<LevelOfDetail^>^ GenerateLevels( Mesh^ mesh, AttributeWeights weights, int levelCount, float reduction, bool lockBorder );
+
+			/// <summary>
+			/// Creates a mesh for one level of a chain.
+			/// </summary>
+			/// <param name="mesh">The mesh the chain was built from.</param>
+			/// <param name="level">The level.</param>
+			/// <returns>
+			/// A new mesh with the vertices, materials and effects of the original and the faces of the level, or <c>null</c>
+			/// if the buffers could not be locked. Subsets keep their attribute ids; the attribute table is only filled in if
+			/// the original faces were grouped by attribute.
+			/// </returns>
+			static Mesh^ CreateMesh( Mesh^ mesh, LevelOfDetail^ level );
+		};
+	}
+}
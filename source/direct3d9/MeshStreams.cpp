@@ -0,0 +1,127 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <d3d9.h>
+#include <d3dx9.h>
+#include <string.h>
+
+#include "MeshStreams.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+	void CheckMeshStream( DataStream^ stream, Int64 size, String^ name )
+	{
+		if( stream == nullptr )
+			throw gcnew ArgumentNullException( name );
+		if( stream->RemainingLength < size )
+			throw gcnew ArgumentException( "The stream is too small for the given number of elements.", name );
+	}
+
+	std::vector<unsigned int> ReadMeshIndices( DataStream^ stream, bool sixteenBitIndices, int faceCount )
+	{
+		CheckMeshStream( stream, static_cast<Int64>( faceCount ) * 3 * ( sixteenBitIndices ? 2 : 4 ), "indices" );
+
+		std::vector<unsigned int> result( faceCount * 3 );
+		if( sixteenBitIndices )
+		{
+			const unsigned short *source = reinterpret_cast<const unsigned short*>( stream->PositionPointer );
+			for( size_t i = 0; i < result.size(); i++ )
+				result[i] = source[i];
+		}
+		else if( faceCount > 0 )
+			memcpy( &result[0], stream->PositionPointer, result.size() * sizeof( unsigned int ) );
+
+		return result;
+	}
+
+	void WriteMeshIndices( DataStream^ stream, bool sixteenBitIndices, const std::vector<unsigned int> &indices )
+	{
+		if( sixteenBitIndices )
+		{
+			unsigned short *destination = reinterpret_cast<unsigned short*>( stream->PositionPointer );
+			for( size_t i = 0; i < indices.size(); i++ )
+				destination[i] = static_cast<unsigned short>( indices[i] );
+		}
+		else if( indices.size() > 0 )
+			memcpy( stream->PositionPointer, &indices[0], indices.size() * sizeof( unsigned int ) );
+	}
+
+	void CheckMeshIndices( const std::vector<unsigned int> &indices, int vertexCount )
+	{
+		for( size_t i = 0; i < indices.size(); i++ )
+		{
+			if( indices[i] >= static_cast<unsigned int>( vertexCount ) )
+				throw gcnew ArgumentException( "An index refers to a vertex past the end of the vertex data.", "indices" );
+		}
+	}
+
+	int FindVertexElement( array<VertexElement>^ declaration, DeclarationUsage usage, int usageIndex, DeclarationType type )
+	{
+		if( declaration == nullptr )
+			return -1;
+
+		for( int i = 0; i < declaration->Length; i++ )
+		{
+			VertexElement element = declaration[i];
+			if( element.Stream == 255 )
+				break;
+
+			if( element.Stream == 0 && element.Usage == usage && element.UsageIndex == usageIndex && element.Type == type )
+				return element.Offset;
+		}
+
+		return -1;
+	}
+
+	void UpdateVertexRanges( array<AttributeRange>^ table, const std::vector<unsigned int> &indices )
+	{
+		int faceCount = static_cast<int>( indices.size() / 3 );
+		for( int i = 0; i < table->Length; i++ )
+		{
+			int start = Math::Max( 0, table[i].FaceStart );
+			int end = Math::Min( faceCount, start + table[i].FaceCount );
+			if( end <= start )
+			{
+				table[i].VertexStart = 0;
+				table[i].VertexCount = 0;
+				continue;
+			}
+
+			unsigned int low = indices[start * 3];
+			unsigned int high = low;
+			for( int index = start * 3; index < end * 3; index++ )
+			{
+				low = Math::Min( low, indices[index] );
+				high = Math::Max( high, indices[index] );
+			}
+
+			table[i].VertexStart = static_cast<int>( low );
+			table[i].VertexCount = static_cast<int>( high - low + 1 );
+		}
+	}
+}
+}
@@ -0,0 +1,55 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+
+#include "../DataStream.h"
+
+#include "AttributeRange.h"
+#include "Enums.h"
+#include "VertexElement.h"
+
+// Shared plumbing for the mesh processing classes, which work on index and vertex data in DataStreams.
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		// Throws unless the stream holds at least size bytes past its position.
+		void CheckMeshStream( DataStream^ stream, System::Int64 size, System::String^ name );
+
+		// Reads the indices of faceCount triangles at the position of the stream, widening 16-bit indices.
+		std::vector<unsigned int> ReadMeshIndices( DataStream^ stream, bool sixteenBitIndices, int faceCount );
+
+		// Writes indices back at the position of the stream, narrowing them again if needed.
+		void WriteMeshIndices( DataStream^ stream, bool sixteenBitIndices, const std::vector<unsigned int> &indices );
+
+		// Throws if an index is not below vertexCount.
+		void CheckMeshIndices( const std::vector<unsigned int> &indices, int vertexCount );
+
+		// The offset of the first element in stream 0 with the given usage and type, or -1.
+		int FindVertexElement( array<VertexElement>^ declaration, DeclarationUsage usage, int usageIndex, DeclarationType type );
+
+		// Sets the vertex range of each subset to the span of the vertices its faces use.
+		void UpdateVertexRanges( array<AttributeRange>^ table, const std::vector<unsigned int> &indices );
+	}
+}
@@ -0,0 +1,485 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <d3d9.h>
+#include <d3dx9.h>
+#include <vector>
+
+#include "../ComObject.h"
+#include "../DataStream.h"
+#include "../ParallelLoop.h"
+
+#include "Direct3D9Exception.h"
+#include "ResultCode9.h"
+
+#include "Mesh.h"
+#include "MeshKernels.h"
+#include "MeshStreams.h"
+#include "MeshTopology.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+	// vertices and faces are cheap on their own, so hand them out in large ranges
+	const int ElementsPerRange = 4096;
+
+	ref class TopologyJob sealed
+	{
+	public:
+		unsigned char *Vertices;
+		unsigned int Stride;
+		unsigned int PositionOffset;
+		float CellSize;
+		const MeshKernels::VertexComponent *Components;
+		unsigned int ComponentCount;
+		const unsigned int *Indices;
+		MeshKernels::HashEntry *Entries;
+		MeshKernels::HashEntry *Table;
+		const unsigned int *BucketStarts;
+		unsigned int *Representatives;
+		unsigned int *Adjacency;
+
+		void Hash( int begin, int end )
+		{
+			MeshKernels::HashPositions( Vertices + PositionOffset, Stride, CellSize, begin, end, Entries );
+		}
+
+		void SortBuckets( int begin, int end )
+		{
+			for( int bucket = begin; bucket < end; bucket++ )
+				MeshKernels::SortEntries( Table + BucketStarts[bucket], BucketStarts[bucket + 1] - BucketStarts[bucket] );
+		}
+
+		void Match( int begin, int end )
+		{
+			MeshKernels::FindMatches( Table, BucketStarts, Vertices, Stride, CellSize, Components, ComponentCount, begin, end, Representatives );
+		}
+
+		void CopyPartial( int begin, int end )
+		{
+			MeshKernels::CopyPartialMatches( Vertices, Stride, Representatives, Components, ComponentCount, begin, end );
+		}
+
+		void Edges( int begin, int end )
+		{
+			MeshKernels::BuildEdges( Indices, Representatives, begin, end, Entries );
+		}
+
+		// both halves of an edge share a key and so a bucket, so buckets can be paired independently
+		void Pair( int begin, int end )
+		{
+			for( int bucket = begin; bucket < end; bucket++ )
+			{
+				unsigned int count = BucketStarts[bucket + 1] - BucketStarts[bucket];
+				MeshKernels::SortEntries( Table + BucketStarts[bucket], count );
+				MeshKernels::PairEdges( Table + BucketStarts[bucket], count, Indices, Representatives, Adjacency );
+			}
+		}
+	};
+
+	// Leaves each vertex with the lowest numbered vertex that matches it on every component, directly or through others.
+	static void FindRepresentatives( unsigned char *vertices, int vertexCount, int vertexStride, float cellSize,
+		const std::vector<MeshKernels::VertexComponent> &components, std::vector<unsigned int> &representatives )
+	{
+		if( vertexCount == 0 )
+			return;
+
+		std::vector<MeshKernels::HashEntry> entries( vertexCount );
+		std::vector<MeshKernels::HashEntry> table( vertexCount );
+		std::vector<unsigned int> bucketStarts( MeshKernels::HashBucketCount + 1 );
+
+		TopologyJob^ job = gcnew TopologyJob();
+		job->Vertices = vertices;
+		job->Stride = vertexStride;
+		job->PositionOffset = components[0].Offset;
+		job->CellSize = cellSize;
+		job->Components = &components[0];
+		job->ComponentCount = static_cast<unsigned int>( components.size() );
+		job->Entries = &entries[0];
+		job->Table = &table[0];
+		job->BucketStarts = &bucketStarts[0];
+		job->Representatives = &representatives[0];
+
+		ParallelLoop::For( vertexCount, ElementsPerRange, gcnew ParallelRange( job, &TopologyJob::Hash ) );
+		MeshKernels::PartitionEntries( &entries[0], vertexCount, &table[0], &bucketStarts[0] );
+		ParallelLoop::For( static_cast<int>( MeshKernels::HashBucketCount ), 1, gcnew ParallelRange( job, &TopologyJob::SortBuckets ) );
+		ParallelLoop::For( vertexCount, ElementsPerRange, gcnew ParallelRange( job, &TopologyJob::Match ) );
+		MeshKernels::ResolveMatches( &representatives[0], vertexCount );
+	}
+
+	static void CheckPositionOffset( int positionOffset, int vertexStride )
+	{
+		if( vertexStride <= 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexStride" );
+		if( positionOffset < 0 || positionOffset + 3 * static_cast<int>( sizeof( float ) ) > vertexStride )
+			throw gcnew ArgumentOutOfRangeException( "positionOffset" );
+	}
+
+	static float ComponentEpsilon( VertexElement element, WeldEpsilons epsilons )
+	{
+		switch( element.Usage )
+		{
+		case DeclarationUsage::Position:
+		case DeclarationUsage::PositionTransformed:
+			return epsilons.Position;
+		case DeclarationUsage::BlendWeight:
+			return epsilons.BlendWeights;
+		case DeclarationUsage::Normal:
+			return epsilons.Normal;
+		case DeclarationUsage::PointSize:
+			return epsilons.PointSize;
+		case DeclarationUsage::Color:
+			return element.UsageIndex == 0 ? epsilons.Diffuse : epsilons.Specular;
+		case DeclarationUsage::Tangent:
+			return epsilons.Tangent;
+		case DeclarationUsage::Binormal:
+			return epsilons.Binormal;
+		case DeclarationUsage::TessellateFactor:
+			return epsilons.TessellationFactor;
+
+		case DeclarationUsage::TextureCoordinate:
+			switch( element.UsageIndex )
+			{
+			case 0: return epsilons.TextureCoordinate1;
+			case 1: return epsilons.TextureCoordinate2;
+			case 2: return epsilons.TextureCoordinate3;
+			case 3: return epsilons.TextureCoordinate4;
+			case 4: return epsilons.TextureCoordinate5;
+			case 5: return epsilons.TextureCoordinate6;
+			case 6: return epsilons.TextureCoordinate7;
+			case 7: return epsilons.TextureCoordinate8;
+			}
+			return 0.0f;
+
+		default:
+			return 0.0f;
+		}
+	}
+
+	static MeshKernels::VertexComponent MakeComponent( VertexElement element, WeldEpsilons epsilons )
+	{
+		MeshKernels::VertexComponent component;
+		component.Offset = element.Offset;
+		component.Epsilon = ComponentEpsilon( element, epsilons );
+
+		switch( element.Type )
+		{
+		case DeclarationType::Float1:
+		case DeclarationType::Float2:
+		case DeclarationType::Float3:
+		case DeclarationType::Float4:
+			component.Kind = MeshKernels::FloatComponent;
+			component.Size = ( static_cast<int>( element.Type ) - static_cast<int>( DeclarationType::Float1 ) + 1 ) * sizeof( float );
+			break;
+
+		case DeclarationType::Color:
+			component.Kind = MeshKernels::ColorComponent;
+			component.Size = 4;
+			break;
+
+		case DeclarationType::Short4:
+		case DeclarationType::Short4N:
+		case DeclarationType::UShort4N:
+		case DeclarationType::HalfFour:
+			component.Kind = MeshKernels::ExactComponent;
+			component.Size = 8;
+			break;
+
+		default:
+			component.Kind = MeshKernels::ExactComponent;
+			component.Size = 4;
+			break;
+		}
+
+		return component;
+	}
+
+	array<int>^ MeshTopology::GenerateAdjacency( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount,
+		int vertexStride, int positionOffset, float epsilon, [Out] array<int>^% pointReps )
+	{
+		if( faceCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "faceCount" );
+		if( vertexCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexCount" );
+		if( !( epsilon >= 0.0f ) )
+			throw gcnew ArgumentOutOfRangeException( "epsilon" );
+		CheckPositionOffset( positionOffset, vertexStride );
+
+		std::vector<unsigned int> values = ReadMeshIndices( indices, sixteenBitIndices, faceCount );
+		CheckMeshStream( vertices, static_cast<Int64>( vertexCount ) * vertexStride, "vertices" );
+		CheckMeshIndices( values, vertexCount );
+
+		MeshKernels::VertexComponent position = { positionOffset, 3 * sizeof( float ), MeshKernels::FloatComponent, epsilon };
+		std::vector<MeshKernels::VertexComponent> components( 1, position );
+		std::vector<unsigned int> representatives( vertexCount );
+		FindRepresentatives( reinterpret_cast<unsigned char*>( vertices->PositionPointer ), vertexCount, vertexStride, epsilon, components, representatives );
+
+		std::vector<unsigned int> adjacency( faceCount * 3, 0xffffffff );
+		if( faceCount > 0 )
+		{
+			std::vector<MeshKernels::HashEntry> edges( faceCount * 3 );
+			std::vector<MeshKernels::HashEntry> table( faceCount * 3 );
+			std::vector<unsigned int> bucketStarts( MeshKernels::HashBucketCount + 1 );
+
+			TopologyJob^ job = gcnew TopologyJob();
+			job->Indices = &values[0];
+			job->Representatives = &representatives[0];
+			job->Entries = &edges[0];
+			job->Table = &table[0];
+			job->BucketStarts = &bucketStarts[0];
+			job->Adjacency = &adjacency[0];
+
+			ParallelLoop::For( faceCount, ElementsPerRange, gcnew ParallelRange( job, &TopologyJob::Edges ) );
+			MeshKernels::PartitionEntries( &edges[0], faceCount * 3, &table[0], &bucketStarts[0] );
+			ParallelLoop::For( static_cast<int>( MeshKernels::HashBucketCount ), 1, gcnew ParallelRange( job, &TopologyJob::Pair ) );
+		}
+
+		array<int>^ result = gcnew array<int>( faceCount * 3 );
+		for( int i = 0; i < faceCount * 3; i++ )
+			result[i] = static_cast<int>( adjacency[i] );
+
+		pointReps = gcnew array<int>( vertexCount );
+		if( vertexCount > 0 )
+		{
+			// rebuilt from the adjacency, so that vertices no face joins stay apart even where the spatial hash matched them;
+			// the positions only settle which ends of a shared edge belong together
+			std::vector<unsigned int> reps( vertexCount );
+			MeshKernels::AdjacencyToPointReps( faceCount > 0 ? &values[0] : NULL, faceCount, faceCount > 0 ? &adjacency[0] : NULL, vertexCount,
+				&representatives[0], &reps[0] );
+			for( int i = 0; i < vertexCount; i++ )
+				pointReps[i] = reps[i];
+		}
+
+		return result;
+	}
+
+	array<int>^ MeshTopology::GenerateAdjacency( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount,
+		int vertexStride, int positionOffset, float epsilon )
+	{
+		array<int>^ pointReps;
+		return GenerateAdjacency( indices, sixteenBitIndices, faceCount, vertices, vertexCount, vertexStride, positionOffset, epsilon, pointReps );
+	}
+
+	array<int>^ MeshTopology::GenerateAdjacency( BaseMesh^ mesh, float epsilon )
+	{
+		if( mesh == nullptr )
+			throw gcnew ArgumentNullException( "mesh" );
+
+		int positionOffset = FindVertexElement( mesh->GetDeclaration(), DeclarationUsage::Position, 0, DeclarationType::Float3 );
+		if( positionOffset < 0 )
+			throw gcnew ArgumentException( "The mesh has no three-component float position.", "mesh" );
+
+		bool sixteenBitIndices = ( mesh->CreationOptions & MeshFlags::Use32Bit ) != MeshFlags::Use32Bit;
+
+		DataStream^ indices = mesh->LockIndexBuffer( LockFlags::ReadOnly );
+		if( indices == nullptr )
+			return nullptr;
+
+		DataStream^ vertices = nullptr;
+		try
+		{
+			vertices = mesh->LockVertexBuffer( LockFlags::ReadOnly );
+			if( vertices == nullptr )
+				return nullptr;
+
+			return GenerateAdjacency( indices, sixteenBitIndices, mesh->FaceCount, vertices, mesh->VertexCount, mesh->BytesPerVertex, positionOffset, epsilon );
+		}
+		finally
+		{
+			if( vertices != nullptr )
+				mesh->UnlockVertexBuffer();
+			mesh->UnlockIndexBuffer();
+		}
+	}
+
+	array<int>^ MeshTopology::ConvertAdjacencyToPointReps( DataStream^ indices, bool sixteenBitIndices, int faceCount, int vertexCount, array<int>^ adjacency )
+	{
+		if( faceCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "faceCount" );
+		if( vertexCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexCount" );
+		if( adjacency == nullptr )
+			throw gcnew ArgumentNullException( "adjacency" );
+		if( adjacency->Length < faceCount * 3 )
+			throw gcnew ArgumentException( "The adjacency must have three entries for each face.", "adjacency" );
+
+		std::vector<unsigned int> values = ReadMeshIndices( indices, sixteenBitIndices, faceCount );
+		CheckMeshIndices( values, vertexCount );
+
+		array<int>^ result = gcnew array<int>( vertexCount );
+		if( vertexCount == 0 )
+			return result;
+
+		std::vector<unsigned int> neighbors( faceCount * 3 );
+		for( int i = 0; i < faceCount * 3; i++ )
+			neighbors[i] = static_cast<unsigned int>( adjacency[i] );
+
+		std::vector<unsigned int> reps( vertexCount );
+		MeshKernels::AdjacencyToPointReps( faceCount > 0 ? &values[0] : NULL, faceCount, faceCount > 0 ? &neighbors[0] : NULL, vertexCount, NULL, &reps[0] );
+		for( int i = 0; i < vertexCount; i++ )
+			result[i] = reps[i];
+
+		return result;
+	}
+
+	int MeshTopology::WeldVertices( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride,
+		array<VertexElement>^ declaration, WeldFlags flags, WeldEpsilons epsilons, [Out] array<int>^% vertexRemap )
+	{
+		if( faceCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "faceCount" );
+		if( vertexCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexCount" );
+		if( vertexStride <= 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexStride" );
+		if( declaration == nullptr )
+			throw gcnew ArgumentNullException( "declaration" );
+
+		int positionOffset = FindVertexElement( declaration, DeclarationUsage::Position, 0, DeclarationType::Float3 );
+		if( positionOffset < 0 )
+			throw gcnew ArgumentException( "The declaration has no three-component float position.", "declaration" );
+
+		// the position always comes first, since it is what the vertices are hashed by
+		std::vector<MeshKernels::VertexComponent> components;
+		for( int i = 0; i < declaration->Length && declaration[i].Stream != 255; i++ )
+		{
+			VertexElement element = declaration[i];
+			if( element.Stream != 0 || element.Type == DeclarationType::Unused )
+				continue;
+
+			MeshKernels::VertexComponent component = MakeComponent( element, epsilons );
+			if( component.Offset + component.Size > static_cast<unsigned int>( vertexStride ) )
+				throw gcnew ArgumentException( "The declaration does not fit in the vertex stride.", "declaration" );
+
+			if( element.Offset == positionOffset )
+				components.insert( components.begin(), component );
+			else if( ( flags & WeldFlags::WeldAll ) != WeldFlags::WeldAll )
+				components.push_back( component );
+		}
+
+		std::vector<unsigned int> values = ReadMeshIndices( indices, sixteenBitIndices, faceCount );
+		CheckMeshStream( vertices, static_cast<Int64>( vertexCount ) * vertexStride, "vertices" );
+		CheckMeshIndices( values, vertexCount );
+
+		unsigned char *data = reinterpret_cast<unsigned char*>( vertices->PositionPointer );
+		std::vector<unsigned int> representatives( vertexCount );
+		vertexRemap = gcnew array<int>( vertexCount );
+
+		if( ( flags & WeldFlags::WeldPartialMatches ) == WeldFlags::WeldPartialMatches && vertexCount > 0 )
+		{
+			// make everything that is close enough to the first vertex at the same position equal to it
+			std::vector<MeshKernels::VertexComponent> position( 1, components[0] );
+			FindRepresentatives( data, vertexCount, vertexStride, epsilons.Position, position, representatives );
+
+			TopologyJob^ job = gcnew TopologyJob();
+			job->Vertices = data;
+			job->Stride = vertexStride;
+			job->Components = &components[0];
+			job->ComponentCount = static_cast<unsigned int>( components.size() );
+			job->Representatives = &representatives[0];
+			ParallelLoop::For( vertexCount, ElementsPerRange, gcnew ParallelRange( job, &TopologyJob::CopyPartial ) );
+
+			if( ( flags & WeldFlags::DoNotRemoveVertices ) == WeldFlags::DoNotRemoveVertices )
+			{
+				for( int i = 0; i < vertexCount; i++ )
+					vertexRemap[i] = i;
+				return vertexCount;
+			}
+		}
+
+		FindRepresentatives( data, vertexCount, vertexStride, epsilons.Position, components, representatives );
+
+		// survivors keep their order and move down over the vertices that were welded away
+		std::vector<unsigned int> newIndices( vertexCount );
+		int count = 0;
+		for( int v = 0; v < vertexCount; v++ )
+		{
+			if( representatives[v] != static_cast<unsigned int>( v ) )
+				continue;
+
+			if( count != v )
+				memcpy( data + static_cast<size_t>( count ) * vertexStride, data + static_cast<size_t>( v ) * vertexStride, vertexStride );
+
+			newIndices[v] = count;
+			vertexRemap[count++] = v;
+		}
+
+		for( int i = count; i < vertexCount; i++ )
+			vertexRemap[i] = -1;
+
+		for( size_t i = 0; i < values.size(); i++ )
+			values[i] = newIndices[representatives[values[i]]];
+
+		WriteMeshIndices( indices, sixteenBitIndices, values );
+		return count;
+	}
+
+	Result MeshTopology::WeldVertices( Mesh^ mesh, WeldFlags flags, WeldEpsilons epsilons, [Out] array<int>^% faceRemap, [Out] array<int>^% vertexRemap )
+	{
+		if( mesh == nullptr )
+			throw gcnew ArgumentNullException( "mesh" );
+
+		faceRemap = nullptr;
+		vertexRemap = nullptr;
+
+		int faceCount = mesh->FaceCount;
+		bool sixteenBitIndices = ( mesh->CreationOptions & MeshFlags::Use32Bit ) != MeshFlags::Use32Bit;
+		array<VertexElement>^ declaration = mesh->GetDeclaration();
+		array<AttributeRange>^ table = mesh->GetAttributeTable();
+
+		DataStream^ indices = mesh->LockIndexBuffer( LockFlags::None );
+		if( indices == nullptr )
+			return RECORD_D3D9( E_FAIL );
+
+		DataStream^ vertices = nullptr;
+		try
+		{
+			vertices = mesh->LockVertexBuffer( LockFlags::None );
+			if( vertices == nullptr )
+				return RECORD_D3D9( E_FAIL );
+
+			WeldVertices( indices, sixteenBitIndices, faceCount, vertices, mesh->VertexCount, mesh->BytesPerVertex, declaration, flags, epsilons, vertexRemap );
+
+			if( table != nullptr )
+				UpdateVertexRanges( table, ReadMeshIndices( indices, sixteenBitIndices, faceCount ) );
+		}
+		finally
+		{
+			if( vertices != nullptr )
+				mesh->UnlockVertexBuffer();
+			mesh->UnlockIndexBuffer();
+		}
+
+		faceRemap = gcnew array<int>( faceCount );
+		for( int i = 0; i < faceCount; i++ )
+			faceRemap[i] = i;
+
+		if( table != nullptr )
+			return mesh->SetAttributeTable( table );
+
+		return ResultCode::Success;
+	}
+}
+}
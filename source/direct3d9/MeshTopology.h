@@ -0,0 +1,147 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "../DataStream.h"
+
+#include "D3DXEnums.h"
+#include "VertexElement.h"
+#include "WeldEpsilons.h"
+
+using System::Runtime::InteropServices::OutAttribute;
+
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		ref class BaseMesh;
+		ref class Mesh;
+
+		/// <summary>
+		/// Builds adjacency and welds vertices of indexed triangle lists without D3DX, using spatial hashing so the cost
+		/// grows linearly with the size of the mesh.
+		/// </summary>
+		/// <remarks>
+		/// The work is split across threads, but every result is defined by vertex and face numbers alone: a group of
+		/// coincident vertices is always represented by its lowest numbered vertex, and shared edges are paired in
+		/// face order. The output is therefore the same whatever the number of threads.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class MeshTopology sealed
+		{
+		private:
+			MeshTopology() { }
+
+		public:
+			/// <summary>
+			/// Generates adjacency information for a triangle list.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <param name="vertices">The vertex data.</param>
+			/// <param name="vertexCount">The number of vertices.</param>
+			/// <param name="vertexStride">The size of a vertex, in bytes.</param>
+			/// <param name="positionOffset">The offset of a three-component float position within a vertex.</param>
+			/// <param name="epsilon">Vertices whose positions differ by no more than this on each axis are treated as the same point.</param>
+			/// <param name="pointReps">When the method completes, contains the point representative of each vertex, as
+			/// <see cref="ConvertAdjacencyToPointReps"/> would compute it from the adjacency.</param>
+			/// <returns>Three entries per face holding the neighbouring face across each edge, or -1.</returns>
+			static array<int>^ GenerateAdjacency( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount,
+				int vertexStride, int positionOffset, float epsilon, [Out] array<int>^% pointReps );
+
+			/// <summary>
+			/// Generates adjacency information for a triangle list.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <param name="vertices">The vertex data.</param>
+			/// <param name="vertexCount">The number of vertices.</param>
+			/// <param name="vertexStride">The size of a vertex, in bytes.</param>
+			/// <param name="positionOffset">The offset of a three-component float position within a vertex.</param>
+			/// <param name="epsilon">Vertices whose positions differ by no more than this on each axis are treated as the same point.</param>
+			/// <returns>Three entries per face holding the neighbouring face across each edge, or -1.</returns>
+			static array<int>^ GenerateAdjacency( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount,
+				int vertexStride, int positionOffset, float epsilon );
+
+			/// <summary>
+			/// Generates adjacency information for a mesh.
+			/// </summary>
+			/// <param name="mesh">The mesh. Its vertices must have a three-component float position.</param>
+			/// <param name="epsilon">Vertices whose positions differ by no more than this on each axis are treated as the same point.</param>
+			/// <returns>Three entries per face holding the neighbouring face across each edge, or -1.</returns>
+			static array<int>^ GenerateAdjacency( BaseMesh^ mesh, float epsilon );
+
+			/// <summary>
+			/// Converts adjacency information into point representatives: each vertex is mapped to the lowest numbered
+			/// vertex that it is joined to through shared edges.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <param name="vertexCount">The number of vertices.</param>
+			/// <param name="adjacency">Three entries per face holding the neighbouring face across each edge, or -1.</param>
+			/// <returns>The point representative of each vertex.</returns>
+			static array<int>^ ConvertAdjacencyToPointReps( DataStream^ indices, bool sixteenBitIndices, int faceCount, int vertexCount, array<int>^ adjacency );
+
+			/// <summary>
+			/// Welds vertices that match within the given epsilons, moving the surviving vertices to the front of the
+			/// vertex data and rewriting the indices to refer to them.
+			/// </summary>
+			/// <param name="indices">The index data of a triangle list.</param>
+			/// <param name="sixteenBitIndices"><c>true</c> if the indices are 16-bit; <c>false</c> if they are 32-bit.</param>
+			/// <param name="faceCount">The number of faces.</param>
+			/// <param name="vertices">The vertex data.</param>
+			/// <param name="vertexCount">The number of vertices.</param>
+			/// <param name="vertexStride">The size of a vertex, in bytes.</param>
+			/// <param name="declaration">The layout of the vertices. It must have a three-component float position in stream 0.</param>
+			/// <param name="flags">
+			/// <see cref="WeldFlags::WeldAll"/> compares positions only. <see cref="WeldFlags::WeldPartialMatches"/> first makes every
+			/// component that is within epsilon of the first vertex at the same position identical to it, and
+			/// <see cref="WeldFlags::DoNotRemoveVertices"/> stops there. <see cref="WeldFlags::DoNotSplit"/> is ignored.
+			/// </param>
+			/// <param name="epsilons">The largest difference allowed for each kind of component. Positions are compared per axis, colors
+			/// per channel on a scale of 0 to 1, and components without an epsilon, such as blend indices, must match exactly.</param>
+			/// <param name="vertexRemap">When the method completes, contains the original vertex of each welded vertex, followed by -1 for
+			/// each vertex that was removed.</param>
+			/// <returns>The number of vertices left.</returns>
+			static int WeldVertices( DataStream^ indices, bool sixteenBitIndices, int faceCount, DataStream^ vertices, int vertexCount, int vertexStride,
+				array<VertexElement>^ declaration, WeldFlags flags, WeldEpsilons epsilons, [Out] array<int>^% vertexRemap );
+
+			/// <summary>
+			/// Welds the vertices of a mesh in place.
+			/// </summary>
+			/// <param name="mesh">The mesh to weld.</param>
+			/// <param name="flags">The weld options, as for the stream overload.</param>
+			/// <param name="epsilons">The largest difference allowed for each kind of component.</param>
+			/// <param name="faceRemap">When the method completes, contains the face remap. Welding never moves faces.</param>
+			/// <param name="vertexRemap">When the method completes, contains the vertex remap.</param>
+			/// <returns>A <see cref="SlimDX::Result"/> object describing the result of the operation.</returns>
+			/// <remarks>
+			/// The vertex buffer keeps its size, so removed vertices are left unused at its end. The vertex ranges in the
+			/// attribute table are updated to match.
+			/// </remarks>
+			static Result WeldVertices( Mesh^ mesh, WeldFlags flags, WeldEpsilons epsilons, [Out] array<int>^% faceRemap, [Out] array<int>^% vertexRemap );
+		};
+	}
+}
@@ -0,0 +1,653 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "MeshKernels.h"
+#include "TangentKernels.h"
+#include "SimplifyKernels.h"
+
+#ifdef _MANAGED
+#pragma managed(push, off)
+#endif
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+namespace SimplifyKernels
+{
+	// open edge links are either a vertex or one of these
+	const unsigned int NoEdge = ~0u;
+	const unsigned int ManyEdges = ~0u - 1;
+
+	// a collapse may turn a face by no more than about 75 degrees
+	const double MinimumFaceCosine = 0.25;
+
+	static inline unsigned long long EdgeKey( unsigned int from, unsigned int to )
+	{
+		return ( static_cast<unsigned long long>( from ) << 32 ) | to;
+	}
+
+	static inline bool HasEdge( const std::vector<unsigned long long> &edges, unsigned int from, unsigned int to )
+	{
+		return std::binary_search( edges.begin(), edges.end(), EdgeKey( from, to ) );
+	}
+
+	static inline void Link( unsigned int &link, unsigned int vertex )
+	{
+		link = link == NoEdge ? vertex : ManyEdges;
+	}
+
+	static void Cross( const double *a, const double *b, double *result )
+	{
+		result[0] = a[1] * b[2] - a[2] * b[1];
+		result[1] = a[2] * b[0] - a[0] * b[2];
+		result[2] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	static inline double Dot( const double *a, const double *b )
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	static void Difference( const float *a, const float *b, double *result )
+	{
+		result[0] = static_cast<double>( a[0] ) - b[0];
+		result[1] = static_cast<double>( a[1] ) - b[1];
+		result[2] = static_cast<double>( a[2] ) - b[2];
+	}
+
+	static void AddPlane( Quadric &q, const double *normal, double distance, double weight )
+	{
+		q.A00 += weight * normal[0] * normal[0];
+		q.A01 += weight * normal[0] * normal[1];
+		q.A02 += weight * normal[0] * normal[2];
+		q.A11 += weight * normal[1] * normal[1];
+		q.A12 += weight * normal[1] * normal[2];
+		q.A22 += weight * normal[2] * normal[2];
+		q.B0 += weight * normal[0] * distance;
+		q.B1 += weight * normal[1] * distance;
+		q.B2 += weight * normal[2] * distance;
+		q.C += weight * distance * distance;
+	}
+
+	static void AddQuadric( Quadric &q, const Quadric &other )
+	{
+		q.A00 += other.A00;
+		q.A01 += other.A01;
+		q.A02 += other.A02;
+		q.A11 += other.A11;
+		q.A12 += other.A12;
+		q.A22 += other.A22;
+		q.B0 += other.B0;
+		q.B1 += other.B1;
+		q.B2 += other.B2;
+		q.C += other.C;
+		q.Weight += other.Weight;
+	}
+
+	static double EvaluateQuadric( const Quadric &q, const float *point )
+	{
+		double x = point[0], y = point[1], z = point[2];
+		double result = q.A00 * x * x + q.A11 * y * y + q.A22 * z * z
+			+ 2.0 * ( q.A01 * x * y + q.A02 * x * z + q.A12 * y * z )
+			+ 2.0 * ( q.B0 * x + q.B1 * y + q.B2 * z ) + q.C;
+
+		// rounding can take a sum of squares just below zero
+		return result > 0.0 ? result : 0.0;
+	}
+
+	Simplifier::Simplifier( const unsigned int *indices, unsigned int faceCount, const unsigned char *vertices, unsigned int vertexCount,
+		const SimplifierSettings &settings, const Attribute *attributes, unsigned int attributeCount, const float *vertexWeights )
+		: m_Indices( indices, indices + faceCount * 3 ), m_FaceIds( faceCount ), m_Vertices( vertices ), m_VertexCount( vertexCount ),
+		m_Settings( settings ), m_Attributes( attributes, attributes + attributeCount ), m_Error( 0.0f )
+	{
+		for( unsigned int f = 0; f < faceCount; f++ )
+			m_FaceIds[f] = f;
+
+		if( vertexWeights != NULL )
+			m_VertexWeights.assign( vertexWeights, vertexWeights + vertexCount );
+
+		Quadric zero;
+		memset( &zero, 0, sizeof( zero ) );
+		m_FaceQuadrics.assign( faceCount, zero );
+		m_Quadrics.assign( vertexCount, zero );
+
+		m_Collapses.resize( vertexCount );
+		m_Remap.resize( vertexCount );
+		for( unsigned int v = 0; v < vertexCount; v++ )
+			m_Remap[v] = v;
+		m_Removed.assign( vertexCount, 0 );
+		m_Touched.assign( vertexCount, 0 );
+
+		Classify();
+		BeginPass();
+	}
+
+	const float *Simplifier::Position( unsigned int vertex ) const
+	{
+		return reinterpret_cast<const float*>( m_Vertices + static_cast<size_t>( vertex ) * m_Settings.Stride + m_Settings.PositionOffset );
+	}
+
+	void Simplifier::Classify()
+	{
+		unsigned int vertexCount = m_VertexCount;
+		unsigned int cornerCount = static_cast<unsigned int>( m_Indices.size() );
+
+		// vertices at exactly the same position are one point, represented by the lowest of them
+		std::vector<MeshKernels::HashEntry> entries( vertexCount + 1 );
+		if( vertexCount > 0 )
+		{
+			MeshKernels::HashPositions( m_Vertices + m_Settings.PositionOffset, m_Settings.Stride, 0.0f, 0, vertexCount, &entries[0] );
+			MeshKernels::SortEntries( &entries[0], vertexCount );
+		}
+
+		m_PointReps.resize( vertexCount );
+		for( unsigned int start = 0, end; start < vertexCount; start = end )
+		{
+			for( end = start + 1; end < vertexCount && entries[end].Key == entries[start].Key; end++ )
+			{
+			}
+
+			for( unsigned int i = start; i < end; i++ )
+			{
+				unsigned int vertex = entries[i].Value;
+				m_PointReps[vertex] = vertex;
+				for( unsigned int j = start; j < i; j++ )
+				{
+					if( memcmp( Position( entries[j].Value ), Position( vertex ), 3 * sizeof( float ) ) == 0 )
+					{
+						m_PointReps[vertex] = m_PointReps[entries[j].Value];
+						break;
+					}
+				}
+			}
+		}
+
+		std::vector<unsigned int> pointSizes( vertexCount, 0 );
+		m_Twins.assign( vertexCount, NoEdge );
+		for( unsigned int v = 0; v < vertexCount; v++ )
+		{
+			unsigned int rep = m_PointReps[v];
+			pointSizes[rep]++;
+			if( rep != v )
+			{
+				m_Twins[v] = rep;
+				m_Twins[rep] = v;
+			}
+		}
+
+		// directed edges by vertex and by point; an edge is open where the reverse edge is missing
+		std::vector<unsigned long long> edges( cornerCount );
+		std::vector<unsigned long long> pointEdges( cornerCount );
+		for( unsigned int i = 0; i < cornerCount; i++ )
+		{
+			unsigned int from = m_Indices[i];
+			unsigned int to = m_Indices[i - i % 3 + ( i + 1 ) % 3];
+			edges[i] = EdgeKey( from, to );
+			pointEdges[i] = EdgeKey( m_PointReps[from], m_PointReps[to] );
+		}
+		std::sort( edges.begin(), edges.end() );
+		std::sort( pointEdges.begin(), pointEdges.end() );
+
+		std::vector<unsigned char> tangled( vertexCount, 0 );
+		for( unsigned int i = 1; i < cornerCount; i++ )
+		{
+			// an edge used twice in the same direction is not manifold
+			if( edges[i] == edges[i - 1] )
+			{
+				tangled[static_cast<unsigned int>( edges[i] >> 32 )] = 1;
+				tangled[static_cast<unsigned int>( edges[i] )] = 1;
+			}
+		}
+
+		m_OpenIn.assign( vertexCount, NoEdge );
+		m_OpenOut.assign( vertexCount, NoEdge );
+		m_OpenCorners.assign( cornerCount, 0 );
+		for( unsigned int i = 0; i < cornerCount; i++ )
+		{
+			unsigned int from = m_Indices[i];
+			unsigned int to = m_Indices[i - i % 3 + ( i + 1 ) % 3];
+			if( from == to || HasEdge( edges, to, from ) )
+				continue;
+
+			m_OpenCorners[i] = 1;
+			Link( m_OpenOut[from], to );
+			Link( m_OpenIn[to], from );
+		}
+
+		m_Kinds.assign( vertexCount, LockedVertex );
+		for( unsigned int v = 0; v < vertexCount; v++ )
+		{
+			unsigned int point = m_PointReps[v];
+			unsigned int in = m_OpenIn[v];
+			unsigned int out = m_OpenOut[v];
+			bool closed = in == NoEdge && out == NoEdge;
+			bool single = in < ManyEdges && out < ManyEdges;
+
+			if( tangled[v] )
+				continue;
+
+			if( pointSizes[point] == 1 )
+			{
+				// an edge that is open between vertices but closed between points ends a seam, which has to stay
+				if( closed )
+					m_Kinds[v] = ManifoldVertex;
+				else if( single && !m_Settings.LockBorder && !HasEdge( pointEdges, m_PointReps[out], point ) && !HasEdge( pointEdges, point, m_PointReps[in] ) )
+					m_Kinds[v] = BorderVertex;
+			}
+			else if( pointSizes[point] == 2 )
+			{
+				// the two sides of a seam run along it in opposite directions
+				unsigned int twin = m_Twins[v];
+				unsigned int twinIn = m_OpenIn[twin];
+				unsigned int twinOut = m_OpenOut[twin];
+				if( single && twinIn < ManyEdges && twinOut < ManyEdges && !tangled[twin] &&
+					m_PointReps[out] == m_PointReps[twinIn] && m_PointReps[in] == m_PointReps[twinOut] )
+					m_Kinds[v] = SeamVertex;
+			}
+		}
+	}
+
+	void Simplifier::ComputeFaceQuadrics( unsigned int begin, unsigned int end )
+	{
+		for( unsigned int f = begin; f < end; f++ )
+		{
+			const float *p0 = Position( m_Indices[f * 3] );
+			double e1[3], e2[3], normal[3];
+			Difference( Position( m_Indices[f * 3 + 1] ), p0, e1 );
+			Difference( Position( m_Indices[f * 3 + 2] ), p0, e2 );
+			Cross( e1, e2, normal );
+
+			double length = sqrt( Dot( normal, normal ) );
+			if( length <= 0.0 )
+				continue;
+
+			for( int i = 0; i < 3; i++ )
+				normal[i] /= length;
+
+			double point[3] = { p0[0], p0[1], p0[2] };
+			double area = length * 0.5;
+			AddPlane( m_FaceQuadrics[f], normal, -Dot( normal, point ), area );
+			m_FaceQuadrics[f].Weight = area;
+		}
+	}
+
+	void Simplifier::GatherQuadrics( unsigned int begin, unsigned int end )
+	{
+		for( unsigned int v = begin; v < end; v++ )
+		{
+			for( unsigned int i = m_Starts[v]; i < m_Starts[v + 1]; i++ )
+				AddQuadric( m_Quadrics[v], m_FaceQuadrics[m_Corners[i] / 3] );
+		}
+	}
+
+	void Simplifier::AddBorderQuadrics()
+	{
+		// a plane through each open edge, at right angles to its face, holds borders and seams in place
+		if( m_Settings.BoundaryWeight > 0.0f )
+		{
+			for( unsigned int i = 0; i < m_OpenCorners.size(); i++ )
+			{
+				if( !m_OpenCorners[i] )
+					continue;
+
+				unsigned int face = i / 3;
+				unsigned int from = m_Indices[i];
+				unsigned int to = m_Indices[face * 3 + ( i + 1 ) % 3];
+
+				const float *p0 = Position( m_Indices[face * 3] );
+				double e1[3], e2[3], faceNormal[3], edge[3], normal[3];
+				Difference( Position( m_Indices[face * 3 + 1] ), p0, e1 );
+				Difference( Position( m_Indices[face * 3 + 2] ), p0, e2 );
+				Cross( e1, e2, faceNormal );
+				Difference( Position( to ), Position( from ), edge );
+				Cross( edge, faceNormal, normal );
+
+				double length = sqrt( Dot( normal, normal ) );
+				if( length <= 0.0 )
+					continue;
+
+				for( int c = 0; c < 3; c++ )
+					normal[c] /= length;
+
+				const float *origin = Position( from );
+				double point[3] = { origin[0], origin[1], origin[2] };
+				double weight = m_Settings.BoundaryWeight * Dot( edge, edge );
+				AddPlane( m_Quadrics[from], normal, -Dot( normal, point ), weight );
+				AddPlane( m_Quadrics[to], normal, -Dot( normal, point ), weight );
+			}
+		}
+
+		std::vector<unsigned char>().swap( m_OpenCorners );
+		std::vector<Quadric>().swap( m_FaceQuadrics );
+	}
+
+	void Simplifier::BeginPass()
+	{
+		unsigned int cornerCount = static_cast<unsigned int>( m_Indices.size() );
+		m_Starts.resize( m_VertexCount + 1 );
+		m_Corners.resize( cornerCount + 1 );
+		TangentKernels::BuildCornerLists( m_Indices.empty() ? NULL : &m_Indices[0], cornerCount / 3, NULL, m_VertexCount, &m_Starts[0], &m_Corners[0] );
+	}
+
+	float Simplifier::AttributeDistance( unsigned int vertex, unsigned int target ) const
+	{
+		const unsigned char *a = m_Vertices + static_cast<size_t>( vertex ) * m_Settings.Stride;
+		const unsigned char *b = m_Vertices + static_cast<size_t>( target ) * m_Settings.Stride;
+
+		float result = 0.0f;
+		for( size_t i = 0; i < m_Attributes.size(); i++ )
+		{
+			const Attribute &attribute = m_Attributes[i];
+			float sum = 0.0f;
+			for( unsigned int c = 0; c < attribute.Count; c++ )
+			{
+				float difference;
+				if( attribute.Kind == ColorAttribute )
+					difference = ( static_cast<float>( a[attribute.Offset + c] ) - b[attribute.Offset + c] ) / 255.0f;
+				else
+					difference = reinterpret_cast<const float*>( a + attribute.Offset )[c] - reinterpret_cast<const float*>( b + attribute.Offset )[c];
+				sum += difference * difference;
+			}
+
+			result += attribute.Weight * sum;
+		}
+
+		return result;
+	}
+
+	bool Simplifier::FlipsFaces( unsigned int vertex, unsigned int target ) const
+	{
+		const float *from = Position( vertex );
+		const float *to = Position( target );
+
+		for( unsigned int i = m_Starts[vertex]; i < m_Starts[vertex + 1]; i++ )
+		{
+			unsigned int face = m_Corners[i] / 3;
+			unsigned int corner = m_Corners[i] % 3;
+			unsigned int a = m_Indices[face * 3 + ( corner + 1 ) % 3];
+			unsigned int b = m_Indices[face * 3 + ( corner + 2 ) % 3];
+
+			// faces along the collapsed edge go away
+			if( a == target || b == target )
+				continue;
+
+			double ea[3], eb[3], before[3], after[3];
+			Difference( Position( a ), from, ea );
+			Difference( Position( b ), from, eb );
+			Cross( ea, eb, before );
+			Difference( Position( a ), to, ea );
+			Difference( Position( b ), to, eb );
+			Cross( ea, eb, after );
+
+			double lengths = sqrt( Dot( before, before ) * Dot( after, after ) );
+			if( Dot( after, after ) <= 0.0 || Dot( before, after ) < MinimumFaceCosine * lengths )
+				return true;
+		}
+
+		return false;
+	}
+
+	bool Simplifier::Evaluate( unsigned int vertex, unsigned int target, Collapse &collapse ) const
+	{
+		unsigned char kind = m_Kinds[vertex];
+		unsigned char targetKind = m_Kinds[target];
+		unsigned int twin = NoEdge;
+		unsigned int twinTarget = NoEdge;
+
+		if( kind == BorderVertex || kind == SeamVertex )
+		{
+			if( target != m_OpenIn[vertex] && target != m_OpenOut[vertex] )
+				return false;
+			if( targetKind != kind && targetKind != LockedVertex )
+				return false;
+		}
+
+		if( kind == SeamVertex )
+		{
+			// the other side runs the opposite way
+			twin = m_Twins[vertex];
+			twinTarget = target == m_OpenOut[vertex] ? m_OpenIn[twin] : m_OpenOut[twin];
+			if( twinTarget >= ManyEdges || m_PointReps[twinTarget] != m_PointReps[target] || FlipsFaces( twin, twinTarget ) )
+				return false;
+		}
+
+		if( FlipsFaces( vertex, target ) )
+			return false;
+
+		const Quadric &q = m_Quadrics[vertex];
+		double distance = EvaluateQuadric( q, Position( target ) );
+		double cost = m_Settings.PositionWeight * distance + AttributeDistance( vertex, target ) * q.Weight;
+		double area = q.Weight;
+
+		unsigned int removed = 0;
+		for( unsigned int i = m_Starts[vertex]; i < m_Starts[vertex + 1]; i++ )
+		{
+			unsigned int face = m_Corners[i] / 3;
+			if( m_Indices[face * 3] == target || m_Indices[face * 3 + 1] == target || m_Indices[face * 3 + 2] == target )
+				removed++;
+		}
+
+		if( twin != NoEdge )
+		{
+			const Quadric &t = m_Quadrics[twin];
+			distance += EvaluateQuadric( t, Position( twinTarget ) );
+			cost += m_Settings.PositionWeight * EvaluateQuadric( t, Position( twinTarget ) ) + AttributeDistance( twin, twinTarget ) * t.Weight;
+			area += t.Weight;
+
+			for( unsigned int i = m_Starts[twin]; i < m_Starts[twin + 1]; i++ )
+			{
+				unsigned int face = m_Corners[i] / 3;
+				if( m_Indices[face * 3] == twinTarget || m_Indices[face * 3 + 1] == twinTarget || m_Indices[face * 3 + 2] == twinTarget )
+					removed++;
+			}
+		}
+
+		if( !m_VertexWeights.empty() )
+			cost *= m_VertexWeights[vertex];
+
+		collapse.Target = target;
+		collapse.TwinTarget = twinTarget;
+		collapse.RemovedFaces = removed;
+		collapse.Cost = static_cast<float>( cost );
+		collapse.Error = static_cast<float>( sqrt( area > 0.0 ? distance / area : distance ) );
+		return true;
+	}
+
+	void Simplifier::FindCollapses( unsigned int begin, unsigned int end )
+	{
+		for( unsigned int v = begin; v < end; v++ )
+		{
+			Collapse best;
+			best.Target = NoEdge;
+
+			if( !m_Removed[v] && m_Kinds[v] != LockedVertex )
+			{
+				for( unsigned int i = m_Starts[v]; i < m_Starts[v + 1]; i++ )
+				{
+					unsigned int face = m_Corners[i] / 3;
+					for( unsigned int corner = 0; corner < 3; corner++ )
+					{
+						unsigned int target = m_Indices[face * 3 + corner];
+						if( target == v || target == best.Target )
+							continue;
+
+						// ties go to the lowest target, so the choice does not depend on face order
+						Collapse candidate;
+						if( Evaluate( v, target, candidate ) && ( best.Target == NoEdge || candidate.Cost < best.Cost ||
+							( candidate.Cost == best.Cost && target < best.Target ) ) )
+							best = candidate;
+					}
+				}
+			}
+
+			m_Collapses[v] = best;
+		}
+	}
+
+	struct CostLess
+	{
+		const std::vector<Collapse> *Collapses;
+
+		bool operator()( unsigned int left, unsigned int right ) const
+		{
+			float a = ( *Collapses )[left].Cost;
+			float b = ( *Collapses )[right].Cost;
+			return a < b || ( a == b && left < right );
+		}
+	};
+
+	void Simplifier::Touch( unsigned int vertex )
+	{
+		m_Touched[vertex] = 1;
+		for( unsigned int i = m_Starts[vertex]; i < m_Starts[vertex + 1]; i++ )
+		{
+			unsigned int face = m_Corners[i] / 3;
+			m_Touched[m_Indices[face * 3]] = 1;
+			m_Touched[m_Indices[face * 3 + 1]] = 1;
+			m_Touched[m_Indices[face * 3 + 2]] = 1;
+		}
+	}
+
+	void Simplifier::UpdateOpenEdges( unsigned int vertex, unsigned int target )
+	{
+		// the open edges into and out of the vertex become one edge that skips it
+		unsigned int in = m_OpenIn[vertex];
+		unsigned int out = m_OpenOut[vertex];
+		if( target == out )
+		{
+			if( in < ManyEdges )
+				m_OpenOut[in] = target;
+			if( m_OpenIn[target] == vertex )
+				m_OpenIn[target] = in;
+		}
+		else if( target == in )
+		{
+			if( out < ManyEdges )
+				m_OpenIn[out] = target;
+			if( m_OpenOut[target] == vertex )
+				m_OpenOut[target] = out;
+		}
+	}
+
+	unsigned int Simplifier::ApplyCollapses( unsigned int targetFaceCount, float maximumError )
+	{
+		unsigned int faceCount = FaceCount();
+		m_Applied.clear();
+		if( faceCount <= targetFaceCount )
+			return 0;
+
+		std::vector<unsigned int> order;
+		for( unsigned int v = 0; v < m_VertexCount; v++ )
+		{
+			if( m_Collapses[v].Target != NoEdge && m_Collapses[v].Error <= maximumError )
+				order.push_back( v );
+		}
+
+		CostLess less = { &m_Collapses };
+		std::sort( order.begin(), order.end(), less );
+
+		// only the cheaper part of the candidates is taken in one pass, so that expensive collapses wait until the
+		// cheap ones around them have been made and costs have been brought up to date
+		size_t limit = order.size() / 3 + 1;
+		unsigned int goal = faceCount - targetFaceCount;
+		unsigned int removed = 0;
+		std::fill( m_Touched.begin(), m_Touched.end(), 0 );
+
+		for( size_t i = 0; i < order.size() && i < limit && removed < goal; i++ )
+		{
+			unsigned int vertex = order[i];
+			const Collapse &collapse = m_Collapses[vertex];
+			unsigned int twin = m_Kinds[vertex] == SeamVertex ? m_Twins[vertex] : NoEdge;
+
+			if( m_Touched[vertex] || m_Touched[collapse.Target] )
+				continue;
+			if( twin != NoEdge && ( m_Touched[twin] || m_Touched[collapse.TwinTarget] ) )
+				continue;
+
+			Touch( vertex );
+			m_Remap[vertex] = collapse.Target;
+			m_Removed[vertex] = 1;
+			AddQuadric( m_Quadrics[collapse.Target], m_Quadrics[vertex] );
+			UpdateOpenEdges( vertex, collapse.Target );
+			m_Applied.push_back( vertex );
+
+			if( twin != NoEdge )
+			{
+				Touch( twin );
+				m_Remap[twin] = collapse.TwinTarget;
+				m_Removed[twin] = 1;
+				AddQuadric( m_Quadrics[collapse.TwinTarget], m_Quadrics[twin] );
+				UpdateOpenEdges( twin, collapse.TwinTarget );
+				m_Applied.push_back( twin );
+			}
+
+			removed += collapse.RemovedFaces;
+			m_Error = ( std::max )( m_Error, collapse.Error );
+		}
+
+		return static_cast<unsigned int>( m_Applied.size() );
+	}
+
+	void Simplifier::RemapFaces( unsigned int begin, unsigned int end )
+	{
+		for( unsigned int i = begin * 3; i < end * 3; i++ )
+			m_Indices[i] = m_Remap[m_Indices[i]];
+	}
+
+	void Simplifier::EndPass()
+	{
+		unsigned int kept = 0;
+		for( unsigned int f = 0; f < FaceCount(); f++ )
+		{
+			unsigned int a = m_Indices[f * 3];
+			unsigned int b = m_Indices[f * 3 + 1];
+			unsigned int c = m_Indices[f * 3 + 2];
+			if( a == b || b == c || c == a )
+				continue;
+
+			m_Indices[kept * 3] = a;
+			m_Indices[kept * 3 + 1] = b;
+			m_Indices[kept * 3 + 2] = c;
+			m_FaceIds[kept++] = m_FaceIds[f];
+		}
+
+		m_Indices.resize( kept * 3 );
+		m_FaceIds.resize( kept );
+
+		for( size_t i = 0; i < m_Applied.size(); i++ )
+			m_Remap[m_Applied[i]] = m_Applied[i];
+		m_Applied.clear();
+	}
+}
+}
+}
+
+#ifdef _MANAGED
+#pragma managed(pop)
+#endif
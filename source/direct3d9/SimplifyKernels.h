@@ -0,0 +1,161 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+
+// Quadric error simplification of indexed triangle lists with 32-bit indices, by half-edge collapses: a vertex is
+// folded into one of its neighbours, so every surviving vertex keeps its data and the vertex buffer never changes.
+// Collapses are made in passes. Within a pass the candidates of all vertices are found independently, then an
+// independent set of them is picked in cost order and applied, so the passes split across threads without locks and
+// always pick the same collapses. Nothing in here depends on Windows or the CLR.
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		namespace SimplifyKernels
+		{
+			enum AttributeKind
+			{
+				FloatAttribute,
+				ColorAttribute
+			};
+
+			// A vertex attribute whose change is charged when a vertex is folded into a neighbour, per unit of area.
+			struct Attribute
+			{
+				unsigned int Offset;
+				unsigned int Count;
+				AttributeKind Kind;
+				float Weight;
+			};
+
+			struct SimplifierSettings
+			{
+				unsigned int Stride;
+				unsigned int PositionOffset;
+				float PositionWeight;
+				float BoundaryWeight;
+				bool LockBorder;
+			};
+
+			// What a vertex is allowed to do. Border vertices only slide along the border and seam vertices along
+			// the seam, together with their twin on the other side; anything more tangled than that stays put.
+			enum VertexKind
+			{
+				ManifoldVertex,
+				BorderVertex,
+				SeamVertex,
+				LockedVertex
+			};
+
+			// The symmetric matrix, vector and constant of a sum of squared distances to planes, and the area
+			// the planes were weighted by.
+			struct Quadric
+			{
+				double A00, A01, A02, A11, A12, A22;
+				double B0, B1, B2;
+				double C;
+				double Weight;
+			};
+
+			struct Collapse
+			{
+				unsigned int Target;
+				unsigned int TwinTarget;
+				unsigned int RemovedFaces;
+				float Cost;
+				float Error;
+			};
+
+			class Simplifier
+			{
+			public:
+				// The vertices must stay in place for the life of the simplifier. vertexWeights may be NULL; a larger
+				// weight makes a vertex more expensive to remove.
+				Simplifier( const unsigned int *indices, unsigned int faceCount, const unsigned char *vertices, unsigned int vertexCount,
+					const SimplifierSettings &settings, const Attribute *attributes, unsigned int attributeCount, const float *vertexWeights );
+
+				// Setup, run once in order: plane quadrics for faces [begin, end), then their sums for vertices [begin, end),
+				// then the border planes.
+				void ComputeFaceQuadrics( unsigned int begin, unsigned int end );
+				void GatherQuadrics( unsigned int begin, unsigned int end );
+				void AddBorderQuadrics();
+
+				// A pass: lists the faces of each vertex, finds the cheapest collapse of vertices [begin, end), applies
+				// an independent set of collapses that stays within the target and error limit and returns how many,
+				// rewrites the indices of faces [begin, end), and drops the faces that collapsed.
+				void BeginPass();
+				void FindCollapses( unsigned int begin, unsigned int end );
+				unsigned int ApplyCollapses( unsigned int targetFaceCount, float maximumError );
+				void RemapFaces( unsigned int begin, unsigned int end );
+				void EndPass();
+
+				unsigned int FaceCount() const { return static_cast<unsigned int>( m_FaceIds.size() ); }
+				unsigned int VertexCount() const { return m_VertexCount; }
+				const unsigned int *Indices() const { return m_Indices.empty() ? NULL : &m_Indices[0]; }
+
+				// The original face of each remaining face.
+				const unsigned int *FaceIds() const { return m_FaceIds.empty() ? NULL : &m_FaceIds[0]; }
+
+				// The largest geometric error, as a distance, of any collapse made so far.
+				float Error() const { return m_Error; }
+
+			private:
+				const float *Position( unsigned int vertex ) const;
+				void Classify();
+				void UpdateOpenEdges( unsigned int vertex, unsigned int target );
+				float AttributeDistance( unsigned int vertex, unsigned int target ) const;
+				bool FlipsFaces( unsigned int vertex, unsigned int target ) const;
+				bool Evaluate( unsigned int vertex, unsigned int target, Collapse &collapse ) const;
+				void Touch( unsigned int vertex );
+
+				std::vector<unsigned int> m_Indices;
+				std::vector<unsigned int> m_FaceIds;
+				const unsigned char *m_Vertices;
+				unsigned int m_VertexCount;
+				SimplifierSettings m_Settings;
+				std::vector<Attribute> m_Attributes;
+				std::vector<float> m_VertexWeights;
+
+				std::vector<unsigned int> m_PointReps;
+				std::vector<unsigned int> m_Twins;
+				std::vector<unsigned int> m_OpenIn;
+				std::vector<unsigned int> m_OpenOut;
+				std::vector<unsigned char> m_Kinds;
+				std::vector<unsigned char> m_OpenCorners;
+
+				std::vector<Quadric> m_FaceQuadrics;
+				std::vector<Quadric> m_Quadrics;
+
+				std::vector<unsigned int> m_Starts;
+				std::vector<unsigned int> m_Corners;
+				std::vector<Collapse> m_Collapses;
+				std::vector<unsigned int> m_Remap;
+				std::vector<unsigned char> m_Removed;
+				std::vector<unsigned char> m_Touched;
+				std::vector<unsigned int> m_Applied;
+				float m_Error;
+			};
+		}
+	}
+}
@@ -0,0 +1,219 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <d3d9.h>
+#include <d3dx9.h>
+#include <string.h>
+#include <vector>
+
+#include "../ComObject.h"
+#include "../DataStream.h"
+#include "../ParallelLoop.h"
+
+#include "Direct3D9Exception.h"
+
+#include "D3DX.h"
+#include "Mesh.h"
+#include "SkinInfo.h"
+#include "MeshStreams.h"
+#include "SkinningKernels.h"
+#include "SkinningEngine.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+	// a vertex is a few dozen flops per influence, so hand them out in large ranges
+	const int VerticesPerRange = 2048;
+
+	ref class SkinningJob sealed
+	{
+	public:
+		const unsigned int *Starts;
+		const unsigned int *Bones;
+		const float *Weights;
+		const float *Matrices;
+		const float *InverseTransposes;
+		const SkinningKernels::DualQuaternion *Transforms;
+		const unsigned char *Source;
+		unsigned char *Destination;
+		const SkinningKernels::SkinLayout *Layout;
+
+		void Linear( int begin, int end )
+		{
+			SkinningKernels::SkinLinear( Starts, Bones, Weights, Matrices, InverseTransposes, Source, Destination, *Layout, begin, end );
+		}
+
+		void DualQuaternion( int begin, int end )
+		{
+			SkinningKernels::SkinDualQuaternion( Starts, Bones, Weights, Transforms, Source, Destination, *Layout, begin, end );
+		}
+	};
+
+	SkinningEngine::SkinningEngine( SkinInfo^ skinInfo, int vertexCount )
+	{
+		if( skinInfo == nullptr )
+			throw gcnew ArgumentNullException( "skinInfo" );
+		if( vertexCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "vertexCount" );
+
+		array<VertexElement>^ declaration = skinInfo->GetDeclaration();
+		positionOffset = FindVertexElement( declaration, DeclarationUsage::Position, 0, DeclarationType::Float3 );
+		if( positionOffset < 0 )
+			throw gcnew ArgumentException( "The skin declaration has no three-component float position.", "skinInfo" );
+
+		normalOffset = FindVertexElement( declaration, DeclarationUsage::Normal, 0, DeclarationType::Float3 );
+		tangentOffset = FindVertexElement( declaration, DeclarationUsage::Tangent, 0, DeclarationType::Float4 );
+		tangentHasSign = tangentOffset >= 0;
+		if( tangentOffset < 0 )
+			tangentOffset = FindVertexElement( declaration, DeclarationUsage::Tangent, 0, DeclarationType::Float3 );
+		binormalOffset = FindVertexElement( declaration, DeclarationUsage::Binormal, 0, DeclarationType::Float3 );
+
+		this->vertexCount = vertexCount;
+		boneCount = skinInfo->BoneCount;
+		vertexStride = D3DX::GetDeclarationVertexSize( declaration, 0 );
+
+		// gather the influences, which D3DX keeps per bone, into a list per vertex in bone order
+		array<array<int>^>^ boneVertices = gcnew array<array<int>^>( boneCount );
+		array<array<float>^>^ boneWeights = gcnew array<array<float>^>( boneCount );
+		starts = gcnew array<int>( vertexCount + 1 );
+
+		for( int bone = 0; bone < boneCount; bone++ )
+		{
+			if( skinInfo->GetBoneInfluenceCount( bone ) == 0 )
+				continue;
+			if( skinInfo->GetBoneInfluence( bone, boneVertices[bone], boneWeights[bone] ).IsFailure )
+				throw gcnew Direct3D9Exception( Result::Last );
+
+			for( int i = 0; i < boneVertices[bone]->Length; i++ )
+			{
+				int vertex = boneVertices[bone][i];
+				if( vertex < 0 || vertex >= vertexCount )
+					throw gcnew ArgumentException( "A bone influences a vertex past the end of the vertex data.", "vertexCount" );
+				if( boneWeights[bone][i] != 0.0f )
+					starts[vertex + 1]++;
+			}
+		}
+
+		maximumInfluences = 0;
+		for( int v = 0; v < vertexCount; v++ )
+		{
+			maximumInfluences = Math::Max( maximumInfluences, starts[v + 1] );
+			starts[v + 1] += starts[v];
+		}
+
+		// the arrays are pinned for each update, so they always get at least one element
+		bones = gcnew array<int>( Math::Max( starts[vertexCount], 1 ) );
+		weights = gcnew array<float>( bones->Length );
+		array<int>^ next = safe_cast<array<int>^>( starts->Clone() );
+
+		for( int bone = 0; bone < boneCount; bone++ )
+		{
+			if( boneVertices[bone] == nullptr )
+				continue;
+
+			for( int i = 0; i < boneVertices[bone]->Length; i++ )
+			{
+				if( boneWeights[bone][i] == 0.0f )
+					continue;
+
+				int slot = next[boneVertices[bone][i]]++;
+				bones[slot] = bone;
+				weights[slot] = boneWeights[bone][i];
+			}
+		}
+	}
+
+	void SkinningEngine::UpdateSkinnedMesh( array<Matrix>^ boneTransforms, array<Matrix>^ boneInvTransposeTransforms, DataStream^ source, DataStream^ destination )
+	{
+		UpdateSkinnedMesh( boneTransforms, boneInvTransposeTransforms, source, destination, SkinningMethod::Linear );
+	}
+
+	void SkinningEngine::UpdateSkinnedMesh( array<Matrix>^ boneTransforms, array<Matrix>^ boneInvTransposeTransforms, DataStream^ source, DataStream^ destination, SkinningMethod method )
+	{
+		if( boneTransforms == nullptr )
+			throw gcnew ArgumentNullException( "boneTransforms" );
+		if( boneTransforms->Length < boneCount )
+			throw gcnew ArgumentException( "There must be a transform for each bone.", "boneTransforms" );
+		if( boneInvTransposeTransforms != nullptr && boneInvTransposeTransforms->Length < boneCount )
+			throw gcnew ArgumentException( "There must be an inverse transpose transform for each bone.", "boneInvTransposeTransforms" );
+		if( method != SkinningMethod::Linear && method != SkinningMethod::DualQuaternion )
+			throw gcnew ArgumentOutOfRangeException( "method" );
+
+		Int64 size = static_cast<Int64>( vertexCount ) * vertexStride;
+		CheckMeshStream( source, size, "source" );
+		CheckMeshStream( destination, size, "destination" );
+
+		if( vertexCount == 0 )
+			return;
+
+		// with no bones there are no influences to apply
+		if( boneCount == 0 )
+		{
+			if( source->PositionPointer != destination->PositionPointer )
+				memcpy( destination->PositionPointer, source->PositionPointer, static_cast<size_t>( size ) );
+			return;
+		}
+
+		SkinningKernels::SkinLayout layout;
+		layout.Stride = vertexStride;
+		layout.PositionOffset = positionOffset;
+		layout.NormalOffset = normalOffset;
+		layout.TangentOffset = tangentOffset;
+		layout.TangentHasSign = tangentHasSign;
+		layout.BinormalOffset = binormalOffset;
+
+		pin_ptr<Matrix> pinnedTransforms = &boneTransforms[0];
+		pin_ptr<Matrix> pinnedInverses = nullptr;
+		if( boneInvTransposeTransforms != nullptr )
+			pinnedInverses = &boneInvTransposeTransforms[0];
+		pin_ptr<int> pinnedStarts = &starts[0];
+		pin_ptr<int> pinnedBones = &bones[0];
+		pin_ptr<float> pinnedWeights = &weights[0];
+
+		SkinningJob^ job = gcnew SkinningJob();
+		job->Starts = reinterpret_cast<const unsigned int*>( pinnedStarts );
+		job->Bones = reinterpret_cast<const unsigned int*>( pinnedBones );
+		job->Weights = pinnedWeights;
+		job->Matrices = reinterpret_cast<const float*>( pinnedTransforms );
+		job->InverseTransposes = reinterpret_cast<const float*>( pinnedInverses );
+		job->Source = reinterpret_cast<const unsigned char*>( source->PositionPointer );
+		job->Destination = reinterpret_cast<unsigned char*>( destination->PositionPointer );
+		job->Layout = &layout;
+
+		if( method == SkinningMethod::Linear )
+		{
+			ParallelLoop::For( vertexCount, VerticesPerRange, gcnew ParallelRange( job, &SkinningJob::Linear ) );
+			return;
+		}
+
+		std::vector<SkinningKernels::DualQuaternion> transforms( boneCount );
+		SkinningKernels::ToDualQuaternions( job->Matrices, boneCount, &transforms[0] );
+		job->Transforms = &transforms[0];
+
+		ParallelLoop::For( vertexCount, VerticesPerRange, gcnew ParallelRange( job, &SkinningJob::DualQuaternion ) );
+	}
+}
+}
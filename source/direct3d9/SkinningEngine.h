@@ -0,0 +1,127 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "../DataStream.h"
+#include "../math/Matrix.h"
+
+#include "D3DXEnums.h"
+#include "VertexElement.h"
+
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		ref class SkinInfo;
+
+		/// <summary>
+		/// Skins vertices on the CPU without D3DX, spreading the work across threads.
+		/// </summary>
+		/// <remarks>
+		/// The bone influences of a <see cref="SkinInfo"/> are gathered once into per-vertex lists, so each update only
+		/// walks the influences of each vertex. Positions, normals, tangents and binormals in stream 0 of the skin
+		/// declaration are transformed; the rest of each vertex is copied. As with <see cref="SkinInfo"/>.UpdateSkinnedMesh,
+		/// the bone transforms already include the bone offsets, and blended normals are not renormalized. Results do not
+		/// depend on the number of threads.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class SkinningEngine sealed
+		{
+		private:
+			array<int>^ starts;
+			array<int>^ bones;
+			array<float>^ weights;
+			int vertexCount;
+			int boneCount;
+			int vertexStride;
+			int maximumInfluences;
+
+			int positionOffset;
+			int normalOffset;
+			int tangentOffset;
+			bool tangentHasSign;
+			int binormalOffset;
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="SkinningEngine"/> class.
+			/// </summary>
+			/// <param name="skinInfo">The skin to take the bone influences and vertex declaration from.</param>
+			/// <param name="vertexCount">The number of vertices in the skinned vertex data.</param>
+			SkinningEngine( SkinInfo^ skinInfo, int vertexCount );
+
+			/// <summary>
+			/// Skins vertices by blending the bone matrices.
+			/// </summary>
+			/// <param name="boneTransforms">The transform of each bone.</param>
+			/// <param name="boneInvTransposeTransforms">The inverse transpose of each bone transform, used for normals, tangents and binormals, or <c>null</c> to use the bone transforms.</param>
+			/// <param name="source">The vertex data to skin.</param>
+			/// <param name="destination">The vertex data to receive the skinned vertices. It may be the same as <paramref name="source"/>.</param>
+			void UpdateSkinnedMesh( array<Matrix>^ boneTransforms, array<Matrix>^ boneInvTransposeTransforms, DataStream^ source, DataStream^ destination );
+
+			/// <summary>
+			/// Skins vertices.
+			/// </summary>
+			/// <param name="boneTransforms">The transform of each bone.</param>
+			/// <param name="boneInvTransposeTransforms">
+			/// The inverse transpose of each bone transform, used for normals, tangents and binormals by <see cref="SkinningMethod::Linear"/>,
+			/// or <c>null</c> to use the bone transforms.
+			/// </param>
+			/// <param name="source">The vertex data to skin.</param>
+			/// <param name="destination">The vertex data to receive the skinned vertices. It may be the same as <paramref name="source"/>.</param>
+			/// <param name="method">How to blend the bone transforms.</param>
+			void UpdateSkinnedMesh( array<Matrix>^ boneTransforms, array<Matrix>^ boneInvTransposeTransforms, DataStream^ source, DataStream^ destination, SkinningMethod method );
+
+			/// <summary>
+			/// Gets the number of vertices that are skinned.
+			/// </summary>
+			property int VertexCount
+			{
+				int get() { return vertexCount; }
+			}
+
+			/// <summary>
+			/// Gets the number of bones.
+			/// </summary>
+			property int BoneCount
+			{
+				int get() { return boneCount; }
+			}
+
+			/// <summary>
+			/// Gets the size of a vertex, in bytes.
+			/// </summary>
+			property int VertexStride
+			{
+				int get() { return vertexStride; }
+			}
+
+			/// <summary>
+			/// Gets the largest number of bones that influence one vertex.
+			/// </summary>
+			property int MaximumVertexInfluences
+			{
+				int get() { return maximumInfluences; }
+			}
+		};
+	}
+}
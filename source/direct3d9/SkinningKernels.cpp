@@ -0,0 +1,342 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <string.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define SKINNING_USE_SSE
+#include <emmintrin.h>
+#endif
+
+#include "SkinningKernels.h"
+
+// intrinsics are not available to managed code
+#ifdef _MANAGED
+#pragma managed(push, off)
+#endif
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+namespace SkinningKernels
+{
+	// The weighted sum of the matrices of the influences of one vertex.
+	struct BlendedMatrix
+	{
+#ifdef SKINNING_USE_SSE
+		__m128 Rows[4];
+#else
+		float Rows[4][4];
+#endif
+	};
+
+	static inline void Blend( const unsigned int *bones, const float *weights, unsigned int first, unsigned int last, const float *matrices, BlendedMatrix &result )
+	{
+#ifdef SKINNING_USE_SSE
+		__m128 r0 = _mm_setzero_ps(), r1 = _mm_setzero_ps(), r2 = _mm_setzero_ps(), r3 = _mm_setzero_ps();
+		for( unsigned int i = first; i < last; i++ )
+		{
+			const float *m = matrices + static_cast<size_t>( bones[i] ) * 16;
+			__m128 weight = _mm_set1_ps( weights[i] );
+			r0 = _mm_add_ps( r0, _mm_mul_ps( weight, _mm_loadu_ps( m ) ) );
+			r1 = _mm_add_ps( r1, _mm_mul_ps( weight, _mm_loadu_ps( m + 4 ) ) );
+			r2 = _mm_add_ps( r2, _mm_mul_ps( weight, _mm_loadu_ps( m + 8 ) ) );
+			r3 = _mm_add_ps( r3, _mm_mul_ps( weight, _mm_loadu_ps( m + 12 ) ) );
+		}
+
+		result.Rows[0] = r0;
+		result.Rows[1] = r1;
+		result.Rows[2] = r2;
+		result.Rows[3] = r3;
+#else
+		memset( result.Rows, 0, sizeof( result.Rows ) );
+		for( unsigned int i = first; i < last; i++ )
+		{
+			const float *m = matrices + static_cast<size_t>( bones[i] ) * 16;
+			for( int r = 0; r < 4; r++ )
+			{
+				for( int c = 0; c < 4; c++ )
+					result.Rows[r][c] += weights[i] * m[r * 4 + c];
+			}
+		}
+#endif
+	}
+
+	// Transforms three floats as a point (with translation) or as a direction.
+	static inline void Transform( const BlendedMatrix &matrix, const unsigned char *source, unsigned char *destination, bool point )
+	{
+		float v[3];
+		memcpy( v, source, sizeof( v ) );
+
+#ifdef SKINNING_USE_SSE
+		__m128 result = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( v[0] ), matrix.Rows[0] ), _mm_mul_ps( _mm_set1_ps( v[1] ), matrix.Rows[1] ) ),
+			_mm_mul_ps( _mm_set1_ps( v[2] ), matrix.Rows[2] ) );
+		if( point )
+			result = _mm_add_ps( result, matrix.Rows[3] );
+
+		float values[4];
+		_mm_storeu_ps( values, result );
+		memcpy( destination, values, sizeof( v ) );
+#else
+		float values[3];
+		for( int c = 0; c < 3; c++ )
+			values[c] = v[0] * matrix.Rows[0][c] + v[1] * matrix.Rows[1][c] + v[2] * matrix.Rows[2][c] + ( point ? matrix.Rows[3][c] : 0.0f );
+		memcpy( destination, values, sizeof( values ) );
+#endif
+	}
+
+	void SkinLinear( const unsigned int *starts, const unsigned int *bones, const float *weights, const float *matrices,
+		const float *inverseTransposes, const unsigned char *source, unsigned char *destination, const SkinLayout &layout,
+		unsigned int begin, unsigned int end )
+	{
+		bool directions = layout.NormalOffset >= 0 || layout.TangentOffset >= 0 || layout.BinormalOffset >= 0;
+		bool shared = inverseTransposes == NULL || inverseTransposes == matrices;
+
+		for( unsigned int v = begin; v < end; v++ )
+		{
+			const unsigned char *from = source + static_cast<size_t>( v ) * layout.Stride;
+			unsigned char *to = destination + static_cast<size_t>( v ) * layout.Stride;
+			if( from != to )
+				memcpy( to, from, layout.Stride );
+
+			if( starts[v] == starts[v + 1] )
+				continue;
+
+			BlendedMatrix matrix;
+			Blend( bones, weights, starts[v], starts[v + 1], matrices, matrix );
+			if( layout.PositionOffset >= 0 )
+				Transform( matrix, from + layout.PositionOffset, to + layout.PositionOffset, true );
+
+			if( !directions )
+				continue;
+
+			BlendedMatrix inverse;
+			if( shared )
+				inverse = matrix;
+			else
+				Blend( bones, weights, starts[v], starts[v + 1], inverseTransposes, inverse );
+
+			if( layout.NormalOffset >= 0 )
+				Transform( inverse, from + layout.NormalOffset, to + layout.NormalOffset, false );
+			if( layout.TangentOffset >= 0 )
+				Transform( inverse, from + layout.TangentOffset, to + layout.TangentOffset, false );
+			if( layout.BinormalOffset >= 0 )
+				Transform( inverse, from + layout.BinormalOffset, to + layout.BinormalOffset, false );
+		}
+	}
+
+	static inline float Length( float x, float y, float z )
+	{
+		return sqrtf( x * x + y * y + z * z );
+	}
+
+	void ToDualQuaternions( const float *matrices, unsigned int count, DualQuaternion *result )
+	{
+		for( unsigned int i = 0; i < count; i++ )
+		{
+			const float *m = matrices + static_cast<size_t>( i ) * 16;
+
+			// the rotation, with any scale divided out of the rows
+			float a[3][3];
+			for( int r = 0; r < 3; r++ )
+			{
+				float length = Length( m[r * 4], m[r * 4 + 1], m[r * 4 + 2] );
+				float scale = length > 0.0f ? 1.0f / length : 0.0f;
+				for( int c = 0; c < 3; c++ )
+					a[r][c] = m[r * 4 + c] * scale;
+			}
+
+			// the matrices transform row vectors, so they hold the transpose of the usual rotation
+			float x, y, z, w;
+			float trace = a[0][0] + a[1][1] + a[2][2];
+			if( trace > 0.0f )
+			{
+				float s = sqrtf( trace + 1.0f ) * 2.0f;
+				w = 0.25f * s;
+				x = ( a[1][2] - a[2][1] ) / s;
+				y = ( a[2][0] - a[0][2] ) / s;
+				z = ( a[0][1] - a[1][0] ) / s;
+			}
+			else if( a[0][0] > a[1][1] && a[0][0] > a[2][2] )
+			{
+				float s = sqrtf( 1.0f + a[0][0] - a[1][1] - a[2][2] ) * 2.0f;
+				w = ( a[1][2] - a[2][1] ) / s;
+				x = 0.25f * s;
+				y = ( a[0][1] + a[1][0] ) / s;
+				z = ( a[2][0] + a[0][2] ) / s;
+			}
+			else if( a[1][1] > a[2][2] )
+			{
+				float s = sqrtf( 1.0f + a[1][1] - a[0][0] - a[2][2] ) * 2.0f;
+				w = ( a[2][0] - a[0][2] ) / s;
+				x = ( a[0][1] + a[1][0] ) / s;
+				y = 0.25f * s;
+				z = ( a[1][2] + a[2][1] ) / s;
+			}
+			else
+			{
+				float s = sqrtf( 1.0f + a[2][2] - a[0][0] - a[1][1] ) * 2.0f;
+				w = ( a[0][1] - a[1][0] ) / s;
+				x = ( a[2][0] + a[0][2] ) / s;
+				y = ( a[1][2] + a[2][1] ) / s;
+				z = 0.25f * s;
+			}
+
+			float length = sqrtf( x * x + y * y + z * z + w * w );
+			float scale = length > 0.0f ? 1.0f / length : 0.0f;
+			x *= scale;
+			y *= scale;
+			z *= scale;
+			w = length > 0.0f ? w * scale : 1.0f;
+
+			// the dual part is half the translation times the rotation
+			float tx = m[12], ty = m[13], tz = m[14];
+			DualQuaternion &q = result[i];
+			q.Real[0] = x;
+			q.Real[1] = y;
+			q.Real[2] = z;
+			q.Real[3] = w;
+			q.Dual[0] = 0.5f * ( tx * w + ty * z - tz * y );
+			q.Dual[1] = 0.5f * ( -tx * z + ty * w + tz * x );
+			q.Dual[2] = 0.5f * ( tx * y - ty * x + tz * w );
+			q.Dual[3] = -0.5f * ( tx * x + ty * y + tz * z );
+		}
+	}
+
+	// Rotates three floats by a unit quaternion, and adds a translation if one is given.
+	static inline void Rotate( const float *q, const float *translation, const unsigned char *source, unsigned char *destination )
+	{
+		float v[3];
+		memcpy( v, source, sizeof( v ) );
+
+		// v + 2w(u x v) + 2u x (u x v), with t = 2(u x v)
+		float tx = 2.0f * ( q[1] * v[2] - q[2] * v[1] );
+		float ty = 2.0f * ( q[2] * v[0] - q[0] * v[2] );
+		float tz = 2.0f * ( q[0] * v[1] - q[1] * v[0] );
+
+		float result[3];
+		result[0] = v[0] + q[3] * tx + ( q[1] * tz - q[2] * ty );
+		result[1] = v[1] + q[3] * ty + ( q[2] * tx - q[0] * tz );
+		result[2] = v[2] + q[3] * tz + ( q[0] * ty - q[1] * tx );
+
+		if( translation != NULL )
+		{
+			result[0] += translation[0];
+			result[1] += translation[1];
+			result[2] += translation[2];
+		}
+
+		memcpy( destination, result, sizeof( result ) );
+	}
+
+	void SkinDualQuaternion( const unsigned int *starts, const unsigned int *bones, const float *weights, const DualQuaternion *transforms,
+		const unsigned char *source, unsigned char *destination, const SkinLayout &layout, unsigned int begin, unsigned int end )
+	{
+		for( unsigned int v = begin; v < end; v++ )
+		{
+			const unsigned char *from = source + static_cast<size_t>( v ) * layout.Stride;
+			unsigned char *to = destination + static_cast<size_t>( v ) * layout.Stride;
+			if( from != to )
+				memcpy( to, from, layout.Stride );
+
+			unsigned int first = starts[v];
+			unsigned int last = starts[v + 1];
+			if( first == last )
+				continue;
+
+			// every rotation is taken on the same side of the first, so that blending goes the short way round
+			const float *pivot = transforms[bones[first]].Real;
+			float real[4], dual[4];
+
+#ifdef SKINNING_USE_SSE
+			__m128 pivotVector = _mm_loadu_ps( pivot );
+			__m128 realSum = _mm_setzero_ps();
+			__m128 dualSum = _mm_setzero_ps();
+			for( unsigned int i = first; i < last; i++ )
+			{
+				const DualQuaternion &q = transforms[bones[i]];
+				__m128 r = _mm_loadu_ps( q.Real );
+				__m128 products = _mm_mul_ps( r, pivotVector );
+				products = _mm_add_ps( products, _mm_shuffle_ps( products, products, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+				products = _mm_add_ss( products, _mm_movehl_ps( products, products ) );
+				float weight = _mm_cvtss_f32( products ) < 0.0f ? -weights[i] : weights[i];
+
+				__m128 w = _mm_set1_ps( weight );
+				realSum = _mm_add_ps( realSum, _mm_mul_ps( w, r ) );
+				dualSum = _mm_add_ps( dualSum, _mm_mul_ps( w, _mm_loadu_ps( q.Dual ) ) );
+			}
+
+			_mm_storeu_ps( real, realSum );
+			_mm_storeu_ps( dual, dualSum );
+#else
+			memset( real, 0, sizeof( real ) );
+			memset( dual, 0, sizeof( dual ) );
+			for( unsigned int i = first; i < last; i++ )
+			{
+				const DualQuaternion &q = transforms[bones[i]];
+				float dot = q.Real[0] * pivot[0] + q.Real[1] * pivot[1] + q.Real[2] * pivot[2] + q.Real[3] * pivot[3];
+				float weight = dot < 0.0f ? -weights[i] : weights[i];
+				for( int c = 0; c < 4; c++ )
+				{
+					real[c] += weight * q.Real[c];
+					dual[c] += weight * q.Dual[c];
+				}
+			}
+#endif
+
+			float length = sqrtf( real[0] * real[0] + real[1] * real[1] + real[2] * real[2] + real[3] * real[3] );
+			if( !( length > 0.0f ) )
+				continue;
+
+			float scale = 1.0f / length;
+			for( int c = 0; c < 4; c++ )
+			{
+				real[c] *= scale;
+				dual[c] *= scale;
+			}
+
+			// the translation is twice the vector part of the dual times the conjugate of the real
+			float translation[3];
+			translation[0] = 2.0f * ( real[3] * dual[0] - dual[3] * real[0] + real[1] * dual[2] - real[2] * dual[1] );
+			translation[1] = 2.0f * ( real[3] * dual[1] - dual[3] * real[1] + real[2] * dual[0] - real[0] * dual[2] );
+			translation[2] = 2.0f * ( real[3] * dual[2] - dual[3] * real[2] + real[0] * dual[1] - real[1] * dual[0] );
+
+			if( layout.PositionOffset >= 0 )
+				Rotate( real, translation, from + layout.PositionOffset, to + layout.PositionOffset );
+			if( layout.NormalOffset >= 0 )
+				Rotate( real, NULL, from + layout.NormalOffset, to + layout.NormalOffset );
+			if( layout.TangentOffset >= 0 )
+				Rotate( real, NULL, from + layout.TangentOffset, to + layout.TangentOffset );
+			if( layout.BinormalOffset >= 0 )
+				Rotate( real, NULL, from + layout.BinormalOffset, to + layout.BinormalOffset );
+		}
+	}
+}
+}
+}
+
+#ifdef _MANAGED
+#pragma managed(pop)
+#endif
@@ -0,0 +1,69 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+// Portable CPU skinning of interleaved vertices. Influences are kept as three parallel arrays, indexed through a
+// start offset per vertex. Each call skins a range of vertices and writes only those vertices, so ranges can be run
+// on any number of threads with identical results. Matrices are row-major and transform row vectors, as in D3DX.
+// Nothing in here depends on Windows or the CLR.
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		namespace SkinningKernels
+		{
+			// Byte offsets of the skinned components within a vertex; -1 for components the vertex does not have.
+			// The tangent is four floats when TangentHasSign is set, and its fourth float is copied unchanged.
+			struct SkinLayout
+			{
+				unsigned int Stride;
+				int PositionOffset;
+				int NormalOffset;
+				int TangentOffset;
+				bool TangentHasSign;
+				int BinormalOffset;
+			};
+
+			// A rigid transform as a unit rotation quaternion (X, Y, Z, W) and a dual part that carries the translation.
+			struct DualQuaternion
+			{
+				float Real[4];
+				float Dual[4];
+			};
+
+			// Converts count matrices to dual quaternions. Scale is removed from each matrix first.
+			void ToDualQuaternions( const float *matrices, unsigned int count, DualQuaternion *result );
+
+			// Skins vertices [begin, end) by blending the bone matrices. Normals, tangents and binormals use the
+			// blend of inverseTransposes. source and destination may be the same; otherwise the rest of each vertex is
+			// copied across. Vertices without influences are left untransformed.
+			void SkinLinear( const unsigned int *starts, const unsigned int *bones, const float *weights, const float *matrices,
+				const float *inverseTransposes, const unsigned char *source, unsigned char *destination, const SkinLayout &layout,
+				unsigned int begin, unsigned int end );
+
+			// Skins vertices [begin, end) by blending the bone dual quaternions, which keeps volume at twisting
+			// joints. Behaves like SkinLinear otherwise.
+			void SkinDualQuaternion( const unsigned int *starts, const unsigned int *bones, const float *weights, const DualQuaternion *transforms,
+				const unsigned char *source, unsigned char *destination, const SkinLayout &layout, unsigned int begin, unsigned int end );
+		}
+	}
+}
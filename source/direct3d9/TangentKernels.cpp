@@ -0,0 +1,390 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <string.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define TANGENT_USE_SSE
+#include <emmintrin.h>
+#endif
+
+#include "TangentKernels.h"
+
+// intrinsics are not available to managed code
+#ifdef _MANAGED
+#pragma managed(push, off)
+#endif
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+namespace TangentKernels
+{
+	struct Float3
+	{
+		float X;
+		float Y;
+		float Z;
+	};
+
+	static inline Float3 Load( const unsigned char *data, unsigned int vertex, unsigned int stride )
+	{
+		Float3 result;
+		memcpy( &result, data + static_cast<size_t>( vertex ) * stride, sizeof( Float3 ) );
+		return result;
+	}
+
+	static inline Float3 Subtract( const Float3 &left, const Float3 &right )
+	{
+		Float3 result = { left.X - right.X, left.Y - right.Y, left.Z - right.Z };
+		return result;
+	}
+
+	static inline Float3 Scale( const Float3 &value, float scale )
+	{
+		Float3 result = { value.X * scale, value.Y * scale, value.Z * scale };
+		return result;
+	}
+
+	static inline Float3 Cross( const Float3 &left, const Float3 &right )
+	{
+		Float3 result = { left.Y * right.Z - left.Z * right.Y, left.Z * right.X - left.X * right.Z, left.X * right.Y - left.Y * right.X };
+		return result;
+	}
+
+	static inline float Dot( const Float3 &left, const Float3 &right )
+	{
+		return left.X * right.X + left.Y * right.Y + left.Z * right.Z;
+	}
+
+	static inline float Length( const Float3 &value )
+	{
+		return sqrtf( Dot( value, value ) );
+	}
+
+	// the angle at the first point of a triangle
+	static float CornerAngle( const Float3 &corner, const Float3 &next, const Float3 &previous )
+	{
+		Float3 a = Subtract( next, corner );
+		Float3 b = Subtract( previous, corner );
+		float lengths = Length( a ) * Length( b );
+		if( lengths <= 0.0f )
+			return 0.0f;
+
+		float cosine = Dot( a, b ) / lengths;
+		cosine = cosine > 1.0f ? 1.0f : ( cosine < -1.0f ? -1.0f : cosine );
+		return acosf( cosine );
+	}
+
+	static float CornerWeight( const FrameOptions &options, const Float3 *points, unsigned int corner, float area )
+	{
+		switch( options.Weights )
+		{
+		case WeightByArea:
+			return area;
+		case WeightEqually:
+			return 1.0f;
+		default:
+			return CornerAngle( points[corner], points[( corner + 1 ) % 3], points[( corner + 2 ) % 3] );
+		}
+	}
+
+	static inline float Wrap( float difference, bool wrap )
+	{
+		return wrap ? difference - floorf( difference + 0.5f ) : difference;
+	}
+
+	static inline void SetContribution( Contribution &contribution, const Float3 &value, float w )
+	{
+		contribution.X = value.X;
+		contribution.Y = value.Y;
+		contribution.Z = value.Z;
+		contribution.W = w;
+	}
+
+	static inline void Accumulate( const Contribution *contributions, const unsigned int *corners, unsigned int begin, unsigned int end, Contribution &sum )
+	{
+#ifdef TANGENT_USE_SSE
+		__m128 total = _mm_setzero_ps();
+		for( unsigned int i = begin; i < end; i++ )
+			total = _mm_add_ps( total, _mm_loadu_ps( &contributions[corners[i]].X ) );
+		_mm_storeu_ps( &sum.X, total );
+#else
+		Contribution total = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for( unsigned int i = begin; i < end; i++ )
+		{
+			const Contribution &c = contributions[corners[i]];
+			total.X += c.X;
+			total.Y += c.Y;
+			total.Z += c.Z;
+			total.W += c.W;
+		}
+		sum = total;
+#endif
+	}
+
+	void BuildCornerLists( const unsigned int *indices, unsigned int faceCount, const unsigned int *groups, unsigned int vertexCount,
+		unsigned int *starts, unsigned int *corners )
+	{
+		memset( starts, 0, ( vertexCount + 1 ) * sizeof( unsigned int ) );
+		for( unsigned int i = 0; i < faceCount * 3; i++ )
+		{
+			unsigned int key = groups != NULL ? groups[indices[i]] : indices[i];
+			starts[key + 1]++;
+		}
+
+		for( unsigned int v = 0; v < vertexCount; v++ )
+			starts[v + 1] += starts[v];
+
+		// filling moves each start up to the end of its list, which is where the next list starts
+		for( unsigned int i = 0; i < faceCount * 3; i++ )
+		{
+			unsigned int key = groups != NULL ? groups[indices[i]] : indices[i];
+			corners[starts[key]++] = i;
+		}
+
+		for( unsigned int v = vertexCount; v > 0; v-- )
+			starts[v] = starts[v - 1];
+		starts[0] = 0;
+	}
+
+	void FaceNormals( const unsigned int *indices, const unsigned char *positions, unsigned int stride, const FrameOptions &options,
+		unsigned int begin, unsigned int end, Contribution *contributions )
+	{
+		for( unsigned int f = begin; f < end; f++ )
+		{
+			Float3 points[3];
+			for( unsigned int corner = 0; corner < 3; corner++ )
+				points[corner] = Load( positions, indices[f * 3 + corner], stride );
+
+			Float3 normal = Cross( Subtract( points[1], points[0] ), Subtract( points[2], points[0] ) );
+			float length = Length( normal );
+			if( length > 0.0f )
+				normal = Scale( normal, ( options.Clockwise ? -1.0f : 1.0f ) / length );
+
+			for( unsigned int corner = 0; corner < 3; corner++ )
+			{
+				float weight = length > 0.0f ? CornerWeight( options, points, corner, length * 0.5f ) : 0.0f;
+				SetContribution( contributions[f * 3 + corner], Scale( normal, weight ), 0.0f );
+			}
+		}
+	}
+
+	void GatherNormals( const unsigned int *starts, const unsigned int *corners, const Contribution *contributions, const unsigned int *groups,
+		unsigned int begin, unsigned int end, unsigned char *normals, unsigned int stride )
+	{
+		for( unsigned int v = begin; v < end; v++ )
+		{
+			unsigned int key = groups != NULL ? groups[v] : v;
+
+			Contribution sum;
+			Accumulate( contributions, corners, starts[key], starts[key + 1], sum );
+
+			Float3 normal = { sum.X, sum.Y, sum.Z };
+			float length = Length( normal );
+			if( length > 0.0f )
+				normal = Scale( normal, 1.0f / length );
+
+			memcpy( normals + static_cast<size_t>( v ) * stride, &normal, sizeof( Float3 ) );
+		}
+	}
+
+	void FaceTangents( const unsigned int *indices, const unsigned char *positions, const unsigned char *normals, const unsigned char *textureCoordinates,
+		unsigned int stride, const FrameOptions &options, unsigned int begin, unsigned int end, Contribution *contributions )
+	{
+		static const Float3 Zero = { 0.0f, 0.0f, 0.0f };
+
+		for( unsigned int f = begin; f < end; f++ )
+		{
+			Float3 points[3];
+			float uv[3][2];
+			for( unsigned int corner = 0; corner < 3; corner++ )
+			{
+				unsigned int vertex = indices[f * 3 + corner];
+				points[corner] = Load( positions, vertex, stride );
+				memcpy( uv[corner], textureCoordinates + static_cast<size_t>( vertex ) * stride, sizeof( uv[corner] ) );
+			}
+
+			Float3 d1 = Subtract( points[1], points[0] );
+			Float3 d2 = Subtract( points[2], points[0] );
+			float s1 = Wrap( uv[1][0] - uv[0][0], options.WrapU );
+			float t1 = Wrap( uv[1][1] - uv[0][1], options.WrapV );
+			float s2 = Wrap( uv[2][0] - uv[0][0], options.WrapU );
+			float t2 = Wrap( uv[2][1] - uv[0][1], options.WrapV );
+
+			// twice the signed area of the face in texture space; its sign tells whether the mapping is mirrored
+			float textureArea = s1 * t2 - s2 * t1;
+			float area = Length( Cross( d1, d2 ) ) * 0.5f;
+			if( textureArea == 0.0f || area == 0.0f )
+			{
+				for( unsigned int corner = 0; corner < 3; corner++ )
+					SetContribution( contributions[f * 3 + corner], Zero, 0.0f );
+				continue;
+			}
+
+			float sign = textureArea > 0.0f ? 1.0f : -1.0f;
+			Float3 direction = Subtract( Scale( d1, t2 * sign ), Scale( d2, t1 * sign ) );
+
+			for( unsigned int corner = 0; corner < 3; corner++ )
+			{
+				Float3 tangent = direction;
+				if( options.Orthogonalize )
+				{
+					Float3 normal = Load( normals, indices[f * 3 + corner], stride );
+					tangent = Subtract( tangent, Scale( normal, Dot( normal, tangent ) ) );
+				}
+
+				float length = Length( tangent );
+				if( length <= 0.0f )
+				{
+					SetContribution( contributions[f * 3 + corner], Zero, 0.0f );
+					continue;
+				}
+
+				SetContribution( contributions[f * 3 + corner], Scale( tangent, CornerWeight( options, points, corner, area ) / length ), sign );
+			}
+		}
+	}
+
+	void GatherTangents( const unsigned int *starts, const unsigned int *corners, const Contribution *contributions,
+		unsigned int begin, unsigned int end, Contribution *positive, Contribution *negative )
+	{
+#ifdef TANGENT_USE_SSE
+		const __m128 one = _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f );
+		const __m128 xyz = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+#endif
+
+		for( unsigned int v = begin; v < end; v++ )
+		{
+			// W ends up counting the corners on each side
+#ifdef TANGENT_USE_SSE
+			__m128 plus = _mm_setzero_ps();
+			__m128 minus = _mm_setzero_ps();
+			for( unsigned int i = starts[v]; i < starts[v + 1]; i++ )
+			{
+				const Contribution &c = contributions[corners[i]];
+				__m128 value = _mm_loadu_ps( &c.X );
+				if( c.W > 0.0f )
+					plus = _mm_add_ps( plus, _mm_or_ps( _mm_and_ps( value, xyz ), one ) );
+				else if( c.W < 0.0f )
+					minus = _mm_add_ps( minus, _mm_or_ps( _mm_and_ps( value, xyz ), one ) );
+			}
+			_mm_storeu_ps( &positive[v].X, plus );
+			_mm_storeu_ps( &negative[v].X, minus );
+#else
+			Contribution plus = { 0.0f, 0.0f, 0.0f, 0.0f };
+			Contribution minus = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for( unsigned int i = starts[v]; i < starts[v + 1]; i++ )
+			{
+				const Contribution &c = contributions[corners[i]];
+				Contribution &side = c.W > 0.0f ? plus : minus;
+				if( c.W == 0.0f )
+					continue;
+
+				side.X += c.X;
+				side.Y += c.Y;
+				side.Z += c.Z;
+				side.W += 1.0f;
+			}
+			positive[v] = plus;
+			negative[v] = minus;
+#endif
+		}
+	}
+
+	void FinishTangent( const float *normal, const Contribution &sum, const FrameOptions &options, float *tangent )
+	{
+		Float3 n = { normal[0], normal[1], normal[2] };
+		Float3 t = { sum.X, sum.Y, sum.Z };
+		if( options.Orthogonalize )
+			t = Subtract( t, Scale( n, Dot( n, t ) ) );
+
+		float length = Length( t );
+		if( length <= 1e-12f )
+		{
+			// any direction in the plane of the normal will do; take the one closest to an axis the normal is far from
+			Float3 axis = { 1.0f, 0.0f, 0.0f };
+			if( fabsf( n.X ) > 0.9f )
+			{
+				axis.X = 0.0f;
+				axis.Y = 1.0f;
+			}
+
+			t = Subtract( axis, Scale( n, Dot( n, axis ) ) );
+			length = Length( t );
+		}
+
+		t = Scale( t, 1.0f / length );
+		memcpy( tangent, &t, sizeof( Float3 ) );
+	}
+
+	static void WriteFrame( unsigned char *vertex, const FrameLayout &layout, const Contribution &sum, float sign, const FrameOptions &options )
+	{
+		float normal[3];
+		memcpy( normal, vertex + layout.NormalOffset, sizeof( normal ) );
+
+		float tangent[4];
+		FinishTangent( normal, sum, options, tangent );
+		tangent[3] = sign;
+
+		if( layout.TangentOffset >= 0 )
+			memcpy( vertex + layout.TangentOffset, tangent, ( layout.TangentHasSign ? 4 : 3 ) * sizeof( float ) );
+
+		if( layout.BinormalOffset >= 0 )
+		{
+			Float3 n = { normal[0], normal[1], normal[2] };
+			Float3 t = { tangent[0], tangent[1], tangent[2] };
+			Float3 binormal = Scale( Cross( n, t ), sign );
+			memcpy( vertex + layout.BinormalOffset, &binormal, sizeof( Float3 ) );
+		}
+	}
+
+	void WriteFrames( unsigned char *vertices, const FrameLayout &layout, const Contribution *positive, const Contribution *negative,
+		const unsigned int *splits, const FrameOptions &options, unsigned int begin, unsigned int end )
+	{
+		for( unsigned int v = begin; v < end; v++ )
+		{
+			unsigned char *vertex = vertices + static_cast<size_t>( v ) * layout.Stride;
+			if( splits != NULL && splits[v] != ~0u )
+			{
+				WriteFrame( vertex, layout, positive[v], 1.0f, options );
+				WriteFrame( vertices + static_cast<size_t>( splits[v] ) * layout.Stride, layout, negative[v], -1.0f, options );
+				continue;
+			}
+
+			// opposite sides point opposite ways across a mirror, so mixing them would cancel the tangent out
+			if( negative[v].W > positive[v].W )
+				WriteFrame( vertex, layout, negative[v], -1.0f, options );
+			else
+				WriteFrame( vertex, layout, positive[v], 1.0f, options );
+		}
+	}
+}
+}
+}
+
+#ifdef _MANAGED
+#pragma managed(pop)
+#endif
@@ -0,0 +1,105 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+// Portable normal and tangent frame generation for indexed triangle lists with 32-bit indices. Each pass either
+// works on a range of faces or a range of vertices and writes only to its own outputs, so the ranges can be run on
+// any number of threads with identical results. Nothing in here depends on Windows or the CLR.
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		namespace TangentKernels
+		{
+			enum Weighting
+			{
+				WeightByAngle,
+				WeightByArea,
+				WeightEqually
+			};
+
+			struct FrameOptions
+			{
+				Weighting Weights;
+				bool Clockwise;
+				bool WrapU;
+				bool WrapV;
+				bool Orthogonalize;
+			};
+
+			// The contribution of one face corner. W carries the handedness of tangent contributions, and is zero
+			// for corners that contribute nothing.
+			struct Contribution
+			{
+				float X;
+				float Y;
+				float Z;
+				float W;
+			};
+
+			// Lists the corners (face * 3 + corner) that touch each vertex, in face order. When groups is not NULL,
+			// corners are listed under the group of their vertex instead, so vertices of a group share one list.
+			// starts receives vertexCount + 1 offsets into corners, which has room for faceCount * 3 entries.
+			void BuildCornerLists( const unsigned int *indices, unsigned int faceCount, const unsigned int *groups, unsigned int vertexCount,
+				unsigned int *starts, unsigned int *corners );
+
+			// Computes the weighted face normal at each corner of faces [begin, end).
+			void FaceNormals( const unsigned int *indices, const unsigned char *positions, unsigned int stride, const FrameOptions &options,
+				unsigned int begin, unsigned int end, Contribution *contributions );
+
+			// Sums the corner normals of the group of each vertex in [begin, end) and writes the normalized result
+			// as three floats at normals + vertex * stride.
+			void GatherNormals( const unsigned int *starts, const unsigned int *corners, const Contribution *contributions, const unsigned int *groups,
+				unsigned int begin, unsigned int end, unsigned char *normals, unsigned int stride );
+
+			// Computes the weighted tangent of each corner of faces [begin, end) from the texture coordinates, as
+			// MikkTSpace does: the direction of increasing u projected onto the plane of the vertex normal, signed
+			// by whether the texture is mirrored on the face. Faces without a usable mapping contribute nothing.
+			void FaceTangents( const unsigned int *indices, const unsigned char *positions, const unsigned char *normals, const unsigned char *textureCoordinates,
+				unsigned int stride, const FrameOptions &options, unsigned int begin, unsigned int end, Contribution *contributions );
+
+			// Sums the corner tangents of each vertex in [begin, end) separately for each handedness.
+			void GatherTangents( const unsigned int *starts, const unsigned int *corners, const Contribution *contributions,
+				unsigned int begin, unsigned int end, Contribution *positive, Contribution *negative );
+
+			// Turns a tangent sum into the unit tangent of a vertex with the given normal. A vertex without any
+			// tangent gets one perpendicular to its normal.
+			void FinishTangent( const float *normal, const Contribution &sum, const FrameOptions &options, float *tangent );
+
+			// Where the tangent frame goes in a vertex. Offsets of elements that are not wanted are -1.
+			struct FrameLayout
+			{
+				unsigned int Stride;
+				unsigned int NormalOffset;
+				int TangentOffset;
+				bool TangentHasSign;
+				int BinormalOffset;
+			};
+
+			// Writes the tangent frames of vertices [begin, end). A vertex used with both handednesses keeps the
+			// positive side and writes the negative side to vertex splits[vertex], which must already hold a copy of
+			// it; when splits is NULL or the entry is ~0 the vertex takes the side with more corners.
+			void WriteFrames( unsigned char *vertices, const FrameLayout &layout, const Contribution *positive, const Contribution *negative,
+				const unsigned int *splits, const FrameOptions &options, unsigned int begin, unsigned int end );
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "VertexCacheStatistics.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace Direct3D9
+{
+	float VertexCacheStatistics::AverageCacheMissRatio::get()
+	{
+		return FaceCount == 0 ? 0.0f : static_cast<float>( CacheMissCount ) / FaceCount;
+	}
+
+	float VertexCacheStatistics::AverageTransformToVertexRatio::get()
+	{
+		return VertexCount == 0 ? 0.0f : static_cast<float>( CacheMissCount ) / VertexCount;
+	}
+
+	bool VertexCacheStatistics::operator == ( VertexCacheStatistics left, VertexCacheStatistics right )
+	{
+		return VertexCacheStatistics::Equals( left, right );
+	}
+
+	bool VertexCacheStatistics::operator != ( VertexCacheStatistics left, VertexCacheStatistics right )
+	{
+		return !VertexCacheStatistics::Equals( left, right );
+	}
+
+	int VertexCacheStatistics::GetHashCode()
+	{
+		return FaceCount.GetHashCode() + VertexCount.GetHashCode() + CacheMissCount.GetHashCode();
+	}
+
+	bool VertexCacheStatistics::Equals( Object^ value )
+	{
+		if( value == nullptr )
+			return false;
+
+		if( value->GetType() != GetType() )
+			return false;
+
+		return Equals( safe_cast<VertexCacheStatistics>( value ) );
+	}
+
+	bool VertexCacheStatistics::Equals( VertexCacheStatistics value )
+	{
+		return ( FaceCount == value.FaceCount && VertexCount == value.VertexCount && CacheMissCount == value.CacheMissCount );
+	}
+
+	bool VertexCacheStatistics::Equals( VertexCacheStatistics% value1, VertexCacheStatistics% value2 )
+	{
+		return ( value1.FaceCount == value2.FaceCount && value1.VertexCount == value2.VertexCount && value1.CacheMissCount == value2.CacheMissCount );
+	}
+}
+}
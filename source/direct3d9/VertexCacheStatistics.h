@@ -0,0 +1,77 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	namespace Direct3D9
+	{
+		/// <summary>
+		/// Describes how an index list behaves in a simulated FIFO post-transform vertex cache.
+		/// </summary>
+		/// <unmanaged>None</unmanaged>
+		public value class VertexCacheStatistics : System::IEquatable<VertexCacheStatistics>
+		{
+		public:
+			/// <summary>
+			/// Gets or sets the number of faces that were drawn.
+			/// </summary>
+			property int FaceCount;
+
+			/// <summary>
+			/// Gets or sets the number of distinct vertices referenced by the faces.
+			/// </summary>
+			property int VertexCount;
+
+			/// <summary>
+			/// Gets or sets the number of vertices that had to be transformed because they were not in the cache.
+			/// </summary>
+			property int CacheMissCount;
+
+			/// <summary>
+			/// Gets the average cache miss ratio (ACMR), the number of transformed vertices per face. It ranges from 3 for
+			/// no reuse down to about 0.5 for a regular grid.
+			/// </summary>
+			property float AverageCacheMissRatio
+			{
+				float get();
+			}
+
+			/// <summary>
+			/// Gets the average transform to vertex ratio (ATVR), the number of times each vertex was transformed.
+			/// 1 is optimal.
+			/// </summary>
+			property float AverageTransformToVertexRatio
+			{
+				float get();
+			}
+
+			static bool operator == ( VertexCacheStatistics left, VertexCacheStatistics right );
+			static bool operator != ( VertexCacheStatistics left, VertexCacheStatistics right );
+
+			virtual int GetHashCode() override;
+			virtual bool Equals( System::Object^ obj ) override;
+			virtual bool Equals( VertexCacheStatistics other );
+			static bool Equals( VertexCacheStatistics% value1, VertexCacheStatistics% value2 );
+		};
+	}
+}
@@ -23,7 +23,7 @@
 
 #include "../SlimDXException.h"
 
-#define RECORD_DINPUT(x) Result::Record<DirectInputException^>( (x), (nullptr), (nullptr) )
+#define RECORD_DINPUT(x) Result::Record<DirectInputException^>( SLIMDX_INSTRUMENT_RESULT(x), (nullptr), (nullptr) )
 
 namespace SlimDX
 {
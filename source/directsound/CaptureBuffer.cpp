@@ -144,6 +144,32 @@ namespace DirectSound
 		return Unlock( stream1, stream2 );
 	}
 
+	Result CaptureBuffer::Read( int bufferOffset, IntPtr destination, int count )
+	{
+		if( destination == IntPtr::Zero )
+			throw gcnew ArgumentNullException( "destination" );
+		if( count < 0 )
+			throw gcnew ArgumentOutOfRangeException( "count" );
+		if( count == 0 )
+			return Result( DS_OK );
+
+		void* buffer1;
+		void* buffer2;
+		DWORD size1, size2;
+
+		HRESULT hr = InternalPointer->Lock( bufferOffset, count, &buffer1, &size1, &buffer2, &size2, 0 );
+		if( RECORD_DSOUND( hr ).IsFailure )
+			return Result::Last;
+
+		char* output = reinterpret_cast<char*>( destination.ToPointer() );
+		memcpy( output, buffer1, size1 );
+		if( buffer2 != NULL )
+			memcpy( output + size1, buffer2, size2 );
+
+		hr = InternalPointer->Unlock( buffer1, size1, buffer2, size2 );
+		return RECORD_DSOUND( hr );
+	}
+
 	Result CaptureBuffer::SetNotificationPositions( array<NotificationPosition>^ positions )
 	{
 		IDirectSoundNotify *pointer;
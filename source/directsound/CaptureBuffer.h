@@ -25,6 +25,7 @@
 #include "DirectSoundCapture.h"
 #include "CaptureBufferDescription.h"
 #include "NotificationPosition.h"
+#include "ICaptureSource.h"
 
 namespace SlimDX
 {
@@ -36,7 +37,7 @@ namespace SlimDX
 		/// The CaptureBuffer object is used to manipulate sound capture buffers.
 		/// </summary>
 		/// <unmanaged>IDirectSoundCaptureBuffer8</unmanaged>
-		public ref class CaptureBuffer : public ComObject
+		public ref class CaptureBuffer : public ComObject, ICaptureSource
 		{
 			COMOBJECT(IDirectSoundCaptureBuffer8, CaptureBuffer);
 
@@ -71,7 +72,16 @@ namespace SlimDX
 			generic<typename T> where T : value class
 			Result Read( array<T>^ data, int bufferOffset, bool lockEntireBuffer );
 
-			Result SetNotificationPositions( array<NotificationPosition>^ positions );
+			virtual Result SetNotificationPositions( array<NotificationPosition>^ positions );
+
+			/// <summary>
+			/// Copies captured data to unmanaged memory without allocating, wrapping around the end of the buffer.
+			/// </summary>
+			/// <param name="bufferOffset">The offset, in bytes, in the buffer to start copying from.</param>
+			/// <param name="destination">The memory to copy to.</param>
+			/// <param name="count">The number of bytes to copy, at most the size of the buffer.</param>
+			/// <returns>A <see cref="SlimDX::Result"/> object describing the result of the operation.</returns>
+			virtual Result Read( int bufferOffset, System::IntPtr destination, int count );
 
 			/// <summary>
 			/// Begins capturing data into the buffer. If the buffer is already capturing, the method has no effect.
@@ -104,7 +114,7 @@ namespace SlimDX
 			/// </summary>
 			property SlimDX::Multimedia::WaveFormat^ Format
 			{
-				SlimDX::Multimedia::WaveFormat^ get();
+				virtual SlimDX::Multimedia::WaveFormat^ get();
 			}
 
 			/// <summary>
@@ -112,7 +122,7 @@ namespace SlimDX
 			/// </summary>
 			property int SizeInBytes
 			{
-				int get();
+				virtual int get();
 			}
 
 			/// <summary>
@@ -136,7 +146,7 @@ namespace SlimDX
 			/// </summary>
 			property int CurrentReadPosition
 			{
-				int get();
+				virtual int get();
 			}
 		};
 	}
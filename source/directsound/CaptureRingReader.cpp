@@ -0,0 +1,363 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <windows.h>
+#include <dsound.h>
+
+#include "../RingStream.h"
+#include "../multimedia/WaveFormat.h"
+
+#include "DirectSoundException.h"
+
+#include "CaptureRingReader.h"
+
+using namespace System;
+using namespace System::Diagnostics;
+using namespace System::Threading;
+using namespace SlimDX::Multimedia;
+
+namespace SlimDX
+{
+namespace DirectSound
+{
+	static TimeSpan ToTimeSpan( Int64 ticks )
+	{
+		return TimeSpan::FromTicks( static_cast<Int64>( ticks * ( static_cast<double>( TimeSpan::TicksPerSecond ) / Stopwatch::Frequency ) ) );
+	}
+
+	CaptureRingReader::CaptureRingReader( ICaptureSource^ source, int blockFrames, int ringBlocks )
+	{
+		if( source == nullptr )
+			throw gcnew ArgumentNullException( "source" );
+		if( blockFrames < 1 )
+			throw gcnew ArgumentOutOfRangeException( "blockFrames" );
+		if( ringBlocks < 2 )
+			throw gcnew ArgumentOutOfRangeException( "ringBlocks" );
+
+		WaveFormat^ format = source->Format;
+		if( format == nullptr || format->BlockAlignment <= 0 )
+			throw gcnew ArgumentException( "The capture source does not have a valid format.", "source" );
+
+		m_Source = source;
+		m_Format = format;
+		m_FrameSize = format->BlockAlignment;
+		m_BufferSize = source->SizeInBytes;
+		m_BlockFrames = blockFrames;
+
+		Int64 blockSize = static_cast<Int64>( blockFrames ) * m_FrameSize;
+		if( blockSize > m_BufferSize )
+			throw gcnew ArgumentOutOfRangeException( "blockFrames", "A block cannot be larger than the capture buffer." );
+		if( blockSize * ringBlocks > ( 1 << 30 ) )
+			throw gcnew ArgumentOutOfRangeException( "ringBlocks" );
+
+		m_BlockSize = static_cast<int>( blockSize );
+		m_Ring = gcnew RingStream( m_BlockSize * ringBlocks, RingStreamMode::SingleProducer );
+
+		// the ring rounds its capacity up, so there are stamps for every block it can hold plus the one being filled
+		m_BlockTimes = gcnew array<Int64>( m_Ring->Capacity / m_BlockSize + 2 );
+
+		// the timeout only matters for sources whose notifications are late or missing
+		int bytesPerSecond = format->AverageBytesPerSecond;
+		m_PollInterval = bytesPerSecond > 0 ? Math::Max( 1, static_cast<int>( blockSize * 1000 / bytesPerSecond ) ) : 10;
+
+		m_Notify = gcnew AutoResetEvent( false );
+		array<NotificationPosition>^ positions = gcnew array<NotificationPosition>( m_BufferSize / m_BlockSize );
+		for( int i = 0; i < positions->Length; i++ )
+		{
+			positions[i].Offset = ( i + 1 ) * m_BlockSize - 1;
+			positions[i].Event = m_Notify;
+		}
+
+		Result result = source->SetNotificationPositions( positions );
+		if( result.IsFailure )
+		{
+			delete m_Ring;
+			throw gcnew DirectSoundException( result );
+		}
+
+		m_ReadCursor = source->CurrentReadPosition;
+
+		// the thread only holds the reader weakly, so that an undisposed reader can still be finalized
+		m_Thread = gcnew Thread( gcnew ParameterizedThreadStart( &CaptureRingReader::Run ) );
+		m_Thread->IsBackground = true;
+		m_Thread->Name = "SlimDX capture reader";
+		m_Thread->Start( gcnew WeakReference( this ) );
+	}
+
+	CaptureRingReader::~CaptureRingReader()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	CaptureRingReader::!CaptureRingReader()
+	{
+		Destruct();
+	}
+
+	void CaptureRingReader::Destruct()
+	{
+		if( m_Thread == nullptr )
+			return;
+
+		// completing the ring releases a consumer blocked in ReadBlock, which then finds the reader disposed
+		Interlocked::Exchange( m_Stopping, 1 );
+		m_Ring->CompleteWriting();
+		m_Notify->Set();
+		m_Thread->Join();
+		m_Thread = nullptr;
+
+		// the event is left open, since the capture source still holds its notification positions
+		delete m_Ring;
+	}
+
+	void CaptureRingReader::CheckError()
+	{
+		if( Thread::VolatileRead( m_Stopping ) != 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		Exception^ error = m_Error;
+		if( error != nullptr )
+			throw gcnew InvalidOperationException( "The capture thread has stopped because of an error.", error );
+	}
+
+	void CaptureRingReader::Run( Object^ state )
+	{
+		WeakReference^ reference = safe_cast<WeakReference^>( state );
+		CaptureRingReader^ reader = safe_cast<CaptureRingReader^>( reference->Target );
+		if( reader == nullptr )
+			return;
+
+		AutoResetEvent^ notify = reader->m_Notify;
+		int pollInterval = reader->m_PollInterval;
+
+		while( reader->Step() )
+		{
+			// let go of the reader while waiting, so that it can be collected if nobody disposes it
+			reader = nullptr;
+
+			notify->WaitOne( pollInterval, false );
+
+			reader = safe_cast<CaptureRingReader^>( reference->Target );
+			if( reader == nullptr )
+				return;
+		}
+	}
+
+	bool CaptureRingReader::Step()
+	{
+		if( Thread::VolatileRead( m_Stopping ) != 0 )
+			return false;
+
+		try
+		{
+			Pump();
+			return true;
+		}
+		catch( Exception^ e )
+		{
+			// a write refused because Destruct completed the ring is not an error
+			if( Thread::VolatileRead( m_Stopping ) != 0 )
+				return false;
+
+			// handed to the consumer on its next read; completing the ring releases it if it is waiting
+			m_Error = e;
+			m_Ring->CompleteWriting();
+			return false;
+		}
+	}
+
+	void CaptureRingReader::Pump()
+	{
+		Int64 now = Stopwatch::GetTimestamp();
+		int bytesPerSecond = m_Format->AverageBytesPerSecond;
+		if( m_LastPassTime != 0 && bytesPerSecond > 0 )
+		{
+			// positions only tell us where the device is modulo the buffer, so a long enough stall hides a whole lap
+			Int64 elapsedBytes = ( now - m_LastPassTime ) * bytesPerSecond / Stopwatch::Frequency;
+			if( elapsedBytes >= m_BufferSize )
+				Interlocked::Increment( m_CaptureOverrunCount );
+		}
+		m_LastPassTime = now;
+
+		int available = m_Source->CurrentReadPosition - m_ReadCursor;
+		if( available < 0 )
+			available += m_BufferSize;
+		available -= available % m_FrameSize;
+		if( available == 0 )
+			return;
+
+		int space = m_Ring->FreeSpace;
+		int count = Math::Min( available, space - space % m_FrameSize );
+		if( count > 0 )
+		{
+			// a single producer always gets the whole reservation, and it may wrap in the ring as well as in the source
+			RingBufferRegion region = m_Ring->ReserveWrite( count );
+
+			Result result = m_Source->Read( m_ReadCursor, region.First, region.FirstSize );
+			if( result.IsSuccess && region.SecondSize > 0 )
+				result = m_Source->Read( ( m_ReadCursor + region.FirstSize ) % m_BufferSize, region.Second, region.SecondSize );
+			if( result.IsFailure )
+				throw gcnew DirectSoundException( result );
+
+			Int64 copied = Stopwatch::GetTimestamp();
+			Int64 lastBlock = ( m_WrittenBytes + count ) / m_BlockSize;
+			for( Int64 block = m_WrittenBytes / m_BlockSize; block < lastBlock; block++ )
+				m_BlockTimes[static_cast<int>( block % m_BlockTimes->Length )] = copied;
+
+			m_WrittenBytes += count;
+			m_Ring->CommitWrite( region );
+			Interlocked::Add( m_CapturedBytes, count );
+		}
+
+		if( count < available )
+		{
+			Interlocked::Add( m_DroppedBytes, available - count );
+			Interlocked::Increment( m_OverrunCount );
+		}
+
+		m_ReadCursor = ( m_ReadCursor + available ) % m_BufferSize;
+	}
+
+	bool CaptureRingReader::CopyBlock( char *destination )
+	{
+		RingBufferRegion region = m_Ring->PeekRead( m_BlockSize );
+		if( region.Size < m_BlockSize )
+			return false;
+
+		memcpy( destination, region.First.ToPointer(), region.FirstSize );
+		if( region.SecondSize > 0 )
+			memcpy( destination + region.FirstSize, region.Second.ToPointer(), region.SecondSize );
+
+		// the stamp was written before the block was committed, so it is visible once the block is
+		Int64 stamp = m_BlockTimes[static_cast<int>( m_ReadBlocks % m_BlockTimes->Length )];
+		m_ReadBlocks++;
+		m_Ring->CommitRead( m_BlockSize );
+
+		Int64 latency = Stopwatch::GetTimestamp() - stamp;
+		Interlocked::Exchange( m_LastLatency, latency );
+		Interlocked::Add( m_TotalLatency, latency );
+		if( latency > Interlocked::Read( m_MaximumLatency ) )
+			Interlocked::Exchange( m_MaximumLatency, latency );
+		Interlocked::Increment( m_BlocksDelivered );
+
+		return true;
+	}
+
+	generic<typename T>
+	bool CaptureRingReader::TryReadBlock( array<T>^ block )
+	{
+		CheckError();
+		if( block == nullptr )
+			throw gcnew ArgumentNullException( "block" );
+		if( static_cast<Int64>( block->Length ) * sizeof(T) < m_BlockSize )
+			throw gcnew ArgumentException( "The array is smaller than a block.", "block" );
+
+		pin_ptr<T> pinnedBlock = &block[0];
+		return CopyBlock( reinterpret_cast<char*>( pinnedBlock ) );
+	}
+
+	bool CaptureRingReader::TryReadBlock( IntPtr destination )
+	{
+		CheckError();
+		if( destination == IntPtr::Zero )
+			throw gcnew ArgumentNullException( "destination" );
+
+		return CopyBlock( reinterpret_cast<char*>( destination.ToPointer() ) );
+	}
+
+	generic<typename T>
+	bool CaptureRingReader::ReadBlock( array<T>^ block, int millisecondsTimeout )
+	{
+		CheckError();
+		if( block == nullptr )
+			throw gcnew ArgumentNullException( "block" );
+		if( static_cast<Int64>( block->Length ) * sizeof(T) < m_BlockSize )
+			throw gcnew ArgumentException( "The array is smaller than a block.", "block" );
+
+		if( !m_Ring->WaitForData( m_BlockSize, millisecondsTimeout ) )
+			return false;
+
+		// the wait also ends when the reader is disposed or the capture thread fails, which the read reports
+		return TryReadBlock( block );
+	}
+
+	void CaptureRingReader::ResetStatistics()
+	{
+		Interlocked::Exchange( m_CapturedBytes, 0 );
+		Interlocked::Exchange( m_DroppedBytes, 0 );
+		Interlocked::Exchange( m_BlocksDelivered, 0 );
+		Interlocked::Exchange( m_OverrunCount, 0 );
+		Interlocked::Exchange( m_CaptureOverrunCount, 0 );
+		Interlocked::Exchange( m_TotalLatency, 0 );
+		Interlocked::Exchange( m_MaximumLatency, 0 );
+		Interlocked::Exchange( m_LastLatency, 0 );
+	}
+
+	int CaptureRingReader::AvailableBlocks::get()
+	{
+		CheckError();
+		return m_Ring->Count / m_BlockSize;
+	}
+
+	Int64 CaptureRingReader::CapturedBytes::get()
+	{
+		return Interlocked::Read( m_CapturedBytes );
+	}
+
+	Int64 CaptureRingReader::DroppedBytes::get()
+	{
+		return Interlocked::Read( m_DroppedBytes );
+	}
+
+	int CaptureRingReader::OverrunCount::get()
+	{
+		return Thread::VolatileRead( m_OverrunCount );
+	}
+
+	int CaptureRingReader::CaptureOverrunCount::get()
+	{
+		return Thread::VolatileRead( m_CaptureOverrunCount );
+	}
+
+	Int64 CaptureRingReader::BlocksDelivered::get()
+	{
+		return Interlocked::Read( m_BlocksDelivered );
+	}
+
+	TimeSpan CaptureRingReader::LastLatency::get()
+	{
+		return ToTimeSpan( Interlocked::Read( m_LastLatency ) );
+	}
+
+	TimeSpan CaptureRingReader::AverageLatency::get()
+	{
+		Int64 blocks = Interlocked::Read( m_BlocksDelivered );
+		return blocks == 0 ? TimeSpan::Zero : ToTimeSpan( Interlocked::Read( m_TotalLatency ) / blocks );
+	}
+
+	TimeSpan CaptureRingReader::MaximumLatency::get()
+	{
+		return ToTimeSpan( Interlocked::Read( m_MaximumLatency ) );
+	}
+}
+}
@@ -0,0 +1,241 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "ICaptureSource.h"
+
+namespace SlimDX
+{
+	ref class RingStream;
+
+	namespace DirectSound
+	{
+		/// <summary>
+		/// Drains a circular capture buffer on a dedicated thread into a lock-free ring, and hands the captured audio out in blocks
+		/// of a fixed number of frames.
+		/// </summary>
+		/// <remarks>
+		/// <para>The reader sets a notification position at the end of every block of the capture buffer and copies whatever has been
+		/// captured each time one is signaled, so it must be created while the buffer is stopped. Audio that does not fit in the ring
+		/// because the consumer has fallen behind is dropped and counted as an overrun; a reader thread that wakes up later than the
+		/// length of the capture buffer is counted as a capture overrun, since the device may have overwritten audio it had not read.</para>
+		/// <para>There must be a single consumer. Reading a block never allocates, and the latency of each block is measured from the
+		/// moment it was copied into the ring to the moment it was read.</para>
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class CaptureRingReader : System::IDisposable
+		{
+		private:
+			ICaptureSource^ m_Source;
+			SlimDX::Multimedia::WaveFormat^ m_Format;
+			int m_BlockFrames;
+			int m_BlockSize;
+			int m_FrameSize;
+			int m_BufferSize;
+			int m_PollInterval;
+
+			RingStream^ m_Ring;
+			array<System::Int64>^ m_BlockTimes;
+
+			int m_ReadCursor;
+			System::Int64 m_WrittenBytes;
+			System::Int64 m_LastPassTime;
+			System::Int64 m_ReadBlocks;
+
+			int m_Stopping;
+			System::Exception^ m_Error;
+			System::Threading::AutoResetEvent^ m_Notify;
+			System::Threading::Thread^ m_Thread;
+
+			System::Int64 m_CapturedBytes;
+			System::Int64 m_DroppedBytes;
+			System::Int64 m_BlocksDelivered;
+			int m_OverrunCount;
+			int m_CaptureOverrunCount;
+			System::Int64 m_TotalLatency;
+			System::Int64 m_MaximumLatency;
+			System::Int64 m_LastLatency;
+
+			void Destruct();
+			void CheckError();
+			static void Run( System::Object^ state );
+			bool Step();
+			void Pump();
+			bool CopyBlock( char *destination );
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="CaptureRingReader"/> class and starts its thread.
+			/// </summary>
+			/// <param name="source">The capture buffer, or a stand-in, to read from. It must not be capturing yet.</param>
+			/// <param name="blockFrames">The number of frames in each block handed to the consumer.</param>
+			/// <param name="ringBlocks">The number of blocks the ring can hold before captured audio is dropped.</param>
+			CaptureRingReader( ICaptureSource^ source, int blockFrames, int ringBlocks );
+
+			/// <summary>
+			/// Stops the reader thread and releases the ring. The capture source is left as it is.
+			/// </summary>
+			~CaptureRingReader();
+
+			/// <summary>
+			/// Stops the reader thread and releases the ring.
+			/// </summary>
+			!CaptureRingReader();
+
+			/// <summary>
+			/// Copies the next block to an array if one is available, without waiting or allocating.
+			/// </summary>
+			/// <typeparam name="T">The type of the samples.</typeparam>
+			/// <param name="block">The array to copy to, which must hold at least <see cref="BlockSize"/> bytes.</param>
+			/// <returns><c>true</c> if a block was copied; otherwise, <c>false</c>.</returns>
+			generic<typename T> where T : value class
+			bool TryReadBlock( array<T>^ block );
+
+			/// <summary>
+			/// Copies the next block to unmanaged memory if one is available, without waiting or allocating.
+			/// </summary>
+			/// <param name="destination">The memory to copy to, which must hold at least <see cref="BlockSize"/> bytes.</param>
+			/// <returns><c>true</c> if a block was copied; otherwise, <c>false</c>.</returns>
+			bool TryReadBlock( System::IntPtr destination );
+
+			/// <summary>
+			/// Waits for the next block and copies it to an array.
+			/// </summary>
+			/// <typeparam name="T">The type of the samples.</typeparam>
+			/// <param name="block">The array to copy to, which must hold at least <see cref="BlockSize"/> bytes.</param>
+			/// <param name="millisecondsTimeout">The number of milliseconds to wait, or <see cref="System::Threading::Timeout::Infinite"/>.</param>
+			/// <returns><c>true</c> if a block was copied; <c>false</c> if the wait timed out.</returns>
+			/// <exception cref="System::ObjectDisposedException">The reader was disposed, including while waiting.</exception>
+			generic<typename T> where T : value class
+			bool ReadBlock( array<T>^ block, int millisecondsTimeout );
+
+			/// <summary>
+			/// Resets the overrun, delivery and latency statistics.
+			/// </summary>
+			void ResetStatistics();
+
+			/// <summary>
+			/// Gets the source the reader drains.
+			/// </summary>
+			property ICaptureSource^ Source
+			{
+				ICaptureSource^ get() { return m_Source; }
+			}
+
+			/// <summary>
+			/// Gets the format of the captured audio.
+			/// </summary>
+			property SlimDX::Multimedia::WaveFormat^ Format
+			{
+				SlimDX::Multimedia::WaveFormat^ get() { return m_Format; }
+			}
+
+			/// <summary>
+			/// Gets the number of frames in each block.
+			/// </summary>
+			property int BlockFrames
+			{
+				int get() { return m_BlockFrames; }
+			}
+
+			/// <summary>
+			/// Gets the size of each block, in bytes.
+			/// </summary>
+			property int BlockSize
+			{
+				int get() { return m_BlockSize; }
+			}
+
+			/// <summary>
+			/// Gets the number of whole blocks waiting in the ring.
+			/// </summary>
+			property int AvailableBlocks
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the number of bytes copied out of the capture source.
+			/// </summary>
+			property System::Int64 CapturedBytes
+			{
+				System::Int64 get();
+			}
+
+			/// <summary>
+			/// Gets the number of captured bytes dropped because the ring was full.
+			/// </summary>
+			property System::Int64 DroppedBytes
+			{
+				System::Int64 get();
+			}
+
+			/// <summary>
+			/// Gets the number of times captured audio was dropped because the ring was full.
+			/// </summary>
+			property int OverrunCount
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the number of times the reader thread fell a whole capture buffer behind the device.
+			/// </summary>
+			property int CaptureOverrunCount
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the number of blocks read by the consumer.
+			/// </summary>
+			property System::Int64 BlocksDelivered
+			{
+				System::Int64 get();
+			}
+
+			/// <summary>
+			/// Gets the latency of the last block read.
+			/// </summary>
+			property System::TimeSpan LastLatency
+			{
+				System::TimeSpan get();
+			}
+
+			/// <summary>
+			/// Gets the average latency of the blocks read.
+			/// </summary>
+			property System::TimeSpan AverageLatency
+			{
+				System::TimeSpan get();
+			}
+
+			/// <summary>
+			/// Gets the largest latency of the blocks read.
+			/// </summary>
+			property System::TimeSpan MaximumLatency
+			{
+				System::TimeSpan get();
+			}
+		};
+	}
+}
@@ -23,7 +23,7 @@
 
 #include "../SlimDXException.h"
 
-#define RECORD_DSOUND(x) Result::Record<DirectSoundException^>( (x), (nullptr), (nullptr) )
+#define RECORD_DSOUND(x) Result::Record<DirectSoundException^>( SLIMDX_INSTRUMENT_RESULT(x), (nullptr), (nullptr) )
 
 namespace SlimDX
 {
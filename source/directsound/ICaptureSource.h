@@ -0,0 +1,83 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "NotificationPosition.h"
+
+namespace SlimDX
+{
+	namespace Multimedia
+	{
+		ref class WaveFormat;
+	}
+
+	namespace DirectSound
+	{
+		/// <summary>
+		/// The capture operations used by <see cref="CaptureRingReader"/>. It is implemented by <see cref="CaptureBuffer"/>, and can
+		/// be implemented by a stand-in source that feeds audio without a capture device.
+		/// </summary>
+		/// <unmanaged>None</unmanaged>
+		public interface struct ICaptureSource
+		{
+			/// <summary>
+			/// Gets the waveform format of the captured data.
+			/// </summary>
+			property SlimDX::Multimedia::WaveFormat^ Format
+			{
+				SlimDX::Multimedia::WaveFormat^ get();
+			}
+
+			/// <summary>
+			/// Gets the size, in bytes, of the circular capture buffer.
+			/// </summary>
+			property int SizeInBytes
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the position of the read cursor. The data before it has been completely captured.
+			/// </summary>
+			property int CurrentReadPosition
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Sets the positions at which events are signaled as the capture cursor passes them.
+			/// </summary>
+			/// <param name="positions">The notification positions.</param>
+			/// <returns>A <see cref="SlimDX::Result"/> object describing the result of the operation.</returns>
+			virtual Result SetNotificationPositions( array<NotificationPosition>^ positions ) = 0;
+
+			/// <summary>
+			/// Copies captured data to unmanaged memory, wrapping around the end of the capture buffer.
+			/// </summary>
+			/// <param name="bufferOffset">The offset, in bytes, in the capture buffer to start copying from.</param>
+			/// <param name="destination">The memory to copy to.</param>
+			/// <param name="count">The number of bytes to copy, at most the size of the buffer.</param>
+			/// <returns>A <see cref="SlimDX::Result"/> object describing the result of the operation.</returns>
+			virtual Result Read( int bufferOffset, System::IntPtr destination, int count ) = 0;
+		};
+	}
+}
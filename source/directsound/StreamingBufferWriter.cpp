@@ -0,0 +1,279 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <windows.h>
+#include <dsound.h>
+
+#include "../DataStream.h"
+#include "../Utilities.h"
+#include "../multimedia/WaveFormat.h"
+
+#include "DirectSoundException.h"
+
+#include "SecondarySoundBuffer.h"
+#include "StreamingBufferWriter.h"
+
+using namespace System;
+using namespace SlimDX::Multimedia;
+
+namespace SlimDX
+{
+namespace DirectSound
+{
+	static int GreatestCommonDivisor( int a, int b )
+	{
+		while( b != 0 )
+		{
+			int t = a % b;
+			a = b;
+			b = t;
+		}
+		return a;
+	}
+
+	StreamingBufferWriter::StreamingBufferWriter( SecondarySoundBuffer^ buffer, int targetLatencyMilliseconds )
+	{
+		if( buffer == nullptr )
+			throw gcnew ArgumentNullException( "buffer" );
+		if( targetLatencyMilliseconds <= 0 )
+			throw gcnew ArgumentOutOfRangeException( "targetLatencyMilliseconds" );
+
+		WaveFormat^ format = buffer->Format;
+		if( format == nullptr || format->BlockAlignment <= 0 )
+			throw gcnew ArgumentException( "The format of the buffer could not be determined.", "buffer" );
+
+		m_Buffer = buffer;
+		m_BufferSize = buffer->Capabilities.BufferSize;
+		m_BlockAlignment = format->BlockAlignment;
+
+		// 8-bit PCM is unsigned, so its silence is the midpoint rather than zero
+		m_Silence = format->BitsPerSample == 8 ? 0x80 : 0;
+
+		Int64 bytes = static_cast<Int64>( targetLatencyMilliseconds ) * format->AverageBytesPerSecond / 1000;
+		bytes -= bytes % m_BlockAlignment;
+		if( bytes <= 0 || bytes > m_BufferSize - m_BlockAlignment )
+			throw gcnew ArgumentOutOfRangeException( "targetLatencyMilliseconds", "The target latency must be at least one frame and shorter than the buffer." );
+
+		m_TargetLatency = static_cast<int>( bytes );
+	}
+
+	int StreamingBufferWriter::UpdateCursor()
+	{
+		DWORD play;
+		DWORD write;
+
+		HRESULT hr = m_Buffer->InternalPointer->GetCurrentPosition( &play, &write );
+		if( RECORD_DSOUND( hr ).IsFailure )
+			return -1;
+
+		int reserved = ( static_cast<int>( write ) - static_cast<int>( play ) + m_BufferSize ) % m_BufferSize;
+		if( !m_Started )
+		{
+			m_Cursor = write;
+			m_Ahead = reserved;
+			m_Started = true;
+		}
+
+		// the play cursor only ever moves towards our cursor, so the distance between them can only shrink;
+		// if it grew, or fell inside the region the device has already committed, the device played past us
+		int queued = ( m_Cursor - static_cast<int>( play ) + m_BufferSize ) % m_BufferSize;
+		if( queued < reserved || queued > m_Ahead )
+		{
+			m_UnderrunCount++;
+			m_Cursor = write;
+			queued = reserved;
+		}
+
+		m_Ahead = queued;
+		return queued;
+	}
+
+	void StreamingBufferWriter::Advance( int count )
+	{
+		m_Cursor = ( m_Cursor + count ) % m_BufferSize;
+		m_Ahead += count;
+		m_TotalBytesWritten += count;
+	}
+
+	int StreamingBufferWriter::WriteBytes( const char *source, int count )
+	{
+		void *first;
+		void *second;
+		DWORD firstSize;
+		DWORD secondSize;
+
+		HRESULT hr = m_Buffer->InternalPointer->Lock( m_Cursor, count, &first, &firstSize, &second, &secondSize, 0 );
+		if( RECORD_DSOUND( hr ).IsFailure )
+			return 0;
+
+		if( source != NULL )
+		{
+			memcpy( first, source, firstSize );
+			if( second != NULL )
+				memcpy( second, source + firstSize, secondSize );
+		}
+		else
+		{
+			memset( first, m_Silence, firstSize );
+			if( second != NULL )
+				memset( second, m_Silence, secondSize );
+		}
+
+		hr = m_Buffer->InternalPointer->Unlock( first, firstSize, second, secondSize );
+		if( RECORD_DSOUND( hr ).IsFailure )
+			return 0;
+
+		Advance( count );
+		return count;
+	}
+
+	DataStream^ StreamingBufferWriter::Retarget( DataStream^ stream, void *region, int size )
+	{
+		if( stream == nullptr )
+			return gcnew DataStream( region, size, true, true, false );
+
+		stream->Retarget( region, size );
+		return stream;
+	}
+
+	generic<typename T>
+	int StreamingBufferWriter::Write( array<T>^ data, int startIndex, int count )
+	{
+		Utilities::CheckArrayBounds( data, startIndex, count );
+
+		int elementSize = static_cast<int>( sizeof(T) );
+
+		// only whole frames made of whole elements are written, so round down to a multiple of both
+		Int64 unit = static_cast<Int64>( m_BlockAlignment / GreatestCommonDivisor( m_BlockAlignment, elementSize ) ) * elementSize;
+
+		Int64 bytes = Math::Min( static_cast<Int64>( count ) * elementSize, static_cast<Int64>( WritableBytes ) );
+		bytes -= bytes % unit;
+		if( bytes <= 0 )
+			return 0;
+
+		pin_ptr<T> pinnedData = &data[startIndex];
+		return WriteBytes( reinterpret_cast<const char*>( pinnedData ), static_cast<int>( bytes ) ) / elementSize;
+	}
+
+	int StreamingBufferWriter::Write( IntPtr source, int sizeInBytes )
+	{
+		if( source == IntPtr::Zero )
+			throw gcnew ArgumentNullException( "source" );
+		if( sizeInBytes < 0 )
+			throw gcnew ArgumentOutOfRangeException( "sizeInBytes" );
+
+		int bytes = Math::Min( sizeInBytes, WritableBytes );
+		bytes -= bytes % m_BlockAlignment;
+		if( bytes == 0 )
+			return 0;
+
+		return WriteBytes( reinterpret_cast<const char*>( source.ToPointer() ), bytes );
+	}
+
+	int StreamingBufferWriter::Fill( BufferFillCallback^ callback )
+	{
+		if( callback == nullptr )
+			throw gcnew ArgumentNullException( "callback" );
+
+		int writable = WritableBytes;
+		if( writable == 0 )
+			return 0;
+
+		void *first;
+		void *second;
+		DWORD firstSize;
+		DWORD secondSize;
+
+		HRESULT hr = m_Buffer->InternalPointer->Lock( m_Cursor, writable, &first, &firstSize, &second, &secondSize, 0 );
+		if( RECORD_DSOUND( hr ).IsFailure )
+			return 0;
+
+		int written = 0;
+		try
+		{
+			m_FirstRegion = Retarget( m_FirstRegion, first, firstSize );
+			written = Math::Max( 0, Math::Min( callback( m_FirstRegion ), static_cast<int>( firstSize ) ) );
+
+			if( second != NULL && written == static_cast<int>( firstSize ) )
+			{
+				m_SecondRegion = Retarget( m_SecondRegion, second, secondSize );
+				written += Math::Max( 0, Math::Min( callback( m_SecondRegion ), static_cast<int>( secondSize ) ) );
+			}
+		}
+		catch( ... )
+		{
+			m_Buffer->InternalPointer->Unlock( first, 0, second, 0 );
+			throw;
+		}
+
+		// a partial frame is left where it is and overwritten by the next write
+		written -= written % m_BlockAlignment;
+
+		DWORD firstWritten = Math::Min( written, static_cast<int>( firstSize ) );
+		hr = m_Buffer->InternalPointer->Unlock( first, firstWritten, second, written - firstWritten );
+		if( RECORD_DSOUND( hr ).IsFailure )
+			return 0;
+
+		Advance( written );
+		return written;
+	}
+
+	int StreamingBufferWriter::WriteSilence()
+	{
+		int bytes = WritableBytes;
+		if( bytes == 0 )
+			return 0;
+
+		return WriteBytes( NULL, bytes );
+	}
+
+	void StreamingBufferWriter::Reset()
+	{
+		m_Started = false;
+	}
+
+	void StreamingBufferWriter::TargetLatency::set( int value )
+	{
+		value -= value % m_BlockAlignment;
+		if( value <= 0 || value > m_BufferSize - m_BlockAlignment )
+			throw gcnew ArgumentOutOfRangeException( "value", "The target latency must be at least one frame and shorter than the buffer." );
+
+		m_TargetLatency = value;
+	}
+
+	int StreamingBufferWriter::QueuedBytes::get()
+	{
+		return Math::Max( 0, UpdateCursor() );
+	}
+
+	int StreamingBufferWriter::WritableBytes::get()
+	{
+		int queued = UpdateCursor();
+		if( queued < 0 )
+			return 0;
+
+		int writable = Math::Max( 0, m_TargetLatency - queued );
+		return writable - writable % m_BlockAlignment;
+	}
+}
+}
@@ -0,0 +1,178 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	ref class DataStream;
+
+	namespace DirectSound
+	{
+		ref class SecondarySoundBuffer;
+
+		/// <summary>
+		/// Produces audio directly into a locked region of a sound buffer.
+		/// </summary>
+		/// <param name="destination">A stream over the locked region, positioned at its start.</param>
+		/// <returns>The number of bytes written to the region. Returning fewer bytes than the length of the region ends the fill.</returns>
+		public delegate int BufferFillCallback( DataStream^ destination );
+
+		/// <summary>
+		/// Streams audio into a looping <see cref="SecondarySoundBuffer"/>, keeping track of the write cursor and topping the buffer up
+		/// to a target latency ahead of the play cursor.
+		/// </summary>
+		/// <remarks>
+		/// <para>Every write locks at most the room between the writer's cursor and the target latency and copies straight into both
+		/// parts of the lock, so no arrays or streams are allocated once the writer exists. The first write starts at the write cursor
+		/// of the buffer, which allows the buffer to be primed before it is played.</para>
+		/// <para>If the play cursor overtakes the writer, because it was not called often enough, the writer counts an underrun and
+		/// starts again from the write cursor of the buffer. The target latency should therefore be comfortably larger than the
+		/// distance the device keeps between its play and write cursors.</para>
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class StreamingBufferWriter
+		{
+		private:
+			SecondarySoundBuffer^ m_Buffer;
+			int m_BufferSize;
+			int m_BlockAlignment;
+			int m_TargetLatency;
+			unsigned char m_Silence;
+
+			int m_Cursor;
+			int m_Ahead;
+			bool m_Started;
+			System::Int64 m_TotalBytesWritten;
+			int m_UnderrunCount;
+
+			DataStream^ m_FirstRegion;
+			DataStream^ m_SecondRegion;
+
+			int UpdateCursor();
+			int WriteBytes( const char *source, int count );
+			void Advance( int count );
+			DataStream^ Retarget( DataStream^ stream, void *region, int size );
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="StreamingBufferWriter"/> class.
+			/// </summary>
+			/// <param name="buffer">The buffer to stream into. It should be played with <see cref="PlayFlags::Looping"/>.</param>
+			/// <param name="targetLatencyMilliseconds">How far ahead of the play cursor to keep the buffer filled, in milliseconds.</param>
+			StreamingBufferWriter( SecondarySoundBuffer^ buffer, int targetLatencyMilliseconds );
+
+			/// <summary>
+			/// Writes as much of an array as fits below the target latency.
+			/// </summary>
+			/// <typeparam name="T">The type of the samples.</typeparam>
+			/// <param name="data">The samples to write.</param>
+			/// <param name="startIndex">The index of the first element to write.</param>
+			/// <param name="count">The number of elements to write, or 0 for the rest of the array.</param>
+			/// <returns>The number of elements written, which always make up whole frames.</returns>
+			generic<typename T> where T : value class
+			int Write( array<T>^ data, int startIndex, int count );
+
+			/// <summary>
+			/// Writes as much of a block of memory as fits below the target latency.
+			/// </summary>
+			/// <param name="source">The audio to write.</param>
+			/// <param name="sizeInBytes">The size of the audio, in bytes.</param>
+			/// <returns>The number of bytes written, which always make up whole frames.</returns>
+			int Write( System::IntPtr source, int sizeInBytes );
+
+			/// <summary>
+			/// Tops the buffer up to the target latency by letting a callback write into the locked regions.
+			/// </summary>
+			/// <param name="callback">The callback that produces the audio. It is called once for each part of the lock.</param>
+			/// <returns>The number of bytes written, rounded down to whole frames.</returns>
+			int Fill( BufferFillCallback^ callback );
+
+			/// <summary>
+			/// Tops the buffer up to the target latency with silence.
+			/// </summary>
+			/// <returns>The number of bytes written.</returns>
+			int WriteSilence();
+
+			/// <summary>
+			/// Forgets the writer's cursor, so the next write starts again at the write cursor of the buffer.
+			/// </summary>
+			void Reset();
+
+			/// <summary>
+			/// Gets the buffer the writer streams into.
+			/// </summary>
+			property SecondarySoundBuffer^ Buffer
+			{
+				SecondarySoundBuffer^ get() { return m_Buffer; }
+			}
+
+			/// <summary>
+			/// Gets or sets how far ahead of the play cursor to keep the buffer filled, in bytes.
+			/// </summary>
+			property int TargetLatency
+			{
+				int get() { return m_TargetLatency; }
+				void set( int value );
+			}
+
+			/// <summary>
+			/// Gets the offset in the buffer at which the next write will start.
+			/// </summary>
+			property int WritePosition
+			{
+				int get() { return m_Cursor; }
+			}
+
+			/// <summary>
+			/// Gets the number of bytes written ahead of the play cursor that have not been played yet.
+			/// </summary>
+			property int QueuedBytes
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the number of bytes that can be written now without going past the target latency.
+			/// </summary>
+			property int WritableBytes
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the total number of bytes written.
+			/// </summary>
+			property System::Int64 TotalBytesWritten
+			{
+				System::Int64 get() { return m_TotalBytesWritten; }
+			}
+
+			/// <summary>
+			/// Gets the number of times the play cursor overtook the writer.
+			/// </summary>
+			property int UnderrunCount
+			{
+				int get() { return m_UnderrunCount; }
+			}
+		};
+	}
+}
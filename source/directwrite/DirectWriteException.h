@@ -21,7 +21,7 @@
 */
 #pragma once
 
-#define RECORD_DW(x) Result::Record<DirectWriteException^>( (x), (nullptr), (nullptr) )
+#define RECORD_DW(x) Result::Record<DirectWriteException^>( SLIMDX_INSTRUMENT_RESULT(x), (nullptr), (nullptr) )
 
 #include "../SlimDXException.h"
 
@@ -0,0 +1,387 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "../DataStream.h"
+#include "../ParallelLoop.h"
+
+#include "AdpcmKernels.h"
+#include "AdpcmCodec.h"
+
+using namespace System;
+using namespace System::IO;
+
+namespace SlimDX
+{
+namespace Multimedia
+{
+	// blocks are small, so hand them out in batches to keep the scheduling cost down
+	const int BlocksPerRange = 64;
+
+	static const Adpcm::Coefficient *CopyCoefficients( WaveFormat^ format, unsigned int &count )
+	{
+		AdpcmWaveFormat^ adpcm = dynamic_cast<AdpcmWaveFormat^>( format );
+		if( format->FormatTag != WaveFormatTag::AdPcm || adpcm == nullptr || adpcm->Coefficients == nullptr || adpcm->Coefficients->Length == 0 )
+		{
+			count = Adpcm::StandardCoefficientCount;
+			return Adpcm::StandardCoefficients;
+		}
+
+		// a block names its predictor with a single byte, so later entries can never be used
+		count = Math::Min( adpcm->Coefficients->Length, 256 );
+
+		// Manual Allocation: this is fine
+		Adpcm::Coefficient *result = new Adpcm::Coefficient[count];
+
+		// each entry packs the first coefficient in its low half and the second in its high half, as stored in the file
+		for( unsigned int i = 0; i < count; i++ )
+		{
+			result[i].Coef1 = static_cast<short>( adpcm->Coefficients[i] & 0xffff );
+			result[i].Coef2 = static_cast<short>( adpcm->Coefficients[i] >> 16 );
+		}
+
+		return result;
+	}
+
+	ref class AdpcmBlockJob sealed
+	{
+	public:
+		bool Ms;
+		bool Float;
+		unsigned char *Encoded;
+		System::Int64 EncodedLength;
+		short *Samples;
+		System::Int64 FrameCount;
+		unsigned int Channels;
+		unsigned int BlockAlignment;
+		unsigned int SamplesPerBlock;
+		const Adpcm::Coefficient *Coefficients;
+		unsigned int CoefficientCount;
+
+		void Decode( int begin, int end )
+		{
+			for( int block = begin; block < end; block++ )
+			{
+				Int64 offset = static_cast<Int64>( block ) * BlockAlignment;
+				unsigned int size = static_cast<unsigned int>( Math::Min( static_cast<Int64>( BlockAlignment ), EncodedLength - offset ) );
+				unsigned int frames = Math::Min( SamplesPerBlock, Ms ? Adpcm::MsSamplesPerBlock( size, Channels ) : Adpcm::ImaSamplesPerBlock( size, Channels ) );
+				Int64 sample = static_cast<Int64>( block ) * SamplesPerBlock * Channels;
+
+				bool valid = true;
+				if( Ms && Float )
+					valid = Adpcm::DecodeMsBlock( Encoded + offset, Channels, frames, Coefficients, CoefficientCount, reinterpret_cast<float*>( Samples ) + sample );
+				else if( Ms )
+					valid = Adpcm::DecodeMsBlock( Encoded + offset, Channels, frames, Coefficients, CoefficientCount, Samples + sample );
+				else if( Float )
+					Adpcm::DecodeImaBlock( Encoded + offset, Channels, frames, reinterpret_cast<float*>( Samples ) + sample );
+				else
+					Adpcm::DecodeImaBlock( Encoded + offset, Channels, frames, Samples + sample );
+
+				if( !valid )
+					throw gcnew InvalidDataException( "The ADPCM data refers to a predictor that is not in the coefficient table." );
+			}
+		}
+
+		void Encode( int begin, int end )
+		{
+			for( int block = begin; block < end; block++ )
+			{
+				Int64 frame = static_cast<Int64>( block ) * SamplesPerBlock;
+				unsigned int frames = static_cast<unsigned int>( Math::Min( static_cast<Int64>( SamplesPerBlock ), FrameCount - frame ) );
+				unsigned char *destination = Encoded + static_cast<Int64>( block ) * BlockAlignment;
+
+				if( Ms )
+					Adpcm::EncodeMsBlock( Samples + frame * Channels, frames, Channels, SamplesPerBlock, Coefficients, CoefficientCount, destination, BlockAlignment );
+				else
+					Adpcm::EncodeImaBlock( Samples + frame * Channels, frames, Channels, SamplesPerBlock, destination, BlockAlignment );
+			}
+		}
+	};
+
+	int AdpcmCodec::CheckFormat( WaveFormat^ format )
+	{
+		if( format == nullptr )
+			throw gcnew ArgumentNullException( "format" );
+		if( format->Channels < 1 || format->Channels > static_cast<int>( Adpcm::MaxChannels ) )
+			throw gcnew ArgumentException( "The format has an unsupported number of channels.", "format" );
+
+		unsigned int blockAlignment = static_cast<unsigned short>( format->BlockAlignment );
+		if( format->FormatTag == WaveFormatTag::ImaAdpcm )
+		{
+			// the block must also split evenly into four byte groups per channel
+			int samples = Adpcm::ImaSamplesPerBlock( blockAlignment, format->Channels );
+			if( samples < 2 || blockAlignment % (4 * format->Channels) != 0 )
+				throw gcnew ArgumentException( "The format has an invalid block alignment.", "format" );
+
+			return samples;
+		}
+
+		if( format->FormatTag != WaveFormatTag::AdPcm )
+			throw gcnew ArgumentException( "The format is not MS-ADPCM or IMA-ADPCM.", "format" );
+
+		int samples = Adpcm::MsSamplesPerBlock( blockAlignment, format->Channels );
+		if( samples < 2 )
+			throw gcnew ArgumentException( "The format has an invalid block alignment.", "format" );
+
+		AdpcmWaveFormat^ adpcm = dynamic_cast<AdpcmWaveFormat^>( format );
+		if( adpcm != nullptr && adpcm->SamplesPerBlock > 0 )
+		{
+			if( adpcm->SamplesPerBlock > samples )
+				throw gcnew ArgumentException( "The format has more samples per block than its block alignment can hold.", "format" );
+
+			samples = adpcm->SamplesPerBlock;
+		}
+
+		return samples;
+	}
+
+	int AdpcmCodec::CheckSampleFormat( WaveFormatTag sampleFormat )
+	{
+		if( sampleFormat == WaveFormatTag::Pcm )
+			return sizeof( short );
+		if( sampleFormat == WaveFormatTag::IeeeFloat )
+			return sizeof( float );
+
+		throw gcnew ArgumentOutOfRangeException( "sampleFormat" );
+	}
+
+	int AdpcmCodec::GetSamplesPerBlock( WaveFormat^ format )
+	{
+		return CheckFormat( format );
+	}
+
+	WaveFormat^ AdpcmCodec::GetDecodedFormat( WaveFormat^ format, WaveFormatTag sampleFormat )
+	{
+		CheckFormat( format );
+		int sampleSize = CheckSampleFormat( sampleFormat );
+
+		WaveFormat^ result = gcnew WaveFormat();
+		result->FormatTag = sampleFormat;
+		result->Channels = format->Channels;
+		result->SamplesPerSecond = format->SamplesPerSecond;
+		result->BitsPerSample = static_cast<short>( sampleSize * 8 );
+		result->BlockAlignment = static_cast<short>( sampleSize * format->Channels );
+		result->AverageBytesPerSecond = format->SamplesPerSecond * result->BlockAlignment;
+
+		return result;
+	}
+
+	Int64 AdpcmCodec::GetDecodedSize( WaveFormat^ format, Int64 encodedSize, WaveFormatTag sampleFormat )
+	{
+		int samplesPerBlock = CheckFormat( format );
+		int sampleSize = CheckSampleFormat( sampleFormat );
+		if( encodedSize < 0 )
+			throw gcnew ArgumentOutOfRangeException( "encodedSize" );
+
+		unsigned int blockAlignment = static_cast<unsigned short>( format->BlockAlignment );
+		unsigned int tail = static_cast<unsigned int>( encodedSize % blockAlignment );
+		unsigned int tailFrames = format->FormatTag == WaveFormatTag::AdPcm ? Adpcm::MsSamplesPerBlock( tail, format->Channels ) : Adpcm::ImaSamplesPerBlock( tail, format->Channels );
+
+		Int64 frames = encodedSize / blockAlignment * samplesPerBlock + Math::Min( tailFrames, static_cast<unsigned int>( samplesPerBlock ) );
+		return frames * format->Channels * sampleSize;
+	}
+
+	Int64 AdpcmCodec::GetEncodedSize( WaveFormat^ format, Int64 frameCount )
+	{
+		int samplesPerBlock = CheckFormat( format );
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+
+		Int64 blocks = frameCount / samplesPerBlock + (frameCount % samplesPerBlock != 0 ? 1 : 0);
+		return blocks * static_cast<unsigned short>( format->BlockAlignment );
+	}
+
+	Int64 AdpcmCodec::Decode( WaveFormat^ format, DataStream^ source, DataStream^ destination, WaveFormatTag sampleFormat )
+	{
+		if( source == nullptr )
+			throw gcnew ArgumentNullException( "source" );
+		if( destination == nullptr )
+			throw gcnew ArgumentNullException( "destination" );
+		if( !source->CanRead )
+			throw gcnew NotSupportedException( "The source stream must be readable." );
+		if( !destination->CanWrite )
+			throw gcnew NotSupportedException( "The destination stream must be writable." );
+
+		int samplesPerBlock = CheckFormat( format );
+		Int64 encodedLength = source->Length - source->Position;
+		Int64 size = GetDecodedSize( format, encodedLength, sampleFormat );
+		if( size > destination->Length - destination->Position )
+			throw gcnew ArgumentException( "The destination stream is too small for the decoded data.", "destination" );
+
+		// a final partial block counts if it holds any samples at all
+		unsigned int blockAlignment = static_cast<unsigned short>( format->BlockAlignment );
+		Int64 blocks = encodedLength / blockAlignment;
+		if( size > blocks * samplesPerBlock * format->Channels * CheckSampleFormat( sampleFormat ) )
+			blocks++;
+		if( blocks > Int32::MaxValue )
+			throw gcnew ArgumentException( "The source stream holds too many blocks.", "source" );
+
+		AdpcmBlockJob^ job = gcnew AdpcmBlockJob();
+		job->Ms = format->FormatTag == WaveFormatTag::AdPcm;
+		job->Float = sampleFormat == WaveFormatTag::IeeeFloat;
+		job->Encoded = reinterpret_cast<unsigned char*>( source->PositionPointer );
+		job->EncodedLength = encodedLength;
+		job->Samples = reinterpret_cast<short*>( destination->PositionPointer );
+		job->Channels = format->Channels;
+		job->BlockAlignment = blockAlignment;
+		job->SamplesPerBlock = samplesPerBlock;
+
+		unsigned int coefficientCount;
+		job->Coefficients = CopyCoefficients( format, coefficientCount );
+		job->CoefficientCount = coefficientCount;
+
+		try
+		{
+			ParallelLoop::For( static_cast<int>( blocks ), BlocksPerRange, gcnew ParallelRange( job, &AdpcmBlockJob::Decode ) );
+		}
+		finally
+		{
+			if( job->Coefficients != Adpcm::StandardCoefficients )
+				delete[] job->Coefficients;
+		}
+
+		source->Position = source->Length;
+		destination->Position += size;
+		return size;
+	}
+
+	DataStream^ AdpcmCodec::Decode( WaveFormat^ format, DataStream^ source, WaveFormatTag sampleFormat )
+	{
+		if( source == nullptr )
+			throw gcnew ArgumentNullException( "source" );
+
+		DataStream^ result = gcnew DataStream( GetDecodedSize( format, source->Length - source->Position, sampleFormat ), true, true );
+		Decode( format, source, result, sampleFormat );
+
+		result->Position = 0;
+		return result;
+	}
+
+	Int64 AdpcmCodec::Encode( WaveFormat^ format, DataStream^ source, DataStream^ destination )
+	{
+		if( source == nullptr )
+			throw gcnew ArgumentNullException( "source" );
+		if( destination == nullptr )
+			throw gcnew ArgumentNullException( "destination" );
+		if( !source->CanRead )
+			throw gcnew NotSupportedException( "The source stream must be readable." );
+		if( !destination->CanWrite )
+			throw gcnew NotSupportedException( "The destination stream must be writable." );
+
+		int samplesPerBlock = CheckFormat( format );
+		Int64 frames = (source->Length - source->Position) / (format->Channels * sizeof( short ));
+		Int64 size = GetEncodedSize( format, frames );
+		if( size > destination->Length - destination->Position )
+			throw gcnew ArgumentException( "The destination stream is too small for the encoded data.", "destination" );
+
+		Int64 blocks = size / static_cast<unsigned short>( format->BlockAlignment );
+		if( blocks > Int32::MaxValue )
+			throw gcnew ArgumentException( "The source stream holds too many samples.", "source" );
+
+		AdpcmBlockJob^ job = gcnew AdpcmBlockJob();
+		job->Ms = format->FormatTag == WaveFormatTag::AdPcm;
+		job->Encoded = reinterpret_cast<unsigned char*>( destination->PositionPointer );
+		job->Samples = reinterpret_cast<short*>( source->PositionPointer );
+		job->FrameCount = frames;
+		job->Channels = format->Channels;
+		job->BlockAlignment = static_cast<unsigned short>( format->BlockAlignment );
+		job->SamplesPerBlock = samplesPerBlock;
+
+		unsigned int coefficientCount;
+		job->Coefficients = CopyCoefficients( format, coefficientCount );
+		job->CoefficientCount = coefficientCount;
+
+		try
+		{
+			ParallelLoop::For( static_cast<int>( blocks ), BlocksPerRange, gcnew ParallelRange( job, &AdpcmBlockJob::Encode ) );
+		}
+		finally
+		{
+			if( job->Coefficients != Adpcm::StandardCoefficients )
+				delete[] job->Coefficients;
+		}
+
+		source->Position += frames * format->Channels * sizeof( short );
+		destination->Position += size;
+		return size;
+	}
+
+	DataStream^ AdpcmCodec::Encode( WaveFormat^ format, DataStream^ source )
+	{
+		if( source == nullptr )
+			throw gcnew ArgumentNullException( "source" );
+
+		CheckFormat( format );
+
+		DataStream^ result = gcnew DataStream( GetEncodedSize( format, (source->Length - source->Position) / (format->Channels * sizeof( short )) ), true, true );
+		Encode( format, source, result );
+
+		result->Position = 0;
+		return result;
+	}
+
+	AdpcmWaveFormat^ AdpcmCodec::CreateFormat( int samplesPerSecond, int channels, int blockAlignment )
+	{
+		if( samplesPerSecond < 1 )
+			throw gcnew ArgumentOutOfRangeException( "samplesPerSecond" );
+		if( channels < 1 || channels > static_cast<int>( Adpcm::MaxChannels ) )
+			throw gcnew ArgumentOutOfRangeException( "channels" );
+		if( blockAlignment > UInt16::MaxValue || Adpcm::MsSamplesPerBlock( blockAlignment, channels ) < 2 )
+			throw gcnew ArgumentOutOfRangeException( "blockAlignment" );
+
+		AdpcmWaveFormat^ result = gcnew AdpcmWaveFormat();
+		result->FormatTag = WaveFormatTag::AdPcm;
+		result->Channels = static_cast<short>( channels );
+		result->SamplesPerSecond = samplesPerSecond;
+		result->BlockAlignment = static_cast<short>( blockAlignment );
+		result->BitsPerSample = 4;
+		result->SamplesPerBlock = static_cast<short>( Adpcm::MsSamplesPerBlock( blockAlignment, channels ) );
+		result->AverageBytesPerSecond = static_cast<int>( static_cast<Int64>( samplesPerSecond ) * blockAlignment / result->SamplesPerBlock );
+
+		result->Coefficients = gcnew array<int>( Adpcm::StandardCoefficientCount );
+		for( unsigned int i = 0; i < Adpcm::StandardCoefficientCount; i++ )
+			result->Coefficients[i] = (Adpcm::StandardCoefficients[i].Coef2 << 16) | (Adpcm::StandardCoefficients[i].Coef1 & 0xffff);
+
+		return result;
+	}
+
+	WaveFormat^ AdpcmCodec::CreateImaFormat( int samplesPerSecond, int channels, int blockAlignment )
+	{
+		if( samplesPerSecond < 1 )
+			throw gcnew ArgumentOutOfRangeException( "samplesPerSecond" );
+		if( channels < 1 || channels > static_cast<int>( Adpcm::MaxChannels ) )
+			throw gcnew ArgumentOutOfRangeException( "channels" );
+		if( blockAlignment > UInt16::MaxValue || blockAlignment % (4 * channels) != 0 || Adpcm::ImaSamplesPerBlock( blockAlignment, channels ) < 2 )
+			throw gcnew ArgumentOutOfRangeException( "blockAlignment" );
+
+		WaveFormat^ result = gcnew WaveFormat();
+		result->FormatTag = WaveFormatTag::ImaAdpcm;
+		result->Channels = static_cast<short>( channels );
+		result->SamplesPerSecond = samplesPerSecond;
+		result->BlockAlignment = static_cast<short>( blockAlignment );
+		result->BitsPerSample = 4;
+		result->AverageBytesPerSecond = static_cast<int>( static_cast<Int64>( samplesPerSecond ) * blockAlignment / Adpcm::ImaSamplesPerBlock( blockAlignment, channels ) );
+
+		return result;
+	}
+}
+}
@@ -0,0 +1,141 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "WaveFormat.h"
+#include "AdpcmWaveFormat.h"
+
+namespace SlimDX
+{
+	ref class DataStream;
+
+	namespace Multimedia
+	{
+		/// <summary>
+		/// Decodes and encodes MS-ADPCM and IMA-ADPCM audio in software.
+		/// </summary>
+		/// <remarks>
+		/// Each ADPCM block starts from its own predictor state, so blocks are processed independently, spread across
+		/// the thread pool. MS-ADPCM uses the coefficient table carried by an <see cref="AdpcmWaveFormat"/>, or the standard
+		/// table if the format has none. IMA-ADPCM formats are described by a plain <see cref="WaveFormat"/> whose block
+		/// alignment determines the number of samples per block.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class AdpcmCodec sealed
+		{
+		private:
+			AdpcmCodec() { }
+
+			static int CheckFormat( WaveFormat^ format );
+			static int CheckSampleFormat( WaveFormatTag sampleFormat );
+
+		public:
+			/// <summary>
+			/// Gets the number of frames held by each block of an ADPCM format.
+			/// </summary>
+			/// <param name="format">An MS-ADPCM or IMA-ADPCM format.</param>
+			/// <returns>The number of frames per block.</returns>
+			static int GetSamplesPerBlock( WaveFormat^ format );
+
+			/// <summary>
+			/// Gets the format of the audio produced by decoding.
+			/// </summary>
+			/// <param name="format">An MS-ADPCM or IMA-ADPCM format.</param>
+			/// <param name="sampleFormat">Either <see cref="WaveFormatTag::Pcm"/> for 16-bit samples or <see cref="WaveFormatTag::IeeeFloat"/> for 32-bit float samples.</param>
+			/// <returns>The decoded format.</returns>
+			static WaveFormat^ GetDecodedFormat( WaveFormat^ format, WaveFormatTag sampleFormat );
+
+			/// <summary>
+			/// Gets the number of bytes produced by decoding.
+			/// </summary>
+			/// <param name="format">An MS-ADPCM or IMA-ADPCM format.</param>
+			/// <param name="encodedSize">The size of the encoded data, in bytes. A final partial block is decoded as far as it goes.</param>
+			/// <param name="sampleFormat">Either <see cref="WaveFormatTag::Pcm"/> or <see cref="WaveFormatTag::IeeeFloat"/>.</param>
+			/// <returns>The size of the decoded data, in bytes.</returns>
+			static System::Int64 GetDecodedSize( WaveFormat^ format, System::Int64 encodedSize, WaveFormatTag sampleFormat );
+
+			/// <summary>
+			/// Gets the number of bytes produced by encoding.
+			/// </summary>
+			/// <param name="format">An MS-ADPCM or IMA-ADPCM format.</param>
+			/// <param name="frameCount">The number of frames to encode.</param>
+			/// <returns>The size of the encoded data, in bytes, which is always a whole number of blocks.</returns>
+			static System::Int64 GetEncodedSize( WaveFormat^ format, System::Int64 frameCount );
+
+			/// <summary>
+			/// Decodes ADPCM data from the current position of one stream into another.
+			/// </summary>
+			/// <param name="format">The format of the encoded data.</param>
+			/// <param name="source">The encoded data, which is read from its current position to its end.</param>
+			/// <param name="destination">The stream that receives interleaved samples at its current position.</param>
+			/// <param name="sampleFormat">Either <see cref="WaveFormatTag::Pcm"/> for 16-bit samples or <see cref="WaveFormatTag::IeeeFloat"/> for 32-bit float samples.</param>
+			/// <returns>The number of bytes written. Both streams are advanced.</returns>
+			/// <exception cref="System::IO::InvalidDataException">A block refers to a predictor outside the coefficient table.</exception>
+			static System::Int64 Decode( WaveFormat^ format, DataStream^ source, DataStream^ destination, WaveFormatTag sampleFormat );
+
+			/// <summary>
+			/// Decodes ADPCM data from the current position of a stream into a new stream.
+			/// </summary>
+			/// <param name="format">The format of the encoded data.</param>
+			/// <param name="source">The encoded data, which is read from its current position to its end.</param>
+			/// <param name="sampleFormat">Either <see cref="WaveFormatTag::Pcm"/> for 16-bit samples or <see cref="WaveFormatTag::IeeeFloat"/> for 32-bit float samples.</param>
+			/// <returns>A stream holding the decoded samples.</returns>
+			/// <exception cref="System::IO::InvalidDataException">A block refers to a predictor outside the coefficient table.</exception>
+			static DataStream^ Decode( WaveFormat^ format, DataStream^ source, WaveFormatTag sampleFormat );
+
+			/// <summary>
+			/// Encodes interleaved 16-bit samples from the current position of one stream into another.
+			/// </summary>
+			/// <param name="format">The format to encode to.</param>
+			/// <param name="source">The samples to encode, read from the current position to the end. The final block is padded with silence.</param>
+			/// <param name="destination">The stream that receives the encoded blocks at its current position.</param>
+			/// <returns>The number of bytes written. Both streams are advanced.</returns>
+			static System::Int64 Encode( WaveFormat^ format, DataStream^ source, DataStream^ destination );
+
+			/// <summary>
+			/// Encodes interleaved 16-bit samples from the current position of a stream into a new stream.
+			/// </summary>
+			/// <param name="format">The format to encode to.</param>
+			/// <param name="source">The samples to encode, read from the current position to the end. The final block is padded with silence.</param>
+			/// <returns>A stream holding the encoded blocks.</returns>
+			static DataStream^ Encode( WaveFormat^ format, DataStream^ source );
+
+			/// <summary>
+			/// Creates an MS-ADPCM format that uses the standard coefficient table.
+			/// </summary>
+			/// <param name="samplesPerSecond">The sample rate.</param>
+			/// <param name="channels">The number of channels.</param>
+			/// <param name="blockAlignment">The size of each block, in bytes.</param>
+			/// <returns>The new format.</returns>
+			static AdpcmWaveFormat^ CreateFormat( int samplesPerSecond, int channels, int blockAlignment );
+
+			/// <summary>
+			/// Creates an IMA-ADPCM format.
+			/// </summary>
+			/// <param name="samplesPerSecond">The sample rate.</param>
+			/// <param name="channels">The number of channels.</param>
+			/// <param name="blockAlignment">The size of each block, in bytes.</param>
+			/// <returns>The new format.</returns>
+			static WaveFormat^ CreateImaFormat( int samplesPerSecond, int channels, int blockAlignment );
+		};
+	}
+}
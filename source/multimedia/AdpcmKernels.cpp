@@ -0,0 +1,446 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <string.h>
+
+#include "AdpcmKernels.h"
+
+#ifdef _MANAGED
+#pragma managed(push, off)
+#endif
+
+namespace SlimDX
+{
+namespace Multimedia
+{
+namespace Adpcm
+{
+	const Coefficient StandardCoefficients[StandardCoefficientCount] =
+	{
+		{ 256, 0 }, { 512, -256 }, { 0, 0 }, { 192, 64 }, { 240, 0 }, { 460, -208 }, { 392, -232 }
+	};
+
+	static const int AdaptationTable[16] =
+	{
+		230, 230, 230, 230, 307, 409, 512, 614, 768, 614, 512, 409, 307, 230, 230, 230
+	};
+
+	static const int StepTable[89] =
+	{
+		7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+		50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+		337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+		2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+		15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+	};
+
+	static const int IndexTable[16] =
+	{
+		-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8
+	};
+
+	// keeps the adaptive delta from overflowing on hostile input, as other decoders do
+	static const int MaxDelta = 0x7fffffff / 768;
+
+	static int Clamp16( int value )
+	{
+		return value < -32768 ? -32768 : (value > 32767 ? 32767 : value);
+	}
+
+	static int Read16( const unsigned char *data )
+	{
+		return static_cast<short>( data[0] | (data[1] << 8) );
+	}
+
+	static void Write16( unsigned char *data, int value )
+	{
+		data[0] = static_cast<unsigned char>( value & 0xff );
+		data[1] = static_cast<unsigned char>( (value >> 8) & 0xff );
+	}
+
+	static void Store( short *output, int value )
+	{
+		*output = static_cast<short>( value );
+	}
+
+	static void Store( float *output, int value )
+	{
+		*output = value * (1.0f / 32768.0f);
+	}
+
+	struct MsState
+	{
+		int Coef1;
+		int Coef2;
+		int Delta;
+		int Sample1;
+		int Sample2;
+
+		int Predict() const
+		{
+			return static_cast<int>( (static_cast<long long>( Sample1 ) * Coef1 + static_cast<long long>( Sample2 ) * Coef2) >> 8 );
+		}
+
+		int Decode( int nibble )
+		{
+			int sample = Clamp16( Predict() + (nibble - ((nibble & 8) << 1)) * Delta );
+			Sample2 = Sample1;
+			Sample1 = sample;
+
+			Delta = (AdaptationTable[nibble] * Delta) >> 8;
+			if( Delta < 16 )
+				Delta = 16;
+			else if( Delta > MaxDelta )
+				Delta = MaxDelta;
+
+			return sample;
+		}
+
+		int Encode( int sample )
+		{
+			int error = sample - Predict();
+			int nibble = (error >= 0 ? error + Delta / 2 : error - Delta / 2) / Delta;
+			nibble = nibble < -8 ? -8 : (nibble > 7 ? 7 : nibble);
+
+			// running the decoder keeps the state identical to what a decoder will see
+			Decode( nibble & 0xf );
+			return nibble & 0xf;
+		}
+	};
+
+	struct ImaState
+	{
+		int Predictor;
+		int Index;
+
+		int Decode( int nibble )
+		{
+			int step = StepTable[Index];
+			int difference = step >> 3;
+			if( nibble & 1 )
+				difference += step >> 2;
+			if( nibble & 2 )
+				difference += step >> 1;
+			if( nibble & 4 )
+				difference += step;
+
+			Predictor = Clamp16( nibble & 8 ? Predictor - difference : Predictor + difference );
+
+			Index += IndexTable[nibble];
+			Index = Index < 0 ? 0 : (Index > 88 ? 88 : Index);
+
+			return Predictor;
+		}
+
+		int Encode( int sample )
+		{
+			int difference = sample - Predictor;
+			int nibble = 0;
+			if( difference < 0 )
+			{
+				nibble = 8;
+				difference = -difference;
+			}
+
+			int step = StepTable[Index];
+			if( difference >= step )
+			{
+				nibble |= 4;
+				difference -= step;
+			}
+			step >>= 1;
+			if( difference >= step )
+			{
+				nibble |= 2;
+				difference -= step;
+			}
+			step >>= 1;
+			if( difference >= step )
+				nibble |= 1;
+
+			Decode( nibble );
+			return nibble;
+		}
+	};
+
+	unsigned int MsSamplesPerBlock( unsigned int blockSize, unsigned int channels )
+	{
+		if( channels == 0 || channels > MaxChannels || blockSize < 7 * channels )
+			return 0;
+
+		// two samples per channel live in the header, and every byte after it holds two more
+		return 2 + (blockSize - 7 * channels) * 2 / channels;
+	}
+
+	unsigned int ImaSamplesPerBlock( unsigned int blockSize, unsigned int channels )
+	{
+		if( channels == 0 || channels > MaxChannels || blockSize < 4 * channels )
+			return 0;
+
+		// one sample per channel in the header, then eight per four byte group of each channel
+		return 1 + (blockSize - 4 * channels) / (4 * channels) * 8;
+	}
+
+	template<typename Sample>
+	static bool DecodeMs( const unsigned char *block, unsigned int channels, unsigned int frames, const Coefficient *coefficients, unsigned int coefficientCount, Sample *output )
+	{
+		MsState state[MaxChannels];
+		const unsigned char *header = block;
+
+		for( unsigned int c = 0; c < channels; ++c )
+		{
+			unsigned int predictor = header[c];
+			if( predictor >= coefficientCount )
+				return false;
+
+			state[c].Coef1 = coefficients[predictor].Coef1;
+			state[c].Coef2 = coefficients[predictor].Coef2;
+			state[c].Delta = Read16( header + channels + 2 * c );
+			state[c].Sample1 = Read16( header + 3 * channels + 2 * c );
+			state[c].Sample2 = Read16( header + 5 * channels + 2 * c );
+		}
+
+		// the older header sample comes out first
+		for( unsigned int c = 0; c < channels && frames > 0; ++c )
+			Store( output + c, state[c].Sample2 );
+		for( unsigned int c = 0; c < channels && frames > 1; ++c )
+			Store( output + channels + c, state[c].Sample1 );
+
+		if( frames <= 2 )
+			return true;
+
+		const unsigned char *data = block + 7 * channels;
+		unsigned int count = (frames - 2) * channels;
+		Sample *out = output + 2 * channels;
+		unsigned int c = 0;
+
+		// nibbles run high first through the channels in turn
+		for( unsigned int i = 0; i < count; ++i )
+		{
+			int nibble = i & 1 ? data[i >> 1] & 0xf : data[i >> 1] >> 4;
+			Store( out + i, state[c].Decode( nibble ) );
+
+			if( ++c == channels )
+				c = 0;
+		}
+
+		return true;
+	}
+
+	template<typename Sample>
+	static void DecodeIma( const unsigned char *block, unsigned int channels, unsigned int frames, Sample *output )
+	{
+		ImaState state[MaxChannels];
+
+		for( unsigned int c = 0; c < channels; ++c )
+		{
+			state[c].Predictor = Read16( block + 4 * c );
+			state[c].Index = block[4 * c + 2] > 88 ? 88 : block[4 * c + 2];
+
+			if( frames > 0 )
+				Store( output + c, state[c].Predictor );
+		}
+
+		// each channel in turn contributes four bytes holding its next eight samples, low nibble first
+		const unsigned char *data = block + 4 * channels;
+		for( unsigned int frame = 1; frame < frames; frame += 8, data += 4 * channels )
+		{
+			unsigned int count = frames - frame < 8 ? frames - frame : 8;
+			for( unsigned int c = 0; c < channels; ++c )
+			{
+				const unsigned char *group = data + 4 * c;
+				Sample *out = output + frame * channels + c;
+
+				for( unsigned int k = 0; k < count; ++k )
+				{
+					int nibble = k & 1 ? group[k >> 1] >> 4 : group[k >> 1] & 0xf;
+					Store( out + k * channels, state[c].Decode( nibble ) );
+				}
+			}
+		}
+	}
+
+	bool DecodeMsBlock( const unsigned char *block, unsigned int channels, unsigned int frames, const Coefficient *coefficients, unsigned int coefficientCount, short *output )
+	{
+		return DecodeMs( block, channels, frames, coefficients, coefficientCount, output );
+	}
+
+	bool DecodeMsBlock( const unsigned char *block, unsigned int channels, unsigned int frames, const Coefficient *coefficients, unsigned int coefficientCount, float *output )
+	{
+		return DecodeMs( block, channels, frames, coefficients, coefficientCount, output );
+	}
+
+	void DecodeImaBlock( const unsigned char *block, unsigned int channels, unsigned int frames, short *output )
+	{
+		DecodeIma( block, channels, frames, output );
+	}
+
+	void DecodeImaBlock( const unsigned char *block, unsigned int channels, unsigned int frames, float *output )
+	{
+		DecodeIma( block, channels, frames, output );
+	}
+
+	static int InputSample( const short *input, unsigned int frames, unsigned int channels, unsigned int frame, unsigned int channel )
+	{
+		return frame < frames ? input[frame * channels + channel] : 0;
+	}
+
+	static MsState StartMs( const short *input, unsigned int frames, unsigned int channels, unsigned int channel, const Coefficient &coefficient )
+	{
+		MsState state;
+		state.Coef1 = coefficient.Coef1;
+		state.Coef2 = coefficient.Coef2;
+		state.Sample1 = InputSample( input, frames, channels, 1, channel );
+		state.Sample2 = InputSample( input, frames, channels, 0, channel );
+
+		// start the step near the typical residual over the opening samples, so the first nibbles are not wasted adapting
+		long long total = 0;
+		unsigned int count = 0;
+		MsState probe = state;
+		for( unsigned int frame = 2; frame < frames && count < 16; ++frame, ++count )
+		{
+			int sample = InputSample( input, frames, channels, frame, channel );
+			int error = sample - probe.Predict();
+			total += error < 0 ? -error : error;
+			probe.Sample2 = probe.Sample1;
+			probe.Sample1 = sample;
+		}
+
+		long long delta = count > 0 ? total / (count * 2) : 16;
+		state.Delta = static_cast<int>( delta < 16 ? 16 : (delta > 32767 ? 32767 : delta) );
+		return state;
+	}
+
+	void EncodeMsBlock( const short *input, unsigned int frames, unsigned int channels, unsigned int samplesPerBlock, const Coefficient *coefficients, unsigned int coefficientCount, unsigned char *block, unsigned int blockSize )
+	{
+		memset( block, 0, blockSize );
+		if( frames > samplesPerBlock )
+			frames = samplesPerBlock;
+
+		MsState state[MaxChannels];
+		for( unsigned int c = 0; c < channels; ++c )
+		{
+			// pick whichever predictor reconstructs this channel of the block most closely
+			long long bestError = -1;
+			unsigned int best = 0;
+
+			for( unsigned int p = 0; p < coefficientCount; ++p )
+			{
+				MsState trial = StartMs( input, frames, channels, c, coefficients[p] );
+				long long error = 0;
+
+				for( unsigned int frame = 2; frame < samplesPerBlock && (bestError < 0 || error < bestError); ++frame )
+				{
+					int sample = InputSample( input, frames, channels, frame, c );
+					trial.Encode( sample );
+					long long difference = sample - trial.Sample1;
+					error += difference * difference;
+				}
+
+				if( bestError < 0 || error < bestError )
+				{
+					bestError = error;
+					best = p;
+				}
+			}
+
+			state[c] = StartMs( input, frames, channels, c, coefficients[best] );
+			block[c] = static_cast<unsigned char>( best );
+			Write16( block + channels + 2 * c, state[c].Delta );
+			Write16( block + 3 * channels + 2 * c, state[c].Sample1 );
+			Write16( block + 5 * channels + 2 * c, state[c].Sample2 );
+		}
+
+		unsigned char *data = block + 7 * channels;
+		unsigned int i = 0;
+		for( unsigned int frame = 2; frame < samplesPerBlock; ++frame )
+		{
+			for( unsigned int c = 0; c < channels; ++c, ++i )
+			{
+				int nibble = state[c].Encode( InputSample( input, frames, channels, frame, c ) );
+				data[i >> 1] |= static_cast<unsigned char>( i & 1 ? nibble : nibble << 4 );
+			}
+		}
+	}
+
+	void EncodeImaBlock( const short *input, unsigned int frames, unsigned int channels, unsigned int samplesPerBlock, unsigned char *block, unsigned int blockSize )
+	{
+		memset( block, 0, blockSize );
+		if( frames > samplesPerBlock )
+			frames = samplesPerBlock;
+
+		ImaState state[MaxChannels];
+		for( unsigned int c = 0; c < channels; ++c )
+		{
+			// the step index is chosen per block so blocks stay independent; score each against the opening samples
+			int first = InputSample( input, frames, channels, 0, c );
+			long long bestError = -1;
+			int best = 0;
+
+			for( int index = 0; index <= 88; ++index )
+			{
+				ImaState trial = { first, index };
+				long long error = 0;
+
+				for( unsigned int frame = 1; frame < samplesPerBlock && frame <= 32; ++frame )
+				{
+					int sample = InputSample( input, frames, channels, frame, c );
+					trial.Encode( sample );
+					long long difference = sample - trial.Predictor;
+					error += difference * difference;
+				}
+
+				if( bestError < 0 || error < bestError )
+				{
+					bestError = error;
+					best = index;
+				}
+			}
+
+			state[c].Predictor = first;
+			state[c].Index = best;
+			Write16( block + 4 * c, first );
+			block[4 * c + 2] = static_cast<unsigned char>( best );
+		}
+
+		unsigned char *data = block + 4 * channels;
+		for( unsigned int frame = 1; frame < samplesPerBlock; frame += 8, data += 4 * channels )
+		{
+			for( unsigned int c = 0; c < channels; ++c )
+			{
+				unsigned char *group = data + 4 * c;
+				for( unsigned int k = 0; k < 8 && frame + k < samplesPerBlock; ++k )
+				{
+					int nibble = state[c].Encode( InputSample( input, frames, channels, frame + k, c ) );
+					group[k >> 1] |= static_cast<unsigned char>( k & 1 ? nibble << 4 : nibble );
+				}
+			}
+		}
+	}
+}
+}
+}
+
+#ifdef _MANAGED
+#pragma managed(pop)
+#endif
@@ -0,0 +1,61 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+// Portable MS-ADPCM and IMA-ADPCM block codecs. Every block starts with its own predictor state, so blocks
+// can be decoded and encoded independently and in any order. Nothing in here depends on Windows or the CLR.
+namespace SlimDX
+{
+	namespace Multimedia
+	{
+		namespace Adpcm
+		{
+			const unsigned int MaxChannels = 8;
+
+			// One MS-ADPCM predictor, in 8.8 fixed point.
+			struct Coefficient
+			{
+				int Coef1;
+				int Coef2;
+			};
+
+			const unsigned int StandardCoefficientCount = 7;
+			extern const Coefficient StandardCoefficients[StandardCoefficientCount];
+
+			// The number of frames held by a block of the given size, or 0 if it is too small for the block header.
+			unsigned int MsSamplesPerBlock( unsigned int blockSize, unsigned int channels );
+			unsigned int ImaSamplesPerBlock( unsigned int blockSize, unsigned int channels );
+
+			// Decodes the first frames of a block into interleaved samples. Returns false if the block names a predictor
+			// outside the coefficient table.
+			bool DecodeMsBlock( const unsigned char *block, unsigned int channels, unsigned int frames, const Coefficient *coefficients, unsigned int coefficientCount, short *output );
+			bool DecodeMsBlock( const unsigned char *block, unsigned int channels, unsigned int frames, const Coefficient *coefficients, unsigned int coefficientCount, float *output );
+			void DecodeImaBlock( const unsigned char *block, unsigned int channels, unsigned int frames, short *output );
+			void DecodeImaBlock( const unsigned char *block, unsigned int channels, unsigned int frames, float *output );
+
+			// Encodes up to samplesPerBlock frames of interleaved samples into a block of blockSize bytes, padding
+			// missing frames with silence. samplesPerBlock must not exceed what the block size can hold.
+			void EncodeMsBlock( const short *input, unsigned int frames, unsigned int channels, unsigned int samplesPerBlock, const Coefficient *coefficients, unsigned int coefficientCount, unsigned char *block, unsigned int blockSize );
+			void EncodeImaBlock( const short *input, unsigned int frames, unsigned int channels, unsigned int samplesPerBlock, unsigned char *block, unsigned int blockSize );
+		}
+	}
+}
@@ -0,0 +1,484 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "../DataStream.h"
+#include "../xapo/DspKernels.h"
+
+#include "ConversionKernels.h"
+#include "Resampler.h"
+#include "WaveFormatExtensible.h"
+#include "WaveStream.h"
+#include "AudioConverter.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace Multimedia
+{
+	// frames per pass through the pipeline; small enough that every intermediate buffer stays in cache
+	const int ChunkFrames = 1024;
+
+	// how much of a wave stream is read at a time by the batch conversion
+	const int ReadSize = 64 * 1024;
+
+	struct QualitySettings
+	{
+		unsigned int Taps;
+		double Passband;
+		double Beta;
+	};
+
+	static const QualitySettings Qualities[] =
+	{
+		{ 8, 0.85, 5.0 },
+		{ 16, 0.90, 6.0 },
+		{ 32, 0.94, 8.0 },
+		{ 64, 0.96, 10.0 },
+	};
+
+	static const int SampleSizes[] = { 1, 2, 3, 4, 4 };
+
+	AudioConverter::AudioConverter( WaveFormat^ sourceFormat, WaveFormat^ destinationFormat )
+	{
+		Construct( sourceFormat, destinationFormat, ResamplerQuality::High );
+	}
+
+	AudioConverter::AudioConverter( WaveFormat^ sourceFormat, WaveFormat^ destinationFormat, ResamplerQuality quality )
+	{
+		Construct( sourceFormat, destinationFormat, quality );
+	}
+
+	AudioConverter::~AudioConverter()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	AudioConverter::!AudioConverter()
+	{
+		Destruct();
+	}
+
+	void AudioConverter::Construct( WaveFormat^ sourceFormat, WaveFormat^ destinationFormat, ResamplerQuality quality )
+	{
+		unsigned int sourceMask;
+		unsigned int destinationMask;
+		m_SourceType = ParseFormat( sourceFormat, "sourceFormat", sourceMask );
+		m_DestinationType = ParseFormat( destinationFormat, "destinationFormat", destinationMask );
+		if( quality < ResamplerQuality::Low || quality > ResamplerQuality::Best )
+			throw gcnew ArgumentOutOfRangeException( "quality" );
+
+		m_SourceFormat = sourceFormat;
+		m_DestinationFormat = destinationFormat;
+		m_Quality = quality;
+		m_Dither = true;
+
+		m_SourceChannels = sourceFormat->Channels;
+		m_DestinationChannels = destinationFormat->Channels;
+		m_SourceFrameSize = SampleSizes[m_SourceType] * m_SourceChannels;
+		m_DestinationFrameSize = SampleSizes[m_DestinationType] * m_DestinationChannels;
+
+		// float sources and deeper integer sources lose precision on the way out; the enumeration is in that order
+		m_Narrowing = m_SourceType > m_DestinationType;
+
+		int resampledChannels = Math::Min( m_SourceChannels, m_DestinationChannels );
+		int widestChannels = Math::Max( m_SourceChannels, m_DestinationChannels );
+
+		try
+		{
+			// Manual Allocation: this is fine
+			m_Matrix = new float[m_SourceChannels * m_DestinationChannels];
+			m_Input = new float[m_SourceChannels * ChunkFrames];
+			m_Mixed = new float[widestChannels * ChunkFrames];
+			m_Resampled = new float[resampledChannels * ChunkFrames];
+			m_DitherState = new Conversion::DitherState();
+
+			Conversion::BuildChannelMatrix( sourceMask, m_SourceChannels, destinationMask, m_DestinationChannels, m_Matrix );
+			UpdateRemap();
+
+			if( sourceFormat->SamplesPerSecond != destinationFormat->SamplesPerSecond )
+			{
+				// the filter runs over whichever side of the channel matrix has fewer channels
+				const QualitySettings &settings = Qualities[static_cast<int>( quality )];
+				m_Resampler = new Conversion::Resampler();
+				if( !m_Resampler->Initialize( resampledChannels, sourceFormat->SamplesPerSecond, destinationFormat->SamplesPerSecond, settings.Taps, settings.Passband, settings.Beta ) )
+					throw gcnew OutOfMemoryException();
+			}
+
+			Reset();
+		}
+		catch( ... )
+		{
+			Destruct();
+			throw;
+		}
+	}
+
+	void AudioConverter::Destruct()
+	{
+		delete m_Resampler;
+		delete m_DitherState;
+		delete[] m_Matrix;
+		delete[] m_Input;
+		delete[] m_Mixed;
+		delete[] m_Resampled;
+
+		m_Resampler = 0;
+		m_DitherState = 0;
+		m_Matrix = 0;
+		m_Input = 0;
+		m_Mixed = 0;
+		m_Resampled = 0;
+	}
+
+	void AudioConverter::UpdateRemap()
+	{
+		m_Remap = m_SourceChannels != m_DestinationChannels;
+		for( int d = 0; d < m_DestinationChannels && !m_Remap; d++ )
+		{
+			for( int s = 0; s < m_SourceChannels; s++ )
+			{
+				if( m_Matrix[d * m_SourceChannels + s] != (d == s ? 1.0f : 0.0f) )
+					m_Remap = true;
+			}
+		}
+	}
+
+	int AudioConverter::ParseFormat( WaveFormat^ format, String^ name, unsigned int% channelMask )
+	{
+		if( format == nullptr )
+			throw gcnew ArgumentNullException( name );
+		if( format->Channels < 1 || format->Channels > 64 )
+			throw gcnew ArgumentException( "The format has an unsupported number of channels.", name );
+		if( format->SamplesPerSecond <= 0 )
+			throw gcnew ArgumentException( "The format has an invalid sample rate.", name );
+
+		WaveFormatTag tag = format->FormatTag;
+		WaveFormatExtensible^ extensible = dynamic_cast<WaveFormatExtensible^>( format );
+		channelMask = 0;
+
+		if( tag == WaveFormatTag::Extensible )
+		{
+			if( extensible == nullptr )
+				throw gcnew ArgumentException( "An extensible format must be given as a WaveFormatExtensible.", name );
+
+			// the sub-format is the plain format tag inside the standard media subtype GUID
+			if( extensible->SubFormat == Guid( static_cast<int>( WaveFormatTag::Pcm ), 0x0000, 0x0010, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 ) )
+				tag = WaveFormatTag::Pcm;
+			else if( extensible->SubFormat == Guid( static_cast<int>( WaveFormatTag::IeeeFloat ), 0x0000, 0x0010, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 ) )
+				tag = WaveFormatTag::IeeeFloat;
+
+			channelMask = static_cast<unsigned int>( extensible->ChannelMask );
+		}
+
+		int type;
+		if( tag == WaveFormatTag::Pcm && format->BitsPerSample == 8 )
+			type = Conversion::SampleUInt8;
+		else if( tag == WaveFormatTag::Pcm && format->BitsPerSample == 16 )
+			type = Conversion::SampleInt16;
+		else if( tag == WaveFormatTag::Pcm && format->BitsPerSample == 24 )
+			type = Conversion::SampleInt24;
+		else if( tag == WaveFormatTag::Pcm && format->BitsPerSample == 32 )
+			type = Conversion::SampleInt32;
+		else if( tag == WaveFormatTag::IeeeFloat && format->BitsPerSample == 32 )
+			type = Conversion::SampleFloat32;
+		else
+			throw gcnew ArgumentException( "The format is not 8, 16, 24 or 32-bit PCM or 32-bit IEEE float.", name );
+
+		if( format->BlockAlignment != SampleSizes[type] * format->Channels )
+			throw gcnew ArgumentException( "The format has an invalid block alignment.", name );
+
+		if( channelMask == 0 )
+			channelMask = Conversion::DefaultChannelMask( format->Channels );
+
+		return type;
+	}
+
+	int AudioConverter::ConvertFrames( const char *source, int frameCount, int% consumed, char *destination, int capacity )
+	{
+		if( m_Input == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		Conversion::SampleType sourceType = static_cast<Conversion::SampleType>( m_SourceType );
+		Conversion::SampleType destinationType = static_cast<Conversion::SampleType>( m_DestinationType );
+		Conversion::DitherState *dither = m_Dither && (m_Resampler != 0 || m_Remap || m_Narrowing) ? m_DitherState : 0;
+		bool remapFirst = m_Remap && m_DestinationChannels <= m_SourceChannels;
+		bool remapAfter = m_Remap && !remapFirst;
+
+		int written = 0;
+		consumed = 0;
+
+		while( written < capacity )
+		{
+			int frames = Math::Min( frameCount - consumed, ChunkFrames );
+			int produced;
+			int used;
+
+			// without a resampler a frame in is a frame out, so the input is cut short to fit the output
+			if( m_Resampler == 0 )
+				frames = Math::Min( frames, capacity - written );
+
+			if( frames > 0 )
+				Conversion::ToFloat( source + static_cast<size_t>( consumed ) * m_SourceFrameSize, sourceType, m_Input, frames * m_SourceChannels );
+
+			const float *samples = m_Input;
+			if( remapFirst && frames > 0 )
+			{
+				XAPO::Dsp::MixMatrix( m_Input, m_SourceChannels, m_Mixed, m_DestinationChannels, frames, m_Matrix, false );
+				samples = m_Mixed;
+			}
+
+			if( m_Resampler != 0 )
+			{
+				unsigned int taken;
+				produced = m_Resampler->Process( samples, frames, taken, m_Resampled, Math::Min( capacity - written, ChunkFrames ) );
+				used = taken;
+				samples = m_Resampled;
+			}
+			else
+			{
+				produced = frames;
+				used = frames;
+			}
+
+			if( produced == 0 && used == 0 )
+				break;
+
+			if( remapAfter && produced > 0 )
+			{
+				XAPO::Dsp::MixMatrix( samples, m_SourceChannels, m_Mixed, m_DestinationChannels, produced, m_Matrix, false );
+				samples = m_Mixed;
+			}
+
+			Conversion::FromFloat( samples, destinationType, destination + static_cast<size_t>( written ) * m_DestinationFrameSize, produced * m_DestinationChannels, dither );
+			consumed += used;
+			written += produced;
+		}
+
+		return written;
+	}
+
+	int AudioConverter::FlushFrames( char *destination, int capacity )
+	{
+		if( m_Input == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( m_Resampler == 0 )
+			return 0;
+
+		Conversion::SampleType destinationType = static_cast<Conversion::SampleType>( m_DestinationType );
+		Conversion::DitherState *dither = m_Dither ? m_DitherState : 0;
+		bool remapAfter = m_Remap && m_DestinationChannels > m_SourceChannels;
+		int written = 0;
+
+		while( written < capacity )
+		{
+			int produced = m_Resampler->Flush( m_Resampled, Math::Min( capacity - written, ChunkFrames ) );
+			if( produced == 0 )
+				break;
+
+			const float *samples = m_Resampled;
+			if( remapAfter )
+			{
+				XAPO::Dsp::MixMatrix( m_Resampled, m_SourceChannels, m_Mixed, m_DestinationChannels, produced, m_Matrix, false );
+				samples = m_Mixed;
+			}
+
+			Conversion::FromFloat( samples, destinationType, destination + static_cast<size_t>( written ) * m_DestinationFrameSize, produced * m_DestinationChannels, dither );
+			written += produced;
+		}
+
+		return written;
+	}
+
+	int AudioConverter::Convert( DataStream^ source, DataStream^ destination )
+	{
+		if( source == nullptr )
+			throw gcnew ArgumentNullException( "source" );
+		if( destination == nullptr )
+			throw gcnew ArgumentNullException( "destination" );
+		if( !source->CanRead )
+			throw gcnew NotSupportedException( "The source stream must be readable." );
+		if( !destination->CanWrite )
+			throw gcnew NotSupportedException( "The destination stream must be writable." );
+
+		int frames = static_cast<int>( Math::Min( source->RemainingLength / m_SourceFrameSize, static_cast<Int64>( Int32::MaxValue ) ) );
+		int capacity = static_cast<int>( Math::Min( destination->RemainingLength / m_DestinationFrameSize, static_cast<Int64>( Int32::MaxValue / m_DestinationFrameSize ) ) );
+
+		int consumed;
+		int written = ConvertFrames( source->PositionPointer, frames, consumed, destination->PositionPointer, capacity );
+
+		source->Position += static_cast<Int64>( consumed ) * m_SourceFrameSize;
+		destination->Position += written * m_DestinationFrameSize;
+		return written * m_DestinationFrameSize;
+	}
+
+	int AudioConverter::Flush( DataStream^ destination )
+	{
+		if( destination == nullptr )
+			throw gcnew ArgumentNullException( "destination" );
+		if( !destination->CanWrite )
+			throw gcnew NotSupportedException( "The destination stream must be writable." );
+
+		int capacity = static_cast<int>( Math::Min( destination->RemainingLength / m_DestinationFrameSize, static_cast<Int64>( Int32::MaxValue / m_DestinationFrameSize ) ) );
+		int written = FlushFrames( destination->PositionPointer, capacity );
+
+		destination->Position += written * m_DestinationFrameSize;
+		return written * m_DestinationFrameSize;
+	}
+
+	void AudioConverter::Reset()
+	{
+		if( m_Resampler != 0 )
+			m_Resampler->Reset();
+
+		// a fixed seed keeps conversions reproducible
+		if( m_DitherState != 0 )
+			Conversion::SeedDither( *m_DitherState, 0x2545f491 );
+	}
+
+	Int64 AudioConverter::GetOutputSize( Int64 inputSize )
+	{
+		if( inputSize < 0 )
+			throw gcnew ArgumentOutOfRangeException( "inputSize" );
+
+		Int64 frames = inputSize / m_SourceFrameSize;
+		if( m_Resampler != 0 )
+			frames = static_cast<Int64>( m_Resampler->OutputFrames( frames ) );
+
+		return frames * m_DestinationFrameSize;
+	}
+
+	DataStream^ AudioConverter::Convert( WaveStream^ source, WaveFormat^ destinationFormat )
+	{
+		return Convert( source, destinationFormat, ResamplerQuality::High );
+	}
+
+	DataStream^ AudioConverter::Convert( WaveStream^ source, WaveFormat^ destinationFormat, ResamplerQuality quality )
+	{
+		if( source == nullptr )
+			throw gcnew ArgumentNullException( "source" );
+
+		AudioConverter^ converter = gcnew AudioConverter( source->Format, destinationFormat, quality );
+		char *chunk = 0;
+
+		try
+		{
+			int frameSize = converter->m_SourceFrameSize;
+			int chunkSize = Math::Max( ReadSize / frameSize, 1 ) * frameSize;
+
+			DataStream^ result = gcnew DataStream( converter->GetOutputSize( source->Length - source->Position ), true, true );
+			Int64 capacity = result->Length / converter->m_DestinationFrameSize;
+			Int64 written = 0;
+			int filled = 0;
+
+			// Manual Allocation: this is fine
+			chunk = new char[chunkSize];
+
+			for( ;; )
+			{
+				// reads may end partway through a frame, so the remainder is carried over to the next pass
+				int read = source->ReadTo( chunk + filled, chunkSize - filled );
+				filled += read;
+
+				int frames = filled / frameSize;
+				int offset = 0;
+				while( offset < frames )
+				{
+					int consumed;
+					int room = static_cast<int>( Math::Min( capacity - written, static_cast<Int64>( Int32::MaxValue ) ) );
+					written += converter->ConvertFrames( chunk + offset * frameSize, frames - offset, consumed, result->RawPointer + written * converter->m_DestinationFrameSize, room );
+					offset += consumed;
+					if( consumed == 0 )
+						break;
+				}
+
+				memmove( chunk, chunk + offset * frameSize, filled - offset * frameSize );
+				filled -= offset * frameSize;
+
+				if( read == 0 )
+					break;
+			}
+
+			for( ;; )
+			{
+				int room = static_cast<int>( Math::Min( capacity - written, static_cast<Int64>( Int32::MaxValue ) ) );
+				int flushed = converter->FlushFrames( result->RawPointer + written * converter->m_DestinationFrameSize, room );
+				if( flushed == 0 )
+					break;
+
+				written += flushed;
+			}
+
+			result->Position = 0;
+			return result;
+		}
+		finally
+		{
+			delete[] chunk;
+			delete converter;
+		}
+	}
+
+	array<float>^ AudioConverter::CreateChannelMatrix( WaveFormat^ sourceFormat, WaveFormat^ destinationFormat )
+	{
+		unsigned int sourceMask;
+		unsigned int destinationMask;
+		ParseFormat( sourceFormat, "sourceFormat", sourceMask );
+		ParseFormat( destinationFormat, "destinationFormat", destinationMask );
+
+		array<float>^ result = gcnew array<float>( sourceFormat->Channels * destinationFormat->Channels );
+		pin_ptr<float> pinnedResult = &result[0];
+		Conversion::BuildChannelMatrix( sourceMask, sourceFormat->Channels, destinationMask, destinationFormat->Channels, pinnedResult );
+
+		return result;
+	}
+
+	array<float>^ AudioConverter::ChannelMatrix::get()
+	{
+		if( m_Matrix == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		array<float>^ result = gcnew array<float>( m_SourceChannels * m_DestinationChannels );
+		for( int i = 0; i < result->Length; i++ )
+			result[i] = m_Matrix[i];
+
+		return result;
+	}
+
+	void AudioConverter::ChannelMatrix::set( array<float>^ value )
+	{
+		if( m_Matrix == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( value == nullptr )
+			throw gcnew ArgumentNullException( "value" );
+		if( value->Length != m_SourceChannels * m_DestinationChannels )
+			throw gcnew ArgumentException( "The matrix must hold one level for each pair of source and destination channels.", "value" );
+
+		for( int i = 0; i < value->Length; i++ )
+			m_Matrix[i] = value[i];
+
+		UpdateRemap();
+	}
+}
+}
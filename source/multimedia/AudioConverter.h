@@ -0,0 +1,220 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "WaveFormat.h"
+#include "Enums.h"
+
+namespace SlimDX
+{
+	ref class DataStream;
+
+	namespace Multimedia
+	{
+		ref class WaveStream;
+
+		namespace Conversion
+		{
+			class Resampler;
+			struct DitherState;
+		}
+
+		/// <summary>
+		/// Converts PCM and IEEE float audio between sample rates, sample formats and speaker layouts in software.
+		/// </summary>
+		/// <remarks>
+		/// Samples are converted to float, remixed through a channel matrix, resampled with a polyphase windowed-sinc
+		/// filter and converted back, in blocks small enough to stay in cache. Channels are remixed before resampling
+		/// when the destination has fewer of them and afterwards when it has more, so the filter always runs over the
+		/// smaller layout. A converter keeps its filter history between calls to <see cref="Convert(DataStream^, DataStream^)"/>,
+		/// so a stream may be fed to it in blocks of any size; <see cref="Flush"/> writes the tail of the filter at the end.
+		/// Integer sample types of 8 to 32 bits are supported, as well as 32-bit float, in either a plain
+		/// <see cref="WaveFormat"/> or a <see cref="WaveFormatExtensible"/>.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class AudioConverter sealed : System::IDisposable
+		{
+		private:
+			WaveFormat^ m_SourceFormat;
+			WaveFormat^ m_DestinationFormat;
+			ResamplerQuality m_Quality;
+			bool m_Dither;
+
+			int m_SourceType;
+			int m_DestinationType;
+			int m_SourceChannels;
+			int m_DestinationChannels;
+			int m_SourceFrameSize;
+			int m_DestinationFrameSize;
+			bool m_Narrowing;
+
+			Conversion::Resampler *m_Resampler;
+			Conversion::DitherState *m_DitherState;
+			float *m_Matrix;
+			bool m_Remap;
+			float *m_Input;
+			float *m_Mixed;
+			float *m_Resampled;
+
+			void Construct( WaveFormat^ sourceFormat, WaveFormat^ destinationFormat, ResamplerQuality quality );
+			void Destruct();
+			void UpdateRemap();
+
+		internal:
+			static int ParseFormat( WaveFormat^ format, System::String^ name, unsigned int% channelMask );
+			int ConvertFrames( const char *source, int frameCount, int% consumed, char *destination, int capacity );
+			int FlushFrames( char *destination, int capacity );
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="AudioConverter"/> class with <see cref="ResamplerQuality::High"/> quality.
+			/// </summary>
+			/// <param name="sourceFormat">The format of the audio to convert.</param>
+			/// <param name="destinationFormat">The format to convert to.</param>
+			AudioConverter( WaveFormat^ sourceFormat, WaveFormat^ destinationFormat );
+
+			/// <summary>
+			/// Initializes a new instance of the <see cref="AudioConverter"/> class.
+			/// </summary>
+			/// <param name="sourceFormat">The format of the audio to convert.</param>
+			/// <param name="destinationFormat">The format to convert to.</param>
+			/// <param name="quality">The quality of the resampling filter, which is only used when the sample rates differ.</param>
+			AudioConverter( WaveFormat^ sourceFormat, WaveFormat^ destinationFormat, ResamplerQuality quality );
+
+			/// <summary>
+			/// Releases the native resources held by the converter.
+			/// </summary>
+			~AudioConverter();
+
+			/// <summary>
+			/// Releases the native resources held by the converter.
+			/// </summary>
+			!AudioConverter();
+
+			/// <summary>
+			/// Converts whole frames from the current position of one stream into another.
+			/// </summary>
+			/// <param name="source">The audio to convert, read from its current position up to its end.</param>
+			/// <param name="destination">The stream that receives the converted audio at its current position.</param>
+			/// <returns>The number of bytes written.</returns>
+			/// <remarks>
+			/// Conversion stops when either the source is used up or the destination is full; each stream is advanced past
+			/// the frames actually consumed or written, so a partly converted source can simply be passed in again.
+			/// When resampling, some of the consumed input is held back by the filter until later calls or <see cref="Flush"/>.
+			/// </remarks>
+			int Convert( DataStream^ source, DataStream^ destination );
+
+			/// <summary>
+			/// Writes the audio still held by the resampling filter once the source has ended.
+			/// </summary>
+			/// <param name="destination">The stream that receives the converted audio at its current position.</param>
+			/// <returns>The number of bytes written. Call again until it returns zero.</returns>
+			int Flush( DataStream^ destination );
+
+			/// <summary>
+			/// Discards the filter history so that the converter can start on an unrelated stream.
+			/// </summary>
+			void Reset();
+
+			/// <summary>
+			/// Gets the number of bytes produced by converting a whole stream, including the flush at its end.
+			/// </summary>
+			/// <param name="inputSize">The size of the source audio, in bytes.</param>
+			/// <returns>The size of the converted audio, in bytes.</returns>
+			System::Int64 GetOutputSize( System::Int64 inputSize );
+
+			/// <summary>
+			/// Converts the rest of a wave stream into a new stream.
+			/// </summary>
+			/// <param name="source">The audio to convert, read from its current position to its end.</param>
+			/// <param name="destinationFormat">The format to convert to.</param>
+			/// <returns>A stream holding the converted audio.</returns>
+			static DataStream^ Convert( WaveStream^ source, WaveFormat^ destinationFormat );
+
+			/// <summary>
+			/// Converts the rest of a wave stream into a new stream.
+			/// </summary>
+			/// <param name="source">The audio to convert, read from its current position to its end.</param>
+			/// <param name="destinationFormat">The format to convert to.</param>
+			/// <param name="quality">The quality of the resampling filter, which is only used when the sample rates differ.</param>
+			/// <returns>A stream holding the converted audio.</returns>
+			static DataStream^ Convert( WaveStream^ source, WaveFormat^ destinationFormat, ResamplerQuality quality );
+
+			/// <summary>
+			/// Builds the default channel matrix between two formats.
+			/// </summary>
+			/// <param name="sourceFormat">The source format. Its speaker layout comes from <see cref="WaveFormatExtensible::ChannelMask"/>,
+			/// or from the standard layout for its channel count.</param>
+			/// <param name="destinationFormat">The destination format.</param>
+			/// <returns>The levels, laid out like <see cref="ChannelMatrix"/>.</returns>
+			/// <remarks>
+			/// Speakers present in both layouts are passed straight through; the rest are folded into their nearest
+			/// neighbours in the destination at equal power. The matrix is scaled down if any output could otherwise clip.
+			/// </remarks>
+			static array<float>^ CreateChannelMatrix( WaveFormat^ sourceFormat, WaveFormat^ destinationFormat );
+
+			/// <summary>
+			/// Gets the format of the audio being converted.
+			/// </summary>
+			property WaveFormat^ SourceFormat
+			{
+				WaveFormat^ get() { return m_SourceFormat; }
+			}
+
+			/// <summary>
+			/// Gets the format the audio is converted to.
+			/// </summary>
+			property WaveFormat^ DestinationFormat
+			{
+				WaveFormat^ get() { return m_DestinationFormat; }
+			}
+
+			/// <summary>
+			/// Gets the quality of the resampling filter.
+			/// </summary>
+			property ResamplerQuality Quality
+			{
+				ResamplerQuality get() { return m_Quality; }
+			}
+
+			/// <summary>
+			/// Gets or sets a value indicating whether triangular dither is added when the conversion loses precision
+			/// on the way to an integer format of 24 bits or less. The default is <c>true</c>.
+			/// </summary>
+			property bool Dither
+			{
+				bool get() { return m_Dither; }
+				void set( bool value ) { m_Dither = value; }
+			}
+
+			/// <summary>
+			/// Gets or sets the channel matrix. The level from source channel <c>s</c> to destination channel <c>d</c>
+			/// is at <c>d * sourceChannels + s</c>, as in a voice output matrix.
+			/// </summary>
+			property array<float>^ ChannelMatrix
+			{
+				array<float>^ get();
+				void set( array<float>^ value );
+			}
+		};
+	}
+}
@@ -0,0 +1,530 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <string.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define CONVERSION_USE_SSE
+#include <emmintrin.h>
+#endif
+
+#include "ConversionKernels.h"
+
+#ifdef _MANAGED
+#pragma managed(push, off)
+#endif
+
+namespace SlimDX
+{
+namespace Multimedia
+{
+namespace Conversion
+{
+	enum Speaker
+	{
+		FrontLeft = 0x1,
+		FrontRight = 0x2,
+		FrontCenter = 0x4,
+		LowFrequency = 0x8,
+		BackLeft = 0x10,
+		BackRight = 0x20,
+		FrontLeftOfCenter = 0x40,
+		FrontRightOfCenter = 0x80,
+		BackCenter = 0x100,
+		SideLeft = 0x200,
+		SideRight = 0x400,
+		TopCenter = 0x800,
+		TopFrontLeft = 0x1000,
+		TopFrontCenter = 0x2000,
+		TopFrontRight = 0x4000,
+		TopBackLeft = 0x8000,
+		TopBackCenter = 0x10000,
+		TopBackRight = 0x20000
+	};
+
+	static const float Half = 0.5f;
+	static const float MinusThreeDecibels = 0.70710678f;
+
+	static int RoundToInt( float value )
+	{
+#ifdef CONVERSION_USE_SSE
+		return _mm_cvtss_si32( _mm_set_ss( value ) );
+#else
+		return static_cast<int>( floor( value + 0.5f ) );
+#endif
+	}
+
+	static float Clamp( float value, float low, float high )
+	{
+		return value < low ? low : (value > high ? high : value);
+	}
+
+	static unsigned int NextRandom( unsigned int &state )
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	static float UnitRandom( unsigned int &state )
+	{
+		// the top 23 bits become the mantissa of a float in [1, 2)
+		union { unsigned int Bits; float Value; } convert;
+		convert.Bits = (NextRandom( state ) >> 9) | 0x3f800000;
+		return convert.Value - 1.0f;
+	}
+
+	static float TriangularNoise( DitherState *dither )
+	{
+		if( dither == NULL )
+			return 0.0f;
+
+		return UnitRandom( dither->Seed[0] ) - UnitRandom( dither->Seed[0] );
+	}
+
+	void SeedDither( DitherState &dither, unsigned int seed )
+	{
+		for( int i = 0; i < 4; ++i )
+		{
+			// xorshift must never start from zero
+			dither.Seed[i] = seed * 2654435761u + i * 0x9e3779b9u;
+			if( dither.Seed[i] == 0 )
+				dither.Seed[i] = 0x6d2b79f5u;
+		}
+	}
+
+#ifdef CONVERSION_USE_SSE
+	static __m128i NextRandom( __m128i state )
+	{
+		state = _mm_xor_si128( state, _mm_slli_epi32( state, 13 ) );
+		state = _mm_xor_si128( state, _mm_srli_epi32( state, 17 ) );
+		return _mm_xor_si128( state, _mm_slli_epi32( state, 5 ) );
+	}
+
+	static __m128 UnitRandom( __m128i state )
+	{
+		__m128i bits = _mm_or_si128( _mm_srli_epi32( state, 9 ), _mm_set1_epi32( 0x3f800000 ) );
+		return _mm_sub_ps( _mm_castsi128_ps( bits ), _mm_set1_ps( 1.0f ) );
+	}
+
+	static __m128 TriangularNoise( __m128i &state )
+	{
+		state = NextRandom( state );
+		__m128 first = UnitRandom( state );
+		state = NextRandom( state );
+		return _mm_sub_ps( first, UnitRandom( state ) );
+	}
+#endif
+
+	void ToFloat( const void *source, SampleType type, float *destination, unsigned int count )
+	{
+		unsigned int i = 0;
+
+		switch( type )
+		{
+		case SampleUInt8:
+			{
+				const unsigned char *input = static_cast<const unsigned char*>( source );
+				for( ; i < count; ++i )
+					destination[i] = (static_cast<int>( input[i] ) - 128) * (1.0f / 128.0f);
+			}
+			break;
+
+		case SampleInt16:
+			{
+				const short *input = static_cast<const short*>( source );
+#ifdef CONVERSION_USE_SSE
+				const __m128 scale = _mm_set1_ps( 1.0f / 32768.0f );
+				for( ; i + 8 <= count; i += 8 )
+				{
+					__m128i packed = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input + i ) );
+
+					// sign extend by placing each sample in the high half of a lane and shifting it back down
+					__m128i low = _mm_srai_epi32( _mm_unpacklo_epi16( packed, packed ), 16 );
+					__m128i high = _mm_srai_epi32( _mm_unpackhi_epi16( packed, packed ), 16 );
+					_mm_storeu_ps( destination + i, _mm_mul_ps( _mm_cvtepi32_ps( low ), scale ) );
+					_mm_storeu_ps( destination + i + 4, _mm_mul_ps( _mm_cvtepi32_ps( high ), scale ) );
+				}
+#endif
+				for( ; i < count; ++i )
+					destination[i] = input[i] * (1.0f / 32768.0f);
+			}
+			break;
+
+		case SampleInt24:
+			{
+				const unsigned char *input = static_cast<const unsigned char*>( source );
+				for( ; i < count; ++i, input += 3 )
+				{
+					int value = (input[0] << 8) | (input[1] << 16) | (input[2] << 24);
+					destination[i] = (value >> 8) * (1.0f / 8388608.0f);
+				}
+			}
+			break;
+
+		case SampleInt32:
+			{
+				const int *input = static_cast<const int*>( source );
+#ifdef CONVERSION_USE_SSE
+				const __m128 scale = _mm_set1_ps( 1.0f / 2147483648.0f );
+				for( ; i + 4 <= count; i += 4 )
+				{
+					__m128i value = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input + i ) );
+					_mm_storeu_ps( destination + i, _mm_mul_ps( _mm_cvtepi32_ps( value ), scale ) );
+				}
+#endif
+				for( ; i < count; ++i )
+					destination[i] = static_cast<float>( input[i] ) * (1.0f / 2147483648.0f);
+			}
+			break;
+
+		case SampleFloat32:
+			memcpy( destination, source, count * sizeof( float ) );
+			break;
+		}
+	}
+
+	void FromFloat( const float *source, SampleType type, void *destination, unsigned int count, DitherState *dither )
+	{
+		unsigned int i = 0;
+
+		switch( type )
+		{
+		case SampleUInt8:
+			{
+				unsigned char *output = static_cast<unsigned char*>( destination );
+				for( ; i < count; ++i )
+				{
+					float value = Clamp( source[i] * 128.0f + TriangularNoise( dither ), -128.0f, 127.0f );
+					output[i] = static_cast<unsigned char>( RoundToInt( value ) + 128 );
+				}
+			}
+			break;
+
+		case SampleInt16:
+			{
+				short *output = static_cast<short*>( destination );
+#ifdef CONVERSION_USE_SSE
+				const __m128 scale = _mm_set1_ps( 32768.0f );
+				const __m128 low = _mm_set1_ps( -32768.0f );
+				const __m128 high = _mm_set1_ps( 32767.0f );
+				__m128i state = _mm_setzero_si128();
+				if( dither != NULL )
+					state = _mm_loadu_si128( reinterpret_cast<const __m128i*>( dither->Seed ) );
+
+				for( ; i + 8 <= count; i += 8 )
+				{
+					__m128 first = _mm_mul_ps( _mm_loadu_ps( source + i ), scale );
+					__m128 second = _mm_mul_ps( _mm_loadu_ps( source + i + 4 ), scale );
+					if( dither != NULL )
+					{
+						first = _mm_add_ps( first, TriangularNoise( state ) );
+						second = _mm_add_ps( second, TriangularNoise( state ) );
+					}
+
+					// clamp before converting, since out of range floats convert to the most negative integer
+					first = _mm_min_ps( _mm_max_ps( first, low ), high );
+					second = _mm_min_ps( _mm_max_ps( second, low ), high );
+					__m128i packed = _mm_packs_epi32( _mm_cvtps_epi32( first ), _mm_cvtps_epi32( second ) );
+					_mm_storeu_si128( reinterpret_cast<__m128i*>( output + i ), packed );
+				}
+
+				if( dither != NULL )
+					_mm_storeu_si128( reinterpret_cast<__m128i*>( dither->Seed ), state );
+#endif
+				for( ; i < count; ++i )
+					output[i] = static_cast<short>( RoundToInt( Clamp( source[i] * 32768.0f + TriangularNoise( dither ), -32768.0f, 32767.0f ) ) );
+			}
+			break;
+
+		case SampleInt24:
+			{
+				unsigned char *output = static_cast<unsigned char*>( destination );
+				for( ; i < count; ++i, output += 3 )
+				{
+					int value = RoundToInt( Clamp( source[i] * 8388608.0f + TriangularNoise( dither ), -8388608.0f, 8388607.0f ) );
+					output[0] = static_cast<unsigned char>( value & 0xff );
+					output[1] = static_cast<unsigned char>( (value >> 8) & 0xff );
+					output[2] = static_cast<unsigned char>( (value >> 16) & 0xff );
+				}
+			}
+			break;
+
+		case SampleInt32:
+			{
+				// the largest float below 2^31 keeps the conversion in range; dither is far below the float's own precision
+				int *output = static_cast<int*>( destination );
+#ifdef CONVERSION_USE_SSE
+				const __m128 scale = _mm_set1_ps( 2147483648.0f );
+				const __m128 low = _mm_set1_ps( -2147483648.0f );
+				const __m128 high = _mm_set1_ps( 2147483520.0f );
+				for( ; i + 4 <= count; i += 4 )
+				{
+					__m128 value = _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_loadu_ps( source + i ), scale ), low ), high );
+					_mm_storeu_si128( reinterpret_cast<__m128i*>( output + i ), _mm_cvtps_epi32( value ) );
+				}
+#endif
+				for( ; i < count; ++i )
+					output[i] = RoundToInt( Clamp( source[i] * 2147483648.0f, -2147483648.0f, 2147483520.0f ) );
+			}
+			break;
+
+		case SampleFloat32:
+			memcpy( destination, source, count * sizeof( float ) );
+			break;
+		}
+	}
+
+	unsigned int DefaultChannelMask( unsigned int channels )
+	{
+		// the layouts XAudio2 assumes for formats without a channel mask
+		switch( channels )
+		{
+		case 1:
+			return FrontCenter;
+		case 2:
+			return FrontLeft | FrontRight;
+		case 3:
+			return FrontLeft | FrontRight | LowFrequency;
+		case 4:
+			return FrontLeft | FrontRight | BackLeft | BackRight;
+		case 5:
+			return FrontLeft | FrontRight | LowFrequency | BackLeft | BackRight;
+		case 6:
+			return FrontLeft | FrontRight | FrontCenter | LowFrequency | BackLeft | BackRight;
+		case 8:
+			return FrontLeft | FrontRight | FrontCenter | LowFrequency | BackLeft | BackRight | FrontLeftOfCenter | FrontRightOfCenter;
+		default:
+			return 0;
+		}
+	}
+
+	class ChannelRouter
+	{
+	public:
+		ChannelRouter( unsigned int destinationMask, unsigned int destinationChannels, unsigned int sourceChannels, float *matrix )
+			: m_SourceChannels( sourceChannels ), m_Matrix( matrix )
+		{
+			unsigned int channel = 0;
+			for( unsigned int bit = 0; bit < 32; ++bit )
+			{
+				m_Index[bit] = -1;
+				if( (destinationMask & (1u << bit)) && channel < destinationChannels )
+					m_Index[bit] = channel++;
+			}
+		}
+
+		bool Has( unsigned int speaker ) const
+		{
+			return m_Index[BitOf( speaker )] >= 0;
+		}
+
+		bool Add( unsigned int speaker, unsigned int source, float gain )
+		{
+			int index = m_Index[BitOf( speaker )];
+			if( index < 0 )
+				return false;
+
+			m_Matrix[index * m_SourceChannels + source] += gain;
+			return true;
+		}
+
+		bool AddPair( unsigned int left, unsigned int right, unsigned int source, float gain )
+		{
+			if( !Has( left ) || !Has( right ) )
+				return false;
+
+			Add( left, source, gain * MinusThreeDecibels );
+			Add( right, source, gain * MinusThreeDecibels );
+			return true;
+		}
+
+		void RouteFront( unsigned int speaker, unsigned int source, float gain )
+		{
+			if( Add( speaker, source, gain ) )
+				return;
+
+			if( speaker == FrontCenter )
+			{
+				if( !AddPair( FrontLeft, FrontRight, source, gain ) && !Add( FrontLeft, source, gain ) )
+					Add( FrontRight, source, gain );
+			}
+			else
+				Add( FrontCenter, source, gain * MinusThreeDecibels );
+		}
+
+		void Route( unsigned int speaker, unsigned int source, float gain )
+		{
+			switch( speaker )
+			{
+			case FrontLeft:
+			case FrontRight:
+			case FrontCenter:
+				RouteFront( speaker, source, gain );
+				break;
+
+			case FrontLeftOfCenter:
+				if( !Add( speaker, source, gain ) )
+					RouteFront( FrontLeft, source, gain );
+				break;
+
+			case FrontRightOfCenter:
+				if( !Add( speaker, source, gain ) )
+					RouteFront( FrontRight, source, gain );
+				break;
+
+			case BackLeft:
+				if( !Add( speaker, source, gain ) && !Add( SideLeft, source, gain ) && !Add( BackCenter, source, gain * MinusThreeDecibels ) )
+					RouteFront( FrontLeft, source, gain * MinusThreeDecibels );
+				break;
+
+			case BackRight:
+				if( !Add( speaker, source, gain ) && !Add( SideRight, source, gain ) && !Add( BackCenter, source, gain * MinusThreeDecibels ) )
+					RouteFront( FrontRight, source, gain * MinusThreeDecibels );
+				break;
+
+			case SideLeft:
+				if( !Add( speaker, source, gain ) && !Add( BackLeft, source, gain ) )
+					RouteFront( FrontLeft, source, gain * MinusThreeDecibels );
+				break;
+
+			case SideRight:
+				if( !Add( speaker, source, gain ) && !Add( BackRight, source, gain ) )
+					RouteFront( FrontRight, source, gain * MinusThreeDecibels );
+				break;
+
+			case BackCenter:
+				if( !Add( speaker, source, gain ) && !AddPair( BackLeft, BackRight, source, gain ) && !AddPair( SideLeft, SideRight, source, gain ) )
+				{
+					RouteFront( FrontLeft, source, gain * Half );
+					RouteFront( FrontRight, source, gain * Half );
+				}
+				break;
+
+			// height channels fold down onto the speaker beneath them
+			case TopFrontLeft:
+				if( !Add( speaker, source, gain ) )
+					Route( FrontLeft, source, gain );
+				break;
+
+			case TopFrontRight:
+				if( !Add( speaker, source, gain ) )
+					Route( FrontRight, source, gain );
+				break;
+
+			case TopCenter:
+			case TopFrontCenter:
+				if( !Add( speaker, source, gain ) )
+					Route( FrontCenter, source, gain );
+				break;
+
+			case TopBackLeft:
+				if( !Add( speaker, source, gain ) )
+					Route( BackLeft, source, gain );
+				break;
+
+			case TopBackRight:
+				if( !Add( speaker, source, gain ) )
+					Route( BackRight, source, gain );
+				break;
+
+			case TopBackCenter:
+				if( !Add( speaker, source, gain ) )
+					Route( BackCenter, source, gain );
+				break;
+
+			// the low frequency channel is dropped when there is nowhere to send it, as is usual for downmixes
+			default:
+				Add( speaker, source, gain );
+				break;
+			}
+		}
+
+	private:
+		static unsigned int BitOf( unsigned int speaker )
+		{
+			unsigned int bit = 0;
+			while( speaker > 1 )
+			{
+				speaker >>= 1;
+				++bit;
+			}
+			return bit;
+		}
+
+		int m_Index[32];
+		unsigned int m_SourceChannels;
+		float *m_Matrix;
+	};
+
+	static unsigned int CountSpeakers( unsigned int mask, unsigned int channels )
+	{
+		unsigned int count = 0;
+		for( ; mask != 0 && count < channels; mask &= mask - 1 )
+			++count;
+		return count;
+	}
+
+	void BuildChannelMatrix( unsigned int sourceMask, unsigned int sourceChannels, unsigned int destinationMask, unsigned int destinationChannels, float *matrix )
+	{
+		memset( matrix, 0, sourceChannels * destinationChannels * sizeof( float ) );
+
+		ChannelRouter router( destinationMask, destinationChannels, sourceChannels, matrix );
+		unsigned int channel = 0;
+		for( unsigned int bit = 0; bit < 32 && channel < sourceChannels; ++bit )
+		{
+			if( sourceMask & (1u << bit) )
+				router.Route( 1u << bit, channel++, 1.0f );
+		}
+
+		// channels without a speaker position pass straight through to their counterparts
+		unsigned int sourceNamed = CountSpeakers( sourceMask, sourceChannels );
+		unsigned int destinationNamed = CountSpeakers( destinationMask, destinationChannels );
+		for( unsigned int i = 0; sourceNamed + i < sourceChannels && destinationNamed + i < destinationChannels; ++i )
+			matrix[(destinationNamed + i) * sourceChannels + sourceNamed + i] = 1.0f;
+
+		// scale a folding downmix so that a full scale signal on every source channel cannot clip
+		float largest = 0.0f;
+		for( unsigned int d = 0; d < destinationChannels; ++d )
+		{
+			float sum = 0.0f;
+			for( unsigned int s = 0; s < sourceChannels; ++s )
+				sum += matrix[d * sourceChannels + s];
+			largest = sum > largest ? sum : largest;
+		}
+
+		if( largest > 1.0f )
+		{
+			for( unsigned int i = 0; i < sourceChannels * destinationChannels; ++i )
+				matrix[i] /= largest;
+		}
+	}
+}
+}
+}
+
+#ifdef _MANAGED
+#pragma managed(pop)
+#endif
@@ -0,0 +1,65 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+// Native sample format and channel layout conversion used by AudioConverter. Nothing in here depends
+// on Windows or the CLR, so the kernels can be built and checked on their own.
+namespace SlimDX
+{
+	namespace Multimedia
+	{
+		namespace Conversion
+		{
+			enum SampleType
+			{
+				SampleUInt8,
+				SampleInt16,
+				SampleInt24,
+				SampleInt32,
+				SampleFloat32
+			};
+
+			// Triangular dither noise state, one generator per vector lane.
+			struct DitherState
+			{
+				unsigned int Seed[4];
+			};
+
+			void SeedDither( DitherState &dither, unsigned int seed );
+
+			// Converts interleaved samples to floats in [-1, 1).
+			void ToFloat( const void *source, SampleType type, float *destination, unsigned int count );
+
+			// Converts floats to the given sample type with saturation, adding one LSB of triangular dither to
+			// integer types of 24 bits or less when dither is not null.
+			void FromFloat( const float *source, SampleType type, void *destination, unsigned int count, DitherState *dither );
+
+			// The speaker mask implied by a channel count when a format does not give one.
+			unsigned int DefaultChannelMask( unsigned int channels );
+
+			// Builds a destination-major level matrix (matrix[d * sourceChannels + s]) that routes each source speaker
+			// to the same speaker in the destination, or folds it into its nearest neighbours when the destination lacks it.
+			// Channels beyond those named by a mask are matched up in order.
+			void BuildChannelMatrix( unsigned int sourceMask, unsigned int sourceChannels, unsigned int destinationMask, unsigned int destinationChannels, float *matrix );
+		}
+	}
+}
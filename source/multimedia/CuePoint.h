@@ -0,0 +1,56 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	namespace Multimedia
+	{
+		/// <summary>
+		/// Describes a marker stored in the cue chunk of a wave file.
+		/// </summary>
+		/// <unmanaged>CuePoint</unmanaged>
+		public value class CuePoint
+		{
+		public:
+			/// <summary>
+			/// Gets or sets the identifier of the cue point.
+			/// </summary>
+			property int Identifier;
+
+			/// <summary>
+			/// Gets or sets the position of the cue point in play order.
+			/// </summary>
+			property int Position;
+
+			/// <summary>
+			/// Gets or sets the sample at which the cue point is located.
+			/// </summary>
+			property int SampleOffset;
+
+			/// <summary>
+			/// Gets or sets the label given to the cue point in the associated data list, or <c>null</c> if it has none.
+			/// </summary>
+			property System::String^ Label;
+		};
+	}
+}
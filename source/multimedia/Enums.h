@@ -925,6 +925,32 @@ namespace SlimDX
 			Msr = 0x8E
 		};
 
+		/// <summary>
+		/// Specifies the filter quality used by an <see cref="AudioConverter"/> when changing sample rates.
+		/// </summary>
+		public enum class ResamplerQuality : System::Int32
+		{
+			/// <summary>
+			/// An 8 tap filter suitable for voice and previews. This is the cheapest setting.
+			/// </summary>
+			Low,
+
+			/// <summary>
+			/// A 16 tap filter suitable for most game audio.
+			/// </summary>
+			Medium,
+
+			/// <summary>
+			/// A 32 tap filter suitable for music.
+			/// </summary>
+			High,
+
+			/// <summary>
+			/// A 64 tap filter intended for offline conversion where cost is not a concern.
+			/// </summary>
+			Best
+		};
+
 		/// <summary>
 		/// Specifies possible speaker combinations for audio devices.
 		/// </summary>
@@ -1092,6 +1118,7 @@ namespace SlimDX
 			Pcm = WAVE_FORMAT_PCM,
 			AdPcm = WAVE_FORMAT_ADPCM,
 			IeeeFloat = WAVE_FORMAT_IEEE_FLOAT,
+			ImaAdpcm = WAVE_FORMAT_IMA_ADPCM,
 			MpegLayer3 = WAVE_FORMAT_MPEGLAYER3,
 			DolbyAC3Spdif = WAVE_FORMAT_DOLBY_AC3_SPDIF,
 			WMAudio2 = WAVE_FORMAT_WMAUDIO2,
@@ -0,0 +1,247 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "RiffFile.h"
+#include "ReadAheadCache.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Threading;
+using namespace System::Runtime::InteropServices;
+
+namespace SlimDX
+{
+namespace Multimedia
+{
+	ReadAheadCache::ReadAheadCache( RiffFile^ file, int blockSize, int blockCount )
+	{
+		if( file == nullptr )
+			throw gcnew ArgumentNullException( "file" );
+		if( blockSize < 1 )
+			throw gcnew ArgumentOutOfRangeException( "blockSize" );
+		if( blockCount < 2 )
+			throw gcnew ArgumentOutOfRangeException( "blockCount" );
+
+		m_File = file;
+		m_BlockSize = blockSize;
+		m_BlockCount = blockCount;
+		m_TotalBlocks = (file->DataLength + blockSize - 1) / blockSize;
+
+		m_Blocks = gcnew array<array<Byte>^>( blockCount );
+		m_Loaded = gcnew array<Int64>( blockCount );
+		m_Lengths = gcnew array<int>( blockCount );
+
+		for( int i = 0; i < blockCount; i++ )
+		{
+			m_Blocks[i] = gcnew array<Byte>( blockSize );
+			m_Loaded[i] = -1;
+		}
+
+		m_Lock = gcnew Object();
+		m_Thread = gcnew Thread( gcnew ThreadStart( this, &ReadAheadCache::Run ) );
+		m_Thread->IsBackground = true;
+		m_Thread->Name = "SlimDX read-ahead";
+		m_Thread->Start();
+	}
+
+	ReadAheadCache::~ReadAheadCache()
+	{
+		if( m_Thread == nullptr )
+			return;
+
+		Monitor::Enter( m_Lock );
+		try
+		{
+			m_Stopping = true;
+			Monitor::PulseAll( m_Lock );
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+
+		m_Thread->Join();
+		m_Thread = nullptr;
+	}
+
+	Int64 ReadAheadCache::NextMissingBlock()
+	{
+		// the window is the block being read plus as many after it as there are slots, and each block has a fixed slot
+		Int64 end = min( m_Wanted + m_BlockCount, m_TotalBlocks );
+		for( Int64 block = m_Wanted; block < end; block++ )
+		{
+			if( m_Loaded[static_cast<int>( block % m_BlockCount )] != block )
+				return block;
+		}
+
+		return -1;
+	}
+
+	void ReadAheadCache::Run()
+	{
+		while( true )
+		{
+			Int64 block;
+			int slot;
+
+			Monitor::Enter( m_Lock );
+			try
+			{
+				while( true )
+				{
+					if( m_Stopping )
+						return;
+
+					block = NextMissingBlock();
+					if( block >= 0 )
+						break;
+
+					Monitor::Wait( m_Lock );
+				}
+
+				// nobody may read the slot while it is being overwritten
+				slot = static_cast<int>( block % m_BlockCount );
+				m_Loaded[slot] = -1;
+			}
+			finally
+			{
+				Monitor::Exit( m_Lock );
+			}
+
+			int length = 0;
+			Exception^ error = nullptr;
+
+			try
+			{
+				length = m_File->ReadData( block * m_BlockSize, m_Blocks[slot], 0, m_BlockSize );
+			}
+			catch( Exception^ e )
+			{
+				error = e;
+			}
+
+			Monitor::Enter( m_Lock );
+			try
+			{
+				if( error != nullptr )
+					m_Error = error;
+				else
+				{
+					m_Loaded[slot] = block;
+					m_Lengths[slot] = length;
+				}
+
+				Monitor::PulseAll( m_Lock );
+			}
+			finally
+			{
+				Monitor::Exit( m_Lock );
+			}
+
+			if( error != nullptr )
+				return;
+		}
+	}
+
+	array<Byte>^ ReadAheadCache::WaitForBlock( Int64 position, int% within, int% available )
+	{
+		Int64 block = position / m_BlockSize;
+		int slot = static_cast<int>( block % m_BlockCount );
+
+		Monitor::Enter( m_Lock );
+		try
+		{
+			if( m_Wanted != block )
+			{
+				m_Wanted = block;
+				Monitor::PulseAll( m_Lock );
+			}
+
+			if( m_Loaded[slot] != block )
+			{
+				m_StallCount++;
+
+				do
+				{
+					if( m_Error != nullptr )
+						throw gcnew IOException( "The read-ahead thread failed to read the file.", m_Error );
+
+					Monitor::Wait( m_Lock );
+				}
+				while( m_Loaded[slot] != block );
+			}
+
+			within = static_cast<int>( position - block * m_BlockSize );
+			available = m_Lengths[slot] - within;
+			return m_Blocks[slot];
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+	}
+
+	int ReadAheadCache::Read( Int64 position, array<Byte>^ buffer, int offset, int count )
+	{
+		int total = 0;
+		while( total < count && position < m_File->DataLength )
+		{
+			int within;
+			int available;
+			array<Byte>^ block = WaitForBlock( position, within, available );
+			if( available <= 0 )
+				break;
+
+			// the block cannot be replaced while it is the one being read, so copying outside the lock is safe
+			int chunk = min( available, count - total );
+			Buffer::BlockCopy( block, within, buffer, offset + total, chunk );
+
+			position += chunk;
+			total += chunk;
+		}
+
+		return total;
+	}
+
+	int ReadAheadCache::Read( Int64 position, void *destination, int count )
+	{
+		int total = 0;
+		while( total < count && position < m_File->DataLength )
+		{
+			int within;
+			int available;
+			array<Byte>^ block = WaitForBlock( position, within, available );
+			if( available <= 0 )
+				break;
+
+			int chunk = min( available, count - total );
+			Marshal::Copy( block, within, IntPtr( static_cast<char*>( destination ) + total ), chunk );
+
+			position += chunk;
+			total += chunk;
+		}
+
+		return total;
+	}
+}
+}
@@ -0,0 +1,87 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	namespace Multimedia
+	{
+		ref class RiffFile;
+
+		/// <summary>
+		/// Reads the data chunk of a RIFF file on demand in fixed blocks, keeping a bounded window of blocks
+		/// ahead of the reader filled from a background thread.
+		/// </summary>
+		/// <remarks>
+		/// The cache takes over the file: every read of it happens on the I/O thread. Reads from the consumer
+		/// side must come from one thread at a time, which is already the contract of a Stream.
+		/// </remarks>
+		ref class ReadAheadCache sealed
+		{
+		private:
+			RiffFile^ m_File;
+			int m_BlockSize;
+			int m_BlockCount;
+			System::Int64 m_TotalBlocks;
+
+			array<array<System::Byte>^>^ m_Blocks;
+			array<System::Int64>^ m_Loaded;
+			array<int>^ m_Lengths;
+
+			System::Object^ m_Lock;
+			System::Threading::Thread^ m_Thread;
+			System::Int64 m_Wanted;
+			bool m_Stopping;
+			System::Exception^ m_Error;
+			System::Int64 m_StallCount;
+
+			System::Int64 NextMissingBlock();
+			array<System::Byte>^ WaitForBlock( System::Int64 position, int% within, int% available );
+			void Run();
+
+		public:
+			ReadAheadCache( RiffFile^ file, int blockSize, int blockCount );
+			~ReadAheadCache();
+
+			int Read( System::Int64 position, array<System::Byte>^ buffer, int offset, int count );
+			int Read( System::Int64 position, void *destination, int count );
+
+			/// <summary>
+			/// Gets the number of reads that had to wait for the I/O thread.
+			/// </summary>
+			property System::Int64 StallCount
+			{
+				System::Int64 get() { return System::Threading::Interlocked::Read( m_StallCount ); }
+			}
+
+			property int BlockSize
+			{
+				int get() { return m_BlockSize; }
+			}
+
+			property int BlockCount
+			{
+				int get() { return m_BlockCount; }
+			}
+		};
+	}
+}
@@ -0,0 +1,332 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <string.h>
+#include <new>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define RESAMPLER_USE_SSE
+#include <emmintrin.h>
+#endif
+
+#include "Resampler.h"
+
+#ifdef _MANAGED
+#pragma managed(push, off)
+#endif
+
+namespace SlimDX
+{
+namespace Multimedia
+{
+namespace Conversion
+{
+	// above this many phases the table would outgrow the cache, so phases are interpolated instead
+	static const unsigned int MaxPhases = 1024;
+	static const unsigned int MaxChannels = 64;
+	static const unsigned int MaxTaps = 1024;
+	static const unsigned int BlockFrames = 1024;
+	static const double Pi = 3.14159265358979323846;
+
+	static unsigned int GreatestCommonDivisor( unsigned int a, unsigned int b )
+	{
+		while( b != 0 )
+		{
+			unsigned int t = a % b;
+			a = b;
+			b = t;
+		}
+		return a;
+	}
+
+	// zeroth order modified Bessel function of the first kind, for the Kaiser window
+	static double BesselI0( double x )
+	{
+		double sum = 1.0;
+		double term = 1.0;
+		for( int k = 1; k < 50; ++k )
+		{
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+			if( term < sum * 1e-12 )
+				break;
+		}
+		return sum;
+	}
+
+	static float Dot( const float *samples, const float *filter, unsigned int taps )
+	{
+#ifdef RESAMPLER_USE_SSE
+		__m128 sum = _mm_setzero_ps();
+		unsigned int i = 0;
+		for( ; i + 4 <= taps; i += 4 )
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( samples + i ), _mm_loadu_ps( filter + i ) ) );
+
+		sum = _mm_add_ps( sum, _mm_movehl_ps( sum, sum ) );
+		sum = _mm_add_ss( sum, _mm_shuffle_ps( sum, sum, 1 ) );
+		float result = _mm_cvtss_f32( sum );
+		for( ; i < taps; ++i )
+			result += samples[i] * filter[i];
+		return result;
+#else
+		float result = 0.0f;
+		for( unsigned int i = 0; i < taps; ++i )
+			result += samples[i] * filter[i];
+		return result;
+#endif
+	}
+
+	Resampler::Resampler()
+		: m_Channels( 0 ), m_Up( 1 ), m_Down( 1 ), m_Taps( 0 ), m_Phases( 0 ), m_Filter( NULL ), m_Buffer( NULL ), m_Capacity( 0 )
+	{
+		Reset();
+	}
+
+	Resampler::~Resampler()
+	{
+		Release();
+	}
+
+	void Resampler::Release()
+	{
+		delete[] m_Filter;
+		delete[] m_Buffer;
+		m_Filter = NULL;
+		m_Buffer = NULL;
+	}
+
+	bool Resampler::Initialize( unsigned int channels, unsigned int sourceRate, unsigned int destinationRate, unsigned int taps, double passband, double beta )
+	{
+		Release();
+
+		if( channels == 0 || channels > MaxChannels || sourceRate == 0 || destinationRate == 0 || taps < 2 || taps > MaxTaps || taps % 2 != 0 )
+			return false;
+
+		unsigned int divisor = GreatestCommonDivisor( sourceRate, destinationRate );
+		m_Channels = channels;
+		m_Up = destinationRate / divisor;
+		m_Down = sourceRate / divisor;
+
+		// the tap count is given in output samples, so a downsampling filter has to reach over proportionally more input
+		if( m_Down > m_Up )
+		{
+			double scaled = ceil( static_cast<double>( taps ) * m_Down / m_Up / 2 ) * 2;
+			taps = scaled > MaxTaps ? MaxTaps : static_cast<unsigned int>( scaled );
+		}
+
+		m_Taps = taps;
+		m_Phases = m_Up <= MaxPhases ? m_Up : MaxPhases;
+		m_Capacity = taps + BlockFrames;
+
+		// one extra row holds the filter for a whole sample of delay, which interpolation between phases reaches for
+		m_Filter = new (std::nothrow) float[(m_Phases + 1) * taps];
+		m_Buffer = new (std::nothrow) float[m_Capacity * channels];
+		if( m_Filter == NULL || m_Buffer == NULL )
+		{
+			Release();
+			return false;
+		}
+
+		// the cutoff sits below the lower of the two Nyquist frequencies, in cycles per input sample
+		double cutoff = 0.5 * passband * (m_Up < m_Down ? static_cast<double>( m_Up ) / m_Down : 1.0);
+		double half = taps / 2;
+		double window = BesselI0( beta );
+
+		for( unsigned int phase = 0; phase <= m_Phases; ++phase )
+		{
+			float *row = m_Filter + phase * taps;
+			double offset = static_cast<double>( phase ) / m_Phases;
+			double sum = 0.0;
+
+			for( unsigned int j = 0; j < taps; ++j )
+			{
+				// distance in input samples from the output instant to the tap
+				double distance = offset + half - 1 - j;
+				double x = 2.0 * cutoff * distance;
+				double sinc = fabs( x ) < 1e-12 ? 1.0 : sin( Pi * x ) / (Pi * x);
+				double ratio = distance / half;
+				double kaiser = ratio * ratio < 1.0 ? BesselI0( beta * sqrt( 1.0 - ratio * ratio ) ) / window : 0.0;
+
+				double value = 2.0 * cutoff * sinc * kaiser;
+				row[j] = static_cast<float>( value );
+				sum += value;
+			}
+
+			// unity gain at DC for every phase, so a constant signal comes through unchanged
+			for( unsigned int j = 0; j < taps; ++j )
+				row[j] = static_cast<float>( row[j] / sum );
+		}
+
+		Reset();
+		return true;
+	}
+
+	void Resampler::Reset()
+	{
+		// the filter is centered on the output instant, so the first outputs need half a filter of silence before the input
+		unsigned int lead = m_Taps > 0 ? m_Taps / 2 - 1 : 0;
+		if( m_Buffer != NULL )
+			memset( m_Buffer, 0, m_Capacity * m_Channels * sizeof( float ) );
+
+		m_Count = lead;
+		m_Base = -static_cast<long long>( lead );
+		m_Index = 0;
+		m_Phase = 0;
+		m_Received = 0;
+	}
+
+	unsigned long long Resampler::OutputFrames( unsigned long long inputFrames ) const
+	{
+		return (inputFrames * m_Up + m_Down - 1) / m_Down;
+	}
+
+	bool Resampler::Ready() const
+	{
+		return m_Index + m_Taps / 2 < m_Base + m_Count;
+	}
+
+	void Resampler::Produce( float *output )
+	{
+		unsigned int start = static_cast<unsigned int>( m_Index - m_Taps / 2 + 1 - m_Base );
+
+		if( m_Phases == m_Up )
+		{
+			const float *row = m_Filter + m_Phase * m_Taps;
+			for( unsigned int c = 0; c < m_Channels; ++c )
+				output[c] = Dot( m_Buffer + c * m_Capacity + start, row, m_Taps );
+		}
+		else
+		{
+			double position = static_cast<double>( m_Phase ) * m_Phases / m_Up;
+			unsigned int phase = static_cast<unsigned int>( position );
+			float weight = static_cast<float>( position - phase );
+			const float *row = m_Filter + phase * m_Taps;
+
+			for( unsigned int c = 0; c < m_Channels; ++c )
+			{
+				const float *samples = m_Buffer + c * m_Capacity + start;
+				float first = Dot( samples, row, m_Taps );
+				float second = Dot( samples, row + m_Taps, m_Taps );
+				output[c] = first + (second - first) * weight;
+			}
+		}
+
+		m_Phase += m_Down;
+		m_Index += m_Phase / m_Up;
+		m_Phase %= m_Up;
+	}
+
+	unsigned int Resampler::Fill( const float *input, unsigned int frames )
+	{
+		// drop the frames no future output reaches, which may include input not yet seen when downsampling steeply
+		long long first = m_Index - m_Taps / 2 + 1;
+		unsigned int skipped = 0;
+
+		if( first >= m_Base + m_Count )
+		{
+			long long gap = first - (m_Base + m_Count);
+			skipped = gap < frames ? static_cast<unsigned int>( gap ) : frames;
+			m_Base += m_Count + skipped;
+			m_Count = 0;
+			if( input != NULL )
+				input += skipped * m_Channels;
+			frames -= skipped;
+		}
+		else if( first > m_Base )
+		{
+			unsigned int drop = static_cast<unsigned int>( first - m_Base );
+			for( unsigned int c = 0; c < m_Channels; ++c )
+				memmove( m_Buffer + c * m_Capacity, m_Buffer + c * m_Capacity + drop, (m_Count - drop) * sizeof( float ) );
+
+			m_Base = first;
+			m_Count -= drop;
+		}
+
+		unsigned int count = m_Capacity - m_Count < frames ? m_Capacity - m_Count : frames;
+		for( unsigned int c = 0; c < m_Channels; ++c )
+		{
+			float *destination = m_Buffer + c * m_Capacity + m_Count;
+			if( input == NULL )
+				memset( destination, 0, count * sizeof( float ) );
+			else
+			{
+				for( unsigned int i = 0; i < count; ++i )
+					destination[i] = input[i * m_Channels + c];
+			}
+		}
+
+		m_Count += count;
+		return skipped + count;
+	}
+
+	unsigned int Resampler::Process( const float *input, unsigned int frames, unsigned int &consumed, float *output, unsigned int capacity )
+	{
+		unsigned int written = 0;
+		consumed = 0;
+
+		while( written < capacity )
+		{
+			if( Ready() )
+			{
+				Produce( output + written * m_Channels );
+				++written;
+				continue;
+			}
+
+			if( consumed == frames )
+				break;
+
+			unsigned int taken = Fill( input + consumed * m_Channels, frames - consumed );
+			consumed += taken;
+			m_Received += taken;
+		}
+
+		return written;
+	}
+
+	unsigned int Resampler::Flush( float *output, unsigned int capacity )
+	{
+		unsigned int written = 0;
+
+		// outputs are owed for every instant before the end of the real input
+		while( written < capacity && m_Index < m_Received )
+		{
+			if( Ready() )
+			{
+				Produce( output + written * m_Channels );
+				++written;
+			}
+			else
+				Fill( NULL, static_cast<unsigned int>( m_Index + m_Taps / 2 + 1 - (m_Base + m_Count) ) );
+		}
+
+		return written;
+	}
+}
+}
+}
+
+#ifdef _MANAGED
+#pragma managed(pop)
+#endif
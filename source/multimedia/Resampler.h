@@ -0,0 +1,79 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	namespace Multimedia
+	{
+		namespace Conversion
+		{
+			// Streaming polyphase windowed-sinc sample rate converter over interleaved float frames.
+			// The rate ratio is reduced to up/down integers and kept exact; the filter keeps one phase per
+			// output position when there are few enough, and interpolates between phases otherwise.
+			// Output is aligned with the input, so a whole stream produces OutputFrames( input ) frames.
+			class Resampler
+			{
+			public:
+				Resampler();
+				~Resampler();
+
+				// Returns false if the arguments are out of range or the filter cannot be allocated.
+				bool Initialize( unsigned int channels, unsigned int sourceRate, unsigned int destinationRate, unsigned int taps, double passband, double beta );
+				void Reset();
+
+				// Buffers input and writes as many frames as are ready, up to capacity. consumed receives the number of
+				// input frames taken, which is less than frames only when the output filled up.
+				unsigned int Process( const float *input, unsigned int frames, unsigned int &consumed, float *output, unsigned int capacity );
+
+				// Writes the frames still owed for the input so far, padding it with silence. Call until it returns zero.
+				unsigned int Flush( float *output, unsigned int capacity );
+
+				unsigned long long OutputFrames( unsigned long long inputFrames ) const;
+
+			private:
+				Resampler( const Resampler& );
+				Resampler &operator=( const Resampler& );
+
+				bool Ready() const;
+				void Produce( float *output );
+				unsigned int Fill( const float *input, unsigned int frames );
+				void Release();
+
+				unsigned int m_Channels;
+				unsigned int m_Up;
+				unsigned int m_Down;
+				unsigned int m_Taps;
+				unsigned int m_Phases;
+				float *m_Filter;
+
+				float *m_Buffer;
+				unsigned int m_Capacity;
+				unsigned int m_Count;
+				long long m_Base;
+				long long m_Index;
+				unsigned int m_Phase;
+				long long m_Received;
+			};
+		}
+	}
+}
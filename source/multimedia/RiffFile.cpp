@@ -0,0 +1,425 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <vcclr.h>
+
+#include "../InternalHelpers.h"
+#include "../stack_array.h"
+#include "../DataStream.h"
+#include "../MappedFile.h"
+
+#include "RiffFile.h"
+#include "WaveFormat.h"
+#include "WaveFormatExtensible.h"
+#include "AdpcmWaveFormat.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Collections::Generic;
+using namespace System::Runtime::InteropServices;
+
+namespace SlimDX
+{
+namespace Multimedia
+{
+	static int StringLength( const unsigned char *text, unsigned int size )
+	{
+		// RIFF strings are usually, but not always, null terminated
+		unsigned int length = 0;
+		while( length < size && text[length] != 0 )
+			length++;
+
+		return static_cast<int>( length );
+	}
+
+	// lets the portable parser read headers out of a file that is not in memory
+	class StreamChunkReader : public Riff::ChunkReader
+	{
+	private:
+		gcroot<RiffFile^> m_File;
+
+	public:
+		StreamChunkReader( RiffFile^ file )
+		: m_File( file )
+		{
+		}
+
+		virtual unsigned long long Size() const
+		{
+			RiffFile^ file = m_File;
+			return static_cast<unsigned long long>( file->Length );
+		}
+
+		virtual bool Read( unsigned long long offset, void *buffer, unsigned int count )
+		{
+			return m_File->ReadNative( static_cast<Int64>( offset ), buffer, static_cast<int>( count ) );
+		}
+	};
+
+	RiffFile::RiffFile( DataStream^ memory )
+	{
+		if( memory == nullptr )
+			throw gcnew ArgumentNullException( "memory" );
+
+		m_Memory = memory;
+		m_Length = memory->Length;
+
+		// Manual Allocation: this is fine
+		m_Layout = new Riff::WaveLayout();
+	}
+
+	RiffFile::RiffFile( Stream^ stream, Int64 offset, Int64 length, bool ownsStream )
+	{
+		if( stream == nullptr )
+			throw gcnew ArgumentNullException( "stream" );
+		if( !stream->CanRead || !stream->CanSeek )
+			throw gcnew NotSupportedException( "RIFF files can only be read from seekable streams." );
+
+		m_Stream = stream;
+		m_OwnsStream = ownsStream;
+		m_Base = offset;
+		m_Length = length;
+
+		// Manual Allocation: this is fine
+		m_Layout = new Riff::WaveLayout();
+	}
+
+	RiffFile::~RiffFile()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	RiffFile::!RiffFile()
+	{
+		Destruct();
+	}
+
+	void RiffFile::Destruct()
+	{
+		if( m_DataView != nullptr )
+		{
+			delete m_DataView;
+			m_DataView = nullptr;
+		}
+
+		if( m_Memory != nullptr )
+		{
+			delete m_Memory;
+			m_Memory = nullptr;
+		}
+
+		if( m_Stream != nullptr && m_OwnsStream )
+			delete m_Stream;
+		m_Stream = nullptr;
+
+		delete m_Layout;
+		m_Layout = NULL;
+	}
+
+	RiffFile^ RiffFile::Open( String^ path, bool map )
+	{
+		FileStream^ file = gcnew FileStream( path, FileMode::Open, FileAccess::Read, FileShare::Read, 4096, map ? FileOptions::None : FileOptions::SequentialScan );
+		DataStream^ memory = nullptr;
+
+		try
+		{
+			// a file too large for the address space is read through the stream instead
+			if( map && file->Length > 0 )
+				memory = MappedFile::Map( file, 0, 0 );
+		}
+		catch( Exception^ )
+		{
+			delete file;
+			throw;
+		}
+
+		if( memory == nullptr )
+			return gcnew RiffFile( file, 0, file->Length, true );
+
+		delete file;
+		return gcnew RiffFile( memory );
+	}
+
+	void RiffFile::Parse( Riff::FourCC formType, String^ invalidMessage )
+	{
+		Riff::ParseResult result;
+		if( m_Memory != nullptr )
+		{
+			Riff::MemoryChunkReader reader( m_Memory->RawPointer, static_cast<unsigned long long>( m_Length ) );
+			result = Riff::ParseWave( reader, formType, *m_Layout );
+		}
+		else
+		{
+			StreamChunkReader reader( this );
+			result = Riff::ParseWave( reader, formType, *m_Layout );
+		}
+
+		if( result != Riff::ParseSucceeded || m_Layout->Data.Size == 0 )
+			throw gcnew InvalidDataException( invalidMessage );
+
+		if( m_Memory != nullptr )
+			m_DataView = gcnew DataStream( m_Memory, DataOffset, DataLength, true, false );
+	}
+
+	bool RiffFile::ReadNative( Int64 offset, void *buffer, int count )
+	{
+		if( count == 0 )
+			return true;
+
+		array<Byte>^ bytes = gcnew array<Byte>( count );
+		if( ReadAt( offset, bytes, 0, count ) != count )
+			return false;
+
+		Marshal::Copy( bytes, 0, IntPtr( buffer ), count );
+		return true;
+	}
+
+	int RiffFile::ReadData( Int64 position, array<Byte>^ buffer, int offset, int count )
+	{
+		if( position < 0 || position >= DataLength )
+			return 0;
+
+		return ReadAt( position + DataOffset, buffer, offset, static_cast<int>( min( static_cast<Int64>( count ), DataLength - position ) ) );
+	}
+
+	int RiffFile::ReadData( Int64 position, void *destination, int count )
+	{
+		if( position < 0 || position >= DataLength || count <= 0 )
+			return 0;
+
+		count = static_cast<int>( min( static_cast<Int64>( count ), DataLength - position ) );
+		if( m_Memory != nullptr )
+		{
+			memcpy( destination, m_Memory->RawPointer + DataOffset + position, count );
+			return count;
+		}
+
+		array<Byte>^ bytes = gcnew array<Byte>( count );
+		int read = ReadAt( position + DataOffset, bytes, 0, count );
+		if( read > 0 )
+			Marshal::Copy( bytes, 0, IntPtr( destination ), read );
+
+		return read;
+	}
+
+	int RiffFile::ReadAt( Int64 fileOffset, array<Byte>^ buffer, int offset, int count )
+	{
+		if( fileOffset < 0 || fileOffset >= m_Length )
+			return 0;
+
+		if( count > m_Length - fileOffset )
+			count = static_cast<int>( m_Length - fileOffset );
+		if( count <= 0 )
+			return 0;
+
+		if( m_Memory != nullptr )
+		{
+			Marshal::Copy( IntPtr( m_Memory->RawPointer + fileOffset ), buffer, offset, count );
+			return count;
+		}
+
+		m_Stream->Position = m_Base + fileOffset;
+
+		int total = 0;
+		while( total < count )
+		{
+			int read = m_Stream->Read( buffer, offset + total, count - total );
+			if( read == 0 )
+				break;
+
+			total += read;
+		}
+
+		return total;
+	}
+
+	array<Byte>^ RiffFile::ReadChunk( const Riff::ChunkRange &range )
+	{
+		if( !range.Found || range.Size > Riff::MaxMetadataSize )
+			return nullptr;
+
+		array<Byte>^ bytes = gcnew array<Byte>( static_cast<int>( range.Size ) );
+		if( ReadAt( static_cast<Int64>( range.Offset ), bytes, 0, bytes->Length ) != bytes->Length )
+			return nullptr;
+
+		return bytes;
+	}
+
+	WaveFormat^ RiffFile::ReadFormat( String^ invalidMessage )
+	{
+		array<Byte>^ chunk = ReadChunk( m_Layout->Format );
+		if( chunk == nullptr || chunk->Length == 0 )
+			throw gcnew InvalidDataException( invalidMessage );
+
+		pin_ptr<Byte> pinnedChunk = &chunk[0];
+		Riff::FormatHeader header;
+		unsigned int formatSize = Riff::ParseFormat( pinnedChunk, chunk->Length, header );
+		if( formatSize == 0 )
+			throw gcnew InvalidDataException( invalidMessage );
+
+		// the chunk may stop short of cbSize, so build the whole structure and copy in what is there
+		size_t allocationSize = max( static_cast<size_t>( formatSize ), sizeof( WAVEFORMATEX ) );
+		auto_array<WAVEFORMATEX> format( reinterpret_cast<WAVEFORMATEX*>( new BYTE[allocationSize] ) );
+		memset( format.get(), 0, allocationSize );
+		memcpy( format.get(), pinnedChunk, min( static_cast<size_t>( formatSize ), static_cast<size_t>( chunk->Length ) ) );
+		format->cbSize = header.ExtraSize;
+
+		switch( header.FormatTag )
+		{
+		case WAVE_FORMAT_PCM:
+		case WAVE_FORMAT_IEEE_FLOAT:
+			return WaveFormat::FromUnmanaged( *format.get() );
+
+		case WAVE_FORMAT_EXTENSIBLE:
+			return WaveFormatExtensible::FromBase( format.get() );
+
+		case WAVE_FORMAT_ADPCM:
+			return AdpcmWaveFormat::FromBase( format.get() );
+
+		case WAVE_FORMAT_WMAUDIO2:
+		case WAVE_FORMAT_WMAUDIO3:
+			if( header.Channels <= 2 )
+			{
+				format->cbSize = 0;
+				return WaveFormat::FromUnmanaged( *format.get() );
+			}
+
+			return WaveFormatExtensible::FromBase( format.get() );
+
+		default:
+			throw gcnew InvalidDataException( "Unknown or unsupported wave format." );
+		}
+	}
+
+	array<SampleLoop>^ RiffFile::ReadLoops()
+	{
+		array<Byte>^ chunk = ReadChunk( m_Layout->Sample );
+		if( chunk == nullptr || chunk->Length == 0 )
+			return gcnew array<SampleLoop>( 0 );
+
+		pin_ptr<Byte> pinnedChunk = &chunk[0];
+		int count = Riff::ParseSampleLoops( pinnedChunk, chunk->Length, NULL, 0 );
+		stack_array<Riff::SampleLoopRecord> records = stackalloc( Riff::SampleLoopRecord, max( count, 1 ) );
+		Riff::ParseSampleLoops( pinnedChunk, chunk->Length, &records[0], count );
+
+		array<SampleLoop>^ loops = gcnew array<SampleLoop>( count );
+		for( int i = 0; i < count; i++ )
+		{
+			loops[i].Identifier = records[i].Identifier;
+			loops[i].Type = records[i].Type;
+			loops[i].Start = records[i].Start;
+			loops[i].End = records[i].End;
+			loops[i].Fraction = records[i].Fraction;
+			loops[i].PlayCount = records[i].PlayCount;
+		}
+
+		return loops;
+	}
+
+	array<CuePoint>^ RiffFile::ReadCuePoints()
+	{
+		array<Byte>^ chunk = ReadChunk( m_Layout->Cue );
+		if( chunk == nullptr || chunk->Length == 0 )
+			return gcnew array<CuePoint>( 0 );
+
+		pin_ptr<Byte> pinnedChunk = &chunk[0];
+		int count = Riff::ParseCuePoints( pinnedChunk, chunk->Length, NULL, 0 );
+		stack_array<Riff::CuePointRecord> records = stackalloc( Riff::CuePointRecord, max( count, 1 ) );
+		Riff::ParseCuePoints( pinnedChunk, chunk->Length, &records[0], count );
+
+		array<CuePoint>^ points = gcnew array<CuePoint>( count );
+		for( int i = 0; i < count; i++ )
+		{
+			points[i].Identifier = records[i].Identifier;
+			points[i].Position = records[i].Position;
+			points[i].SampleOffset = records[i].SampleOffset;
+		}
+
+		// labels live in a separate associated data list, keyed by cue identifier
+		array<Byte>^ list = ReadChunk( m_Layout->AssociatedData );
+		if( list != nullptr && list->Length > 0 )
+		{
+			pin_ptr<Byte> pinnedList = &list[0];
+			const unsigned char *listData = pinnedList;
+			unsigned int cursor = 0;
+			Riff::SubChunk subChunk;
+
+			while( Riff::NextSubChunk( listData, list->Length, cursor, subChunk ) )
+			{
+				if( subChunk.Id != Riff::MakeFourCC( 'l', 'a', 'b', 'l' ) || subChunk.Size < 4 )
+					continue;
+
+				int identifier = BitConverter::ToInt32( list, subChunk.Offset );
+				const unsigned char *text = listData + subChunk.Offset + 4;
+				String^ label = Marshal::PtrToStringAnsi( IntPtr( const_cast<unsigned char*>( text ) ), StringLength( text, subChunk.Size - 4 ) );
+
+				for( int i = 0; i < count; i++ )
+				{
+					if( points[i].Identifier == identifier )
+						points[i].Label = label;
+				}
+			}
+		}
+
+		return points;
+	}
+
+	IDictionary<String^, String^>^ RiffFile::ReadInfo()
+	{
+		Dictionary<String^, String^>^ info = gcnew Dictionary<String^, String^>();
+
+		array<Byte>^ list = ReadChunk( m_Layout->Info );
+		if( list == nullptr || list->Length == 0 )
+			return info;
+
+		pin_ptr<Byte> pinnedList = &list[0];
+		const unsigned char *listData = pinnedList;
+		unsigned int cursor = 0;
+		Riff::SubChunk subChunk;
+
+		while( Riff::NextSubChunk( listData, list->Length, cursor, subChunk ) )
+		{
+			// the key is the sub-chunk's own identifier, just ahead of its size
+			const unsigned char *text = listData + subChunk.Offset;
+			String^ key = Marshal::PtrToStringAnsi( IntPtr( const_cast<unsigned char*>( text - 8 ) ), 4 );
+			info[key] = Marshal::PtrToStringAnsi( IntPtr( const_cast<unsigned char*>( text ) ), StringLength( text, subChunk.Size ) );
+		}
+
+		return info;
+	}
+
+	array<int>^ RiffFile::ReadPacketTable()
+	{
+		array<Byte>^ chunk = ReadChunk( m_Layout->PacketTable );
+		if( chunk == nullptr )
+			return nullptr;
+
+		array<int>^ table = gcnew array<int>( chunk->Length / sizeof( int ) );
+		if( table->Length > 0 )
+			Buffer::BlockCopy( chunk, 0, table, 0, table->Length * sizeof( int ) );
+
+		return table;
+	}
+}
+}
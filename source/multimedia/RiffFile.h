@@ -0,0 +1,123 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "RiffParser.h"
+#include "SampleLoop.h"
+#include "CuePoint.h"
+
+namespace SlimDX
+{
+	ref class DataStream;
+
+	namespace Multimedia
+	{
+		ref class WaveFormat;
+
+		/// <summary>
+		/// Locates the chunks of a RIFF file held in memory, a mapped file or a seekable stream, and reads
+		/// sample data straight out of wherever the file lives.
+		/// </summary>
+		ref class RiffFile sealed
+		{
+		private:
+			DataStream^ m_Memory;
+			DataStream^ m_DataView;
+			System::IO::Stream^ m_Stream;
+			bool m_OwnsStream;
+			System::Int64 m_Base;
+			System::Int64 m_Length;
+			Riff::WaveLayout *m_Layout;
+
+			void Destruct();
+			array<System::Byte>^ ReadChunk( const Riff::ChunkRange &range );
+			int ReadAt( System::Int64 fileOffset, array<System::Byte>^ buffer, int offset, int count );
+
+		internal:
+			bool ReadNative( System::Int64 offset, void *buffer, int count );
+
+		public:
+			/// <summary>
+			/// Wraps a whole RIFF file in memory. The file takes ownership of the stream.
+			/// </summary>
+			RiffFile( DataStream^ memory );
+
+			/// <summary>
+			/// Wraps a RIFF file that starts at the given offset of a seekable stream.
+			/// </summary>
+			RiffFile( System::IO::Stream^ stream, System::Int64 offset, System::Int64 length, bool ownsStream );
+
+			~RiffFile();
+			!RiffFile();
+
+			/// <summary>
+			/// Opens a file, mapping it into memory if requested. A file that cannot be mapped is read through a stream.
+			/// </summary>
+			static RiffFile^ Open( System::String^ path, bool map );
+
+			/// <summary>
+			/// Locates the chunks of the file, throwing an <see cref="System::IO::InvalidDataException"/> with the given message if it is not a valid file of the form type.
+			/// </summary>
+			void Parse( Riff::FourCC formType, System::String^ invalidMessage );
+
+			WaveFormat^ ReadFormat( System::String^ invalidMessage );
+			array<SampleLoop>^ ReadLoops();
+			array<CuePoint>^ ReadCuePoints();
+			System::Collections::Generic::IDictionary<System::String^, System::String^>^ ReadInfo();
+			array<int>^ ReadPacketTable();
+
+			/// <summary>
+			/// Reads from the data chunk, returning the number of bytes read.
+			/// </summary>
+			int ReadData( System::Int64 position, array<System::Byte>^ buffer, int offset, int count );
+			int ReadData( System::Int64 position, void *destination, int count );
+
+			/// <summary>
+			/// Gets a view of the data chunk, or <c>nullptr</c> if the file is read through a stream.
+			/// </summary>
+			property DataStream^ DataView
+			{
+				DataStream^ get() { return m_DataView; }
+			}
+
+			property System::Int64 DataOffset
+			{
+				System::Int64 get() { return static_cast<System::Int64>( m_Layout->Data.Offset ); }
+			}
+
+			property System::Int64 DataLength
+			{
+				System::Int64 get() { return static_cast<System::Int64>( m_Layout->Data.Size ); }
+			}
+
+			property bool IsRF64
+			{
+				bool get() { return m_Layout->IsRF64; }
+			}
+
+			property System::Int64 Length
+			{
+				System::Int64 get() { return m_Length; }
+			}
+		};
+	}
+}
@@ -0,0 +1,298 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <string.h>
+
+#include "RiffParser.h"
+
+namespace SlimDX
+{
+namespace Multimedia
+{
+namespace Riff
+{
+	static unsigned short Read16( const unsigned char *data )
+	{
+		return static_cast<unsigned short>( data[0] | (data[1] << 8) );
+	}
+
+	static unsigned int Read32( const unsigned char *data )
+	{
+		return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<unsigned int>( data[3] ) << 24);
+	}
+
+	static unsigned long long Read64( const unsigned char *data )
+	{
+		return Read32( data ) | (static_cast<unsigned long long>( Read32( data + 4 ) ) << 32);
+	}
+
+	static void SetRange( ChunkRange &range, unsigned long long offset, unsigned long long size )
+	{
+		// the first chunk of each kind wins, as it does for every other reader
+		if( range.Found )
+			return;
+
+		range.Found = true;
+		range.Offset = offset;
+		range.Size = size;
+	}
+
+	MemoryChunkReader::MemoryChunkReader( const void *data, unsigned long long size )
+	: m_Data( static_cast<const unsigned char*>( data ) ), m_Size( size )
+	{
+	}
+
+	unsigned long long MemoryChunkReader::Size() const
+	{
+		return m_Size;
+	}
+
+	bool MemoryChunkReader::Read( unsigned long long offset, void *buffer, unsigned int count )
+	{
+		if( offset > m_Size || count > m_Size - offset )
+			return false;
+
+		memcpy( buffer, m_Data + offset, count );
+		return true;
+	}
+
+	ParseResult ParseWave( ChunkReader &reader, FourCC formType, WaveLayout &layout )
+	{
+		memset( &layout, 0, sizeof( layout ) );
+
+		unsigned long long fileSize = reader.Size();
+		unsigned char header[12];
+		if( fileSize < 12 || !reader.Read( 0, header, 12 ) )
+			return ParseNotRiff;
+
+		FourCC id = Read32( header );
+		if( id == MakeFourCC( 'R', 'F', '6', '4' ) )
+			layout.IsRF64 = true;
+		else if( id != MakeFourCC( 'R', 'I', 'F', 'F' ) )
+			return ParseNotRiff;
+
+		layout.FormType = Read32( header + 8 );
+		if( layout.FormType != formType )
+			return ParseWrongFormType;
+
+		unsigned long long riffSize = Read32( header + 4 );
+		unsigned long long dataSize = 0;
+		unsigned long long offset = 12;
+
+		if( layout.IsRF64 )
+		{
+			// RF64 keeps the real sizes in a ds64 chunk, which has to come first
+			unsigned char ds64[36];
+			if( fileSize < 12 + sizeof( ds64 ) || !reader.Read( 12, ds64, sizeof( ds64 ) ) )
+				return ParseMalformed;
+
+			unsigned int ds64Size = Read32( ds64 + 4 );
+			if( Read32( ds64 ) != MakeFourCC( 'd', 's', '6', '4' ) || ds64Size < 28 )
+				return ParseMalformed;
+
+			riffSize = Read64( ds64 + 8 );
+			dataSize = Read64( ds64 + 16 );
+			offset = 12 + 8 + static_cast<unsigned long long>( ds64Size ) + (ds64Size & 1);
+		}
+
+		// writers that stream to disk often leave the RIFF size at zero or larger than the file
+		unsigned long long end = fileSize;
+		if( riffSize >= 4 && riffSize <= fileSize - 8 )
+			end = riffSize + 8;
+
+		while( offset <= end && end - offset >= 8 )
+		{
+			unsigned char chunkHeader[12];
+			unsigned int headerSize = end - offset >= 12 ? 12 : 8;
+			if( !reader.Read( offset, chunkHeader, headerSize ) )
+				return ParseMalformed;
+
+			FourCC chunkId = Read32( chunkHeader );
+			unsigned long long size = Read32( chunkHeader + 4 );
+			unsigned long long payload = offset + 8;
+			unsigned long long available = end - payload;
+			bool isData = chunkId == MakeFourCC( 'd', 'a', 't', 'a' );
+
+			if( isData && layout.IsRF64 && size == 0xFFFFFFFF )
+				size = dataSize;
+
+			if( size > available )
+			{
+				// only the sample data may run past the end, which happens to files that were cut short
+				if( !isData )
+					break;
+
+				size = available;
+				layout.IsTruncated = true;
+			}
+
+			if( isData )
+				SetRange( layout.Data, payload, size );
+			else if( chunkId == MakeFourCC( 'f', 'm', 't', ' ' ) )
+				SetRange( layout.Format, payload, size );
+			else if( chunkId == MakeFourCC( 's', 'm', 'p', 'l' ) )
+				SetRange( layout.Sample, payload, size );
+			else if( chunkId == MakeFourCC( 'c', 'u', 'e', ' ' ) )
+				SetRange( layout.Cue, payload, size );
+			else if( chunkId == MakeFourCC( 'd', 'p', 'd', 's' ) )
+				SetRange( layout.PacketTable, payload, size );
+			else if( chunkId == MakeFourCC( 'L', 'I', 'S', 'T' ) && headerSize == 12 && size >= 4 )
+			{
+				FourCC listType = Read32( chunkHeader + 8 );
+				if( listType == MakeFourCC( 'I', 'N', 'F', 'O' ) )
+					SetRange( layout.Info, payload + 4, size - 4 );
+				else if( listType == MakeFourCC( 'a', 'd', 't', 'l' ) )
+					SetRange( layout.AssociatedData, payload + 4, size - 4 );
+			}
+
+			// chunks are padded to an even size
+			unsigned long long advance = size + (size & 1);
+			if( advance > available )
+				break;
+
+			offset = payload + advance;
+		}
+
+		if( !layout.Format.Found )
+			return ParseMissingFormat;
+		if( !layout.Data.Found )
+			return ParseMissingData;
+
+		return ParseSucceeded;
+	}
+
+	unsigned int ParseFormat( const unsigned char *chunk, unsigned int size, FormatHeader &header )
+	{
+		memset( &header, 0, sizeof( header ) );
+		if( chunk == 0 || size < 16 )
+			return 0;
+
+		header.FormatTag = Read16( chunk );
+		header.Channels = Read16( chunk + 2 );
+		header.SamplesPerSecond = Read32( chunk + 4 );
+		header.AverageBytesPerSecond = Read32( chunk + 8 );
+		header.BlockAlign = Read16( chunk + 12 );
+		header.BitsPerSample = Read16( chunk + 14 );
+
+		if( header.Channels == 0 || header.BlockAlign == 0 )
+			return 0;
+
+		bool isPlain = header.FormatTag == 1 || header.FormatTag == 3;
+		if( size >= 18 && !isPlain )
+		{
+			header.ExtraSize = Read16( chunk + 16 );
+			if( header.ExtraSize > size - 18 )
+				return 0;
+		}
+
+		switch( header.FormatTag )
+		{
+		case 0xFFFE:
+			// WAVEFORMATEXTENSIBLE
+			if( header.ExtraSize < 22 )
+				return 0;
+			break;
+
+		case 2:
+			{
+				// ADPCMWAVEFORMAT: samples per block, coefficient count, then the coefficient pairs
+				if( header.ExtraSize < 4 )
+					return 0;
+
+				int coefficients = static_cast<short>( Read16( chunk + 20 ) );
+				if( coefficients < 0 || 4 + 4 * coefficients > header.ExtraSize )
+					return 0;
+				break;
+			}
+		}
+
+		return 18 + header.ExtraSize;
+	}
+
+	int ParseSampleLoops( const unsigned char *chunk, unsigned int size, SampleLoopRecord *loops, int capacity )
+	{
+		if( chunk == 0 || size < 36 )
+			return 0;
+
+		unsigned int count = Read32( chunk + 28 );
+		if( count > (size - 36) / 24 )
+			count = (size - 36) / 24;
+
+		for( unsigned int i = 0; i < count && static_cast<int>( i ) < capacity; i++ )
+		{
+			const unsigned char *source = chunk + 36 + i * 24;
+			loops[i].Identifier = Read32( source );
+			loops[i].Type = Read32( source + 4 );
+			loops[i].Start = Read32( source + 8 );
+			loops[i].End = Read32( source + 12 );
+			loops[i].Fraction = Read32( source + 16 );
+			loops[i].PlayCount = Read32( source + 20 );
+		}
+
+		return static_cast<int>( count );
+	}
+
+	int ParseCuePoints( const unsigned char *chunk, unsigned int size, CuePointRecord *points, int capacity )
+	{
+		if( chunk == 0 || size < 4 )
+			return 0;
+
+		unsigned int count = Read32( chunk );
+		if( count > (size - 4) / 24 )
+			count = (size - 4) / 24;
+
+		for( unsigned int i = 0; i < count && static_cast<int>( i ) < capacity; i++ )
+		{
+			const unsigned char *source = chunk + 4 + i * 24;
+			points[i].Identifier = Read32( source );
+			points[i].Position = Read32( source + 4 );
+			points[i].DataChunk = Read32( source + 8 );
+			points[i].ChunkStart = Read32( source + 12 );
+			points[i].BlockStart = Read32( source + 16 );
+			points[i].SampleOffset = Read32( source + 20 );
+		}
+
+		return static_cast<int>( count );
+	}
+
+	bool NextSubChunk( const unsigned char *list, unsigned int size, unsigned int &cursor, SubChunk &chunk )
+	{
+		if( list == 0 || cursor > size || size - cursor < 8 )
+			return false;
+
+		unsigned int chunkSize = Read32( list + cursor + 4 );
+		unsigned int payload = cursor + 8;
+		if( chunkSize > size - payload )
+			return false;
+
+		chunk.Id = Read32( list + cursor );
+		chunk.Offset = payload;
+		chunk.Size = chunkSize;
+
+		unsigned int advance = chunkSize + (chunkSize & 1);
+		cursor = advance > size - payload ? size : payload + advance;
+		return true;
+	}
+}
+}
+}
@@ -0,0 +1,156 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+// A portable RIFF/WAVE chunk parser. Nothing in here depends on Windows or the CLR, so it can be built and
+// fuzzed on its own. It only ever reads headers and metadata and reports where the chunks are, leaving the
+// sample data untouched in whatever memory or stream it lives in.
+
+namespace SlimDX
+{
+	namespace Multimedia
+	{
+		namespace Riff
+		{
+			typedef unsigned int FourCC;
+
+			inline FourCC MakeFourCC( char a, char b, char c, char d )
+			{
+				return static_cast<unsigned char>( a ) | (static_cast<unsigned char>( b ) << 8) |
+					(static_cast<unsigned char>( c ) << 16) | (static_cast<unsigned int>( static_cast<unsigned char>( d ) ) << 24);
+			}
+
+			// metadata chunks larger than this are skipped rather than read into memory
+			const unsigned int MaxMetadataSize = 1024 * 1024;
+
+			enum ParseResult
+			{
+				ParseSucceeded,
+				ParseNotRiff,
+				ParseWrongFormType,
+				ParseMalformed,
+				ParseMissingFormat,
+				ParseMissingData
+			};
+
+			struct ChunkRange
+			{
+				bool Found;
+				unsigned long long Offset;
+				unsigned long long Size;
+			};
+
+			struct WaveLayout
+			{
+				FourCC FormType;
+				bool IsRF64;
+				bool IsTruncated;
+				ChunkRange Format;
+				ChunkRange Data;
+				ChunkRange Sample;
+				ChunkRange Cue;
+				ChunkRange Info;
+				ChunkRange AssociatedData;
+				ChunkRange PacketTable;
+			};
+
+			struct FormatHeader
+			{
+				unsigned short FormatTag;
+				unsigned short Channels;
+				unsigned int SamplesPerSecond;
+				unsigned int AverageBytesPerSecond;
+				unsigned short BlockAlign;
+				unsigned short BitsPerSample;
+				unsigned short ExtraSize;
+			};
+
+			struct SampleLoopRecord
+			{
+				unsigned int Identifier;
+				unsigned int Type;
+				unsigned int Start;
+				unsigned int End;
+				unsigned int Fraction;
+				unsigned int PlayCount;
+			};
+
+			struct CuePointRecord
+			{
+				unsigned int Identifier;
+				unsigned int Position;
+				FourCC DataChunk;
+				unsigned int ChunkStart;
+				unsigned int BlockStart;
+				unsigned int SampleOffset;
+			};
+
+			struct SubChunk
+			{
+				FourCC Id;
+				unsigned int Offset;
+				unsigned int Size;
+			};
+
+			// Random access to the bytes of a RIFF file, wherever they are stored.
+			class ChunkReader
+			{
+			public:
+				virtual ~ChunkReader() { }
+				virtual unsigned long long Size() const = 0;
+				virtual bool Read( unsigned long long offset, void *buffer, unsigned int count ) = 0;
+			};
+
+			class MemoryChunkReader : public ChunkReader
+			{
+			private:
+				const unsigned char *m_Data;
+				unsigned long long m_Size;
+
+			public:
+				MemoryChunkReader( const void *data, unsigned long long size );
+
+				virtual unsigned long long Size() const;
+				virtual bool Read( unsigned long long offset, void *buffer, unsigned int count );
+			};
+
+			// Locates the chunks of a RIFF or RF64 file whose form type is formType. Truncated data chunks are
+			// accepted and clamped to the end of the file, which is flagged in the layout.
+			ParseResult ParseWave( ChunkReader &reader, FourCC formType, WaveLayout &layout );
+
+			// Validates a fmt chunk. Returns the number of leading bytes that make up the format, counting the
+			// cbSize field even when the chunk omits it, or zero if the chunk is malformed.
+			unsigned int ParseFormat( const unsigned char *chunk, unsigned int size, FormatHeader &header );
+
+			// Decodes the loops of a smpl chunk. Returns the number of complete loops in the chunk; at most
+			// capacity of them are written.
+			int ParseSampleLoops( const unsigned char *chunk, unsigned int size, SampleLoopRecord *loops, int capacity );
+
+			// Decodes the points of a cue chunk. Returns the number of complete points in the chunk; at most
+			// capacity of them are written.
+			int ParseCuePoints( const unsigned char *chunk, unsigned int size, CuePointRecord *points, int capacity );
+
+			// Steps through the sub-chunks of a LIST payload that follows its list type. The cursor starts at zero.
+			bool NextSubChunk( const unsigned char *list, unsigned int size, unsigned int &cursor, SubChunk &chunk );
+		}
+	}
+}
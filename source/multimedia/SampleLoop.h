@@ -0,0 +1,66 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	namespace Multimedia
+	{
+		/// <summary>
+		/// Describes a loop stored in the smpl chunk of a wave file.
+		/// </summary>
+		/// <unmanaged>SampleLoop</unmanaged>
+		public value class SampleLoop
+		{
+		public:
+			/// <summary>
+			/// Gets or sets the identifier of the loop, which may match a cue point.
+			/// </summary>
+			property int Identifier;
+
+			/// <summary>
+			/// Gets or sets the loop type; zero is forward, one is alternating and two is backward.
+			/// </summary>
+			property int Type;
+
+			/// <summary>
+			/// Gets or sets the first sample of the loop.
+			/// </summary>
+			property int Start;
+
+			/// <summary>
+			/// Gets or sets the last sample of the loop, inclusive.
+			/// </summary>
+			property int End;
+
+			/// <summary>
+			/// Gets or sets the fractional part of a sample at which to loop.
+			/// </summary>
+			property int Fraction;
+
+			/// <summary>
+			/// Gets or sets the number of times to play the loop; zero means forever.
+			/// </summary>
+			property int PlayCount;
+		};
+	}
+}
@@ -42,11 +42,7 @@ namespace Multimedia
 		if( !File::Exists( path ) )
 			throw gcnew FileNotFoundException( "Could not find xWMA file", path );
 
-		pin_ptr<const wchar_t> pinnedPath = PtrToStringChars( path );
-		handle = mmioOpen( const_cast<LPWSTR>( reinterpret_cast<LPCWSTR>( pinnedPath ) ), NULL, MMIO_ALLOCBUF | MMIO_READ );
-		if( handle == NULL )
-			throw gcnew FileLoadException( "Could not open the file", path );
-
+		file = RiffFile::Open( path, true );
 		Init();
 	}
 
@@ -60,119 +56,84 @@ namespace Multimedia
 		InitStream( stream, length );
 	}
 
-	void XWMAStream::InitStream( Stream^ stream, int length )
+	XWMAStream::XWMAStream( String^ path, int blockSize, int blockCount )
+	{
+		if( String::IsNullOrEmpty( path ) )
+			throw gcnew ArgumentNullException( "path" );
+		if( blockSize < 1 )
+			throw gcnew ArgumentOutOfRangeException( "blockSize" );
+		if( blockCount < 2 )
+			throw gcnew ArgumentOutOfRangeException( "blockCount" );
+
+		if( !File::Exists( path ) )
+			throw gcnew FileNotFoundException( "Could not find xWMA file", path );
+
+		file = RiffFile::Open( path, false );
+		Init();
+		InitStreaming( blockSize, blockCount );
+	}
+
+	XWMAStream::XWMAStream( Stream^ stream, int blockSize, int blockCount )
 	{
 		if( stream == nullptr )
 			throw gcnew ArgumentNullException( "stream" );
+		if( blockSize < 1 )
+			throw gcnew ArgumentOutOfRangeException( "blockSize" );
+		if( blockCount < 2 )
+			throw gcnew ArgumentOutOfRangeException( "blockCount" );
 
-		DataStream^ ds = nullptr;
-		array<Byte>^ bytes = Utilities::ReadStream( stream, length, &ds );
+		file = gcnew RiffFile( stream, stream->Position, stream->Length - stream->Position, false );
+		Init();
+		InitStreaming( blockSize, blockCount );
+	}
 
-		if( bytes == nullptr )
-		{
-			Int64 size = ds->RemainingLength;
-			internalMemory = gcnew DataStream( size, true, true );
-			internalMemory->WriteRange( IntPtr( ds->SeekToEnd() ), size );
-		}
-		else
+	void XWMAStream::InitStreaming( int blockSize, int blockCount )
+	{
+		// blocks hold whole frames, so nothing filled from a single block ever splits one
+		int alignment = Math::Max( static_cast<int>( format->BlockAlignment ), 1 );
+		if( blockSize > Int32::MaxValue - alignment )
 		{
-			internalMemory = gcnew DataStream( bytes->LongLength, true, true );
-			internalMemory->Write( bytes, 0, bytes->Length );
+			Destruct();
+			throw gcnew ArgumentOutOfRangeException( "blockSize" );
 		}
-		internalMemory->Position = 0;
 
-		MMIOINFO info;
-		ZeroMemory( &info, sizeof( info ) );
-		info.fccIOProc = FOURCC_MEM;
-		info.cchBuffer = bytes->Length;
-		info.pchBuffer = internalMemory->PositionPointer;
+		blockSize = (blockSize + alignment - 1) / alignment * alignment;
+		cache = gcnew ReadAheadCache( file, blockSize, blockCount );
+	}
+
+	void XWMAStream::InitStream( Stream^ stream, int length )
+	{
+		if( stream == nullptr )
+			throw gcnew ArgumentNullException( "stream" );
 
-		handle = mmioOpen( NULL, &info, MMIO_READ );
-		if( handle == NULL )
+		// shares the source's memory wherever its lifetime can be tracked, rather than copying the whole file
+		DataStream^ memory = Utilities::ReadStreamView( stream, length, false );
+		if( memory == nullptr )
 			throw gcnew InvalidDataException( "Invalid xWMA file." );
 
+		file = gcnew RiffFile( memory );
 		Init();
 	}
 
 	void XWMAStream::Init()
 	{
-		MMCKINFO fileInfo;
-		MMCKINFO chunk;
-		PCMWAVEFORMAT pcmFormat;		
-
-		if( mmioDescend( handle, &fileInfo, NULL, 0 ) != 0 )
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-
-		if( fileInfo.ckid != FOURCC_RIFF ||
-			fileInfo.fccType != mmioFOURCC( 'X', 'W', 'M', 'A' ) )
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-
-		chunk.ckid = mmioFOURCC( 'f', 'm', 't', ' ' );
-		if( mmioDescend( handle, &chunk, &fileInfo, MMIO_FINDCHUNK ) != 0 )
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-
-		if( chunk.cksize < static_cast<LONG>( sizeof( PCMWAVEFORMAT ) ) )
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-
-		if( mmioRead( handle, reinterpret_cast<HPSTR>( &pcmFormat ), sizeof( pcmFormat ) ) != sizeof( pcmFormat ) )
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-
-		if( (pcmFormat.wf.wFormatTag != WAVE_FORMAT_WMAUDIO2) &&
-			(pcmFormat.wf.wFormatTag != WAVE_FORMAT_WMAUDIO3))
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-		
-		if(pcmFormat.wf.nChannels <= 2)
+		try
 		{
-			auto_array<WAVEFORMATEX> tempFormat( reinterpret_cast<WAVEFORMATEX*>( new BYTE[sizeof( WAVEFORMATEX )] ) );
-			memcpy( tempFormat.get(), &pcmFormat, sizeof( pcmFormat ) );
-			tempFormat->cbSize = 0;
+			file->Parse( Riff::MakeFourCC( 'X', 'W', 'M', 'A' ), "Invalid xWMA file." );
+			format = file->ReadFormat( "Invalid xWMA file." );
 
-			format = WaveFormat::FromUnmanaged( *tempFormat.get() );
-		}
-		else
-		{
-			WORD extraBytes = 0;
-			if( mmioRead( handle, reinterpret_cast<CHAR*>( &extraBytes ), sizeof( WORD ) ) != sizeof( WORD ) )
+			if( format->FormatTag != WaveFormatTag::WMAudio2 && format->FormatTag != WaveFormatTag::WMAudio3 )
 				throw gcnew InvalidDataException( "Invalid xWMA file." );
 
-			auto_array<WAVEFORMATEX> tempFormat( reinterpret_cast<WAVEFORMATEX*>( new BYTE[sizeof( WAVEFORMATEX ) + extraBytes] ) );
-			memcpy( tempFormat.get(), &pcmFormat, sizeof( pcmFormat ) );
-			tempFormat->cbSize = extraBytes;
-
-			if( mmioRead( handle, reinterpret_cast<CHAR*>( reinterpret_cast<BYTE*>( &tempFormat->cbSize ) + sizeof( WORD ) ), extraBytes ) != extraBytes )
+			decodedpacketsinfo = file->ReadPacketTable();
+			if( decodedpacketsinfo == nullptr || decodedpacketsinfo->Length == 0 )
 				throw gcnew InvalidDataException( "Invalid xWMA file." );
-
-			format = WaveFormatExtensible::FromBase( tempFormat.get() );
 		}
-
-		if( mmioAscend( handle, &chunk, 0 ) != 0 )
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-
-		chunk.ckid = mmioFOURCC( 'd', 'p', 'd', 's' );
-		if( mmioDescend( handle, &chunk, &fileInfo, MMIO_FINDCHUNK ) != 0 )
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-		
-		int numpackets = chunk.cksize / sizeof(int);
-		decodedpacketsinfo = gcnew array<int>(numpackets);
-		pin_ptr<int> pinnedData = &decodedpacketsinfo[0];
-		if( mmioRead( handle, reinterpret_cast<CHAR*>(pinnedData), chunk.cksize ) != (LONG)chunk.cksize )
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-		
-		if( mmioAscend( handle, &chunk, 0 ) != 0 )
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-		
-		chunk.ckid = mmioFOURCC( 'd', 'a', 't', 'a' );
-		if( mmioDescend( handle, &chunk, &fileInfo, MMIO_FINDCHUNK ) != 0 )
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-		
-		dataOffset = mmioSeek( handle, 0, SEEK_CUR );
-		size = chunk.cksize;
-
-		if( dataOffset < 0 || size <= 0 )
-			throw gcnew InvalidDataException( "Invalid xWMA file." );
-
-		if (internalMemory != nullptr)
-		    publicMemory = gcnew DataStream(internalMemory->RawPointer + dataOffset, internalMemory->Length - dataOffset, true, false, false);
+		catch( Exception^ )
+		{
+			Destruct();
+			throw;
+		}
 	}
 
 	XWMAStream::~XWMAStream()
@@ -188,46 +149,34 @@ namespace Multimedia
 
 	void XWMAStream::Destruct()
 	{
-		if( handle != NULL )
-		{
-			mmioClose( handle, 0 );
-			handle = NULL;
-		}
-
-		if( internalMemory != nullptr )
+		// the read-ahead thread has to stop before the file it reads goes away
+		if( cache != nullptr )
 		{
-			delete internalMemory;
-			internalMemory = nullptr;
+			delete cache;
+			cache = nullptr;
 		}
 
-		if( publicMemory != nullptr )
+		if( file != nullptr )
 		{
-			delete publicMemory;
-			publicMemory = nullptr;
+			delete file;
+			file = nullptr;
 		}
 	}
 
 	Int64 XWMAStream::Seek( Int64 offset, SeekOrigin origin )
 	{
-		int targetPosition = static_cast<int>( offset );
-		int targetOrigin = SEEK_CUR;
+		Int64 targetPosition = offset;
 
-		if( origin == SeekOrigin::Begin )
-		{
-			targetOrigin = SEEK_SET;
-			targetPosition += dataOffset;
-		}
+		if( origin == SeekOrigin::Current )
+			targetPosition += position;
 		else if( origin == SeekOrigin::End )
-		{
-			targetOrigin = SEEK_END;
-			targetPosition = dataOffset;
-		}
+			targetPosition += Length;
 
-		int result = mmioSeek( handle, targetPosition, targetOrigin );
-		if( result < 0 )
+		if( targetPosition < 0 || targetPosition > Length )
 			throw gcnew InvalidOperationException("Cannot seek beyond the end of the stream.");
 
-		return result - dataOffset;
+		position = targetPosition;
+		return position;
 	}
 
 	void XWMAStream::Write( array<Byte>^ buffer, int offset, int count )
@@ -243,11 +192,8 @@ namespace Multimedia
 	{		
 		Utilities::CheckArrayBounds( buffer, offset, count );
 
-		// truncate the count to the end of the stream
-		size_t actualCount = min( static_cast<size_t>( Length - Position ), static_cast<size_t>( count ) );
-
-		pin_ptr<Byte> pinnedBuffer = &buffer[offset];
-		int read = mmioRead( handle, reinterpret_cast<HPSTR>( pinnedBuffer ), static_cast<LONG>( actualCount ) );
+		int read = cache != nullptr ? cache->Read( position, buffer, offset, count ) : file->ReadData( position, buffer, offset, count );
+		position += read;
 
 		return read;
 	}
@@ -265,7 +211,7 @@ namespace Multimedia
 
 	Int64 XWMAStream::Position::get()
 	{
-		return mmioSeek( handle, 0, SEEK_CUR ) - dataOffset;
+		return position;
 	}
 
 	void XWMAStream::Position::set( System::Int64 value )
@@ -275,7 +221,7 @@ namespace Multimedia
 	
 	Int64 XWMAStream::Length::get()
 	{
-		return size;
+		return file->DataLength;
 	}
 }
 }
\ No newline at end of file
@@ -23,6 +23,8 @@
 
 #include "WaveFormat.h"
 #include "WaveFormatExtensible.h"
+#include "RiffFile.h"
+#include "ReadAheadCache.h"
 
 namespace SlimDX
 {
@@ -31,28 +33,46 @@ namespace SlimDX
 		public ref class XWMAStream : System::IO::Stream
 		{
 		private:
-			HMMIO handle;
-			int dataOffset;
-			int size;
+			RiffFile^ file;
+			ReadAheadCache^ cache;
+			System::Int64 position;
 			WaveFormat^ format;
 			array<int>^ decodedpacketsinfo;
-			DataStream^ internalMemory;
-			DataStream^ publicMemory;
 
 			void Destruct();
 			void Init();
 			void InitStream( System::IO::Stream^ stream, int length );
+			void InitStreaming( int blockSize, int blockCount );
 
 		internal:
 			property DataStream^ InternalMemory
 			{
-				DataStream^ get() { return publicMemory; }
+				DataStream^ get() { return file == nullptr ? nullptr : file->DataView; }
 			}
 
 		public:
 			XWMAStream( System::String^ path );
 			XWMAStream( System::IO::Stream^ stream );
 			XWMAStream( System::IO::Stream^ stream, int length );
+
+			/// <summary>
+			/// Opens a file in streaming mode. The header is read immediately, but the data is read on demand in blocks,
+			/// with up to <paramref name="blockCount"/> blocks read ahead on a background thread.
+			/// </summary>
+			/// <param name="path">The file to open.</param>
+			/// <param name="blockSize">The size of each block in bytes, which is rounded up to a whole number of frames.</param>
+			/// <param name="blockCount">The number of blocks to keep in memory; at least two.</param>
+			XWMAStream( System::String^ path, int blockSize, int blockCount );
+
+			/// <summary>
+			/// Reads a file from a stream in streaming mode. The header is read immediately, but the data is read on demand in blocks,
+			/// with up to <paramref name="blockCount"/> blocks read ahead on a background thread.
+			/// </summary>
+			/// <param name="stream">A seekable stream positioned at the start of the file. The stream must stay open, and must not
+			/// be used elsewhere, until this object is disposed.</param>
+			/// <param name="blockSize">The size of each block in bytes, which is rounded up to a whole number of frames.</param>
+			/// <param name="blockCount">The number of blocks to keep in memory; at least two.</param>
+			XWMAStream( System::IO::Stream^ stream, int blockSize, int blockCount );
 			~XWMAStream();
 			!XWMAStream();
 
@@ -148,6 +168,22 @@ namespace SlimDX
 				WaveFormat^ get() { return format; }
 			}
 
+			/// <summary>
+			/// Gets whether the data is read on demand rather than held in memory.
+			/// </summary>
+			property bool IsStreaming
+			{
+				bool get() { return cache != nullptr; }
+			}
+
+			/// <summary>
+			/// Gets the number of reads in streaming mode that had to wait for data to arrive from the file.
+			/// </summary>
+			property System::Int64 StallCount
+			{
+				System::Int64 get() { return cache == nullptr ? 0 : cache->StallCount; }
+			}
+
 			property array<int>^ DecodedPacketsInfo
 			{
 				array<int>^ get() { return decodedpacketsinfo; }
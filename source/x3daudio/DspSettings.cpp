@@ -37,6 +37,24 @@ namespace X3DAudio
 		MatrixCoefficients = nullptr;
 		DelayTimes = nullptr;
 
+		Assign( settings );
+	}
+
+	DspSettings::DspSettings( int sourceChannelCount, int destinationChannelCount )
+	{
+		if( sourceChannelCount <= 0 )
+			throw gcnew ArgumentOutOfRangeException( "sourceChannelCount" );
+		if( destinationChannelCount <= 0 )
+			throw gcnew ArgumentOutOfRangeException( "destinationChannelCount" );
+
+		MatrixCoefficients = gcnew array<float>( sourceChannelCount * destinationChannelCount );
+		DelayTimes = gcnew array<float>( destinationChannelCount );
+		SourceChannelCount = sourceChannelCount;
+		DestinationChannelCount = destinationChannelCount;
+	}
+
+	void DspSettings::Assign( const X3DAUDIO_DSP_SETTINGS &settings )
+	{
 		SourceChannelCount = settings.SrcChannelCount;
 		DestinationChannelCount = settings.DstChannelCount;
 		LpfDirectCoefficient = settings.LPFDirectCoefficient;
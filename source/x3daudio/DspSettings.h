@@ -30,7 +30,17 @@ namespace SlimDX
 		internal:
 			DspSettings( const X3DAUDIO_DSP_SETTINGS &settings );
 
+			void Assign( const X3DAUDIO_DSP_SETTINGS &settings );
+
 		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="DspSettings"/> class with preallocated matrix and delay arrays,
+			/// for use with the batched <see cref="X3DAudio"/>.Calculate.
+			/// </summary>
+			/// <param name="sourceChannelCount">The number of channels of the emitter the settings will be calculated for.</param>
+			/// <param name="destinationChannelCount">The number of channels of the final mix.</param>
+			DspSettings( int sourceChannelCount, int destinationChannelCount );
+
 			property array<float>^ MatrixCoefficients;
 			property array<float>^ DelayTimes;
 			property int SourceChannelCount;
@@ -0,0 +1,264 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <windows.h>
+#include <x3daudio.h>
+
+#include "EmitterSet.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace X3DAudio
+{
+	namespace
+	{
+		// Stream order: position, velocity, front and top, three components each.
+		const int PositionStream = 0;
+		const int VelocityStream = 3;
+		const int FrontStream = 6;
+		const int TopStream = 9;
+		const int StreamCount = 12;
+
+		size_t CurveSize( array<CurvePoint>^ points )
+		{
+			if( points == nullptr )
+				return 0;
+
+			return sizeof( X3DAUDIO_DISTANCE_CURVE ) + sizeof( X3DAUDIO_DISTANCE_CURVE_POINT ) * points->Length;
+		}
+
+		X3DAUDIO_DISTANCE_CURVE *WriteCurve( array<CurvePoint>^ points, char *&cursor )
+		{
+			if( points == nullptr )
+				return NULL;
+
+			X3DAUDIO_DISTANCE_CURVE *curve = reinterpret_cast<X3DAUDIO_DISTANCE_CURVE*>( cursor );
+			curve->PointCount = points->Length;
+			curve->pPoints = reinterpret_cast<X3DAUDIO_DISTANCE_CURVE_POINT*>( cursor + sizeof( X3DAUDIO_DISTANCE_CURVE ) );
+
+			for( int i = 0; i < points->Length; i++ )
+			{
+				curve->pPoints[i].Distance = points[i].Distance;
+				curve->pPoints[i].DSPSetting = points[i].DspSetting;
+			}
+
+			cursor += CurveSize( points );
+			return curve;
+		}
+	}
+
+	EmitterSet::EmitterSet( int capacity )
+	{
+		if( capacity <= 0 )
+			throw gcnew ArgumentOutOfRangeException( "capacity" );
+
+		m_Capacity = capacity;
+		m_Count = 0;
+
+		// Manual Allocation: cleaned up in the finalizer / destructor
+		m_Streams = new float[StreamCount * capacity];
+		m_Emitters = new X3DAUDIO_EMITTER[capacity];
+		m_Blocks = new char*[capacity];
+
+		memset( m_Streams, 0, sizeof( float ) * StreamCount * capacity );
+		memset( m_Emitters, 0, sizeof( X3DAUDIO_EMITTER ) * capacity );
+		memset( m_Blocks, 0, sizeof( char* ) * capacity );
+	}
+
+	void EmitterSet::Destruct()
+	{
+		FreeBlocks();
+
+		delete[] m_Streams;
+		delete[] m_Emitters;
+		delete[] m_Blocks;
+		m_Streams = NULL;
+		m_Emitters = NULL;
+		m_Blocks = NULL;
+		m_Count = 0;
+	}
+
+	void EmitterSet::FreeBlocks()
+	{
+		if( m_Blocks == NULL )
+			return;
+
+		for( int i = 0; i < m_Capacity; i++ )
+		{
+			delete[] m_Blocks[i];
+			m_Blocks[i] = NULL;
+		}
+	}
+
+	int EmitterSet::Add( Emitter^ emitter )
+	{
+		if( m_Streams == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( m_Count == m_Capacity )
+			throw gcnew InvalidOperationException( "The emitter set is full." );
+
+		int index = m_Count++;
+		try
+		{
+			Set( index, emitter );
+		}
+		catch( Exception^ )
+		{
+			m_Count--;
+			throw;
+		}
+
+		return index;
+	}
+
+	void EmitterSet::Set( int index, Emitter^ emitter )
+	{
+		if( m_Streams == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( index < 0 || index >= m_Count )
+			throw gcnew ArgumentOutOfRangeException( "index" );
+		if( emitter == nullptr )
+			throw gcnew ArgumentNullException( "emitter" );
+		if( emitter->ChannelCount < 1 )
+			throw gcnew ArgumentException( "The emitter must have at least one channel.", "emitter" );
+		if( emitter->ChannelCount > 1 && ( emitter->ChannelAzimuths == nullptr || emitter->ChannelAzimuths->Length < emitter->ChannelCount ) )
+			throw gcnew ArgumentException( "A multichannel emitter needs an azimuth for each channel.", "emitter" );
+
+		Cone^ cone = emitter->Cone;
+		array<float>^ azimuths = emitter->ChannelAzimuths;
+		array<CurvePoint>^ volume = emitter->VolumeCurve;
+		array<CurvePoint>^ lfe = emitter->LfeCurve;
+		array<CurvePoint>^ lpfDirect = emitter->LpfDirectCurve;
+		array<CurvePoint>^ lpfReverb = emitter->LpfReverbCurve;
+		array<CurvePoint>^ reverb = emitter->ReverbCurve;
+
+		// curves go first so that their pointers stay aligned; the cone and azimuths are plain floats
+		size_t size = CurveSize( volume ) + CurveSize( lfe ) + CurveSize( lpfDirect ) + CurveSize( lpfReverb ) + CurveSize( reverb );
+		if( cone != nullptr )
+			size += sizeof( X3DAUDIO_CONE );
+		if( azimuths != nullptr )
+			size += sizeof( FLOAT32 ) * azimuths->Length;
+
+		// Manual Allocation: cleaned up in FreeBlocks or when the slot is set again
+		char *block = size == 0 ? NULL : new char[size];
+		char *cursor = block;
+
+		X3DAUDIO_EMITTER &target = m_Emitters[index];
+
+		target.pVolumeCurve = WriteCurve( volume, cursor );
+		target.pLFECurve = WriteCurve( lfe, cursor );
+		target.pLPFDirectCurve = WriteCurve( lpfDirect, cursor );
+		target.pLPFReverbCurve = WriteCurve( lpfReverb, cursor );
+		target.pReverbCurve = WriteCurve( reverb, cursor );
+
+		target.pCone = NULL;
+		if( cone != nullptr )
+		{
+			target.pCone = reinterpret_cast<X3DAUDIO_CONE*>( cursor );
+			*target.pCone = cone->ToUnmanaged();
+			cursor += sizeof( X3DAUDIO_CONE );
+		}
+
+		target.pChannelAzimuths = NULL;
+		if( azimuths != nullptr )
+		{
+			target.pChannelAzimuths = reinterpret_cast<FLOAT32*>( cursor );
+			for( int i = 0; i < azimuths->Length; i++ )
+				target.pChannelAzimuths[i] = azimuths[i];
+		}
+
+		delete[] m_Blocks[index];
+		m_Blocks[index] = block;
+
+		target.InnerRadius = emitter->InnerRadius;
+		target.InnerRadiusAngle = emitter->InnerRadiusAngle;
+		target.ChannelCount = emitter->ChannelCount;
+		target.ChannelRadius = emitter->ChannelRadius;
+		target.CurveDistanceScaler = emitter->CurveDistance;
+		target.DopplerScaler = emitter->Doppler;
+
+		SetPosition( index, emitter->Position, emitter->Velocity );
+		SetOrientation( index, emitter->OrientFront, emitter->OrientTop );
+	}
+
+	void EmitterSet::SetPosition( int index, Vector3 position, Vector3 velocity )
+	{
+		if( m_Streams == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( index < 0 || index >= m_Count )
+			throw gcnew ArgumentOutOfRangeException( "index" );
+
+		Stream( PositionStream )[index] = position.X;
+		Stream( PositionStream + 1 )[index] = position.Y;
+		Stream( PositionStream + 2 )[index] = position.Z;
+		Stream( VelocityStream )[index] = velocity.X;
+		Stream( VelocityStream + 1 )[index] = velocity.Y;
+		Stream( VelocityStream + 2 )[index] = velocity.Z;
+	}
+
+	void EmitterSet::SetOrientation( int index, Vector3 front, Vector3 top )
+	{
+		if( m_Streams == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( index < 0 || index >= m_Count )
+			throw gcnew ArgumentOutOfRangeException( "index" );
+
+		Stream( FrontStream )[index] = front.X;
+		Stream( FrontStream + 1 )[index] = front.Y;
+		Stream( FrontStream + 2 )[index] = front.Z;
+		Stream( TopStream )[index] = top.X;
+		Stream( TopStream + 1 )[index] = top.Y;
+		Stream( TopStream + 2 )[index] = top.Z;
+	}
+
+	void EmitterSet::Clear()
+	{
+		if( m_Streams == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		FreeBlocks();
+		memset( m_Emitters, 0, sizeof( X3DAUDIO_EMITTER ) * m_Capacity );
+		m_Count = 0;
+	}
+
+	void EmitterSet::Fill( int index, X3DAUDIO_EMITTER &emitter )
+	{
+		emitter = m_Emitters[index];
+
+		emitter.Position.x = Stream( PositionStream )[index];
+		emitter.Position.y = Stream( PositionStream + 1 )[index];
+		emitter.Position.z = Stream( PositionStream + 2 )[index];
+		emitter.Velocity.x = Stream( VelocityStream )[index];
+		emitter.Velocity.y = Stream( VelocityStream + 1 )[index];
+		emitter.Velocity.z = Stream( VelocityStream + 2 )[index];
+		emitter.OrientFront.x = Stream( FrontStream )[index];
+		emitter.OrientFront.y = Stream( FrontStream + 1 )[index];
+		emitter.OrientFront.z = Stream( FrontStream + 2 )[index];
+		emitter.OrientTop.x = Stream( TopStream )[index];
+		emitter.OrientTop.y = Stream( TopStream + 1 )[index];
+		emitter.OrientTop.z = Stream( TopStream + 2 )[index];
+	}
+}
+}
@@ -0,0 +1,124 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "../math/Vector3.h"
+#include "Emitter.h"
+
+namespace SlimDX
+{
+	namespace X3DAudio
+	{
+		/// <summary>
+		/// A fixed-capacity set of emitters kept in native memory, for calculating many emitters against one listener in a
+		/// single call to <see cref="X3DAudio"/>.Calculate.
+		/// </summary>
+		/// <remarks>
+		/// Positions, velocities and orientations are stored as separate arrays so that they can be updated every frame
+		/// without touching the rest of the emitter. Cones, curves and channel azimuths are copied into a native block owned
+		/// by the emitter's slot each time the emitter is added or set; changes made to those objects afterwards are not seen
+		/// until the emitter is set again.
+		/// </remarks>
+		/// <unmanaged>X3DAUDIO_EMITTER</unmanaged>
+		public ref class EmitterSet sealed : System::IDisposable
+		{
+		private:
+			int m_Capacity;
+			int m_Count;
+			float *m_Streams;
+			X3DAUDIO_EMITTER *m_Emitters;
+			char **m_Blocks;
+
+			void Destruct();
+			void FreeBlocks();
+			float *Stream( int component ) { return m_Streams + component * m_Capacity; }
+
+		internal:
+			void Fill( int index, X3DAUDIO_EMITTER &emitter );
+			int GetChannelCount( int index ) { return m_Emitters[index].ChannelCount; }
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="EmitterSet"/> class.
+			/// </summary>
+			/// <param name="capacity">The maximum number of emitters the set can hold.</param>
+			EmitterSet( int capacity );
+
+			/// <summary>
+			/// Releases the native memory held by the set.
+			/// </summary>
+			~EmitterSet() { Destruct(); }
+			!EmitterSet() { Destruct(); }
+
+			/// <summary>
+			/// Adds an emitter to the end of the set.
+			/// </summary>
+			/// <param name="emitter">The emitter to copy into the set.</param>
+			/// <returns>The index of the new emitter.</returns>
+			int Add( Emitter^ emitter );
+
+			/// <summary>
+			/// Replaces all of the properties of an emitter in the set.
+			/// </summary>
+			/// <param name="index">The index of the emitter.</param>
+			/// <param name="emitter">The emitter to copy into the set.</param>
+			void Set( int index, Emitter^ emitter );
+
+			/// <summary>
+			/// Updates the position and velocity of an emitter in the set.
+			/// </summary>
+			/// <param name="index">The index of the emitter.</param>
+			/// <param name="position">The new position of the emitter.</param>
+			/// <param name="velocity">The new velocity of the emitter.</param>
+			void SetPosition( int index, Vector3 position, Vector3 velocity );
+
+			/// <summary>
+			/// Updates the orientation of an emitter in the set.
+			/// </summary>
+			/// <param name="index">The index of the emitter.</param>
+			/// <param name="front">The new front orientation of the emitter.</param>
+			/// <param name="top">The new top orientation of the emitter.</param>
+			void SetOrientation( int index, Vector3 front, Vector3 top );
+
+			/// <summary>
+			/// Removes all emitters from the set and releases their converted cones and curves.
+			/// </summary>
+			void Clear();
+
+			/// <summary>
+			/// Gets the number of emitters in the set.
+			/// </summary>
+			property int Count
+			{
+				int get() { return m_Count; }
+			}
+
+			/// <summary>
+			/// Gets the maximum number of emitters the set can hold.
+			/// </summary>
+			property int Capacity
+			{
+				int get() { return m_Capacity; }
+			}
+		};
+	}
+}
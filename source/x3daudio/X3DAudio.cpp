@@ -25,6 +25,8 @@
 #include <x3daudio.h>
 #include <xaudio2.h>
 
+#include "../ParallelLoop.h"
+
 #include "X3DAudio.h"
 
 using namespace System;
@@ -35,6 +37,50 @@ namespace X3DAudio
 {
 	X3DAUDIO_VECTOR Vector3ToX3DAudio( Vector3 value );
 
+	// each emitter is cheap, so hand them out in batches to keep the scheduling cost down
+	const int EmittersPerRange = 32;
+
+	static void CalculateEmitter( const BYTE *handle, const X3DAUDIO_LISTENER *listener, EmitterSet^ emitters, UINT32 flags, DspSettings^ target, int index )
+	{
+		X3DAUDIO_EMITTER emitter;
+		emitters->Fill( index, emitter );
+
+		pin_ptr<float> pinMatrix = &target->MatrixCoefficients[0];
+		pin_ptr<float> pinDelayTimes;
+
+		X3DAUDIO_DSP_SETTINGS nativeSettings;
+		memset( &nativeSettings, 0, sizeof( nativeSettings ) );
+		nativeSettings.SrcChannelCount = target->SourceChannelCount;
+		nativeSettings.DstChannelCount = target->DestinationChannelCount;
+		nativeSettings.pMatrixCoefficients = reinterpret_cast<FLOAT32*>( pinMatrix );
+
+		if( target->DelayTimes != nullptr && target->DelayTimes->Length > 0 )
+		{
+			pinDelayTimes = &target->DelayTimes[0];
+			nativeSettings.pDelayTimes = reinterpret_cast<FLOAT32*>( pinDelayTimes );
+		}
+
+		X3DAudioCalculate( handle, listener, &emitter, flags, &nativeSettings );
+
+		target->Assign( nativeSettings );
+	}
+
+	ref class CalculateJob sealed
+	{
+	public:
+		const BYTE *Handle;
+		const X3DAUDIO_LISTENER *NativeListener;
+		EmitterSet^ Emitters;
+		UINT32 Flags;
+		array<DspSettings^>^ Settings;
+
+		void Run( int begin, int end )
+		{
+			for( int i = begin; i < end; i++ )
+				CalculateEmitter( Handle, NativeListener, Emitters, Flags, Settings[i], i );
+		}
+	};
+
 	X3DAudio::X3DAudio( SlimDX::Multimedia::Speakers speakers, float speedOfSound )
 	{
 		// Manual Allocation: cleaned up in the finalizer / destructor
@@ -180,5 +226,65 @@ namespace X3DAudio
 
 		return settings;
 	}
+
+	void X3DAudio::Calculate( Listener^ listener, EmitterSet^ emitters, CalculateFlags flags, array<DspSettings^>^ settings )
+	{
+		Calculate( listener, emitters, flags, settings, false );
+	}
+
+	void X3DAudio::Calculate( Listener^ listener, EmitterSet^ emitters, CalculateFlags flags, array<DspSettings^>^ settings, bool parallel )
+	{
+		if( handle == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( listener == nullptr )
+			throw gcnew ArgumentNullException( "listener" );
+		if( emitters == nullptr )
+			throw gcnew ArgumentNullException( "emitters" );
+		if( settings == nullptr )
+			throw gcnew ArgumentNullException( "settings" );
+		if( settings->Length < emitters->Count )
+			throw gcnew ArgumentException( "There must be a settings object for every emitter.", "settings" );
+
+		bool delay = ( flags & CalculateFlags::Delay ) == CalculateFlags::Delay;
+		for( int i = 0; i < emitters->Count; i++ )
+		{
+			DspSettings^ target = settings[i];
+			if( target == nullptr )
+				throw gcnew ArgumentNullException( "settings" );
+			if( target->SourceChannelCount != emitters->GetChannelCount( i ) )
+				throw gcnew ArgumentException( "The source channel count of each settings object must match its emitter.", "settings" );
+			if( target->MatrixCoefficients == nullptr || target->MatrixCoefficients->Length < target->SourceChannelCount * target->DestinationChannelCount )
+				throw gcnew ArgumentException( "Each settings object must have room for its full matrix.", "settings" );
+			if( delay && ( target->DelayTimes == nullptr || target->DelayTimes->Length < target->DestinationChannelCount ) )
+				throw gcnew ArgumentException( "Each settings object must have room for its delay times.", "settings" );
+		}
+
+		X3DAUDIO_CONE cone;
+		X3DAUDIO_LISTENER nativeListener = listener->ToUnmanaged();
+
+		if( listener->Cone != nullptr )
+		{
+			cone = listener->Cone->ToUnmanaged();
+			nativeListener.pCone = &cone;
+		}
+		else
+			nativeListener.pCone = NULL;
+
+		if( !parallel || emitters->Count <= EmittersPerRange )
+		{
+			for( int i = 0; i < emitters->Count; i++ )
+				CalculateEmitter( handle->Handle, &nativeListener, emitters, static_cast<UINT32>( flags ), settings[i], i );
+			return;
+		}
+
+		CalculateJob^ job = gcnew CalculateJob();
+		job->Handle = handle->Handle;
+		job->NativeListener = &nativeListener;
+		job->Emitters = emitters;
+		job->Flags = static_cast<UINT32>( flags );
+		job->Settings = settings;
+
+		ParallelLoop::For( emitters->Count, EmittersPerRange, gcnew ParallelRange( job, &CalculateJob::Run ) );
+	}
 }
 }
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include "../multimedia/Enums.h"
 #include "Listener.h"
 #include "Emitter.h"
+#include "EmitterSet.h"
 #include "DspSettings.h"
 #include "Enums.h"
 #include "HandleWrapper.h"
@@ -45,6 +46,29 @@ namespace SlimDX
 			!X3DAudio() { Destruct(); }
 
 			DspSettings^ Calculate( Listener^ listener, Emitter^ emitter, CalculateFlags flags, int sourceChannelCount, int destinationChannelCount );
+
+			/// <summary>
+			/// Calculates DSP settings for every emitter in a set against one listener, writing them into preallocated settings.
+			/// </summary>
+			/// <param name="listener">The listener.</param>
+			/// <param name="emitters">The emitters to calculate settings for.</param>
+			/// <param name="flags">Flags that specify which settings to calculate.</param>
+			/// <param name="settings">One preallocated settings object per emitter, in the same order. Each must have been created
+			/// with the channel count of its emitter, and needs delay times if <see cref="CalculateFlags::Delay"/> is specified.</param>
+			/// <remarks>This overload does not allocate; the settings objects and their arrays are reused.</remarks>
+			void Calculate( Listener^ listener, EmitterSet^ emitters, CalculateFlags flags, array<DspSettings^>^ settings );
+
+			/// <summary>
+			/// Calculates DSP settings for every emitter in a set against one listener, writing them into preallocated settings.
+			/// </summary>
+			/// <param name="listener">The listener.</param>
+			/// <param name="emitters">The emitters to calculate settings for.</param>
+			/// <param name="flags">Flags that specify which settings to calculate.</param>
+			/// <param name="settings">One preallocated settings object per emitter, in the same order. Each must have been created
+			/// with the channel count of its emitter, and needs delay times if <see cref="CalculateFlags::Delay"/> is specified.</param>
+			/// <param name="parallel"><c>true</c> to spread the emitters across the thread pool; otherwise, <c>false</c>.
+			/// The results are the same either way.</param>
+			void Calculate( Listener^ listener, EmitterSet^ emitters, CalculateFlags flags, array<DspSettings^>^ settings, bool parallel );
 		};
 	}
 }
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include "XACT3Exception.h"
 #include "SoundBank.h"
 #include "WaveBank.h"
+#include "WaveBankFile.h"
 #include "Engine.h"
 
 using namespace System;
@@ -81,6 +82,29 @@ namespace XACT3
 		return gcnew WaveBank( result );
 	}
 
+	WaveBank^ Engine::CreateWaveBank( WaveBankFile^ file )
+	{
+		if( file == nullptr )
+			throw gcnew ArgumentNullException( "file" );
+		if( file->IsStreaming )
+			throw gcnew ArgumentException( "Streaming wave banks must be created with CreateStreamingWaveBank.", "file" );
+		if( file->Length > UInt32::MaxValue )
+			throw gcnew ArgumentException( "The wave bank is too large to be held in memory.", "file" );
+
+		DataStream^ data = file->Data;
+		IXACT3WaveBank *result;
+
+		HRESULT hr = InternalPointer->CreateInMemoryWaveBank( data->RawPointer, static_cast<DWORD>( file->Length ), 0, 0, &result );
+		if (RECORD_XACT3(hr).IsFailure)
+		{
+			delete data;
+			return nullptr;
+		}
+
+		// the stream shares the file's mapping, so holding it keeps the bank's memory mapped
+		return gcnew WaveBank( result, data );
+	}
+
 	WaveBank^ Engine::CreateStreamingWaveBank(String^ fileName, int offset, int packetSize)
 	{
 		IXACT3WaveBank *result;
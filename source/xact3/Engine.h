@@ -36,6 +36,7 @@ namespace SlimDX
 	{
 		ref class SoundBank;
 		ref class WaveBank;
+		ref class WaveBankFile;
 
 		public ref class Engine : public ComObject
 		{
@@ -52,6 +53,13 @@ namespace SlimDX
 			WaveBank^ CreateWaveBank( DataStream^ data );
 			WaveBank^ CreateStreamingWaveBank( System::String^ fileName, int offset, int packetSize );
 
+			/// <summary>
+			/// Creates an in-memory wave bank that plays straight from a mapped wave bank file, without copying it.
+			/// </summary>
+			/// <param name="file">The mapped wave bank file. The wave bank keeps the mapping alive, so the file may be disposed first.</param>
+			/// <returns>The new wave bank, or <c>null</c> if the engine could not create it.</returns>
+			WaveBank^ CreateWaveBank( WaveBankFile^ file );
+
 			/// <summary>
 			/// Performs periodic work that is required by the XACT engine. Typically this should be called every 30 to 100 milliseconds.
 			/// </summary>
@@ -21,6 +21,8 @@
 */
 #include "stdafx.h"
 
+#include "../DataStream.h"
+
 #include "XACT3Exception.h"
 #include "WaveBank.h"
 
@@ -42,12 +44,27 @@ namespace XACT3
 		handle = file;
 	}
 
+	WaveBank::WaveBank( IXACT3WaveBank *pointer, DataStream^ memory )
+	{
+		// the memory holding an in-memory bank has to outlive it
+		InternalPointer = pointer;
+		handle = nullptr;
+		source = memory;
+	}
+
 	Result WaveBank::Destroy()
 	{
 		HRESULT hr = InternalPointer->Destroy();
 		if (handle != nullptr)
 			delete handle;
 
+		// the slice holds a reference on the file's mapping until it is disposed
+		if (source != nullptr)
+		{
+			delete source;
+			source = nullptr;
+		}
+
 		return RECORD_XACT3(hr);
 	}
 
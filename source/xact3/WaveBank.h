@@ -27,6 +27,8 @@
 
 namespace SlimDX
 {
+	ref class DataStream;
+
 	namespace XACT3
 	{
 		/// <summary>
@@ -38,10 +40,12 @@ namespace SlimDX
 		private:
 			IXACT3WaveBank* InternalPointer;
 			Microsoft::Win32::SafeHandles::SafeFileHandle^ handle;
+			DataStream^ source;
 
 		internal:
 			WaveBank( IXACT3WaveBank *pointer );
 			WaveBank( IXACT3WaveBank *pointer, Microsoft::Win32::SafeHandles::SafeFileHandle^ handle );
+			WaveBank( IXACT3WaveBank *pointer, DataStream^ source );
 
 		public:
 			Result Destroy();
@@ -0,0 +1,530 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include "stdafx.h"
+
+#include "../DataStream.h"
+#include "../MappedFile.h"
+
+#include "WaveBankFile.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Threading;
+using namespace System::Collections::Generic;
+
+namespace SlimDX
+{
+namespace XACT3
+{
+	namespace
+	{
+		const Int64 DefaultPrefetchBudget = 64 * 1024 * 1024;
+		const unsigned int StreamingFlag = 0x1;
+	}
+
+#ifdef _MANAGED
+#pragma managed(push, off)
+#endif
+
+	// Reads one byte from every page of a region so that the pages are brought in from disk.
+	static unsigned int TouchPages( const unsigned char *data, unsigned long long length, unsigned int pageSize )
+	{
+		unsigned int sum = 0;
+		const volatile unsigned char *p = data;
+
+		for( unsigned long long i = 0; i < length; i += pageSize )
+			sum += p[i];
+		if( length > 0 )
+			sum += p[length - 1];
+
+		return sum;
+	}
+
+#ifdef _MANAGED
+#pragma managed(pop)
+#endif
+
+	WaveBankFile::WaveBankFile( String^ fileName )
+	{
+		Open( fileName, DefaultPrefetchBudget );
+	}
+
+	WaveBankFile::WaveBankFile( String^ fileName, Int64 prefetchBudget )
+	{
+		Open( fileName, prefetchBudget );
+	}
+
+	void WaveBankFile::Open( String^ fileName, Int64 prefetchBudget )
+	{
+		if( fileName == nullptr )
+			throw gcnew ArgumentNullException( "fileName" );
+		if( prefetchBudget < 0 )
+			throw gcnew ArgumentOutOfRangeException( "prefetchBudget" );
+
+		m_File = INVALID_HANDLE_VALUE;
+		m_PrefetchBudget = prefetchBudget;
+
+		pin_ptr<const wchar_t> pinnedName = PtrToStringChars( fileName );
+		HANDLE file = CreateFile( reinterpret_cast<LPCWSTR>( pinnedName ), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL );
+
+		if( file == NULL || file == INVALID_HANDLE_VALUE )
+			throw gcnew FileNotFoundException( "Could not open the specified file.", fileName );
+
+		m_File = file;
+
+		try
+		{
+			LARGE_INTEGER size;
+			if( !GetFileSizeEx( file, &size ) || size.QuadPart == 0 )
+				throw gcnew InvalidDataException( "The file is not a wave bank." );
+
+			m_Length = size.QuadPart;
+			HANDLE mapping = CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+			void *view = mapping == NULL ? NULL : MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+			if( view == NULL )
+			{
+				if( mapping != NULL )
+					CloseHandle( mapping );
+				throw gcnew IOException( "Could not map the wave bank into memory." );
+			}
+
+			// the view belongs to a stream that every returned slice hangs off, so it is unmapped
+			// only once the file and all of its slices have let go of it
+			m_Data = gcnew DataStream( view, m_Length, true, false, gcnew MappedFile( mapping, view ) );
+			m_View = static_cast<unsigned char*>( view );
+
+			// Manual Allocation: cleaned up in the finalizer / destructor
+			m_Header = new WaveBankLayout::Header();
+
+			switch( WaveBankLayout::ReadHeader( m_View, m_Length, *m_Header ) )
+			{
+			case WaveBankLayout::Ok:
+				break;
+			case WaveBankLayout::BigEndian:
+				throw gcnew InvalidDataException( "Big-endian wave banks are not supported." );
+			case WaveBankLayout::UnsupportedVersion:
+				throw gcnew InvalidDataException( "Unsupported wave bank version." );
+			case WaveBankLayout::Truncated:
+				throw gcnew InvalidDataException( "The wave bank is truncated or corrupt." );
+			default:
+				throw gcnew InvalidDataException( "The file is not a wave bank." );
+			}
+
+			// Manual Allocation: cleaned up in the finalizer / destructor
+			m_Entries = new WaveBankLayout::Entry[m_Header->EntryCount + 1];
+			if( WaveBankLayout::ReadEntries( m_View, m_Length, *m_Header, m_Entries ) != WaveBankLayout::Ok )
+				throw gcnew InvalidDataException( "The wave bank is truncated or corrupt." );
+
+			m_Name = gcnew String( m_Header->Name );
+			m_Names = gcnew Dictionary<String^, int>( StringComparer::Ordinal );
+
+			char name[WaveBankLayout::NameLength + 1];
+			for( unsigned int i = 0; i < m_Header->EntryCount; i++ )
+			{
+				// the first of several waves with the same name wins, as with the engine
+				if( WaveBankLayout::ReadName( m_View, m_Length, *m_Header, i, name ) && name[0] != 0 )
+				{
+					String^ key = gcnew String( name );
+					if( !m_Names->ContainsKey( key ) )
+						m_Names->Add( key, i );
+				}
+			}
+		}
+		catch( Exception^ )
+		{
+			Destruct();
+			throw;
+		}
+
+		m_Lock = gcnew Object();
+		m_Pending = gcnew Queue<PrefetchRegion>();
+		m_Resident = gcnew List<PrefetchRegion>();
+		m_Wake = gcnew AutoResetEvent( false );
+		m_Idle = gcnew ManualResetEvent( true );
+	}
+
+	void WaveBankFile::Destruct()
+	{
+		if( m_Thread != nullptr )
+		{
+			Monitor::Enter( m_Lock );
+			try
+			{
+				m_Stopping = true;
+			}
+			finally
+			{
+				Monitor::Exit( m_Lock );
+			}
+
+			m_Wake->Set();
+			m_Thread->Join();
+			m_Thread = nullptr;
+		}
+
+		m_View = NULL;
+		if( m_Data != nullptr )
+		{
+			delete m_Data;
+			m_Data = nullptr;
+		}
+
+		if( m_File != INVALID_HANDLE_VALUE && m_File != NULL )
+		{
+			CloseHandle( m_File );
+			m_File = INVALID_HANDLE_VALUE;
+		}
+
+		delete m_Header;
+		delete[] m_Entries;
+		m_Header = NULL;
+		m_Entries = NULL;
+	}
+
+	void WaveBankFile::CheckIndex( int waveIndex )
+	{
+		if( m_View == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( waveIndex < 0 || static_cast<unsigned int>( waveIndex ) >= m_Header->EntryCount )
+			throw gcnew ArgumentOutOfRangeException( "waveIndex" );
+	}
+
+	int WaveBankFile::GetWaveIndex( String^ friendlyName )
+	{
+		if( m_View == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( friendlyName == nullptr )
+			throw gcnew ArgumentNullException( "friendlyName" );
+
+		int index;
+		return m_Names->TryGetValue( friendlyName, index ) ? index : -1;
+	}
+
+	WaveProperties WaveBankFile::GetWaveProperties( int waveIndex )
+	{
+		CheckIndex( waveIndex );
+
+		const WaveBankLayout::Entry &entry = m_Entries[waveIndex];
+
+		char name[WaveBankLayout::NameLength + 1];
+		WaveBankLayout::ReadName( m_View, m_Length, *m_Header, waveIndex, name );
+
+		XACT_WAVE_PROPERTIES props;
+		memset( &props, 0, sizeof( props ) );
+		strncpy( props.friendlyName, name, sizeof( props.friendlyName ) - 1 );
+		props.format.dwValue = entry.Format;
+		props.durationInSamples = entry.Duration;
+		props.loopRegion.dwStartSample = entry.LoopStart;
+		props.loopRegion.dwTotalSamples = entry.LoopLength;
+		props.streaming = ( m_Header->Flags & StreamingFlag ) ? TRUE : FALSE;
+
+		return WaveProperties( props );
+	}
+
+	WaveBankFile::PrefetchRegion WaveBankFile::GetRegion( int waveIndex, int startSample, int sampleCount )
+	{
+		CheckIndex( waveIndex );
+		if( startSample < 0 )
+			throw gcnew ArgumentOutOfRangeException( "startSample" );
+		if( sampleCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "sampleCount" );
+
+		const WaveBankLayout::Entry &entry = m_Entries[waveIndex];
+
+		unsigned int offset;
+		unsigned int bytes;
+		WaveBankLayout::FramesToBytes( entry.Format, entry.Length, startSample, sampleCount, offset, bytes );
+
+		PrefetchRegion region;
+		region.Offset = static_cast<Int64>( entry.Offset ) + offset;
+		region.Length = bytes;
+		return region;
+	}
+
+	DataStream^ WaveBankFile::GetWaveData( int waveIndex )
+	{
+		CheckIndex( waveIndex );
+
+		PrefetchRegion region;
+		region.Offset = static_cast<Int64>( m_Entries[waveIndex].Offset );
+		region.Length = m_Entries[waveIndex].Length;
+		return GetWaveData( region );
+	}
+
+	DataStream^ WaveBankFile::GetWaveData( int waveIndex, int startSample, int sampleCount )
+	{
+		return GetWaveData( GetRegion( waveIndex, startSample, sampleCount ) );
+	}
+
+	DataStream^ WaveBankFile::GetWaveData( PrefetchRegion region )
+	{
+		bool hit = false;
+
+		Monitor::Enter( m_Lock );
+		try
+		{
+			for( int i = m_Resident->Count - 1; i >= 0; i-- )
+			{
+				PrefetchRegion resident = m_Resident[i];
+				if( resident.Offset <= region.Offset && region.Offset + region.Length <= resident.Offset + resident.Length )
+				{
+					// keep recently used regions at the back, away from eviction
+					m_Resident->RemoveAt( i );
+					m_Resident->Add( resident );
+					hit = true;
+					break;
+				}
+			}
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+
+		if( hit )
+			Interlocked::Increment( m_HitCount );
+		else
+			Interlocked::Increment( m_MissCount );
+
+		return m_Data->Slice( region.Offset, region.Length );
+	}
+
+	void WaveBankFile::Prefetch( int waveIndex )
+	{
+		CheckIndex( waveIndex );
+
+		PrefetchRegion region;
+		region.Offset = static_cast<Int64>( m_Entries[waveIndex].Offset );
+		region.Length = m_Entries[waveIndex].Length;
+		Prefetch( region );
+	}
+
+	void WaveBankFile::Prefetch( int waveIndex, int startSample, int sampleCount )
+	{
+		Prefetch( GetRegion( waveIndex, startSample, sampleCount ) );
+	}
+
+	void WaveBankFile::Prefetch( PrefetchRegion region )
+	{
+		if( region.Length == 0 || m_PrefetchBudget == 0 )
+			return;
+
+		Monitor::Enter( m_Lock );
+		try
+		{
+			m_Pending->Enqueue( region );
+			m_Idle->Reset();
+
+			if( m_Thread == nullptr )
+			{
+				// the thread only holds the file weakly, so that an undisposed file can still be finalized
+				m_Thread = gcnew Thread( gcnew ParameterizedThreadStart( &WaveBankFile::Run ) );
+				m_Thread->IsBackground = true;
+				m_Thread->Name = "SlimDX wave bank prefetch";
+				m_Thread->Start( gcnew WeakReference( this ) );
+			}
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+
+		m_Wake->Set();
+	}
+
+	void WaveBankFile::Run( Object^ state )
+	{
+		WeakReference^ reference = safe_cast<WeakReference^>( state );
+		WaveBankFile^ file = safe_cast<WaveBankFile^>( reference->Target );
+		if( file == nullptr )
+			return;
+
+		SYSTEM_INFO info;
+		GetSystemInfo( &info );
+		AutoResetEvent^ wake = file->m_Wake;
+
+		while( file->Step( info.dwPageSize ) )
+		{
+			// let go of the file while waiting, so that it can be collected if nobody disposes it
+			file = nullptr;
+
+			wake->WaitOne();
+
+			file = safe_cast<WaveBankFile^>( reference->Target );
+			if( file == nullptr )
+				return;
+		}
+	}
+
+	bool WaveBankFile::Step( unsigned int pageSize )
+	{
+		// reads queued regions until the queue runs dry, then returns to wait for more
+		while( true )
+		{
+			PrefetchRegion region;
+			bool found = false;
+
+			Monitor::Enter( m_Lock );
+			try
+			{
+				if( m_Stopping )
+					return false;
+
+				if( m_Pending->Count > 0 )
+				{
+					region = m_Pending->Dequeue();
+					found = true;
+
+					// anything that was already read only needs to move to the back of the list
+					for( int i = 0; i < m_Resident->Count; i++ )
+					{
+						PrefetchRegion resident = m_Resident[i];
+						if( resident.Offset <= region.Offset && region.Offset + region.Length <= resident.Offset + resident.Length )
+						{
+							m_Resident->RemoveAt( i );
+							m_Resident->Add( resident );
+							found = false;
+							break;
+						}
+					}
+
+					if( found )
+					{
+						region.Length = Math::Min( region.Length, m_PrefetchBudget );
+
+						// release the oldest regions until the new one fits
+						while( m_Resident->Count > 0 && m_ResidentBytes + region.Length > m_PrefetchBudget )
+						{
+							PrefetchRegion oldest = m_Resident[0];
+							m_Resident->RemoveAt( 0 );
+							m_ResidentBytes -= oldest.Length;
+
+							// unlocking pages that were never locked drops them from the working set
+							VirtualUnlock( m_View + oldest.Offset, static_cast<SIZE_T>( oldest.Length ) );
+						}
+					}
+				}
+				else
+				{
+					m_Idle->Set();
+					return true;
+				}
+			}
+			finally
+			{
+				Monitor::Exit( m_Lock );
+			}
+
+			if( !found )
+				continue;
+
+			TouchPages( m_View + region.Offset, region.Length, pageSize );
+
+			Monitor::Enter( m_Lock );
+			try
+			{
+				m_Resident->Add( region );
+				m_ResidentBytes += region.Length;
+				m_PrefetchedBytes += region.Length;
+			}
+			finally
+			{
+				Monitor::Exit( m_Lock );
+			}
+		}
+	}
+
+	bool WaveBankFile::WaitForPrefetch( int millisecondsTimeout )
+	{
+		if( m_View == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		return m_Idle->WaitOne( millisecondsTimeout, false );
+	}
+
+	void WaveBankFile::ResetStatistics()
+	{
+		Monitor::Enter( m_Lock );
+		try
+		{
+			m_HitCount = 0;
+			m_MissCount = 0;
+			m_PrefetchedBytes = 0;
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+	}
+
+	int WaveBankFile::WaveCount::get()
+	{
+		if( m_View == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		return static_cast<int>( m_Header->EntryCount );
+	}
+
+	bool WaveBankFile::IsStreaming::get()
+	{
+		if( m_View == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		return ( m_Header->Flags & StreamingFlag ) != 0;
+	}
+
+	DataStream^ WaveBankFile::Data::get()
+	{
+		if( m_View == NULL )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		return m_Data->Slice( 0, m_Length );
+	}
+
+	Int64 WaveBankFile::ResidentBytes::get()
+	{
+		Monitor::Enter( m_Lock );
+		try
+		{
+			return m_ResidentBytes;
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+	}
+
+	Int64 WaveBankFile::PrefetchedBytes::get()
+	{
+		Monitor::Enter( m_Lock );
+		try
+		{
+			return m_PrefetchedBytes;
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+	}
+}
+}
@@ -0,0 +1,249 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "WaveBankLayout.h"
+#include "WaveProperties.h"
+
+namespace SlimDX
+{
+	ref class DataStream;
+
+	namespace XACT3
+	{
+		/// <summary>
+		/// A wave bank file mapped into memory, for creating in-memory wave banks without copying them and for reading
+		/// individual waves in place.
+		/// </summary>
+		/// <remarks>
+		/// <para>The header and entry table are read once when the file is opened, so waves can be looked up by index or
+		/// friendly name without the XACT engine. Pages of the file are only read from disk when they are first touched.</para>
+		/// <para>Waves that are about to be needed can be prefetched on a background thread, which reads their pages ahead
+		/// of time. At most <see cref="PrefetchBudget"/> bytes are kept resident; older prefetched regions are released
+		/// from the working set to make room for new ones. <see cref="GetWaveData(int)"/> counts a hit when the requested
+		/// data was prefetched and a miss otherwise.</para>
+		/// <para>Streams returned by <see cref="GetWaveData(int)"/> and wave banks created from the file share its mapping
+		/// without copying it. The mapping stays alive until the file and every such stream have been disposed or collected.</para>
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class WaveBankFile sealed : System::IDisposable
+		{
+		private:
+			value class PrefetchRegion
+			{
+			public:
+				System::Int64 Offset;
+				System::Int64 Length;
+			};
+
+			HANDLE m_File;
+			DataStream^ m_Data;
+			unsigned char *m_View;
+			System::Int64 m_Length;
+			WaveBankLayout::Header *m_Header;
+			WaveBankLayout::Entry *m_Entries;
+			System::String^ m_Name;
+			System::Collections::Generic::Dictionary<System::String^, int>^ m_Names;
+
+			System::Int64 m_PrefetchBudget;
+			System::Int64 m_ResidentBytes;
+			System::Int64 m_PrefetchedBytes;
+			int m_HitCount;
+			int m_MissCount;
+
+			System::Object^ m_Lock;
+			System::Collections::Generic::Queue<PrefetchRegion>^ m_Pending;
+			System::Collections::Generic::List<PrefetchRegion>^ m_Resident;
+			bool m_Busy;
+			bool m_Stopping;
+			System::Threading::AutoResetEvent^ m_Wake;
+			System::Threading::ManualResetEvent^ m_Idle;
+			System::Threading::Thread^ m_Thread;
+
+			void Open( System::String^ fileName, System::Int64 prefetchBudget );
+			void Destruct();
+			static void Run( System::Object^ state );
+			bool Step( unsigned int pageSize );
+			void CheckIndex( int waveIndex );
+			PrefetchRegion GetRegion( int waveIndex, int startSample, int sampleCount );
+			DataStream^ GetWaveData( PrefetchRegion region );
+			void Prefetch( PrefetchRegion region );
+
+		public:
+			/// <summary>
+			/// Opens and maps a wave bank file, with a prefetch budget of 64 megabytes.
+			/// </summary>
+			/// <param name="fileName">The name of the wave bank file.</param>
+			WaveBankFile( System::String^ fileName );
+
+			/// <summary>
+			/// Opens and maps a wave bank file.
+			/// </summary>
+			/// <param name="fileName">The name of the wave bank file.</param>
+			/// <param name="prefetchBudget">The largest number of prefetched bytes to keep resident.</param>
+			WaveBankFile( System::String^ fileName, System::Int64 prefetchBudget );
+
+			/// <summary>
+			/// Stops the prefetch thread and unmaps the file.
+			/// </summary>
+			~WaveBankFile() { Destruct(); }
+			!WaveBankFile() { Destruct(); }
+
+			/// <summary>
+			/// Get a wave index based on a string that represents the friendly name of the wave.
+			/// </summary>
+			/// <param name="friendlyName">A string that contains the friendly name of the wave.</param>
+			/// <returns>The index for the wave if it exists, otherwise -1.</returns>
+			int GetWaveIndex( System::String^ friendlyName );
+
+			/// <summary>
+			/// Get the properties of a wave.
+			/// </summary>
+			/// <param name="waveIndex">The index of the wave to get the properties of.</param>
+			/// <returns>A <see cref="WaveProperties"/> object containing the properties of the wave.</returns>
+			WaveProperties GetWaveProperties( int waveIndex );
+
+			/// <summary>
+			/// Gets a read-only stream over the data of a wave, without copying it.
+			/// </summary>
+			/// <param name="waveIndex">The index of the wave.</param>
+			/// <returns>A stream over the encoded data of the wave.</returns>
+			DataStream^ GetWaveData( int waveIndex );
+
+			/// <summary>
+			/// Gets a read-only stream over part of the data of a wave, without copying it.
+			/// </summary>
+			/// <param name="waveIndex">The index of the wave.</param>
+			/// <param name="startSample">The first sample of the region.</param>
+			/// <param name="sampleCount">The number of samples in the region.</param>
+			/// <returns>A stream over the encoded data holding the region, rounded out to whole blocks. Formats without
+			/// fixed blocks give the whole wave.</returns>
+			DataStream^ GetWaveData( int waveIndex, int startSample, int sampleCount );
+
+			/// <summary>
+			/// Queues a wave to be read into memory on the prefetch thread.
+			/// </summary>
+			/// <param name="waveIndex">The index of the wave.</param>
+			void Prefetch( int waveIndex );
+
+			/// <summary>
+			/// Queues part of a wave to be read into memory on the prefetch thread.
+			/// </summary>
+			/// <param name="waveIndex">The index of the wave.</param>
+			/// <param name="startSample">The first sample of the region.</param>
+			/// <param name="sampleCount">The number of samples in the region.</param>
+			void Prefetch( int waveIndex, int startSample, int sampleCount );
+
+			/// <summary>
+			/// Waits until every queued prefetch has been read.
+			/// </summary>
+			/// <param name="millisecondsTimeout">The longest time to wait, or -1 to wait indefinitely.</param>
+			/// <returns><c>true</c> if the prefetch queue is empty; otherwise, <c>false</c>.</returns>
+			bool WaitForPrefetch( int millisecondsTimeout );
+
+			/// <summary>
+			/// Resets the prefetch hit and miss counts and the prefetched byte count.
+			/// </summary>
+			void ResetStatistics();
+
+			/// <summary>
+			/// Gets the name of the wave bank.
+			/// </summary>
+			property System::String^ Name
+			{
+				System::String^ get() { return m_Name; }
+			}
+
+			/// <summary>
+			/// Gets the number of waves in the bank.
+			/// </summary>
+			property int WaveCount
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets a value indicating whether the bank was built for streaming.
+			/// </summary>
+			property bool IsStreaming
+			{
+				bool get();
+			}
+
+			/// <summary>
+			/// Gets the length of the file, in bytes.
+			/// </summary>
+			property System::Int64 Length
+			{
+				System::Int64 get() { return m_Length; }
+			}
+
+			/// <summary>
+			/// Gets a read-only stream over the whole mapped file, without copying it. Each call returns a new stream.
+			/// </summary>
+			property DataStream^ Data
+			{
+				DataStream^ get();
+			}
+
+			/// <summary>
+			/// Gets the largest number of prefetched bytes kept resident.
+			/// </summary>
+			property System::Int64 PrefetchBudget
+			{
+				System::Int64 get() { return m_PrefetchBudget; }
+			}
+
+			/// <summary>
+			/// Gets the number of prefetched bytes currently counted as resident.
+			/// </summary>
+			property System::Int64 ResidentBytes
+			{
+				System::Int64 get();
+			}
+
+			/// <summary>
+			/// Gets the total number of bytes read by the prefetch thread.
+			/// </summary>
+			property System::Int64 PrefetchedBytes
+			{
+				System::Int64 get();
+			}
+
+			/// <summary>
+			/// Gets the number of wave data requests that were already prefetched.
+			/// </summary>
+			property int PrefetchHitCount
+			{
+				int get() { return System::Threading::Thread::VolatileRead( m_HitCount ); }
+			}
+
+			/// <summary>
+			/// Gets the number of wave data requests that had not been prefetched.
+			/// </summary>
+			property int PrefetchMissCount
+			{
+				int get() { return System::Threading::Thread::VolatileRead( m_MissCount ); }
+			}
+		};
+	}
+}
@@ -0,0 +1,286 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include "stdafx.h"
+
+#include <string.h>
+
+#include "WaveBankLayout.h"
+
+#ifdef _MANAGED
+#pragma managed(push, off)
+#endif
+
+namespace SlimDX
+{
+namespace XACT3
+{
+namespace WaveBankLayout
+{
+	namespace
+	{
+		// "WBND" as read from a little-endian bank, and as read from a big-endian one.
+		const unsigned int Signature = 0x444E4257;
+		const unsigned int SwappedSignature = 0x57424E44;
+		const unsigned int HeaderVersion = 44;
+		const unsigned int HeaderSize = 12 + 5 * 8;
+		const unsigned int BankDataSize = 96;
+
+		const unsigned int CompactFlag = 0x00020000;
+		const unsigned int EntryNamesFlag = 0x00010000;
+		const unsigned int FullEntrySize = 24;
+
+		const unsigned int SegmentBankData = 0;
+		const unsigned int SegmentMetaData = 1;
+		const unsigned int SegmentNames = 3;
+		const unsigned int SegmentWaveData = 4;
+
+		const unsigned int TagPcm = 0;
+		const unsigned int TagAdpcm = 2;
+		const unsigned int AdpcmBlockAlignOffset = 22;
+
+		unsigned int ReadUInt( const unsigned char *p )
+		{
+			return p[0] | ( p[1] << 8 ) | ( p[2] << 16 ) | ( static_cast<unsigned int>( p[3] ) << 24 );
+		}
+
+		bool Fits( unsigned long long offset, unsigned long long length, unsigned long long size )
+		{
+			return offset <= size && length <= size - offset;
+		}
+	}
+
+	unsigned int FormatTag( unsigned int format )
+	{
+		return format & 0x3;
+	}
+
+	unsigned int FormatChannels( unsigned int format )
+	{
+		return ( format >> 2 ) & 0x7;
+	}
+
+	unsigned int FormatSampleRate( unsigned int format )
+	{
+		return ( format >> 5 ) & 0x3FFFF;
+	}
+
+	unsigned int BlockSize( unsigned int format )
+	{
+		unsigned int channels = FormatChannels( format );
+		unsigned int blockAlign = ( format >> 23 ) & 0xFF;
+
+		switch( FormatTag( format ) )
+		{
+		case TagPcm:
+			return channels * ( ( format >> 31 ) ? 2 : 1 );
+		case TagAdpcm:
+			return ( blockAlign + AdpcmBlockAlignOffset ) * channels;
+		default:
+			return 0;
+		}
+	}
+
+	unsigned int FramesPerBlock( unsigned int format )
+	{
+		unsigned int channels = FormatChannels( format );
+		unsigned int size = BlockSize( format );
+		if( size == 0 || channels == 0 )
+			return 0;
+
+		if( FormatTag( format ) == TagAdpcm )
+			return ( size - 7 * channels ) * 2 / channels + 2;
+
+		return 1;
+	}
+
+	unsigned int DurationOf( unsigned int format, unsigned int length )
+	{
+		unsigned int size = BlockSize( format );
+		if( size == 0 )
+			return 0;
+
+		return ( length / size ) * FramesPerBlock( format );
+	}
+
+	void FramesToBytes( unsigned int format, unsigned int length, unsigned int startFrame, unsigned int frameCount, unsigned int &offset, unsigned int &bytes )
+	{
+		unsigned int size = BlockSize( format );
+		unsigned int frames = FramesPerBlock( format );
+		if( size == 0 || frames == 0 )
+		{
+			offset = 0;
+			bytes = length;
+			return;
+		}
+
+		unsigned long long first = static_cast<unsigned long long>( startFrame / frames ) * size;
+		unsigned long long last = ( ( static_cast<unsigned long long>( startFrame ) + frameCount + frames - 1 ) / frames ) * size;
+		if( last > length )
+			last = length;
+		if( first > last )
+			first = last;
+
+		offset = static_cast<unsigned int>( first );
+		bytes = static_cast<unsigned int>( last - first );
+	}
+
+	Status ReadHeader( const unsigned char *data, unsigned long long size, Header &header )
+	{
+		memset( &header, 0, sizeof( header ) );
+
+		if( size < 4 )
+			return NotAWaveBank;
+
+		unsigned int signature = ReadUInt( data );
+		if( signature == SwappedSignature )
+			return BigEndian;
+		if( signature != Signature )
+			return NotAWaveBank;
+		if( size < HeaderSize )
+			return Truncated;
+		if( ReadUInt( data + 8 ) != HeaderVersion )
+			return UnsupportedVersion;
+
+		header.ContentVersion = ReadUInt( data + 4 );
+
+		unsigned long long offsets[5];
+		unsigned long long lengths[5];
+		for( int i = 0; i < 5; i++ )
+		{
+			offsets[i] = ReadUInt( data + 12 + i * 8 );
+			lengths[i] = ReadUInt( data + 16 + i * 8 );
+		}
+
+		if( lengths[SegmentBankData] < BankDataSize || !Fits( offsets[SegmentBankData], BankDataSize, size ) )
+			return Truncated;
+
+		const unsigned char *bank = data + offsets[SegmentBankData];
+		header.Flags = ReadUInt( bank );
+		header.EntryCount = ReadUInt( bank + 4 );
+		memcpy( header.Name, bank + 8, NameLength );
+		header.Name[NameLength] = 0;
+		header.MetaDataElementSize = ReadUInt( bank + 72 );
+		header.NameElementSize = ReadUInt( bank + 76 );
+		header.Alignment = ReadUInt( bank + 80 );
+		header.CompactFormat = ReadUInt( bank + 84 );
+
+		header.MetaDataOffset = offsets[SegmentMetaData];
+		header.DataOffset = offsets[SegmentWaveData];
+		header.DataLength = lengths[SegmentWaveData];
+
+		if( ( header.Flags & EntryNamesFlag ) && header.NameElementSize > 0 && lengths[SegmentNames] > 0 )
+		{
+			header.NamesOffset = offsets[SegmentNames];
+			if( !Fits( header.NamesOffset, static_cast<unsigned long long>( header.NameElementSize ) * header.EntryCount, size ) )
+				return Truncated;
+		}
+		else
+			header.NameElementSize = 0;
+
+		if( header.MetaDataElementSize == 0 )
+			header.MetaDataElementSize = ( header.Flags & CompactFlag ) ? 4 : FullEntrySize;
+		if( ( header.Flags & CompactFlag ) == 0 && header.MetaDataElementSize < 16 )
+			return UnsupportedVersion;
+
+		if( !Fits( header.MetaDataOffset, static_cast<unsigned long long>( header.MetaDataElementSize ) * header.EntryCount, size ) ||
+			!Fits( header.DataOffset, header.DataLength, size ) )
+			return Truncated;
+
+		return Ok;
+	}
+
+	Status ReadEntries( const unsigned char *data, unsigned long long size, const Header &header, Entry *entries )
+	{
+		const unsigned char *table = data + header.MetaDataOffset;
+
+		if( header.Flags & CompactFlag )
+		{
+			unsigned long long alignment = header.Alignment == 0 ? 1 : header.Alignment;
+
+			for( unsigned int i = 0; i < header.EntryCount; i++ )
+			{
+				unsigned int packed = ReadUInt( table + i * header.MetaDataElementSize );
+				unsigned long long offset = ( packed & 0x1FFFFF ) * alignment;
+				unsigned long long end = header.DataLength;
+				if( i + 1 < header.EntryCount )
+					end = ( ReadUInt( table + ( i + 1 ) * header.MetaDataElementSize ) & 0x1FFFFF ) * alignment;
+
+				unsigned long long deviation = packed >> 21;
+				if( end < offset + deviation || end > header.DataLength )
+					return Truncated;
+
+				Entry &entry = entries[i];
+				memset( &entry, 0, sizeof( entry ) );
+				entry.Format = header.CompactFormat;
+				entry.Offset = header.DataOffset + offset;
+				entry.Length = static_cast<unsigned int>( end - offset - deviation );
+				entry.Duration = DurationOf( entry.Format, entry.Length );
+			}
+
+			return Ok;
+		}
+
+		for( unsigned int i = 0; i < header.EntryCount; i++ )
+		{
+			unsigned char raw[FullEntrySize];
+			memset( raw, 0, sizeof( raw ) );
+			memcpy( raw, table + i * header.MetaDataElementSize, header.MetaDataElementSize < FullEntrySize ? header.MetaDataElementSize : FullEntrySize );
+
+			Entry &entry = entries[i];
+			unsigned int flagsAndDuration = ReadUInt( raw );
+			entry.Flags = flagsAndDuration & 0xF;
+			entry.Duration = flagsAndDuration >> 4;
+			entry.Format = ReadUInt( raw + 4 );
+			entry.Offset = header.DataOffset + ReadUInt( raw + 8 );
+			entry.Length = ReadUInt( raw + 12 );
+			entry.LoopStart = ReadUInt( raw + 16 );
+			entry.LoopLength = ReadUInt( raw + 20 );
+
+			if( !Fits( entry.Offset, entry.Length, size ) || entry.Offset + entry.Length > header.DataOffset + header.DataLength )
+				return Truncated;
+		}
+
+		return Ok;
+	}
+
+	bool ReadName( const unsigned char *data, unsigned long long size, const Header &header, unsigned int index, char *name )
+	{
+		name[0] = 0;
+		if( header.NameElementSize == 0 || index >= header.EntryCount )
+			return false;
+
+		unsigned long long offset = header.NamesOffset + static_cast<unsigned long long>( index ) * header.NameElementSize;
+		if( !Fits( offset, header.NameElementSize, size ) )
+			return false;
+
+		unsigned int length = header.NameElementSize < NameLength ? header.NameElementSize : NameLength;
+		memcpy( name, data + offset, length );
+		name[length] = 0;
+		return true;
+	}
+}
+}
+}
+
+#ifdef _MANAGED
+#pragma managed(pop)
+#endif
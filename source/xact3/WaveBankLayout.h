@@ -0,0 +1,101 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+// Reads the header and entry table of an XACT wave bank (.xwb) straight from its bytes, so that a mapped bank
+// can be indexed without going through the engine. Only little-endian (Windows) banks are understood. Nothing
+// in here depends on Windows or the CLR.
+namespace SlimDX
+{
+	namespace XACT3
+	{
+		namespace WaveBankLayout
+		{
+			const unsigned int NameLength = 64;
+
+			enum Status
+			{
+				Ok,
+				NotAWaveBank,
+				BigEndian,
+				UnsupportedVersion,
+				Truncated
+			};
+
+			struct Header
+			{
+				unsigned int ContentVersion;
+				unsigned int Flags;
+				unsigned int EntryCount;
+				char Name[NameLength + 1];
+				unsigned int Alignment;
+				unsigned int CompactFormat;
+
+				unsigned long long MetaDataOffset;
+				unsigned int MetaDataElementSize;
+				unsigned long long NamesOffset;
+				unsigned int NameElementSize;
+				unsigned long long DataOffset;
+				unsigned long long DataLength;
+			};
+
+			// One wave, with its play region resolved to an offset from the start of the file.
+			struct Entry
+			{
+				unsigned int Flags;
+				unsigned int Duration;
+				unsigned int Format;
+				unsigned long long Offset;
+				unsigned int Length;
+				unsigned int LoopStart;
+				unsigned int LoopLength;
+			};
+
+			Status ReadHeader( const unsigned char *data, unsigned long long size, Header &header );
+
+			// Fills header.EntryCount entries. Compact entries take the bank's compact format and have their
+			// length and duration worked out from their neighbours.
+			Status ReadEntries( const unsigned char *data, unsigned long long size, const Header &header, Entry *entries );
+
+			// Copies the friendly name of an entry into a buffer of NameLength + 1 characters. Returns false, leaving
+			// the buffer empty, if the bank carries no names.
+			bool ReadName( const unsigned char *data, unsigned long long size, const Header &header, unsigned int index, char *name );
+
+			// Unpacks the fields of a packed mini wave format.
+			unsigned int FormatTag( unsigned int format );
+			unsigned int FormatChannels( unsigned int format );
+			unsigned int FormatSampleRate( unsigned int format );
+
+			// The number of bytes in an aligned block of the format and the frames it holds, or 0 for formats
+			// (xWMA and XMA) whose blocks cannot be located without a seek table.
+			unsigned int BlockSize( unsigned int format );
+			unsigned int FramesPerBlock( unsigned int format );
+
+			// The frames held by the given number of bytes of the format, or 0 if it cannot be known from the length.
+			unsigned int DurationOf( unsigned int format, unsigned int length );
+
+			// The bytes of a wave of the given length that hold a run of frames, rounded out to whole blocks. Formats
+			// without fixed blocks give the whole wave.
+			void FramesToBytes( unsigned int format, unsigned int length, unsigned int startFrame, unsigned int frameCount, unsigned int &offset, unsigned int &bytes );
+		}
+	}
+}
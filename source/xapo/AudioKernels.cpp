@@ -0,0 +1,145 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "DspKernels.h"
+#include "AudioKernels.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace XAPO
+{
+	void AudioKernels::CheckChannels( int channels, String^ name )
+	{
+		if( channels < 1 || channels > static_cast<int>( Dsp::MaxChannels ) )
+			throw gcnew ArgumentOutOfRangeException( name );
+	}
+
+	void AudioKernels::CheckBuffer( IntPtr buffer, String^ name )
+	{
+		if( buffer == IntPtr::Zero )
+			throw gcnew ArgumentNullException( name );
+	}
+
+	void AudioKernels::ApplyGain( IntPtr buffer, int channels, int frameCount, float startGain, float endGain )
+	{
+		CheckBuffer( buffer, "buffer" );
+		CheckChannels( channels, "channels" );
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+
+		Dsp::ApplyGainRamp( static_cast<float*>( buffer.ToPointer() ), channels, frameCount, startGain, endGain );
+	}
+
+	void AudioKernels::MixWithGain( IntPtr source, IntPtr destination, int channels, int frameCount, float startGain, float endGain )
+	{
+		CheckBuffer( source, "source" );
+		CheckBuffer( destination, "destination" );
+		CheckChannels( channels, "channels" );
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+
+		Dsp::MixGainRamp( static_cast<float*>( source.ToPointer() ), static_cast<float*>( destination.ToPointer() ), channels, frameCount, startGain, endGain );
+	}
+
+	void AudioKernels::MixMatrix( IntPtr source, int sourceChannels, IntPtr destination, int destinationChannels, int frameCount, array<float>^ matrix, bool mixWithDestination )
+	{
+		CheckBuffer( source, "source" );
+		CheckBuffer( destination, "destination" );
+		CheckChannels( sourceChannels, "sourceChannels" );
+		CheckChannels( destinationChannels, "destinationChannels" );
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+		if( matrix == nullptr )
+			throw gcnew ArgumentNullException( "matrix" );
+		if( matrix->Length < sourceChannels * destinationChannels )
+			throw gcnew ArgumentException( "The matrix must hold sourceChannels * destinationChannels levels.", "matrix" );
+
+		pin_ptr<float> pinnedMatrix = &matrix[0];
+		Dsp::MixMatrix( static_cast<float*>( source.ToPointer() ), sourceChannels, static_cast<float*>( destination.ToPointer() ), destinationChannels, frameCount, pinnedMatrix, mixWithDestination );
+	}
+
+	void AudioKernels::MeasureLevels( IntPtr buffer, int channels, int frameCount, array<float>^ peaks, array<float>^ rms )
+	{
+		CheckBuffer( buffer, "buffer" );
+		CheckChannels( channels, "channels" );
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+		if( peaks == nullptr )
+			throw gcnew ArgumentNullException( "peaks" );
+		if( rms == nullptr )
+			throw gcnew ArgumentNullException( "rms" );
+		if( peaks->Length < channels )
+			throw gcnew ArgumentException( "The array must hold one value per channel.", "peaks" );
+		if( rms->Length < channels )
+			throw gcnew ArgumentException( "The array must hold one value per channel.", "rms" );
+
+		pin_ptr<float> pinnedPeaks = &peaks[0];
+		pin_ptr<float> pinnedRms = &rms[0];
+		Dsp::MeasureLevels( static_cast<float*>( buffer.ToPointer() ), channels, frameCount, pinnedPeaks, pinnedRms );
+	}
+
+	void AudioKernels::Deinterleave( IntPtr source, int channels, int frameCount, array<IntPtr>^ destinations )
+	{
+		CheckBuffer( source, "source" );
+		CheckChannels( channels, "channels" );
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+		if( destinations == nullptr )
+			throw gcnew ArgumentNullException( "destinations" );
+		if( destinations->Length < channels )
+			throw gcnew ArgumentException( "There must be one buffer per channel.", "destinations" );
+
+		float *planes[Dsp::MaxChannels];
+		for( int i = 0; i < channels; i++ )
+		{
+			CheckBuffer( destinations[i], "destinations" );
+			planes[i] = static_cast<float*>( destinations[i].ToPointer() );
+		}
+
+		Dsp::Deinterleave( static_cast<float*>( source.ToPointer() ), channels, frameCount, planes );
+	}
+
+	void AudioKernels::Interleave( array<IntPtr>^ sources, int channels, int frameCount, IntPtr destination )
+	{
+		CheckBuffer( destination, "destination" );
+		CheckChannels( channels, "channels" );
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+		if( sources == nullptr )
+			throw gcnew ArgumentNullException( "sources" );
+		if( sources->Length < channels )
+			throw gcnew ArgumentException( "There must be one buffer per channel.", "sources" );
+
+		const float *planes[Dsp::MaxChannels];
+		for( int i = 0; i < channels; i++ )
+		{
+			CheckBuffer( sources[i], "sources" );
+			planes[i] = static_cast<const float*>( sources[i].ToPointer() );
+		}
+
+		Dsp::Interleave( planes, channels, frameCount, static_cast<float*>( destination.ToPointer() ) );
+	}
+}
+}
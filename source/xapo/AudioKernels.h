@@ -0,0 +1,109 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	namespace XAPO
+	{
+		/// <summary>
+		/// Vectorized kernels for processing the interleaved 32-bit float buffers handed to audio processors.
+		/// </summary>
+		/// <remarks>
+		/// The kernels do not allocate, so they are safe to call from <see cref="BaseProcessor::Process"/>.
+		/// Buffers are given as raw pointers, typically <see cref="BufferParameter::Buffer"/>.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class AudioKernels sealed
+		{
+		private:
+			AudioKernels() { }
+
+		internal:
+			static void CheckChannels( int channels, System::String^ name );
+			static void CheckBuffer( System::IntPtr buffer, System::String^ name );
+
+		public:
+			/// <summary>
+			/// Scales a buffer in place, ramping the gain linearly from one value towards another.
+			/// </summary>
+			/// <param name="buffer">The interleaved samples to scale.</param>
+			/// <param name="channels">The number of channels in the buffer.</param>
+			/// <param name="frameCount">The number of frames to process.</param>
+			/// <param name="startGain">The gain applied to the first frame.</param>
+			/// <param name="endGain">The gain the ramp reaches at the frame after the last, so consecutive ramps join up.</param>
+			static void ApplyGain( System::IntPtr buffer, int channels, int frameCount, float startGain, float endGain );
+
+			/// <summary>
+			/// Adds a gain-ramped copy of one buffer to another.
+			/// </summary>
+			/// <param name="source">The interleaved samples to mix in.</param>
+			/// <param name="destination">The interleaved samples to mix into.</param>
+			/// <param name="channels">The number of channels in both buffers.</param>
+			/// <param name="frameCount">The number of frames to process.</param>
+			/// <param name="startGain">The gain applied to the first frame.</param>
+			/// <param name="endGain">The gain the ramp reaches at the frame after the last.</param>
+			static void MixWithGain( System::IntPtr source, System::IntPtr destination, int channels, int frameCount, float startGain, float endGain );
+
+			/// <summary>
+			/// Up- or down-mixes a buffer through a level matrix.
+			/// </summary>
+			/// <param name="source">The interleaved samples to read. Must not overlap <paramref name="destination"/>.</param>
+			/// <param name="sourceChannels">The number of channels in the source.</param>
+			/// <param name="destination">The interleaved samples to write.</param>
+			/// <param name="destinationChannels">The number of channels in the destination.</param>
+			/// <param name="frameCount">The number of frames to process.</param>
+			/// <param name="matrix">The levels, laid out like a voice output matrix: the level from source channel <c>s</c>
+			/// to destination channel <c>d</c> is at <c>d * sourceChannels + s</c>.</param>
+			/// <param name="mixWithDestination"><c>true</c> to add to the existing destination samples; <c>false</c> to overwrite them.</param>
+			static void MixMatrix( System::IntPtr source, int sourceChannels, System::IntPtr destination, int destinationChannels, int frameCount, array<float>^ matrix, bool mixWithDestination );
+
+			/// <summary>
+			/// Measures the peak and RMS level of each channel in a buffer.
+			/// </summary>
+			/// <param name="buffer">The interleaved samples to measure.</param>
+			/// <param name="channels">The number of channels in the buffer.</param>
+			/// <param name="frameCount">The number of frames to measure.</param>
+			/// <param name="peaks">Receives the absolute peak of each channel.</param>
+			/// <param name="rms">Receives the RMS level of each channel.</param>
+			static void MeasureLevels( System::IntPtr buffer, int channels, int frameCount, array<float>^ peaks, array<float>^ rms );
+
+			/// <summary>
+			/// Splits an interleaved buffer into one buffer per channel.
+			/// </summary>
+			/// <param name="source">The interleaved samples.</param>
+			/// <param name="channels">The number of channels.</param>
+			/// <param name="frameCount">The number of frames to convert.</param>
+			/// <param name="destinations">One buffer per channel, each holding at least <paramref name="frameCount"/> samples.</param>
+			static void Deinterleave( System::IntPtr source, int channels, int frameCount, array<System::IntPtr>^ destinations );
+
+			/// <summary>
+			/// Merges one buffer per channel into an interleaved buffer.
+			/// </summary>
+			/// <param name="sources">One buffer per channel, each holding at least <paramref name="frameCount"/> samples.</param>
+			/// <param name="channels">The number of channels.</param>
+			/// <param name="frameCount">The number of frames to convert.</param>
+			/// <param name="destination">The interleaved samples.</param>
+			static void Interleave( array<System::IntPtr>^ sources, int channels, int frameCount, System::IntPtr destination );
+		};
+	}
+}
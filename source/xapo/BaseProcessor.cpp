@@ -342,6 +342,10 @@ namespace XAPO
 		{
 			try
 			{
+				// Process runs on the audio thread and must not allocate, so size its parameter arrays here
+				m_inputParameters = gcnew array<BufferParameter>( InputLockedParameterCount );
+				m_outputParameters = gcnew array<BufferParameter>( OutputLockedParameterCount );
+
 				array<LockParameter>^ input = gcnew array<LockParameter>( InputLockedParameterCount );
 				for( int i = 0; i < input->Length; i++ )
 				{
@@ -381,29 +385,28 @@ namespace XAPO
 	{
 		try
 		{
-			array<BufferParameter>^ input = gcnew array<BufferParameter>( InputProcessParameterCount );
-			for( int i = 0; i < input->Length; i++ )
-			{
-				BufferParameter p;
-				p.Buffer = IntPtr( pInputProcessParameters[i].pBuffer );
-				p.Flags = static_cast<BufferFlags>( pInputProcessParameters[i].BufferFlags );
-				p.ValidFrameCount = pInputProcessParameters[i].ValidFrameCount;
+			array<BufferParameter>^ input = m_inputParameters;
+			array<BufferParameter>^ output = m_outputParameters;
 
-				input[i] = p;
+			// the engine always locks first; these only allocate if it was bypassed
+			if( input == nullptr || input->Length != static_cast<int>( InputProcessParameterCount ) )
+			{
+				input = gcnew array<BufferParameter>( InputProcessParameterCount );
+				m_inputParameters = input;
 			}
 
-			array<BufferParameter>^ output = gcnew array<BufferParameter>( OutputProcessParameterCount );
-			for( int i = 0; i < output->Length; i++ )
+			if( output == nullptr || output->Length != static_cast<int>( OutputProcessParameterCount ) )
 			{
-				BufferParameter p;
-				p.Buffer = IntPtr( pOutputProcessParameters[i].pBuffer );
-				p.Flags = static_cast<BufferFlags>( pOutputProcessParameters[i].BufferFlags );
-				p.ValidFrameCount = pOutputProcessParameters[i].ValidFrameCount;
-
-				output[i] = p;
+				output = gcnew array<BufferParameter>( OutputProcessParameterCount );
+				m_outputParameters = output;
 			}
 
+			BufferParameter::FromUnmanaged( input, pInputProcessParameters );
+			BufferParameter::FromUnmanaged( output, pOutputProcessParameters );
+
 			m_processor->Process( input, output, IsEnabled > 0 );
+
+			BufferParameter::ToUnmanaged( output, pOutputProcessParameters );
 		}
 		catch(...)
 		{
@@ -76,6 +76,8 @@ namespace SlimDX
 		{
 		private:
 			gcroot<BaseProcessor^> m_processor;
+			gcroot<array<BufferParameter>^> m_inputParameters;
+			gcroot<array<BufferParameter>^> m_outputParameters;
 			XAPO_REGISTRATION_PROPERTIES *pProperties;
 
 		public:
@@ -0,0 +1,173 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <math.h>
+
+#include "DspKernels.h"
+#include "AudioKernels.h"
+#include "BiquadFilter.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace XAPO
+{
+	BiquadFilter::BiquadFilter( int channels, int stageCount )
+	{
+		AudioKernels::CheckChannels( channels, "channels" );
+		if( stageCount < 1 )
+			throw gcnew ArgumentOutOfRangeException( "stageCount" );
+
+		m_Channels = channels;
+		m_StageCount = stageCount;
+
+		// Manual Allocation: this is fine
+		m_Stages = new Dsp::BiquadStage[stageCount];
+		m_State = new float[stageCount * channels * 2];
+		GC::AddMemoryPressure( stageCount * (sizeof(Dsp::BiquadStage) + channels * 2 * sizeof(float)) );
+
+		for( int i = 0; i < stageCount; i++ )
+			SetCoefficients( i, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f );
+
+		Reset();
+	}
+
+	BiquadFilter::~BiquadFilter()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	BiquadFilter::!BiquadFilter()
+	{
+		Destruct();
+	}
+
+	void BiquadFilter::Destruct()
+	{
+		if( m_Stages != 0 )
+		{
+			delete[] m_Stages;
+			delete[] m_State;
+			GC::RemoveMemoryPressure( m_StageCount * (sizeof(Dsp::BiquadStage) + m_Channels * 2 * sizeof(float)) );
+
+			m_Stages = 0;
+			m_State = 0;
+		}
+	}
+
+	void BiquadFilter::CheckStage( int stage )
+	{
+		if( m_Stages == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		if( stage < 0 || stage >= m_StageCount )
+			throw gcnew ArgumentOutOfRangeException( "stage" );
+	}
+
+	void BiquadFilter::CheckDesign( int stage, float sampleRate, float frequency, float q )
+	{
+		CheckStage( stage );
+
+		// written so that NaN fails every check; a zero q or a frequency at Nyquist would produce infinite coefficients
+		if( !(sampleRate > 0.0f) )
+			throw gcnew ArgumentOutOfRangeException( "sampleRate" );
+		if( !(frequency > 0.0f && frequency < sampleRate / 2.0f) )
+			throw gcnew ArgumentOutOfRangeException( "frequency" );
+		if( !(q > 0.0f) )
+			throw gcnew ArgumentOutOfRangeException( "q" );
+	}
+
+	void BiquadFilter::SetCoefficients( int stage, float b0, float b1, float b2, float a1, float a2 )
+	{
+		CheckStage( stage );
+
+		Dsp::BiquadStage &section = m_Stages[stage];
+		section.B0 = b0;
+		section.B1 = b1;
+		section.B2 = b2;
+		section.A1 = a1;
+		section.A2 = a2;
+	}
+
+	// coefficient formulas follow the RBJ audio EQ cookbook
+	void BiquadFilter::SetLowPass( int stage, float sampleRate, float frequency, float q )
+	{
+		CheckDesign( stage, sampleRate, frequency, q );
+
+		double w0 = 2.0 * Math::PI * frequency / sampleRate;
+		double alpha = sin( w0 ) / (2.0 * q);
+		double c = cos( w0 );
+		double a0 = 1.0 + alpha;
+
+		SetCoefficients( stage, static_cast<float>( (1.0 - c) / 2.0 / a0 ), static_cast<float>( (1.0 - c) / a0 ), static_cast<float>( (1.0 - c) / 2.0 / a0 ),
+			static_cast<float>( -2.0 * c / a0 ), static_cast<float>( (1.0 - alpha) / a0 ) );
+	}
+
+	void BiquadFilter::SetHighPass( int stage, float sampleRate, float frequency, float q )
+	{
+		CheckDesign( stage, sampleRate, frequency, q );
+
+		double w0 = 2.0 * Math::PI * frequency / sampleRate;
+		double alpha = sin( w0 ) / (2.0 * q);
+		double c = cos( w0 );
+		double a0 = 1.0 + alpha;
+
+		SetCoefficients( stage, static_cast<float>( (1.0 + c) / 2.0 / a0 ), static_cast<float>( -(1.0 + c) / a0 ), static_cast<float>( (1.0 + c) / 2.0 / a0 ),
+			static_cast<float>( -2.0 * c / a0 ), static_cast<float>( (1.0 - alpha) / a0 ) );
+	}
+
+	void BiquadFilter::SetPeaking( int stage, float sampleRate, float frequency, float q, float gain )
+	{
+		CheckDesign( stage, sampleRate, frequency, q );
+
+		double a = pow( 10.0, gain / 40.0 );
+		double w0 = 2.0 * Math::PI * frequency / sampleRate;
+		double alpha = sin( w0 ) / (2.0 * q);
+		double c = cos( w0 );
+		double a0 = 1.0 + alpha / a;
+
+		SetCoefficients( stage, static_cast<float>( (1.0 + alpha * a) / a0 ), static_cast<float>( -2.0 * c / a0 ), static_cast<float>( (1.0 - alpha * a) / a0 ),
+			static_cast<float>( -2.0 * c / a0 ), static_cast<float>( (1.0 - alpha / a) / a0 ) );
+	}
+
+	void BiquadFilter::Process( IntPtr buffer, int frameCount )
+	{
+		if( m_Stages == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		AudioKernels::CheckBuffer( buffer, "buffer" );
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+
+		Dsp::ProcessBiquads( static_cast<float*>( buffer.ToPointer() ), m_Channels, frameCount, m_Stages, m_StageCount, m_State );
+	}
+
+	void BiquadFilter::Reset()
+	{
+		if( m_Stages == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		memset( m_State, 0, m_StageCount * m_Channels * 2 * sizeof(float) );
+	}
+}
+}
@@ -0,0 +1,145 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	namespace XAPO
+	{
+		namespace Dsp
+		{
+			struct BiquadStage;
+		}
+
+		/// <summary>
+		/// A cascade of second-order IIR filter sections applied to interleaved float samples.
+		/// </summary>
+		/// <remarks>
+		/// Each channel keeps its own filter state between calls to <see cref="Process"/>, which does not allocate.
+		/// New stages pass audio through unchanged until their coefficients are set.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class BiquadFilter : System::IDisposable
+		{
+		private:
+			Dsp::BiquadStage *m_Stages;
+			float *m_State;
+			int m_Channels;
+			int m_StageCount;
+
+			void Destruct();
+			void CheckStage( int stage );
+			void CheckDesign( int stage, float sampleRate, float frequency, float q );
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="BiquadFilter"/> class.
+			/// </summary>
+			/// <param name="channels">The number of interleaved channels to filter.</param>
+			/// <param name="stageCount">The number of cascaded sections.</param>
+			BiquadFilter( int channels, int stageCount );
+
+			/// <summary>
+			/// Releases the filter state.
+			/// </summary>
+			~BiquadFilter();
+
+			/// <summary>
+			/// Releases the filter state.
+			/// </summary>
+			!BiquadFilter();
+
+			/// <summary>
+			/// Sets the coefficients of a section, normalized so that a0 is 1.
+			/// </summary>
+			/// <param name="stage">The index of the section.</param>
+			/// <param name="b0">The b0 coefficient.</param>
+			/// <param name="b1">The b1 coefficient.</param>
+			/// <param name="b2">The b2 coefficient.</param>
+			/// <param name="a1">The a1 coefficient.</param>
+			/// <param name="a2">The a2 coefficient.</param>
+			void SetCoefficients( int stage, float b0, float b1, float b2, float a1, float a2 );
+
+			/// <summary>
+			/// Configures a section as a low-pass filter.
+			/// </summary>
+			/// <param name="stage">The index of the section.</param>
+			/// <param name="sampleRate">The sample rate of the audio, in hertz.</param>
+			/// <param name="frequency">The cutoff frequency, in hertz.</param>
+			/// <param name="q">The quality factor of the section.</param>
+			/// <exception cref="System::ArgumentOutOfRangeException"><paramref name="sampleRate"/> is not positive, <paramref name="frequency"/> is not
+			/// between zero and half the sample rate, or <paramref name="q"/> is not positive.</exception>
+			void SetLowPass( int stage, float sampleRate, float frequency, float q );
+
+			/// <summary>
+			/// Configures a section as a high-pass filter.
+			/// </summary>
+			/// <param name="stage">The index of the section.</param>
+			/// <param name="sampleRate">The sample rate of the audio, in hertz.</param>
+			/// <param name="frequency">The cutoff frequency, in hertz.</param>
+			/// <param name="q">The quality factor of the section.</param>
+			/// <exception cref="System::ArgumentOutOfRangeException"><paramref name="sampleRate"/> is not positive, <paramref name="frequency"/> is not
+			/// between zero and half the sample rate, or <paramref name="q"/> is not positive.</exception>
+			void SetHighPass( int stage, float sampleRate, float frequency, float q );
+
+			/// <summary>
+			/// Configures a section as a peaking equalizer band.
+			/// </summary>
+			/// <param name="stage">The index of the section.</param>
+			/// <param name="sampleRate">The sample rate of the audio, in hertz.</param>
+			/// <param name="frequency">The center frequency, in hertz.</param>
+			/// <param name="q">The quality factor of the band.</param>
+			/// <param name="gain">The gain at the center frequency, in decibels.</param>
+			/// <exception cref="System::ArgumentOutOfRangeException"><paramref name="sampleRate"/> is not positive, <paramref name="frequency"/> is not
+			/// between zero and half the sample rate, or <paramref name="q"/> is not positive.</exception>
+			void SetPeaking( int stage, float sampleRate, float frequency, float q, float gain );
+
+			/// <summary>
+			/// Filters a buffer in place.
+			/// </summary>
+			/// <param name="buffer">The interleaved samples to filter.</param>
+			/// <param name="frameCount">The number of frames to process.</param>
+			void Process( System::IntPtr buffer, int frameCount );
+
+			/// <summary>
+			/// Clears the filter history of every channel.
+			/// </summary>
+			void Reset();
+
+			/// <summary>
+			/// Gets the number of interleaved channels the filter processes.
+			/// </summary>
+			property int Channels
+			{
+				int get() { return m_Channels; }
+			}
+
+			/// <summary>
+			/// Gets the number of cascaded sections.
+			/// </summary>
+			property int StageCount
+			{
+				int get() { return m_StageCount; }
+			}
+		};
+	}
+}
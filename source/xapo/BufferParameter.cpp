@@ -27,6 +27,26 @@ namespace SlimDX
 {
 namespace XAPO
 {
+	void BufferParameter::FromUnmanaged( array<BufferParameter>^ destination, const XAPO_PROCESS_BUFFER_PARAMETERS *source )
+	{
+		for( int i = 0; i < destination->Length; i++ )
+		{
+			destination[i].Buffer = System::IntPtr( source[i].pBuffer );
+			destination[i].Flags = static_cast<BufferFlags>( source[i].BufferFlags );
+			destination[i].ValidFrameCount = source[i].ValidFrameCount;
+		}
+	}
+
+	void BufferParameter::ToUnmanaged( array<BufferParameter>^ source, XAPO_PROCESS_BUFFER_PARAMETERS *destination )
+	{
+		// the buffer pointers belong to the engine; only the flags and frame counts are ours to report
+		for( int i = 0; i < source->Length; i++ )
+		{
+			destination[i].BufferFlags = static_cast<XAPO_BUFFER_FLAGS>( source[i].Flags );
+			destination[i].ValidFrameCount = source[i].ValidFrameCount;
+		}
+	}
+
 	bool BufferParameter::operator == ( BufferParameter left, BufferParameter right )
 	{
 		return BufferParameter::Equals( left, right );
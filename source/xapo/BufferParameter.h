@@ -36,6 +36,12 @@ namespace SlimDX
 			property BufferFlags Flags;
 			property int ValidFrameCount;
 
+		internal:
+			static void FromUnmanaged( array<BufferParameter>^ destination, const XAPO_PROCESS_BUFFER_PARAMETERS *source );
+			static void ToUnmanaged( array<BufferParameter>^ source, XAPO_PROCESS_BUFFER_PARAMETERS *destination );
+
+		public:
+
 			/// <summary>
 			/// Tests for equality between two objects.
 			/// </summary>
@@ -0,0 +1,95 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "DspKernels.h"
+#include "AudioKernels.h"
+#include "DelayLine.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace XAPO
+{
+	DelayLine::DelayLine( int channels, int maxDelayFrames )
+	{
+		AudioKernels::CheckChannels( channels, "channels" );
+		if( maxDelayFrames < 1 )
+			throw gcnew ArgumentOutOfRangeException( "maxDelayFrames" );
+
+		m_Channels = channels;
+		m_MaxDelay = maxDelayFrames;
+
+		// Manual Allocation: this is fine
+		m_Line = new float[maxDelayFrames * channels];
+		GC::AddMemoryPressure( maxDelayFrames * channels * sizeof(float) );
+
+		Reset();
+	}
+
+	DelayLine::~DelayLine()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	DelayLine::!DelayLine()
+	{
+		Destruct();
+	}
+
+	void DelayLine::Destruct()
+	{
+		if( m_Line != 0 )
+		{
+			delete[] m_Line;
+			GC::RemoveMemoryPressure( m_MaxDelay * m_Channels * sizeof(float) );
+			m_Line = 0;
+		}
+	}
+
+	void DelayLine::Process( IntPtr buffer, int frameCount, int delayFrames, float feedback, float dryLevel, float wetLevel )
+	{
+		if( m_Line == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+		AudioKernels::CheckBuffer( buffer, "buffer" );
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+		if( delayFrames < 1 || delayFrames > m_MaxDelay )
+			throw gcnew ArgumentOutOfRangeException( "delayFrames" );
+
+		unsigned int writeFrame = m_WriteFrame;
+		Dsp::ProcessDelay( static_cast<float*>( buffer.ToPointer() ), m_Channels, frameCount, m_Line, m_MaxDelay, writeFrame, delayFrames, feedback, dryLevel, wetLevel );
+		m_WriteFrame = writeFrame;
+	}
+
+	void DelayLine::Reset()
+	{
+		if( m_Line == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		memset( m_Line, 0, m_MaxDelay * m_Channels * sizeof(float) );
+		m_WriteFrame = 0;
+	}
+}
+}
@@ -0,0 +1,96 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	namespace XAPO
+	{
+		/// <summary>
+		/// A multichannel feedback delay line for interleaved float samples.
+		/// </summary>
+		/// <remarks>
+		/// The line keeps its history between calls to <see cref="Process"/>, which does not allocate.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class DelayLine : System::IDisposable
+		{
+		private:
+			float *m_Line;
+			int m_Channels;
+			int m_MaxDelay;
+			unsigned int m_WriteFrame;
+
+			void Destruct();
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="DelayLine"/> class.
+			/// </summary>
+			/// <param name="channels">The number of interleaved channels to delay.</param>
+			/// <param name="maxDelayFrames">The longest delay, in frames, that the line can hold.</param>
+			DelayLine( int channels, int maxDelayFrames );
+
+			/// <summary>
+			/// Releases the delay history.
+			/// </summary>
+			~DelayLine();
+
+			/// <summary>
+			/// Releases the delay history.
+			/// </summary>
+			!DelayLine();
+
+			/// <summary>
+			/// Runs a buffer through the delay line in place.
+			/// </summary>
+			/// <param name="buffer">The interleaved samples to process.</param>
+			/// <param name="frameCount">The number of frames to process.</param>
+			/// <param name="delayFrames">The delay, in frames, between 1 and <see cref="MaximumDelay"/>.</param>
+			/// <param name="feedback">The amount of the delayed signal fed back into the line.</param>
+			/// <param name="dryLevel">The level of the input signal in the output.</param>
+			/// <param name="wetLevel">The level of the delayed signal in the output.</param>
+			void Process( System::IntPtr buffer, int frameCount, int delayFrames, float feedback, float dryLevel, float wetLevel );
+
+			/// <summary>
+			/// Clears the delay history.
+			/// </summary>
+			void Reset();
+
+			/// <summary>
+			/// Gets the number of interleaved channels the line processes.
+			/// </summary>
+			property int Channels
+			{
+				int get() { return m_Channels; }
+			}
+
+			/// <summary>
+			/// Gets the longest delay, in frames, that the line can hold.
+			/// </summary>
+			property int MaximumDelay
+			{
+				int get() { return m_MaxDelay; }
+			}
+		};
+	}
+}
@@ -0,0 +1,423 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <math.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define DSP_USE_SSE
+#include <emmintrin.h>
+#endif
+
+#include "DspKernels.h"
+
+// intrinsics are not available to managed code, and these kernels gain nothing from it anyway
+#ifdef _MANAGED
+#pragma managed(push, off)
+#endif
+
+namespace SlimDX
+{
+namespace XAPO
+{
+namespace Dsp
+{
+	template<bool Mix>
+	static void GainRamp( const float *source, float *destination, unsigned int channels, unsigned int frames, float startGain, float endGain )
+	{
+		float step = frames > 0 ? (endGain - startGain) / frames : 0.0f;
+		unsigned int samples = channels * frames;
+		unsigned int i = 0;
+
+#ifdef DSP_USE_SSE
+		if( channels < 4 && 4 % channels == 0 )
+		{
+			// each vector spans whole frames, so the per-lane gain offsets are fixed
+			__m128 offsets = _mm_mul_ps( _mm_setr_ps( 0.0f, static_cast<float>( 1 / channels ), static_cast<float>( 2 / channels ), static_cast<float>( 3 / channels ) ), _mm_set1_ps( step ) );
+			for( ; i + 4 <= samples; i += 4 )
+			{
+				__m128 gain = _mm_add_ps( _mm_set1_ps( startGain + step * (i / channels) ), offsets );
+				__m128 value = _mm_mul_ps( _mm_loadu_ps( source + i ), gain );
+				if( Mix )
+					value = _mm_add_ps( value, _mm_loadu_ps( destination + i ) );
+				_mm_storeu_ps( destination + i, value );
+			}
+		}
+		else if( channels >= 4 )
+		{
+			for( unsigned int frame = 0; frame < frames; ++frame )
+			{
+				float scalar = startGain + step * frame;
+				__m128 gain = _mm_set1_ps( scalar );
+				unsigned int channel = 0;
+				i = frame * channels;
+
+				for( ; channel + 4 <= channels; channel += 4, i += 4 )
+				{
+					__m128 value = _mm_mul_ps( _mm_loadu_ps( source + i ), gain );
+					if( Mix )
+						value = _mm_add_ps( value, _mm_loadu_ps( destination + i ) );
+					_mm_storeu_ps( destination + i, value );
+				}
+
+				for( ; channel < channels; ++channel, ++i )
+					destination[i] = Mix ? destination[i] + source[i] * scalar : source[i] * scalar;
+			}
+
+			return;
+		}
+#endif
+
+		for( ; i < samples; ++i )
+		{
+			float gain = startGain + step * (i / channels);
+			destination[i] = Mix ? destination[i] + source[i] * gain : source[i] * gain;
+		}
+	}
+
+	void ApplyGainRamp( float *buffer, unsigned int channels, unsigned int frames, float startGain, float endGain )
+	{
+		GainRamp<false>( buffer, buffer, channels, frames, startGain, endGain );
+	}
+
+	void MixGainRamp( const float *source, float *destination, unsigned int channels, unsigned int frames, float startGain, float endGain )
+	{
+		GainRamp<true>( source, destination, channels, frames, startGain, endGain );
+	}
+
+	void MixMatrix( const float *source, unsigned int sourceChannels, float *destination, unsigned int destinationChannels, unsigned int frames, const float *matrix, bool mixWithDestination )
+	{
+		unsigned int d = 0;
+
+#ifdef DSP_USE_SSE
+		if( destinationChannels >= 4 )
+		{
+			// transpose so each source channel's contributions to consecutive outputs sit next to each other
+			float columns[MaxChannels * MaxChannels];
+			for( unsigned int s = 0; s < sourceChannels; ++s )
+			{
+				for( unsigned int c = 0; c < destinationChannels; ++c )
+					columns[s * destinationChannels + c] = matrix[c * sourceChannels + s];
+			}
+
+			for( unsigned int frame = 0; frame < frames; ++frame )
+			{
+				const float *input = source + frame * sourceChannels;
+				float *output = destination + frame * destinationChannels;
+
+				for( d = 0; d + 4 <= destinationChannels; d += 4 )
+				{
+					__m128 sum = mixWithDestination ? _mm_loadu_ps( output + d ) : _mm_setzero_ps();
+					for( unsigned int s = 0; s < sourceChannels; ++s )
+						sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( columns + s * destinationChannels + d ), _mm_set1_ps( input[s] ) ) );
+					_mm_storeu_ps( output + d, sum );
+				}
+
+				for( unsigned int c = d; c < destinationChannels; ++c )
+				{
+					float sum = mixWithDestination ? output[c] : 0.0f;
+					for( unsigned int s = 0; s < sourceChannels; ++s )
+						sum += matrix[c * sourceChannels + s] * input[s];
+					output[c] = sum;
+				}
+			}
+
+			return;
+		}
+#endif
+
+		for( unsigned int frame = 0; frame < frames; ++frame )
+		{
+			const float *input = source + frame * sourceChannels;
+			float *output = destination + frame * destinationChannels;
+
+			for( d = 0; d < destinationChannels; ++d )
+			{
+				float sum = mixWithDestination ? output[d] : 0.0f;
+				for( unsigned int s = 0; s < sourceChannels; ++s )
+					sum += matrix[d * sourceChannels + s] * input[s];
+				output[d] = sum;
+			}
+		}
+	}
+
+	void ProcessBiquads( float *buffer, unsigned int channels, unsigned int frames, const BiquadStage *stages, unsigned int stageCount, float *state )
+	{
+		for( unsigned int stage = 0; stage < stageCount; ++stage )
+		{
+			const BiquadStage &k = stages[stage];
+			float *z1 = state + stage * channels * 2;
+			float *z2 = z1 + channels;
+			unsigned int channel = 0;
+
+#ifdef DSP_USE_SSE
+			// filter four interleaved channels at once; the recursion runs along frames, never across lanes
+			__m128 b0 = _mm_set1_ps( k.B0 ), b1 = _mm_set1_ps( k.B1 ), b2 = _mm_set1_ps( k.B2 );
+			__m128 a1 = _mm_set1_ps( k.A1 ), a2 = _mm_set1_ps( k.A2 );
+
+			for( ; channel + 4 <= channels; channel += 4 )
+			{
+				__m128 s1 = _mm_loadu_ps( z1 + channel );
+				__m128 s2 = _mm_loadu_ps( z2 + channel );
+				float *sample = buffer + channel;
+
+				for( unsigned int frame = 0; frame < frames; ++frame, sample += channels )
+				{
+					__m128 x = _mm_loadu_ps( sample );
+					__m128 y = _mm_add_ps( _mm_mul_ps( b0, x ), s1 );
+					s1 = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( b1, x ), _mm_mul_ps( a1, y ) ), s2 );
+					s2 = _mm_sub_ps( _mm_mul_ps( b2, x ), _mm_mul_ps( a2, y ) );
+					_mm_storeu_ps( sample, y );
+				}
+
+				_mm_storeu_ps( z1 + channel, s1 );
+				_mm_storeu_ps( z2 + channel, s2 );
+			}
+#endif
+
+			for( ; channel < channels; ++channel )
+			{
+				float s1 = z1[channel];
+				float s2 = z2[channel];
+				float *sample = buffer + channel;
+
+				for( unsigned int frame = 0; frame < frames; ++frame, sample += channels )
+				{
+					float x = *sample;
+					float y = k.B0 * x + s1;
+					s1 = k.B1 * x - k.A1 * y + s2;
+					s2 = k.B2 * x - k.A2 * y;
+					*sample = y;
+				}
+
+				z1[channel] = s1;
+				z2[channel] = s2;
+			}
+		}
+	}
+
+	void ProcessDelay( float *buffer, unsigned int channels, unsigned int frames, float *line, unsigned int lineFrames, unsigned int &writeFrame, unsigned int delayFrames, float feedback, float dry, float wet )
+	{
+		unsigned int length = lineFrames * channels;
+		unsigned int distance = delayFrames * channels;
+		unsigned int write = writeFrame * channels;
+		unsigned int read = (write + length - distance) % length;
+		unsigned int remaining = frames * channels;
+
+		while( remaining > 0 )
+		{
+			// work in runs where neither cursor wraps
+			unsigned int run = remaining;
+			if( run > length - write )
+				run = length - write;
+			if( run > length - read )
+				run = length - read;
+
+			unsigned int i = 0;
+
+#ifdef DSP_USE_SSE
+			// a sample is only read back once the write cursor is a full vector past it
+			if( distance >= 4 )
+			{
+				__m128 vdry = _mm_set1_ps( dry ), vwet = _mm_set1_ps( wet ), vfeedback = _mm_set1_ps( feedback );
+				for( ; i + 4 <= run; i += 4 )
+				{
+					__m128 input = _mm_loadu_ps( buffer + i );
+					__m128 delayed = _mm_loadu_ps( line + read + i );
+					_mm_storeu_ps( line + write + i, _mm_add_ps( input, _mm_mul_ps( vfeedback, delayed ) ) );
+					_mm_storeu_ps( buffer + i, _mm_add_ps( _mm_mul_ps( vdry, input ), _mm_mul_ps( vwet, delayed ) ) );
+				}
+			}
+#endif
+
+			for( ; i < run; ++i )
+			{
+				float input = buffer[i];
+				float delayed = line[read + i];
+				line[write + i] = input + feedback * delayed;
+				buffer[i] = dry * input + wet * delayed;
+			}
+
+			buffer += run;
+			remaining -= run;
+			write = (write + run) % length;
+			read = (read + run) % length;
+		}
+
+		writeFrame = write / channels;
+	}
+
+	void MeasureLevels( const float *buffer, unsigned int channels, unsigned int frames, float *peaks, float *rms )
+	{
+		unsigned int channel = 0;
+
+		for( unsigned int c = 0; c < channels; ++c )
+		{
+			peaks[c] = 0.0f;
+			rms[c] = 0.0f;
+		}
+
+#ifdef DSP_USE_SSE
+		__m128 signMask = _mm_castsi128_ps( _mm_set1_epi32( 0x7fffffff ) );
+		float peakLanes[4];
+		float sumLanes[4];
+
+		if( channels < 4 && 4 % channels == 0 )
+		{
+			// lane k always holds channel k % channels, so fold the lanes at the end
+			unsigned int samples = channels * frames;
+			unsigned int i = 0;
+			__m128 peak = _mm_setzero_ps();
+			__m128 sum = _mm_setzero_ps();
+
+			for( ; i + 4 <= samples; i += 4 )
+			{
+				__m128 x = _mm_loadu_ps( buffer + i );
+				peak = _mm_max_ps( peak, _mm_and_ps( x, signMask ) );
+				sum = _mm_add_ps( sum, _mm_mul_ps( x, x ) );
+			}
+
+			_mm_storeu_ps( peakLanes, peak );
+			_mm_storeu_ps( sumLanes, sum );
+			for( unsigned int lane = 0; lane < 4; ++lane )
+			{
+				unsigned int c = lane % channels;
+				if( peakLanes[lane] > peaks[c] )
+					peaks[c] = peakLanes[lane];
+				rms[c] += sumLanes[lane];
+			}
+
+			for( ; i < samples; ++i )
+			{
+				float x = fabsf( buffer[i] );
+				unsigned int c = i % channels;
+				if( x > peaks[c] )
+					peaks[c] = x;
+				rms[c] += x * x;
+			}
+
+			channel = channels;
+		}
+		else
+		{
+			for( ; channel + 4 <= channels; channel += 4 )
+			{
+				__m128 peak = _mm_setzero_ps();
+				__m128 sum = _mm_setzero_ps();
+				const float *sample = buffer + channel;
+
+				for( unsigned int frame = 0; frame < frames; ++frame, sample += channels )
+				{
+					__m128 x = _mm_loadu_ps( sample );
+					peak = _mm_max_ps( peak, _mm_and_ps( x, signMask ) );
+					sum = _mm_add_ps( sum, _mm_mul_ps( x, x ) );
+				}
+
+				_mm_storeu_ps( peaks + channel, peak );
+				_mm_storeu_ps( rms + channel, sum );
+			}
+		}
+#endif
+
+		for( ; channel < channels; ++channel )
+		{
+			float peak = 0.0f;
+			float sum = 0.0f;
+			const float *sample = buffer + channel;
+
+			for( unsigned int frame = 0; frame < frames; ++frame, sample += channels )
+			{
+				float x = fabsf( *sample );
+				if( x > peak )
+					peak = x;
+				sum += x * x;
+			}
+
+			peaks[channel] = peak;
+			rms[channel] = sum;
+		}
+
+		// rms holds sums of squares until here
+		for( unsigned int c = 0; c < channels; ++c )
+			rms[c] = frames > 0 ? sqrtf( rms[c] / frames ) : 0.0f;
+	}
+
+	void Deinterleave( const float *source, unsigned int channels, unsigned int frames, float *const *destinations )
+	{
+		unsigned int frame = 0;
+
+#ifdef DSP_USE_SSE
+		if( channels == 2 )
+		{
+			float *left = destinations[0];
+			float *right = destinations[1];
+
+			for( ; frame + 4 <= frames; frame += 4 )
+			{
+				__m128 a = _mm_loadu_ps( source + frame * 2 );
+				__m128 b = _mm_loadu_ps( source + frame * 2 + 4 );
+				_mm_storeu_ps( left + frame, _mm_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+				_mm_storeu_ps( right + frame, _mm_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+			}
+		}
+#endif
+
+		for( ; frame < frames; ++frame )
+		{
+			for( unsigned int c = 0; c < channels; ++c )
+				destinations[c][frame] = source[frame * channels + c];
+		}
+	}
+
+	void Interleave( const float *const *sources, unsigned int channels, unsigned int frames, float *destination )
+	{
+		unsigned int frame = 0;
+
+#ifdef DSP_USE_SSE
+		if( channels == 2 )
+		{
+			const float *left = sources[0];
+			const float *right = sources[1];
+
+			for( ; frame + 4 <= frames; frame += 4 )
+			{
+				__m128 l = _mm_loadu_ps( left + frame );
+				__m128 r = _mm_loadu_ps( right + frame );
+				_mm_storeu_ps( destination + frame * 2, _mm_unpacklo_ps( l, r ) );
+				_mm_storeu_ps( destination + frame * 2 + 4, _mm_unpackhi_ps( l, r ) );
+			}
+		}
+#endif
+
+		for( ; frame < frames; ++frame )
+		{
+			for( unsigned int c = 0; c < channels; ++c )
+				destination[frame * channels + c] = sources[c][frame];
+		}
+	}
+}
+}
+}
+
+#ifdef _MANAGED
+#pragma managed(pop)
+#endif
@@ -0,0 +1,65 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+// Native float32 DSP kernels shared by the XAPO helpers. Nothing in here depends on
+// Windows or the CLR, so the kernels can be built and checked on their own.
+namespace SlimDX
+{
+	namespace XAPO
+	{
+		namespace Dsp
+		{
+			const unsigned int MaxChannels = 64;
+
+			struct BiquadStage
+			{
+				float B0;
+				float B1;
+				float B2;
+				float A1;
+				float A2;
+			};
+
+			// Scales interleaved samples in place, ramping linearly from startGain towards endGain across the frames.
+			void ApplyGainRamp( float *buffer, unsigned int channels, unsigned int frames, float startGain, float endGain );
+
+			// Adds ramped, gain-scaled source samples to the destination.
+			void MixGainRamp( const float *source, float *destination, unsigned int channels, unsigned int frames, float startGain, float endGain );
+
+			// Applies a destination-major level matrix (matrix[d * sourceChannels + s]); source and destination must not overlap.
+			void MixMatrix( const float *source, unsigned int sourceChannels, float *destination, unsigned int destinationChannels, unsigned int frames, const float *matrix, bool mixWithDestination );
+
+			// Runs a cascade of transposed direct form II biquads in place. state holds stageCount * channels * 2 floats.
+			void ProcessBiquads( float *buffer, unsigned int channels, unsigned int frames, const BiquadStage *stages, unsigned int stageCount, float *state );
+
+			// Feedback delay over a circular line of lineFrames frames; writeFrame is advanced by frames.
+			void ProcessDelay( float *buffer, unsigned int channels, unsigned int frames, float *line, unsigned int lineFrames, unsigned int &writeFrame, unsigned int delayFrames, float feedback, float dry, float wet );
+
+			// Computes the absolute peak and RMS level of each channel.
+			void MeasureLevels( const float *buffer, unsigned int channels, unsigned int frames, float *peaks, float *rms );
+
+			void Deinterleave( const float *source, unsigned int channels, unsigned int frames, float *const *destinations );
+			void Interleave( const float *const *sources, unsigned int channels, unsigned int frames, float *destination );
+		}
+	}
+}
@@ -0,0 +1,236 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "ParameterChannel.h"
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+using namespace System::Threading;
+
+namespace SlimDX
+{
+namespace XAPO
+{
+	generic<typename T> where T : value class
+	ParameterChannel<T>::ParameterChannel()
+	{
+		Construct( T() );
+	}
+
+	generic<typename T> where T : value class
+	ParameterChannel<T>::ParameterChannel( T initialValue )
+	{
+		Construct( initialValue );
+	}
+
+	generic<typename T> where T : value class
+	void ParameterChannel<T>::Construct( T initialValue )
+	{
+		// blocks are copied bitwise between threads, which would hide references from the collector;
+		// the runtime refuses to pin a value that contains any
+		try
+		{
+			GCHandle handle = GCHandle::Alloc( initialValue, GCHandleType::Pinned );
+			handle.Free();
+		}
+		catch( ArgumentException^ )
+		{
+			throw gcnew ArgumentException( "The parameter type must be blittable." );
+		}
+
+		// give each block its own cache lines so the reader and writers never share one
+		m_Stride = static_cast<int>( (sizeof(T) + 63) & ~63 );
+
+		// Manual Allocation: this is fine
+		m_Memory = new char[m_Stride * 3 + 63];
+		m_Blocks = reinterpret_cast<char*>( (reinterpret_cast<size_t>( m_Memory ) + 63) & ~static_cast<size_t>( 63 ) );
+		GC::AddMemoryPressure( m_Stride * 3 + 63 );
+
+		for( int i = 0; i < 3; i++ )
+			memcpy( m_Blocks + i * m_Stride, &initialValue, sizeof(T) );
+
+		m_ReadIndex = 0;
+		m_State = 1;
+		m_WriteIndex = 2;
+	}
+
+	generic<typename T> where T : value class
+	ParameterChannel<T>::~ParameterChannel()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	generic<typename T> where T : value class
+	ParameterChannel<T>::!ParameterChannel()
+	{
+		Destruct();
+	}
+
+	generic<typename T> where T : value class
+	void ParameterChannel<T>::Destruct()
+	{
+		if( m_Memory != 0 )
+		{
+			delete[] m_Memory;
+			GC::RemoveMemoryPressure( m_Stride * 3 + 63 );
+			m_Memory = 0;
+			m_Blocks = 0;
+		}
+	}
+
+	generic<typename T> where T : value class
+	void ParameterChannel<T>::Acquire()
+	{
+		while( Interlocked::CompareExchange( m_Writing, 1, 0 ) != 0 )
+			Thread::SpinWait( 20 );
+	}
+
+	generic<typename T> where T : value class
+	void ParameterChannel<T>::Publish( const void *value )
+	{
+		// the caller holds m_Writing, so the write block is ours alone until the swap
+		memcpy( m_Blocks + m_WriteIndex * m_Stride, value, sizeof(T) );
+
+		int previous = Interlocked::Exchange( m_State, m_WriteIndex | FreshFlag );
+		m_WriteIndex = previous & IndexMask;
+
+		if( (previous & FreshFlag) != 0 )
+			Interlocked::Increment( m_Coalesced );
+		Interlocked::Increment( m_Written );
+
+		Interlocked::Exchange( m_Writing, 0 );
+	}
+
+	generic<typename T> where T : value class
+	void ParameterChannel<T>::Write( T value )
+	{
+		if( m_Memory == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		Acquire();
+		Publish( &value );
+	}
+
+	generic<typename T> where T : value class
+	bool ParameterChannel<T>::TryWrite( T value )
+	{
+		if( m_Memory == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		if( Interlocked::CompareExchange( m_Writing, 1, 0 ) != 0 )
+		{
+			Interlocked::Increment( m_Dropped );
+			return false;
+		}
+
+		Publish( &value );
+		return true;
+	}
+
+	generic<typename T> where T : value class
+	bool ParameterChannel<T>::Update()
+	{
+		if( m_Memory == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		if( (Thread::VolatileRead( m_State ) & FreshFlag) == 0 )
+			return false;
+
+		int previous = Interlocked::Exchange( m_State, m_ReadIndex );
+		m_ReadIndex = previous & IndexMask;
+
+		Interlocked::Increment( m_Applied );
+		return true;
+	}
+
+	generic<typename T> where T : value class
+	int ParameterChannel<T>::GetBlockSize()
+	{
+		return static_cast<int>( sizeof(T) );
+	}
+
+	generic<typename T> where T : value class
+	const char *ParameterChannel<T>::GetCurrentBlock()
+	{
+		if( m_Memory == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		return m_Blocks + m_ReadIndex * m_Stride;
+	}
+
+	generic<typename T> where T : value class
+	void ParameterChannel<T>::PublishBlock( const char *block )
+	{
+		if( m_Memory == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		Acquire();
+		Publish( block );
+	}
+
+	generic<typename T> where T : value class
+	T ParameterChannel<T>::Current::get()
+	{
+		if( m_Memory == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		T value;
+		memcpy( &value, m_Blocks + m_ReadIndex * m_Stride, sizeof(T) );
+		return value;
+	}
+
+	generic<typename T> where T : value class
+	void ParameterChannel<T>::ResetStatistics()
+	{
+		Interlocked::Exchange( m_Written, 0 );
+		Interlocked::Exchange( m_Applied, 0 );
+		Interlocked::Exchange( m_Coalesced, 0 );
+		Interlocked::Exchange( m_Dropped, 0 );
+	}
+
+	generic<typename T> where T : value class
+	Int64 ParameterChannel<T>::WrittenCount::get()
+	{
+		return Interlocked::Read( m_Written );
+	}
+
+	generic<typename T> where T : value class
+	Int64 ParameterChannel<T>::AppliedCount::get()
+	{
+		return Interlocked::Read( m_Applied );
+	}
+
+	generic<typename T> where T : value class
+	Int64 ParameterChannel<T>::CoalescedCount::get()
+	{
+		return Interlocked::Read( m_Coalesced );
+	}
+
+	generic<typename T> where T : value class
+	Int64 ParameterChannel<T>::DroppedCount::get()
+	{
+		return Interlocked::Read( m_Dropped );
+	}
+}
+}
@@ -0,0 +1,168 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	namespace XAPO
+	{
+		// Untyped access to a parameter channel, so that a processor can read one without knowing its type.
+		interface class IParameterChannel
+		{
+			int GetBlockSize();
+			const char *GetCurrentBlock();
+			void PublishBlock( const char *block );
+			bool Update();
+		};
+
+		/// <summary>
+		/// Passes typed parameter blocks from game threads to an audio processor without locking or allocating.
+		/// </summary>
+		/// <typeparam name="T">The parameter structure. It must be blittable; it is copied bitwise between threads.</typeparam>
+		/// <remarks>
+		/// The channel is triple buffered: writers fill a private block and publish it with a single atomic swap,
+		/// and the processor picks up the most recent block once per quantum with <see cref="Update"/>. Blocks that
+		/// are replaced before the processor sees them are coalesced rather than queued. Only one writer can fill a
+		/// block at a time; <see cref="TryWrite"/> drops the update instead of waiting when another writer is busy.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		generic<typename T> where T : value class
+		public ref class ParameterChannel : System::IDisposable, IParameterChannel
+		{
+		private:
+			literal int IndexMask = 3;
+			literal int FreshFlag = 4;
+
+			char* m_Memory;
+			char* m_Blocks;
+			int m_Stride;
+
+			int m_State;
+			int m_WriteIndex;
+			int m_ReadIndex;
+			int m_Writing;
+
+			System::Int64 m_Written;
+			System::Int64 m_Applied;
+			System::Int64 m_Coalesced;
+			System::Int64 m_Dropped;
+
+			void Construct( T initialValue );
+			void Destruct();
+			void Acquire();
+			void Publish( const void *value );
+
+			virtual int GetBlockSize() sealed = IParameterChannel::GetBlockSize;
+			virtual const char *GetCurrentBlock() sealed = IParameterChannel::GetCurrentBlock;
+			virtual void PublishBlock( const char *block ) sealed = IParameterChannel::PublishBlock;
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="ParameterChannel{T}"/> class with default parameters.
+			/// </summary>
+			/// <exception cref="System::ArgumentException"><typeparamref name="T"/> contains references and cannot be copied bitwise.</exception>
+			ParameterChannel();
+
+			/// <summary>
+			/// Initializes a new instance of the <see cref="ParameterChannel{T}"/> class.
+			/// </summary>
+			/// <param name="initialValue">The parameters the processor sees before the first update.</param>
+			/// <exception cref="System::ArgumentException"><typeparamref name="T"/> contains references and cannot be copied bitwise.</exception>
+			ParameterChannel( T initialValue );
+
+			/// <summary>
+			/// Releases the parameter blocks.
+			/// </summary>
+			~ParameterChannel();
+
+			/// <summary>
+			/// Releases the parameter blocks.
+			/// </summary>
+			!ParameterChannel();
+
+			/// <summary>
+			/// Publishes new parameters, waiting if another writer is publishing at the same time.
+			/// </summary>
+			/// <param name="value">The parameters to publish.</param>
+			void Write( T value );
+
+			/// <summary>
+			/// Publishes new parameters unless another writer is publishing at the same time.
+			/// </summary>
+			/// <param name="value">The parameters to publish.</param>
+			/// <returns><c>true</c> if the parameters were published; <c>false</c> if they were dropped.</returns>
+			bool TryWrite( T value );
+
+			/// <summary>
+			/// Makes the most recently published parameters current. Call once at the start of each processing pass,
+			/// from the processing thread only.
+			/// </summary>
+			/// <returns><c>true</c> if new parameters were picked up; otherwise, <c>false</c>.</returns>
+			virtual bool Update();
+
+			/// <summary>
+			/// Resets the update counters to zero.
+			/// </summary>
+			void ResetStatistics();
+
+			/// <summary>
+			/// Gets the parameters made current by the last call to <see cref="Update"/>.
+			/// </summary>
+			property T Current
+			{
+				T get();
+			}
+
+			/// <summary>
+			/// Gets the number of updates that have been published.
+			/// </summary>
+			property System::Int64 WrittenCount
+			{
+				System::Int64 get();
+			}
+
+			/// <summary>
+			/// Gets the number of updates the processor has picked up.
+			/// </summary>
+			property System::Int64 AppliedCount
+			{
+				System::Int64 get();
+			}
+
+			/// <summary>
+			/// Gets the number of updates that were replaced by a newer one before the processor picked them up.
+			/// </summary>
+			property System::Int64 CoalescedCount
+			{
+				System::Int64 get();
+			}
+
+			/// <summary>
+			/// Gets the number of updates rejected by <see cref="TryWrite"/> because another writer was busy.
+			/// </summary>
+			property System::Int64 DroppedCount
+			{
+				System::Int64 get();
+			}
+		};
+	}
+}
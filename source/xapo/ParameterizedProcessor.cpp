@@ -42,16 +42,51 @@ namespace XAPO
 		XAPO_REGISTRATION_PROPERTIES *props = properties.ToUnmanaged();
 
 		Construct( static_cast<IXAPOParameters*>( new XAPOParametersImpl( this, props, reinterpret_cast<BYTE*>( parameterBlocks->PositionPointer ), blockSize, producer ) ) );
+
+		m_BlockSize = blockSize;
+		m_ProcessParameters = gcnew DataStream( parameterBlocks->PositionPointer, blockSize, true, false, false );
+	}
+
+	generic<typename T> where T : value class
+	void ParameterizedProcessor::UseParameterChannel( ParameterChannel<T>^ channel )
+	{
+		if( channel == nullptr )
+			throw gcnew ArgumentNullException( "channel" );
+		if( static_cast<int>( sizeof(T) ) != m_BlockSize )
+			throw gcnew ArgumentException( "The parameter type must be the size of a parameter block.", "channel" );
+
+		m_Channel = channel;
+	}
+
+	const void *ParameterizedProcessor::BeginChannel()
+	{
+		// the channel only swaps blocks in Update, so the current one stays put until the next pass
+		m_ChannelChanged = m_Channel->Update();
+		return m_Channel->GetCurrentBlock();
 	}
 
 	IntPtr ParameterizedProcessor::BeginProcess()
 	{
+		if( m_Channel != nullptr )
+			return IntPtr( const_cast<void*>( BeginChannel() ) );
+
 		return IntPtr( ParamPointer->BeginProcess() );
 	}
 
+	DataStream^ ParameterizedProcessor::BeginProcessParameters()
+	{
+		if( m_Channel != nullptr )
+			m_ProcessParameters->Retarget( BeginChannel(), m_BlockSize );
+		else
+			m_ProcessParameters->Retarget( ParamPointer->BeginProcess(), m_BlockSize );
+
+		return m_ProcessParameters;
+	}
+
 	void ParameterizedProcessor::EndProcess()
 	{
-		ParamPointer->EndProcess();
+		if( m_Channel == nullptr )
+			ParamPointer->EndProcess();
 	}
 
 	void ParameterizedProcessor::OnSetParameters( DataStream^ parameters )
@@ -61,21 +96,60 @@ namespace XAPO
 
 	void ParameterizedProcessor::GetParameters( DataStream^ parameters )
 	{
+		if( m_Channel != nullptr )
+		{
+			if( parameters->RemainingLength < m_BlockSize )
+				throw gcnew ArgumentException( "The stream is smaller than a parameter block.", "parameters" );
+
+			memcpy( parameters->PositionPointer, m_Channel->GetCurrentBlock(), m_BlockSize );
+			return;
+		}
+
 		ParamPointer->ManagedCaller = true;
 		ParamPointer->GetParameters( parameters->PositionPointer, static_cast<UINT32>( parameters->RemainingLength ) );
 	}
 
 	void ParameterizedProcessor::SetParameters( DataStream^ parameters )
 	{
+		if( m_Channel != nullptr )
+		{
+			if( parameters->RemainingLength != m_BlockSize )
+				throw gcnew ArgumentException( "The stream must hold exactly one parameter block.", "parameters" );
+
+			m_Channel->PublishBlock( parameters->PositionPointer );
+			OnSetParameters( parameters );
+			return;
+		}
+
 		ParamPointer->ManagedCaller = true;
 		ParamPointer->SetParameters( parameters->PositionPointer, static_cast<UINT32>( parameters->RemainingLength ) );
 	}
 
 	bool ParameterizedProcessor::ParametersChanged::get()
 	{
+		if( m_Channel != nullptr )
+			return m_ChannelChanged;
+
 		return ParamPointer->ParametersChanged() > 0;
 	}
 
+	// parameter traffic arrives every frame for every voice, so each entry point keeps one stream and repoints it
+	static DataStream^ ReuseView( gcroot<DataStream^> &cache, const void *buffer, UINT32 size, bool canWrite )
+	{
+		DataStream^ view = cache;
+		if( view == nullptr )
+		{
+			view = gcnew DataStream( const_cast<void*>( buffer ), size, true, canWrite, false );
+			cache = view;
+		}
+		else
+		{
+			view->Retarget( buffer, size );
+		}
+
+		return view;
+	}
+
 	XAPOParametersImpl::XAPOParametersImpl( ParameterizedProcessor^ processor, XAPO_REGISTRATION_PROPERTIES *pRegProperties, BYTE *pParameterBlocks, UINT32 uParameterBlockByteSize, BOOL fProducer )
 		: CXAPOParametersBase( pRegProperties, pParameterBlocks, uParameterBlockByteSize, fProducer )
 	{
@@ -86,7 +160,7 @@ namespace XAPO
 
 	void XAPOParametersImpl::OnSetParameters( const void *pParameters, UINT32 ParameterByteSize )
 	{
-		m_processor->OnSetParameters( gcnew DataStream( pParameters, ParameterByteSize, true, false ) );
+		m_processor->OnSetParameters( ReuseView( m_parameterView, pParameters, ParameterByteSize, false ) );
 	}
 
 	UINT32 WINAPI XAPOParametersImpl::CalcInputFrames( UINT32 OutputFrameCount )
@@ -264,6 +338,10 @@ namespace XAPO
 		{
 			try
 			{
+				// Process runs on the audio thread and must not allocate, so size its parameter arrays here
+				m_inputParameters = gcnew array<BufferParameter>( InputLockedParameterCount );
+				m_outputParameters = gcnew array<BufferParameter>( OutputLockedParameterCount );
+
 				array<LockParameter>^ input = gcnew array<LockParameter>( InputLockedParameterCount );
 				for( int i = 0; i < input->Length; i++ )
 				{
@@ -303,29 +381,28 @@ namespace XAPO
 	{
 		try
 		{
-			array<BufferParameter>^ input = gcnew array<BufferParameter>( InputProcessParameterCount );
-			for( int i = 0; i < input->Length; i++ )
-			{
-				BufferParameter p;
-				p.Buffer = IntPtr( pInputProcessParameters[i].pBuffer );
-				p.Flags = static_cast<BufferFlags>( pInputProcessParameters[i].BufferFlags );
-				p.ValidFrameCount = pInputProcessParameters[i].ValidFrameCount;
+			array<BufferParameter>^ input = m_inputParameters;
+			array<BufferParameter>^ output = m_outputParameters;
 
-				input[i] = p;
+			// the engine always locks first; these only allocate if it was bypassed
+			if( input == nullptr || input->Length != static_cast<int>( InputProcessParameterCount ) )
+			{
+				input = gcnew array<BufferParameter>( InputProcessParameterCount );
+				m_inputParameters = input;
 			}
 
-			array<BufferParameter>^ output = gcnew array<BufferParameter>( OutputProcessParameterCount );
-			for( int i = 0; i < output->Length; i++ )
+			if( output == nullptr || output->Length != static_cast<int>( OutputProcessParameterCount ) )
 			{
-				BufferParameter p;
-				p.Buffer = IntPtr( pOutputProcessParameters[i].pBuffer );
-				p.Flags = static_cast<BufferFlags>( pOutputProcessParameters[i].BufferFlags );
-				p.ValidFrameCount = pOutputProcessParameters[i].ValidFrameCount;
-
-				output[i] = p;
+				output = gcnew array<BufferParameter>( OutputProcessParameterCount );
+				m_outputParameters = output;
 			}
 
+			BufferParameter::FromUnmanaged( input, pInputProcessParameters );
+			BufferParameter::FromUnmanaged( output, pOutputProcessParameters );
+
 			m_processor->Process( input, output, IsEnabled > 0 );
+
+			BufferParameter::ToUnmanaged( output, pOutputProcessParameters );
 		}
 		catch(...)
 		{
@@ -381,7 +458,7 @@ namespace XAPO
 		{
 			try
 			{
-				m_processor->GetParameters( gcnew DataStream( pParameters, ParameterByteSize, true, true, false ) );
+				m_processor->GetParameters( ReuseView( m_getView, pParameters, ParameterByteSize, true ) );
 			}
 			catch(...)
 			{
@@ -400,7 +477,7 @@ namespace XAPO
 		{
 			try
 			{
-				m_processor->SetParameters( gcnew DataStream( pParameters, ParameterByteSize, true, false ) );
+				m_processor->SetParameters( ReuseView( m_setView, pParameters, ParameterByteSize, false ) );
 			}
 			catch(...)
 			{
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "BaseProcessor.h"
+#include "ParameterChannel.h"
 
 namespace SlimDX
 {
@@ -31,6 +32,14 @@ namespace SlimDX
 
 		public ref class ParameterizedProcessor abstract : BaseProcessor, IParameterProvider
 		{
+		private:
+			DataStream^ m_ProcessParameters;
+			int m_BlockSize;
+			IParameterChannel^ m_Channel;
+			bool m_ChannelChanged;
+
+			const void *BeginChannel();
+
 		internal:
 			property XAPOParametersImpl *ParamPointer
 			{
@@ -42,8 +51,31 @@ namespace SlimDX
 
 			virtual void OnSetParameters( DataStream^ parameters );
 
+			/// <summary>
+			/// Takes the parameters for each processing pass from a channel instead of the engine's parameter blocks.
+			/// </summary>
+			/// <remarks>
+			/// <see cref="BeginProcess"/> and <see cref="BeginProcessParameters"/> pick up the most recent block
+			/// written to the channel, and parameters set through the engine are written to it as well.
+			/// </remarks>
+			/// <typeparam name="T">The parameter structure, which must be the size of a parameter block.</typeparam>
+			/// <param name="channel">The channel to read parameters from.</param>
+			generic<typename T> where T : value class
+			void UseParameterChannel( ParameterChannel<T>^ channel );
+
 		public:
 			System::IntPtr BeginProcess();
+
+			/// <summary>
+			/// Gets the parameter block to use for the current processing pass, as a read-only stream.
+			/// Must be paired with a call to <see cref="EndProcess"/>.
+			/// </summary>
+			/// <remarks>
+			/// The same stream instance is returned on every call so that processing does not allocate;
+			/// it is only valid until <see cref="EndProcess"/> is called.
+			/// </remarks>
+			/// <returns>A stream over the current parameter block.</returns>
+			DataStream^ BeginProcessParameters();
 			void EndProcess();
 
 			virtual void GetParameters( DataStream^ parameters );
@@ -59,6 +91,11 @@ namespace SlimDX
 		{
 		private:
 			gcroot<ParameterizedProcessor^> m_processor;
+			gcroot<array<BufferParameter>^> m_inputParameters;
+			gcroot<array<BufferParameter>^> m_outputParameters;
+			gcroot<DataStream^> m_parameterView;
+			gcroot<DataStream^> m_getView;
+			gcroot<DataStream^> m_setView;
 			XAPO_REGISTRATION_PROPERTIES *pProperties;
 
 		public:
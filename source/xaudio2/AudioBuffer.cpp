@@ -49,21 +49,19 @@ namespace XAudio2
 		result.LoopCount = LoopCount;
 		result.pContext = Context.ToPointer();
 
-		DataStream^ dataStream;
-		array<Byte>^ bytes = Utilities::ReadStream( AudioData, AudioBytes, &dataStream );
-
-		if( bytes == nullptr )
+		DataStream^ dataStream = Utilities::AsDataStream( AudioData );
+		if( dataStream != nullptr )
 			result.pAudioData = reinterpret_cast<BYTE*>( dataStream->PositionPointer );
 		else
 		{
+			// anything else gets a view that stays alive until the buffer is resubmitted or disposed
 			Destruct();
-			handle = GCHandle::Alloc( bytes, GCHandleType::Pinned );
 
-#if SLIMDX_XAUDIO2_VERSION < 23
-			result.pAudioData = reinterpret_cast<const BYTE*>( handle.AddrOfPinnedObject().ToPointer() );
-#else
-			result.pAudioData = reinterpret_cast<BYTE*>( handle.AddrOfPinnedObject().ToPointer() );
-#endif
+			int audioBytes = AudioBytes;
+			data = Utilities::ReadStreamView( AudioData, audioBytes, true );
+
+			result.AudioBytes = audioBytes;
+			result.pAudioData = data == nullptr ? NULL : reinterpret_cast<BYTE*>( data->RawPointer );
 		}
 
 		return result;
@@ -71,8 +69,11 @@ namespace XAudio2
 
 	void AudioBuffer::Destruct()
 	{
-		if( handle.IsAllocated )
-			handle.Free();
+		if( data != nullptr )
+		{
+			delete data;
+			data = nullptr;
+		}
 	}
 }
 }
\ No newline at end of file
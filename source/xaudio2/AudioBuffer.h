@@ -25,16 +25,23 @@
 
 namespace SlimDX
 {
+	ref class DataStream;
+
 	namespace XAudio2
 	{
+		ref class AudioBufferPool;
+
 		public ref class AudioBuffer
 		{
 		private:
-			System::Runtime::InteropServices::GCHandle handle;
+			DataStream^ data;
 
 			void Destruct();
 
 		internal:
+			AudioBufferPool^ pool;
+			int poolIndex;
+
 			XAUDIO2_BUFFER ToUnmanaged();
 
 		public:
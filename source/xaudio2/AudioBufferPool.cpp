@@ -0,0 +1,301 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <xaudio2.h>
+
+#include "../DataStream.h"
+#include "../multimedia/WaveStream.h"
+
+#include "AudioBufferPool.h"
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+using namespace System::Threading;
+
+namespace SlimDX
+{
+namespace XAudio2
+{
+	AudioBufferPool::AudioBufferPool( int bufferCount, int bufferSize )
+	{
+		if( bufferCount < 1 )
+			throw gcnew ArgumentOutOfRangeException( "bufferCount" );
+		if( bufferSize < 1 || bufferSize > XAUDIO2_MAX_BUFFER_BYTES )
+			throw gcnew ArgumentOutOfRangeException( "bufferSize" );
+
+		m_BufferCount = bufferCount;
+		m_BufferSize = bufferSize;
+		m_Stride = (bufferSize + 63) & ~63;
+
+		Int64 totalSize = static_cast<Int64>( m_Stride ) * bufferCount;
+		if( totalSize > Int32::MaxValue )
+			throw gcnew ArgumentOutOfRangeException( "bufferCount" );
+
+		// Manual Allocation: this is fine
+		m_Memory = new char[static_cast<size_t>( totalSize )];
+		m_Next = new int[bufferCount];
+		GC::AddMemoryPressure( totalSize );
+
+		m_Buffers = gcnew array<AudioBuffer^>( bufferCount );
+		m_Streams = gcnew array<DataStream^>( bufferCount );
+		m_Pending = gcnew array<int>( bufferCount );
+
+		for( int i = 0; i < bufferCount; i++ )
+		{
+			m_Streams[i] = gcnew DataStream( m_Memory + static_cast<size_t>( i ) * m_Stride, bufferSize, true, true, false );
+
+			AudioBuffer^ buffer = gcnew AudioBuffer();
+			buffer->AudioData = m_Streams[i];
+			buffer->pool = this;
+			buffer->poolIndex = i;
+			m_Buffers[i] = buffer;
+
+			// the free list links are stored as index + 1 so that zero can mean empty
+			m_Next[i] = i + 2 <= bufferCount ? i + 2 : 0;
+			m_Pending[i] = -1;
+		}
+
+		m_FreeHead = 1;
+	}
+
+	AudioBufferPool::~AudioBufferPool()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	AudioBufferPool::!AudioBufferPool()
+	{
+		Destruct();
+	}
+
+	void AudioBufferPool::Destruct()
+	{
+		// a voice may still be reading submitted buffers, in which case the last of them to come back frees the memory;
+		// the flag is raised before the count is read, and CompleteSubmission works the other way round
+		Interlocked::Exchange( m_Closed, 1 );
+		if( Thread::VolatileRead( m_Submitted ) == 0 )
+			FreeMemory();
+	}
+
+	void AudioBufferPool::FreeMemory()
+	{
+		if( m_Memory != 0 && Interlocked::Exchange( m_Freed, 1 ) == 0 )
+		{
+			if( m_Streams != nullptr )
+			{
+				for each( DataStream^ stream in m_Streams )
+					delete stream;
+			}
+
+			delete[] m_Memory;
+			delete[] m_Next;
+			GC::RemoveMemoryPressure( static_cast<Int64>( m_Stride ) * m_BufferCount );
+
+			m_Memory = 0;
+			m_Next = 0;
+		}
+	}
+
+	AudioBuffer^ AudioBufferPool::Rent()
+	{
+		if( Thread::VolatileRead( m_Closed ) != 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		int index;
+		while( true )
+		{
+			// the high half of the head is a version tag, which keeps a recycled index from fooling the swap
+			Int64 head = Interlocked::Read( m_FreeHead );
+			int top = static_cast<int>( head & 0xffffffff );
+			if( top == 0 )
+			{
+				Interlocked::Increment( m_FailedRentCount );
+				return nullptr;
+			}
+
+			Int64 next = (((head >> 32) + 1) << 32) | static_cast<unsigned int>( m_Next[top - 1] );
+			if( Interlocked::CompareExchange( m_FreeHead, next, head ) == head )
+			{
+				index = top - 1;
+				break;
+			}
+		}
+
+		m_Pending[index] = 0;
+		Interlocked::Increment( m_RentCount );
+
+		int inUse = Interlocked::Increment( m_InUse );
+		int peak = Thread::VolatileRead( m_PeakInUse );
+		while( inUse > peak )
+		{
+			int seen = Interlocked::CompareExchange( m_PeakInUse, inUse, peak );
+			if( seen == peak )
+				break;
+			peak = seen;
+		}
+
+		AudioBuffer^ buffer = m_Buffers[index];
+		buffer->Flags = BufferFlags::None;
+		buffer->AudioBytes = m_BufferSize;
+		buffer->PlayBegin = 0;
+		buffer->PlayLength = 0;
+		buffer->LoopBegin = 0;
+		buffer->LoopLength = 0;
+		buffer->LoopCount = 0;
+		buffer->Context = IntPtr::Zero;
+		m_Streams[index]->Position = 0;
+
+		return buffer;
+	}
+
+	void AudioBufferPool::Return( AudioBuffer^ buffer )
+	{
+		if( buffer == nullptr )
+			throw gcnew ArgumentNullException( "buffer" );
+		if( buffer->pool != this )
+			throw gcnew ArgumentException( "The buffer does not belong to this pool.", "buffer" );
+		if( Interlocked::CompareExchange( m_Pending[buffer->poolIndex], -1, 0 ) != 0 )
+			throw gcnew InvalidOperationException( "The buffer has been submitted or is not rented." );
+
+		Release( buffer->poolIndex );
+	}
+
+	bool AudioBufferPool::Fill( SlimDX::Multimedia::WaveStream^ source, [Out] AudioBuffer^% buffer )
+	{
+		buffer = nullptr;
+		if( source == nullptr )
+			throw gcnew ArgumentNullException( "source" );
+
+		int alignment = Math::Max( static_cast<int>( source->Format->BlockAlignment ), 1 );
+		int size = m_BufferSize / alignment * alignment;
+		if( size == 0 )
+			throw gcnew InvalidOperationException( "The pool buffers are smaller than one frame of the stream." );
+
+		// running out of data is not the pool's doing, so it is told apart before anything is rented
+		if( source->Length - source->Position < alignment )
+			return false;
+
+		AudioBuffer^ rented = Rent();
+		if( rented == nullptr )
+			return true;
+
+		int read;
+		try
+		{
+			read = source->ReadTo( m_Streams[rented->poolIndex]->RawPointer, size );
+		}
+		catch( Exception^ )
+		{
+			Return( rented );
+			throw;
+		}
+
+		if( read == 0 )
+		{
+			// the stream was shorter than it claimed; take back the rent that never happened
+			Return( rented );
+			Interlocked::Decrement( m_RentCount );
+			return false;
+		}
+
+		rented->AudioBytes = read;
+		if( source->Position >= source->Length )
+			rented->Flags = BufferFlags::EndOfStream;
+
+		buffer = rented;
+		return true;
+	}
+
+	void AudioBufferPool::AddSubmission( AudioBuffer^ buffer )
+	{
+		if( Interlocked::Increment( m_Pending[buffer->poolIndex] ) == 1 )
+			Interlocked::Increment( m_Submitted );
+	}
+
+	void AudioBufferPool::CancelSubmission( AudioBuffer^ buffer )
+	{
+		// the caller still holds the buffer, so this never releases it
+		if( Interlocked::Decrement( m_Pending[buffer->poolIndex] ) == 0 )
+			Interlocked::Decrement( m_Submitted );
+	}
+
+	void AudioBufferPool::CompleteSubmission( AudioBuffer^ buffer )
+	{
+		int index = buffer->poolIndex;
+		if( Interlocked::Decrement( m_Pending[index] ) != 0 )
+			return;
+
+		if( Interlocked::CompareExchange( m_Pending[index], -1, 0 ) == 0 )
+			Release( index );
+
+		if( Interlocked::Decrement( m_Submitted ) == 0 && Thread::VolatileRead( m_Closed ) != 0 )
+			FreeMemory();
+	}
+
+	void AudioBufferPool::Release( int index )
+	{
+		if( m_Memory == 0 )
+			return;
+
+		Interlocked::Decrement( m_InUse );
+
+		while( true )
+		{
+			Int64 head = Interlocked::Read( m_FreeHead );
+			m_Next[index] = static_cast<int>( head & 0xffffffff );
+
+			Int64 next = (((head >> 32) + 1) << 32) | static_cast<unsigned int>( index + 1 );
+			if( Interlocked::CompareExchange( m_FreeHead, next, head ) == head )
+				return;
+		}
+	}
+
+	void AudioBufferPool::ResetStatistics()
+	{
+		Interlocked::Exchange( m_RentCount, 0 );
+		Interlocked::Exchange( m_FailedRentCount, 0 );
+		Interlocked::Exchange( m_PeakInUse, Thread::VolatileRead( m_InUse ) );
+	}
+
+	int AudioBufferPool::InUseCount::get()
+	{
+		return Thread::VolatileRead( m_InUse );
+	}
+
+	int AudioBufferPool::PeakInUseCount::get()
+	{
+		return Thread::VolatileRead( m_PeakInUse );
+	}
+
+	Int64 AudioBufferPool::RentCount::get()
+	{
+		return Interlocked::Read( m_RentCount );
+	}
+
+	Int64 AudioBufferPool::FailedRentCount::get()
+	{
+		return Interlocked::Read( m_FailedRentCount );
+	}
+}
+}
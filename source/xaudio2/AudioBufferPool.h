@@ -0,0 +1,177 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "AudioBuffer.h"
+
+namespace SlimDX
+{
+	ref class DataStream;
+
+	namespace Multimedia
+	{
+		ref class WaveStream;
+	}
+
+	namespace XAudio2
+	{
+		/// <summary>
+		/// A fixed set of reusable native audio buffers for streaming submissions.
+		/// </summary>
+		/// <remarks>
+		/// Every pooled buffer lives in one native allocation that never moves, so submitting it to a
+		/// <see cref="SourceVoice"/> neither copies nor pins anything. Once a rented buffer has been submitted,
+		/// it returns to the pool by itself when the last voice it was submitted to raises
+		/// <see cref="SourceVoice::BufferEnd"/>; a buffer that is never submitted must be handed back with
+		/// <see cref="Return"/>. Flush or dispose every voice playing from the pool before disposing it: the pool memory
+		/// is only freed once no voice holds any of its buffers, so a voice left playing keeps it alive indefinitely.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class AudioBufferPool : System::IDisposable
+		{
+		private:
+			char *m_Memory;
+			int *m_Next;
+			int m_BufferCount;
+			int m_BufferSize;
+			int m_Stride;
+
+			System::Int64 m_FreeHead;
+			array<AudioBuffer^>^ m_Buffers;
+			array<DataStream^>^ m_Streams;
+			array<int>^ m_Pending;
+
+			int m_InUse;
+			int m_PeakInUse;
+			int m_Submitted;
+			int m_Closed;
+			int m_Freed;
+			System::Int64 m_RentCount;
+			System::Int64 m_FailedRentCount;
+
+			void Destruct();
+			void FreeMemory();
+			void Release( int index );
+
+		internal:
+			void AddSubmission( AudioBuffer^ buffer );
+			void CancelSubmission( AudioBuffer^ buffer );
+			void CompleteSubmission( AudioBuffer^ buffer );
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="AudioBufferPool"/> class.
+			/// </summary>
+			/// <param name="bufferCount">The number of buffers in the pool.</param>
+			/// <param name="bufferSize">The size of each buffer, in bytes.</param>
+			AudioBufferPool( int bufferCount, int bufferSize );
+
+			/// <summary>
+			/// Releases the pool memory, or defers that until the last buffer still submitted to a voice comes back.
+			/// </summary>
+			~AudioBufferPool();
+
+			/// <summary>
+			/// Releases the pool memory, or defers that until the last buffer still submitted to a voice comes back.
+			/// </summary>
+			!AudioBufferPool();
+
+			/// <summary>
+			/// Takes a buffer from the pool.
+			/// </summary>
+			/// <returns>A reset buffer whose <see cref="AudioBuffer::AudioData"/> is a writable stream over pooled memory,
+			/// or <c>null</c> if every buffer is in use.</returns>
+			/// <remarks>The same <see cref="AudioBuffer"/> instances are handed out again once they are recycled.</remarks>
+			AudioBuffer^ Rent();
+
+			/// <summary>
+			/// Hands back a rented buffer that was not submitted to any voice.
+			/// </summary>
+			/// <param name="buffer">The buffer to return.</param>
+			void Return( AudioBuffer^ buffer );
+
+			/// <summary>
+			/// Takes a buffer from the pool and fills it with the next whole frames read from a wave stream.
+			/// </summary>
+			/// <param name="source">The stream to read from. A streaming <see cref="SlimDX::Multimedia::WaveStream"/> keeps
+			/// the memory used by a long track fixed at its read-ahead blocks plus this pool.</param>
+			/// <param name="buffer">Receives a buffer ready to submit, flagged with <see cref="BufferFlags::EndOfStream"/> if it
+			/// holds the last of the data, or <c>null</c> if every buffer is in use or the stream has no data left.</param>
+			/// <returns><c>false</c> if the stream has no data left; otherwise, <c>true</c>, even when the pool was exhausted.</returns>
+			/// <remarks>Reaching the end of the stream neither rents a buffer nor counts in <see cref="FailedRentCount"/>.</remarks>
+			bool Fill( SlimDX::Multimedia::WaveStream^ source, [System::Runtime::InteropServices::Out] AudioBuffer^% buffer );
+
+			/// <summary>
+			/// Resets the rent counters to zero and the peak usage to the current usage.
+			/// </summary>
+			void ResetStatistics();
+
+			/// <summary>
+			/// Gets the number of buffers in the pool.
+			/// </summary>
+			property int BufferCount
+			{
+				int get() { return m_BufferCount; }
+			}
+
+			/// <summary>
+			/// Gets the size of each buffer, in bytes.
+			/// </summary>
+			property int BufferSize
+			{
+				int get() { return m_BufferSize; }
+			}
+
+			/// <summary>
+			/// Gets the number of buffers currently rented or playing.
+			/// </summary>
+			property int InUseCount
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the largest number of buffers that have been in use at once.
+			/// </summary>
+			property int PeakInUseCount
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the number of successful calls to <see cref="Rent"/>.
+			/// </summary>
+			property System::Int64 RentCount
+			{
+				System::Int64 get();
+			}
+
+			/// <summary>
+			/// Gets the number of calls to <see cref="Rent"/> that found the pool empty.
+			/// </summary>
+			property System::Int64 FailedRentCount
+			{
+				System::Int64 get();
+			}
+		};
+	}
+}
@@ -115,6 +115,17 @@ namespace SlimDX
 			PlayTails = XAUDIO2_PLAY_TAILS
 		};
 
+		public enum class VoiceCallbackKind : System::Int32
+		{
+			BufferStart,
+			BufferEnd,
+			LoopEnd,
+			StreamEnd,
+			VoiceError,
+			VoiceProcessingPassStart,
+			VoiceProcessingPassEnd
+		};
+
 		[System::Flags]
 		public enum class VoiceFlags : System::Int32
 		{
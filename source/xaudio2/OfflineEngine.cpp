@@ -0,0 +1,346 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <xaudio2.h>
+
+#include "../DataStream.h"
+
+#include "OfflineKernels.h"
+#include "OfflineSourceVoice.h"
+#include "OfflineSubmixVoice.h"
+#include "OfflineMasteringVoice.h"
+#include "OfflineEngine.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Collections::Generic;
+
+namespace SlimDX
+{
+namespace XAudio2
+{
+	OfflineEngine::OfflineEngine()
+	{
+		m_QuantumFrames = 480;
+		m_Voices = gcnew List<OfflineVoice^>();
+		m_MinimumCycles = Int32::MaxValue;
+	}
+
+	OfflineEngine::OfflineEngine( int quantumFrames )
+	{
+		if( quantumFrames < 1 || quantumFrames > XAUDIO2_MAX_SAMPLE_RATE )
+			throw gcnew ArgumentOutOfRangeException( "quantumFrames" );
+
+		m_QuantumFrames = quantumFrames;
+		m_Voices = gcnew List<OfflineVoice^>();
+		m_MinimumCycles = Int32::MaxValue;
+	}
+
+	OfflineEngine::~OfflineEngine()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	OfflineEngine::!OfflineEngine()
+	{
+		Destruct();
+	}
+
+	void OfflineEngine::Destruct()
+	{
+		if( m_Disposed )
+			return;
+
+		// disposing a voice removes it from the list
+		for each( OfflineVoice^ voice in m_Voices->ToArray() )
+			delete voice;
+
+		m_Order = nullptr;
+		m_Disposed = true;
+	}
+
+	void OfflineEngine::CheckDisposed()
+	{
+		if( m_Disposed )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+	}
+
+	void OfflineEngine::AddVoice( OfflineVoice^ voice )
+	{
+		OfflineMasteringVoice^ mastering = dynamic_cast<OfflineMasteringVoice^>( voice );
+		if( mastering != nullptr )
+		{
+			if( m_MasteringVoice != nullptr )
+				throw gcnew InvalidOperationException( "The engine already has a mastering voice." );
+			m_MasteringVoice = mastering;
+		}
+
+		m_Voices->Add( voice );
+		InvalidateOrder();
+	}
+
+	void OfflineEngine::RemoveVoice( OfflineVoice^ voice )
+	{
+		m_Voices->Remove( voice );
+		for each( OfflineVoice^ other in m_Voices )
+			other->RemoveSendsTo( voice );
+
+		if( voice == m_MasteringVoice )
+			m_MasteringVoice = nullptr;
+
+		InvalidateOrder();
+	}
+
+	void OfflineEngine::BuildOrder()
+	{
+		array<OfflineVoice^>^ order = m_Voices->ToArray();
+
+		// insertion sort keeps voices of the same stage in creation order
+		for( int i = 1; i < order->Length; i++ )
+		{
+			OfflineVoice^ voice = order[i];
+			int stage = voice->ProcessingStage;
+			int j = i - 1;
+			while( j >= 0 && order[j]->ProcessingStage > stage )
+			{
+				order[j + 1] = order[j];
+				j--;
+			}
+			order[j + 1] = voice;
+		}
+
+		for each( OfflineVoice^ voice in order )
+		{
+			if( voice->ProcessingStage != Int32::MinValue && voice->m_SampleRate != m_MasteringVoice->m_SampleRate )
+				throw gcnew InvalidOperationException( "All submix voices must have the sample rate of the mastering voice." );
+		}
+
+		m_Order = order;
+	}
+
+	void OfflineEngine::RenderQuantum( float *output, int frames )
+	{
+		unsigned long long start = Offline::ReadCycles();
+
+		if( m_Order == nullptr )
+			BuildOrder();
+
+		for( int i = 0; i < m_Order->Length; i++ )
+		{
+			if( m_Order[i]->ProcessingStage != Int32::MinValue )
+				m_Order[i]->ClearBuffer( frames );
+		}
+
+		m_MasteringVoice->m_Output = output;
+
+		unsigned long long audio = 0;
+		for( int i = 0; i < m_Order->Length; i++ )
+		{
+			OfflineVoice^ voice = m_Order[i];
+			unsigned long long begin = Offline::ReadCycles();
+			if( voice->Process( frames ) )
+			{
+				unsigned long long cycles = Offline::ReadCycles() - begin;
+				voice->RecordCycles( cycles );
+				audio += cycles;
+			}
+		}
+
+		m_MasteringVoice->m_Output = NULL;
+
+		int quantum = audio > static_cast<unsigned long long>( Int32::MaxValue ) ? Int32::MaxValue : static_cast<int>( audio );
+		if( quantum < m_MinimumCycles )
+			m_MinimumCycles = quantum;
+		if( quantum > m_MaximumCycles )
+			m_MaximumCycles = quantum;
+
+		m_AudioCycles += static_cast<Int64>( audio );
+		m_RenderCycles += static_cast<Int64>( Offline::ReadCycles() - start );
+		m_FramesRendered += frames;
+
+		// handlers may change the graph, so they run once the quantum is complete
+		array<OfflineVoice^>^ order = m_Order;
+		for( int i = 0; i < order->Length; i++ )
+		{
+			OfflineSourceVoice^ source = dynamic_cast<OfflineSourceVoice^>( order[i] );
+			if( source != nullptr && source->m_Engine != nullptr )
+				source->RaiseCallbacks();
+		}
+	}
+
+	void OfflineEngine::RenderFrames( float *output, int frameCount )
+	{
+		int channels = m_MasteringVoice->m_OutputChannels;
+		while( frameCount > 0 )
+		{
+			int frames = Math::Min( frameCount, m_QuantumFrames );
+			RenderQuantum( output, frames );
+
+			if( output != NULL )
+				output += frames * channels;
+			frameCount -= frames;
+		}
+	}
+
+	void OfflineEngine::Render( int frameCount )
+	{
+		CheckDisposed();
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+		if( m_MasteringVoice == nullptr )
+			throw gcnew InvalidOperationException( "The engine has no mastering voice." );
+
+		RenderFrames( NULL, frameCount );
+	}
+
+	void OfflineEngine::Render( DataStream^ destination, int frameCount )
+	{
+		CheckDisposed();
+		if( destination == nullptr )
+			throw gcnew ArgumentNullException( "destination" );
+		if( !destination->CanWrite )
+			throw gcnew ArgumentException( "The stream must be writable.", "destination" );
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+		if( m_MasteringVoice == nullptr )
+			throw gcnew InvalidOperationException( "The engine has no mastering voice." );
+
+		Int64 bytes = static_cast<Int64>( frameCount ) * m_MasteringVoice->m_OutputChannels * 4;
+		if( destination->Length - destination->Position < bytes )
+			throw gcnew ArgumentException( "The stream does not have room for the rendered frames.", "destination" );
+
+		RenderFrames( reinterpret_cast<float*>( destination->PositionPointer ), frameCount );
+		destination->Position += bytes;
+	}
+
+	void OfflineEngine::RenderToFile( String^ fileName, int frameCount )
+	{
+		CheckDisposed();
+		if( fileName == nullptr )
+			throw gcnew ArgumentNullException( "fileName" );
+		if( frameCount < 0 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+		if( m_MasteringVoice == nullptr )
+			throw gcnew InvalidOperationException( "The engine has no mastering voice." );
+
+		int channels = m_MasteringVoice->m_OutputChannels;
+		int sampleRate = m_MasteringVoice->m_SampleRate;
+		int frameSize = channels * 4;
+		Int64 dataSize = static_cast<Int64>( frameCount ) * frameSize;
+		if( dataSize > UInt32::MaxValue - 58 )
+			throw gcnew ArgumentOutOfRangeException( "frameCount" );
+
+		// render in blocks of whole quanta through a reusable buffer
+		int blockFrames = m_QuantumFrames * Math::Max( 1, 65536 / ( m_QuantumFrames * frameSize ) );
+		array<Byte>^ block = gcnew array<Byte>( blockFrames * frameSize );
+
+		FileStream^ file = gcnew FileStream( fileName, FileMode::Create, FileAccess::Write );
+		BinaryWriter^ writer = gcnew BinaryWriter( file );
+		try
+		{
+			// a float format is not PCM, so the header carries the extended format size and a fact chunk
+			writer->Write( static_cast<UInt32>( 0x46464952 ) );
+			writer->Write( static_cast<UInt32>( 50 + dataSize ) );
+			writer->Write( static_cast<UInt32>( 0x45564157 ) );
+			writer->Write( static_cast<UInt32>( 0x20746d66 ) );
+			writer->Write( static_cast<UInt32>( 18 ) );
+			writer->Write( static_cast<UInt16>( WAVE_FORMAT_IEEE_FLOAT ) );
+			writer->Write( static_cast<UInt16>( channels ) );
+			writer->Write( static_cast<UInt32>( sampleRate ) );
+			writer->Write( static_cast<UInt32>( sampleRate * frameSize ) );
+			writer->Write( static_cast<UInt16>( frameSize ) );
+			writer->Write( static_cast<UInt16>( 32 ) );
+			writer->Write( static_cast<UInt16>( 0 ) );
+			writer->Write( static_cast<UInt32>( 0x74636166 ) );
+			writer->Write( static_cast<UInt32>( 4 ) );
+			writer->Write( static_cast<UInt32>( frameCount ) );
+			writer->Write( static_cast<UInt32>( 0x61746164 ) );
+			writer->Write( static_cast<UInt32>( dataSize ) );
+
+			while( frameCount > 0 )
+			{
+				int frames = Math::Min( frameCount, blockFrames );
+				{
+					pin_ptr<Byte> pinnedBlock = &block[0];
+					RenderFrames( reinterpret_cast<float*>( pinnedBlock ), frames );
+				}
+
+				writer->Write( block, 0, frames * frameSize );
+				frameCount -= frames;
+			}
+		}
+		finally
+		{
+			writer->Close();
+		}
+	}
+
+	SlimDX::XAudio2::PerformanceData^ OfflineEngine::PerformanceData::get()
+	{
+		CheckDisposed();
+
+		SlimDX::XAudio2::PerformanceData^ data = gcnew SlimDX::XAudio2::PerformanceData();
+		data->AudioCyclesSinceLastQuery = m_AudioCycles;
+		data->TotalCyclesSinceLastQuery = m_RenderCycles - m_RenderCyclesAtQuery;
+		data->MinimumCyclesPerQuantum = m_MinimumCycles == Int32::MaxValue ? 0 : m_MinimumCycles;
+		data->MaximumCyclesPerQuantum = m_MaximumCycles;
+
+		int memory = 0;
+		for each( OfflineVoice^ voice in m_Voices )
+		{
+			memory += 2 * voice->m_BufferChannels * m_QuantumFrames * 4;
+#if SLIMDX_XAUDIO2_VERSION >= 23
+			data->ActiveMatrixMixCount += voice->m_Sends->Count;
+#endif
+
+			OfflineSourceVoice^ source = dynamic_cast<OfflineSourceVoice^>( voice );
+			if( source != nullptr )
+			{
+				data->TotalSourceVoiceCount++;
+				if( source->IsRunning )
+					data->ActiveSourceVoiceCount++;
+#if SLIMDX_XAUDIO2_VERSION >= 23
+				if( source->IsResampling )
+					data->ActiveResamplerCount++;
+#endif
+			}
+			else if( dynamic_cast<OfflineSubmixVoice^>( voice ) != nullptr )
+			{
+				data->ActiveSubmixVoiceCount++;
+#if SLIMDX_XAUDIO2_VERSION < 23
+				data->TotalSubmixVoiceCount++;
+#endif
+			}
+		}
+
+		data->MemoryUsageInBytes = memory;
+
+		m_AudioCycles = 0;
+		m_RenderCyclesAtQuery = m_RenderCycles;
+		m_MinimumCycles = Int32::MaxValue;
+		m_MaximumCycles = 0;
+		return data;
+	}
+}
+}
@@ -0,0 +1,157 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "PerformanceData.h"
+
+namespace SlimDX
+{
+	ref class DataStream;
+
+	namespace XAudio2
+	{
+		ref class OfflineVoice;
+		ref class OfflineSourceVoice;
+		ref class OfflineMasteringVoice;
+
+		/// <summary>
+		/// Renders a graph of voices shaped like the XAudio2 voice graph on the calling thread, without an audio device and as
+		/// fast as the CPU allows.
+		/// </summary>
+		/// <remarks>
+		/// <para>Voices are created against the engine with <see cref="OfflineSourceVoice"/>, <see cref="OfflineSubmixVoice"/> and
+		/// <see cref="OfflineMasteringVoice"/>, and then connected and configured as their XAudio2 counterparts would be. Each call to
+		/// <see cref="Render(DataStream^, int)"/> runs whole processing quanta of <see cref="QuantumFrames"/> frames: every running
+		/// source voice, then every submix voice in order of processing stage, then the mastering voice, whose output is written as
+		/// interleaved 32-bit floats.</para>
+		/// <para>All submix and mastering voices must share one sample rate; source voices are resampled to it. The time spent on each
+		/// voice is counted in processor cycles and reported through <see cref="PerformanceData"/> objects, as XAudio2 does for the
+		/// engine as a whole. Callbacks of source voices are raised on the rendering thread at the end of the quantum in which they occur.</para>
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class OfflineEngine sealed : System::IDisposable
+		{
+		private:
+			int m_QuantumFrames;
+			System::Int64 m_FramesRendered;
+			System::Collections::Generic::List<OfflineVoice^>^ m_Voices;
+			array<OfflineVoice^>^ m_Order;
+
+			System::Int64 m_AudioCycles;
+			System::Int64 m_RenderCycles;
+			System::Int64 m_RenderCyclesAtQuery;
+			int m_MinimumCycles;
+			int m_MaximumCycles;
+			bool m_Disposed;
+
+			void Destruct();
+			void RenderQuantum( float *output, int frames );
+			void RenderFrames( float *output, int frameCount );
+			void BuildOrder();
+
+		internal:
+			OfflineMasteringVoice^ m_MasteringVoice;
+
+			void AddVoice( OfflineVoice^ voice );
+			void RemoveVoice( OfflineVoice^ voice );
+			void InvalidateOrder() { m_Order = nullptr; }
+			System::Int64 GetRenderCycles() { return m_RenderCycles; }
+			void CheckDisposed();
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="OfflineEngine"/> class with a 10 millisecond quantum at 48 kHz.
+			/// </summary>
+			OfflineEngine();
+
+			/// <summary>
+			/// Initializes a new instance of the <see cref="OfflineEngine"/> class.
+			/// </summary>
+			/// <param name="quantumFrames">The number of frames processed by each pass over the graph.</param>
+			OfflineEngine( int quantumFrames );
+
+			/// <summary>
+			/// Releases every voice of the engine.
+			/// </summary>
+			~OfflineEngine();
+
+			/// <summary>
+			/// Releases every voice of the engine.
+			/// </summary>
+			!OfflineEngine();
+
+			/// <summary>
+			/// Renders the graph and discards the output, for measuring its cost.
+			/// </summary>
+			/// <param name="frameCount">The number of frames to render.</param>
+			void Render( int frameCount );
+
+			/// <summary>
+			/// Renders the graph and writes the output of the mastering voice to a stream as interleaved 32-bit floats.
+			/// </summary>
+			/// <param name="destination">The stream to write to. It must have room for the output at its current position.</param>
+			/// <param name="frameCount">The number of frames to render.</param>
+			void Render( DataStream^ destination, int frameCount );
+
+			/// <summary>
+			/// Renders the graph and writes the output of the mastering voice to a 32-bit float wave file.
+			/// </summary>
+			/// <param name="fileName">The name of the file to create.</param>
+			/// <param name="frameCount">The number of frames to render.</param>
+			void RenderToFile( System::String^ fileName, int frameCount );
+
+			/// <summary>
+			/// Gets the number of frames processed by each pass over the graph.
+			/// </summary>
+			property int QuantumFrames
+			{
+				int get() { return m_QuantumFrames; }
+			}
+
+			/// <summary>
+			/// Gets the number of frames rendered so far.
+			/// </summary>
+			property System::Int64 FramesRendered
+			{
+				System::Int64 get() { return m_FramesRendered; }
+			}
+
+			/// <summary>
+			/// Gets the mastering voice of the engine, or <c>null</c> if none has been created.
+			/// </summary>
+			property OfflineMasteringVoice^ MasteringVoice
+			{
+				OfflineMasteringVoice^ get() { return m_MasteringVoice; }
+			}
+
+			/// <summary>
+			/// Gets the processing cost of the whole graph since the last query. <see cref="SlimDX::XAudio2::PerformanceData::AudioCyclesSinceLastQuery"/>
+			/// counts the cycles spent on voices and <see cref="SlimDX::XAudio2::PerformanceData::TotalCyclesSinceLastQuery"/> the cycles spent in
+			/// <see cref="Render(int)"/>; the minimum and maximum are taken over the quanta rendered.
+			/// </summary>
+			property SlimDX::XAudio2::PerformanceData^ PerformanceData
+			{
+				SlimDX::XAudio2::PerformanceData^ get();
+			}
+		};
+	}
+}
@@ -0,0 +1,107 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "OfflineKernels.h"
+
+#ifdef _MANAGED
+#pragma managed(push, off)
+#endif
+
+namespace SlimDX
+{
+namespace XAudio2
+{
+namespace Offline
+{
+	unsigned long long ReadCycles()
+	{
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+		return __rdtsc();
+#else
+		return 0;
+#endif
+	}
+
+	void ApplyFilter( float *buffer, unsigned int channels, unsigned int frames, FilterKind kind, float frequency, float oneOverQ, float *state )
+	{
+		for( unsigned int c = 0; c < channels; c++ )
+		{
+			float low = state[c * 2];
+			float band = state[c * 2 + 1];
+			float *sample = buffer + c;
+
+			for( unsigned int i = 0; i < frames; i++, sample += channels )
+			{
+				low += frequency * band;
+				float high = *sample - low - oneOverQ * band;
+				band += frequency * high;
+
+				switch( kind )
+				{
+				case LowPass:
+					*sample = low;
+					break;
+				case BandPass:
+					*sample = band;
+					break;
+				case HighPass:
+					*sample = high;
+					break;
+				default:
+					*sample = low + high;
+					break;
+				}
+			}
+
+			state[c * 2] = low;
+			state[c * 2 + 1] = band;
+		}
+	}
+
+	void ResampleLinear( const float *source, unsigned int channels, double position, double step, float *destination, unsigned int frames )
+	{
+		for( unsigned int i = 0; i < frames; i++ )
+		{
+			double at = position + i * step;
+			unsigned int index = static_cast<unsigned int>( at );
+			float fraction = static_cast<float>( at - index );
+			const float *a = source + index * channels;
+			const float *b = a + channels;
+
+			for( unsigned int c = 0; c < channels; c++ )
+				*destination++ = a[c] + ( b[c] - a[c] ) * fraction;
+		}
+	}
+}
+}
+}
+
+#ifdef _MANAGED
+#pragma managed(pop)
+#endif
@@ -0,0 +1,53 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+// Native per-voice processing used by OfflineEngine. Mixing goes through the XAPO DSP kernels; this adds
+// what only a voice needs. Nothing in here depends on Windows or the CLR.
+namespace SlimDX
+{
+	namespace XAudio2
+	{
+		namespace Offline
+		{
+			// Same values as the XAudio2 filter types.
+			enum FilterKind
+			{
+				LowPass,
+				BandPass,
+				HighPass,
+				Notch
+			};
+
+			// A processor timestamp, for counting cycles spent on each voice.
+			unsigned long long ReadCycles();
+
+			// Runs the XAudio2 state variable filter in place. frequency and oneOverQ are given as in
+			// XAUDIO2_FILTER_PARAMETERS; state holds two floats per channel.
+			void ApplyFilter( float *buffer, unsigned int channels, unsigned int frames, FilterKind kind, float frequency, float oneOverQ, float *state );
+
+			// Fills frames of output by linear interpolation between the source frames, starting at the fractional
+			// source frame position and advancing by step for each output frame.
+			void ResampleLinear( const float *source, unsigned int channels, double position, double step, float *destination, unsigned int frames );
+		}
+	}
+}
@@ -0,0 +1,56 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "OfflineVoice.h"
+
+namespace SlimDX
+{
+	namespace XAudio2
+	{
+		/// <summary>
+		/// The mastering voice of an <see cref="OfflineEngine"/>, whose output is what the engine renders.
+		/// </summary>
+		/// <unmanaged>None</unmanaged>
+		public ref class OfflineMasteringVoice : OfflineVoice
+		{
+		internal:
+			float *m_Output;
+
+			virtual bool Process( int frames ) override;
+
+			virtual property int ProcessingStage
+			{
+				int get() override { return System::Int32::MaxValue; }
+			}
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="OfflineMasteringVoice"/> class. An engine has at most one mastering voice.
+			/// </summary>
+			/// <param name="engine">The engine the voice belongs to.</param>
+			/// <param name="inputChannels">The number of channels of the output.</param>
+			/// <param name="inputSampleRate">The sample rate of the output.</param>
+			OfflineMasteringVoice( OfflineEngine^ engine, int inputChannels, int inputSampleRate );
+		};
+	}
+}
@@ -0,0 +1,324 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <xaudio2.h>
+
+#include "../multimedia/AudioConverter.h"
+#include "../multimedia/ConversionKernels.h"
+
+#include "OfflineKernels.h"
+#include "OfflineEngine.h"
+#include "OfflineMasteringVoice.h"
+#include "OfflineSourceVoice.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace SlimDX::Multimedia;
+
+namespace SlimDX
+{
+namespace XAudio2
+{
+	enum CallbackKind
+	{
+		CallbackBufferStart,
+		CallbackBufferEnd,
+		CallbackLoopEnd,
+		CallbackStreamEnd
+	};
+
+	OfflineSourceVoice::OfflineSourceVoice( OfflineEngine^ engine, WaveFormat^ sourceFormat )
+	{
+		unsigned int channelMask;
+		m_SampleType = AudioConverter::ParseFormat( sourceFormat, "sourceFormat", channelMask );
+		if( sourceFormat->SamplesPerSecond < XAUDIO2_MIN_SAMPLE_RATE || sourceFormat->SamplesPerSecond > XAUDIO2_MAX_SAMPLE_RATE )
+			throw gcnew ArgumentException( "The format has an unsupported sample rate.", "sourceFormat" );
+
+		m_Format = sourceFormat;
+		m_BlockAlignment = sourceFormat->BlockAlignment;
+		m_Queue = gcnew Queue<OfflineSourceBuffer^>();
+		m_Callbacks = gcnew List<PendingCallback>();
+		m_FrequencyRatio = 1.0f;
+
+		Construct( engine, sourceFormat->Channels, sourceFormat->SamplesPerSecond );
+	}
+
+	OfflineSourceVoice::~OfflineSourceVoice()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	OfflineSourceVoice::!OfflineSourceVoice()
+	{
+		Destruct();
+	}
+
+	void OfflineSourceVoice::Destruct()
+	{
+		delete[] m_Window;
+		m_Window = NULL;
+		m_WindowFrames = 0;
+		m_WindowCapacity = 0;
+	}
+
+	int OfflineSourceVoice::OutputSampleRate::get()
+	{
+		if( m_Sends->Count > 0 )
+			return m_Sends[0]->Target->m_SampleRate;
+		if( m_Engine != nullptr && m_Engine->m_MasteringVoice != nullptr )
+			return m_Engine->m_MasteringVoice->m_SampleRate;
+		return m_SampleRate;
+	}
+
+	void OfflineSourceVoice::Fill( int frames )
+	{
+		int channels = m_InputChannels;
+		while( m_WindowFrames < frames )
+		{
+			if( m_Queue->Count == 0 )
+			{
+				// a starved voice plays silence, as XAudio2 does
+				memset( m_Window + m_WindowFrames * channels, 0, ( frames - m_WindowFrames ) * channels * sizeof(float) );
+				m_WindowFrames = frames;
+				break;
+			}
+
+			OfflineSourceBuffer^ buffer = m_Queue->Peek();
+			if( !buffer->Started )
+			{
+				buffer->Started = true;
+				m_Callbacks->Add( PendingCallback( CallbackBufferStart, buffer->Buffer->Context ) );
+			}
+
+			bool looping = buffer->LoopsLeft > 0;
+			int end = looping ? buffer->LoopEnd : buffer->PlayEnd;
+			int count = Math::Min( frames - m_WindowFrames, end - buffer->Position );
+			if( count > 0 )
+			{
+				Conversion::ToFloat( buffer->Data + static_cast<size_t>( buffer->Position ) * m_BlockAlignment, static_cast<Conversion::SampleType>( m_SampleType ),
+					m_Window + m_WindowFrames * channels, count * channels );
+				buffer->Position += count;
+				m_WindowFrames += count;
+			}
+
+			if( buffer->Position < end )
+				continue;
+
+			if( looping )
+			{
+				m_Callbacks->Add( PendingCallback( CallbackLoopEnd, buffer->Buffer->Context ) );
+				if( buffer->LoopsLeft != XAUDIO2_LOOP_INFINITE )
+					buffer->LoopsLeft--;
+				buffer->Position = buffer->LoopBegin;
+			}
+			else
+			{
+				m_Queue->Dequeue();
+				m_Callbacks->Add( PendingCallback( CallbackBufferEnd, buffer->Buffer->Context ) );
+				if( buffer->EndOfStream )
+					m_Callbacks->Add( PendingCallback( CallbackStreamEnd, IntPtr::Zero ) );
+			}
+		}
+	}
+
+	bool OfflineSourceVoice::Process( int frames )
+	{
+		if( !m_Running )
+			return false;
+
+		ResolveDefaultSend();
+
+		int channels = m_InputChannels;
+		double step = static_cast<double>( m_FrequencyRatio ) * m_SampleRate / OutputSampleRate;
+		bool direct = step == 1.0 && m_Position == 0.0;
+
+		// interpolation reads one frame past the last position it lands on
+		int needed = frames;
+		if( !direct )
+			needed = Math::Max( static_cast<int>( m_Position + ( frames - 1 ) * step ) + 2, static_cast<int>( m_Position + frames * step ) );
+
+		if( needed > m_WindowCapacity )
+		{
+			// Manual Allocation: released in Destruct
+			float *window = new float[needed * channels];
+			if( m_WindowFrames > 0 )
+				memcpy( window, m_Window, m_WindowFrames * channels * sizeof(float) );
+
+			delete[] m_Window;
+			m_Window = window;
+			m_WindowCapacity = needed;
+		}
+
+		Fill( needed );
+
+		int consumed;
+		if( direct )
+		{
+			memcpy( m_Buffer, m_Window, frames * channels * sizeof(float) );
+			consumed = frames;
+		}
+		else
+		{
+			Offline::ResampleLinear( m_Window, channels, m_Position, step, m_Buffer, frames );
+
+			double end = m_Position + frames * step;
+			consumed = static_cast<int>( end );
+			m_Position = end - consumed;
+		}
+
+		m_WindowFrames -= consumed;
+		if( m_WindowFrames > 0 )
+			memmove( m_Window, m_Window + consumed * channels, m_WindowFrames * channels * sizeof(float) );
+		m_SamplesPlayed += consumed;
+
+		ProcessChain( frames );
+		Route( frames );
+		return true;
+	}
+
+	void OfflineSourceVoice::RaiseCallbacks()
+	{
+		// handlers may flush the voice, which queues more callbacks for the next quantum;
+		// event arguments are only built when somebody is listening
+		int count = m_Callbacks->Count;
+		for( int i = 0; i < count; i++ )
+		{
+			PendingCallback callback = m_Callbacks[i];
+			switch( callback.Kind )
+			{
+			case CallbackBufferStart:
+				if( &OfflineSourceVoice::BufferStart != nullptr )
+					BufferStart( this, gcnew ContextEventArgs( callback.Context ) );
+				break;
+			case CallbackBufferEnd:
+				if( &OfflineSourceVoice::BufferEnd != nullptr )
+					BufferEnd( this, gcnew ContextEventArgs( callback.Context ) );
+				break;
+			case CallbackLoopEnd:
+				if( &OfflineSourceVoice::LoopEnd != nullptr )
+					LoopEnd( this, gcnew ContextEventArgs( callback.Context ) );
+				break;
+			case CallbackStreamEnd:
+				StreamEnd( this, EventArgs::Empty );
+				break;
+			}
+		}
+
+		m_Callbacks->RemoveRange( 0, count );
+	}
+
+	void OfflineSourceVoice::SubmitSourceBuffer( AudioBuffer^ buffer )
+	{
+		CheckDisposed();
+		if( buffer == nullptr )
+			throw gcnew ArgumentNullException( "buffer" );
+
+		XAUDIO2_BUFFER native = buffer->ToUnmanaged();
+		if( native.pAudioData == NULL )
+			throw gcnew ArgumentException( "The buffer has no audio data.", "buffer" );
+
+		int total = static_cast<int>( native.AudioBytes ) / m_BlockAlignment;
+		int playBegin = static_cast<int>( native.PlayBegin );
+		int playEnd = native.PlayLength == 0 ? total : playBegin + static_cast<int>( native.PlayLength );
+		if( playBegin < 0 || playBegin >= playEnd || playEnd > total )
+			throw gcnew ArgumentException( "The play region lies outside the audio data.", "buffer" );
+
+		OfflineSourceBuffer^ queued = gcnew OfflineSourceBuffer();
+		queued->Buffer = buffer;
+		queued->Data = native.pAudioData;
+		queued->Position = playBegin;
+		queued->PlayEnd = playEnd;
+		queued->EndOfStream = ( native.Flags & XAUDIO2_END_OF_STREAM ) != 0;
+
+		if( native.LoopCount > 0 )
+		{
+			if( native.LoopCount > XAUDIO2_MAX_LOOP_COUNT && native.LoopCount != XAUDIO2_LOOP_INFINITE )
+				throw gcnew ArgumentException( "The loop count is out of range.", "buffer" );
+
+			int loopBegin = static_cast<int>( native.LoopBegin );
+			int loopEnd = native.LoopLength == 0 ? playEnd : loopBegin + static_cast<int>( native.LoopLength );
+			if( loopBegin < 0 || loopBegin >= loopEnd || loopEnd > playEnd || loopEnd <= playBegin )
+				throw gcnew ArgumentException( "The loop region must end inside the play region.", "buffer" );
+
+			queued->LoopBegin = loopBegin;
+			queued->LoopEnd = loopEnd;
+			queued->LoopsLeft = static_cast<int>( native.LoopCount );
+		}
+
+		m_Queue->Enqueue( queued );
+	}
+
+	void OfflineSourceVoice::FlushSourceBuffers()
+	{
+		CheckDisposed();
+
+		for each( OfflineSourceBuffer^ buffer in m_Queue )
+		{
+			m_Callbacks->Add( PendingCallback( CallbackBufferEnd, buffer->Buffer->Context ) );
+		}
+
+		m_Queue->Clear();
+	}
+
+	void OfflineSourceVoice::ExitLoop()
+	{
+		CheckDisposed();
+
+		if( m_Queue->Count > 0 )
+			m_Queue->Peek()->LoopsLeft = 0;
+	}
+
+	void OfflineSourceVoice::Start()
+	{
+		CheckDisposed();
+		m_Running = true;
+	}
+
+	void OfflineSourceVoice::Stop()
+	{
+		CheckDisposed();
+		m_Running = false;
+	}
+
+	VoiceState OfflineSourceVoice::State::get()
+	{
+		CheckDisposed();
+
+		VoiceState state;
+		state.Context = m_Queue->Count > 0 ? m_Queue->Peek()->Buffer->Context : IntPtr::Zero;
+		state.BuffersQueued = m_Queue->Count;
+		state.SamplesPlayed = m_SamplesPlayed;
+		return state;
+	}
+
+	void OfflineSourceVoice::FrequencyRatio::set( float value )
+	{
+		CheckDisposed();
+		if( value < XAUDIO2_MIN_FREQ_RATIO || value > XAUDIO2_MAX_FREQ_RATIO )
+			throw gcnew ArgumentOutOfRangeException( "value" );
+
+		m_FrequencyRatio = value;
+	}
+}
+}
@@ -0,0 +1,190 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "../multimedia/WaveFormat.h"
+
+#include "AudioBuffer.h"
+#include "ContextEventArgs.h"
+#include "VoiceState.h"
+#include "OfflineVoice.h"
+
+namespace SlimDX
+{
+	namespace XAudio2
+	{
+		// A submitted buffer, with its regions in frames.
+		ref class OfflineSourceBuffer sealed
+		{
+		public:
+			AudioBuffer^ Buffer;
+			const unsigned char *Data;
+			int Position;
+			int PlayEnd;
+			int LoopBegin;
+			int LoopEnd;
+			int LoopsLeft;
+			bool EndOfStream;
+			bool Started;
+		};
+
+		/// <summary>
+		/// A source voice of an <see cref="OfflineEngine"/>, which plays submitted PCM or 32-bit float buffers.
+		/// </summary>
+		/// <remarks>
+		/// Buffers are played with their play and loop regions as in XAudio2, and resampled to the rate of the destination voices by
+		/// linear interpolation. A stopped voice is skipped entirely. Callbacks are raised on the thread calling
+		/// <see cref="OfflineEngine::Render(int)"/>, after the quantum in which they happen.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class OfflineSourceVoice : OfflineVoice
+		{
+		private:
+			value class PendingCallback
+			{
+			public:
+				int Kind;
+				System::IntPtr Context;
+
+				PendingCallback( int kind, System::IntPtr context ) : Kind( kind ), Context( context ) { }
+			};
+
+			SlimDX::Multimedia::WaveFormat^ m_Format;
+			int m_SampleType;
+			int m_BlockAlignment;
+			System::Collections::Generic::Queue<OfflineSourceBuffer^>^ m_Queue;
+			System::Collections::Generic::List<PendingCallback>^ m_Callbacks;
+			bool m_Running;
+			float m_FrequencyRatio;
+			System::Int64 m_SamplesPlayed;
+
+			float *m_Window;
+			int m_WindowFrames;
+			int m_WindowCapacity;
+			double m_Position;
+
+			void Fill( int frames );
+
+		internal:
+			void RaiseCallbacks();
+			void Destruct();
+			virtual bool Process( int frames ) override;
+
+			virtual property int ProcessingStage
+			{
+				int get() override { return System::Int32::MinValue; }
+			}
+
+			virtual property int OutputSampleRate
+			{
+				int get() override;
+			}
+
+			property bool IsRunning
+			{
+				bool get() { return m_Running; }
+			}
+
+			property bool IsResampling
+			{
+				bool get() { return m_Running && ( m_FrequencyRatio != 1.0f || OutputSampleRate != m_SampleRate ); }
+			}
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="OfflineSourceVoice"/> class.
+			/// </summary>
+			/// <param name="engine">The engine the voice belongs to.</param>
+			/// <param name="sourceFormat">The format of the submitted buffers: 8, 16, 24 or 32-bit PCM, or 32-bit float.</param>
+			OfflineSourceVoice( OfflineEngine^ engine, SlimDX::Multimedia::WaveFormat^ sourceFormat );
+
+			/// <summary>
+			/// Frees the sample window of the voice.
+			/// </summary>
+			~OfflineSourceVoice();
+			!OfflineSourceVoice();
+
+			/// <summary>
+			/// Queues a buffer for playback. The buffer and its data must stay alive until it ends.
+			/// </summary>
+			/// <param name="buffer">The buffer to play.</param>
+			void SubmitSourceBuffer( AudioBuffer^ buffer );
+
+			/// <summary>
+			/// Removes every queued buffer. Their <see cref="BufferEnd"/> callbacks are raised at the end of the next quantum.
+			/// </summary>
+			void FlushSourceBuffers();
+
+			/// <summary>
+			/// Stops looping the current buffer, which then plays on to its end.
+			/// </summary>
+			void ExitLoop();
+
+			/// <summary>
+			/// Starts consuming and processing audio.
+			/// </summary>
+			void Start();
+
+			/// <summary>
+			/// Stops consuming and processing audio.
+			/// </summary>
+			void Stop();
+
+			/// <summary>
+			/// Gets the state of the voice.
+			/// </summary>
+			property VoiceState State
+			{
+				VoiceState get();
+			}
+
+			/// <summary>
+			/// Gets or sets the frequency adjustment ratio, between 1/1024 and 1024.
+			/// </summary>
+			property float FrequencyRatio
+			{
+				float get() { return m_FrequencyRatio; }
+				void set( float value );
+			}
+
+			/// <summary>
+			/// Occurs when the voice starts playing a buffer.
+			/// </summary>
+			event System::EventHandler<ContextEventArgs^>^ BufferStart;
+
+			/// <summary>
+			/// Occurs when the voice finishes a buffer.
+			/// </summary>
+			event System::EventHandler<ContextEventArgs^>^ BufferEnd;
+
+			/// <summary>
+			/// Occurs when the voice reaches the end of a loop region.
+			/// </summary>
+			event System::EventHandler<ContextEventArgs^>^ LoopEnd;
+
+			/// <summary>
+			/// Occurs when the voice finishes a buffer marked with <see cref="BufferFlags::EndOfStream"/>.
+			/// </summary>
+			event System::EventHandler^ StreamEnd;
+		};
+	}
+}
@@ -0,0 +1,56 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "OfflineEngine.h"
+#include "OfflineSubmixVoice.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace XAudio2
+{
+	OfflineSubmixVoice::OfflineSubmixVoice( OfflineEngine^ engine, int inputChannels, int inputSampleRate )
+	{
+		m_ProcessingStage = 0;
+		Construct( engine, inputChannels, inputSampleRate );
+	}
+
+	OfflineSubmixVoice::OfflineSubmixVoice( OfflineEngine^ engine, int inputChannels, int inputSampleRate, int processingStage )
+	{
+		// the extremes of the range order the source and mastering voices
+		if( processingStage < 0 || processingStage == Int32::MaxValue )
+			throw gcnew ArgumentOutOfRangeException( "processingStage" );
+
+		m_ProcessingStage = processingStage;
+		Construct( engine, inputChannels, inputSampleRate );
+	}
+
+	bool OfflineSubmixVoice::Process( int frames )
+	{
+		ProcessChain( frames );
+		Route( frames );
+		return true;
+	}
+}
+}
@@ -0,0 +1,66 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "OfflineVoice.h"
+
+namespace SlimDX
+{
+	namespace XAudio2
+	{
+		/// <summary>
+		/// A submix voice of an <see cref="OfflineEngine"/>, which mixes the voices that send to it and sends the result on.
+		/// </summary>
+		/// <unmanaged>None</unmanaged>
+		public ref class OfflineSubmixVoice : OfflineVoice
+		{
+		private:
+			int m_ProcessingStage;
+
+		internal:
+			virtual bool Process( int frames ) override;
+
+			virtual property int ProcessingStage
+			{
+				int get() override { return m_ProcessingStage; }
+			}
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="OfflineSubmixVoice"/> class in processing stage 0.
+			/// </summary>
+			/// <param name="engine">The engine the voice belongs to.</param>
+			/// <param name="inputChannels">The number of input channels.</param>
+			/// <param name="inputSampleRate">The input sample rate, which must be that of the mastering voice.</param>
+			OfflineSubmixVoice( OfflineEngine^ engine, int inputChannels, int inputSampleRate );
+
+			/// <summary>
+			/// Initializes a new instance of the <see cref="OfflineSubmixVoice"/> class.
+			/// </summary>
+			/// <param name="engine">The engine the voice belongs to.</param>
+			/// <param name="inputChannels">The number of input channels.</param>
+			/// <param name="inputSampleRate">The input sample rate, which must be that of the mastering voice.</param>
+			/// <param name="processingStage">The processing stage. A submix voice can only send to submix voices in a later stage.</param>
+			OfflineSubmixVoice( OfflineEngine^ engine, int inputChannels, int inputSampleRate, int processingStage );
+		};
+	}
+}
@@ -0,0 +1,672 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <xaudio2.h>
+
+#include "../xapo/DspKernels.h"
+#include "../multimedia/ConversionKernels.h"
+
+#include "OfflineKernels.h"
+#include "OfflineEngine.h"
+#include "OfflineSourceVoice.h"
+#include "OfflineSubmixVoice.h"
+#include "OfflineMasteringVoice.h"
+#include "OfflineVoice.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace SlimDX::Multimedia;
+using namespace SlimDX::XAPO;
+
+namespace SlimDX
+{
+namespace XAudio2
+{
+	static WaveFormat^ CreateFloatFormat( int channels, int sampleRate )
+	{
+		WaveFormat^ format = gcnew WaveFormat();
+		format->FormatTag = WaveFormatTag::IeeeFloat;
+		format->Channels = static_cast<short>( channels );
+		format->SamplesPerSecond = sampleRate;
+		format->BitsPerSample = 32;
+		format->BlockAlignment = static_cast<short>( channels * 4 );
+		format->AverageBytesPerSecond = sampleRate * channels * 4;
+		return format;
+	}
+
+	static SlimDX::XAudio2::FilterParameters DefaultFilter()
+	{
+		SlimDX::XAudio2::FilterParameters filter;
+		filter.Type = FilterType::LowPassFilter;
+		filter.Frequency = 1.0f;
+		filter.OneOverQ = 1.0f;
+		return filter;
+	}
+
+	static array<float>^ CreateUnitVolumes( int channels )
+	{
+		array<float>^ volumes = gcnew array<float>( channels );
+		for( int i = 0; i < channels; i++ )
+			volumes[i] = 1.0f;
+		return volumes;
+	}
+
+	void OfflineVoice::Construct( OfflineEngine^ engine, int channels, int sampleRate )
+	{
+		if( engine == nullptr )
+			throw gcnew ArgumentNullException( "engine" );
+		engine->CheckDisposed();
+		if( channels < 1 || channels > XAUDIO2_MAX_AUDIO_CHANNELS )
+			throw gcnew ArgumentOutOfRangeException( "channels" );
+		if( sampleRate < XAUDIO2_MIN_SAMPLE_RATE || sampleRate > XAUDIO2_MAX_SAMPLE_RATE )
+			throw gcnew ArgumentOutOfRangeException( "sampleRate" );
+
+		m_InputChannels = channels;
+		m_OutputChannels = channels;
+		m_SampleRate = sampleRate;
+		m_Volume = 1.0f;
+		m_ChannelVolumes = CreateUnitVolumes( channels );
+		m_Filter = DefaultFilter();
+		m_Sends = gcnew List<OfflineSend^>();
+		m_EffectInput = gcnew array<BufferParameter>( 1 );
+		m_EffectOutput = gcnew array<BufferParameter>( 1 );
+		m_MinimumCycles = Int32::MaxValue;
+
+		// the voice has to know its engine before it can size its buffers
+		m_Engine = engine;
+		try
+		{
+			// Manual Allocation: released in Destruct
+			m_FilterState = new float[2 * channels];
+			memset( m_FilterState, 0, 2 * channels * sizeof(float) );
+			AllocateBuffers( channels );
+
+			engine->AddVoice( this );
+		}
+		catch( ... )
+		{
+			Destruct();
+			throw;
+		}
+	}
+
+	OfflineVoice::~OfflineVoice()
+	{
+		if( m_Engine != nullptr )
+		{
+			m_Engine->RemoveVoice( this );
+			UnlockEffects();
+			Destruct();
+		}
+
+		GC::SuppressFinalize( this );
+	}
+
+	OfflineVoice::!OfflineVoice()
+	{
+		Destruct();
+	}
+
+	void OfflineVoice::Destruct()
+	{
+		if( m_Sends != nullptr )
+		{
+			for each( OfflineSend^ send in m_Sends )
+				FreeSend( send );
+			m_Sends->Clear();
+		}
+
+		delete[] m_Buffer;
+		delete[] m_Scratch;
+		delete[] m_FilterState;
+		m_Buffer = NULL;
+		m_Scratch = NULL;
+		m_FilterState = NULL;
+		m_BufferChannels = 0;
+		m_Engine = nullptr;
+	}
+
+	void OfflineVoice::CheckDisposed()
+	{
+		if( m_Engine == nullptr )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+	}
+
+	void OfflineVoice::AllocateBuffers( int channels )
+	{
+		if( channels <= m_BufferChannels )
+			return;
+
+		int samples = channels * m_Engine->QuantumFrames;
+
+		// Manual Allocation: released in Destruct
+		float *buffer = new float[samples];
+		float *scratch = NULL;
+		try
+		{
+			scratch = new float[samples];
+		}
+		catch( ... )
+		{
+			delete[] buffer;
+			throw;
+		}
+
+		delete[] m_Buffer;
+		delete[] m_Scratch;
+		m_Buffer = buffer;
+		m_Scratch = scratch;
+		m_BufferChannels = channels;
+	}
+
+	void OfflineVoice::UnlockEffects()
+	{
+		if( m_Effects == nullptr )
+			return;
+
+		for( int i = 0; i < m_Effects->Length; i++ )
+			m_Effects[i].Effect->UnlockForProcess();
+		m_Effects = nullptr;
+		m_EffectEnabled = nullptr;
+		m_EffectChannels = nullptr;
+		m_EffectInPlace = nullptr;
+	}
+
+	OfflineSend^ OfflineVoice::CreateSend( OfflineVoice^ target, VoiceSendFlags flags )
+	{
+		int sourceChannels = m_OutputChannels;
+		int destinationChannels = target->m_InputChannels;
+
+		OfflineSend^ send = gcnew OfflineSend();
+		send->Target = target;
+		send->Flags = flags;
+		send->Filter = DefaultFilter();
+		send->Matrix = gcnew array<float>( sourceChannels * destinationChannels );
+
+		try
+		{
+			// Manual Allocation: released in FreeSend
+			send->Levels = new float[sourceChannels * destinationChannels];
+			send->FilterState = new float[2 * sourceChannels];
+			memset( send->FilterState, 0, 2 * sourceChannels * sizeof(float) );
+		}
+		catch( ... )
+		{
+			FreeSend( send );
+			throw;
+		}
+
+		Multimedia::Conversion::BuildChannelMatrix( Multimedia::Conversion::DefaultChannelMask( sourceChannels ), sourceChannels,
+			Multimedia::Conversion::DefaultChannelMask( destinationChannels ), destinationChannels, send->Levels );
+
+		pin_ptr<float> pinnedMatrix = &send->Matrix[0];
+		memcpy( pinnedMatrix, send->Levels, sourceChannels * destinationChannels * sizeof(float) );
+		return send;
+	}
+
+	void OfflineVoice::FreeSend( OfflineSend^ send )
+	{
+		delete[] send->Levels;
+		delete[] send->FilterState;
+		send->Levels = NULL;
+		send->FilterState = NULL;
+	}
+
+	OfflineSend^ OfflineVoice::FindSend( OfflineVoice^ destinationVoice, String^ name )
+	{
+		CheckDisposed();
+		if( destinationVoice == nullptr )
+			throw gcnew ArgumentNullException( name );
+
+		ResolveDefaultSend();
+		for each( OfflineSend^ send in m_Sends )
+		{
+			if( send->Target == destinationVoice )
+				return send;
+		}
+
+		throw gcnew ArgumentException( "The voice does not send to the destination voice.", name );
+	}
+
+	void OfflineVoice::ResolveDefaultSend()
+	{
+		// like XAudio2, a voice without explicit sends feeds the mastering voice
+		OfflineVoice^ mastering = m_Engine->m_MasteringVoice;
+		if( m_SendsSet || m_Sends->Count > 0 || mastering == nullptr || mastering == this )
+			return;
+
+		m_Sends->Add( CreateSend( mastering, VoiceSendFlags::None ) );
+	}
+
+	void OfflineVoice::RemoveSendsTo( OfflineVoice^ target )
+	{
+		for( int i = m_Sends->Count - 1; i >= 0; i-- )
+		{
+			if( m_Sends[i]->Target == target )
+			{
+				FreeSend( m_Sends[i] );
+				m_Sends->RemoveAt( i );
+			}
+		}
+	}
+
+	void OfflineVoice::RecordCycles( unsigned long long cycles )
+	{
+		int quantum = cycles > static_cast<unsigned long long>( Int32::MaxValue ) ? Int32::MaxValue : static_cast<int>( cycles );
+
+		m_Cycles += static_cast<Int64>( cycles );
+		if( quantum < m_MinimumCycles )
+			m_MinimumCycles = quantum;
+		if( quantum > m_MaximumCycles )
+			m_MaximumCycles = quantum;
+	}
+
+	void OfflineVoice::ClearBuffer( int frames )
+	{
+		memset( m_Buffer, 0, frames * m_InputChannels * sizeof(float) );
+	}
+
+	void OfflineVoice::ProcessChain( int frames )
+	{
+		if( m_FilterEnabled )
+		{
+			Offline::ApplyFilter( m_Buffer, m_InputChannels, frames, static_cast<Offline::FilterKind>( m_Filter.Type ),
+				m_Filter.Frequency, m_Filter.OneOverQ, m_FilterState );
+		}
+
+		if( m_Effects == nullptr )
+			return;
+
+		int channels = m_InputChannels;
+		for( int i = 0; i < m_Effects->Length; i++ )
+		{
+			int outputChannels = m_EffectChannels[i];
+			bool inPlace = m_EffectInPlace[i];
+			float *output = inPlace ? m_Buffer : m_Scratch;
+
+			m_EffectInput[0].Buffer = IntPtr( m_Buffer );
+			m_EffectInput[0].Flags = BufferFlags::Valid;
+			m_EffectInput[0].ValidFrameCount = frames;
+			m_EffectOutput[0].Buffer = IntPtr( output );
+			m_EffectOutput[0].Flags = BufferFlags::Valid;
+			m_EffectOutput[0].ValidFrameCount = frames;
+
+			m_Effects[i].Effect->Process( m_EffectInput, m_EffectOutput, m_EffectEnabled[i] );
+
+			// a silent output may leave the buffer untouched, and the rest of the graph expects real samples
+			if( m_EffectOutput[0].Flags == BufferFlags::Silent )
+				memset( output, 0, frames * outputChannels * sizeof(float) );
+
+			if( !inPlace )
+			{
+				m_Scratch = m_Buffer;
+				m_Buffer = output;
+			}
+
+			channels = outputChannels;
+		}
+	}
+
+	void OfflineVoice::ApplyVolumes( int frames )
+	{
+		int channels = m_OutputChannels;
+		float gains[XAUDIO2_MAX_AUDIO_CHANNELS];
+		for( int c = 0; c < channels; c++ )
+			gains[c] = m_Volume * m_ChannelVolumes[c];
+
+		float *samples = m_Buffer;
+		for( int f = 0; f < frames; f++ )
+		{
+			for( int c = 0; c < channels; c++ )
+				samples[c] *= gains[c];
+			samples += channels;
+		}
+	}
+
+	void OfflineVoice::Route( int frames )
+	{
+		ResolveDefaultSend();
+
+		int sourceChannels = m_OutputChannels;
+		for( int i = 0; i < m_Sends->Count; i++ )
+		{
+			OfflineSend^ send = m_Sends[i];
+			OfflineVoice^ target = send->Target;
+			int destinationChannels = target->m_InputChannels;
+
+			// the voice and channel volumes are folded into the matrix so each send is a single pass
+			for( int d = 0; d < destinationChannels; d++ )
+			{
+				for( int s = 0; s < sourceChannels; s++ )
+				{
+					int index = d * sourceChannels + s;
+					send->Levels[index] = send->Matrix[index] * m_Volume * m_ChannelVolumes[s];
+				}
+			}
+
+			const float *source = m_Buffer;
+			if( ( send->Flags & VoiceSendFlags::UseFilter ) == VoiceSendFlags::UseFilter )
+			{
+				memcpy( m_Scratch, m_Buffer, frames * sourceChannels * sizeof(float) );
+				Offline::ApplyFilter( m_Scratch, sourceChannels, frames, static_cast<Offline::FilterKind>( send->Filter.Type ),
+					send->Filter.Frequency, send->Filter.OneOverQ, send->FilterState );
+				source = m_Scratch;
+			}
+
+			XAPO::Dsp::MixMatrix( source, sourceChannels, target->m_Buffer, destinationChannels, frames, send->Levels, true );
+		}
+	}
+
+	void OfflineVoice::EnableEffect( int effectIndex )
+	{
+		CheckDisposed();
+		if( m_Effects == nullptr || effectIndex < 0 || effectIndex >= m_Effects->Length )
+			throw gcnew ArgumentOutOfRangeException( "effectIndex" );
+
+		m_EffectEnabled[effectIndex] = true;
+	}
+
+	void OfflineVoice::DisableEffect( int effectIndex )
+	{
+		CheckDisposed();
+		if( m_Effects == nullptr || effectIndex < 0 || effectIndex >= m_Effects->Length )
+			throw gcnew ArgumentOutOfRangeException( "effectIndex" );
+
+		m_EffectEnabled[effectIndex] = false;
+	}
+
+	bool OfflineVoice::IsEffectEnabled( int effectIndex )
+	{
+		CheckDisposed();
+		if( m_Effects == nullptr || effectIndex < 0 || effectIndex >= m_Effects->Length )
+			throw gcnew ArgumentOutOfRangeException( "effectIndex" );
+
+		return m_EffectEnabled[effectIndex];
+	}
+
+	void OfflineVoice::SetEffectChain( array<EffectDescriptor>^ effects )
+	{
+		CheckDisposed();
+
+		int count = effects == nullptr ? 0 : effects->Length;
+		array<int>^ channels = gcnew array<int>( count );
+		int widest = m_InputChannels;
+		int current = m_InputChannels;
+
+		for( int i = 0; i < count; i++ )
+		{
+			if( effects[i].Effect == nullptr )
+				throw gcnew ArgumentException( "Every effect descriptor must have an effect.", "effects" );
+
+			int output = effects[i].OutputChannelCount > 0 ? effects[i].OutputChannelCount : current;
+			if( output > XAUDIO2_MAX_AUDIO_CHANNELS )
+				throw gcnew ArgumentException( "An effect has too many output channels.", "effects" );
+
+			channels[i] = output;
+			widest = Math::Max( widest, output );
+			current = output;
+		}
+
+		UnlockEffects();
+		AllocateBuffers( widest );
+
+		array<bool>^ inPlace = gcnew array<bool>( count );
+		current = m_InputChannels;
+		for( int i = 0; i < count; i++ )
+		{
+			array<LockParameter>^ input = gcnew array<LockParameter>( 1 );
+			array<LockParameter>^ output = gcnew array<LockParameter>( 1 );
+			input[0].Format = CreateFloatFormat( current, m_SampleRate );
+			input[0].MaxFrameCount = m_Engine->QuantumFrames;
+			output[0].Format = CreateFloatFormat( channels[i], m_SampleRate );
+			output[0].MaxFrameCount = m_Engine->QuantumFrames;
+
+			if( effects[i].Effect->LockForProcess( input, output ).IsFailure )
+			{
+				for( int j = 0; j < i; j++ )
+					effects[j].Effect->UnlockForProcess();
+				throw gcnew InvalidOperationException( "An effect could not be locked for processing." );
+			}
+
+			PropertyFlags flags = effects[i].Effect->RegistrationProperties.Flags;
+			inPlace[i] = channels[i] == current && ( flags & ( PropertyFlags::InPlaceSupported | PropertyFlags::InPlaceRequired ) ) != static_cast<PropertyFlags>( 0 );
+			current = channels[i];
+		}
+
+		if( count > 0 )
+		{
+			m_Effects = safe_cast<array<EffectDescriptor>^>( effects->Clone() );
+			m_EffectChannels = channels;
+			m_EffectInPlace = inPlace;
+			m_EffectEnabled = gcnew array<bool>( count );
+			for( int i = 0; i < count; i++ )
+				m_EffectEnabled[i] = effects[i].InitiallyStarted;
+		}
+
+		if( current != m_OutputChannels )
+		{
+			// the sends were built for the old channel count
+			m_OutputChannels = current;
+			m_ChannelVolumes = CreateUnitVolumes( current );
+
+			for( int i = 0; i < m_Sends->Count; i++ )
+			{
+				OfflineSend^ send = CreateSend( m_Sends[i]->Target, m_Sends[i]->Flags );
+				FreeSend( m_Sends[i] );
+				m_Sends[i] = send;
+			}
+		}
+	}
+
+	array<float>^ OfflineVoice::GetChannelVolumes( int channels )
+	{
+		CheckDisposed();
+		if( channels != m_OutputChannels )
+			throw gcnew ArgumentOutOfRangeException( "channels" );
+
+		return safe_cast<array<float>^>( m_ChannelVolumes->Clone() );
+	}
+
+	void OfflineVoice::SetChannelVolumes( int channels, array<float>^ volumes )
+	{
+		CheckDisposed();
+		if( channels != m_OutputChannels )
+			throw gcnew ArgumentOutOfRangeException( "channels" );
+		if( volumes == nullptr )
+			throw gcnew ArgumentNullException( "volumes" );
+		if( volumes->Length < channels )
+			throw gcnew ArgumentException( "There must be a volume for each channel.", "volumes" );
+
+		Array::Copy( volumes, m_ChannelVolumes, channels );
+	}
+
+	array<float>^ OfflineVoice::GetOutputMatrix( OfflineVoice^ destinationVoice, int sourceChannels, int destinationChannels )
+	{
+		OfflineSend^ send = FindSend( destinationVoice, "destinationVoice" );
+		if( sourceChannels != m_OutputChannels )
+			throw gcnew ArgumentOutOfRangeException( "sourceChannels" );
+		if( destinationChannels != destinationVoice->m_InputChannels )
+			throw gcnew ArgumentOutOfRangeException( "destinationChannels" );
+
+		return safe_cast<array<float>^>( send->Matrix->Clone() );
+	}
+
+	void OfflineVoice::SetOutputMatrix( OfflineVoice^ destinationVoice, int sourceChannels, int destinationChannels, array<float>^ matrix )
+	{
+		OfflineSend^ send = FindSend( destinationVoice, "destinationVoice" );
+		if( sourceChannels != m_OutputChannels )
+			throw gcnew ArgumentOutOfRangeException( "sourceChannels" );
+		if( destinationChannels != destinationVoice->m_InputChannels )
+			throw gcnew ArgumentOutOfRangeException( "destinationChannels" );
+		if( matrix == nullptr )
+			throw gcnew ArgumentNullException( "matrix" );
+		if( matrix->Length < sourceChannels * destinationChannels )
+			throw gcnew ArgumentException( "The matrix must have a level for each pair of channels.", "matrix" );
+
+		Array::Copy( matrix, send->Matrix, sourceChannels * destinationChannels );
+	}
+
+	void OfflineVoice::SetOutputVoices( array<OfflineVoiceSend>^ outputVoices )
+	{
+		CheckDisposed();
+
+		int count = outputVoices == nullptr ? 0 : outputVoices->Length;
+		int rate = 0;
+		for( int i = 0; i < count; i++ )
+		{
+			OfflineVoice^ target = outputVoices[i].OutputVoice;
+			if( target == nullptr )
+				throw gcnew ArgumentException( "Every send must have an output voice.", "outputVoices" );
+			if( target->m_Engine != m_Engine )
+				throw gcnew ArgumentException( "An output voice belongs to another engine or has been disposed.", "outputVoices" );
+			if( target->ProcessingStage <= ProcessingStage )
+				throw gcnew ArgumentException( "A voice can only send to a submix voice in a later processing stage or to the mastering voice.", "outputVoices" );
+
+			// sources resample to their destinations, everything else must already match them
+			if( ProcessingStage != Int32::MinValue && target->m_SampleRate != m_SampleRate )
+				throw gcnew ArgumentException( "An output voice has a different sample rate.", "outputVoices" );
+			if( i > 0 && target->m_SampleRate != rate )
+				throw gcnew ArgumentException( "All output voices must have the same sample rate.", "outputVoices" );
+			rate = target->m_SampleRate;
+
+			for( int j = 0; j < i; j++ )
+			{
+				if( outputVoices[j].OutputVoice == target )
+					throw gcnew ArgumentException( "An output voice appears more than once.", "outputVoices" );
+			}
+		}
+
+		List<OfflineSend^>^ sends = gcnew List<OfflineSend^>( count );
+		try
+		{
+			for( int i = 0; i < count; i++ )
+				sends->Add( CreateSend( outputVoices[i].OutputVoice, outputVoices[i].Flags ) );
+		}
+		catch( ... )
+		{
+			for each( OfflineSend^ send in sends )
+				FreeSend( send );
+			throw;
+		}
+
+		for each( OfflineSend^ send in m_Sends )
+			FreeSend( send );
+
+		m_Sends = sends;
+		m_SendsSet = outputVoices != nullptr;
+	}
+
+	SlimDX::XAudio2::FilterParameters OfflineVoice::GetOutputFilterParameters( OfflineVoice^ destinationVoice )
+	{
+		return FindSend( destinationVoice, "destinationVoice" )->Filter;
+	}
+
+	void OfflineVoice::SetOutputFilterParameters( OfflineVoice^ destinationVoice, SlimDX::XAudio2::FilterParameters parameters )
+	{
+		OfflineSend^ send = FindSend( destinationVoice, "destinationVoice" );
+		if( parameters.Frequency < 0.0f || parameters.Frequency > XAUDIO2_MAX_FILTER_FREQUENCY )
+			throw gcnew ArgumentOutOfRangeException( "parameters" );
+		if( parameters.OneOverQ <= 0.0f || parameters.OneOverQ > XAUDIO2_MAX_FILTER_ONEOVERQ )
+			throw gcnew ArgumentOutOfRangeException( "parameters" );
+
+		send->Filter = parameters;
+	}
+
+	SlimDX::XAudio2::FilterParameters OfflineVoice::FilterParameters::get()
+	{
+		return m_Filter;
+	}
+
+	void OfflineVoice::FilterParameters::set( SlimDX::XAudio2::FilterParameters value )
+	{
+		CheckDisposed();
+		if( value.Frequency < 0.0f || value.Frequency > XAUDIO2_MAX_FILTER_FREQUENCY )
+			throw gcnew ArgumentOutOfRangeException( "value" );
+		if( value.OneOverQ <= 0.0f || value.OneOverQ > XAUDIO2_MAX_FILTER_ONEOVERQ )
+			throw gcnew ArgumentOutOfRangeException( "value" );
+
+		m_Filter = value;
+		m_FilterEnabled = true;
+	}
+
+	float OfflineVoice::Volume::get()
+	{
+		return m_Volume;
+	}
+
+	void OfflineVoice::Volume::set( float value )
+	{
+		CheckDisposed();
+		if( value < -XAUDIO2_MAX_VOLUME_LEVEL || value > XAUDIO2_MAX_VOLUME_LEVEL )
+			throw gcnew ArgumentOutOfRangeException( "value" );
+
+		m_Volume = value;
+	}
+
+	SlimDX::XAudio2::VoiceDetails OfflineVoice::VoiceDetails::get()
+	{
+		SlimDX::XAudio2::VoiceDetails details;
+		details.CreationFlags = VoiceFlags::None;
+		details.InputChannels = m_InputChannels;
+		details.InputSampleRate = m_SampleRate;
+		return details;
+	}
+
+	SlimDX::XAudio2::PerformanceData^ OfflineVoice::PerformanceData::get()
+	{
+		CheckDisposed();
+
+		SlimDX::XAudio2::PerformanceData^ data = gcnew SlimDX::XAudio2::PerformanceData();
+		data->AudioCyclesSinceLastQuery = m_Cycles;
+		data->TotalCyclesSinceLastQuery = m_Engine->GetRenderCycles() - m_RenderCyclesAtQuery;
+		data->MinimumCyclesPerQuantum = m_MinimumCycles == Int32::MaxValue ? 0 : m_MinimumCycles;
+		data->MaximumCyclesPerQuantum = m_MaximumCycles;
+		data->MemoryUsageInBytes = 2 * m_BufferChannels * m_Engine->QuantumFrames * 4;
+
+		OfflineSourceVoice^ source = dynamic_cast<OfflineSourceVoice^>( this );
+		if( source != nullptr )
+		{
+			data->TotalSourceVoiceCount = 1;
+			data->ActiveSourceVoiceCount = source->IsRunning ? 1 : 0;
+		}
+		else if( dynamic_cast<OfflineSubmixVoice^>( this ) != nullptr )
+		{
+			data->ActiveSubmixVoiceCount = 1;
+#if SLIMDX_XAUDIO2_VERSION < 23
+			data->TotalSubmixVoiceCount = 1;
+#endif
+		}
+
+#if SLIMDX_XAUDIO2_VERSION >= 23
+		data->ActiveResamplerCount = source != nullptr && source->IsResampling ? 1 : 0;
+		data->ActiveMatrixMixCount = m_Sends->Count;
+#endif
+
+		m_Cycles = 0;
+		m_MinimumCycles = Int32::MaxValue;
+		m_MaximumCycles = 0;
+		m_RenderCyclesAtQuery = m_Engine->GetRenderCycles();
+		return data;
+	}
+}
+}
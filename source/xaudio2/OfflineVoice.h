@@ -0,0 +1,257 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "../xapo/BufferParameter.h"
+
+#include "FilterParameters.h"
+#include "VoiceDetails.h"
+#include "EffectDescriptor.h"
+#include "PerformanceData.h"
+#include "OfflineVoiceSend.h"
+
+namespace SlimDX
+{
+	namespace XAudio2
+	{
+		ref class OfflineEngine;
+
+		// The state kept for each send of a voice.
+		ref class OfflineSend sealed
+		{
+		public:
+			OfflineVoice^ Target;
+			VoiceSendFlags Flags;
+			array<float>^ Matrix;
+			float *Levels;
+			SlimDX::XAudio2::FilterParameters Filter;
+			float *FilterState;
+		};
+
+		/// <summary>
+		/// The base class for the voices of an <see cref="OfflineEngine"/>, which mirror the XAudio2 voices but are processed on
+		/// the CPU by <see cref="OfflineEngine::Render(int)"/>.
+		/// </summary>
+		/// <remarks>
+		/// Every voice runs its filter, its effect chain, and then its volume, channel volumes and output matrices, in the same order as
+		/// XAudio2. Sends default to the mastering voice, and default output matrices route each speaker to the same speaker of the
+		/// destination. Effects are run as managed <see cref="SlimDX::XAPO::IAudioProcessor"/> objects on 32-bit float buffers.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class OfflineVoice abstract : System::IDisposable
+		{
+		private:
+			array<SlimDX::XAPO::BufferParameter>^ m_EffectInput;
+			array<SlimDX::XAPO::BufferParameter>^ m_EffectOutput;
+
+			void Destruct();
+			void UnlockEffects();
+			void AllocateBuffers( int channels );
+			OfflineSend^ FindSend( OfflineVoice^ destinationVoice, System::String^ name );
+			OfflineSend^ CreateSend( OfflineVoice^ target, VoiceSendFlags flags );
+			void FreeSend( OfflineSend^ send );
+
+		internal:
+			OfflineEngine^ m_Engine;
+			int m_InputChannels;
+			int m_OutputChannels;
+			int m_SampleRate;
+			float *m_Buffer;
+			float *m_Scratch;
+			int m_BufferChannels;
+
+			float m_Volume;
+			array<float>^ m_ChannelVolumes;
+			SlimDX::XAudio2::FilterParameters m_Filter;
+			bool m_FilterEnabled;
+			float *m_FilterState;
+
+			System::Collections::Generic::List<OfflineSend^>^ m_Sends;
+			bool m_SendsSet;
+			array<EffectDescriptor>^ m_Effects;
+			array<bool>^ m_EffectEnabled;
+			array<int>^ m_EffectChannels;
+			array<bool>^ m_EffectInPlace;
+
+			System::Int64 m_Cycles;
+			int m_MinimumCycles;
+			int m_MaximumCycles;
+			System::Int64 m_RenderCyclesAtQuery;
+
+			void Construct( OfflineEngine^ engine, int channels, int sampleRate );
+			void CheckDisposed();
+			void ClearBuffer( int frames );
+			void ProcessChain( int frames );
+			void ApplyVolumes( int frames );
+			void Route( int frames );
+			void ResolveDefaultSend();
+			void RemoveSendsTo( OfflineVoice^ target );
+			void RecordCycles( unsigned long long cycles );
+
+			// Returns false when the voice had nothing to do this quantum.
+			virtual bool Process( int frames ) abstract;
+
+			// Sources come first, then submix voices in stage order, then the mastering voice.
+			virtual property int ProcessingStage
+			{
+				int get() abstract;
+			}
+
+			// The sample rate the voice outputs at, which for a source voice is that of its destinations.
+			virtual property int OutputSampleRate
+			{
+				int get() { return m_SampleRate; }
+			}
+
+		protected:
+			OfflineVoice() { }
+
+		public:
+			/// <summary>
+			/// Releases the voice, removing it from the engine.
+			/// </summary>
+			~OfflineVoice();
+			!OfflineVoice();
+
+			/// <summary>
+			/// Enables an effect in the effect chain of the voice.
+			/// </summary>
+			/// <param name="effectIndex">The index of the effect.</param>
+			void EnableEffect( int effectIndex );
+
+			/// <summary>
+			/// Disables an effect in the effect chain of the voice. Disabled effects are still called, with <c>isEnabled</c> set to <c>false</c>.
+			/// </summary>
+			/// <param name="effectIndex">The index of the effect.</param>
+			void DisableEffect( int effectIndex );
+
+			/// <summary>
+			/// Gets a value indicating whether an effect in the effect chain is enabled.
+			/// </summary>
+			/// <param name="effectIndex">The index of the effect.</param>
+			/// <returns><c>true</c> if the effect is enabled; otherwise, <c>false</c>.</returns>
+			bool IsEffectEnabled( int effectIndex );
+
+			/// <summary>
+			/// Replaces the effect chain of the voice. Each effect is locked for 32-bit float processing at the sample rate of the voice.
+			/// </summary>
+			/// <param name="effects">The new effect chain, or <c>null</c> to remove all effects.</param>
+			void SetEffectChain( array<EffectDescriptor>^ effects );
+
+			/// <summary>
+			/// Gets the volume levels of the output channels of the voice.
+			/// </summary>
+			/// <param name="channels">The number of output channels of the voice.</param>
+			/// <returns>The channel volumes.</returns>
+			array<float>^ GetChannelVolumes( int channels );
+
+			/// <summary>
+			/// Sets the volume levels of the output channels of the voice.
+			/// </summary>
+			/// <param name="channels">The number of output channels of the voice.</param>
+			/// <param name="volumes">The channel volumes.</param>
+			void SetChannelVolumes( int channels, array<float>^ volumes );
+
+			/// <summary>
+			/// Gets the level matrix used for a send of the voice.
+			/// </summary>
+			/// <param name="destinationVoice">The destination of the send.</param>
+			/// <param name="sourceChannels">The number of output channels of the voice.</param>
+			/// <param name="destinationChannels">The number of input channels of the destination voice.</param>
+			/// <returns>The destination-major level matrix.</returns>
+			array<float>^ GetOutputMatrix( OfflineVoice^ destinationVoice, int sourceChannels, int destinationChannels );
+
+			/// <summary>
+			/// Sets the level matrix used for a send of the voice.
+			/// </summary>
+			/// <param name="destinationVoice">The destination of the send.</param>
+			/// <param name="sourceChannels">The number of output channels of the voice.</param>
+			/// <param name="destinationChannels">The number of input channels of the destination voice.</param>
+			/// <param name="matrix">The destination-major level matrix, laid out as for <see cref="Voice"/>.</param>
+			void SetOutputMatrix( OfflineVoice^ destinationVoice, int sourceChannels, int destinationChannels, array<float>^ matrix );
+
+			/// <summary>
+			/// Replaces the sends of the voice.
+			/// </summary>
+			/// <param name="outputVoices">The new sends, or <c>null</c> to send to the mastering voice.</param>
+			void SetOutputVoices( array<OfflineVoiceSend>^ outputVoices );
+
+			/// <summary>
+			/// Gets the filter applied to a send that was set up with <see cref="VoiceSendFlags::UseFilter"/>.
+			/// </summary>
+			/// <param name="destinationVoice">The destination of the send.</param>
+			/// <returns>The filter parameters of the send.</returns>
+			SlimDX::XAudio2::FilterParameters GetOutputFilterParameters( OfflineVoice^ destinationVoice );
+
+			/// <summary>
+			/// Sets the filter applied to a send that was set up with <see cref="VoiceSendFlags::UseFilter"/>.
+			/// </summary>
+			/// <param name="destinationVoice">The destination of the send.</param>
+			/// <param name="parameters">The filter parameters of the send.</param>
+			void SetOutputFilterParameters( OfflineVoice^ destinationVoice, SlimDX::XAudio2::FilterParameters parameters );
+
+			/// <summary>
+			/// Gets or sets the filter applied to the input of the voice. The filter is bypassed until it is first set.
+			/// </summary>
+			property SlimDX::XAudio2::FilterParameters FilterParameters
+			{
+				SlimDX::XAudio2::FilterParameters get();
+				void set( SlimDX::XAudio2::FilterParameters value );
+			}
+
+			/// <summary>
+			/// Gets or sets the overall volume of the voice.
+			/// </summary>
+			property float Volume
+			{
+				float get();
+				void set( float value );
+			}
+
+			/// <summary>
+			/// Gets the channel count and sample rate of the input of the voice.
+			/// </summary>
+			property SlimDX::XAudio2::VoiceDetails VoiceDetails
+			{
+				SlimDX::XAudio2::VoiceDetails get();
+			}
+
+			/// <summary>
+			/// Gets the processing cost of the voice since the last query. <see cref="SlimDX::XAudio2::PerformanceData::AudioCyclesSinceLastQuery"/>
+			/// counts the cycles spent on this voice, and <see cref="SlimDX::XAudio2::PerformanceData::TotalCyclesSinceLastQuery"/> the cycles
+			/// spent rendering the whole graph over the same period.
+			/// </summary>
+			property SlimDX::XAudio2::PerformanceData^ PerformanceData
+			{
+				SlimDX::XAudio2::PerformanceData^ get();
+			}
+
+			/// <summary>
+			/// Gets the engine the voice belongs to.
+			/// </summary>
+			property OfflineEngine^ Engine
+			{
+				OfflineEngine^ get() { return m_Engine; }
+			}
+		};
+	}
+}
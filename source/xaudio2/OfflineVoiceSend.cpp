@@ -0,0 +1,80 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <xaudio2.h>
+
+#include "OfflineVoice.h"
+#include "OfflineVoiceSend.h"
+
+using namespace System;
+
+namespace SlimDX
+{
+namespace XAudio2
+{
+	OfflineVoiceSend::OfflineVoiceSend( OfflineVoice^ voice, VoiceSendFlags flags )
+	{
+		if( voice == nullptr )
+			throw gcnew ArgumentNullException( "voice" );
+
+		OutputVoice = voice;
+		Flags = flags;
+	}
+
+	bool OfflineVoiceSend::operator == ( OfflineVoiceSend left, OfflineVoiceSend right )
+	{
+		return OfflineVoiceSend::Equals( left, right );
+	}
+
+	bool OfflineVoiceSend::operator != ( OfflineVoiceSend left, OfflineVoiceSend right )
+	{
+		return !OfflineVoiceSend::Equals( left, right );
+	}
+
+	int OfflineVoiceSend::GetHashCode()
+	{
+		return ( OutputVoice == nullptr ? 0 : OutputVoice->GetHashCode() ) + Flags.GetHashCode();
+	}
+
+	bool OfflineVoiceSend::Equals( Object^ value )
+	{
+		if( value == nullptr )
+			return false;
+
+		if( value->GetType() != GetType() )
+			return false;
+
+		return Equals( safe_cast<OfflineVoiceSend>( value ) );
+	}
+
+	bool OfflineVoiceSend::Equals( OfflineVoiceSend value )
+	{
+		return ( OutputVoice == value.OutputVoice && Flags == value.Flags );
+	}
+
+	bool OfflineVoiceSend::Equals( OfflineVoiceSend% value1, OfflineVoiceSend% value2 )
+	{
+		return ( value1.OutputVoice == value2.OutputVoice && value1.Flags == value2.Flags );
+	}
+}
+}
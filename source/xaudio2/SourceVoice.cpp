@@ -56,6 +56,7 @@ namespace XAudio2
 			throw gcnew XAudio2Exception( Result::Last );
 
 		InternalPointer = pointer;
+		pendingBuffers = gcnew array<AudioBuffer^>( MaxPendingBuffers );
 	}
 
 	SourceVoice::SourceVoice( XAudio2^ device, WaveFormat^ sourceFormat, VoiceFlags flags )
@@ -72,6 +73,7 @@ namespace XAudio2
 			throw gcnew XAudio2Exception( Result::Last );
 
 		InternalPointer = pointer;
+		pendingBuffers = gcnew array<AudioBuffer^>( MaxPendingBuffers );
 	}
 
 	SourceVoice::SourceVoice( XAudio2^ device, WaveFormat^ sourceFormat )
@@ -88,6 +90,7 @@ namespace XAudio2
 			throw gcnew XAudio2Exception( Result::Last );
 
 		InternalPointer = pointer;
+		pendingBuffers = gcnew array<AudioBuffer^>( MaxPendingBuffers );
 	}
 
 	SourceVoice::~SourceVoice()
@@ -96,11 +99,148 @@ namespace XAudio2
 			InternalPointer->DestroyVoice();
 		InternalPointer = NULL;
 
+		// a destroyed voice reports no more buffer ends, so give back whatever it was still holding
+		ReleasePendingBuffers();
+		CallbackQueue = nullptr;
+
 		if( callback != NULL )
 			delete callback;
 		callback = NULL;
 	}
 
+	bool SourceVoice::BeginSubmit( AudioBuffer^ buffer )
+	{
+		// publish before submitting, since the engine may finish a short buffer before SubmitSourceBuffer returns
+		int tail = pendingTail;
+		if( tail - Threading::Thread::VolatileRead( pendingHead ) >= MaxPendingBuffers )
+			return false;
+
+		AudioBufferPool^ pool = buffer->pool;
+		if( pool != nullptr )
+			pool->AddSubmission( buffer );
+
+		pendingBuffers[tail & (MaxPendingBuffers - 1)] = pool != nullptr ? buffer : nullptr;
+		Threading::Thread::VolatileWrite( pendingTail, tail + 1 );
+		return true;
+	}
+
+	void SourceVoice::CancelSubmit( AudioBuffer^ buffer )
+	{
+		// a rejected buffer never gets a BufferEnd, and nothing queued after it exists yet
+		Threading::Thread::VolatileWrite( pendingTail, pendingTail - 1 );
+
+		if( buffer->pool != nullptr )
+			buffer->pool->CancelSubmission( buffer );
+	}
+
+	void SourceVoice::CompleteBuffer()
+	{
+		int head = pendingHead;
+		if( head == Threading::Thread::VolatileRead( pendingTail ) )
+			return;
+
+		AudioBuffer^ buffer = pendingBuffers[head & (MaxPendingBuffers - 1)];
+		pendingBuffers[head & (MaxPendingBuffers - 1)] = nullptr;
+		Threading::Thread::VolatileWrite( pendingHead, head + 1 );
+
+		if( buffer != nullptr )
+			buffer->pool->CompleteSubmission( buffer );
+	}
+
+	void SourceVoice::ReleasePendingBuffers()
+	{
+		if( pendingBuffers == nullptr )
+			return;
+
+		while( pendingHead != pendingTail )
+			CompleteBuffer();
+	}
+
+	void SourceVoice::Dispatch( VoiceCallbackKind kind, void *context, int value )
+	{
+		// recycle first, so a handler that refills the voice can rent the buffer that just finished
+		if( kind == VoiceCallbackKind::BufferEnd )
+		{
+			CompleteBuffer();
+
+			Threading::EventWaitHandle^ signal = bufferEndSignal;
+			if( signal != nullptr )
+				signal->Set();
+		}
+
+		VoiceCallbackQueue^ queue = callbackQueue;
+		if( queue != nullptr )
+		{
+			queue->Post( callbackToken, kind, context, value );
+			return;
+		}
+
+		VoiceCallbackHandler^ handler = callbackHandler;
+		if( handler != nullptr )
+		{
+			handler( VoiceCallbackRecord( this, kind, IntPtr( context ), value ) );
+			return;
+		}
+
+		// only build event arguments when somebody is listening
+		switch( kind )
+		{
+		case VoiceCallbackKind::BufferStart:
+			if( &SourceVoice::BufferStart != nullptr )
+				OnBufferStart( gcnew ContextEventArgs( IntPtr( context ) ) );
+			break;
+
+		case VoiceCallbackKind::BufferEnd:
+			if( &SourceVoice::BufferEnd != nullptr )
+				OnBufferEnd( gcnew ContextEventArgs( IntPtr( context ) ) );
+			break;
+
+		case VoiceCallbackKind::LoopEnd:
+			if( &SourceVoice::LoopEnd != nullptr )
+				OnLoopEnd( gcnew ContextEventArgs( IntPtr( context ) ) );
+			break;
+
+		case VoiceCallbackKind::StreamEnd:
+			OnStreamEnd( EventArgs::Empty );
+			break;
+
+		case VoiceCallbackKind::VoiceError:
+			if( &SourceVoice::VoiceError != nullptr )
+				OnVoiceError( gcnew ErrorEventArgs( Result( value ), IntPtr( context ) ) );
+			break;
+
+		case VoiceCallbackKind::VoiceProcessingPassStart:
+			OnVoiceProcessingPassStart( value );
+			break;
+
+		case VoiceCallbackKind::VoiceProcessingPassEnd:
+			OnVoiceProcessingPassEnd( EventArgs::Empty );
+			break;
+		}
+	}
+
+	void SourceVoice::CallbackQueue::set( VoiceCallbackQueue^ value )
+	{
+		if( callbackQueue == value )
+			return;
+
+		// detach before swapping tokens, so the engine thread never pairs a queue with another queue's token
+		VoiceCallbackQueue^ previous = callbackQueue;
+		callbackQueue = nullptr;
+		Threading::Thread::MemoryBarrier();
+
+		if( previous != nullptr )
+			previous->Unregister( callbackToken );
+
+		if( value != nullptr )
+		{
+			callbackToken = value->Register( this );
+			Threading::Thread::MemoryBarrier();
+		}
+
+		callbackQueue = value;
+	}
+
 	void SourceVoice::OnBufferEnd( ContextEventArgs^ e )
 	{
 		if( &SourceVoice::BufferEnd != nullptr )
@@ -207,7 +347,13 @@ namespace XAudio2
 	{
 		XAUDIO2_BUFFER input = buffer->ToUnmanaged();
 
+		if( !BeginSubmit( buffer ) )
+			return RECORD_XAUDIO2( XAUDIO2_E_INVALID_CALL );
+
 		HRESULT hr = SourcePointer->SubmitSourceBuffer( &input );
+		if( FAILED( hr ) )
+			CancelSubmit( buffer );
+
 		return RECORD_XAUDIO2( hr );
 	}
 
@@ -224,7 +370,13 @@ namespace XAudio2
 		wma.pDecodedPacketCumulativeBytes = reinterpret_cast<UINT32*>( pinnedData );
 #endif
 
+		if( !BeginSubmit( buffer ) )
+			return RECORD_XAUDIO2( XAUDIO2_E_INVALID_CALL );
+
 		HRESULT hr = SourcePointer->SubmitSourceBuffer( &input, &wma );
+		if( FAILED( hr ) )
+			CancelSubmit( buffer );
+
 		return RECORD_XAUDIO2( hr );
 	}
 
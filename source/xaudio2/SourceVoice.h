@@ -23,10 +23,13 @@
 
 #include "Voice.h"
 #include "VoiceCallback.h"
+#include "VoiceCallbackQueue.h"
 #include "ContextEventArgs.h"
 #include "ErrorEventArgs.h"
 #include "StartProcessingEventArgs.h"
 #include "AudioBuffer.h"
+#include "AudioBufferPool.h"
+#include "StreamingVoicePump.h"
 #include "VoiceState.h"
 
 namespace SlimDX
@@ -43,21 +46,34 @@ namespace SlimDX
 		public ref class SourceVoice : Voice
 		{
 		private:
+			literal int MaxPendingBuffers = 128;
+
 			VoiceCallbackShim *callback;
 
+			// every submission in order, so BufferEnd can hand pooled buffers back; null for unpooled ones
+			array<AudioBuffer^>^ pendingBuffers;
+			int pendingHead;
+			int pendingTail;
+
+			VoiceCallbackQueue^ callbackQueue;
+			int callbackToken;
+			VoiceCallbackHandler^ callbackHandler;
+
+			bool BeginSubmit( AudioBuffer^ buffer );
+			void CancelSubmit( AudioBuffer^ buffer );
+			void ReleasePendingBuffers();
+
 			property IXAudio2SourceVoice *SourcePointer
 			{
 				IXAudio2SourceVoice *get() { return reinterpret_cast<IXAudio2SourceVoice*>( InternalPointer ); }
 			}
 
 		internal:
-			void InvokeBufferEnd( ContextEventArgs^ e ) { OnBufferEnd( e ); }
-			void InvokeBufferStart( ContextEventArgs^ e ) { OnBufferStart( e ); }
-			void InvokeLoopEnd( ContextEventArgs^ e ) { OnLoopEnd( e ); }
-			void InvokeStreamEnd() { OnStreamEnd( System::EventArgs::Empty ); }
-			void InvokeVoiceError( ErrorEventArgs^ e ) { OnVoiceError( e ); }
-			void InvokeVoiceProcessingPassEnd() { OnVoiceProcessingPassEnd( System::EventArgs::Empty ); }
-			void InvokeVoiceProcessingPassStart( int bytesRequired ) { OnVoiceProcessingPassStart( bytesRequired ); }
+			// set after every buffer end, so a StreamingVoicePump can wait for room without taking over the callbacks
+			System::Threading::EventWaitHandle^ bufferEndSignal;
+
+			void CompleteBuffer();
+			void Dispatch( VoiceCallbackKind kind, void *context, int value );
 
 		protected:
 			void OnBufferEnd( ContextEventArgs^ e );
@@ -106,6 +122,32 @@ namespace SlimDX
 				void set( float value );
 			}
 
+			/// <summary>
+			/// Gets or sets a queue that receives this voice's callbacks instead of the events.
+			/// </summary>
+			/// <remarks>
+			/// While a queue is set, callbacks are posted to it without allocating and none of the events are raised;
+			/// drain the queue on whichever thread should handle them. Change it only while the voice is stopped.
+			/// </remarks>
+			property VoiceCallbackQueue^ CallbackQueue
+			{
+				VoiceCallbackQueue^ get() { return callbackQueue; }
+				void set( VoiceCallbackQueue^ value );
+			}
+
+			/// <summary>
+			/// Gets or sets a handler that receives this voice's callbacks instead of the events.
+			/// </summary>
+			/// <remarks>
+			/// The handler runs inline on the audio engine thread and is passed a record rather than new event arguments,
+			/// so nothing is allocated per callback. It is ignored while <see cref="CallbackQueue"/> is set.
+			/// </remarks>
+			property VoiceCallbackHandler^ CallbackHandler
+			{
+				VoiceCallbackHandler^ get() { return callbackHandler; }
+				void set( VoiceCallbackHandler^ value ) { callbackHandler = value; }
+			}
+
 			event System::EventHandler<ContextEventArgs^>^ BufferEnd;
 			event System::EventHandler<ContextEventArgs^>^ BufferStart;
 			event System::EventHandler<ContextEventArgs^>^ LoopEnd;
@@ -0,0 +1,676 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <xaudio2.h>
+
+#include "../DataStream.h"
+#include "../Utilities.h"
+#include "../multimedia/WaveStream.h"
+#include "../multimedia/AdpcmCodec.h"
+
+#include "XAudio2Exception.h"
+
+#include "XAudio2.h"
+#include "SourceVoice.h"
+#include "StreamingVoicePump.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Threading;
+using namespace SlimDX::Multimedia;
+
+namespace SlimDX
+{
+namespace XAudio2
+{
+	ref class StreamingTrack sealed
+	{
+	public:
+		int Id;
+
+		// exactly one of these is set: in-memory tracks are submitted whole, the rest are read by the pump
+		WaveStream^ Wave;
+		DataStream^ View;
+
+		// byte positions; Position and the loop bounds count from the stream position the track started at
+		Int64 Start;
+		Int64 Length;
+		Int64 Position;
+		Int64 LoopBegin;
+		Int64 LoopEnd;
+		int LoopBeginFrame;
+		int LoopLengthFrame;
+		int LoopCount;
+
+		// the sequence number of the last buffer that holds part of the track, or -1 before the first
+		Int64 LastBuffer;
+	};
+
+	static bool SameFormat( WaveFormat^ left, WaveFormat^ right )
+	{
+		return left->FormatTag == right->FormatTag && left->Channels == right->Channels && left->SamplesPerSecond == right->SamplesPerSecond &&
+			left->BitsPerSample == right->BitsPerSample && left->BlockAlignment == right->BlockAlignment;
+	}
+
+	StreamingVoicePump::StreamingVoicePump( SourceVoice^ voice, WaveFormat^ format, int bufferCount, int bufferMilliseconds )
+	{
+		if( voice == nullptr )
+			throw gcnew ArgumentNullException( "voice" );
+		if( format == nullptr )
+			throw gcnew ArgumentNullException( "format" );
+		if( bufferCount < 2 || bufferCount > XAudio2::MaximumQueuedBuffers )
+			throw gcnew ArgumentOutOfRangeException( "bufferCount" );
+		if( bufferMilliseconds < 1 )
+			throw gcnew ArgumentOutOfRangeException( "bufferMilliseconds" );
+
+		WaveFormatTag tag = format->FormatTag;
+		if( tag == WaveFormatTag::Pcm || tag == WaveFormatTag::IeeeFloat || tag == WaveFormatTag::Extensible )
+			m_FramesPerBlock = 1;
+		else if( tag == WaveFormatTag::AdPcm || tag == WaveFormatTag::ImaAdpcm )
+			m_FramesPerBlock = AdpcmCodec::GetSamplesPerBlock( format );
+		else
+			throw gcnew ArgumentException( "The format must be PCM, IEEE float or ADPCM.", "format" );
+
+		int alignment = Math::Max( static_cast<int>( format->BlockAlignment ), 1 );
+		Int64 size = static_cast<Int64>( format->AverageBytesPerSecond ) * bufferMilliseconds / 1000 / alignment * alignment;
+		if( size > Int32::MaxValue )
+			throw gcnew ArgumentOutOfRangeException( "bufferMilliseconds" );
+
+		if( voice->bufferEndSignal != nullptr )
+			throw gcnew InvalidOperationException( "The voice already has a streaming pump." );
+
+		m_Voice = voice;
+		m_Format = format;
+		m_BufferCount = bufferCount;
+		m_BufferSize = Math::Max( static_cast<int>( size ), alignment );
+		m_PollInterval = Math::Max( bufferMilliseconds / 2, 1 );
+		m_LowestQueueDepth = bufferCount;
+
+		m_Pool = gcnew AudioBufferPool( bufferCount, m_BufferSize );
+		m_DirectBuffer = gcnew AudioBuffer();
+
+		m_Lock = gcnew Object();
+		m_Pending = gcnew Queue<StreamingTrack^>();
+		m_Submitted = gcnew Queue<StreamingTrack^>();
+		m_Wake = gcnew AutoResetEvent( false );
+
+		voice->bufferEndSignal = m_Wake;
+
+		// the thread only holds the pump weakly, so that an undisposed pump can still be finalized
+		m_Thread = gcnew Thread( gcnew ParameterizedThreadStart( &StreamingVoicePump::Run ) );
+		m_Thread->IsBackground = true;
+		m_Thread->Name = "SlimDX streaming pump";
+		m_Thread->Start( gcnew WeakReference( this ) );
+	}
+
+	StreamingVoicePump::~StreamingVoicePump()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	StreamingVoicePump::!StreamingVoicePump()
+	{
+		// the thread finds the pump gone the next time it wakes and exits; the pool and the
+		// track sources have finalizers of their own
+		if( m_Voice != nullptr && m_Voice->bufferEndSignal == m_Wake )
+			m_Voice->bufferEndSignal = nullptr;
+
+		if( m_Wake != nullptr )
+			m_Wake->Set();
+	}
+
+	void StreamingVoicePump::Destruct()
+	{
+		if( m_Thread == nullptr )
+			return;
+
+		Monitor::Enter( m_Lock );
+		try
+		{
+			m_Stopping = true;
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+
+		m_Wake->Set();
+		m_Thread->Join();
+		m_Thread = nullptr;
+
+		// the event is left open, since the engine thread may be about to set it
+		m_Voice->bufferEndSignal = nullptr;
+
+		if( m_Voice->InternalPointer != NULL )
+		{
+			m_Voice->FlushSourceBuffers();
+
+			// flushed buffers still end through the voice callback, which is what hands pooled ones back
+			for( int i = 0; i < 100 && m_Pool->InUseCount > 0; i++ )
+				Thread::Sleep( 10 );
+		}
+
+		// if the engine is not running the voice may still point into the pool, which then stays alive through the voice
+		if( m_Pool->InUseCount == 0 )
+			delete m_Pool;
+		m_Pool = nullptr;
+
+		// views only borrow their parent's memory, so releasing them early cannot pull the data from under the voice
+		for each( StreamingTrack^ track in m_Submitted )
+			delete track->View;
+		for each( StreamingTrack^ track in m_Pending )
+			delete track->View;
+
+		m_Submitted->Clear();
+		m_Pending->Clear();
+		m_Current = nullptr;
+	}
+
+	void StreamingVoicePump::CheckError()
+	{
+		if( m_Thread == nullptr )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		Exception^ error = m_Error;
+		if( error != nullptr )
+			throw gcnew InvalidOperationException( "The streaming thread has stopped because of an error.", error );
+	}
+
+	int StreamingVoicePump::Enqueue( WaveStream^ source )
+	{
+		return Enqueue( source, 0, 0, 0 );
+	}
+
+	int StreamingVoicePump::Enqueue( WaveStream^ source, int loopBegin, int loopLength, int loopCount )
+	{
+		if( source == nullptr )
+			throw gcnew ArgumentNullException( "source" );
+		if( !SameFormat( source->Format, m_Format ) )
+			throw gcnew ArgumentException( "The stream is not in the format of the pump.", "source" );
+
+		// a wave stream that is already in memory is submitted from its own storage like any other data stream
+		DataStream^ memory = Utilities::AsDataStream( source );
+		return AddTrack( memory == nullptr ? source : nullptr, memory, source->Position, source->Length - source->Position, loopBegin, loopLength, loopCount );
+	}
+
+	int StreamingVoicePump::Enqueue( DataStream^ source )
+	{
+		return Enqueue( source, 0, 0, 0 );
+	}
+
+	int StreamingVoicePump::Enqueue( DataStream^ source, int loopBegin, int loopLength, int loopCount )
+	{
+		if( source == nullptr )
+			throw gcnew ArgumentNullException( "source" );
+
+		return AddTrack( nullptr, source, source->Position, source->Length - source->Position, loopBegin, loopLength, loopCount );
+	}
+
+	int StreamingVoicePump::AddTrack( WaveStream^ wave, DataStream^ memory, Int64 offset, Int64 length, int loopBegin, int loopLength, int loopCount )
+	{
+		CheckError();
+
+		int alignment = Math::Max( static_cast<int>( m_Format->BlockAlignment ), 1 );
+		length = length / alignment * alignment;
+		if( length == 0 )
+			throw gcnew ArgumentException( "The stream has no audio left to play.", "source" );
+		if( memory != nullptr && length > Int32::MaxValue )
+			throw gcnew ArgumentException( "The stream is too large to submit as a single buffer.", "source" );
+
+		StreamingTrack^ track = gcnew StreamingTrack();
+		track->Wave = wave;
+		track->Start = offset;
+		track->Length = length;
+		track->LastBuffer = -1;
+
+		if( loopCount != 0 )
+		{
+			Int64 frames = length / alignment * m_FramesPerBlock;
+			if( loopCount < 0 || (loopCount > XAudio2::MaximumLoopCount && loopCount != XAudio2::LoopInfinite) )
+				throw gcnew ArgumentOutOfRangeException( "loopCount" );
+			if( loopBegin < 0 || loopBegin >= frames || loopBegin % m_FramesPerBlock != 0 )
+				throw gcnew ArgumentOutOfRangeException( "loopBegin" );
+			if( loopLength == 0 )
+				loopLength = static_cast<int>( Math::Min( frames - loopBegin, static_cast<Int64>( Int32::MaxValue ) ) );
+			if( loopLength < 0 || loopBegin + static_cast<Int64>( loopLength ) > frames || loopLength % m_FramesPerBlock != 0 )
+				throw gcnew ArgumentOutOfRangeException( "loopLength" );
+
+			track->LoopBeginFrame = loopBegin;
+			track->LoopLengthFrame = loopLength;
+			track->LoopBegin = static_cast<Int64>( loopBegin / m_FramesPerBlock ) * alignment;
+			track->LoopEnd = (static_cast<Int64>( loopBegin ) + loopLength) / m_FramesPerBlock * alignment;
+			track->LoopCount = loopCount;
+		}
+
+		if( memory != nullptr )
+			track->View = memory->Slice( offset, length );
+
+		Monitor::Enter( m_Lock );
+		try
+		{
+			track->Id = ++m_NextTrackId;
+			m_Pending->Enqueue( track );
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+
+		m_Wake->Set();
+		return track->Id;
+	}
+
+	void StreamingVoicePump::ExitLoop()
+	{
+		CheckError();
+
+		Monitor::Enter( m_Lock );
+		try
+		{
+			m_ExitLoopRequested = true;
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+
+		m_Wake->Set();
+	}
+
+	void StreamingVoicePump::Clear()
+	{
+		CheckError();
+
+		// tracks that were never submitted are dropped here, so that anything enqueued after this call survives
+		Monitor::Enter( m_Lock );
+		try
+		{
+			for each( StreamingTrack^ track in m_Pending )
+				delete track->View;
+
+			m_Pending->Clear();
+			m_ClearRequested = true;
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+
+		m_Wake->Set();
+	}
+
+	void StreamingVoicePump::ResetStatistics()
+	{
+		Interlocked::Exchange( m_UnderrunCount, 0 );
+		Interlocked::Exchange( m_LowestQueueDepth, m_BufferCount );
+	}
+
+	void StreamingVoicePump::Run( Object^ state )
+	{
+		WeakReference^ reference = safe_cast<WeakReference^>( state );
+		StreamingVoicePump^ pump = safe_cast<StreamingVoicePump^>( reference->Target );
+		if( pump == nullptr )
+			return;
+
+		AutoResetEvent^ wake = pump->m_Wake;
+		int pollInterval = pump->m_PollInterval;
+
+		while( pump->Step() )
+		{
+			// let go of the pump while waiting, so that it can be collected if nobody disposes it
+			pump = nullptr;
+
+			// buffer ends wake the thread early; the timeout only covers a count the engine had not yet updated
+			wake->WaitOne( pollInterval, false );
+
+			pump = safe_cast<StreamingVoicePump^>( reference->Target );
+			if( pump == nullptr )
+				return;
+		}
+	}
+
+	bool StreamingVoicePump::Step()
+	{
+		try
+		{
+			bool clear;
+			bool exitLoop;
+
+			Monitor::Enter( m_Lock );
+			try
+			{
+				if( m_Stopping )
+					return false;
+
+				clear = m_ClearRequested;
+				exitLoop = m_ExitLoopRequested;
+				m_ClearRequested = false;
+				m_ExitLoopRequested = false;
+			}
+			finally
+			{
+				Monitor::Exit( m_Lock );
+			}
+
+			if( clear )
+				ClearTracks();
+			if( exitLoop )
+				ExitCurrentLoop();
+
+			Pump();
+			return true;
+		}
+		catch( Exception^ e )
+		{
+			// handed to the caller on its next call into the pump; the field is volatile so that callers on
+			// other threads see it without taking the lock
+			m_Error = e;
+			return false;
+		}
+	}
+
+	StreamingTrack^ StreamingVoicePump::NextTrack( bool streamedOnly )
+	{
+		Monitor::Enter( m_Lock );
+		try
+		{
+			if( m_Pending->Count == 0 || (streamedOnly && m_Pending->Peek()->View != nullptr) )
+				return nullptr;
+
+			// a streamed track becomes current under the same lock, so that PendingTrackCount never misses it
+			StreamingTrack^ track = m_Pending->Dequeue();
+			if( track->View == nullptr )
+				m_Current = track;
+
+			return track;
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+	}
+
+	void StreamingVoicePump::EndCurrentTrack()
+	{
+		// only the pump thread writes the current track, but PendingTrackCount reads it from others
+		Monitor::Enter( m_Lock );
+		try
+		{
+			m_Current = nullptr;
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+	}
+
+	void StreamingVoicePump::Pump()
+	{
+		if( m_Voice->InternalPointer == NULL )
+			return;
+
+		while( true )
+		{
+			int queued = m_Voice->State.BuffersQueued;
+			Retire( m_SubmittedCount - queued );
+
+			// running dry only counts as an underrun while there is still audio the voice should have had
+			bool more = m_Current != nullptr || PendingTrackCount > 0;
+			if( m_Primed && more )
+			{
+				if( queued == 0 && !m_Starved )
+				{
+					Interlocked::Increment( m_UnderrunCount );
+					m_Starved = true;
+				}
+
+				if( queued < Thread::VolatileRead( m_LowestQueueDepth ) )
+					Interlocked::Exchange( m_LowestQueueDepth, queued );
+			}
+
+			if( queued > 0 )
+				m_Starved = false;
+			else if( !more )
+				m_Primed = false;
+
+			if( queued >= m_BufferCount || !SubmitNext() )
+				break;
+
+			m_Primed = true;
+		}
+	}
+
+	bool StreamingVoicePump::SubmitNext()
+	{
+		if( m_Current == nullptr )
+		{
+			StreamingTrack^ track = NextTrack( false );
+			if( track == nullptr )
+				return false;
+
+			if( track->View != nullptr )
+			{
+				SubmitDirect( track );
+				return true;
+			}
+		}
+
+		return SubmitPooled();
+	}
+
+	void StreamingVoicePump::SubmitDirect( StreamingTrack^ track )
+	{
+		// the whole track goes in one buffer straight from its own memory, and the voice does the looping
+		track->View->Position = 0;
+
+		AudioBuffer^ buffer = m_DirectBuffer;
+		buffer->AudioData = track->View;
+		buffer->AudioBytes = static_cast<int>( track->Length );
+		buffer->PlayBegin = 0;
+		buffer->PlayLength = 0;
+		buffer->LoopBegin = track->LoopCount != 0 ? track->LoopBeginFrame : 0;
+		buffer->LoopLength = track->LoopCount != 0 ? track->LoopLengthFrame : 0;
+		buffer->LoopCount = track->LoopCount;
+		buffer->Context = IntPtr( track->Id );
+		buffer->Flags = PendingTrackCount == 0 ? BufferFlags::EndOfStream : BufferFlags::None;
+
+		Touch( track );
+		Submit( buffer );
+	}
+
+	bool StreamingVoicePump::SubmitPooled()
+	{
+		AudioBuffer^ buffer = m_Pool->Rent();
+		if( buffer == nullptr )
+			return false;
+
+		char *memory = safe_cast<DataStream^>( buffer->AudioData )->RawPointer;
+		int alignment = Math::Max( static_cast<int>( m_Format->BlockAlignment ), 1 );
+		StreamingTrack^ first = nullptr;
+		int filled = 0;
+
+		try
+		{
+			while( filled < m_BufferSize )
+			{
+				// carry straight on into the next streamed track, so that tracks join without a gap
+				if( m_Current == nullptr && NextTrack( true ) == nullptr )
+					break;
+
+				StreamingTrack^ track = m_Current;
+				Int64 end = track->LoopCount != 0 ? track->LoopEnd : track->Length;
+				int count = static_cast<int>( Math::Min( static_cast<Int64>( m_BufferSize - filled ), end - track->Position ) );
+
+				if( count > 0 )
+				{
+					int read = track->Wave->ReadTo( memory + filled, count );
+					if( read > 0 )
+					{
+						if( first == nullptr )
+							first = track;
+						Touch( track );
+					}
+
+					filled += read;
+					track->Position += read;
+
+					// the stream turned out shorter than it claimed, so the track ends here
+					if( read < count )
+					{
+						track->Length = track->Position;
+						track->LoopCount = 0;
+					}
+				}
+
+				if( track->LoopCount != 0 && track->Position >= track->LoopEnd )
+				{
+					if( track->LoopCount != XAudio2::LoopInfinite )
+						track->LoopCount--;
+
+					track->Position = track->LoopBegin;
+					track->Wave->Position = track->Start + track->LoopBegin;
+				}
+				else if( track->LoopCount == 0 && track->Position >= track->Length )
+					EndCurrentTrack();
+			}
+		}
+		catch( Exception^ )
+		{
+			m_Pool->Return( buffer );
+			throw;
+		}
+
+		filled = filled / alignment * alignment;
+		if( filled == 0 )
+		{
+			m_Pool->Return( buffer );
+			return false;
+		}
+
+		buffer->AudioBytes = filled;
+		buffer->Context = IntPtr( first->Id );
+		buffer->Flags = m_Current == nullptr && PendingTrackCount == 0 ? BufferFlags::EndOfStream : BufferFlags::None;
+
+		Submit( buffer );
+		return true;
+	}
+
+	void StreamingVoicePump::Submit( AudioBuffer^ buffer )
+	{
+		Result result;
+		try
+		{
+			result = m_Voice->SubmitSourceBuffer( buffer );
+		}
+		catch( Exception^ )
+		{
+			if( buffer->pool != nullptr )
+				m_Pool->Return( buffer );
+			throw;
+		}
+
+		if( result.IsFailure )
+		{
+			if( buffer->pool != nullptr )
+				m_Pool->Return( buffer );
+			throw gcnew XAudio2Exception( result );
+		}
+
+		Interlocked::Increment( m_SubmittedCount );
+	}
+
+	void StreamingVoicePump::Touch( StreamingTrack^ track )
+	{
+		if( track->LastBuffer < 0 )
+			m_Submitted->Enqueue( track );
+
+		track->LastBuffer = m_SubmittedCount;
+	}
+
+	void StreamingVoicePump::Retire( Int64 completed )
+	{
+		// the voice plays buffers in order, so everything up to the completed count is finished with
+		while( m_Submitted->Count > 0 )
+		{
+			StreamingTrack^ track = m_Submitted->Peek();
+			if( track == m_Current || track->LastBuffer >= completed )
+				break;
+
+			m_Submitted->Dequeue();
+			delete track->View;
+		}
+	}
+
+	void StreamingVoicePump::ClearTracks()
+	{
+		EndCurrentTrack();
+		m_Primed = false;
+
+		// submitted tracks release their views as their flushed buffers end
+		m_Voice->FlushSourceBuffers();
+	}
+
+	void StreamingVoicePump::ExitCurrentLoop()
+	{
+		Retire( m_SubmittedCount - m_Voice->State.BuffersQueued );
+
+		StreamingTrack^ playing = m_Submitted->Count > 0 ? m_Submitted->Peek() : m_Current;
+		if( playing == nullptr || playing->LoopCount == 0 )
+			return;
+
+		if( playing->View != nullptr )
+			m_Voice->ExitLoop();
+
+		playing->LoopCount = 0;
+	}
+
+	int StreamingVoicePump::PendingTrackCount::get()
+	{
+		Monitor::Enter( m_Lock );
+		try
+		{
+			return m_Pending->Count + (m_Current != nullptr ? 1 : 0);
+		}
+		finally
+		{
+			Monitor::Exit( m_Lock );
+		}
+	}
+
+	int StreamingVoicePump::UnderrunCount::get()
+	{
+		return Thread::VolatileRead( m_UnderrunCount );
+	}
+
+	int StreamingVoicePump::LowestQueueDepth::get()
+	{
+		return Thread::VolatileRead( m_LowestQueueDepth );
+	}
+
+	Int64 StreamingVoicePump::SubmittedBufferCount::get()
+	{
+		return Interlocked::Read( m_SubmittedCount );
+	}
+}
+}
@@ -0,0 +1,243 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+namespace SlimDX
+{
+	ref class DataStream;
+
+	namespace Multimedia
+	{
+		ref class WaveFormat;
+		ref class WaveStream;
+	}
+
+	namespace XAudio2
+	{
+		ref class SourceVoice;
+		ref class AudioBuffer;
+		ref class AudioBufferPool;
+		ref class StreamingTrack;
+
+		/// <summary>
+		/// Keeps a <see cref="SourceVoice"/> supplied with audio from a queue of tracks on a dedicated I/O thread.
+		/// </summary>
+		/// <remarks>
+		/// <para>Tracks are played back to back with no gap between them, in the order they are enqueued, and each may carry
+		/// a loop region. Data that is already in memory, either a <see cref="DataStream"/> or a <see cref="SlimDX::Multimedia::WaveStream"/>
+		/// that was not opened in streaming mode, is submitted in place as a single buffer and looped by the voice itself.
+		/// Any other wave stream is read in buffers of a fixed duration from a private <see cref="AudioBufferPool"/>, keeping
+		/// the voice <see cref="BufferCount"/> buffers ahead of playback and looping by seeking the stream.</para>
+		/// <para>The pump wakes whenever the voice finishes a buffer, without taking over its events or callback queue. Starting and
+		/// stopping the voice remains up to the caller. The pump must be disposed before the voice, and its sources must not
+		/// be used elsewhere until they have finished playing. A pump that is collected without being disposed stops its
+		/// thread and detaches from the voice, but leaves whatever it had queued on the voice.</para>
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class StreamingVoicePump : System::IDisposable
+		{
+		private:
+			SourceVoice^ m_Voice;
+			SlimDX::Multimedia::WaveFormat^ m_Format;
+			int m_BufferCount;
+			int m_BufferSize;
+			int m_FramesPerBlock;
+			int m_PollInterval;
+
+			AudioBufferPool^ m_Pool;
+			AudioBuffer^ m_DirectBuffer;
+
+			System::Object^ m_Lock;
+			System::Collections::Generic::Queue<StreamingTrack^>^ m_Pending;
+			System::Collections::Generic::Queue<StreamingTrack^>^ m_Submitted;
+			StreamingTrack^ m_Current;
+			int m_NextTrackId;
+			bool m_Stopping;
+			bool m_ExitLoopRequested;
+			bool m_ClearRequested;
+			System::Exception^ volatile m_Error;
+
+			System::Threading::AutoResetEvent^ m_Wake;
+			System::Threading::Thread^ m_Thread;
+
+			System::Int64 m_SubmittedCount;
+			bool m_Primed;
+			bool m_Starved;
+			int m_UnderrunCount;
+			int m_LowestQueueDepth;
+
+			void Destruct();
+			void CheckError();
+			int AddTrack( SlimDX::Multimedia::WaveStream^ wave, DataStream^ memory, System::Int64 offset, System::Int64 length, int loopBegin, int loopLength, int loopCount );
+			StreamingTrack^ NextTrack( bool streamedOnly );
+			void EndCurrentTrack();
+			static void Run( System::Object^ state );
+			bool Step();
+			void Pump();
+			bool SubmitNext();
+			void SubmitDirect( StreamingTrack^ track );
+			bool SubmitPooled();
+			void Submit( AudioBuffer^ buffer );
+			void Touch( StreamingTrack^ track );
+			void Retire( System::Int64 completed );
+			void ClearTracks();
+			void ExitCurrentLoop();
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="StreamingVoicePump"/> class and starts its I/O thread.
+			/// </summary>
+			/// <param name="voice">The voice to feed. It must not be fed by anything else, or have another pump.</param>
+			/// <param name="format">The format the voice was created with. PCM, IEEE float and ADPCM formats are supported.</param>
+			/// <param name="bufferCount">The number of buffers to keep queued on the voice, from 2 to <see cref="XAudio2::MaximumQueuedBuffers"/>.</param>
+			/// <param name="bufferMilliseconds">The duration of each streamed buffer, in milliseconds.</param>
+			StreamingVoicePump( SourceVoice^ voice, SlimDX::Multimedia::WaveFormat^ format, int bufferCount, int bufferMilliseconds );
+
+			/// <summary>
+			/// Stops the I/O thread, flushes the buffers queued on the voice and releases the buffer memory.
+			/// </summary>
+			~StreamingVoicePump();
+
+			/// <summary>
+			/// Stops the I/O thread and detaches from the voice.
+			/// </summary>
+			!StreamingVoicePump();
+
+			/// <summary>
+			/// Adds a track that plays the rest of a wave stream once.
+			/// </summary>
+			/// <param name="source">The track, in the format of the pump, played from its current position.</param>
+			/// <returns>An identifier for the track, which is also the <see cref="VoiceState::Context"/> of the voice while the track plays.</returns>
+			int Enqueue( SlimDX::Multimedia::WaveStream^ source );
+
+			/// <summary>
+			/// Adds a track that plays the rest of a wave stream with a loop region.
+			/// </summary>
+			/// <param name="source">The track, in the format of the pump, played from its current position.</param>
+			/// <param name="loopBegin">The first frame of the loop region, counted from the start of the track.</param>
+			/// <param name="loopLength">The number of frames in the loop region, or zero to loop to the end of the track.</param>
+			/// <param name="loopCount">The number of times the region repeats, up to <see cref="XAudio2::MaximumLoopCount"/>, or <see cref="XAudio2::LoopInfinite"/>.</param>
+			/// <returns>An identifier for the track, which is also the <see cref="VoiceState::Context"/> of the voice while the track plays.</returns>
+			/// <remarks>Compressed formats can only loop on whole blocks.</remarks>
+			int Enqueue( SlimDX::Multimedia::WaveStream^ source, int loopBegin, int loopLength, int loopCount );
+
+			/// <summary>
+			/// Adds a track that plays the rest of a data stream once.
+			/// </summary>
+			/// <param name="source">The track, in the format of the pump, played from its current position. It is submitted without copying.</param>
+			/// <returns>An identifier for the track, which is also the <see cref="VoiceState::Context"/> of the voice while the track plays.</returns>
+			int Enqueue( DataStream^ source );
+
+			/// <summary>
+			/// Adds a track that plays the rest of a data stream with a loop region.
+			/// </summary>
+			/// <param name="source">The track, in the format of the pump, played from its current position. It is submitted without copying.</param>
+			/// <param name="loopBegin">The first frame of the loop region, counted from the start of the track.</param>
+			/// <param name="loopLength">The number of frames in the loop region, or zero to loop to the end of the track.</param>
+			/// <param name="loopCount">The number of times the region repeats, up to <see cref="XAudio2::MaximumLoopCount"/>, or <see cref="XAudio2::LoopInfinite"/>.</param>
+			/// <returns>An identifier for the track, which is also the <see cref="VoiceState::Context"/> of the voice while the track plays.</returns>
+			/// <remarks>Compressed formats can only loop on whole blocks.</remarks>
+			int Enqueue( DataStream^ source, int loopBegin, int loopLength, int loopCount );
+
+			/// <summary>
+			/// Lets the playing track leave its loop region and play on to its end.
+			/// </summary>
+			/// <remarks>A streamed track stops looping after the audio that is already queued on the voice, which may be up to
+			/// <see cref="BufferCount"/> buffers.</remarks>
+			void ExitLoop();
+
+			/// <summary>
+			/// Removes every track that has not finished playing and flushes the buffers queued on the voice.
+			/// </summary>
+			void Clear();
+
+			/// <summary>
+			/// Resets the underrun count to zero and the lowest queue depth to the number of buffers.
+			/// </summary>
+			void ResetStatistics();
+
+			/// <summary>
+			/// Gets the voice being fed.
+			/// </summary>
+			property SourceVoice^ Voice
+			{
+				SourceVoice^ get() { return m_Voice; }
+			}
+
+			/// <summary>
+			/// Gets the format of the tracks.
+			/// </summary>
+			property SlimDX::Multimedia::WaveFormat^ Format
+			{
+				SlimDX::Multimedia::WaveFormat^ get() { return m_Format; }
+			}
+
+			/// <summary>
+			/// Gets the number of buffers kept queued on the voice.
+			/// </summary>
+			property int BufferCount
+			{
+				int get() { return m_BufferCount; }
+			}
+
+			/// <summary>
+			/// Gets the size of each streamed buffer, in bytes.
+			/// </summary>
+			property int BufferSize
+			{
+				int get() { return m_BufferSize; }
+			}
+
+			/// <summary>
+			/// Gets the number of tracks that have not been completely submitted to the voice yet.
+			/// </summary>
+			property int PendingTrackCount
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the number of times the voice ran out of queued buffers while the pump still had audio for it.
+			/// </summary>
+			property int UnderrunCount
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the fewest buffers seen queued on the voice while it was playing a track that had more audio to come.
+			/// </summary>
+			property int LowestQueueDepth
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the number of buffers the pump has submitted to the voice.
+			/// </summary>
+			property System::Int64 SubmittedBufferCount
+			{
+				System::Int64 get();
+			}
+		};
+	}
+}
@@ -43,37 +43,37 @@ namespace XAudio2
 
 	void VoiceCallbackShim::OnBufferEnd( void *context )
 	{
-		m_WrappedInterface->InvokeBufferEnd( gcnew ContextEventArgs( IntPtr( context ) ) );
+		m_WrappedInterface->Dispatch( VoiceCallbackKind::BufferEnd, context, 0 );
 	}
 
 	void VoiceCallbackShim::OnBufferStart( void *context )
 	{
-		m_WrappedInterface->InvokeBufferStart( gcnew ContextEventArgs( IntPtr( context ) ) );
+		m_WrappedInterface->Dispatch( VoiceCallbackKind::BufferStart, context, 0 );
 	}
 
 	void VoiceCallbackShim::OnLoopEnd( void *context )
 	{
-		m_WrappedInterface->InvokeLoopEnd( gcnew ContextEventArgs( IntPtr( context ) ) );
+		m_WrappedInterface->Dispatch( VoiceCallbackKind::LoopEnd, context, 0 );
 	}
 
 	void VoiceCallbackShim::OnStreamEnd()
 	{
-		m_WrappedInterface->InvokeStreamEnd();
+		m_WrappedInterface->Dispatch( VoiceCallbackKind::StreamEnd, NULL, 0 );
 	}
 
 	void VoiceCallbackShim::OnVoiceError( void *context, HRESULT error )
 	{
-		m_WrappedInterface->InvokeVoiceError( gcnew ErrorEventArgs( Result( error ), IntPtr( context ) ) );
+		m_WrappedInterface->Dispatch( VoiceCallbackKind::VoiceError, context, error );
 	}
 
 	void VoiceCallbackShim::OnVoiceProcessingPassStart( UINT32 bytesRequired )
 	{
-		m_WrappedInterface->InvokeVoiceProcessingPassStart( bytesRequired );
+		m_WrappedInterface->Dispatch( VoiceCallbackKind::VoiceProcessingPassStart, NULL, static_cast<int>( bytesRequired ) );
 	}
 
 	void VoiceCallbackShim::OnVoiceProcessingPassEnd()
 	{
-		m_WrappedInterface->InvokeVoiceProcessingPassEnd();
+		m_WrappedInterface->Dispatch( VoiceCallbackKind::VoiceProcessingPassEnd, NULL, 0 );
 	}
 }
 }
\ No newline at end of file
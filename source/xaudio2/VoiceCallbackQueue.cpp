@@ -0,0 +1,324 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <xaudio2.h>
+#include <vcclr.h>
+
+#include "../ComObject.h"
+
+#include "SourceVoice.h"
+#include "VoiceCallbackQueue.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Runtime::InteropServices;
+using namespace System::Threading;
+
+namespace SlimDX
+{
+namespace XAudio2
+{
+#pragma managed(push, off)
+	// bounded multi-producer queue; each entry's sequence says whether it is free for the position being written or read
+	static bool PostEntry( VoiceCallbackRing *ring, int token, int kind, int value, void *context )
+	{
+		LONG position = ring->EnqueuePosition;
+
+		while( true )
+		{
+			VoiceCallbackEntry *entry = &ring->Entries[position & ring->Mask];
+			LONG difference = static_cast<LONG>( static_cast<ULONG>( entry->Sequence ) - static_cast<ULONG>( position ) );
+
+			if( difference == 0 )
+			{
+				LONG next = static_cast<LONG>( static_cast<ULONG>( position ) + 1 );
+				LONG previous = InterlockedCompareExchange( &ring->EnqueuePosition, next, position );
+				if( previous == position )
+				{
+					entry->Token = token;
+					entry->Kind = kind;
+					entry->Value = value;
+					entry->Context = context;
+					InterlockedExchange( &entry->Sequence, next );
+					return true;
+				}
+
+				position = previous;
+			}
+			else if( difference < 0 )
+				return false;
+			else
+				position = ring->EnqueuePosition;
+		}
+	}
+
+	static bool TakeEntry( VoiceCallbackRing *ring, int *token, int *kind, int *value, void **context )
+	{
+		LONG position = ring->DequeuePosition;
+
+		while( true )
+		{
+			VoiceCallbackEntry *entry = &ring->Entries[position & ring->Mask];
+			LONG next = static_cast<LONG>( static_cast<ULONG>( position ) + 1 );
+			LONG difference = static_cast<LONG>( static_cast<ULONG>( entry->Sequence ) - static_cast<ULONG>( next ) );
+
+			if( difference == 0 )
+			{
+				LONG previous = InterlockedCompareExchange( &ring->DequeuePosition, next, position );
+				if( previous == position )
+				{
+					*token = entry->Token;
+					*kind = entry->Kind;
+					*value = entry->Value;
+					*context = entry->Context;
+					InterlockedExchange( &entry->Sequence, static_cast<LONG>( static_cast<ULONG>( position ) + ring->Mask + 1 ) );
+					return true;
+				}
+
+				position = previous;
+			}
+			else if( difference < 0 )
+				return false;
+			else
+				position = ring->DequeuePosition;
+		}
+	}
+#pragma managed(pop)
+
+	VoiceCallbackQueue::VoiceCallbackQueue( int capacity )
+	{
+		if( capacity < 1 || capacity > (1 << 24) )
+			throw gcnew ArgumentOutOfRangeException( "capacity" );
+
+		int size = 2;
+		while( size < capacity )
+			size <<= 1;
+
+		m_Capacity = size;
+
+		// Manual Allocation: this is fine
+		m_Ring = new VoiceCallbackRing();
+		m_Ring->EnqueuePosition = 0;
+		m_Ring->DequeuePosition = 0;
+		m_Ring->Mask = size - 1;
+		m_Ring->Entries = new VoiceCallbackEntry[size];
+		GC::AddMemoryPressure( static_cast<Int64>( size ) * sizeof( VoiceCallbackEntry ) );
+
+		for( int i = 0; i < size; i++ )
+			m_Ring->Entries[i].Sequence = i;
+
+		m_Voices = gcnew array<SourceVoice^>( 16 );
+		m_Generations = gcnew array<int>( 16 );
+		m_FreeSlots = gcnew Stack<int>();
+
+		for( int i = m_Voices->Length - 1; i >= 0; i-- )
+			m_FreeSlots->Push( i );
+	}
+
+	VoiceCallbackQueue::~VoiceCallbackQueue()
+	{
+		Destruct();
+		GC::SuppressFinalize( this );
+	}
+
+	VoiceCallbackQueue::!VoiceCallbackQueue()
+	{
+		Destruct();
+	}
+
+	void VoiceCallbackQueue::Destruct()
+	{
+		if( m_Ring != 0 )
+		{
+			// the engine thread may be part way through a post from a voice that is still attached; posts are
+			// short and never block, so waiting them out is cheaper than making every post take a lock
+			Interlocked::Exchange( m_Closed, 1 );
+			while( Thread::VolatileRead( m_Posting ) != 0 )
+				Thread::SpinWait( 20 );
+
+			delete[] m_Ring->Entries;
+			delete m_Ring;
+			GC::RemoveMemoryPressure( static_cast<Int64>( m_Capacity ) * sizeof( VoiceCallbackEntry ) );
+
+			m_Ring = 0;
+		}
+	}
+
+	int VoiceCallbackQueue::Register( SourceVoice^ voice )
+	{
+		Monitor::Enter( m_FreeSlots );
+
+		try
+		{
+			if( m_FreeSlots->Count == 0 )
+			{
+				int length = m_Voices->Length;
+				if( length >= 0x10000 )
+					throw gcnew InvalidOperationException( "Too many voices are attached to the callback queue." );
+
+				// readers never lock, so grow into copies and publish the voices before the generations they are checked against
+				array<SourceVoice^>^ voices = gcnew array<SourceVoice^>( length * 2 );
+				array<int>^ generations = gcnew array<int>( length * 2 );
+				Array::Copy( m_Voices, voices, length );
+				Array::Copy( m_Generations, generations, length );
+
+				m_Voices = voices;
+				Thread::MemoryBarrier();
+				m_Generations = generations;
+
+				for( int i = length * 2 - 1; i >= length; i-- )
+					m_FreeSlots->Push( i );
+			}
+
+			int slot = m_FreeSlots->Pop();
+			m_Voices[slot] = voice;
+			return (m_Generations[slot] << 16) | slot;
+		}
+		finally
+		{
+			Monitor::Exit( m_FreeSlots );
+		}
+	}
+
+	void VoiceCallbackQueue::Unregister( int token )
+	{
+		Monitor::Enter( m_FreeSlots );
+
+		try
+		{
+			// bumping the generation turns anything the voice still has queued into a stale record; it goes first,
+			// so a reader that sees the cleared slot also sees the new generation and drops the record
+			int slot = token & 0xffff;
+			m_Generations[slot] = (m_Generations[slot] + 1) & 0x7fff;
+			Thread::MemoryBarrier();
+			m_Voices[slot] = nullptr;
+			m_FreeSlots->Push( slot );
+		}
+		finally
+		{
+			Monitor::Exit( m_FreeSlots );
+		}
+	}
+
+	bool VoiceCallbackQueue::Post( int token, VoiceCallbackKind kind, void *context, int value )
+	{
+		// Destruct raises the flag before it checks for posts in progress, and a post announces itself before it
+		// checks the flag, so one of the two always sees the other
+		Interlocked::Increment( m_Posting );
+		bool posted = Thread::VolatileRead( m_Closed ) == 0 && PostEntry( m_Ring, token, static_cast<int>( kind ), value, context );
+		Interlocked::Decrement( m_Posting );
+
+		if( !posted )
+		{
+			Interlocked::Increment( m_DroppedCount );
+			return false;
+		}
+
+		Interlocked::Increment( m_PostedCount );
+		return true;
+	}
+
+	bool VoiceCallbackQueue::Resolve( int token, SourceVoice^% voice )
+	{
+		int slot = token & 0xffff;
+		array<int>^ generations = m_Generations;
+		array<SourceVoice^>^ voices = m_Voices;
+
+		if( slot >= generations->Length )
+			return false;
+
+		// read the voice before the generation; Unregister writes them the other way round
+		voice = voices[slot];
+		Thread::MemoryBarrier();
+		return generations[slot] == (token >> 16);
+	}
+
+	bool VoiceCallbackQueue::TryDequeue( [Out] VoiceCallbackRecord% record )
+	{
+		if( m_Ring == 0 )
+			throw gcnew ObjectDisposedException( GetType()->Name );
+
+		int token;
+		int kind;
+		int value;
+		void *context;
+
+		while( TakeEntry( m_Ring, &token, &kind, &value, &context ) )
+		{
+			SourceVoice^ voice;
+			if( !Resolve( token, voice ) )
+				continue;
+
+			record = VoiceCallbackRecord( voice, static_cast<VoiceCallbackKind>( kind ), IntPtr( context ), value );
+			return true;
+		}
+
+		record = VoiceCallbackRecord();
+		return false;
+	}
+
+	int VoiceCallbackQueue::Drain( VoiceCallbackHandler^ handler )
+	{
+		if( handler == nullptr )
+			throw gcnew ArgumentNullException( "handler" );
+
+		int count = 0;
+		VoiceCallbackRecord record;
+
+		// stop at the callbacks that were queued when draining started, so a handler that keeps voices busy cannot starve the caller
+		int pending = Count;
+		while( count < pending && TryDequeue( record ) )
+		{
+			handler( record );
+			count++;
+		}
+
+		return count;
+	}
+
+	void VoiceCallbackQueue::ResetStatistics()
+	{
+		Interlocked::Exchange( m_PostedCount, 0 );
+		Interlocked::Exchange( m_DroppedCount, 0 );
+	}
+
+	int VoiceCallbackQueue::Count::get()
+	{
+		if( m_Ring == 0 )
+			return 0;
+
+		int count = static_cast<int>( static_cast<ULONG>( m_Ring->EnqueuePosition ) - static_cast<ULONG>( m_Ring->DequeuePosition ) );
+		return count < 0 ? 0 : (count > m_Capacity ? m_Capacity : count);
+	}
+
+	Int64 VoiceCallbackQueue::PostedCount::get()
+	{
+		return Interlocked::Read( m_PostedCount );
+	}
+
+	Int64 VoiceCallbackQueue::DroppedCount::get()
+	{
+		return Interlocked::Read( m_DroppedCount );
+	}
+}
+}
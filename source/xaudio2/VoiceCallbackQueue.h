@@ -0,0 +1,154 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "VoiceCallbackRecord.h"
+
+namespace SlimDX
+{
+	namespace XAudio2
+	{
+		struct VoiceCallbackEntry
+		{
+			volatile LONG Sequence;
+			int Token;
+			int Kind;
+			int Value;
+			void *Context;
+		};
+
+		// the two positions sit on separate cache lines, since the engine thread and the draining thread each own one
+		struct VoiceCallbackRing
+		{
+			volatile LONG EnqueuePosition;
+			char Padding1[60];
+			volatile LONG DequeuePosition;
+			char Padding2[60];
+			LONG Mask;
+			VoiceCallbackEntry *Entries;
+		};
+
+		/// <summary>
+		/// A bounded lock-free queue that carries voice callbacks from the audio engine thread to a thread of the caller's choosing.
+		/// </summary>
+		/// <remarks>
+		/// Assign the queue to <see cref="SourceVoice::CallbackQueue"/> on any number of voices and call <see cref="Drain"/>
+		/// or <see cref="TryDequeue"/> from your own thread, for example once per frame. Posting a callback copies a small
+		/// native record and never allocates; when the queue is full the callback is dropped and counted in <see cref="DroppedCount"/>.
+		/// Disposing the queue while voices are still attached is safe; their later callbacks are dropped.
+		/// </remarks>
+		/// <unmanaged>None</unmanaged>
+		public ref class VoiceCallbackQueue : System::IDisposable
+		{
+		private:
+			VoiceCallbackRing *m_Ring;
+			int m_Capacity;
+
+			array<SourceVoice^>^ m_Voices;
+			array<int>^ m_Generations;
+			System::Collections::Generic::Stack<int>^ m_FreeSlots;
+
+			System::Int64 m_PostedCount;
+			System::Int64 m_DroppedCount;
+
+			// posts in progress, and whether Dispose has started waiting them out
+			int m_Posting;
+			int m_Closed;
+
+			void Destruct();
+			bool Resolve( int token, SourceVoice^% voice );
+
+		internal:
+			int Register( SourceVoice^ voice );
+			void Unregister( int token );
+			bool Post( int token, VoiceCallbackKind kind, void *context, int value );
+
+		public:
+			/// <summary>
+			/// Initializes a new instance of the <see cref="VoiceCallbackQueue"/> class.
+			/// </summary>
+			/// <param name="capacity">The number of callbacks the queue can hold; rounded up to a power of two.</param>
+			VoiceCallbackQueue( int capacity );
+
+			/// <summary>
+			/// Releases the queue memory.
+			/// </summary>
+			~VoiceCallbackQueue();
+
+			/// <summary>
+			/// Releases the queue memory.
+			/// </summary>
+			!VoiceCallbackQueue();
+
+			/// <summary>
+			/// Removes the oldest callback from the queue.
+			/// </summary>
+			/// <param name="record">When this method returns <c>true</c>, receives the callback.</param>
+			/// <returns><c>true</c> if a callback was removed; <c>false</c> if the queue was empty.</returns>
+			bool TryDequeue( [System::Runtime::InteropServices::Out] VoiceCallbackRecord% record );
+
+			/// <summary>
+			/// Removes every queued callback and hands each one to a handler on the calling thread.
+			/// </summary>
+			/// <param name="handler">The handler that receives the callbacks.</param>
+			/// <returns>The number of callbacks delivered.</returns>
+			int Drain( VoiceCallbackHandler^ handler );
+
+			/// <summary>
+			/// Resets the posted and dropped counters to zero.
+			/// </summary>
+			void ResetStatistics();
+
+			/// <summary>
+			/// Gets the number of callbacks the queue can hold.
+			/// </summary>
+			property int Capacity
+			{
+				int get() { return m_Capacity; }
+			}
+
+			/// <summary>
+			/// Gets the approximate number of callbacks waiting in the queue.
+			/// </summary>
+			property int Count
+			{
+				int get();
+			}
+
+			/// <summary>
+			/// Gets the number of callbacks that have been queued.
+			/// </summary>
+			property System::Int64 PostedCount
+			{
+				System::Int64 get();
+			}
+
+			/// <summary>
+			/// Gets the number of callbacks that were lost because the queue was full.
+			/// </summary>
+			property System::Int64 DroppedCount
+			{
+				System::Int64 get();
+			}
+		};
+	}
+}
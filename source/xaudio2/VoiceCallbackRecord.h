@@ -0,0 +1,99 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "../Result.h"
+#include "Enums.h"
+
+namespace SlimDX
+{
+	namespace XAudio2
+	{
+		ref class SourceVoice;
+
+		/// <summary>
+		/// Describes a single voice callback without allocating any event arguments.
+		/// </summary>
+		/// <unmanaged>None</unmanaged>
+		public value class VoiceCallbackRecord
+		{
+		private:
+			SourceVoice^ m_Voice;
+			VoiceCallbackKind m_Kind;
+			System::IntPtr m_Context;
+			int m_Value;
+
+		internal:
+			VoiceCallbackRecord( SourceVoice^ voice, VoiceCallbackKind kind, System::IntPtr context, int value )
+				: m_Voice( voice ), m_Kind( kind ), m_Context( context ), m_Value( value )
+			{
+			}
+
+		public:
+			/// <summary>
+			/// Gets the voice that raised the callback.
+			/// </summary>
+			property SourceVoice^ Voice
+			{
+				SourceVoice^ get() { return m_Voice; }
+			}
+
+			/// <summary>
+			/// Gets which callback was raised.
+			/// </summary>
+			property VoiceCallbackKind Kind
+			{
+				VoiceCallbackKind get() { return m_Kind; }
+			}
+
+			/// <summary>
+			/// Gets the buffer context for buffer, loop and error callbacks.
+			/// </summary>
+			property System::IntPtr Context
+			{
+				System::IntPtr get() { return m_Context; }
+			}
+
+			/// <summary>
+			/// Gets the error reported by a <see cref="VoiceCallbackKind::VoiceError"/> callback.
+			/// </summary>
+			property Result Error
+			{
+				Result get() { return Result( m_Kind == VoiceCallbackKind::VoiceError ? m_Value : 0 ); }
+			}
+
+			/// <summary>
+			/// Gets the number of bytes the voice wants for a <see cref="VoiceCallbackKind::VoiceProcessingPassStart"/> callback.
+			/// </summary>
+			property int BytesRequired
+			{
+				int get() { return m_Kind == VoiceCallbackKind::VoiceProcessingPassStart ? m_Value : 0; }
+			}
+		};
+
+		/// <summary>
+		/// Receives voice callbacks as records instead of events.
+		/// </summary>
+		/// <param name="record">The callback that was raised.</param>
+		public delegate void VoiceCallbackHandler( VoiceCallbackRecord record );
+	}
+}
@@ -23,7 +23,7 @@
 
 #include "../SlimDXException.h"
 
-#define RECORD_XINPUT(x) Result::Record<XInputException^>( (x), (nullptr), (nullptr) )
+#define RECORD_XINPUT(x) Result::Record<XInputException^>( SLIMDX_INSTRUMENT_RESULT(x), (nullptr), (nullptr) )
 
 namespace SlimDX
 {
@@ -0,0 +1,161 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::Threading;
+using namespace SlimDX;
+
+static const char* const TestMethod = "CallStatisticsTests::Method";
+static const char* const WorkerMethod = "CallStatisticsTests::Worker";
+
+static CallCounter FindCall( String^ method )
+{
+	for each( CallCounter counter in CallStatistics::GetCallCounters() )
+	{
+		if( counter.Method == method )
+			return counter;
+	}
+
+	return CallCounter();
+}
+
+static Int64 FindResult( int code )
+{
+	for each( ResultCounter counter in CallStatistics::GetResultCounters() )
+	{
+		if( counter.Result.Code == code )
+			return counter.Count;
+	}
+
+	return 0;
+}
+
+ref class CallStatisticsWorker
+{
+public:
+	static void Run()
+	{
+		for( int i = 0; i < 5; i++ )
+			CallStatistics::RecordCall( WorkerMethod, i == 0 ? E_INVALIDARG : S_OK );
+	}
+};
+
+class CallStatisticsTests : public testing::Test
+{
+protected:
+	virtual void SetUp()
+	{
+		CallStatistics::Enabled = true;
+		CallStatistics::LatencySampleInterval = 16;
+		CallStatistics::Reset();
+	}
+
+	virtual void TearDown()
+	{
+		CallStatistics::Enabled = false;
+		CallStatistics::Reset();
+	}
+};
+
+TEST_F( CallStatisticsTests, CountsCallsAndFailures )
+{
+	CallStatistics::RecordCall( TestMethod, S_OK );
+	CallStatistics::RecordCall( TestMethod, S_FALSE );
+	CallStatistics::RecordCall( TestMethod, E_FAIL );
+
+	CallCounter counter = FindCall( gcnew String( TestMethod ) );
+	ASSERT_EQ( 3, counter.Calls );
+	ASSERT_EQ( 1, counter.Failures );
+	ASSERT_EQ( 1, FindResult( E_FAIL ) );
+	ASSERT_EQ( 0, FindResult( S_FALSE ) );
+}
+
+TEST_F( CallStatisticsTests, DisabledCallsAreNotCounted )
+{
+	CallStatistics::Enabled = false;
+	CallStatistics::RecordCall( TestMethod, E_FAIL );
+
+	ASSERT_TRUE( FindCall( gcnew String( TestMethod ) ).Method == nullptr );
+	ASSERT_EQ( 0, FindResult( E_FAIL ) );
+}
+
+TEST_F( CallStatisticsTests, SamplesLatency )
+{
+	CallStatistics::LatencySampleInterval = 1;
+	CallStatistics::MarkCall();
+	CallStatistics::RecordCall( TestMethod, S_OK );
+	CallStatistics::RecordCall( TestMethod, S_OK );
+
+	// only the call that follows a mark is timed
+	CallCounter counter = FindCall( gcnew String( TestMethod ) );
+	ASSERT_EQ( 2, counter.Calls );
+	ASSERT_EQ( 1, counter.LatencySamples );
+
+	Int64 sampled = 0;
+	for each( Int64 bucket in counter.LatencyHistogram )
+		sampled += bucket;
+	ASSERT_EQ( 1, sampled );
+
+	array<double>^ bounds = CallStatistics::LatencyBucketBounds;
+	ASSERT_EQ( counter.LatencyHistogram->Length, bounds->Length );
+	ASSERT_EQ( 1.0, bounds[0] );
+	ASSERT_TRUE( Double::IsPositiveInfinity( bounds[bounds->Length - 1] ) );
+
+	ASSERT_MANAGED_THROW( CallStatistics::LatencySampleInterval = 0, ArgumentOutOfRangeException );
+}
+
+TEST_F( CallStatisticsTests, ResetClearsCounters )
+{
+	CallStatistics::RecordCall( TestMethod, E_FAIL );
+	CallStatistics::Reset();
+
+	ASSERT_TRUE( FindCall( gcnew String( TestMethod ) ).Method == nullptr );
+	ASSERT_EQ( 0, FindResult( E_FAIL ) );
+
+	// the slot is still usable after a reset
+	CallStatistics::RecordCall( TestMethod, S_OK );
+	ASSERT_EQ( 1, FindCall( gcnew String( TestMethod ) ).Calls );
+}
+
+TEST_F( CallStatisticsTests, KeepsCountsOfExitedThreads )
+{
+	Thread^ thread = gcnew Thread( gcnew ThreadStart( &CallStatisticsWorker::Run ) );
+	thread->Start();
+	thread->Join();
+
+	// the first snapshot folds the exited thread into the shared total; the second reads it back from there
+	for( int pass = 0; pass < 2; pass++ )
+	{
+		CallCounter counter = FindCall( gcnew String( WorkerMethod ) );
+		ASSERT_EQ( 5, counter.Calls );
+		ASSERT_EQ( 1, counter.Failures );
+		ASSERT_EQ( 1, FindResult( E_INVALIDARG ) );
+	}
+
+	CallStatistics::Reset();
+	ASSERT_TRUE( FindCall( gcnew String( WorkerMethod ) ).Method == nullptr );
+	ASSERT_EQ( 0, FindResult( E_INVALIDARG ) );
+}
@@ -66,3 +66,120 @@ TEST( DatastreamTests, ManagedArrayBackingReadBytesFromStart )
 	ASSERT_EQ( -1, stream->ReadByte() );
 	delete stream;
 }
+
+TEST( DatastreamTests, SliceSharesBackingStore )
+{
+	array<Byte>^ byteArray = gcnew array<Byte>( 16 );
+	DataStream^ stream = gcnew DataStream( byteArray, true, true );
+	DataStream^ slice = stream->Slice( 4, 8 );
+
+	ASSERT_EQ( 8, slice->Length );
+	ASSERT_EQ( stream->DataPointer + 4, slice->DataPointer );
+
+	slice->WriteByte( 42 );
+	ASSERT_EQ( 42, byteArray[4] );
+
+	delete slice;
+	delete stream;
+}
+
+TEST( DatastreamTests, SliceOutOfRange )
+{
+	DataStream^ stream = gcnew DataStream( 16, true, true );
+
+	ASSERT_MANAGED_THROW( stream->Slice( -1, 4 ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( stream->Slice( 12, 8 ), ArgumentException );
+
+	delete stream;
+}
+
+TEST( DatastreamTests, SliceOutlivesDisposedParent )
+{
+	DataStream^ stream = gcnew DataStream( 16, true, true );
+	stream->Write<int>( 1234 );
+	DataStream^ slice = stream->Slice( 0, 4 );
+
+	delete stream;
+	ASSERT_EQ( 1234, slice->Read<int>() );
+
+	delete slice;
+}
+
+ref class SliceReleaser
+{
+public:
+	DataStream^ Slice;
+
+	void Release()
+	{
+		delete Slice;
+	}
+};
+
+TEST( DatastreamTests, ParentAndSliceReleasedTogetherFreeMemory )
+{
+	// whichever of the two lets go last has to free the memory, however they interleave
+	for( int i = 0; i < 200; i++ )
+	{
+		DataStream^ stream = gcnew DataStream( 16, true, true );
+		SliceReleaser^ releaser = gcnew SliceReleaser();
+		releaser->Slice = stream->Slice( 0, 4 );
+
+		Threading::Thread^ thread = gcnew Threading::Thread( gcnew Threading::ThreadStart( releaser, &SliceReleaser::Release ) );
+		thread->Start();
+		delete stream;
+		thread->Join();
+
+		ASSERT_TRUE( stream->RawPointer == 0 );
+		ASSERT_MANAGED_THROW( stream->Slice( 0, 4 ), ObjectDisposedException );
+	}
+}
+
+TEST( DatastreamTests, AsReadOnlyCannotWrite )
+{
+	DataStream^ stream = gcnew DataStream( 16, true, true );
+	DataStream^ view = stream->AsReadOnly();
+
+	ASSERT_FALSE( view->CanWrite );
+	ASSERT_MANAGED_THROW( view->WriteByte( 0 ), NotSupportedException );
+
+	delete view;
+	delete stream;
+}
+
+TEST( DatastreamTests, TypedViewIndexesElements )
+{
+	array<int>^ intArray = gcnew array<int>( 8 );
+	for( int index = 0; index < intArray->Length; ++index )
+		intArray[index] = index * 10;
+
+	DataStream^ stream = gcnew DataStream( intArray, true, true );
+	DataView<int>^ view = stream->CreateView<int>( 8, 4 );
+
+	ASSERT_EQ( 4, view->Count );
+	ASSERT_EQ( 20, view[0] );
+	ASSERT_EQ( 50, view[3] );
+	ASSERT_MANAGED_THROW( view[4], ArgumentOutOfRangeException );
+
+	view[1] = 7;
+	ASSERT_EQ( 7, intArray[3] );
+
+	delete view;
+	delete stream;
+}
+
+TEST( DatastreamTests, TypedViewThrowsAfterDispose )
+{
+	array<int>^ intArray = gcnew array<int>( 8 );
+	DataStream^ stream = gcnew DataStream( intArray, true, true );
+	DataView<int>^ view = stream->CreateView<int>( 0, 8 );
+	array<int>^ scratch = gcnew array<int>( 4 );
+
+	delete view;
+	ASSERT_MANAGED_THROW( view[0], ObjectDisposedException );
+	ASSERT_MANAGED_THROW( view[0] = 1, ObjectDisposedException );
+	ASSERT_MANAGED_THROW( view->CopyTo( 0, scratch, 0, 4 ), ObjectDisposedException );
+	ASSERT_MANAGED_THROW( view->CopyFrom( scratch, 0, 0, 4 ), ObjectDisposedException );
+
+	delete stream;
+}
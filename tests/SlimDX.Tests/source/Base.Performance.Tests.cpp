@@ -0,0 +1,201 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::IO;
+using namespace System::Text;
+using namespace SlimDX;
+
+value struct RecordedEvent
+{
+	String^ Name;
+	int Color;
+	int Depth;
+	int Type;
+};
+
+// Parses a binary trace and returns the records of the calling thread, checking the reserved bytes on the way.
+static List<RecordedEvent>^ ReadThisThread( MemoryStream^ stream )
+{
+	stream->Position = 0;
+	BinaryReader^ reader = gcnew BinaryReader( stream, Encoding::UTF8 );
+
+	EXPECT_EQ( static_cast<int>( 'S' | 'D' << 8 | 'X' << 16 | 'T' << 24 ), reader->ReadInt32() );
+	EXPECT_EQ( 1, reader->ReadInt32() );
+	reader->ReadInt64();
+	reader->ReadInt64();
+
+	array<String^>^ names = gcnew array<String^>( reader->ReadInt32() );
+	for( int i = 0; i < names->Length; i++ )
+		names[i] = reader->ReadString();
+
+	List<RecordedEvent>^ result = gcnew List<RecordedEvent>();
+	int threadCount = reader->ReadInt32();
+	for( int t = 0; t < threadCount; t++ )
+	{
+		int threadId = reader->ReadInt32();
+		int recordCount = reader->ReadInt32();
+		for( int r = 0; r < recordCount; r++ )
+		{
+			RecordedEvent record;
+			reader->ReadInt64();
+			int nameId = reader->ReadInt32();
+			record.Name = nameId >= 0 && nameId < names->Length ? names[nameId] : nullptr;
+			record.Color = reader->ReadInt32();
+			record.Depth = reader->ReadInt16();
+			record.Type = reader->ReadByte();
+			EXPECT_EQ( 0, reader->ReadByte() );
+
+			if( threadId == Threading::Thread::CurrentThread->ManagedThreadId )
+				result->Add( record );
+		}
+	}
+
+	EXPECT_EQ( stream->Length, stream->Position );
+	return result;
+}
+
+static List<RecordedEvent>^ SaveThisThread()
+{
+	MemoryStream^ stream = gcnew MemoryStream();
+	Performance::SaveRecording( stream, PerformanceTraceFormat::Binary );
+	return ReadThisThread( stream );
+}
+
+TEST( PerformanceRecordingTests, RecordsNestedEvents )
+{
+	Performance::StartRecording( 64 );
+	Performance::ClearRecording();
+
+	Performance::BeginEvent( Color4( 1.0f, 0.0f, 0.0f, 1.0f ), "outer" );
+	ASSERT_EQ( 1, Performance::RecordingDepth );
+	Performance::SetMarker( Color4( 1.0f, 1.0f, 1.0f, 1.0f ), "tick" );
+	Performance::EndEvent();
+	ASSERT_EQ( 0, Performance::RecordingDepth );
+	Performance::StopRecording();
+
+	List<RecordedEvent>^ records = SaveThisThread();
+	ASSERT_EQ( 3, records->Count );
+	ASSERT_EQ( "outer", records[0].Name );
+	ASSERT_EQ( 0, records[0].Type );
+	ASSERT_EQ( "tick", records[1].Name );
+	ASSERT_EQ( 1, records[1].Depth );
+	ASSERT_EQ( 2, records[1].Type );
+	ASSERT_EQ( 1, records[2].Type );
+	ASSERT_EQ( 0, records[2].Depth );
+
+	Performance::ClearRecording();
+	ASSERT_EQ( 0, SaveThisThread()->Count );
+}
+
+TEST( PerformanceRecordingTests, FullRingSkipsSlotBeingWritten )
+{
+	Performance::StartRecording( 8 );
+	Performance::ClearRecording();
+
+	for( int i = 0; i < 20; i++ )
+		Performance::SetMarker( Color4(), i.ToString() );
+	Performance::StopRecording();
+
+	// the oldest slot is the next one the owner writes, so it is never trusted
+	List<RecordedEvent>^ records = SaveThisThread();
+	ASSERT_EQ( 7, records->Count );
+	for( int i = 0; i < records->Count; i++ )
+		ASSERT_EQ( ( 13 + i ).ToString(), records[i].Name );
+}
+
+TEST( PerformanceRecordingTests, WritesChromeTrace )
+{
+	Performance::StartRecording( 64 );
+	Performance::ClearRecording();
+
+	Performance::BeginEvent( Color4( 1.0f, 0.0f, 0.0f, 1.0f ), "outer \"frame\"" );
+	Performance::SetMarker( Color4( 1.0f, 1.0f, 1.0f, 1.0f ), "tick" );
+	Performance::EndEvent();
+	Performance::StopRecording();
+
+	MemoryStream^ stream = gcnew MemoryStream();
+	Performance::SaveRecording( stream, PerformanceTraceFormat::ChromeJson );
+	String^ text = Encoding::UTF8->GetString( stream->ToArray() );
+
+	ASSERT_TRUE( text->StartsWith( "{\"traceEvents\":[" ) );
+	ASSERT_TRUE( text->EndsWith( "],\"displayTimeUnit\":\"ms\"}\n" ) );
+	ASSERT_TRUE( text->Contains( "\"name\":\"outer \\\"frame\\\"\",\"ph\":\"B\"" ) );
+	ASSERT_TRUE( text->Contains( "\"name\":\"tick\",\"ph\":\"i\"" ) );
+	ASSERT_TRUE( text->Contains( "\"color\":\"#FFFF0000\",\"depth\":0" ) );
+	ASSERT_TRUE( text->Contains( "\"ph\":\"E\"" ) );
+
+	ASSERT_MANAGED_THROW( Performance::SaveRecording( nullptr, PerformanceTraceFormat::ChromeJson ), ArgumentNullException );
+	ASSERT_MANAGED_THROW( Performance::StartRecording( 0 ), ArgumentOutOfRangeException );
+}
+
+// Returns the number of threads a binary trace holds buffers for.
+static int SavedThreadCount()
+{
+	MemoryStream^ stream = gcnew MemoryStream();
+	Performance::SaveRecording( stream, PerformanceTraceFormat::Binary );
+
+	stream->Position = 0;
+	BinaryReader^ reader = gcnew BinaryReader( stream, Encoding::UTF8 );
+	reader->ReadInt32();
+	reader->ReadInt32();
+	reader->ReadInt64();
+	reader->ReadInt64();
+
+	int nameCount = reader->ReadInt32();
+	for( int i = 0; i < nameCount; i++ )
+		reader->ReadString();
+
+	return reader->ReadInt32();
+}
+
+static void MarkOnce()
+{
+	Performance::SetMarker( Color4(), "worker" );
+}
+
+TEST( PerformanceRecordingTests, RetiresExitedThreads )
+{
+	Performance::StartRecording( 64 );
+	Performance::ClearRecording();
+	MarkOnce();
+	int before = SavedThreadCount();
+
+	for( int i = 0; i < 20; i++ )
+	{
+		Threading::Thread^ thread = gcnew Threading::Thread( gcnew Threading::ThreadStart( &MarkOnce ) );
+		thread->Start();
+		thread->Join();
+	}
+
+	// the events of exited threads are kept until they are cleared
+	ASSERT_EQ( before + 20, SavedThreadCount() );
+
+	Performance::ClearRecording();
+	ASSERT_TRUE( SavedThreadCount() <= before );
+	Performance::StopRecording();
+}
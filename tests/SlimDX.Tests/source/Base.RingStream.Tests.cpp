@@ -0,0 +1,245 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::Threading;
+using namespace SlimDX;
+
+TEST( RingStreamTests, CapacityRoundsUpToPowerOfTwo )
+{
+	RingStream^ stream = gcnew RingStream( 100, RingStreamMode::SingleProducer );
+	ASSERT_EQ( 128, stream->Capacity );
+	ASSERT_EQ( 128, stream->FreeSpace );
+	ASSERT_EQ( 0, stream->Count );
+
+	delete stream;
+}
+
+TEST( RingStreamTests, ConstructWithInvalidCapacity )
+{
+	ASSERT_MANAGED_THROW( gcnew RingStream( 0, RingStreamMode::SingleProducer ), ArgumentOutOfRangeException );
+}
+
+TEST( RingStreamTests, WriteThenReadPreservesOrder )
+{
+	RingStream^ stream = gcnew RingStream( 16, RingStreamMode::SingleProducer );
+	array<Byte>^ input = gcnew array<Byte>( 10 );
+	for( int index = 0; index < input->Length; ++index )
+		input[index] = static_cast<Byte>( index );
+
+	stream->Write( input, 0, input->Length );
+	ASSERT_EQ( 10, stream->Count );
+
+	array<Byte>^ output = gcnew array<Byte>( 10 );
+	ASSERT_EQ( 10, stream->Read( output, 0, output->Length ) );
+	for( int index = 0; index < output->Length; ++index )
+		ASSERT_EQ( index, output[index] );
+
+	delete stream;
+}
+
+TEST( RingStreamTests, TryWriteStopsWhenFull )
+{
+	RingStream^ stream = gcnew RingStream( 8, RingStreamMode::MultipleProducer );
+	array<Byte>^ input = gcnew array<Byte>( 12 );
+
+	ASSERT_EQ( 8, stream->TryWrite( input, 0, input->Length ) );
+	ASSERT_EQ( 0, stream->TryWrite( input, 0, input->Length ) );
+	ASSERT_EQ( 8, stream->HighWaterMark );
+
+	delete stream;
+}
+
+TEST( RingStreamTests, ReservationSplitsAtWrapAround )
+{
+	RingStream^ stream = gcnew RingStream( 16, RingStreamMode::SingleProducer );
+	array<Byte>^ scratch = gcnew array<Byte>( 12 );
+
+	stream->Write( scratch, 0, 12 );
+	stream->Read( scratch, 0, 12 );
+
+	RingBufferRegion region = stream->ReserveWrite( 8 );
+	ASSERT_EQ( 4, region.FirstSize );
+	ASSERT_EQ( 4, region.SecondSize );
+	ASSERT_EQ( 8, region.Size );
+
+	stream->CommitWrite( region );
+	ASSERT_EQ( 8, stream->Count );
+
+	delete stream;
+}
+
+TEST( RingStreamTests, ReadReturnsZeroAfterCompletion )
+{
+	RingStream^ stream = gcnew RingStream( 16, RingStreamMode::SingleProducer );
+	array<Byte>^ buffer = gcnew array<Byte>( 4 );
+
+	stream->Write( buffer, 0, 4 );
+	stream->CompleteWriting();
+
+	ASSERT_EQ( 4, stream->Read( buffer, 0, 4 ) );
+	ASSERT_EQ( 0, stream->Read( buffer, 0, 4 ) );
+	ASSERT_TRUE( stream->IsCompleted );
+	ASSERT_MANAGED_THROW( stream->Write( buffer, 0, 4 ), InvalidOperationException );
+
+	delete stream;
+}
+
+TEST( RingStreamTests, WaitForDataTimesOut )
+{
+	RingStream^ stream = gcnew RingStream( 16, RingStreamMode::SingleProducer );
+
+	ASSERT_FALSE( stream->WaitForData( 1, 10 ) );
+	ASSERT_EQ( 1, stream->ConsumerStalls );
+
+	delete stream;
+}
+
+TEST( RingStreamTests, ThrowsAfterDispose )
+{
+	RingStream^ stream = gcnew RingStream( 16, RingStreamMode::SingleProducer );
+	array<Byte>^ buffer = gcnew array<Byte>( 4 );
+	delete stream;
+
+	ASSERT_MANAGED_THROW( stream->ReserveWrite( 4 ), ObjectDisposedException );
+	ASSERT_MANAGED_THROW( stream->PeekRead( 4 ), ObjectDisposedException );
+	ASSERT_MANAGED_THROW( stream->TryWrite( buffer, 0, 4 ), ObjectDisposedException );
+	ASSERT_MANAGED_THROW( stream->TryRead( buffer, 0, 4 ), ObjectDisposedException );
+	ASSERT_MANAGED_THROW( stream->WaitForData( 1, 0 ), ObjectDisposedException );
+	ASSERT_MANAGED_THROW( stream->WaitForSpace( 1, 0 ), ObjectDisposedException );
+}
+
+// Writes a known byte sequence from its own thread, or waits on the stream and records how the wait ended.
+ref class RingStreamWorker
+{
+public:
+	RingStreamWorker( RingStream^ stream, int id, int count )
+	{
+		Stream = stream;
+		Id = id;
+		Count = count;
+	}
+
+	// Each byte carries the producer in its top two bits and a running count in the rest, so that the
+	// consumer can check every producer's bytes arrive complete and in order however they interleave.
+	void Produce()
+	{
+		Random^ random = gcnew Random( Id );
+		array<Byte>^ chunk = gcnew array<Byte>( 48 );
+
+		int written = 0;
+		while( written < Count )
+		{
+			int size = Math::Min( random->Next( 1, chunk->Length ), Count - written );
+			for( int i = 0; i < size; i++ )
+				chunk[i] = static_cast<Byte>( ( Id << 6 ) | ( ( written + i ) & 63 ) );
+
+			Stream->Write( chunk, 0, size );
+			written += size;
+		}
+	}
+
+	void Wait()
+	{
+		try
+		{
+			Stream->WaitForData( 1, Timeout::Infinite );
+		}
+		catch( Exception^ e )
+		{
+			Error = e;
+		}
+	}
+
+	RingStream^ Stream;
+	int Id;
+	int Count;
+	Exception^ Error;
+};
+
+static void ProduceAndConsume( RingStreamMode mode, int producers )
+{
+	const int count = 100000;
+	RingStream^ stream = gcnew RingStream( 64, mode );
+
+	array<Thread^>^ threads = gcnew array<Thread^>( producers );
+	for( int i = 0; i < producers; i++ )
+	{
+		threads[i] = gcnew Thread( gcnew ThreadStart( gcnew RingStreamWorker( stream, i, count ), &RingStreamWorker::Produce ) );
+		threads[i]->Start();
+	}
+
+	array<int>^ received = gcnew array<int>( producers );
+	array<Byte>^ buffer = gcnew array<Byte>( 37 );
+	int total = 0;
+	while( total < count * producers )
+	{
+		int read = stream->Read( buffer, 0, buffer->Length );
+		for( int i = 0; i < read; i++ )
+		{
+			int id = buffer[i] >> 6;
+			ASSERT_TRUE( id < producers );
+			ASSERT_EQ( received[id] & 63, buffer[i] & 63 );
+			received[id]++;
+		}
+		total += read;
+	}
+
+	for( int i = 0; i < producers; i++ )
+	{
+		ASSERT_TRUE( threads[i]->Join( 10000 ) );
+		ASSERT_EQ( count, received[i] );
+	}
+	ASSERT_EQ( 0, stream->Count );
+
+	delete stream;
+}
+
+TEST( RingStreamTests, SingleProducerKeepsByteOrderAcrossThreads )
+{
+	ProduceAndConsume( RingStreamMode::SingleProducer, 1 );
+}
+
+TEST( RingStreamTests, MultipleProducersKeepByteOrderAcrossThreads )
+{
+	ProduceAndConsume( RingStreamMode::MultipleProducer, 4 );
+}
+
+TEST( RingStreamTests, DisposeReleasesWaitingConsumer )
+{
+	RingStream^ stream = gcnew RingStream( 16, RingStreamMode::SingleProducer );
+	RingStreamWorker^ worker = gcnew RingStreamWorker( stream, 0, 0 );
+	Thread^ thread = gcnew Thread( gcnew ThreadStart( worker, &RingStreamWorker::Wait ) );
+	thread->Start();
+
+	for( int i = 0; i < 2000 && stream->ConsumerStalls == 0; i++ )
+		Thread::Sleep( 1 );
+	Thread::Sleep( 20 );
+
+	delete stream;
+	ASSERT_TRUE( thread->Join( 2000 ) );
+	ASSERT_TRUE( dynamic_cast<ObjectDisposedException^>( worker->Error ) != nullptr );
+}
@@ -0,0 +1,155 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::IO;
+using namespace System::Runtime::InteropServices;
+using namespace SlimDX;
+
+static array<Byte>^ Pattern( int length )
+{
+	array<Byte>^ bytes = gcnew array<Byte>( length );
+	for( int i = 0; i < length; i++ )
+		bytes[i] = static_cast<Byte>( i * 7 + 3 );
+	return bytes;
+}
+
+static void AssertPattern( DataStream^ view, int start, int length )
+{
+	ASSERT_EQ( length, view->Length );
+	array<Byte>^ bytes = view->ReadRange<Byte>( length );
+	for( int i = 0; i < length; i++ )
+		ASSERT_EQ( static_cast<Byte>( ( start + i ) * 7 + 3 ), bytes[i] );
+}
+
+TEST( ReadStreamViewTests, SlicesDataStreamInPlace )
+{
+	DataStream^ source = gcnew DataStream( Pattern( 64 ), true, false );
+	source->Position = 8;
+
+	int length = 16;
+	DataStream^ view = Utilities::ReadStreamView( source, length, false );
+
+	ASSERT_TRUE( view->RawPointer == source->RawPointer + 8 );
+	ASSERT_EQ( 24, source->Position );
+	AssertPattern( view, 8, 16 );
+
+	delete view;
+	delete source;
+}
+
+TEST( ReadStreamViewTests, HonoursMemoryStreamOrigin )
+{
+	// the stream starts 10 bytes into the array, which GetBuffer does not reveal
+	MemoryStream^ source = gcnew MemoryStream( Pattern( 100 ), 10, 50, false, true );
+	source->Position = 5;
+
+	int length = 8;
+	DataStream^ view = Utilities::ReadStreamView( source, length, false );
+
+	AssertPattern( view, 15, 8 );
+	ASSERT_EQ( 13, source->Position );
+	delete view;
+
+	// a stream over the whole array starts at 0 and is sliced in place
+	source = gcnew MemoryStream( Pattern( 100 ), 0, 100, false, true );
+	source->Position = 40;
+	length = 0;
+	view = Utilities::ReadStreamView( source, length, false );
+
+	ASSERT_EQ( 60, length );
+	AssertPattern( view, 40, 60 );
+	delete view;
+}
+
+TEST( ReadStreamViewTests, BorrowsUnmanagedMemoryStreamOnlyWhenAllowed )
+{
+	array<Byte>^ pattern = Pattern( 32 );
+	IntPtr memory = Marshal::AllocHGlobal( 32 );
+	Marshal::Copy( pattern, 0, memory, 32 );
+
+	try
+	{
+		UnmanagedMemoryStream^ source = gcnew UnmanagedMemoryStream( static_cast<unsigned char*>( memory.ToPointer() ), 32 );
+		source->Position = 4;
+
+		int length = 12;
+		DataStream^ view = Utilities::ReadStreamView( source, length, true );
+		ASSERT_TRUE( view->RawPointer == static_cast<char*>( memory.ToPointer() ) + 4 );
+		AssertPattern( view, 4, 12 );
+		delete view;
+
+		source->Position = 4;
+		view = Utilities::ReadStreamView( source, length, false );
+		ASSERT_TRUE( view->RawPointer != static_cast<char*>( memory.ToPointer() ) + 4 );
+		AssertPattern( view, 4, 12 );
+		delete view;
+
+		delete source;
+	}
+	finally
+	{
+		Marshal::FreeHGlobal( memory );
+	}
+}
+
+TEST( ReadStreamViewTests, MapsLargeFilesAndCopiesSmallOnes )
+{
+	String^ path = Path::GetTempFileName();
+	int size = Utilities::MapThreshold + 4096;
+	File::WriteAllBytes( path, Pattern( size ) );
+
+	try
+	{
+		// an offset off the allocation granularity still lands on the right byte, and the view outlives the file stream
+		FileStream^ file = gcnew FileStream( path, FileMode::Open, FileAccess::Read, FileShare::Read );
+		file->Position = 100;
+		int length = Utilities::MapThreshold;
+		DataStream^ view = Utilities::ReadStreamView( file, length, false );
+		ASSERT_EQ( 100 + Utilities::MapThreshold, file->Position );
+		delete file;
+
+		AssertPattern( view, 100, Utilities::MapThreshold );
+		delete view;
+
+		file = gcnew FileStream( path, FileMode::Open, FileAccess::Read, FileShare::Read );
+		file->Position = 10;
+		length = 64;
+		view = Utilities::ReadStreamView( file, length, false );
+		delete file;
+
+		AssertPattern( view, 10, 64 );
+		delete view;
+
+		view = MappedFile::Map( path, size - 16, 0 );
+		AssertPattern( view, size - 16, 16 );
+		delete view;
+	}
+	finally
+	{
+		File::Delete( path );
+	}
+}
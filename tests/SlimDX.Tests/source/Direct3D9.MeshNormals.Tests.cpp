@@ -0,0 +1,230 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace SlimDX;
+using namespace SlimDX::Direct3D9;
+
+// position, normal, texture coordinate, tangent with handedness, binormal
+const int FrameStride = 60;
+
+static array<VertexElement>^ FrameDeclaration()
+{
+	array<VertexElement>^ declaration = {
+		VertexElement( 0, 0, DeclarationType::Float3, DeclarationMethod::Default, DeclarationUsage::Position, 0 ),
+		VertexElement( 0, 12, DeclarationType::Float3, DeclarationMethod::Default, DeclarationUsage::Normal, 0 ),
+		VertexElement( 0, 24, DeclarationType::Float2, DeclarationMethod::Default, DeclarationUsage::TextureCoordinate, 0 ),
+		VertexElement( 0, 32, DeclarationType::Float4, DeclarationMethod::Default, DeclarationUsage::Tangent, 0 ),
+		VertexElement( 0, 48, DeclarationType::Float3, DeclarationMethod::Default, DeclarationUsage::Binormal, 0 ),
+		VertexElement::VertexDeclarationEnd
+	};
+	return declaration;
+}
+
+// Builds vertices from positions and texture coordinates (five floats each), leaving room for as many again.
+static DataStream^ FrameVertices( array<float>^ data )
+{
+	int count = data->Length / 5;
+	DataStream^ stream = gcnew DataStream( count * FrameStride * 2, true, true );
+	for( int i = 0; i < count; i++ )
+	{
+		stream->Position = i * FrameStride;
+		stream->WriteRange( data, i * 5, 3 );
+		stream->Position = i * FrameStride + 24;
+		stream->WriteRange( data, i * 5 + 3, 2 );
+	}
+
+	stream->Position = 0;
+	return stream;
+}
+
+static DataStream^ Indices( array<int>^ indices )
+{
+	DataStream^ stream = gcnew DataStream( indices->Length * 4, true, true );
+	stream->WriteRange( indices );
+	stream->Position = 0;
+	return stream;
+}
+
+static array<float>^ ReadVector( DataStream^ vertices, int vertex, int offset, int count )
+{
+	vertices->Position = vertex * FrameStride + offset;
+	array<float>^ result = vertices->ReadRange<float>( count );
+	vertices->Position = 0;
+	return result;
+}
+
+static void AssertVector( float x, float y, float z, array<float>^ actual )
+{
+	ASSERT_NEAR( x, actual[0], 1e-5f );
+	ASSERT_NEAR( y, actual[1], 1e-5f );
+	ASSERT_NEAR( z, actual[2], 1e-5f );
+}
+
+// Two unit quads side by side in the z = 0 plane; the second one mirrors the texture in u and shares an edge with the first.
+static DataStream^ MirroredQuads( DataStream^ %indices )
+{
+	array<float>^ data = {
+		0, 0, 0, 0, 0,
+		1, 0, 0, 1, 0,
+		0, 1, 0, 0, 1,
+		1, 1, 0, 1, 1,
+		2, 0, 0, 0, 0,
+		2, 1, 0, 0, 1
+	};
+
+	array<int>^ faces = { 0, 1, 2, 1, 3, 2, 1, 4, 3, 4, 5, 3 };
+	indices = Indices( faces );
+	return FrameVertices( data );
+}
+
+TEST( MeshNormalsTests, WeightsNormalsByAngle )
+{
+	// a right angle at vertex 0 in the z = 0 plane, and half a right angle in the x = 0 plane
+	array<float>^ data = {
+		0, 0, 0, 0, 0,
+		1, 0, 0, 0, 0,
+		0, 1, 0, 0, 0,
+		0, 0, 1, 0, 0,
+		0, 1, 1, 0, 0
+	};
+	array<int>^ faces = { 0, 1, 2, 0, 3, 4 };
+
+	DataStream^ indices = Indices( faces );
+	DataStream^ vertices = FrameVertices( data );
+	MeshNormals::ComputeNormals( indices, false, 2, vertices, 5, FrameStride, FrameDeclaration(), nullptr, TangentOptions::None );
+	float length = static_cast<float>( Math::Sqrt( 5.0 ) );
+	AssertVector( -1.0f / length, 0.0f, 2.0f / length, ReadVector( vertices, 0, 12, 3 ) );
+	AssertVector( 0.0f, 0.0f, 1.0f, ReadVector( vertices, 1, 12, 3 ) );
+	AssertVector( -1.0f, 0.0f, 0.0f, ReadVector( vertices, 3, 12, 3 ) );
+
+	// both faces have the same area
+	MeshNormals::ComputeNormals( indices, false, 2, vertices, 5, FrameStride, FrameDeclaration(), nullptr, TangentOptions::WeightByArea );
+	length = static_cast<float>( Math::Sqrt( 2.0 ) );
+	AssertVector( -1.0f / length, 0.0f, 1.0f / length, ReadVector( vertices, 0, 12, 3 ) );
+
+	MeshNormals::ComputeNormals( indices, false, 2, vertices, 5, FrameStride, FrameDeclaration(), nullptr, TangentOptions::WindCW );
+	AssertVector( 0.0f, 0.0f, -1.0f, ReadVector( vertices, 1, 12, 3 ) );
+}
+
+TEST( MeshNormalsTests, SharesNormalsBetweenPointReps )
+{
+	// vertex 3 sits on vertex 0 but only belongs to the second face
+	array<float>^ data = {
+		0, 0, 0, 0, 0,
+		1, 0, 0, 0, 0,
+		0, 1, 0, 0, 0,
+		0, 0, 0, 0, 0,
+		0, 0, 1, 0, 0,
+		0, 1, 1, 0, 0
+	};
+	array<int>^ faces = { 0, 1, 2, 3, 4, 5 };
+
+	DataStream^ indices = Indices( faces );
+	DataStream^ vertices = FrameVertices( data );
+	MeshNormals::ComputeNormals( indices, false, 2, vertices, 6, FrameStride, FrameDeclaration(), nullptr, TangentOptions::None );
+	AssertVector( 0.0f, 0.0f, 1.0f, ReadVector( vertices, 0, 12, 3 ) );
+	AssertVector( -1.0f, 0.0f, 0.0f, ReadVector( vertices, 3, 12, 3 ) );
+
+	array<int>^ pointReps = { 0, 1, 2, 0, 4, 5 };
+	MeshNormals::ComputeNormals( indices, false, 2, vertices, 6, FrameStride, FrameDeclaration(), pointReps, TangentOptions::None );
+	array<float>^ first = ReadVector( vertices, 0, 12, 3 );
+	AssertVector( first[0], first[1], first[2], ReadVector( vertices, 3, 12, 3 ) );
+	float length = static_cast<float>( Math::Sqrt( 5.0 ) );
+	AssertVector( -1.0f / length, 0.0f, 2.0f / length, first );
+}
+
+TEST( MeshNormalsTests, SplitsMirroredVertices )
+{
+	DataStream^ indices;
+	DataStream^ vertices = MirroredQuads( indices );
+
+	array<int>^ vertexMapping;
+	int count = MeshNormals::ComputeTangentFrame( indices, false, 4, vertices, 6, FrameStride, FrameDeclaration(), 0, nullptr,
+		TangentOptions::CalculateNormals, true, vertexMapping );
+
+	// the two vertices on the shared edge get a mirrored copy each
+	ASSERT_EQ( 8, count );
+	ASSERT_EQ( 8, vertexMapping->Length );
+	ASSERT_EQ( 1, vertexMapping[6] );
+	ASSERT_EQ( 3, vertexMapping[7] );
+
+	array<int>^ split = indices->ReadRange<int>( 12 );
+	array<int>^ expected = { 0, 1, 2, 1, 3, 2, 6, 4, 7, 4, 5, 7 };
+	for( int i = 0; i < 12; i++ )
+		ASSERT_EQ( expected[i], split[i] );
+
+	for( int v = 0; v < 8; v++ )
+	{
+		bool mirrored = v == 4 || v == 5 || v >= 6;
+		array<float>^ tangent = ReadVector( vertices, v, 32, 4 );
+		AssertVector( mirrored ? -1.0f : 1.0f, 0.0f, 0.0f, tangent );
+		ASSERT_EQ( mirrored ? -1.0f : 1.0f, tangent[3] );
+
+		// the bitangent follows increasing v either way
+		AssertVector( 0.0f, 1.0f, 0.0f, ReadVector( vertices, v, 48, 3 ) );
+		AssertVector( 0.0f, 0.0f, 1.0f, ReadVector( vertices, v, 12, 3 ) );
+	}
+}
+
+TEST( MeshNormalsTests, MergesMirroredVerticesWhenNotSplitting )
+{
+	DataStream^ indices;
+	DataStream^ vertices = MirroredQuads( indices );
+
+	array<int>^ vertexMapping;
+	int count = MeshNormals::ComputeTangentFrame( indices, false, 4, vertices, 6, FrameStride, FrameDeclaration(), 0, nullptr,
+		TangentOptions::CalculateNormals, false, vertexMapping );
+	ASSERT_EQ( 6, count );
+
+	// each shared vertex takes the side with more corners
+	array<float>^ tangent = ReadVector( vertices, 1, 32, 4 );
+	AssertVector( 1.0f, 0.0f, 0.0f, tangent );
+	ASSERT_EQ( 1.0f, tangent[3] );
+
+	tangent = ReadVector( vertices, 3, 32, 4 );
+	AssertVector( -1.0f, 0.0f, 0.0f, tangent );
+	ASSERT_EQ( -1.0f, tangent[3] );
+}
+
+TEST( MeshNormalsTests, ValidatesArguments )
+{
+	DataStream^ indices;
+	DataStream^ vertices = MirroredQuads( indices );
+	array<int>^ vertexMapping;
+
+	array<VertexElement>^ noTangent = FrameDeclaration();
+	noTangent[3] = VertexElement::VertexDeclarationEnd;
+	ASSERT_MANAGED_THROW( MeshNormals::ComputeTangentFrame( indices, false, 4, vertices, 6, FrameStride, noTangent, 0, nullptr, TangentOptions::None, true, vertexMapping ), ArgumentException );
+	ASSERT_MANAGED_THROW( MeshNormals::ComputeTangentFrame( indices, false, 4, vertices, 6, FrameStride, FrameDeclaration(), 8, nullptr, TangentOptions::None, true, vertexMapping ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( MeshNormals::ComputeNormals( indices, false, 4, vertices, 6, FrameStride, FrameDeclaration(), gcnew array<int>( 5 ), TangentOptions::None ), ArgumentException );
+
+	// no room for the split vertices
+	DataStream^ tight = gcnew DataStream( 6 * FrameStride, true, true );
+	tight->WriteRange( IntPtr( vertices->PositionPointer ), 6 * FrameStride );
+	tight->Position = 0;
+	ASSERT_MANAGED_THROW( MeshNormals::ComputeTangentFrame( indices, false, 4, tight, 6, FrameStride, FrameDeclaration(), 0, nullptr, TangentOptions::CalculateNormals, true, vertexMapping ), ArgumentException );
+}
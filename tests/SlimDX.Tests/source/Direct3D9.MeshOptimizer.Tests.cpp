@@ -0,0 +1,225 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace SlimDX;
+using namespace SlimDX::Direct3D9;
+
+// A grid of quads with its faces shuffled, so the cache order is as bad as it gets.
+static DataStream^ ShuffledGrid( int size, int &faceCount, int &vertexCount )
+{
+	faceCount = size * size * 2;
+	vertexCount = ( size + 1 ) * ( size + 1 );
+
+	array<int>^ indices = gcnew array<int>( faceCount * 3 );
+	for( int y = 0; y < size; y++ )
+	{
+		for( int x = 0; x < size; x++ )
+		{
+			int a = y * ( size + 1 ) + x;
+			int face = ( y * size + x ) * 2;
+			array<int>^ quad = { a, a + 1, a + size + 1, a + 1, a + size + 2, a + size + 1 };
+			Array::Copy( quad, 0, indices, face * 3, 6 );
+		}
+	}
+
+	Random^ random = gcnew Random( 7 );
+	for( int i = faceCount - 1; i > 0; i-- )
+	{
+		int j = random->Next( i + 1 );
+		for( int corner = 0; corner < 3; corner++ )
+		{
+			int temp = indices[i * 3 + corner];
+			indices[i * 3 + corner] = indices[j * 3 + corner];
+			indices[j * 3 + corner] = temp;
+		}
+	}
+
+	DataStream^ stream = gcnew DataStream( indices->Length * 4, true, true );
+	stream->WriteRange( indices );
+	stream->Position = 0;
+	return stream;
+}
+
+static array<int>^ ReadAll( DataStream^ stream, int count )
+{
+	array<int>^ result = gcnew array<int>( count );
+	stream->Position = 0;
+	stream->ReadRange( result, 0, count );
+	stream->Position = 0;
+	return result;
+}
+
+TEST( MeshOptimizerTests, MeasuresTheVertexCache )
+{
+	array<short>^ indices = { 0, 1, 2, 2, 1, 3, 0, 1, 2 };
+	DataStream^ stream = gcnew DataStream( 18, true, true );
+	stream->WriteRange( indices );
+	stream->Position = 0;
+
+	VertexCacheStatistics statistics = MeshOptimizer::AnalyzeVertexCache( stream, true, 3, 4, 16 );
+	ASSERT_EQ( 3, statistics.FaceCount );
+	ASSERT_EQ( 4, statistics.VertexCount );
+	ASSERT_EQ( 4, statistics.CacheMissCount );
+	ASSERT_FLOAT_EQ( 4.0f / 3.0f, statistics.AverageCacheMissRatio );
+	ASSERT_FLOAT_EQ( 1.0f, statistics.AverageTransformToVertexRatio );
+
+	// a three entry FIFO has pushed out the first face by the time it comes around again
+	statistics = MeshOptimizer::AnalyzeVertexCache( stream, true, 3, 4, 3 );
+	ASSERT_EQ( 7, statistics.CacheMissCount );
+}
+
+TEST( MeshOptimizerTests, ReordersFacesForTheVertexCache )
+{
+	int faceCount;
+	int vertexCount;
+	DataStream^ stream = ShuffledGrid( 24, faceCount, vertexCount );
+	array<int>^ original = ReadAll( stream, faceCount * 3 );
+
+	VertexCacheStatistics before = MeshOptimizer::AnalyzeVertexCache( stream, false, faceCount, vertexCount, 16 );
+	array<int>^ faceRemap = MeshOptimizer::OptimizeVertexCache( stream, false, faceCount );
+	VertexCacheStatistics after = MeshOptimizer::AnalyzeVertexCache( stream, false, faceCount, vertexCount, 16 );
+
+	ASSERT_TRUE( before.AverageCacheMissRatio > 2.5f );
+	ASSERT_TRUE( after.AverageCacheMissRatio < 0.8f );
+	ASSERT_EQ( before.VertexCount, after.VertexCount );
+
+	// every face appears exactly once, with its corners in the original order
+	array<int>^ optimized = ReadAll( stream, faceCount * 3 );
+	array<bool>^ seen = gcnew array<bool>( faceCount );
+	for( int i = 0; i < faceCount; i++ )
+	{
+		ASSERT_FALSE( seen[faceRemap[i]] );
+		seen[faceRemap[i]] = true;
+		for( int corner = 0; corner < 3; corner++ )
+			ASSERT_EQ( original[faceRemap[i] * 3 + corner], optimized[i * 3 + corner] );
+	}
+}
+
+TEST( MeshOptimizerTests, ReordersVerticesByFirstUse )
+{
+	array<int>^ indices = { 3, 1, 4, 4, 1, 0 };
+	DataStream^ indexStream = gcnew DataStream( 24, true, true );
+	indexStream->WriteRange( indices );
+	indexStream->Position = 0;
+
+	array<float>^ vertices = { 0.0f, 10.0f, 20.0f, 30.0f, 40.0f, 50.0f };
+	DataStream^ vertexStream = gcnew DataStream( 24, true, true );
+	vertexStream->WriteRange( vertices );
+	vertexStream->Position = 0;
+
+	array<int>^ vertexRemap = MeshOptimizer::OptimizeVertexFetch( indexStream, false, 2, vertexStream, 6, 4 );
+
+	array<int>^ expectedRemap = { 3, 1, 4, 0, 2, 5 };
+	for( int i = 0; i < 6; i++ )
+		ASSERT_EQ( expectedRemap[i], vertexRemap[i] );
+
+	array<int>^ remapped = ReadAll( indexStream, 6 );
+	array<int>^ expectedIndices = { 0, 1, 2, 2, 1, 3 };
+	for( int i = 0; i < 6; i++ )
+		ASSERT_EQ( expectedIndices[i], remapped[i] );
+
+	array<float>^ moved = vertexStream->ReadRange<float>( 6 );
+	for( int i = 0; i < 6; i++ )
+		ASSERT_EQ( vertices[expectedRemap[i]], moved[i] );
+}
+
+TEST( MeshOptimizerTests, KeepsFacesInTheirSubsets )
+{
+	int faceCount;
+	int vertexCount;
+	DataStream^ grid = ShuffledGrid( 8, faceCount, vertexCount );
+	array<int>^ original = ReadAll( grid, faceCount * 3 );
+
+	// the same grid with 16-bit indices and three floats per vertex
+	DataStream^ indices = gcnew DataStream( faceCount * 6, true, true );
+	for( int i = 0; i < original->Length; i++ )
+		indices->Write( static_cast<short>( original[i] ) );
+	indices->Position = 0;
+
+	DataStream^ vertices = gcnew DataStream( vertexCount * 12, true, true );
+	for( int i = 0; i < vertexCount; i++ )
+	{
+		vertices->Write( static_cast<float>( i % 9 ) );
+		vertices->Write( static_cast<float>( i / 9 ) );
+		vertices->Write( static_cast<float>( i ) );
+	}
+	vertices->Position = 0;
+
+	array<AttributeRange>^ table = gcnew array<AttributeRange>( 2 );
+	table[0].FaceStart = 0;
+	table[0].FaceCount = 50;
+	table[1].AttribId = 1;
+	table[1].FaceStart = 50;
+	table[1].FaceCount = faceCount - 50;
+
+	array<int>^ faceRemap;
+	array<int>^ vertexRemap;
+	MeshOptimizer::Optimize( indices, true, faceCount, vertices, vertexCount, 12, 0, table, MeshOptimizeFlags::VertexCache, true, faceRemap, vertexRemap );
+
+	for( int i = 0; i < faceCount; i++ )
+		ASSERT_EQ( i < 50, faceRemap[i] < 50 );
+
+	// the faces still use the same vertices, wherever they moved to
+	array<short>^ optimized = indices->ReadRange<short>( faceCount * 3 );
+	array<float>^ moved = vertices->ReadRange<float>( vertexCount * 3 );
+	for( int i = 0; i < faceCount * 3; i++ )
+	{
+		int vertex = optimized[i];
+		ASSERT_EQ( original[faceRemap[i / 3] * 3 + i % 3], vertexRemap[vertex] );
+		ASSERT_EQ( static_cast<float>( vertexRemap[vertex] ), moved[vertex * 3 + 2] );
+		ASSERT_TRUE( vertex >= table[i < 150 ? 0 : 1].VertexStart );
+		ASSERT_TRUE( vertex < table[i < 150 ? 0 : 1].VertexStart + table[i < 150 ? 0 : 1].VertexCount );
+	}
+
+	// vertices are fetched in order, so the first subset starts at the first vertex
+	ASSERT_EQ( 0, table[0].VertexStart );
+	ASSERT_EQ( 0, optimized[0] );
+}
+
+TEST( MeshOptimizerTests, ValidatesArguments )
+{
+	array<int>^ indices = { 0, 1, 2 };
+	DataStream^ stream = gcnew DataStream( 12, true, true );
+	stream->WriteRange( indices );
+	stream->Position = 0;
+	DataStream^ vertices = gcnew DataStream( 48, true, true );
+
+	array<int>^ faceRemap;
+	array<int>^ vertexRemap;
+
+	ASSERT_MANAGED_THROW( MeshOptimizer::OptimizeVertexCache( nullptr, false, 1 ), ArgumentNullException );
+	ASSERT_MANAGED_THROW( MeshOptimizer::OptimizeVertexCache( stream, false, 2 ), ArgumentException );
+	ASSERT_MANAGED_THROW( MeshOptimizer::OptimizeVertexCache( stream, false, -1 ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( MeshOptimizer::AnalyzeVertexCache( stream, false, 1, 6, 0 ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( MeshOptimizer::AnalyzeVertexCache( stream, false, 1, 2, 16 ), ArgumentException );
+	ASSERT_MANAGED_THROW( MeshOptimizer::OptimizeVertexFetch( stream, false, 1, vertices, 6, 12 ), ArgumentException );
+	ASSERT_MANAGED_THROW( MeshOptimizer::Optimize( stream, false, 1, vertices, 4, 12, 4, nullptr, MeshOptimizeFlags::VertexCache, true, faceRemap, vertexRemap ), ArgumentOutOfRangeException );
+
+	array<AttributeRange>^ table = gcnew array<AttributeRange>( 1 );
+	table[0].FaceCount = 2;
+	ASSERT_MANAGED_THROW( MeshOptimizer::Optimize( stream, false, 1, vertices, 4, 12, 0, table, MeshOptimizeFlags::VertexCache, false, faceRemap, vertexRemap ), ArgumentException );
+}
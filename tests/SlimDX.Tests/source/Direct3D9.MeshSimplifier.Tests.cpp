@@ -0,0 +1,189 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace SlimDX;
+using namespace SlimDX::Direct3D9;
+
+// position and texture coordinate
+const int GridStride = 20;
+
+static array<VertexElement>^ GridDeclaration()
+{
+	array<VertexElement>^ declaration = {
+		VertexElement( 0, 0, DeclarationType::Float3, DeclarationMethod::Default, DeclarationUsage::Position, 0 ),
+		VertexElement( 0, 12, DeclarationType::Float2, DeclarationMethod::Default, DeclarationUsage::TextureCoordinate, 0 ),
+		VertexElement::VertexDeclarationEnd
+	};
+	return declaration;
+}
+
+static AttributeWeights GridWeights()
+{
+	AttributeWeights weights;
+	weights.Position = 1.0f;
+	weights.Boundary = 1.0f;
+	weights.TextureCoordinate1 = 1.0f;
+	return weights;
+}
+
+// A grid of size by size unit quads, raised by height( x, y ), with the texture stretched over it.
+static DataStream^ Grid( int size, bool bumpy, DataStream^ %indices )
+{
+	int row = size + 1;
+	DataStream^ vertices = gcnew DataStream( row * row * GridStride, true, true );
+	for( int y = 0; y <= size; y++ )
+	{
+		for( int x = 0; x <= size; x++ )
+		{
+			float z = bumpy ? static_cast<float>( Math::Sin( x * 0.7 ) * Math::Cos( y * 0.5 ) ) : 0.0f;
+			array<float>^ vertex = { static_cast<float>( x ), static_cast<float>( y ), z, x / static_cast<float>( size ), y / static_cast<float>( size ) };
+			vertices->WriteRange( vertex );
+		}
+	}
+
+	array<int>^ faces = gcnew array<int>( size * size * 6 );
+	for( int y = 0, i = 0; y < size; y++ )
+	{
+		for( int x = 0; x < size; x++ )
+		{
+			int corner = y * row + x;
+			array<int>^ quad = { corner, corner + 1, corner + row, corner + 1, corner + row + 1, corner + row };
+			quad->CopyTo( faces, i );
+			i += 6;
+		}
+	}
+
+	indices = gcnew DataStream( faces->Length * 4, true, true );
+	indices->WriteRange( faces );
+	indices->Position = 0;
+	vertices->Position = 0;
+	return vertices;
+}
+
+static float Area( DataStream^ vertices, array<int>^ faces, int faceCount )
+{
+	array<float>^ data = vertices->ReadRange<float>( static_cast<int>( vertices->Length / 4 ) );
+	vertices->Position = 0;
+
+	double area = 0.0;
+	for( int f = 0; f < faceCount; f++ )
+	{
+		int a = faces[f * 3] * 5, b = faces[f * 3 + 1] * 5, c = faces[f * 3 + 2] * 5;
+		area += ( ( data[b] - data[a] ) * ( data[c + 1] - data[a + 1] ) - ( data[b + 1] - data[a + 1] ) * ( data[c] - data[a] ) ) * 0.5;
+	}
+
+	return static_cast<float>( area );
+}
+
+TEST( MeshSimplifierTests, SimplifiesFlatGridWithoutError )
+{
+	DataStream^ indices;
+	DataStream^ vertices = Grid( 16, false, indices );
+	array<int>^ faceRemap;
+	float error;
+
+	int count = MeshSimplifier::Simplify( indices, false, 512, vertices, 289, GridStride, GridDeclaration(), GridWeights(), nullptr,
+		100, 1.0f, false, faceRemap, error );
+
+	ASSERT_LE( count, 100 );
+	ASSERT_GT( count, 0 );
+	ASSERT_EQ( count, faceRemap->Length );
+	ASSERT_NEAR( 0.0f, error, 1e-5f );
+
+	array<int>^ faces = indices->ReadRange<int>( count * 3 );
+	ASSERT_NEAR( 256.0f, Area( vertices, faces, count ), 1e-3f );
+
+	// the corners of the border cannot move
+	ASSERT_LE( 0, Array::IndexOf( faces, 0 ) );
+	ASSERT_LE( 0, Array::IndexOf( faces, 16 ) );
+	ASSERT_LE( 0, Array::IndexOf( faces, 272 ) );
+	ASSERT_LE( 0, Array::IndexOf( faces, 288 ) );
+}
+
+TEST( MeshSimplifierTests, GeneratesLevelsOfIncreasingError )
+{
+	DataStream^ indices;
+	DataStream^ vertices = Grid( 32, true, indices );
+
+	array<LevelOfDetail^>^ levels = MeshSimplifier::GenerateLevels( indices, false, 2048, vertices, 1089, GridStride, GridDeclaration(),
+		GridWeights(), nullptr, 4, 0.5f, true );
+
+	ASSERT_EQ( 4, levels->Length );
+	ASSERT_EQ( 2048, levels[0]->FaceCount );
+	ASSERT_EQ( 0.0f, levels[0]->GeometricError );
+
+	for( int i = 1; i < levels->Length; i++ )
+	{
+		ASSERT_LT( levels[i]->FaceCount, levels[i - 1]->FaceCount );
+		ASSERT_LE( levels[i - 1]->GeometricError, levels[i]->GeometricError );
+		ASSERT_EQ( levels[i]->FaceCount, levels[i]->GetFaceRemap()->Length );
+
+		// a locked border keeps all of its vertices
+		array<int>^ faces = levels[i]->GetIndices();
+		for( int x = 0; x <= 32; x++ )
+			ASSERT_LE( 0, Array::IndexOf( faces, x ) );
+	}
+
+	// the 128 border vertices cannot be covered by 32 faces, so the chain ends early
+	levels = MeshSimplifier::GenerateLevels( indices, false, 2048, vertices, 1089, GridStride, GridDeclaration(), GridWeights(), nullptr, 4, 0.25f, true );
+	ASSERT_EQ( 3, levels->Length );
+}
+
+TEST( MeshSimplifierTests, ProjectsErrorOntoScreen )
+{
+	array<LevelOfDetail^>^ levels = {
+		gcnew LevelOfDetail( gcnew array<int>( 3 ), gcnew array<int>( 1 ), 0.0f ),
+		gcnew LevelOfDetail( gcnew array<int>( 3 ), gcnew array<int>( 1 ), 0.1f ),
+		gcnew LevelOfDetail( gcnew array<int>( 3 ), gcnew array<int>( 1 ), 1.0f )
+	};
+
+	// a 90 degree field of view puts 20 units across 1000 pixels at a distance of 10
+	float fov = static_cast<float>( Math::PI / 2.0 );
+	ASSERT_NEAR( 50.0f, levels[2]->GetScreenSpaceError( 10.0f, fov, 1000.0f ), 1e-3f );
+	ASSERT_NEAR( 5.0f, levels[1]->GetScreenSpaceError( 10.0f, fov, 1000.0f ), 1e-3f );
+
+	ASSERT_EQ( 1, LevelOfDetail::SelectLevel( levels, 10.0f, fov, 1000.0f, 10.0f ) );
+	ASSERT_EQ( 0, LevelOfDetail::SelectLevel( levels, 10.0f, fov, 1000.0f, 1.0f ) );
+	ASSERT_EQ( 2, LevelOfDetail::SelectLevel( levels, 1000.0f, fov, 1000.0f, 1.0f ) );
+	ASSERT_MANAGED_THROW( levels[0]->GetScreenSpaceError( 0.0f, fov, 1000.0f ), ArgumentOutOfRangeException );
+}
+
+TEST( MeshSimplifierTests, ValidatesArguments )
+{
+	DataStream^ indices;
+	DataStream^ vertices = Grid( 2, false, indices );
+	array<int>^ faceRemap;
+	float error;
+
+	array<VertexElement>^ noPosition = GridDeclaration();
+	noPosition[0] = VertexElement::VertexDeclarationEnd;
+	ASSERT_MANAGED_THROW( MeshSimplifier::Simplify( indices, false, 8, vertices, 9, GridStride, noPosition, GridWeights(), nullptr, 4, 1.0f, false, faceRemap, error ), ArgumentException );
+	ASSERT_MANAGED_THROW( MeshSimplifier::Simplify( indices, false, 8, vertices, 9, GridStride, GridDeclaration(), GridWeights(), gcnew array<float>( 4 ), 4, 1.0f, false, faceRemap, error ), ArgumentException );
+	ASSERT_MANAGED_THROW( MeshSimplifier::Simplify( indices, false, 8, vertices, 9, GridStride, GridDeclaration(), GridWeights(), nullptr, -1, 1.0f, false, faceRemap, error ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( MeshSimplifier::GenerateLevels( indices, false, 8, vertices, 9, GridStride, GridDeclaration(), GridWeights(), nullptr, 3, 1.0f, false ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( MeshSimplifier::GenerateLevels( indices, false, 8, vertices, 9, GridStride, GridDeclaration(), GridWeights(), nullptr, 0, 0.5f, false ), ArgumentOutOfRangeException );
+}
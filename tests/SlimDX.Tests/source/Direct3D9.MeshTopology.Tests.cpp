@@ -0,0 +1,318 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace SlimDX;
+using namespace SlimDX::Direct3D9;
+
+// A grid of quads in which every quad has its own four vertices, as if it had been exported face by face.
+static void SplitGrid( int size, DataStream^ %indices, DataStream^ %vertices, int &faceCount, int &vertexCount )
+{
+	faceCount = size * size * 2;
+	vertexCount = size * size * 4;
+
+	indices = gcnew DataStream( faceCount * 12, true, true );
+	vertices = gcnew DataStream( vertexCount * 12, true, true );
+	for( int y = 0; y < size; y++ )
+	{
+		for( int x = 0; x < size; x++ )
+		{
+			int a = ( y * size + x ) * 4;
+			array<int>^ quad = { a, a + 1, a + 2, a + 1, a + 3, a + 2 };
+			indices->WriteRange( quad );
+
+			float left = static_cast<float>( x );
+			float top = static_cast<float>( y );
+			array<float>^ corners = { left, top, 0, left + 1, top, 0, left, top + 1, 0, left + 1, top + 1, 0 };
+			vertices->WriteRange( corners );
+		}
+	}
+
+	indices->Position = 0;
+	vertices->Position = 0;
+}
+
+static array<VertexElement>^ PositionNormal()
+{
+	array<VertexElement>^ declaration = {
+		VertexElement( 0, 0, DeclarationType::Float3, DeclarationMethod::Default, DeclarationUsage::Position, 0 ),
+		VertexElement( 0, 12, DeclarationType::Float3, DeclarationMethod::Default, DeclarationUsage::Normal, 0 ),
+		VertexElement::VertexDeclarationEnd
+	};
+	return declaration;
+}
+
+// Two triangles sharing an edge, with the shared corners duplicated and given the normals passed in.
+static DataStream^ TwoTriangles( float normal, float otherNormal, DataStream^ %indices )
+{
+	array<int>^ faces = { 0, 1, 2, 4, 3, 5 };
+	indices = gcnew DataStream( 24, true, true );
+	indices->WriteRange( faces );
+	indices->Position = 0;
+
+	array<float>^ data = {
+		0, 0, 0, 0, 0, normal,
+		1, 0, 0, 0, 0, normal,
+		0, 1, 0, 0, 0, normal,
+		1, 0, 0, 0, 0, otherNormal,
+		0, 1, 0, 0, 0, otherNormal,
+		1, 1, 0, 0, 0, otherNormal
+	};
+	DataStream^ vertices = gcnew DataStream( data->Length * 4, true, true );
+	vertices->WriteRange( data );
+	vertices->Position = 0;
+	return vertices;
+}
+
+TEST( MeshTopologyTests, WeldsCoincidentVertices )
+{
+	DataStream^ indices;
+	DataStream^ vertices;
+	int faceCount;
+	int vertexCount;
+	SplitGrid( 4, indices, vertices, faceCount, vertexCount );
+	array<int>^ original = indices->ReadRange<int>( faceCount * 3 );
+	array<float>^ positions = vertices->ReadRange<float>( vertexCount * 3 );
+	indices->Position = 0;
+	vertices->Position = 0;
+
+	array<VertexElement>^ declaration = {
+		VertexElement( 0, 0, DeclarationType::Float3, DeclarationMethod::Default, DeclarationUsage::Position, 0 ),
+		VertexElement::VertexDeclarationEnd
+	};
+
+	array<int>^ vertexRemap;
+	int count = MeshTopology::WeldVertices( indices, false, faceCount, vertices, vertexCount, 12, declaration, WeldFlags::None, WeldEpsilons(), vertexRemap );
+	ASSERT_EQ( 25, count );
+
+	// the first vertex of each position survives, in order
+	ASSERT_EQ( 0, vertexRemap[0] );
+	ASSERT_EQ( 1, vertexRemap[1] );
+	ASSERT_EQ( 2, vertexRemap[2] );
+	ASSERT_EQ( 3, vertexRemap[3] );
+	ASSERT_EQ( 5, vertexRemap[4] );
+	for( int i = count; i < vertexCount; i++ )
+		ASSERT_EQ( -1, vertexRemap[i] );
+
+	// every corner still has the position it started with
+	array<int>^ welded = indices->ReadRange<int>( faceCount * 3 );
+	array<float>^ moved = vertices->ReadRange<float>( vertexCount * 3 );
+	for( int i = 0; i < faceCount * 3; i++ )
+	{
+		ASSERT_TRUE( welded[i] < count );
+		for( int axis = 0; axis < 3; axis++ )
+			ASSERT_EQ( positions[original[i] * 3 + axis], moved[welded[i] * 3 + axis] );
+	}
+}
+
+TEST( MeshTopologyTests, WeldsWithinEpsilon )
+{
+	DataStream^ indices;
+	DataStream^ vertices = TwoTriangles( 1.0f, 1.0f, indices );
+
+	// nudge the duplicate of vertex 1 along x
+	vertices->Position = 3 * 24;
+	vertices->Write( 1.0005f );
+	vertices->Position = 0;
+
+	array<int>^ vertexRemap;
+	ASSERT_EQ( 5, MeshTopology::WeldVertices( indices, false, 2, vertices, 6, 24, PositionNormal(), WeldFlags::None, WeldEpsilons(), vertexRemap ) );
+
+	vertices = TwoTriangles( 1.0f, 1.0f, indices );
+	vertices->Position = 3 * 24;
+	vertices->Write( 1.0005f );
+	vertices->Position = 0;
+
+	WeldEpsilons epsilons;
+	epsilons.Position = 0.001f;
+	ASSERT_EQ( 4, MeshTopology::WeldVertices( indices, false, 2, vertices, 6, 24, PositionNormal(), WeldFlags::None, epsilons, vertexRemap ) );
+
+	array<int>^ welded = indices->ReadRange<int>( 6 );
+	array<int>^ expected = { 0, 1, 2, 2, 1, 3 };
+	for( int i = 0; i < 6; i++ )
+		ASSERT_EQ( expected[i], welded[i] );
+}
+
+TEST( MeshTopologyTests, KeepsVerticesWithDifferentAttributes )
+{
+	DataStream^ indices;
+	DataStream^ vertices = TwoTriangles( 1.0f, -1.0f, indices );
+
+	array<int>^ vertexRemap;
+	ASSERT_EQ( 6, MeshTopology::WeldVertices( indices, false, 2, vertices, 6, 24, PositionNormal(), WeldFlags::None, WeldEpsilons(), vertexRemap ) );
+
+	vertices = TwoTriangles( 1.0f, -1.0f, indices );
+	ASSERT_EQ( 4, MeshTopology::WeldVertices( indices, false, 2, vertices, 6, 24, PositionNormal(), WeldFlags::WeldAll, WeldEpsilons(), vertexRemap ) );
+}
+
+TEST( MeshTopologyTests, WeldsPartialMatches )
+{
+	DataStream^ indices;
+	DataStream^ vertices = TwoTriangles( 1.0f, 0.99f, indices );
+
+	WeldEpsilons epsilons;
+	epsilons.Normal = 0.05f;
+
+	array<int>^ vertexRemap;
+	WeldFlags flags = WeldFlags::WeldPartialMatches | WeldFlags::DoNotRemoveVertices;
+	ASSERT_EQ( 6, MeshTopology::WeldVertices( indices, false, 2, vertices, 6, 24, PositionNormal(), flags, epsilons, vertexRemap ) );
+	for( int i = 0; i < 6; i++ )
+		ASSERT_EQ( i, vertexRemap[i] );
+
+	// the duplicates now carry the normal of the vertex they match, but the lone vertex keeps its own
+	array<float>^ data = vertices->ReadRange<float>( 36 );
+	ASSERT_EQ( 1.0f, data[3 * 6 + 5] );
+	ASSERT_EQ( 1.0f, data[4 * 6 + 5] );
+	ASSERT_EQ( 0.99f, data[5 * 6 + 5] );
+}
+
+TEST( MeshTopologyTests, GeneratesAdjacencyAcrossSplitVertices )
+{
+	DataStream^ indices;
+	DataStream^ vertices;
+	int faceCount;
+	int vertexCount;
+	SplitGrid( 2, indices, vertices, faceCount, vertexCount );
+
+	array<int>^ pointReps;
+	array<int>^ adjacency = MeshTopology::GenerateAdjacency( indices, false, faceCount, vertices, vertexCount, 12, 0, 0.0f, pointReps );
+	ASSERT_EQ( faceCount * 3, adjacency->Length );
+
+	// four diagonals and four edges between quads, each seen from both sides
+	int shared = 0;
+	for( int i = 0; i < adjacency->Length; i++ )
+	{
+		if( adjacency[i] < 0 )
+			continue;
+
+		shared++;
+		int neighbor = adjacency[i];
+		int face = i / 3;
+		ASSERT_TRUE( adjacency[neighbor * 3] == face || adjacency[neighbor * 3 + 1] == face || adjacency[neighbor * 3 + 2] == face );
+	}
+	ASSERT_EQ( 16, shared );
+
+	// the first quad's diagonal
+	ASSERT_EQ( 1, adjacency[1] );
+	ASSERT_EQ( 0, adjacency[5] );
+
+	array<int>^ converted = MeshTopology::ConvertAdjacencyToPointReps( indices, false, faceCount, vertexCount, adjacency );
+	for( int i = 0; i < vertexCount; i++ )
+		ASSERT_EQ( converted[i], pointReps[i] );
+
+	// the centre of the grid is the last corner of the first quad
+	ASSERT_EQ( 3, pointReps[3] );
+	ASSERT_EQ( 3, pointReps[6] );
+	ASSERT_EQ( 3, pointReps[9] );
+	ASSERT_EQ( 3, pointReps[12] );
+}
+
+// Builds point reps for a mesh of triangles over the given corners, both from positions and from adjacency alone.
+static void PointRepsBothWays( array<int>^ faces, array<float>^ corners, array<int>^ %generated, array<int>^ %converted )
+{
+	DataStream^ indices = gcnew DataStream( faces->Length * 4, true, true );
+	indices->WriteRange( faces );
+	indices->Position = 0;
+
+	DataStream^ vertices = gcnew DataStream( corners->Length * 4, true, true );
+	vertices->WriteRange( corners );
+	vertices->Position = 0;
+
+	int faceCount = faces->Length / 3;
+	int vertexCount = corners->Length / 3;
+	array<int>^ adjacency = MeshTopology::GenerateAdjacency( indices, false, faceCount, vertices, vertexCount, 12, 0, 0.0f, generated );
+
+	indices->Position = 0;
+	converted = MeshTopology::ConvertAdjacencyToPointReps( indices, false, faceCount, vertexCount, adjacency );
+}
+
+TEST( MeshTopologyTests, KeepsVerticesOfTwoSidedMeshes )
+{
+	array<float>^ square = { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 };
+	array<int>^ generated;
+	array<int>^ converted;
+
+	// a quad with a back face wound the other way
+	array<int>^ doubleSided = { 0, 1, 2, 0, 2, 3, 0, 2, 1, 0, 3, 2 };
+	PointRepsBothWays( doubleSided, square, generated, converted );
+	for( int i = 0; i < 4; i++ )
+	{
+		ASSERT_EQ( i, generated[i] );
+		ASSERT_EQ( i, converted[i] );
+	}
+
+	// a single triangle seen from both sides
+	array<int>^ pillow = { 0, 1, 2, 0, 2, 1 };
+	PointRepsBothWays( pillow, square, generated, converted );
+	for( int i = 0; i < 4; i++ )
+	{
+		ASSERT_EQ( i, generated[i] );
+		ASSERT_EQ( i, converted[i] );
+	}
+}
+
+TEST( MeshTopologyTests, KeepsVerticesOfInconsistentlyWoundMeshes )
+{
+	array<float>^ square = { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 };
+	array<int>^ generated;
+	array<int>^ converted;
+
+	// two faces that run along their shared edge in the same direction
+	array<int>^ sameWinding = { 0, 1, 2, 0, 1, 3 };
+	PointRepsBothWays( sameWinding, square, generated, converted );
+	for( int i = 0; i < 4; i++ )
+	{
+		ASSERT_EQ( i, generated[i] );
+		ASSERT_EQ( i, converted[i] );
+	}
+
+	// the same with the shared corners duplicated; positions tell the duplicates apart from the other corners
+	array<float>^ split = { 0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0 };
+	array<int>^ splitFaces = { 0, 1, 2, 3, 4, 5 };
+	PointRepsBothWays( splitFaces, split, generated, converted );
+	array<int>^ expected = { 0, 1, 2, 1, 2, 5 };
+	for( int i = 0; i < 6; i++ )
+		ASSERT_EQ( expected[i], generated[i] );
+}
+
+TEST( MeshTopologyTests, ValidatesArguments )
+{
+	DataStream^ indices;
+	DataStream^ vertices;
+	int faceCount;
+	int vertexCount;
+	SplitGrid( 1, indices, vertices, faceCount, vertexCount );
+
+	ASSERT_MANAGED_THROW( MeshTopology::GenerateAdjacency( indices, false, faceCount, vertices, vertexCount, 12, 0, -1.0f ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( MeshTopology::GenerateAdjacency( indices, false, faceCount, vertices, vertexCount, 12, 4, 0.0f ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( MeshTopology::GenerateAdjacency( indices, false, faceCount, vertices, vertexCount - 1, 12, 0, 0.0f ), ArgumentException );
+	ASSERT_MANAGED_THROW( MeshTopology::ConvertAdjacencyToPointReps( indices, false, faceCount, vertexCount, gcnew array<int>( 3 ) ), ArgumentException );
+
+	array<int>^ vertexRemap;
+	array<VertexElement>^ noPosition = { VertexElement::VertexDeclarationEnd };
+	ASSERT_MANAGED_THROW( MeshTopology::WeldVertices( indices, false, faceCount, vertices, vertexCount, 12, noPosition, WeldFlags::None, WeldEpsilons(), vertexRemap ), ArgumentException );
+	ASSERT_MANAGED_THROW( MeshTopology::WeldVertices( indices, false, faceCount, vertices, vertexCount, 12, PositionNormal(), WeldFlags::None, WeldEpsilons(), vertexRemap ), ArgumentException );
+}
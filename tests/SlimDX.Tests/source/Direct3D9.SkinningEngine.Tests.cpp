@@ -0,0 +1,167 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace SlimDX;
+using namespace SlimDX::Direct3D9;
+
+// position, normal, and a texture coordinate that skinning leaves alone
+const int SkinStride = 32;
+
+static array<VertexElement>^ SkinDeclaration()
+{
+	array<VertexElement>^ declaration = {
+		VertexElement( 0, 0, DeclarationType::Float3, DeclarationMethod::Default, DeclarationUsage::Position, 0 ),
+		VertexElement( 0, 12, DeclarationType::Float3, DeclarationMethod::Default, DeclarationUsage::Normal, 0 ),
+		VertexElement( 0, 24, DeclarationType::Float2, DeclarationMethod::Default, DeclarationUsage::TextureCoordinate, 0 ),
+		VertexElement::VertexDeclarationEnd
+	};
+	return declaration;
+}
+
+// Four vertices at (1, 0, 0) facing +x: the first follows bone 0, the second bone 1, the third both equally, and the
+// fourth neither.
+static SkinInfo^ CreateSkin()
+{
+	SkinInfo^ skin = gcnew SkinInfo( 4, SkinDeclaration(), 2 );
+	skin->SetBoneInfluence( 0, gcnew array<int> { 0, 2 }, gcnew array<float> { 1.0f, 0.5f } );
+	skin->SetBoneInfluence( 1, gcnew array<int> { 1, 2 }, gcnew array<float> { 1.0f, 0.5f } );
+	return skin;
+}
+
+static SkinningEngine^ CreateEngine( DataStream^ %vertices )
+{
+	SkinInfo^ skin = CreateSkin();
+	SkinningEngine^ engine = gcnew SkinningEngine( skin, 4 );
+	delete skin;
+
+	vertices = gcnew DataStream( 4 * SkinStride, true, true );
+	for( int i = 0; i < 4; i++ )
+	{
+		array<float>^ vertex = { 1, 0, 0, 1, 0, 0, 0.25f, static_cast<float>( i ) };
+		vertices->WriteRange( vertex );
+	}
+
+	vertices->Position = 0;
+	return engine;
+}
+
+static array<float>^ ReadVertex( DataStream^ vertices, int vertex )
+{
+	vertices->Position = vertex * SkinStride;
+	array<float>^ result = vertices->ReadRange<float>( SkinStride / 4 );
+	vertices->Position = 0;
+	return result;
+}
+
+static void AssertVector( float x, float y, float z, array<float>^ actual, int offset )
+{
+	ASSERT_NEAR( x, actual[offset], 1e-5f );
+	ASSERT_NEAR( y, actual[offset + 1], 1e-5f );
+	ASSERT_NEAR( z, actual[offset + 2], 1e-5f );
+}
+
+static array<Matrix>^ Bones()
+{
+	array<Matrix>^ bones = { Matrix::Translation( 0.0f, 0.0f, 2.0f ), Matrix::RotationZ( static_cast<float>( Math::PI / 2.0 ) ) };
+	return bones;
+}
+
+TEST( SkinningEngineTests, BuildsInfluenceLists )
+{
+	DataStream^ vertices;
+	SkinningEngine^ engine = CreateEngine( vertices );
+
+	ASSERT_EQ( 4, engine->VertexCount );
+	ASSERT_EQ( 2, engine->BoneCount );
+	ASSERT_EQ( SkinStride, engine->VertexStride );
+	ASSERT_EQ( 2, engine->MaximumVertexInfluences );
+}
+
+TEST( SkinningEngineTests, BlendsMatricesLinearly )
+{
+	DataStream^ vertices;
+	SkinningEngine^ engine = CreateEngine( vertices );
+	DataStream^ skinned = gcnew DataStream( 4 * SkinStride, true, true );
+
+	engine->UpdateSkinnedMesh( Bones(), nullptr, vertices, skinned );
+
+	array<float>^ vertex = ReadVertex( skinned, 0 );
+	AssertVector( 1.0f, 0.0f, 2.0f, vertex, 0 );
+	AssertVector( 1.0f, 0.0f, 0.0f, vertex, 3 );
+	ASSERT_EQ( 0.25f, vertex[6] );
+
+	vertex = ReadVertex( skinned, 1 );
+	AssertVector( 0.0f, 1.0f, 0.0f, vertex, 0 );
+	AssertVector( 0.0f, 1.0f, 0.0f, vertex, 3 );
+
+	// a linear blend of a quarter turn pulls the vertex in towards the axis
+	vertex = ReadVertex( skinned, 2 );
+	AssertVector( 0.5f, 0.5f, 1.0f, vertex, 0 );
+	AssertVector( 0.5f, 0.5f, 0.0f, vertex, 3 );
+
+	vertex = ReadVertex( skinned, 3 );
+	AssertVector( 1.0f, 0.0f, 0.0f, vertex, 0 );
+	ASSERT_EQ( 3.0f, vertex[7] );
+}
+
+TEST( SkinningEngineTests, BlendsDualQuaternions )
+{
+	DataStream^ vertices;
+	SkinningEngine^ engine = CreateEngine( vertices );
+
+	// skinning in place
+	engine->UpdateSkinnedMesh( Bones(), nullptr, vertices, vertices, SkinningMethod::DualQuaternion );
+
+	array<float>^ vertex = ReadVertex( vertices, 0 );
+	AssertVector( 1.0f, 0.0f, 2.0f, vertex, 0 );
+
+	vertex = ReadVertex( vertices, 1 );
+	AssertVector( 0.0f, 1.0f, 0.0f, vertex, 0 );
+
+	// the blend turns the vertex an eighth of the way round without shrinking it, and moves it half the translation
+	float half = static_cast<float>( Math::Sqrt( 0.5 ) );
+	vertex = ReadVertex( vertices, 2 );
+	AssertVector( half, half, 1.0f, vertex, 0 );
+	AssertVector( half, half, 0.0f, vertex, 3 );
+}
+
+TEST( SkinningEngineTests, ValidatesArguments )
+{
+	DataStream^ vertices;
+	SkinningEngine^ engine = CreateEngine( vertices );
+	DataStream^ small = gcnew DataStream( 3 * SkinStride, true, true );
+
+	ASSERT_MANAGED_THROW( engine->UpdateSkinnedMesh( gcnew array<Matrix>( 1 ), nullptr, vertices, vertices ), ArgumentException );
+	ASSERT_MANAGED_THROW( engine->UpdateSkinnedMesh( Bones(), gcnew array<Matrix>( 1 ), vertices, vertices ), ArgumentException );
+	ASSERT_MANAGED_THROW( engine->UpdateSkinnedMesh( Bones(), nullptr, vertices, small ), ArgumentException );
+	ASSERT_MANAGED_THROW( engine->UpdateSkinnedMesh( nullptr, nullptr, vertices, vertices ), ArgumentNullException );
+
+	// vertex 2 has influences but is past the end
+	SkinInfo^ skin = CreateSkin();
+	ASSERT_MANAGED_THROW( gcnew SkinningEngine( skin, 2 ), ArgumentException );
+	delete skin;
+}
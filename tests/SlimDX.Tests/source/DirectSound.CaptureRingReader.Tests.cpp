@@ -0,0 +1,247 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::Threading;
+using namespace SlimDX;
+using namespace SlimDX::Multimedia;
+using namespace SlimDX::DirectSound;
+
+// Stands in for a capture buffer: Capture writes at the capture cursor and signals the notification event.
+ref class FakeCaptureSource : ICaptureSource
+{
+public:
+	FakeCaptureSource( int size )
+	{
+		Data = gcnew array<Byte>( size );
+		AudioFormat = gcnew WaveFormat();
+		AudioFormat->FormatTag = WaveFormatTag::Pcm;
+		AudioFormat->Channels = 1;
+		AudioFormat->SamplesPerSecond = 8000;
+		AudioFormat->BitsPerSample = 16;
+		AudioFormat->BlockAlignment = 2;
+		AudioFormat->AverageBytesPerSecond = 16000;
+	}
+
+	property WaveFormat^ Format
+	{
+		virtual WaveFormat^ get() { return AudioFormat; }
+	}
+
+	property int SizeInBytes
+	{
+		virtual int get() { return Data->Length; }
+	}
+
+	property int CurrentReadPosition
+	{
+		virtual int get() { return Thread::VolatileRead( Position ); }
+	}
+
+	virtual Result SetNotificationPositions( array<NotificationPosition>^ positions )
+	{
+		Positions = positions;
+		return Result( 0 );
+	}
+
+	virtual Result Read( int bufferOffset, IntPtr destination, int count )
+	{
+		unsigned char *output = reinterpret_cast<unsigned char*>( destination.ToPointer() );
+		for( int i = 0; i < count; i++ )
+			output[i] = Data[( bufferOffset + i ) % Data->Length];
+		return Result( 0 );
+	}
+
+	void Capture( int count )
+	{
+		int position = Position;
+		for( int i = 0; i < count; i++ )
+		{
+			Data[position] = static_cast<Byte>( Captured++ % 251 );
+			position = ( position + 1 ) % Data->Length;
+		}
+
+		Thread::VolatileWrite( Position, position );
+		safe_cast<EventWaitHandle^>( Positions[0].Event )->Set();
+	}
+
+	array<Byte>^ Data;
+	WaveFormat^ AudioFormat;
+	array<NotificationPosition>^ Positions;
+	int Position;
+	int Captured;
+};
+
+static void WaitForCapture( CaptureRingReader^ reader, Int64 bytes )
+{
+	for( int i = 0; i < 2000 && reader->CapturedBytes + reader->DroppedBytes < bytes; i++ )
+		Thread::Sleep( 1 );
+}
+
+TEST( CaptureRingReaderTests, SetsNotificationAtEveryBlock )
+{
+	FakeCaptureSource^ source = gcnew FakeCaptureSource( 1024 );
+	CaptureRingReader^ reader = gcnew CaptureRingReader( source, 64, 4 );
+
+	ASSERT_EQ( 128, reader->BlockSize );
+	ASSERT_EQ( 8, source->Positions->Length );
+	ASSERT_EQ( 127, source->Positions[0].Offset );
+	ASSERT_EQ( 1023, source->Positions[7].Offset );
+
+	delete reader;
+}
+
+TEST( CaptureRingReaderTests, DeliversWholeBlocksAcrossTheBufferEnd )
+{
+	FakeCaptureSource^ source = gcnew FakeCaptureSource( 1024 );
+	CaptureRingReader^ reader = gcnew CaptureRingReader( source, 64, 8 );
+	array<short>^ block = gcnew array<short>( 64 );
+	int expected = 0;
+
+	for( int pass = 0; pass < 6; pass++ )
+	{
+		source->Capture( 300 );
+		while( reader->ReadBlock( block, expected + 128 <= source->Captured ? 2000 : 0 ) )
+		{
+			pin_ptr<short> pinnedBlock = &block[0];
+			unsigned char *bytes = reinterpret_cast<unsigned char*>( pinnedBlock );
+			for( int i = 0; i < 128; i++ )
+				ASSERT_EQ( ( expected + i ) % 251, bytes[i] );
+			expected += 128;
+		}
+	}
+
+	// 1800 bytes were captured, so the last 8 are waiting for the rest of their block
+	ASSERT_EQ( 1792, expected );
+	ASSERT_EQ( 14, reader->BlocksDelivered );
+	ASSERT_EQ( 0, reader->OverrunCount );
+	ASSERT_FALSE( reader->TryReadBlock( block ) );
+
+	delete reader;
+}
+
+TEST( CaptureRingReaderTests, DropsAudioWhenTheRingIsFull )
+{
+	FakeCaptureSource^ source = gcnew FakeCaptureSource( 1024 );
+	CaptureRingReader^ reader = gcnew CaptureRingReader( source, 64, 2 );
+
+	source->Capture( 512 );
+	WaitForCapture( reader, 512 );
+
+	ASSERT_EQ( 256, reader->CapturedBytes );
+	ASSERT_EQ( 256, reader->DroppedBytes );
+	ASSERT_EQ( 1, reader->OverrunCount );
+	ASSERT_EQ( 2, reader->AvailableBlocks );
+
+	// the oldest audio is kept
+	array<Byte>^ block = gcnew array<Byte>( 128 );
+	ASSERT_TRUE( reader->TryReadBlock( block ) );
+	ASSERT_EQ( 0, block[0] );
+
+	reader->ResetStatistics();
+	ASSERT_EQ( 0, reader->OverrunCount );
+	ASSERT_EQ( 0, reader->DroppedBytes );
+
+	delete reader;
+}
+
+TEST( CaptureRingReaderTests, MeasuresLatency )
+{
+	FakeCaptureSource^ source = gcnew FakeCaptureSource( 1024 );
+	CaptureRingReader^ reader = gcnew CaptureRingReader( source, 32, 8 );
+	array<Byte>^ block = gcnew array<Byte>( 64 );
+
+	source->Capture( 128 );
+	ASSERT_TRUE( reader->ReadBlock( block, 2000 ) );
+	Thread::Sleep( 20 );
+	ASSERT_TRUE( reader->ReadBlock( block, 2000 ) );
+
+	ASSERT_EQ( 2, reader->BlocksDelivered );
+	ASSERT_TRUE( reader->LastLatency.TotalMilliseconds >= 15 );
+	ASSERT_TRUE( reader->MaximumLatency >= reader->AverageLatency );
+	ASSERT_TRUE( reader->AverageLatency > TimeSpan::Zero );
+
+	delete reader;
+}
+
+TEST( CaptureRingReaderTests, ValidatesArguments )
+{
+	FakeCaptureSource^ source = gcnew FakeCaptureSource( 256 );
+
+	ASSERT_MANAGED_THROW( gcnew CaptureRingReader( nullptr, 64, 4 ), ArgumentNullException );
+	ASSERT_MANAGED_THROW( gcnew CaptureRingReader( source, 256, 4 ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( gcnew CaptureRingReader( source, 64, 1 ), ArgumentOutOfRangeException );
+
+	CaptureRingReader^ reader = gcnew CaptureRingReader( source, 64, 4 );
+	ASSERT_MANAGED_THROW( reader->TryReadBlock( gcnew array<Byte>( 64 ) ), ArgumentException );
+
+	delete reader;
+	ASSERT_MANAGED_THROW( reader->TryReadBlock( gcnew array<Byte>( 128 ) ), ObjectDisposedException );
+}
+
+// Waits for a block on its own thread and records how the wait ended.
+ref class BlockedConsumer
+{
+public:
+	BlockedConsumer( CaptureRingReader^ reader )
+	{
+		Reader = reader;
+		Started = gcnew ManualResetEvent( false );
+	}
+
+	void Run()
+	{
+		try
+		{
+			Started->Set();
+			Reader->ReadBlock( gcnew array<Byte>( Reader->BlockSize ), Timeout::Infinite );
+		}
+		catch( Exception^ e )
+		{
+			Error = e;
+		}
+	}
+
+	CaptureRingReader^ Reader;
+	ManualResetEvent^ Started;
+	Exception^ Error;
+};
+
+TEST( CaptureRingReaderTests, ReleasesBlockedConsumerOnDispose )
+{
+	FakeCaptureSource^ source = gcnew FakeCaptureSource( 1024 );
+	CaptureRingReader^ reader = gcnew CaptureRingReader( source, 64, 4 );
+
+	BlockedConsumer^ consumer = gcnew BlockedConsumer( reader );
+	Thread^ thread = gcnew Thread( gcnew ThreadStart( consumer, &BlockedConsumer::Run ) );
+	thread->Start();
+	consumer->Started->WaitOne();
+	Thread::Sleep( 50 );
+
+	delete reader;
+	ASSERT_TRUE( thread->Join( 2000 ) );
+	ASSERT_TRUE( dynamic_cast<ObjectDisposedException^>( consumer->Error ) != nullptr );
+}
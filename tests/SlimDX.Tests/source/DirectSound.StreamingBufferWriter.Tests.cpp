@@ -0,0 +1,292 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <dsound.h>
+
+#include "IDirectSoundBuffer8Mock.h"
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace SlimDX;
+using namespace SlimDX::DirectSound;
+
+// Backs a mocked buffer with real memory; the cursors are moved by hand to simulate playback.
+// The format is 16-bit mono at 8000 Hz, so one millisecond is 16 bytes, unless more channels are asked for.
+class FakeBufferMemory
+{
+public:
+	static const DWORD Size = 1000;
+
+	FakeBufferMemory( IDirectSoundBuffer8Mock &mock )
+	: Play( 0 ), Write( 0 ), LockCount( 0 ), UnlockedBytes( 0 ), Channels( 1 )
+	{
+		memset( Data, 0xCD, Size );
+
+		ON_CALL( mock, GetCaps( _ ) ).WillByDefault( Invoke( this, &FakeBufferMemory::GetCaps ) );
+		ON_CALL( mock, GetFormat( _, _, _ ) ).WillByDefault( Invoke( this, &FakeBufferMemory::GetFormat ) );
+		ON_CALL( mock, GetCurrentPosition( _, _ ) ).WillByDefault( Invoke( this, &FakeBufferMemory::GetCurrentPosition ) );
+		ON_CALL( mock, Lock( _, _, _, _, _, _, _ ) ).WillByDefault( Invoke( this, &FakeBufferMemory::Lock ) );
+		ON_CALL( mock, Unlock( _, _, _, _ ) ).WillByDefault( Invoke( this, &FakeBufferMemory::Unlock ) );
+	}
+
+	HRESULT GetCaps( LPDSBCAPS caps )
+	{
+		caps->dwBufferBytes = Size;
+		return S_OK;
+	}
+
+	HRESULT GetFormat( LPWAVEFORMATEX format, DWORD, LPDWORD written )
+	{
+		if( written != NULL )
+			*written = sizeof( WAVEFORMATEX );
+
+		if( format != NULL )
+		{
+			format->wFormatTag = WAVE_FORMAT_PCM;
+			format->nChannels = Channels;
+			format->nSamplesPerSec = 8000;
+			format->wBitsPerSample = 16;
+			format->nBlockAlign = static_cast<WORD>( Channels * 2 );
+			format->nAvgBytesPerSec = 16000 * Channels;
+			format->cbSize = 0;
+		}
+
+		return S_OK;
+	}
+
+	HRESULT GetCurrentPosition( LPDWORD play, LPDWORD write )
+	{
+		*play = Play;
+		*write = Write;
+		return S_OK;
+	}
+
+	HRESULT Lock( DWORD offset, DWORD bytes, LPVOID *first, LPDWORD firstSize, LPVOID *second, LPDWORD secondSize, DWORD )
+	{
+		LockCount++;
+		*first = Data + offset;
+		*firstSize = bytes < Size - offset ? bytes : Size - offset;
+		*second = bytes > *firstSize ? Data : NULL;
+		*secondSize = bytes - *firstSize;
+		return S_OK;
+	}
+
+	HRESULT Unlock( LPVOID, DWORD firstSize, LPVOID, DWORD secondSize )
+	{
+		UnlockedBytes += firstSize + secondSize;
+		return S_OK;
+	}
+
+	unsigned char Data[Size];
+	DWORD Play;
+	DWORD Write;
+	int LockCount;
+	DWORD UnlockedBytes;
+	WORD Channels;
+};
+
+ref class CountingFill
+{
+public:
+	int Fill( DataStream^ destination )
+	{
+		Calls++;
+		int count = static_cast<int>( destination->Length );
+		for( int i = 0; i < count; i++ )
+			destination->WriteByte( static_cast<Byte>( Next++ ) );
+		return count;
+	}
+
+	int Calls;
+	int Next;
+};
+
+static array<Byte>^ Sequence( int length, int start )
+{
+	array<Byte>^ result = gcnew array<Byte>( length );
+	for( int i = 0; i < length; i++ )
+		result[i] = static_cast<Byte>( start + i );
+	return result;
+}
+
+TEST( StreamingBufferWriterTests, PrimesUpToTheTargetLatency )
+{
+	NiceMock<IDirectSoundBuffer8Mock> mockBuffer;
+	FakeBufferMemory memory( mockBuffer );
+	SecondarySoundBuffer^ buffer = SecondarySoundBuffer::FromPointer( IntPtr( &mockBuffer ) );
+
+	StreamingBufferWriter^ writer = gcnew StreamingBufferWriter( buffer, 25 );
+	ASSERT_EQ( 400, writer->TargetLatency );
+	ASSERT_EQ( 400, writer->WritableBytes );
+
+	array<short>^ samples = gcnew array<short>( 300 );
+	for( int i = 0; i < samples->Length; i++ )
+		samples[i] = static_cast<short>( i );
+
+	ASSERT_EQ( 200, writer->Write( samples, 0, 0 ) );
+	ASSERT_EQ( 400, writer->WritePosition );
+	ASSERT_EQ( 400, writer->QueuedBytes );
+	ASSERT_EQ( 0, writer->WritableBytes );
+	ASSERT_EQ( 0, writer->Write( samples, 200, 0 ) );
+	ASSERT_EQ( 400, writer->TotalBytesWritten );
+
+	short *written = reinterpret_cast<short*>( memory.Data );
+	ASSERT_EQ( 0, written[0] );
+	ASSERT_EQ( 199, written[199] );
+	ASSERT_EQ( 0xCD, memory.Data[400] );
+
+	delete buffer;
+}
+
+TEST( StreamingBufferWriterTests, WritesAcrossTheEndOfTheBuffer )
+{
+	NiceMock<IDirectSoundBuffer8Mock> mockBuffer;
+	FakeBufferMemory memory( mockBuffer );
+	SecondarySoundBuffer^ buffer = SecondarySoundBuffer::FromPointer( IntPtr( &mockBuffer ) );
+	StreamingBufferWriter^ writer = gcnew StreamingBufferWriter( buffer, 25 );
+
+	ASSERT_EQ( 400, writer->Write( Sequence( 400, 0 ), 0, 0 ) );
+
+	memory.Play = 350;
+	memory.Write = 370;
+	ASSERT_EQ( 350, writer->Write( Sequence( 1000, 400 ), 0, 0 ) );
+	ASSERT_EQ( 750, writer->WritePosition );
+
+	memory.Play = 700;
+	memory.Write = 720;
+	ASSERT_EQ( 350, writer->Write( Sequence( 350, 750 ), 0, 0 ) );
+	ASSERT_EQ( 100, writer->WritePosition );
+	ASSERT_EQ( 3, memory.LockCount );
+	ASSERT_EQ( 1100, memory.UnlockedBytes );
+
+	for( int i = 0; i < 1000; i++ )
+		ASSERT_EQ( static_cast<Byte>( i < 100 ? i + 1000 : i ), memory.Data[i] );
+
+	ASSERT_EQ( 0, writer->UnderrunCount );
+	delete buffer;
+}
+
+TEST( StreamingBufferWriterTests, FillsBothRegionsFromTheCallback )
+{
+	NiceMock<IDirectSoundBuffer8Mock> mockBuffer;
+	FakeBufferMemory memory( mockBuffer );
+	SecondarySoundBuffer^ buffer = SecondarySoundBuffer::FromPointer( IntPtr( &mockBuffer ) );
+	StreamingBufferWriter^ writer = gcnew StreamingBufferWriter( buffer, 25 );
+	CountingFill^ source = gcnew CountingFill();
+	BufferFillCallback^ callback = gcnew BufferFillCallback( source, &CountingFill::Fill );
+
+	memory.Play = memory.Write = 800;
+	ASSERT_EQ( 400, writer->Fill( callback ) );
+	ASSERT_EQ( 2, source->Calls );
+	ASSERT_EQ( 200, writer->WritePosition );
+	ASSERT_EQ( 0, memory.Data[800] );
+	ASSERT_EQ( 199, memory.Data[999] );
+	ASSERT_EQ( 200, memory.Data[0] );
+	ASSERT_EQ( 0xCD, memory.Data[200] );
+
+	// nothing to do until the play cursor moves
+	ASSERT_EQ( 0, writer->Fill( callback ) );
+	ASSERT_EQ( 2, source->Calls );
+
+	memory.Play = 100;
+	memory.Write = 100;
+	ASSERT_EQ( 300, writer->WriteSilence() );
+	ASSERT_EQ( 0, memory.Data[200] );
+	ASSERT_EQ( 0, memory.Data[499] );
+	ASSERT_EQ( 0xCD, memory.Data[500] );
+
+	delete buffer;
+}
+
+TEST( StreamingBufferWriterTests, ResynchronizesAfterAnUnderrun )
+{
+	NiceMock<IDirectSoundBuffer8Mock> mockBuffer;
+	FakeBufferMemory memory( mockBuffer );
+	SecondarySoundBuffer^ buffer = SecondarySoundBuffer::FromPointer( IntPtr( &mockBuffer ) );
+	StreamingBufferWriter^ writer = gcnew StreamingBufferWriter( buffer, 25 );
+
+	ASSERT_EQ( 400, writer->WriteSilence() );
+
+	// the play cursor went past everything that was written
+	memory.Play = 450;
+	memory.Write = 470;
+	ASSERT_EQ( 20, writer->QueuedBytes );
+	ASSERT_EQ( 1, writer->UnderrunCount );
+	ASSERT_EQ( 470, writer->WritePosition );
+	ASSERT_EQ( 380, writer->WritableBytes );
+
+	writer->Reset();
+	memory.Play = memory.Write = 10;
+	ASSERT_EQ( 400, writer->WritableBytes );
+	ASSERT_EQ( 10, writer->WritePosition );
+	ASSERT_EQ( 1, writer->UnderrunCount );
+
+	delete buffer;
+}
+
+TEST( StreamingBufferWriterTests, WritesWholeFramesOfWholeElements )
+{
+	NiceMock<IDirectSoundBuffer8Mock> mockBuffer;
+	FakeBufferMemory memory( mockBuffer );
+	memory.Channels = 3;
+	SecondarySoundBuffer^ buffer = SecondarySoundBuffer::FromPointer( IntPtr( &mockBuffer ) );
+
+	// six-byte frames written as four-byte elements only line up every twelve bytes
+	StreamingBufferWriter^ writer = gcnew StreamingBufferWriter( buffer, 10 );
+	ASSERT_EQ( 480, writer->TargetLatency );
+
+	array<float>^ samples = gcnew array<float>( 5 );
+	ASSERT_EQ( 3, writer->Write( samples, 0, 0 ) );
+	ASSERT_EQ( 12, writer->WritePosition );
+
+	array<float>^ more = gcnew array<float>( 200 );
+	ASSERT_EQ( 117, writer->Write( more, 0, 0 ) );
+	ASSERT_EQ( 480, writer->WritePosition );
+
+	delete buffer;
+}
+
+TEST( StreamingBufferWriterTests, ValidatesArguments )
+{
+	NiceMock<IDirectSoundBuffer8Mock> mockBuffer;
+	FakeBufferMemory memory( mockBuffer );
+	SecondarySoundBuffer^ buffer = SecondarySoundBuffer::FromPointer( IntPtr( &mockBuffer ) );
+
+	ASSERT_MANAGED_THROW( gcnew StreamingBufferWriter( nullptr, 25 ), ArgumentNullException );
+	ASSERT_MANAGED_THROW( gcnew StreamingBufferWriter( buffer, 0 ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( gcnew StreamingBufferWriter( buffer, 100 ), ArgumentOutOfRangeException );
+
+	StreamingBufferWriter^ writer = gcnew StreamingBufferWriter( buffer, 25 );
+	ASSERT_MANAGED_THROW( writer->TargetLatency = 1, ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( writer->TargetLatency = 1000, ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( writer->Write<Byte>( nullptr, 0, 0 ), ArgumentNullException );
+	ASSERT_MANAGED_THROW( writer->Write( IntPtr::Zero, 16 ), ArgumentNullException );
+	ASSERT_MANAGED_THROW( writer->Fill( nullptr ), ArgumentNullException );
+
+	writer->TargetLatency = 101;
+	ASSERT_EQ( 100, writer->TargetLatency );
+
+	delete buffer;
+}
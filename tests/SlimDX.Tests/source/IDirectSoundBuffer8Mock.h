@@ -0,0 +1,51 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "CommonMocks.h"
+
+struct IDirectSoundBuffer8Mock : IDirectSoundBuffer8 {
+	MOCK_IUNKNOWN;
+
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetCaps, HRESULT( LPDSBCAPS ) );
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, GetCurrentPosition, HRESULT( LPDWORD, LPDWORD ) );
+	MOCK_METHOD3_WITH_CALLTYPE( STDMETHODCALLTYPE, GetFormat, HRESULT( LPWAVEFORMATEX, DWORD, LPDWORD ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetVolume, HRESULT( LPLONG ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetPan, HRESULT( LPLONG ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetFrequency, HRESULT( LPDWORD ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetStatus, HRESULT( LPDWORD ) );
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, Initialize, HRESULT( LPDIRECTSOUND, LPCDSBUFFERDESC ) );
+	MOCK_METHOD7_WITH_CALLTYPE( STDMETHODCALLTYPE, Lock, HRESULT( DWORD, DWORD, LPVOID*, LPDWORD, LPVOID*, LPDWORD, DWORD ) );
+	MOCK_METHOD3_WITH_CALLTYPE( STDMETHODCALLTYPE, Play, HRESULT( DWORD, DWORD, DWORD ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, SetCurrentPosition, HRESULT( DWORD ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, SetFormat, HRESULT( LPCWAVEFORMATEX ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, SetVolume, HRESULT( LONG ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, SetPan, HRESULT( LONG ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, SetFrequency, HRESULT( DWORD ) );
+	MOCK_METHOD0_WITH_CALLTYPE( STDMETHODCALLTYPE, Stop, HRESULT() );
+	MOCK_METHOD4_WITH_CALLTYPE( STDMETHODCALLTYPE, Unlock, HRESULT( LPVOID, DWORD, LPVOID, DWORD ) );
+	MOCK_METHOD0_WITH_CALLTYPE( STDMETHODCALLTYPE, Restore, HRESULT() );
+
+	MOCK_METHOD3_WITH_CALLTYPE( STDMETHODCALLTYPE, SetFX, HRESULT( DWORD, LPDSEFFECTDESC, LPDWORD ) );
+	MOCK_METHOD3_WITH_CALLTYPE( STDMETHODCALLTYPE, AcquireResources, HRESULT( DWORD, DWORD, LPDWORD ) );
+	MOCK_METHOD4_WITH_CALLTYPE( STDMETHODCALLTYPE, GetObjectInPath, HRESULT( REFGUID, DWORD, REFGUID, LPVOID* ) );
+};
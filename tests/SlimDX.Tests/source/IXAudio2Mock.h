@@ -0,0 +1,42 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#include "CommonMocks.h"
+
+struct IXAudio2Mock : IXAudio2 {
+	MOCK_IUNKNOWN;
+
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetDeviceCount, HRESULT( UINT32* ) );
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, GetDeviceDetails, HRESULT( UINT32, XAUDIO2_DEVICE_DETAILS* ) );
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, Initialize, HRESULT( UINT32, XAUDIO2_PROCESSOR ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, RegisterForCallbacks, HRESULT( IXAudio2EngineCallback* ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, UnregisterForCallbacks, void( IXAudio2EngineCallback* ) );
+	MOCK_METHOD7_WITH_CALLTYPE( STDMETHODCALLTYPE, CreateSourceVoice, HRESULT( IXAudio2SourceVoice**, const WAVEFORMATEX*, UINT32, float, IXAudio2VoiceCallback*, const XAUDIO2_VOICE_SENDS*, const XAUDIO2_EFFECT_CHAIN* ) );
+	MOCK_METHOD7_WITH_CALLTYPE( STDMETHODCALLTYPE, CreateSubmixVoice, HRESULT( IXAudio2SubmixVoice**, UINT32, UINT32, UINT32, UINT32, const XAUDIO2_VOICE_SENDS*, const XAUDIO2_EFFECT_CHAIN* ) );
+	MOCK_METHOD6_WITH_CALLTYPE( STDMETHODCALLTYPE, CreateMasteringVoice, HRESULT( IXAudio2MasteringVoice**, UINT32, UINT32, UINT32, UINT32, const XAUDIO2_EFFECT_CHAIN* ) );
+	MOCK_METHOD0_WITH_CALLTYPE( STDMETHODCALLTYPE, StartEngine, HRESULT() );
+	MOCK_METHOD0_WITH_CALLTYPE( STDMETHODCALLTYPE, StopEngine, void() );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, CommitChanges, HRESULT( UINT32 ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetPerformanceData, void( XAUDIO2_PERFORMANCE_DATA* ) );
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, SetDebugConfiguration, void( const XAUDIO2_DEBUG_CONFIGURATION*, void* ) );
+};
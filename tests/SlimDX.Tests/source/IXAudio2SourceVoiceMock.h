@@ -0,0 +1,59 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#pragma once
+
+#define MOCK_IXAUDIO2VOICE \
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetVoiceDetails, void( XAUDIO2_VOICE_DETAILS* ) ); \
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, SetOutputVoices, HRESULT( const XAUDIO2_VOICE_SENDS* ) ); \
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, SetEffectChain, HRESULT( const XAUDIO2_EFFECT_CHAIN* ) ); \
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, EnableEffect, HRESULT( UINT32, UINT32 ) ); \
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, DisableEffect, HRESULT( UINT32, UINT32 ) ); \
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, GetEffectState, void( UINT32, BOOL* ) ); \
+	MOCK_METHOD4_WITH_CALLTYPE( STDMETHODCALLTYPE, SetEffectParameters, HRESULT( UINT32, const void*, UINT32, UINT32 ) ); \
+	MOCK_METHOD3_WITH_CALLTYPE( STDMETHODCALLTYPE, GetEffectParameters, HRESULT( UINT32, void*, UINT32 ) ); \
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, SetFilterParameters, HRESULT( const XAUDIO2_FILTER_PARAMETERS*, UINT32 ) ); \
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetFilterParameters, void( XAUDIO2_FILTER_PARAMETERS* ) ); \
+	MOCK_METHOD3_WITH_CALLTYPE( STDMETHODCALLTYPE, SetOutputFilterParameters, HRESULT( IXAudio2Voice*, const XAUDIO2_FILTER_PARAMETERS*, UINT32 ) ); \
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, GetOutputFilterParameters, void( IXAudio2Voice*, XAUDIO2_FILTER_PARAMETERS* ) ); \
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, SetVolume, HRESULT( float, UINT32 ) ); \
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetVolume, void( float* ) ); \
+	MOCK_METHOD3_WITH_CALLTYPE( STDMETHODCALLTYPE, SetChannelVolumes, HRESULT( UINT32, const float*, UINT32 ) ); \
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, GetChannelVolumes, void( UINT32, float* ) ); \
+	MOCK_METHOD5_WITH_CALLTYPE( STDMETHODCALLTYPE, SetOutputMatrix, HRESULT( IXAudio2Voice*, UINT32, UINT32, const float*, UINT32 ) ); \
+	MOCK_METHOD4_WITH_CALLTYPE( STDMETHODCALLTYPE, GetOutputMatrix, void( IXAudio2Voice*, UINT32, UINT32, float* ) ); \
+	MOCK_METHOD0_WITH_CALLTYPE( STDMETHODCALLTYPE, DestroyVoice, void() )
+
+// Voices are not COM objects, so there is no IUnknown to mock.
+struct IXAudio2SourceVoiceMock : IXAudio2SourceVoice {
+	MOCK_IXAUDIO2VOICE;
+
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, Start, HRESULT( UINT32, UINT32 ) );
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, Stop, HRESULT( UINT32, UINT32 ) );
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, SubmitSourceBuffer, HRESULT( const XAUDIO2_BUFFER*, const XAUDIO2_BUFFER_WMA* ) );
+	MOCK_METHOD0_WITH_CALLTYPE( STDMETHODCALLTYPE, FlushSourceBuffers, HRESULT() );
+	MOCK_METHOD0_WITH_CALLTYPE( STDMETHODCALLTYPE, Discontinuity, HRESULT() );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, ExitLoop, HRESULT( UINT32 ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetState, void( XAUDIO2_VOICE_STATE* ) );
+	MOCK_METHOD2_WITH_CALLTYPE( STDMETHODCALLTYPE, SetFrequencyRatio, HRESULT( float, UINT32 ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, GetFrequencyRatio, void( float* ) );
+	MOCK_METHOD1_WITH_CALLTYPE( STDMETHODCALLTYPE, SetSourceSampleRate, HRESULT( UINT32 ) );
+};
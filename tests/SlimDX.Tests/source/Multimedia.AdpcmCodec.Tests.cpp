@@ -0,0 +1,208 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::IO;
+using namespace SlimDX;
+using namespace SlimDX::Multimedia;
+
+// The expected samples were produced by independent reference decoders: the IMA block was encoded and
+// decoded with Python's audioop, and the MS blocks decoded with a transcription of the Microsoft reference.
+
+static const unsigned char ImaMonoBlock[] =
+{
+	0, 0, 30, 0, 119, 119, 6, 0, 136, 169, 170, 187,
+	172, 170, 138, 16, 67, 53, 68, 51, 50, 34, 0, 186,
+	205, 188, 173, 187, 171, 154, 0, 66, 68, 67, 67, 34
+};
+
+static const short ImaMonoExpected[] =
+{
+	0, 243, 764, 1884, 4287, 8753, 9361, 9914, 10417, 9960, 9545, 8411,
+	6694, 5133, 3713, 1906, 264, -1656, -2947, -4120, -5186, -6156, -6332, -6172,
+	-5736, -4809, -3726, -2124, -632, 1114, 3226, 5214, 7021, 8194, 9686, 10656,
+	11537, 11697, 11842, 11180, 10339, 9135, 7693, 5947, 4305, 1959, 398, -1590,
+	-3397, -5039, -6105, -7075, -7603, -7443, -7298, -6636, -5553, -4242, -2655, -1163,
+	583, 2225, 4145, 5436, 6609
+};
+
+static const unsigned char MsMonoBlock[] =
+{
+	5, 40, 0, 176, 4, 76, 4, 33, 62, 0, 223, 2,
+	240, 241, 0, 51, 1, 15, 48, 223, 1, 238, 240, 255,
+	48, 16, 253, 18, 49, 240, 242, 253
+};
+
+static const short MsMonoExpected[] =
+{
+	1100, 1200, 1342, 1471, 1645, 1706, 1728, 1718, 1629, 1515, 1398, 1313,
+	1207, 1102, 983, 886, 793, 705, 670, 679, 675, 677, 668, 634,
+	644, 642, 582, 508, 439, 392, 315, 215, 114, 30, -55, -140,
+	-159, -172, -164, -155, -162, -214, -237, -220, -155, -84, -41, -6,
+	6, 47, 63, 27
+};
+
+static const unsigned char MsStereoBlock[] =
+{
+	1, 6, 44, 1, 20, 0, 12, 254, 32, 3, 248, 253,
+	188, 2, 225, 15, 254, 18, 15, 224, 240, 241, 62, 243,
+	210, 63, 50, 33
+};
+
+static const short MsStereoExpected[] =
+{
+	-520, 700, -500, 800, -1080, 610, -1660, 192, -2481, -291, -3086, -588,
+	-3691, -653, -4644, -468, -5753, -125, -7002, 248, -7876, 461, -8862, 529,
+	-10148, 424, -11167, 153, -11949, -118, -12591, -304
+};
+
+template<typename T, int N>
+static array<T>^ ToArray( const T (&values)[N] )
+{
+	array<T>^ result = gcnew array<T>( N );
+	for( int i = 0; i < N; i++ )
+		result[i] = values[i];
+	return result;
+}
+
+template<int N>
+static void AssertDecodes( WaveFormat^ format, const unsigned char (&block)[N], array<short>^ expected )
+{
+	DataStream^ source = gcnew DataStream( ToArray( block ), true, false );
+	DataStream^ decoded = AdpcmCodec::Decode( format, source, WaveFormatTag::Pcm );
+	ASSERT_EQ( expected->Length * 2, decoded->Length );
+	ASSERT_EQ( N, source->Position );
+
+	array<short>^ samples = decoded->ReadRange<short>( expected->Length );
+	for( int i = 0; i < expected->Length; i++ )
+		ASSERT_EQ( expected[i], samples[i] );
+}
+
+static array<short>^ TestSignal( int frames, int channels )
+{
+	array<short>^ samples = gcnew array<short>( frames * channels );
+	for( int i = 0; i < frames; i++ )
+	{
+		for( int c = 0; c < channels; c++ )
+			samples[i * channels + c] = static_cast<short>( 12000 * Math::Sin( i * (0.06 + 0.03 * c) ) + 2000 * Math::Sin( i * 0.37 ) );
+	}
+	return samples;
+}
+
+static double SignalToNoise( array<short>^ expected, array<short>^ actual )
+{
+	double signal = 0;
+	double noise = 0;
+	for( int i = 0; i < expected->Length; i++ )
+	{
+		signal += static_cast<double>( expected[i] ) * expected[i];
+		noise += static_cast<double>( expected[i] - actual[i] ) * (expected[i] - actual[i]);
+	}
+	return 10 * Math::Log10( signal / noise );
+}
+
+TEST( AdpcmCodecTests, DecodesImaReferenceBlock )
+{
+	WaveFormat^ format = AdpcmCodec::CreateImaFormat( 44100, 1, 36 );
+	ASSERT_TRUE( format->FormatTag == WaveFormatTag::ImaAdpcm );
+	ASSERT_EQ( 65, AdpcmCodec::GetSamplesPerBlock( format ) );
+
+	AssertDecodes( format, ImaMonoBlock, ToArray( ImaMonoExpected ) );
+
+	// a trailing partial block decodes as far as its whole four byte groups go
+	ASSERT_EQ( (65 + 17) * 2, AdpcmCodec::GetDecodedSize( format, 36 + 14, WaveFormatTag::Pcm ) );
+}
+
+TEST( AdpcmCodecTests, DecodesMsReferenceBlocks )
+{
+	AdpcmWaveFormat^ mono = AdpcmCodec::CreateFormat( 44100, 1, 32 );
+	ASSERT_EQ( 52, mono->SamplesPerBlock );
+	ASSERT_EQ( 7, mono->Coefficients->Length );
+	AssertDecodes( mono, MsMonoBlock, ToArray( MsMonoExpected ) );
+
+	AdpcmWaveFormat^ stereo = AdpcmCodec::CreateFormat( 44100, 2, 28 );
+	ASSERT_EQ( 16, stereo->SamplesPerBlock );
+	AssertDecodes( stereo, MsStereoBlock, ToArray( MsStereoExpected ) );
+}
+
+TEST( AdpcmCodecTests, FloatOutputMatchesPcm )
+{
+	WaveFormat^ format = AdpcmCodec::CreateImaFormat( 44100, 1, 36 );
+	DataStream^ decoded = AdpcmCodec::Decode( format, gcnew DataStream( ToArray( ImaMonoBlock ), true, false ), WaveFormatTag::IeeeFloat );
+	ASSERT_EQ( 65 * 4, decoded->Length );
+
+	array<float>^ samples = decoded->ReadRange<float>( 65 );
+	for( int i = 0; i < 65; i++ )
+		ASSERT_EQ( ImaMonoExpected[i] / 32768.0f, samples[i] );
+
+	WaveFormat^ output = AdpcmCodec::GetDecodedFormat( format, WaveFormatTag::IeeeFloat );
+	ASSERT_EQ( 32, output->BitsPerSample );
+	ASSERT_EQ( 4, output->BlockAlignment );
+}
+
+TEST( AdpcmCodecTests, RejectsUnknownPredictors )
+{
+	array<Byte>^ block = ToArray( MsMonoBlock );
+	block[0] = 7;
+	ASSERT_MANAGED_THROW( AdpcmCodec::Decode( AdpcmCodec::CreateFormat( 44100, 1, 32 ), gcnew DataStream( block, true, false ), WaveFormatTag::Pcm ), InvalidDataException );
+
+	// only the predictors in the format's own table are valid
+	AdpcmWaveFormat^ format = AdpcmCodec::CreateFormat( 44100, 1, 32 );
+	format->Coefficients = gcnew array<int> { format->Coefficients[0], format->Coefficients[1] };
+	block[0] = 1;
+	AdpcmCodec::Decode( format, gcnew DataStream( block, true, false ), WaveFormatTag::Pcm );
+	block[0] = 5;
+	ASSERT_MANAGED_THROW( AdpcmCodec::Decode( format, gcnew DataStream( block, true, false ), WaveFormatTag::Pcm ), InvalidDataException );
+
+	ASSERT_MANAGED_THROW( AdpcmCodec::GetSamplesPerBlock( AdpcmCodec::GetDecodedFormat( format, WaveFormatTag::Pcm ) ), ArgumentException );
+}
+
+TEST( AdpcmCodecTests, RoundTripsAcrossManyBlocks )
+{
+	const int frames = 100000;
+	array<short>^ input = TestSignal( frames, 2 );
+
+	array<WaveFormat^>^ formats = { AdpcmCodec::CreateFormat( 44100, 2, 1024 ), AdpcmCodec::CreateImaFormat( 44100, 2, 1024 ) };
+	for each( WaveFormat^ format in formats )
+	{
+		DataStream^ encoded = AdpcmCodec::Encode( format, gcnew DataStream( input, true, false ) );
+		ASSERT_EQ( AdpcmCodec::GetEncodedSize( format, frames ), encoded->Length );
+		ASSERT_EQ( 0, encoded->Length % format->BlockAlignment );
+
+		DataStream^ decoded = AdpcmCodec::Decode( format, encoded, WaveFormatTag::Pcm );
+		ASSERT_TRUE( decoded->Length >= frames * 4 );
+
+		array<short>^ output = decoded->ReadRange<short>( frames * 2 );
+		ASSERT_GT( SignalToNoise( input, output ), 35.0 );
+
+		// blocks run on whichever thread picks them up, which must not change the result
+		encoded->Position = 0;
+		DataStream^ again = AdpcmCodec::Decode( format, encoded, WaveFormatTag::Pcm );
+		array<short>^ repeat = again->ReadRange<short>( frames * 2 );
+		for( int i = 0; i < output->Length; i++ )
+			ASSERT_EQ( output[i], repeat[i] );
+	}
+}
@@ -0,0 +1,286 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::IO;
+using namespace SlimDX;
+using namespace SlimDX::Multimedia;
+
+static WaveFormat^ MakeFormat( WaveFormatTag tag, int rate, int channels, int bits )
+{
+	WaveFormat^ format = gcnew WaveFormat();
+	format->FormatTag = tag;
+	format->SamplesPerSecond = rate;
+	format->Channels = static_cast<short>( channels );
+	format->BitsPerSample = static_cast<short>( bits );
+	format->BlockAlignment = static_cast<short>( channels * bits / 8 );
+	format->AverageBytesPerSecond = rate * format->BlockAlignment;
+	return format;
+}
+
+static array<float>^ Sine( int frames, double frequency, int rate )
+{
+	array<float>^ samples = gcnew array<float>( frames );
+	for( int i = 0; i < frames; i++ )
+		samples[i] = static_cast<float>( 0.5 * Math::Sin( 2 * Math::PI * frequency * i / rate ) );
+	return samples;
+}
+
+static array<float>^ ConvertAll( AudioConverter^ converter, DataStream^ source, int floats )
+{
+	DataStream^ destination = gcnew DataStream( floats * 4, true, true );
+	converter->Convert( source, destination );
+	while( converter->Flush( destination ) > 0 )
+		;
+
+	destination->Position = 0;
+	return destination->ReadRange<float>( floats );
+}
+
+TEST( AudioConverterTests, RoundTripsSixteenBitThroughFloat )
+{
+	array<short>^ input = gcnew array<short>( 4096 );
+	for( int i = 0; i < input->Length; i++ )
+		input[i] = static_cast<short>( i * 16 - 32768 );
+
+	AudioConverter^ toFloat = gcnew AudioConverter( MakeFormat( WaveFormatTag::Pcm, 44100, 2, 16 ), MakeFormat( WaveFormatTag::IeeeFloat, 44100, 2, 32 ) );
+	AudioConverter^ toPcm = gcnew AudioConverter( toFloat->DestinationFormat, toFloat->SourceFormat );
+
+	DataStream^ floats = gcnew DataStream( input->Length * 4, true, true );
+	ASSERT_EQ( input->Length * 4, toFloat->Convert( gcnew DataStream( input, true, false ), floats ) );
+	ASSERT_EQ( 0, toFloat->Flush( floats ) );
+
+	floats->Position = 0;
+	DataStream^ output = gcnew DataStream( input->Length * 2, true, true );
+	ASSERT_EQ( input->Length * 2, toPcm->Convert( floats, output ) );
+
+	// whole 16-bit values come back exactly, so there is nothing for dither to hide
+	output->Position = 0;
+	array<short>^ result = output->ReadRange<short>( input->Length );
+	for( int i = 0; i < input->Length; i++ )
+		ASSERT_EQ( input[i], result[i] );
+}
+
+TEST( AudioConverterTests, ConvertsIntegerSampleTypes )
+{
+	array<Byte>^ bytes = gcnew array<Byte> { 0x00, 0x00, 0x40, 0x00, 0x00, 0xc0, 0xff, 0xff, 0x7f };
+	AudioConverter^ converter = gcnew AudioConverter( MakeFormat( WaveFormatTag::Pcm, 48000, 1, 24 ), MakeFormat( WaveFormatTag::IeeeFloat, 48000, 1, 32 ) );
+	array<float>^ result = ConvertAll( converter, gcnew DataStream( bytes, true, false ), 3 );
+	ASSERT_EQ( 0.5f, result[0] );
+	ASSERT_EQ( -0.5f, result[1] );
+	ASSERT_EQ( 8388607 / 8388608.0f, result[2] );
+
+	// 8-bit samples are unsigned around 128
+	bytes = gcnew array<Byte> { 0x80, 0x00, 0xc0 };
+	converter = gcnew AudioConverter( MakeFormat( WaveFormatTag::Pcm, 48000, 1, 8 ), MakeFormat( WaveFormatTag::IeeeFloat, 48000, 1, 32 ) );
+	result = ConvertAll( converter, gcnew DataStream( bytes, true, false ), 3 );
+	ASSERT_EQ( 0.0f, result[0] );
+	ASSERT_EQ( -1.0f, result[1] );
+	ASSERT_EQ( 0.5f, result[2] );
+}
+
+TEST( AudioConverterTests, ResamplesSineAccurately )
+{
+	const int frames = 44100;
+	AudioConverter^ converter = gcnew AudioConverter( MakeFormat( WaveFormatTag::IeeeFloat, 44100, 1, 32 ), MakeFormat( WaveFormatTag::IeeeFloat, 48000, 1, 32 ) );
+	ASSERT_TRUE( converter->Quality == ResamplerQuality::High );
+	ASSERT_EQ( 48000 * 4, converter->GetOutputSize( frames * 4 ) );
+
+	array<float>^ result = ConvertAll( converter, gcnew DataStream( Sine( frames, 1000, 44100 ), true, false ), 48000 );
+	array<float>^ expected = Sine( 48000, 1000, 48000 );
+
+	// the ends are shaped by the silence around the input, so only the middle is compared
+	double signal = 0;
+	double noise = 0;
+	for( int i = 100; i < 47900; i++ )
+	{
+		signal += expected[i] * expected[i];
+		noise += (expected[i] - result[i]) * (expected[i] - result[i]);
+	}
+	ASSERT_GT( 10 * Math::Log10( signal / noise ), 70.0 );
+}
+
+TEST( AudioConverterTests, PreservesDirectCurrent )
+{
+	array<short>^ input = gcnew array<short>( 10000 );
+	for( int i = 0; i < input->Length; i++ )
+		input[i] = 10000;
+
+	AudioConverter^ converter = gcnew AudioConverter( MakeFormat( WaveFormatTag::Pcm, 44100, 1, 16 ), MakeFormat( WaveFormatTag::Pcm, 32000, 1, 16 ), ResamplerQuality::Low );
+	converter->Dither = false;
+
+	int size = static_cast<int>( converter->GetOutputSize( input->Length * 2 ) );
+	DataStream^ output = gcnew DataStream( size, true, true );
+	converter->Convert( gcnew DataStream( input, true, false ), output );
+	while( converter->Flush( output ) > 0 )
+		;
+	ASSERT_EQ( size, output->Position );
+
+	output->Position = 0;
+	array<short>^ result = output->ReadRange<short>( size / 2 );
+	for( int i = 50; i < result->Length - 50; i++ )
+		ASSERT_NEAR( 10000, result[i], 1 );
+}
+
+TEST( AudioConverterTests, StreamingMatchesBatch )
+{
+	array<float>^ input = gcnew array<float>( 2 * 20000 );
+	for( int i = 0; i < input->Length; i++ )
+		input[i] = static_cast<float>( Math::Sin( i * 0.01 ) * 0.8 );
+
+	WaveFormat^ sourceFormat = MakeFormat( WaveFormatTag::IeeeFloat, 44100, 2, 32 );
+	WaveFormat^ destinationFormat = MakeFormat( WaveFormatTag::IeeeFloat, 22050, 2, 32 );
+	AudioConverter^ converter = gcnew AudioConverter( sourceFormat, destinationFormat );
+	int size = static_cast<int>( converter->GetOutputSize( input->Length * 4 ) );
+	array<float>^ batch = ConvertAll( converter, gcnew DataStream( input, true, false ), size / 4 );
+
+	// feed the same audio through in odd sized pieces, with an even smaller output buffer
+	converter->Reset();
+	DataStream^ source = gcnew DataStream( input, true, false );
+	DataStream^ output = gcnew DataStream( size, true, true );
+	DataStream^ piece = gcnew DataStream( 8 * 23, true, true );
+
+	while( source->Position < source->Length )
+	{
+		int count = static_cast<int>( Math::Min( source->Length - source->Position, static_cast<Int64>( 8 * 37 ) ) );
+		DataStream^ block = gcnew DataStream( source->ReadRange<Byte>( count ), true, false );
+
+		do
+		{
+			piece->Position = 0;
+			int written = converter->Convert( block, piece );
+			output->WriteRange( piece->DataPointer, written );
+		}
+		while( block->Position < block->Length );
+	}
+
+	for( ;; )
+	{
+		piece->Position = 0;
+		int written = converter->Flush( piece );
+		if( written == 0 )
+			break;
+		output->WriteRange( piece->DataPointer, written );
+	}
+
+	ASSERT_EQ( size, output->Position );
+	output->Position = 0;
+	array<float>^ streamed = output->ReadRange<float>( size / 4 );
+	for( int i = 0; i < batch->Length; i++ )
+		ASSERT_EQ( batch[i], streamed[i] );
+}
+
+TEST( AudioConverterTests, BuildsChannelMatrices )
+{
+	WaveFormatExtensible^ surround = gcnew WaveFormatExtensible();
+	surround->FormatTag = WaveFormatTag::Extensible;
+	surround->SamplesPerSecond = 48000;
+	surround->Channels = 6;
+	surround->BitsPerSample = 16;
+	surround->BlockAlignment = 12;
+	surround->ValidBitsPerSample = 16;
+	surround->SubFormat = Guid( 1, 0x0000, 0x0010, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 );
+	surround->ChannelMask = Speakers::FivePointOne;
+
+	// front left, front right, center, LFE, back left, back right
+	array<float>^ matrix = AudioConverter::CreateChannelMatrix( surround, MakeFormat( WaveFormatTag::Pcm, 48000, 2, 16 ) );
+	ASSERT_EQ( 12, matrix->Length );
+	ASSERT_NEAR( 0.414f, matrix[0], 0.001f );
+	ASSERT_EQ( 0.0f, matrix[1] );
+	ASSERT_NEAR( 0.293f, matrix[2], 0.001f );
+	ASSERT_EQ( 0.0f, matrix[3] );
+	ASSERT_NEAR( 0.293f, matrix[4], 0.001f );
+	ASSERT_EQ( 0.0f, matrix[5] );
+	ASSERT_NEAR( 0.414f, matrix[7], 0.001f );
+	ASSERT_NEAR( 0.293f, matrix[8], 0.001f );
+	ASSERT_NEAR( 0.293f, matrix[11], 0.001f );
+
+	matrix = AudioConverter::CreateChannelMatrix( MakeFormat( WaveFormatTag::Pcm, 48000, 1, 16 ), MakeFormat( WaveFormatTag::Pcm, 48000, 2, 16 ) );
+	ASSERT_NEAR( 0.7071f, matrix[0], 0.001f );
+	ASSERT_NEAR( 0.7071f, matrix[1], 0.001f );
+
+	matrix = AudioConverter::CreateChannelMatrix( MakeFormat( WaveFormatTag::Pcm, 48000, 2, 16 ), MakeFormat( WaveFormatTag::Pcm, 48000, 1, 16 ) );
+	ASSERT_EQ( 0.5f, matrix[0] );
+	ASSERT_EQ( 0.5f, matrix[1] );
+}
+
+TEST( AudioConverterTests, RemixesWithCustomMatrix )
+{
+	array<float>^ input = { 0.25f, -0.5f, 0.125f, 0.75f };
+	AudioConverter^ converter = gcnew AudioConverter( MakeFormat( WaveFormatTag::IeeeFloat, 48000, 2, 32 ), MakeFormat( WaveFormatTag::IeeeFloat, 48000, 2, 32 ) );
+
+	// swap the channels
+	converter->ChannelMatrix = gcnew array<float> { 0, 1, 1, 0 };
+	array<float>^ result = ConvertAll( converter, gcnew DataStream( input, true, false ), 4 );
+	ASSERT_EQ( -0.5f, result[0] );
+	ASSERT_EQ( 0.25f, result[1] );
+	ASSERT_EQ( 0.75f, result[2] );
+	ASSERT_EQ( 0.125f, result[3] );
+
+	ASSERT_MANAGED_THROW( converter->ChannelMatrix = gcnew array<float>( 3 ), ArgumentException );
+}
+
+TEST( AudioConverterTests, ConvertsWaveStreams )
+{
+	const int frames = 4410;
+	MemoryStream^ file = gcnew MemoryStream();
+	BinaryWriter^ writer = gcnew BinaryWriter( file );
+	writer->Write( 0x46464952 );
+	writer->Write( 36 + frames * 4 );
+	writer->Write( 0x45564157 );
+	writer->Write( 0x20746d66 );
+	writer->Write( 16 );
+	writer->Write( static_cast<short>( 1 ) );
+	writer->Write( static_cast<short>( 2 ) );
+	writer->Write( 44100 );
+	writer->Write( 44100 * 4 );
+	writer->Write( static_cast<short>( 4 ) );
+	writer->Write( static_cast<short>( 16 ) );
+	writer->Write( 0x61746164 );
+	writer->Write( frames * 4 );
+	for( int i = 0; i < frames * 2; i++ )
+		writer->Write( static_cast<short>( 8192 ) );
+
+	WaveStream^ source = gcnew WaveStream( gcnew MemoryStream( file->ToArray() ) );
+	DataStream^ result = AudioConverter::Convert( source, MakeFormat( WaveFormatTag::IeeeFloat, 48000, 1, 32 ) );
+	ASSERT_EQ( 4800 * 4, result->Length );
+	ASSERT_EQ( 0, result->Position );
+	ASSERT_EQ( source->Length, source->Position );
+
+	// both channels fold into the mono output at half level each
+	array<float>^ samples = result->ReadRange<float>( 4800 );
+	for( int i = 100; i < 4700; i++ )
+		ASSERT_NEAR( 0.25f, samples[i], 0.0001f );
+}
+
+TEST( AudioConverterTests, RejectsUnsupportedFormats )
+{
+	WaveFormat^ pcm = MakeFormat( WaveFormatTag::Pcm, 44100, 2, 16 );
+	ASSERT_MANAGED_THROW( gcnew AudioConverter( AdpcmCodec::CreateImaFormat( 44100, 2, 1024 ), pcm ), ArgumentException );
+	ASSERT_MANAGED_THROW( gcnew AudioConverter( pcm, MakeFormat( WaveFormatTag::IeeeFloat, 44100, 2, 16 ) ), ArgumentException );
+	ASSERT_MANAGED_THROW( gcnew AudioConverter( nullptr, pcm ), ArgumentNullException );
+	ASSERT_MANAGED_THROW( gcnew AudioConverter( pcm, pcm, static_cast<ResamplerQuality>( 7 ) ), ArgumentOutOfRangeException );
+}
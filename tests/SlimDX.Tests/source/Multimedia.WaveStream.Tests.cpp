@@ -0,0 +1,391 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::IO;
+using namespace SlimDX;
+using namespace SlimDX::Multimedia;
+
+ref class WaveBuilder
+{
+private:
+	MemoryStream^ body;
+	BinaryWriter^ writer;
+
+	void Tag( String^ tag )
+	{
+		for( int i = 0; i < 4; i++ )
+			writer->Write( static_cast<Byte>( tag[i] ) );
+	}
+
+public:
+	WaveBuilder()
+	{
+		body = gcnew MemoryStream();
+		writer = gcnew BinaryWriter( body );
+	}
+
+	void Chunk( String^ tag, array<Byte>^ payload )
+	{
+		Tag( tag );
+		writer->Write( payload->Length );
+		writer->Write( payload );
+		if( payload->Length & 1 )
+			writer->Write( static_cast<Byte>( 0 ) );
+	}
+
+	void Format( short tag, short channels, array<Byte>^ extra )
+	{
+		MemoryStream^ format = gcnew MemoryStream();
+		BinaryWriter^ formatWriter = gcnew BinaryWriter( format );
+		formatWriter->Write( tag );
+		formatWriter->Write( channels );
+		formatWriter->Write( 44100 );
+		formatWriter->Write( 44100 * 2 * channels );
+		formatWriter->Write( static_cast<short>( 2 * channels ) );
+		formatWriter->Write( static_cast<short>( 16 ) );
+		if( extra != nullptr )
+		{
+			formatWriter->Write( static_cast<short>( extra->Length ) );
+			formatWriter->Write( extra );
+		}
+
+		Chunk( "fmt ", format->ToArray() );
+	}
+
+	array<Byte>^ ToArray( String^ riff, String^ form )
+	{
+		MemoryStream^ file = gcnew MemoryStream();
+		BinaryWriter^ fileWriter = gcnew BinaryWriter( file );
+		for( int i = 0; i < 4; i++ )
+			fileWriter->Write( static_cast<Byte>( riff[i] ) );
+		fileWriter->Write( riff == "RF64" ? -1 : static_cast<int>( body->Length + 4 ) );
+		for( int i = 0; i < 4; i++ )
+			fileWriter->Write( static_cast<Byte>( form[i] ) );
+		fileWriter->Write( body->ToArray() );
+		return file->ToArray();
+	}
+};
+
+static array<Byte>^ Samples( int count )
+{
+	array<Byte>^ samples = gcnew array<Byte>( count );
+	for( int i = 0; i < count; i++ )
+		samples[i] = static_cast<Byte>( i * 7 );
+	return samples;
+}
+
+TEST( WaveStreamTests, ReadsPcmData )
+{
+	WaveBuilder^ builder = gcnew WaveBuilder();
+	builder->Format( 1, 2, nullptr );
+	builder->Chunk( "data", Samples( 64 ) );
+
+	WaveStream^ stream = gcnew WaveStream( gcnew MemoryStream( builder->ToArray( "RIFF", "WAVE" ) ) );
+	ASSERT_TRUE( stream->Format->FormatTag == WaveFormatTag::Pcm );
+	ASSERT_EQ( 2, stream->Format->Channels );
+	ASSERT_EQ( 64, stream->Length );
+
+	array<Byte>^ buffer = gcnew array<Byte>( 100 );
+	ASSERT_EQ( 64, stream->Read( buffer, 0, 100 ) );
+	ASSERT_EQ( static_cast<Byte>( 70 ), buffer[10] );
+	ASSERT_EQ( 0, stream->Read( buffer, 0, 100 ) );
+
+	ASSERT_EQ( 60, stream->Seek( -4, SeekOrigin::End ) );
+	ASSERT_EQ( 4, stream->Read( buffer, 0, 100 ) );
+	ASSERT_EQ( static_cast<Byte>( 63 * 7 ), buffer[3] );
+	ASSERT_MANAGED_THROW( stream->Seek( 65, SeekOrigin::Begin ), InvalidOperationException );
+
+	delete stream;
+}
+
+TEST( WaveStreamTests, DataStreamInputIsNotCopied )
+{
+	WaveBuilder^ builder = gcnew WaveBuilder();
+	builder->Format( 1, 1, nullptr );
+	builder->Chunk( "data", Samples( 32 ) );
+
+	array<Byte>^ bytes = builder->ToArray( "RIFF", "WAVE" );
+	DataStream^ source = gcnew DataStream( bytes->Length, true, true );
+	source->Write( bytes, 0, bytes->Length );
+	source->Position = 0;
+
+	WaveStream^ stream = gcnew WaveStream( source );
+	ASSERT_EQ( source->DataPointer.ToInt64() + 12 + 8 + 16 + 8, stream->InternalMemory->DataPointer.ToInt64() );
+	ASSERT_EQ( 32, stream->InternalMemory->Length );
+
+	delete stream;
+	delete source;
+}
+
+TEST( WaveStreamTests, ReadsExtensibleAndAdpcmFormats )
+{
+	WaveBuilder^ builder = gcnew WaveBuilder();
+	array<Byte>^ extensible = gcnew array<Byte>( 22 );
+	extensible[2] = 0x3f;
+	builder->Format( -2, 6, extensible );
+	builder->Chunk( "data", Samples( 12 ) );
+
+	WaveStream^ stream = gcnew WaveStream( gcnew MemoryStream( builder->ToArray( "RIFF", "WAVE" ) ) );
+	ASSERT_TRUE( dynamic_cast<WaveFormatExtensible^>( stream->Format ) != nullptr );
+	delete stream;
+
+	builder = gcnew WaveBuilder();
+	array<Byte>^ adpcm = gcnew array<Byte>( 4 + 7 * 4 );
+	adpcm[0] = 0xf4;
+	adpcm[1] = 0x01;
+	adpcm[2] = 7;
+	builder->Format( 2, 1, adpcm );
+	builder->Chunk( "data", Samples( 12 ) );
+
+	stream = gcnew WaveStream( gcnew MemoryStream( builder->ToArray( "RIFF", "WAVE" ) ) );
+	AdpcmWaveFormat^ format = dynamic_cast<AdpcmWaveFormat^>( stream->Format );
+	ASSERT_TRUE( format != nullptr );
+	ASSERT_EQ( 500, format->SamplesPerBlock );
+	ASSERT_EQ( 7, format->Coefficients->Length );
+	delete stream;
+
+	// a coefficient count that runs past the chunk must be rejected rather than read
+	builder = gcnew WaveBuilder();
+	adpcm[2] = 100;
+	builder->Format( 2, 1, adpcm );
+	builder->Chunk( "data", Samples( 12 ) );
+	ASSERT_MANAGED_THROW( gcnew WaveStream( gcnew MemoryStream( builder->ToArray( "RIFF", "WAVE" ) ) ), InvalidDataException );
+}
+
+TEST( WaveStreamTests, ReadsLoopsCuesAndInfo )
+{
+	WaveBuilder^ builder = gcnew WaveBuilder();
+	builder->Format( 1, 1, nullptr );
+	builder->Chunk( "data", Samples( 40 ) );
+
+	array<Byte>^ sample = gcnew array<Byte>( 36 + 24 );
+	sample[28] = 1;
+	sample[36] = 5;
+	sample[44] = 4;
+	sample[48] = 16;
+	builder->Chunk( "smpl", sample );
+
+	array<Byte>^ cue = gcnew array<Byte>( 4 + 24 );
+	cue[0] = 1;
+	cue[4] = 5;
+	cue[24] = 8;
+	builder->Chunk( "cue ", cue );
+
+	array<Byte>^ info = gcnew array<Byte>{ 'I', 'N', 'F', 'O', 'I', 'N', 'A', 'M', 5, 0, 0, 0, 'r', 'a', 'i', 'n', 0, 0 };
+	builder->Chunk( "LIST", info );
+
+	array<Byte>^ adtl = gcnew array<Byte>{ 'a', 'd', 't', 'l', 'l', 'a', 'b', 'l', 8, 0, 0, 0, 5, 0, 0, 0, 'h', 'i', 't', 0 };
+	builder->Chunk( "LIST", adtl );
+
+	WaveStream^ stream = gcnew WaveStream( gcnew MemoryStream( builder->ToArray( "RIFF", "WAVE" ) ) );
+	ASSERT_EQ( 1, stream->Loops->Length );
+	ASSERT_EQ( 5, stream->Loops[0].Identifier );
+	ASSERT_EQ( 4, stream->Loops[0].Start );
+	ASSERT_EQ( 16, stream->Loops[0].End );
+
+	ASSERT_EQ( 1, stream->CuePoints->Length );
+	ASSERT_EQ( 8, stream->CuePoints[0].SampleOffset );
+	ASSERT_TRUE( stream->CuePoints[0].Label == "hit" );
+
+	ASSERT_TRUE( stream->Info["INAM"] == "rain" );
+	ASSERT_EQ( 40, stream->Length );
+
+	delete stream;
+}
+
+TEST( WaveStreamTests, ReadsRF64 )
+{
+	WaveBuilder^ builder = gcnew WaveBuilder();
+	MemoryStream^ ds64 = gcnew MemoryStream();
+	BinaryWriter^ writer = gcnew BinaryWriter( ds64 );
+	writer->Write( static_cast<Int64>( 0 ) );
+	writer->Write( static_cast<Int64>( 24 ) );
+	writer->Write( static_cast<Int64>( 12 ) );
+	writer->Write( 0 );
+	builder->Chunk( "ds64", ds64->ToArray() );
+	builder->Format( 1, 1, nullptr );
+
+	array<Byte>^ bytes = builder->ToArray( "RF64", "WAVE" );
+	MemoryStream^ file = gcnew MemoryStream();
+	file->Write( bytes, 0, bytes->Length );
+	file->Write( gcnew array<Byte>{ 'd', 'a', 't', 'a', 0xff, 0xff, 0xff, 0xff }, 0, 8 );
+	file->Write( Samples( 24 ), 0, 24 );
+
+	WaveStream^ stream = gcnew WaveStream( gcnew MemoryStream( file->ToArray() ) );
+	ASSERT_EQ( 24, stream->Length );
+	delete stream;
+}
+
+TEST( WaveStreamTests, TruncatedDataIsClamped )
+{
+	WaveBuilder^ builder = gcnew WaveBuilder();
+	builder->Format( 1, 1, nullptr );
+	builder->Chunk( "data", Samples( 64 ) );
+
+	array<Byte>^ bytes = builder->ToArray( "RIFF", "WAVE" );
+	WaveStream^ stream = gcnew WaveStream( gcnew MemoryStream( bytes, 0, bytes->Length - 10 ) );
+	ASSERT_EQ( 54, stream->Length );
+	delete stream;
+}
+
+TEST( WaveStreamTests, RejectsInvalidFiles )
+{
+	array<Byte>^ garbage = gcnew array<Byte>{ 'R', 'I', 'F', 'F', 4, 0, 0, 0, 'W', 'A', 'V', 'E' };
+	ASSERT_MANAGED_THROW( gcnew WaveStream( gcnew MemoryStream( garbage ) ), InvalidDataException );
+
+	WaveBuilder^ builder = gcnew WaveBuilder();
+	builder->Format( 1, 1, nullptr );
+	builder->Chunk( "data", Samples( 8 ) );
+	ASSERT_MANAGED_THROW( gcnew WaveStream( gcnew MemoryStream( builder->ToArray( "RIFF", "XWMA" ) ) ), InvalidDataException );
+}
+
+TEST( WaveStreamTests, RiffFileReadsThroughStreams )
+{
+	WaveBuilder^ builder = gcnew WaveBuilder();
+	builder->Format( 1, 1, nullptr );
+	builder->Chunk( "data", Samples( 48 ) );
+
+	array<Byte>^ bytes = builder->ToArray( "RIFF", "WAVE" );
+	MemoryStream^ source = gcnew MemoryStream();
+	source->Write( gcnew array<Byte>( 5 ), 0, 5 );
+	source->Write( bytes, 0, bytes->Length );
+
+	RiffFile^ file = gcnew RiffFile( source, 5, bytes->Length, false );
+	// 'WAVE' as a little endian four character code
+	file->Parse( 0x45564157, "Invalid wave file." );
+	ASSERT_TRUE( file->DataView == nullptr );
+	ASSERT_EQ( 48, file->DataLength );
+
+	array<Byte>^ buffer = gcnew array<Byte>( 16 );
+	ASSERT_EQ( 16, file->ReadData( 32, buffer, 0, 16 ) );
+	ASSERT_EQ( static_cast<Byte>( 32 * 7 ), buffer[0] );
+	ASSERT_EQ( 0, file->ReadData( 48, buffer, 0, 16 ) );
+
+	delete file;
+}
+
+TEST( WaveStreamTests, StreamingMatchesMemoryMode )
+{
+	WaveBuilder^ builder = gcnew WaveBuilder();
+	builder->Format( 1, 2, nullptr );
+	builder->Chunk( "data", Samples( 1000 ) );
+	array<Byte>^ bytes = builder->ToArray( "RIFF", "WAVE" );
+
+	// an odd block size is rounded up to whole frames
+	MemoryStream^ source = gcnew MemoryStream( bytes );
+	WaveStream^ stream = gcnew WaveStream( source, 63, 3 );
+	ASSERT_TRUE( stream->IsStreaming );
+	ASSERT_EQ( 1000, stream->Length );
+
+	array<Byte>^ buffer = gcnew array<Byte>( 1000 );
+	int total = 0;
+	while( true )
+	{
+		int read = stream->Read( buffer, total, Math::Min( 37, 1000 - total ) );
+		if( read == 0 )
+			break;
+		total += read;
+	}
+
+	ASSERT_EQ( 1000, total );
+	for( int i = 0; i < total; i++ )
+		ASSERT_EQ( static_cast<Byte>( i * 7 ), buffer[i] );
+
+	// seeking backwards refills the window from the new position
+	ASSERT_EQ( 100, stream->Seek( 100, SeekOrigin::Begin ) );
+	ASSERT_EQ( 8, stream->Read( buffer, 0, 8 ) );
+	ASSERT_EQ( static_cast<Byte>( 100 * 7 ), buffer[0] );
+
+	delete stream;
+	ASSERT_TRUE( source->CanRead );
+}
+
+TEST( WaveStreamTests, PoolFillsFromStreamingSource )
+{
+	WaveBuilder^ builder = gcnew WaveBuilder();
+	builder->Format( 1, 2, nullptr );
+	builder->Chunk( "data", Samples( 600 ) );
+
+	WaveStream^ stream = gcnew WaveStream( gcnew MemoryStream( builder->ToArray( "RIFF", "WAVE" ) ), 128, 2 );
+	SlimDX::XAudio2::AudioBufferPool^ pool = gcnew SlimDX::XAudio2::AudioBufferPool( 4, 258 );
+
+	// buffers are trimmed to whole frames, and the last one is flagged as the end of the stream
+	SlimDX::XAudio2::AudioBuffer^ first;
+	ASSERT_TRUE( pool->Fill( stream, first ) );
+	ASSERT_EQ( 256, first->AudioBytes );
+	ASSERT_TRUE( first->Flags == SlimDX::XAudio2::BufferFlags::None );
+	first->AudioData->Position = 1;
+	ASSERT_EQ( 7, first->AudioData->ReadByte() );
+
+	SlimDX::XAudio2::AudioBuffer^ second;
+	ASSERT_TRUE( pool->Fill( stream, second ) );
+	second->AudioData->Position = 0;
+	ASSERT_EQ( (256 * 7) & 0xff, second->AudioData->ReadByte() );
+	SlimDX::XAudio2::AudioBuffer^ last;
+	ASSERT_TRUE( pool->Fill( stream, last ) );
+	ASSERT_EQ( 256, second->AudioBytes );
+	ASSERT_EQ( 88, last->AudioBytes );
+	ASSERT_TRUE( last->Flags == SlimDX::XAudio2::BufferFlags::EndOfStream );
+
+	// the end of the stream is not a failure to rent
+	SlimDX::XAudio2::AudioBuffer^ none;
+	ASSERT_FALSE( pool->Fill( stream, none ) );
+	ASSERT_TRUE( none == nullptr );
+	ASSERT_EQ( 3, pool->InUseCount );
+	ASSERT_EQ( 3, pool->RentCount );
+	ASSERT_EQ( 0, pool->FailedRentCount );
+
+	pool->Return( first );
+	pool->Return( second );
+	pool->Return( last );
+	delete pool;
+	delete stream;
+}
+
+TEST( WaveStreamTests, PoolFillTellsExhaustionFromEndOfStream )
+{
+	WaveBuilder^ builder = gcnew WaveBuilder();
+	builder->Format( 1, 2, nullptr );
+	builder->Chunk( "data", Samples( 600 ) );
+
+	WaveStream^ stream = gcnew WaveStream( gcnew MemoryStream( builder->ToArray( "RIFF", "WAVE" ) ), 128, 2 );
+	SlimDX::XAudio2::AudioBufferPool^ pool = gcnew SlimDX::XAudio2::AudioBufferPool( 1, 256 );
+
+	SlimDX::XAudio2::AudioBuffer^ first;
+	ASSERT_TRUE( pool->Fill( stream, first ) );
+
+	// an exhausted pool still has data to give, and leaves the stream where it was
+	SlimDX::XAudio2::AudioBuffer^ second;
+	ASSERT_TRUE( pool->Fill( stream, second ) );
+	ASSERT_TRUE( second == nullptr );
+	ASSERT_EQ( 1, pool->FailedRentCount );
+	ASSERT_EQ( 256, stream->Position );
+
+	pool->Return( first );
+	delete pool;
+	delete stream;
+}
@@ -0,0 +1,215 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace SlimDX::Multimedia;
+using namespace SlimDX::X3DAudio;
+
+typedef SlimDX::X3DAudio::X3DAudio AudioEngine;
+typedef SlimDX::Vector3 Vector3;
+
+static Listener^ MakeListener()
+{
+	Listener^ listener = gcnew Listener();
+	listener->OrientFront = Vector3( 0, 0, 1 );
+	listener->OrientTop = Vector3( 0, 1, 0 );
+	listener->Position = Vector3( 1, 0, -2 );
+	listener->Velocity = Vector3( 0.5f, 0, 0 );
+	return listener;
+}
+
+static Emitter^ MakeEmitter( int index, array<float>^ azimuths, array<CurvePoint>^ curve )
+{
+	Emitter^ emitter = gcnew Emitter();
+	emitter->OrientFront = Vector3( 0, 0, -1 );
+	emitter->OrientTop = Vector3( 0, 1, 0 );
+	emitter->Position = Vector3( static_cast<float>( Math::Cos( index * 0.7 ) * ( 2 + index ) ), 0.25f * index, static_cast<float>( Math::Sin( index * 0.7 ) * ( 2 + index ) ) );
+	emitter->Velocity = Vector3( 0, 0, static_cast<float>( index % 3 ) );
+	emitter->ChannelCount = ( index % 2 ) + 1;
+	emitter->ChannelRadius = 1.0f;
+	emitter->ChannelAzimuths = azimuths;
+	emitter->CurveDistance = 1.0f;
+	emitter->Doppler = 1.0f;
+	emitter->VolumeCurve = curve;
+	return emitter;
+}
+
+static void AssertSame( DspSettings^ expected, DspSettings^ actual )
+{
+	ASSERT_EQ( expected->SourceChannelCount, actual->SourceChannelCount );
+	ASSERT_EQ( expected->DestinationChannelCount, actual->DestinationChannelCount );
+	for( int i = 0; i < expected->MatrixCoefficients->Length; i++ )
+		ASSERT_EQ( expected->MatrixCoefficients[i], actual->MatrixCoefficients[i] );
+	for( int i = 0; i < expected->DelayTimes->Length; i++ )
+		ASSERT_EQ( expected->DelayTimes[i], actual->DelayTimes[i] );
+	ASSERT_EQ( expected->DopplerFactor, actual->DopplerFactor );
+	ASSERT_EQ( expected->EmitterToListenerAngle, actual->EmitterToListenerAngle );
+	ASSERT_EQ( expected->EmitterToListenerDistance, actual->EmitterToListenerDistance );
+	ASSERT_EQ( expected->EmitterVelocityComponent, actual->EmitterVelocityComponent );
+	ASSERT_EQ( expected->ListenerVelocityComponent, actual->ListenerVelocityComponent );
+	ASSERT_EQ( expected->LpfDirectCoefficient, actual->LpfDirectCoefficient );
+	ASSERT_EQ( expected->ReverbLevel, actual->ReverbLevel );
+}
+
+static void CompareBatch( bool parallel )
+{
+	const int count = 100;
+	CalculateFlags flags = CalculateFlags::Matrix | CalculateFlags::Delay | CalculateFlags::Doppler | CalculateFlags::LpfDirect | CalculateFlags::Reverb;
+
+	array<float>^ azimuths = gcnew array<float> { -0.5f, 0.5f };
+	array<CurvePoint>^ curve = gcnew array<CurvePoint>( 3 );
+	curve[0].Distance = 0.0f;
+	curve[0].DspSetting = 1.0f;
+	curve[1].Distance = 0.5f;
+	curve[1].DspSetting = 0.6f;
+	curve[2].Distance = 1.0f;
+	curve[2].DspSetting = 0.0f;
+
+	Cone^ cone = gcnew Cone();
+	cone->InnerAngle = 1.0f;
+	cone->OuterAngle = 2.0f;
+	cone->InnerVolume = 1.0f;
+	cone->OuterVolume = 0.5f;
+
+	AudioEngine^ engine = gcnew AudioEngine( Speakers::Stereo, 343.5f );
+	Listener^ listener = MakeListener();
+	EmitterSet^ set = gcnew EmitterSet( count );
+	array<Emitter^>^ emitters = gcnew array<Emitter^>( count );
+	array<DspSettings^>^ settings = gcnew array<DspSettings^>( count );
+
+	for( int i = 0; i < count; i++ )
+	{
+		emitters[i] = MakeEmitter( i, azimuths, ( i % 4 ) == 0 ? nullptr : curve );
+		emitters[i]->Cone = ( i % 5 ) == 0 ? cone : nullptr;
+		ASSERT_EQ( i, set->Add( emitters[i] ) );
+		settings[i] = gcnew DspSettings( emitters[i]->ChannelCount, 2 );
+	}
+
+	// a second pass after moving the emitters checks that the streams are what gets calculated
+	for( int pass = 0; pass < 2; pass++ )
+	{
+		engine->Calculate( listener, set, flags, settings, parallel );
+
+		for( int i = 0; i < count; i++ )
+			AssertSame( engine->Calculate( listener, emitters[i], flags, emitters[i]->ChannelCount, 2 ), settings[i] );
+
+		for( int i = 0; i < count; i++ )
+		{
+			emitters[i]->Position = emitters[i]->Position + Vector3( 0.5f, 0, -1.0f );
+			emitters[i]->OrientFront = Vector3( 1, 0, 0 );
+			set->SetPosition( i, emitters[i]->Position, emitters[i]->Velocity );
+			set->SetOrientation( i, emitters[i]->OrientFront, emitters[i]->OrientTop );
+		}
+	}
+
+	delete set;
+	delete engine;
+}
+
+TEST( EmitterSetTests, BatchMatchesSingleEmitter )
+{
+	CompareBatch( false );
+}
+
+TEST( EmitterSetTests, ParallelBatchMatchesSingleEmitter )
+{
+	CompareBatch( true );
+}
+
+TEST( EmitterSetTests, SetPicksUpChangedCurvesAndCones )
+{
+	CalculateFlags flags = CalculateFlags::Matrix | CalculateFlags::LpfDirect | CalculateFlags::Reverb;
+
+	array<CurvePoint>^ curve = gcnew array<CurvePoint>( 2 );
+	curve[0].Distance = 0.0f;
+	curve[0].DspSetting = 1.0f;
+	curve[1].Distance = 1.0f;
+	curve[1].DspSetting = 0.5f;
+
+	Cone^ cone = gcnew Cone();
+	cone->InnerAngle = 1.0f;
+	cone->OuterAngle = 2.0f;
+	cone->InnerVolume = 1.0f;
+	cone->OuterVolume = 0.5f;
+
+	AudioEngine^ engine = gcnew AudioEngine( Speakers::Stereo, 343.5f );
+	Listener^ listener = MakeListener();
+	EmitterSet^ set = gcnew EmitterSet( 2 );
+	array<DspSettings^>^ settings = gcnew array<DspSettings^> { gcnew DspSettings( 1, 2 ), gcnew DspSettings( 1, 2 ) };
+
+	// both slots share the same curve and cone objects
+	array<Emitter^>^ emitters = gcnew array<Emitter^> { MakeEmitter( 2, nullptr, curve ), MakeEmitter( 4, nullptr, curve ) };
+	for( int i = 0; i < emitters->Length; i++ )
+	{
+		emitters[i]->Cone = cone;
+		set->Add( emitters[i] );
+	}
+
+	// changing the shared objects in place and setting the emitters again has to pick up the new values
+	for( int pass = 0; pass < 3; pass++ )
+	{
+		curve[1].DspSetting = 0.1f * pass;
+		cone->OuterVolume = 0.2f * pass;
+		for( int i = 0; i < emitters->Length; i++ )
+			set->Set( i, emitters[i] );
+
+		engine->Calculate( listener, set, flags, settings );
+		for( int i = 0; i < emitters->Length; i++ )
+			AssertSame( engine->Calculate( listener, emitters[i], flags, 1, 2 ), settings[i] );
+	}
+
+	// a cleared set can be refilled
+	set->Clear();
+	ASSERT_EQ( 0, set->Count );
+	ASSERT_EQ( 0, set->Add( emitters[1] ) );
+
+	delete set;
+	delete engine;
+}
+
+TEST( EmitterSetTests, RejectsBadArguments )
+{
+	ASSERT_MANAGED_THROW( gcnew EmitterSet( 0 ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( gcnew DspSettings( 0, 2 ), ArgumentOutOfRangeException );
+
+	EmitterSet^ set = gcnew EmitterSet( 1 );
+	Emitter^ stereo = MakeEmitter( 1, nullptr, nullptr );
+	ASSERT_MANAGED_THROW( set->Add( stereo ), ArgumentException );
+	ASSERT_EQ( 0, set->Count );
+
+	set->Add( MakeEmitter( 0, nullptr, nullptr ) );
+	ASSERT_MANAGED_THROW( set->Add( MakeEmitter( 0, nullptr, nullptr ) ), InvalidOperationException );
+	ASSERT_MANAGED_THROW( set->SetPosition( 1, Vector3(), Vector3() ), ArgumentOutOfRangeException );
+
+	AudioEngine^ engine = gcnew AudioEngine( Speakers::Stereo, 343.5f );
+	array<DspSettings^>^ settings = gcnew array<DspSettings^> { gcnew DspSettings( 2, 2 ) };
+	ASSERT_MANAGED_THROW( engine->Calculate( MakeListener(), set, CalculateFlags::Matrix, settings ), ArgumentException );
+	ASSERT_MANAGED_THROW( engine->Calculate( MakeListener(), set, CalculateFlags::Matrix, gcnew array<DspSettings^>( 0 ) ), ArgumentException );
+
+	delete set;
+	ASSERT_MANAGED_THROW( set->Clear(), ObjectDisposedException );
+	delete engine;
+}
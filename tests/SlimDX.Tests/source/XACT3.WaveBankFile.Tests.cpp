@@ -0,0 +1,227 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::IO;
+using namespace SlimDX;
+using namespace SlimDX::XACT3;
+
+// 16-bit stereo PCM at 44100 Hz, packed as a mini wave format
+static const unsigned int PcmFormat = ( 2u << 2 ) | ( 44100u << 5 ) | ( 1u << 31 );
+
+static void WriteName( BinaryWriter^ writer, String^ name )
+{
+	array<unsigned char>^ bytes = gcnew array<unsigned char>( 64 );
+	Text::Encoding::ASCII->GetBytes( name, 0, name->Length, bytes, 0 );
+	writer->Write( bytes );
+}
+
+// Writes a two-wave bank: "first" holds 100 frames and "second" 150, with wave data filled with the wave number.
+static String^ WriteBank( bool compact )
+{
+	String^ path = Path::GetTempFileName();
+	BinaryWriter^ writer = gcnew BinaryWriter( File::Create( path ) );
+
+	int metaDataSize = compact ? 8 : 48;
+	writer->Write( 0x444E4257 );
+	writer->Write( 46 );
+	writer->Write( 44 );
+	writer->Write( 52 ); writer->Write( 96 );
+	writer->Write( 148 ); writer->Write( metaDataSize );
+	writer->Write( 0 ); writer->Write( 0 );
+	writer->Write( 148 + metaDataSize ); writer->Write( 128 );
+	writer->Write( 512 ); writer->Write( 1000 );
+
+	writer->Write( compact ? 0x30000 : 0x10000 );
+	writer->Write( 2 );
+	WriteName( writer, "TestBank" );
+	writer->Write( compact ? 4 : 24 );
+	writer->Write( 64 );
+	writer->Write( 4 );
+	writer->Write( static_cast<int>( PcmFormat ) );
+	writer->Write( static_cast<Int64>( 0 ) );
+
+	if( compact )
+	{
+		writer->Write( 0 );
+		writer->Write( 100 );
+	}
+	else
+	{
+		writer->Write( 100 << 4 );
+		writer->Write( static_cast<int>( PcmFormat ) );
+		writer->Write( 0 ); writer->Write( 400 );
+		writer->Write( 10 ); writer->Write( 20 );
+
+		writer->Write( 150 << 4 );
+		writer->Write( static_cast<int>( PcmFormat ) );
+		writer->Write( 400 ); writer->Write( 600 );
+		writer->Write( 0 ); writer->Write( 0 );
+	}
+
+	WriteName( writer, "first" );
+	WriteName( writer, "second" );
+
+	while( writer->BaseStream->Position < 512 )
+		writer->Write( static_cast<unsigned char>( 0 ) );
+	for( int i = 0; i < 1000; i++ )
+		writer->Write( static_cast<unsigned char>( i < 400 ? 1 : 2 ) );
+
+	writer->Close();
+	return path;
+}
+
+TEST( WaveBankFileTests, ReadsEntryTable )
+{
+	String^ path = WriteBank( false );
+	WaveBankFile^ bank = gcnew WaveBankFile( path );
+
+	ASSERT_TRUE( bank->Name == "TestBank" );
+	ASSERT_EQ( 2, bank->WaveCount );
+	ASSERT_FALSE( bank->IsStreaming );
+	ASSERT_EQ( 1, bank->GetWaveIndex( "second" ) );
+	ASSERT_EQ( -1, bank->GetWaveIndex( "third" ) );
+
+	WaveProperties properties = bank->GetWaveProperties( 0 );
+	ASSERT_TRUE( properties.FriendlyName == "first" );
+	ASSERT_EQ( 100, properties.DurationInSamples );
+	ASSERT_EQ( 10, properties.LoopRegion.StartSample );
+	ASSERT_EQ( 20, properties.LoopRegion.TotalSamples );
+	ASSERT_TRUE( properties.Format.FormatTag == WaveBankMiniFormatTag::Pcm );
+	ASSERT_EQ( 2, properties.Format.Channels );
+	ASSERT_EQ( 44100, properties.Format.SamplesPerSecond );
+
+	DataStream^ data = bank->GetWaveData( 1 );
+	ASSERT_EQ( 600, data->Length );
+	ASSERT_EQ( 2, data->Read<unsigned char>() );
+	ASSERT_FALSE( data->CanWrite );
+
+	// frames 10 to 19 of a 4-byte frame
+	DataStream^ part = bank->GetWaveData( 0, 10, 10 );
+	ASSERT_EQ( 40, part->Length );
+
+	ASSERT_MANAGED_THROW( bank->GetWaveData( 2 ), ArgumentOutOfRangeException );
+
+	delete part;
+	delete data;
+	delete bank;
+	ASSERT_MANAGED_THROW( bank->GetWaveIndex( "first" ), ObjectDisposedException );
+	File::Delete( path );
+}
+
+TEST( WaveBankFileTests, ReadsCompactEntries )
+{
+	String^ path = WriteBank( true );
+	WaveBankFile^ bank = gcnew WaveBankFile( path );
+
+	// compact entries are placed by alignment units and run up to the next entry
+	DataStream^ first = bank->GetWaveData( 0 );
+	DataStream^ second = bank->GetWaveData( 1 );
+	ASSERT_EQ( 400, first->Length );
+	ASSERT_EQ( 100, bank->GetWaveProperties( 0 ).DurationInSamples );
+	ASSERT_EQ( 600, second->Length );
+	ASSERT_EQ( 150, bank->GetWaveProperties( 1 ).DurationInSamples );
+
+	delete first;
+	delete second;
+	delete bank;
+	File::Delete( path );
+}
+
+TEST( WaveBankFileTests, CountsPrefetchHits )
+{
+	String^ path = WriteBank( false );
+	WaveBankFile^ bank = gcnew WaveBankFile( path, 800 );
+
+	bank->Prefetch( 1 );
+	ASSERT_TRUE( bank->WaitForPrefetch( 5000 ) );
+	ASSERT_EQ( 600, bank->PrefetchedBytes );
+
+	delete bank->GetWaveData( 1 );
+	delete bank->GetWaveData( 0 );
+	ASSERT_EQ( 1, bank->PrefetchHitCount );
+	ASSERT_EQ( 1, bank->PrefetchMissCount );
+
+	// the budget only has room for one of the two waves
+	bank->Prefetch( 0 );
+	ASSERT_TRUE( bank->WaitForPrefetch( 5000 ) );
+	ASSERT_EQ( 400, bank->ResidentBytes );
+	delete bank->GetWaveData( 1 );
+	ASSERT_EQ( 2, bank->PrefetchMissCount );
+
+	bank->ResetStatistics();
+	ASSERT_EQ( 0, bank->PrefetchHitCount );
+
+	delete bank;
+	File::Delete( path );
+}
+
+// Kept out of line so that the file is unreachable once it returns.
+[Runtime::CompilerServices::MethodImpl( Runtime::CompilerServices::MethodImplOptions::NoInlining )]
+static DataStream^ GetWaveDataAndDropFile( String^ path )
+{
+	WaveBankFile^ bank = gcnew WaveBankFile( path );
+	return bank->GetWaveData( 1 );
+}
+
+TEST( WaveBankFileTests, StreamsOutliveFile )
+{
+	String^ path = WriteBank( false );
+
+	// the file is finalized while its wave stream is still in use
+	DataStream^ data = GetWaveDataAndDropFile( path );
+	GC::Collect();
+	GC::WaitForPendingFinalizers();
+	GC::Collect();
+
+	data->Position = 599;
+	ASSERT_EQ( 2, data->Read<unsigned char>() );
+
+	// disposing the file explicitly also leaves its streams readable
+	WaveBankFile^ bank = gcnew WaveBankFile( path );
+	DataStream^ whole = bank->Data;
+	delete bank;
+
+	whole->Position = 511;
+	ASSERT_EQ( 0, whole->Read<unsigned char>() );
+	ASSERT_EQ( 1, whole->Read<unsigned char>() );
+
+	// the mapping goes away with the last stream, after which the file can be deleted
+	delete whole;
+	delete data;
+	File::Delete( path );
+}
+
+TEST( WaveBankFileTests, RejectsOtherFiles )
+{
+	String^ path = Path::GetTempFileName();
+	File::WriteAllBytes( path, gcnew array<unsigned char>( 256 ) );
+
+	ASSERT_MANAGED_THROW( gcnew WaveBankFile( path ), InvalidDataException );
+	ASSERT_MANAGED_THROW( gcnew WaveBankFile( path + ".missing" ), FileNotFoundException );
+
+	File::Delete( path );
+}
@@ -0,0 +1,282 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace SlimDX;
+using namespace SlimDX::XAPO;
+
+static array<float>^ Noise( int count, int seed )
+{
+	Random^ random = gcnew Random( seed );
+	array<float>^ samples = gcnew array<float>( count );
+	for( int i = 0; i < count; i++ )
+		samples[i] = static_cast<float>( random->NextDouble() * 2.0 - 1.0 );
+
+	return samples;
+}
+
+// channel counts chosen to cover the vector paths and their scalar tails
+static array<int>^ ChannelCounts()
+{
+	return gcnew array<int> { 1, 2, 3, 4, 6, 8 };
+}
+
+TEST( AudioKernelsTests, ApplyGainMatchesReference )
+{
+	for each( int channels in ChannelCounts() )
+	{
+		const int frames = 131;
+		array<float>^ input = Noise( channels * frames, channels );
+		array<float>^ output = safe_cast<array<float>^>( input->Clone() );
+
+		pin_ptr<float> pinned = &output[0];
+		AudioKernels::ApplyGain( IntPtr( pinned ), channels, frames, 0.25f, 1.25f );
+
+		for( int i = 0; i < input->Length; i++ )
+			ASSERT_NEAR( input[i] * (0.25f + (i / channels) / static_cast<float>( frames )), output[i], 1e-5f );
+	}
+}
+
+TEST( AudioKernelsTests, MixWithGainAddsToDestination )
+{
+	for each( int channels in ChannelCounts() )
+	{
+		const int frames = 67;
+		array<float>^ source = Noise( channels * frames, channels );
+		array<float>^ destination = Noise( channels * frames, channels + 100 );
+		array<float>^ original = safe_cast<array<float>^>( destination->Clone() );
+
+		pin_ptr<float> pinnedSource = &source[0];
+		pin_ptr<float> pinnedDestination = &destination[0];
+		AudioKernels::MixWithGain( IntPtr( pinnedSource ), IntPtr( pinnedDestination ), channels, frames, 0.5f, 0.5f );
+
+		for( int i = 0; i < source->Length; i++ )
+			ASSERT_NEAR( original[i] + source[i] * 0.5f, destination[i], 1e-5f );
+	}
+}
+
+TEST( AudioKernelsTests, MixMatrixMatchesReference )
+{
+	for each( int sourceChannels in ChannelCounts() )
+	{
+		for each( int destinationChannels in ChannelCounts() )
+		{
+			const int frames = 33;
+			array<float>^ source = Noise( sourceChannels * frames, sourceChannels );
+			array<float>^ matrix = Noise( sourceChannels * destinationChannels, destinationChannels );
+			array<float>^ destination = gcnew array<float>( destinationChannels * frames );
+
+			pin_ptr<float> pinnedSource = &source[0];
+			pin_ptr<float> pinnedDestination = &destination[0];
+			AudioKernels::MixMatrix( IntPtr( pinnedSource ), sourceChannels, IntPtr( pinnedDestination ), destinationChannels, frames, matrix, false );
+
+			for( int frame = 0; frame < frames; frame++ )
+			{
+				for( int d = 0; d < destinationChannels; d++ )
+				{
+					float expected = 0.0f;
+					for( int s = 0; s < sourceChannels; s++ )
+						expected += matrix[d * sourceChannels + s] * source[frame * sourceChannels + s];
+
+					ASSERT_NEAR( expected, destination[frame * destinationChannels + d], 1e-4f );
+				}
+			}
+		}
+	}
+}
+
+TEST( AudioKernelsTests, MixMatrixRejectsShortMatrix )
+{
+	array<float>^ samples = gcnew array<float>( 8 );
+	pin_ptr<float> pinned = &samples[0];
+	ASSERT_MANAGED_THROW( AudioKernels::MixMatrix( IntPtr( pinned ), 2, IntPtr( pinned ), 2, 1, gcnew array<float>( 3 ), false ), ArgumentException );
+}
+
+TEST( AudioKernelsTests, MeasureLevelsMatchesReference )
+{
+	for each( int channels in ChannelCounts() )
+	{
+		const int frames = 99;
+		array<float>^ input = Noise( channels * frames, channels );
+		array<float>^ peaks = gcnew array<float>( channels );
+		array<float>^ rms = gcnew array<float>( channels );
+
+		pin_ptr<float> pinned = &input[0];
+		AudioKernels::MeasureLevels( IntPtr( pinned ), channels, frames, peaks, rms );
+
+		for( int c = 0; c < channels; c++ )
+		{
+			float peak = 0.0f;
+			double sum = 0.0;
+			for( int frame = 0; frame < frames; frame++ )
+			{
+				float value = input[frame * channels + c];
+				peak = Math::Max( peak, Math::Abs( value ) );
+				sum += value * value;
+			}
+
+			ASSERT_FLOAT_EQ( peak, peaks[c] );
+			ASSERT_NEAR( Math::Sqrt( sum / frames ), rms[c], 1e-4 );
+		}
+	}
+}
+
+TEST( AudioKernelsTests, InterleaveRoundTrips )
+{
+	for each( int channels in ChannelCounts() )
+	{
+		const int frames = 45;
+		array<float>^ input = Noise( channels * frames, channels );
+		array<float>^ planes = gcnew array<float>( channels * frames );
+		array<float>^ output = gcnew array<float>( channels * frames );
+
+		pin_ptr<float> pinnedInput = &input[0];
+		pin_ptr<float> pinnedPlanes = &planes[0];
+		pin_ptr<float> pinnedOutput = &output[0];
+
+		array<IntPtr>^ pointers = gcnew array<IntPtr>( channels );
+		for( int c = 0; c < channels; c++ )
+			pointers[c] = IntPtr( pinnedPlanes + c * frames );
+
+		AudioKernels::Deinterleave( IntPtr( pinnedInput ), channels, frames, pointers );
+		for( int c = 0; c < channels; c++ )
+			ASSERT_EQ( input[channels * 7 + c], planes[c * frames + 7] );
+
+		AudioKernels::Interleave( pointers, channels, frames, IntPtr( pinnedOutput ) );
+		for( int i = 0; i < input->Length; i++ )
+			ASSERT_EQ( input[i], output[i] );
+	}
+}
+
+TEST( AudioKernelsTests, BiquadMatchesReferenceAcrossCalls )
+{
+	for each( int channels in ChannelCounts() )
+	{
+		const int frames = 50;
+		array<float>^ input = Noise( channels * frames * 2, channels );
+		array<float>^ output = safe_cast<array<float>^>( input->Clone() );
+
+		BiquadFilter^ filter = gcnew BiquadFilter( channels, 2 );
+		filter->SetLowPass( 0, 48000.0f, 1000.0f, 0.707f );
+		filter->SetPeaking( 1, 48000.0f, 4000.0f, 1.0f, 6.0f );
+
+		// split across two calls to check that state carries over
+		pin_ptr<float> pinned = &output[0];
+		filter->Process( IntPtr( pinned ), frames );
+		filter->Process( IntPtr( pinned + channels * frames ), frames );
+
+		// derive both sections from the cookbook formulas, so only the kernel is under test
+		float b[2][5];
+		double w0 = 2.0 * Math::PI * 1000.0 / 48000.0;
+		double alpha = Math::Sin( w0 ) / (2.0 * 0.707);
+		double a0 = 1.0 + alpha;
+		b[0][0] = static_cast<float>( (1.0 - Math::Cos( w0 )) / 2.0 / a0 );
+		b[0][1] = static_cast<float>( (1.0 - Math::Cos( w0 )) / a0 );
+		b[0][2] = b[0][0];
+		b[0][3] = static_cast<float>( -2.0 * Math::Cos( w0 ) / a0 );
+		b[0][4] = static_cast<float>( (1.0 - alpha) / a0 );
+
+		double a = Math::Pow( 10.0, 6.0 / 40.0 );
+		w0 = 2.0 * Math::PI * 4000.0 / 48000.0;
+		alpha = Math::Sin( w0 ) / 2.0;
+		a0 = 1.0 + alpha / a;
+		b[1][0] = static_cast<float>( (1.0 + alpha * a) / a0 );
+		b[1][1] = static_cast<float>( -2.0 * Math::Cos( w0 ) / a0 );
+		b[1][2] = static_cast<float>( (1.0 - alpha * a) / a0 );
+		b[1][3] = b[1][1];
+		b[1][4] = static_cast<float>( (1.0 - alpha / a) / a0 );
+
+		array<float>^ expected = safe_cast<array<float>^>( input->Clone() );
+		for( int stage = 0; stage < 2; stage++ )
+		{
+			for( int c = 0; c < channels; c++ )
+			{
+				float z1 = 0.0f, z2 = 0.0f;
+				for( int frame = 0; frame < frames * 2; frame++ )
+				{
+					float x = expected[frame * channels + c];
+					float y = b[stage][0] * x + z1;
+					z1 = b[stage][1] * x - b[stage][3] * y + z2;
+					z2 = b[stage][2] * x - b[stage][4] * y;
+					expected[frame * channels + c] = y;
+				}
+			}
+		}
+
+		for( int i = 0; i < output->Length; i++ )
+			ASSERT_NEAR( expected[i], output[i], 1e-4f );
+
+		delete filter;
+	}
+}
+
+TEST( AudioKernelsTests, BiquadRejectsInvalidDesigns )
+{
+	BiquadFilter^ filter = gcnew BiquadFilter( 2, 1 );
+
+	ASSERT_MANAGED_THROW( filter->SetLowPass( 0, 0.0f, 1000.0f, 0.707f ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( filter->SetLowPass( 0, 48000.0f, 0.0f, 0.707f ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( filter->SetLowPass( 0, 48000.0f, 24000.0f, 0.707f ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( filter->SetHighPass( 0, 48000.0f, 1000.0f, 0.0f ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( filter->SetHighPass( 0, 48000.0f, Single::NaN, 0.707f ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( filter->SetPeaking( 0, -48000.0f, 1000.0f, 1.0f, 6.0f ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( filter->SetPeaking( 0, 48000.0f, 1000.0f, -1.0f, 6.0f ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( filter->SetPeaking( 1, 48000.0f, 1000.0f, 1.0f, 6.0f ), ArgumentOutOfRangeException );
+
+	filter->SetLowPass( 0, 48000.0f, 23999.0f, 0.707f );
+	delete filter;
+}
+
+TEST( AudioKernelsTests, DelayLineEchoesAfterDelay )
+{
+	for each( int channels in ChannelCounts() )
+	{
+		const int frames = 40;
+		const int delay = 13;
+		array<float>^ samples = gcnew array<float>( channels * frames );
+		for( int c = 0; c < channels; c++ )
+			samples[c] = 1.0f;
+
+		DelayLine^ line = gcnew DelayLine( channels, 16 );
+		pin_ptr<float> pinned = &samples[0];
+		line->Process( IntPtr( pinned ), frames, delay, 0.5f, 1.0f, 1.0f );
+
+		for( int frame = 0; frame < frames; frame++ )
+		{
+			float expected = 0.0f;
+			if( frame == 0 )
+				expected = 1.0f;
+			else if( frame % delay == 0 )
+				expected = static_cast<float>( Math::Pow( 0.5, frame / delay - 1 ) );
+
+			for( int c = 0; c < channels; c++ )
+				ASSERT_FLOAT_EQ( expected, samples[frame * channels + c] );
+		}
+
+		ASSERT_MANAGED_THROW( line->Process( IntPtr( pinned ), frames, 17, 0.0f, 1.0f, 1.0f ), ArgumentOutOfRangeException );
+		delete line;
+	}
+}
@@ -0,0 +1,403 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <xapo.h>
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace SlimDX;
+using namespace SlimDX::XAPO;
+
+ref class PassThroughProcessor : BaseProcessor
+{
+public:
+	PassThroughProcessor( RegistrationProperties properties )
+		: BaseProcessor( properties )
+	{
+	}
+
+	virtual Result LockForProcess( array<LockParameter>^, array<LockParameter>^ ) override
+	{
+		return Result( S_OK );
+	}
+
+	virtual void Process( array<BufferParameter>^ inputParameters, array<BufferParameter>^ outputParameters, bool ) override
+	{
+		for( int i = 0; i < outputParameters->Length; i++ )
+		{
+			outputParameters[i].Flags = inputParameters[i].Flags;
+			outputParameters[i].ValidFrameCount = inputParameters[i].ValidFrameCount;
+		}
+
+		++Quanta;
+		LastInput = inputParameters;
+		LastOutput = outputParameters;
+	}
+
+	int Quanta;
+	array<BufferParameter>^ LastInput;
+	array<BufferParameter>^ LastOutput;
+};
+
+static RegistrationProperties PassThroughProperties()
+{
+	RegistrationProperties properties;
+	properties.ClassId = Guid::NewGuid();
+	properties.FriendlyName = "PassThrough";
+	properties.CopyrightInfo = "None";
+	properties.Flags = PropertyFlags::Default;
+	properties.MajorVersion = 1;
+	properties.MinInputBufferCount = 1;
+	properties.MaxInputBufferCount = 1;
+	properties.MinOutputBufferCount = 1;
+	properties.MaxOutputBufferCount = 1;
+
+	return properties;
+}
+
+static void LockPassThrough( IXAPO *xapo, WAVEFORMATEX *format )
+{
+	format->wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+	format->nChannels = 2;
+	format->nSamplesPerSec = 48000;
+	format->wBitsPerSample = 32;
+	format->nBlockAlign = 8;
+	format->nAvgBytesPerSec = 48000 * 8;
+	format->cbSize = 0;
+
+	XAPO_LOCKFORPROCESS_BUFFER_PARAMETERS lock = { format, 240 };
+	ASSERT_EQ( S_OK, xapo->LockForProcess( 1, &lock, 1, &lock ) );
+}
+
+TEST( BaseProcessorTests, ProcessReusesParameterArrays )
+{
+	PassThroughProcessor^ processor = gcnew PassThroughProcessor( PassThroughProperties() );
+	IXAPO *xapo = reinterpret_cast<IXAPO*>( processor->ComPointer.ToPointer() );
+
+	WAVEFORMATEX format;
+	LockPassThrough( xapo, &format );
+
+	float samples[480] = { 0 };
+	XAPO_PROCESS_BUFFER_PARAMETERS input = { samples, XAPO_BUFFER_VALID, 240 };
+	XAPO_PROCESS_BUFFER_PARAMETERS output = { samples, XAPO_BUFFER_SILENT, 0 };
+
+	xapo->Process( 1, &input, 1, &output, TRUE );
+	array<BufferParameter>^ firstInput = processor->LastInput;
+	array<BufferParameter>^ firstOutput = processor->LastOutput;
+
+	xapo->Process( 1, &input, 1, &output, TRUE );
+	ASSERT_EQ( 2, processor->Quanta );
+	ASSERT_TRUE( Object::ReferenceEquals( firstInput, processor->LastInput ) );
+	ASSERT_TRUE( Object::ReferenceEquals( firstOutput, processor->LastOutput ) );
+	ASSERT_EQ( IntPtr( samples ), processor->LastInput[0].Buffer );
+
+	delete processor;
+}
+
+TEST( BaseProcessorTests, ProcessWritesOutputParametersBack )
+{
+	PassThroughProcessor^ processor = gcnew PassThroughProcessor( PassThroughProperties() );
+	IXAPO *xapo = reinterpret_cast<IXAPO*>( processor->ComPointer.ToPointer() );
+
+	WAVEFORMATEX format;
+	LockPassThrough( xapo, &format );
+
+	float samples[480] = { 0 };
+	XAPO_PROCESS_BUFFER_PARAMETERS input = { samples, XAPO_BUFFER_VALID, 240 };
+	XAPO_PROCESS_BUFFER_PARAMETERS output = { samples, XAPO_BUFFER_SILENT, 0 };
+
+	xapo->Process( 1, &input, 1, &output, TRUE );
+	ASSERT_EQ( XAPO_BUFFER_VALID, output.BufferFlags );
+	ASSERT_EQ( 240u, output.ValidFrameCount );
+
+	delete processor;
+}
+
+delegate void Quantum();
+
+// The budget only absorbs what other threads allocate meanwhile; a single object per quantum would use it up many times over.
+static const Int64 AllocationBudget = 16 * 1024;
+
+static void ExpectNoAllocation( Quantum^ quantum, int count )
+{
+	// warm up so any one-time JIT or lazy initialization is out of the way
+	quantum();
+
+	GC::Collect();
+	GC::WaitForPendingFinalizers();
+	GC::Collect();
+
+	int collections = GC::CollectionCount( 0 );
+	Int64 before = GC::GetTotalMemory( false );
+
+	for( int i = 0; i < count; i++ )
+		quantum();
+
+	ASSERT_EQ( collections, GC::CollectionCount( 0 ) );
+	ASSERT_LT( GC::GetTotalMemory( false ) - before, AllocationBudget );
+}
+
+ref class ProcessLoop
+{
+public:
+	IXAPO *Xapo;
+	IXAPOParameters *Parameters;
+	XAPO_PROCESS_BUFFER_PARAMETERS *Input;
+	XAPO_PROCESS_BUFFER_PARAMETERS *Output;
+	float Gain;
+
+	void Run()
+	{
+		// parameters usually change between quanta, so send a block every time
+		if( Parameters != NULL )
+		{
+			float gain = Gain;
+			Parameters->SetParameters( &gain, sizeof( float ) );
+		}
+
+		Xapo->Process( 1, Input, 1, Output, TRUE );
+	}
+};
+
+ref class GainProcessor : ParameterizedProcessor
+{
+public:
+	GainProcessor( RegistrationProperties properties, DataStream^ parameterBlocks )
+		: ParameterizedProcessor( properties, parameterBlocks, static_cast<int>( sizeof( float ) ), false )
+	{
+	}
+
+	virtual Result LockForProcess( array<LockParameter>^, array<LockParameter>^ ) override
+	{
+		return Result( S_OK );
+	}
+
+	virtual void OnSetParameters( DataStream^ parameters ) override
+	{
+		LastSet = parameters->Read<float>();
+	}
+
+	virtual void Process( array<BufferParameter>^ inputParameters, array<BufferParameter>^ outputParameters, bool ) override
+	{
+		float gain = BeginProcessParameters()->Read<float>();
+		EndProcess();
+
+		float *samples = reinterpret_cast<float*>( inputParameters[0].Buffer.ToPointer() );
+		for( int i = 0; i < inputParameters[0].ValidFrameCount * 2; i++ )
+			samples[i] *= gain;
+
+		outputParameters[0].Flags = inputParameters[0].Flags;
+		outputParameters[0].ValidFrameCount = inputParameters[0].ValidFrameCount;
+
+		++Quanta;
+		LastGain = gain;
+	}
+
+	int Quanta;
+	float LastSet;
+	float LastGain;
+};
+
+ref class FilterProcessor : BaseProcessor
+{
+public:
+	FilterProcessor( RegistrationProperties properties )
+		: BaseProcessor( properties )
+	{
+		// the same buffer goes round every quantum, so keep the gain at or below one
+		Filter = gcnew BiquadFilter( 2, 2 );
+		Filter->SetLowPass( 0, 48000.0f, 2000.0f, 0.7f );
+		Filter->SetHighPass( 1, 48000.0f, 50.0f, 0.7f );
+		Delay = gcnew DelayLine( 2, 4800 );
+	}
+
+	virtual Result LockForProcess( array<LockParameter>^, array<LockParameter>^ ) override
+	{
+		return Result( S_OK );
+	}
+
+	virtual void Process( array<BufferParameter>^ inputParameters, array<BufferParameter>^ outputParameters, bool ) override
+	{
+		Filter->Process( inputParameters[0].Buffer, inputParameters[0].ValidFrameCount );
+		Delay->Process( inputParameters[0].Buffer, inputParameters[0].ValidFrameCount, 2400, 0.4f, 0.5f, 0.5f );
+
+		outputParameters[0].Flags = inputParameters[0].Flags;
+		outputParameters[0].ValidFrameCount = inputParameters[0].ValidFrameCount;
+		++Quanta;
+	}
+
+	BiquadFilter^ Filter;
+	DelayLine^ Delay;
+	int Quanta;
+};
+
+TEST( BaseProcessorTests, ProcessDoesNotAllocatePerQuantum )
+{
+	PassThroughProcessor^ processor = gcnew PassThroughProcessor( PassThroughProperties() );
+	IXAPO *xapo = reinterpret_cast<IXAPO*>( processor->ComPointer.ToPointer() );
+
+	WAVEFORMATEX format;
+	LockPassThrough( xapo, &format );
+
+	float samples[480] = { 0 };
+	XAPO_PROCESS_BUFFER_PARAMETERS input = { samples, XAPO_BUFFER_VALID, 240 };
+	XAPO_PROCESS_BUFFER_PARAMETERS output = { samples, XAPO_BUFFER_SILENT, 0 };
+
+	ProcessLoop^ loop = gcnew ProcessLoop();
+	loop->Xapo = xapo;
+	loop->Input = &input;
+	loop->Output = &output;
+
+	// ten minutes of 5ms quanta
+	ExpectNoAllocation( gcnew Quantum( loop, &ProcessLoop::Run ), 120000 );
+	ASSERT_EQ( 120001, processor->Quanta );
+
+	delete processor;
+}
+
+TEST( BaseProcessorTests, ParameterizedProcessDoesNotAllocatePerQuantum )
+{
+	DataStream^ blocks = gcnew DataStream( 3 * sizeof( float ), true, true );
+	for( int i = 0; i < 3; i++ )
+		blocks->Write( 1.0f );
+	blocks->Position = 0;
+
+	GainProcessor^ processor = gcnew GainProcessor( PassThroughProperties(), blocks );
+	IUnknown *unknown = reinterpret_cast<IUnknown*>( processor->ComPointer.ToPointer() );
+
+	IXAPO *xapo;
+	IXAPOParameters *parameters;
+	ASSERT_EQ( S_OK, unknown->QueryInterface( __uuidof( IXAPO ), reinterpret_cast<void**>( &xapo ) ) );
+	ASSERT_EQ( S_OK, unknown->QueryInterface( __uuidof( IXAPOParameters ), reinterpret_cast<void**>( &parameters ) ) );
+
+	WAVEFORMATEX format;
+	LockPassThrough( xapo, &format );
+
+	float samples[480];
+	for( int i = 0; i < 480; i++ )
+		samples[i] = 1.0f;
+	XAPO_PROCESS_BUFFER_PARAMETERS input = { samples, XAPO_BUFFER_VALID, 240 };
+	XAPO_PROCESS_BUFFER_PARAMETERS output = { samples, XAPO_BUFFER_SILENT, 0 };
+
+	ProcessLoop^ loop = gcnew ProcessLoop();
+	loop->Xapo = xapo;
+	loop->Parameters = parameters;
+	loop->Input = &input;
+	loop->Output = &output;
+	loop->Gain = 1.0f;
+
+	// both the parameter update and the read of the current block on the audio thread must stay off the heap
+	ExpectNoAllocation( gcnew Quantum( loop, &ProcessLoop::Run ), 120000 );
+	ASSERT_EQ( 120001, processor->Quanta );
+	ASSERT_EQ( 1.0f, processor->LastSet );
+	ASSERT_EQ( 1.0f, processor->LastGain );
+
+	loop->Gain = 0.5f;
+	loop->Run();
+	ASSERT_EQ( 0.5f, processor->LastSet );
+	ASSERT_EQ( 0.5f, processor->LastGain );
+	ASSERT_EQ( 0.5f, samples[0] );
+
+	parameters->Release();
+	xapo->Release();
+	delete processor;
+	delete blocks;
+}
+
+TEST( BaseProcessorTests, FilterAndDelayDoNotAllocatePerQuantum )
+{
+	FilterProcessor^ processor = gcnew FilterProcessor( PassThroughProperties() );
+	IXAPO *xapo = reinterpret_cast<IXAPO*>( processor->ComPointer.ToPointer() );
+
+	WAVEFORMATEX format;
+	LockPassThrough( xapo, &format );
+
+	float samples[480];
+	for( int i = 0; i < 480; i++ )
+		samples[i] = ( i / 2 ) % 48 < 24 ? 0.25f : -0.25f;
+	XAPO_PROCESS_BUFFER_PARAMETERS input = { samples, XAPO_BUFFER_VALID, 240 };
+	XAPO_PROCESS_BUFFER_PARAMETERS output = { samples, XAPO_BUFFER_SILENT, 0 };
+
+	ProcessLoop^ loop = gcnew ProcessLoop();
+	loop->Xapo = xapo;
+	loop->Input = &input;
+	loop->Output = &output;
+
+	ExpectNoAllocation( gcnew Quantum( loop, &ProcessLoop::Run ), 120000 );
+	ASSERT_EQ( 120001, processor->Quanta );
+
+	delete processor->Filter;
+	delete processor->Delay;
+	delete processor;
+}
+
+TEST( BaseProcessorTests, ParameterizedProcessorReadsFromChannel )
+{
+	DataStream^ blocks = gcnew DataStream( 3 * sizeof( float ), true, true );
+	for( int i = 0; i < 3; i++ )
+		blocks->Write( 1.0f );
+	blocks->Position = 0;
+
+	GainProcessor^ processor = gcnew GainProcessor( PassThroughProperties(), blocks );
+	ParameterChannel<float>^ channel = gcnew ParameterChannel<float>( 1.0f );
+	processor->UseParameterChannel( channel );
+	ASSERT_MANAGED_THROW( processor->UseParameterChannel( gcnew ParameterChannel<double>() ), ArgumentException );
+
+	IUnknown *unknown = reinterpret_cast<IUnknown*>( processor->ComPointer.ToPointer() );
+	IXAPO *xapo;
+	IXAPOParameters *parameters;
+	ASSERT_EQ( S_OK, unknown->QueryInterface( __uuidof( IXAPO ), reinterpret_cast<void**>( &xapo ) ) );
+	ASSERT_EQ( S_OK, unknown->QueryInterface( __uuidof( IXAPOParameters ), reinterpret_cast<void**>( &parameters ) ) );
+
+	WAVEFORMATEX format;
+	LockPassThrough( xapo, &format );
+
+	float samples[480] = { 0 };
+	XAPO_PROCESS_BUFFER_PARAMETERS input = { samples, XAPO_BUFFER_VALID, 240 };
+	XAPO_PROCESS_BUFFER_PARAMETERS output = { samples, XAPO_BUFFER_SILENT, 0 };
+
+	// written straight to the channel from the game thread
+	channel->Write( 0.25f );
+	xapo->Process( 1, &input, 1, &output, TRUE );
+	ASSERT_EQ( 0.25f, processor->LastGain );
+	ASSERT_TRUE( processor->ParametersChanged );
+
+	// set through the engine, which lands in the same channel
+	float gain = 0.5f;
+	parameters->SetParameters( &gain, sizeof( float ) );
+	ASSERT_EQ( 0.5f, processor->LastSet );
+	ASSERT_EQ( 2, channel->WrittenCount );
+
+	xapo->Process( 1, &input, 1, &output, TRUE );
+	ASSERT_EQ( 0.5f, processor->LastGain );
+	xapo->Process( 1, &input, 1, &output, TRUE );
+	ASSERT_FALSE( processor->ParametersChanged );
+	ASSERT_EQ( 2, channel->AppliedCount );
+
+	parameters->Release();
+	xapo->Release();
+	delete processor;
+	delete channel;
+}
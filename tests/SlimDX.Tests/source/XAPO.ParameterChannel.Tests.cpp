@@ -0,0 +1,227 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::Threading;
+using namespace SlimDX;
+using namespace SlimDX::XAPO;
+
+value class EchoParameters
+{
+public:
+	int Sequence;
+	float Delay;
+	float Feedback;
+	int Check;
+};
+
+static EchoParameters MakeParameters( int sequence )
+{
+	EchoParameters parameters;
+	parameters.Sequence = sequence;
+	parameters.Delay = sequence * 0.5f;
+	parameters.Feedback = 0.25f;
+	parameters.Check = ~sequence;
+
+	return parameters;
+}
+
+TEST( ParameterChannelTests, InitialValueIsCurrent )
+{
+	ParameterChannel<EchoParameters>^ channel = gcnew ParameterChannel<EchoParameters>( MakeParameters( 7 ) );
+	ASSERT_FALSE( channel->Update() );
+	ASSERT_EQ( 7, channel->Current.Sequence );
+
+	delete channel;
+}
+
+TEST( ParameterChannelTests, UpdatePicksUpLatestWrite )
+{
+	ParameterChannel<EchoParameters>^ channel = gcnew ParameterChannel<EchoParameters>();
+	channel->Write( MakeParameters( 1 ) );
+	ASSERT_EQ( 0, channel->Current.Sequence );
+
+	ASSERT_TRUE( channel->Update() );
+	ASSERT_EQ( 1, channel->Current.Sequence );
+	ASSERT_FALSE( channel->Update() );
+	ASSERT_EQ( 1, channel->Current.Sequence );
+
+	delete channel;
+}
+
+TEST( ParameterChannelTests, WritesBetweenUpdatesAreCoalesced )
+{
+	ParameterChannel<EchoParameters>^ channel = gcnew ParameterChannel<EchoParameters>();
+	for( int i = 1; i <= 5; i++ )
+		channel->Write( MakeParameters( i ) );
+
+	ASSERT_TRUE( channel->Update() );
+	ASSERT_EQ( 5, channel->Current.Sequence );
+	ASSERT_EQ( 5, channel->WrittenCount );
+	ASSERT_EQ( 1, channel->AppliedCount );
+	ASSERT_EQ( 4, channel->CoalescedCount );
+	ASSERT_EQ( 0, channel->DroppedCount );
+
+	channel->ResetStatistics();
+	ASSERT_EQ( 0, channel->WrittenCount );
+
+	delete channel;
+}
+
+ref class ChannelProducer
+{
+public:
+	ParameterChannel<EchoParameters>^ Channel;
+	int Count;
+
+	void Run()
+	{
+		for( int i = 1; i <= Count; i++ )
+			Channel->Write( MakeParameters( i ) );
+	}
+};
+
+TEST( ParameterChannelTests, ConcurrentUpdatesAreNeverTorn )
+{
+	ParameterChannel<EchoParameters>^ channel = gcnew ParameterChannel<EchoParameters>();
+	ChannelProducer^ producer = gcnew ChannelProducer();
+	producer->Channel = channel;
+	producer->Count = 200000;
+
+	Thread^ thread = gcnew Thread( gcnew ThreadStart( producer, &ChannelProducer::Run ) );
+	thread->Start();
+
+	int last = 0;
+	while( last < producer->Count )
+	{
+		channel->Update();
+		EchoParameters current = channel->Current;
+
+		ASSERT_EQ( ~current.Sequence, current.Check );
+		ASSERT_FLOAT_EQ( current.Sequence * 0.5f, current.Delay );
+		ASSERT_GE( current.Sequence, last );
+		last = current.Sequence;
+	}
+
+	thread->Join();
+	ASSERT_EQ( producer->Count, channel->WrittenCount );
+	ASSERT_EQ( channel->WrittenCount, channel->AppliedCount + channel->CoalescedCount );
+
+	delete channel;
+}
+
+TEST( ParameterChannelTests, TryWritePublishesWhenUncontended )
+{
+	ParameterChannel<EchoParameters>^ channel = gcnew ParameterChannel<EchoParameters>();
+	ASSERT_TRUE( channel->TryWrite( MakeParameters( 3 ) ) );
+	ASSERT_TRUE( channel->Update() );
+	ASSERT_EQ( 3, channel->Current.Sequence );
+	ASSERT_EQ( 1, channel->WrittenCount );
+	ASSERT_EQ( 0, channel->DroppedCount );
+
+	delete channel;
+}
+
+ref class TryWriteProducer
+{
+public:
+	ParameterChannel<EchoParameters>^ Channel;
+	int Count;
+	int Published;
+	int Dropped;
+
+	void Run()
+	{
+		for( int i = 1; i <= Count; i++ )
+		{
+			if( Channel->TryWrite( MakeParameters( i ) ) )
+				Published++;
+			else
+				Dropped++;
+		}
+	}
+};
+
+TEST( ParameterChannelTests, ContendedTryWritesAreCountedAsDropped )
+{
+	ParameterChannel<EchoParameters>^ channel = gcnew ParameterChannel<EchoParameters>();
+
+	array<TryWriteProducer^>^ producers = gcnew array<TryWriteProducer^>( 4 );
+	array<Thread^>^ threads = gcnew array<Thread^>( producers->Length );
+	for( int i = 0; i < producers->Length; i++ )
+	{
+		producers[i] = gcnew TryWriteProducer();
+		producers[i]->Channel = channel;
+		producers[i]->Count = 50000;
+		threads[i] = gcnew Thread( gcnew ThreadStart( producers[i], &TryWriteProducer::Run ) );
+		threads[i]->Start();
+	}
+
+	// every update the processor sees is whole, however the writers collide
+	for( int i = 0; i < 10000; i++ )
+	{
+		channel->Update();
+		EchoParameters current = channel->Current;
+		ASSERT_EQ( ~current.Sequence, current.Check );
+	}
+
+	Int64 published = 0;
+	Int64 dropped = 0;
+	for( int i = 0; i < producers->Length; i++ )
+	{
+		threads[i]->Join();
+		published += producers[i]->Published;
+		dropped += producers[i]->Dropped;
+	}
+
+	ASSERT_EQ( published, channel->WrittenCount );
+	ASSERT_EQ( dropped, channel->DroppedCount );
+	ASSERT_EQ( 200000, channel->WrittenCount + channel->DroppedCount );
+
+	delete channel;
+}
+
+value class NamedParameters
+{
+public:
+	String^ Name;
+	float Value;
+};
+
+TEST( ParameterChannelTests, RejectsTypesWithReferences )
+{
+	ASSERT_MANAGED_THROW( gcnew ParameterChannel<NamedParameters>(), ArgumentException );
+}
+
+TEST( ParameterChannelTests, ThrowsAfterDispose )
+{
+	ParameterChannel<EchoParameters>^ channel = gcnew ParameterChannel<EchoParameters>();
+	delete channel;
+
+	ASSERT_MANAGED_THROW( channel->Update(), ObjectDisposedException );
+	ASSERT_MANAGED_THROW( channel->TryWrite( MakeParameters( 1 ) ), ObjectDisposedException );
+	ASSERT_MANAGED_THROW( channel->Current, ObjectDisposedException );
+}
@@ -0,0 +1,130 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace SlimDX;
+using namespace SlimDX::XAudio2;
+
+TEST( AudioBufferPoolTests, RentHandsOutWritablePooledMemory )
+{
+	AudioBufferPool^ pool = gcnew AudioBufferPool( 2, 4096 );
+	AudioBuffer^ buffer = pool->Rent();
+
+	ASSERT_TRUE( buffer != nullptr );
+	ASSERT_EQ( 4096, buffer->AudioBytes );
+	ASSERT_TRUE( buffer->AudioData->CanWrite );
+	ASSERT_EQ( 4096, buffer->AudioData->Length );
+	ASSERT_EQ( 1, pool->InUseCount );
+
+	delete pool;
+}
+
+TEST( AudioBufferPoolTests, RentFailsWhenExhausted )
+{
+	AudioBufferPool^ pool = gcnew AudioBufferPool( 2, 256 );
+	AudioBuffer^ first = pool->Rent();
+	AudioBuffer^ second = pool->Rent();
+
+	ASSERT_FALSE( Object::ReferenceEquals( first, second ) );
+	ASSERT_TRUE( pool->Rent() == nullptr );
+	ASSERT_EQ( 2, pool->RentCount );
+	ASSERT_EQ( 1, pool->FailedRentCount );
+	ASSERT_EQ( 2, pool->PeakInUseCount );
+
+	pool->Return( first );
+	ASSERT_EQ( 1, pool->InUseCount );
+	ASSERT_TRUE( Object::ReferenceEquals( first, pool->Rent() ) );
+
+	delete pool;
+}
+
+TEST( AudioBufferPoolTests, ReturnRejectsForeignAndDoubleReturns )
+{
+	AudioBufferPool^ pool = gcnew AudioBufferPool( 1, 256 );
+	AudioBufferPool^ other = gcnew AudioBufferPool( 1, 256 );
+	AudioBuffer^ buffer = pool->Rent();
+
+	ASSERT_MANAGED_THROW( other->Return( buffer ), ArgumentException );
+	pool->Return( buffer );
+	ASSERT_MANAGED_THROW( pool->Return( buffer ), InvalidOperationException );
+
+	delete other;
+	delete pool;
+}
+
+TEST( AudioBufferPoolTests, SubmittedBufferRecyclesAfterLastCompletion )
+{
+	AudioBufferPool^ pool = gcnew AudioBufferPool( 1, 256 );
+	AudioBuffer^ buffer = pool->Rent();
+
+	// two voices playing the same buffer
+	pool->AddSubmission( buffer );
+	pool->AddSubmission( buffer );
+	ASSERT_MANAGED_THROW( pool->Return( buffer ), InvalidOperationException );
+
+	pool->CompleteSubmission( buffer );
+	ASSERT_EQ( 1, pool->InUseCount );
+
+	pool->CompleteSubmission( buffer );
+	ASSERT_EQ( 0, pool->InUseCount );
+	ASSERT_TRUE( Object::ReferenceEquals( buffer, pool->Rent() ) );
+
+	delete pool;
+}
+
+TEST( AudioBufferPoolTests, CancelledSubmissionKeepsBufferRented )
+{
+	AudioBufferPool^ pool = gcnew AudioBufferPool( 1, 256 );
+	AudioBuffer^ buffer = pool->Rent();
+
+	pool->AddSubmission( buffer );
+	pool->CancelSubmission( buffer );
+	ASSERT_EQ( 1, pool->InUseCount );
+
+	pool->Return( buffer );
+	ASSERT_EQ( 0, pool->InUseCount );
+
+	delete pool;
+}
+
+TEST( AudioBufferPoolTests, DisposeWaitsForSubmittedBuffers )
+{
+	AudioBufferPool^ pool = gcnew AudioBufferPool( 2, 256 );
+	AudioBuffer^ submitted = pool->Rent();
+	AudioBuffer^ rented = pool->Rent();
+	pool->AddSubmission( submitted );
+
+	delete pool;
+	ASSERT_MANAGED_THROW( pool->Rent(), ObjectDisposedException );
+
+	// a voice is still reading the submitted buffer, so the memory has to stay; the merely rented one does not count
+	DataStream^ view = safe_cast<DataStream^>( submitted->AudioData )->Slice( 0, 256 );
+	delete view;
+
+	pool->CompleteSubmission( submitted );
+	ASSERT_MANAGED_THROW( safe_cast<DataStream^>( submitted->AudioData )->Slice( 0, 256 ), ObjectDisposedException );
+	ASSERT_MANAGED_THROW( safe_cast<DataStream^>( rented->AudioData )->Slice( 0, 256 ), ObjectDisposedException );
+}
@@ -0,0 +1,368 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <xapo.h>
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::IO;
+using namespace SlimDX;
+using namespace SlimDX::Multimedia;
+using namespace SlimDX::XAPO;
+using namespace SlimDX::XAudio2;
+
+static WaveFormat^ MakeFormat( WaveFormatTag tag, int rate, int channels, int bits )
+{
+	WaveFormat^ format = gcnew WaveFormat();
+	format->FormatTag = tag;
+	format->SamplesPerSecond = rate;
+	format->Channels = static_cast<short>( channels );
+	format->BitsPerSample = static_cast<short>( bits );
+	format->BlockAlignment = static_cast<short>( channels * bits / 8 );
+	format->AverageBytesPerSecond = rate * format->BlockAlignment;
+	return format;
+}
+
+static AudioBuffer^ MakeBuffer( array<float>^ samples )
+{
+	AudioBuffer^ buffer = gcnew AudioBuffer();
+	buffer->AudioData = gcnew DataStream( samples, true, false );
+	buffer->AudioBytes = samples->Length * 4;
+	return buffer;
+}
+
+static array<float>^ Ramp( int frames )
+{
+	array<float>^ samples = gcnew array<float>( frames );
+	for( int i = 0; i < frames; i++ )
+		samples[i] = ( i + 1 ) / static_cast<float>( frames );
+	return samples;
+}
+
+static array<float>^ RenderAll( OfflineEngine^ engine, int frames, int channels )
+{
+	DataStream^ output = gcnew DataStream( frames * channels * 4, true, true );
+	engine->Render( output, frames );
+	EXPECT_EQ( output->Length, output->Position );
+
+	output->Position = 0;
+	return output->ReadRange<float>( frames * channels );
+}
+
+ref class CallbackCounter
+{
+public:
+	int BufferStarts;
+	int BufferEnds;
+	int LoopEnds;
+	int StreamEnds;
+
+	void OnBufferStart( Object^, ContextEventArgs^ ) { BufferStarts++; }
+	void OnBufferEnd( Object^, ContextEventArgs^ ) { BufferEnds++; }
+	void OnLoopEnd( Object^, ContextEventArgs^ ) { LoopEnds++; }
+	void OnStreamEnd( Object^, EventArgs^ ) { StreamEnds++; }
+
+	void Attach( OfflineSourceVoice^ voice )
+	{
+		voice->BufferStart += gcnew EventHandler<ContextEventArgs^>( this, &CallbackCounter::OnBufferStart );
+		voice->BufferEnd += gcnew EventHandler<ContextEventArgs^>( this, &CallbackCounter::OnBufferEnd );
+		voice->LoopEnd += gcnew EventHandler<ContextEventArgs^>( this, &CallbackCounter::OnLoopEnd );
+		voice->StreamEnd += gcnew EventHandler( this, &CallbackCounter::OnStreamEnd );
+	}
+};
+
+ref class GainProcessor : BaseProcessor
+{
+public:
+	GainProcessor( float gain )
+		: BaseProcessor( GainProperties() ), Gain( gain )
+	{
+	}
+
+	virtual Result LockForProcess( array<LockParameter>^ inputParameters, array<LockParameter>^ ) override
+	{
+		Channels = inputParameters[0].Format->Channels;
+		return Result( S_OK );
+	}
+
+	virtual void Process( array<BufferParameter>^ inputParameters, array<BufferParameter>^, bool isEnabled ) override
+	{
+		Quanta++;
+		if( !isEnabled )
+			return;
+
+		float *samples = reinterpret_cast<float*>( inputParameters[0].Buffer.ToPointer() );
+		for( int i = 0; i < inputParameters[0].ValidFrameCount * Channels; i++ )
+			samples[i] *= Gain;
+	}
+
+	float Gain;
+	int Channels;
+	int Quanta;
+
+private:
+	static RegistrationProperties GainProperties()
+	{
+		RegistrationProperties properties;
+		properties.ClassId = Guid::NewGuid();
+		properties.FriendlyName = "Gain";
+		properties.CopyrightInfo = "None";
+		properties.Flags = PropertyFlags::InPlaceRequired | PropertyFlags::ChannelsMustMatch;
+		properties.MajorVersion = 1;
+		properties.MinInputBufferCount = 1;
+		properties.MaxInputBufferCount = 1;
+		properties.MinOutputBufferCount = 1;
+		properties.MaxOutputBufferCount = 1;
+		return properties;
+	}
+};
+
+TEST( OfflineEngineTests, MasteringVoiceAppliesVolume )
+{
+	OfflineEngine^ engine = gcnew OfflineEngine( 256 );
+	OfflineMasteringVoice^ mastering = gcnew OfflineMasteringVoice( engine, 1, 48000 );
+	OfflineSourceVoice^ source = gcnew OfflineSourceVoice( engine, MakeFormat( WaveFormatTag::Pcm, 48000, 1, 16 ) );
+
+	array<short>^ pcm = gcnew array<short>( 600 );
+	for( int i = 0; i < pcm->Length; i++ )
+		pcm[i] = 16384;
+
+	AudioBuffer^ buffer = gcnew AudioBuffer();
+	buffer->AudioData = gcnew DataStream( pcm, true, false );
+	buffer->AudioBytes = pcm->Length * 2;
+	source->SubmitSourceBuffer( buffer );
+	source->Start();
+	mastering->Volume = 0.5f;
+
+	array<float>^ output = RenderAll( engine, 1000, 1 );
+	ASSERT_EQ( 1000, engine->FramesRendered );
+	ASSERT_FLOAT_EQ( 0.25f, output[0] );
+	ASSERT_FLOAT_EQ( 0.25f, output[599] );
+
+	// a starved voice plays silence
+	ASSERT_EQ( 0.0f, output[600] );
+	ASSERT_EQ( 0.0f, output[999] );
+	ASSERT_EQ( 1000, source->State.SamplesPlayed );
+
+	delete engine;
+}
+
+TEST( OfflineEngineTests, OutputMatrixRoutesThroughSubmix )
+{
+	OfflineEngine^ engine = gcnew OfflineEngine( 128 );
+	OfflineMasteringVoice^ mastering = gcnew OfflineMasteringVoice( engine, 2, 48000 );
+	OfflineSubmixVoice^ submix = gcnew OfflineSubmixVoice( engine, 2, 48000 );
+	OfflineSourceVoice^ source = gcnew OfflineSourceVoice( engine, MakeFormat( WaveFormatTag::IeeeFloat, 48000, 1, 32 ) );
+
+	array<OfflineVoiceSend>^ sends = gcnew array<OfflineVoiceSend>( 1 );
+	sends[0] = OfflineVoiceSend( submix, VoiceSendFlags::None );
+	source->SetOutputVoices( sends );
+
+	array<float>^ matrix = gcnew array<float>( 2 );
+	matrix[0] = 0.25f;
+	matrix[1] = 0.75f;
+	source->SetOutputMatrix( submix, 1, 2, matrix );
+	ASSERT_FLOAT_EQ( 0.75f, source->GetOutputMatrix( submix, 1, 2 )[1] );
+
+	array<float>^ samples = gcnew array<float>( 128 );
+	for( int i = 0; i < samples->Length; i++ )
+		samples[i] = 0.5f;
+	source->SubmitSourceBuffer( MakeBuffer( samples ) );
+	source->Start();
+
+	array<float>^ output = RenderAll( engine, 128, 2 );
+	for( int i = 0; i < 128; i++ )
+	{
+		ASSERT_FLOAT_EQ( 0.125f, output[i * 2] );
+		ASSERT_FLOAT_EQ( 0.375f, output[i * 2 + 1] );
+	}
+
+	ASSERT_MANAGED_THROW( source->GetOutputMatrix( mastering, 1, 2 ), ArgumentException );
+
+	delete engine;
+}
+
+TEST( OfflineEngineTests, LoopsRegionAndRaisesCallbacks )
+{
+	OfflineEngine^ engine = gcnew OfflineEngine( 64 );
+	gcnew OfflineMasteringVoice( engine, 1, 44100 );
+	OfflineSourceVoice^ source = gcnew OfflineSourceVoice( engine, MakeFormat( WaveFormatTag::IeeeFloat, 44100, 1, 32 ) );
+
+	CallbackCounter^ counter = gcnew CallbackCounter();
+	counter->Attach( source );
+
+	AudioBuffer^ buffer = MakeBuffer( Ramp( 100 ) );
+	buffer->LoopCount = 2;
+	buffer->Flags = SlimDX::XAudio2::BufferFlags::EndOfStream;
+	source->SubmitSourceBuffer( buffer );
+	source->Start();
+
+	array<float>^ output = RenderAll( engine, 320, 1 );
+	ASSERT_FLOAT_EQ( output[0], output[100] );
+	ASSERT_FLOAT_EQ( output[99], output[299] );
+	ASSERT_EQ( 0.0f, output[300] );
+
+	ASSERT_EQ( 1, counter->BufferStarts );
+	ASSERT_EQ( 2, counter->LoopEnds );
+	ASSERT_EQ( 1, counter->BufferEnds );
+	ASSERT_EQ( 1, counter->StreamEnds );
+	ASSERT_EQ( 0, source->State.BuffersQueued );
+
+	delete engine;
+}
+
+TEST( OfflineEngineTests, FrequencyRatioConsumesFaster )
+{
+	OfflineEngine^ engine = gcnew OfflineEngine( 240 );
+	gcnew OfflineMasteringVoice( engine, 1, 48000 );
+	OfflineSourceVoice^ source = gcnew OfflineSourceVoice( engine, MakeFormat( WaveFormatTag::IeeeFloat, 48000, 1, 32 ) );
+
+	source->SubmitSourceBuffer( MakeBuffer( Ramp( 960 ) ) );
+	source->FrequencyRatio = 2.0f;
+	source->Start();
+
+	array<float>^ output = RenderAll( engine, 480, 1 );
+	ASSERT_FLOAT_EQ( 1.0f / 960, output[0] );
+	ASSERT_FLOAT_EQ( 3.0f / 960, output[1] );
+	ASSERT_EQ( 0, source->State.BuffersQueued );
+	ASSERT_EQ( 960, source->State.SamplesPlayed );
+
+	ASSERT_MANAGED_THROW( source->FrequencyRatio = 0.0f, ArgumentOutOfRangeException );
+
+	delete engine;
+}
+
+TEST( OfflineEngineTests, EffectChainRunsOnVoice )
+{
+	OfflineEngine^ engine = gcnew OfflineEngine( 128 );
+	OfflineMasteringVoice^ mastering = gcnew OfflineMasteringVoice( engine, 1, 48000 );
+	OfflineSourceVoice^ source = gcnew OfflineSourceVoice( engine, MakeFormat( WaveFormatTag::IeeeFloat, 48000, 1, 32 ) );
+
+	GainProcessor^ gain = gcnew GainProcessor( 2.0f );
+	array<EffectDescriptor>^ chain = gcnew array<EffectDescriptor>( 1 );
+	chain[0].Effect = gain;
+	chain[0].InitiallyStarted = true;
+	chain[0].OutputChannelCount = 1;
+	mastering->SetEffectChain( chain );
+	ASSERT_EQ( 1, gain->Channels );
+
+	array<float>^ samples = gcnew array<float>( 256 );
+	for( int i = 0; i < samples->Length; i++ )
+		samples[i] = 0.25f;
+	source->SubmitSourceBuffer( MakeBuffer( samples ) );
+	source->Start();
+
+	ASSERT_FLOAT_EQ( 0.5f, RenderAll( engine, 128, 1 )[0] );
+
+	mastering->DisableEffect( 0 );
+	ASSERT_FALSE( mastering->IsEffectEnabled( 0 ) );
+	ASSERT_FLOAT_EQ( 0.25f, RenderAll( engine, 128, 1 )[0] );
+	ASSERT_EQ( 2, gain->Quanta );
+
+	delete engine;
+}
+
+TEST( OfflineEngineTests, ReportsPerformanceData )
+{
+	OfflineEngine^ engine = gcnew OfflineEngine();
+	gcnew OfflineMasteringVoice( engine, 2, 48000 );
+	gcnew OfflineSubmixVoice( engine, 2, 48000 );
+	OfflineSourceVoice^ source = gcnew OfflineSourceVoice( engine, MakeFormat( WaveFormatTag::Pcm, 22050, 2, 16 ) );
+	gcnew OfflineSourceVoice( engine, MakeFormat( WaveFormatTag::Pcm, 22050, 2, 16 ) );
+	source->Start();
+
+	engine->Render( 4800 );
+
+	PerformanceData^ data = engine->PerformanceData;
+	ASSERT_EQ( 1, data->ActiveSourceVoiceCount );
+	ASSERT_EQ( 2, data->TotalSourceVoiceCount );
+	ASSERT_EQ( 1, data->ActiveSubmixVoiceCount );
+	ASSERT_TRUE( data->AudioCyclesSinceLastQuery > 0 );
+	ASSERT_TRUE( data->TotalCyclesSinceLastQuery >= data->AudioCyclesSinceLastQuery );
+	ASSERT_TRUE( data->MaximumCyclesPerQuantum >= data->MinimumCyclesPerQuantum );
+
+	PerformanceData^ voice = source->PerformanceData;
+	ASSERT_TRUE( voice->AudioCyclesSinceLastQuery > 0 );
+	ASSERT_TRUE( voice->AudioCyclesSinceLastQuery <= data->AudioCyclesSinceLastQuery );
+
+	// queries reset the counters
+	ASSERT_EQ( 0, engine->PerformanceData->AudioCyclesSinceLastQuery );
+
+	delete engine;
+}
+
+TEST( OfflineEngineTests, RenderToFileWritesFloatWave )
+{
+	OfflineEngine^ engine = gcnew OfflineEngine();
+	gcnew OfflineMasteringVoice( engine, 2, 48000 );
+
+	String^ fileName = Path::GetTempFileName();
+	try
+	{
+		engine->RenderToFile( fileName, 1000 );
+
+		array<Byte>^ file = File::ReadAllBytes( fileName );
+		ASSERT_EQ( 58 + 1000 * 8, file->Length );
+		ASSERT_EQ( 3, BitConverter::ToInt16( file, 20 ) );
+		ASSERT_EQ( 2, BitConverter::ToInt16( file, 22 ) );
+		ASSERT_EQ( 48000, BitConverter::ToInt32( file, 24 ) );
+		ASSERT_EQ( 8000, BitConverter::ToInt32( file, 54 ) );
+	}
+	finally
+	{
+		File::Delete( fileName );
+	}
+
+	delete engine;
+}
+
+TEST( OfflineEngineTests, ValidatesGraph )
+{
+	OfflineEngine^ engine = gcnew OfflineEngine();
+	ASSERT_MANAGED_THROW( engine->Render( 480 ), InvalidOperationException );
+
+	OfflineMasteringVoice^ mastering = gcnew OfflineMasteringVoice( engine, 2, 48000 );
+	ASSERT_MANAGED_THROW( gcnew OfflineMasteringVoice( engine, 2, 48000 ), InvalidOperationException );
+
+	OfflineSubmixVoice^ early = gcnew OfflineSubmixVoice( engine, 2, 48000, 0 );
+	OfflineSubmixVoice^ late = gcnew OfflineSubmixVoice( engine, 2, 48000, 1 );
+	OfflineSourceVoice^ source = gcnew OfflineSourceVoice( engine, MakeFormat( WaveFormatTag::Pcm, 48000, 2, 16 ) );
+
+	array<OfflineVoiceSend>^ sends = gcnew array<OfflineVoiceSend>( 1 );
+	sends[0] = OfflineVoiceSend( source, VoiceSendFlags::None );
+	ASSERT_MANAGED_THROW( early->SetOutputVoices( sends ), ArgumentException );
+	sends[0] = OfflineVoiceSend( early, VoiceSendFlags::None );
+	ASSERT_MANAGED_THROW( late->SetOutputVoices( sends ), ArgumentException );
+	sends[0] = OfflineVoiceSend( late, VoiceSendFlags::None );
+	early->SetOutputVoices( sends );
+
+	// removing a voice removes the sends that target it
+	delete late;
+	ASSERT_MANAGED_THROW( early->GetOutputMatrix( late, 2, 2 ), ArgumentException );
+	ASSERT_MANAGED_THROW( late->Volume = 0.5f, ObjectDisposedException );
+
+	delete engine;
+	ASSERT_TRUE( mastering->Engine == nullptr );
+}
@@ -0,0 +1,494 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <xaudio2.h>
+#include <vcclr.h>
+
+#include "IXAudio2Mock.h"
+#include "IXAudio2SourceVoiceMock.h"
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::IO;
+using namespace System::Threading;
+using namespace SlimDX;
+using namespace SlimDX::Multimedia;
+using namespace SlimDX::XAudio2;
+
+typedef SlimDX::XAudio2::XAudio2 AudioDevice;
+
+// Mono float at 8000 Hz with 10 ms buffers, so each streamed buffer holds 80 frames.
+static const int SampleRate = 8000;
+static const int QuantumFrames = 16;
+static const int BufferCount = 3;
+static const int BufferMilliseconds = 10;
+static const int BufferFrames = 80;
+
+static WaveFormat^ FloatFormat()
+{
+	WaveFormat^ format = gcnew WaveFormat();
+	format->FormatTag = WaveFormatTag::IeeeFloat;
+	format->SamplesPerSecond = SampleRate;
+	format->Channels = 1;
+	format->BitsPerSample = 32;
+	format->BlockAlignment = 4;
+	format->AverageBytesPerSecond = SampleRate * 4;
+	return format;
+}
+
+// Every frame holds its own number, so that gaps, repeats and reordering all show up in the output.
+static array<float>^ Sequence( int first, int count )
+{
+	array<float>^ samples = gcnew array<float>( count );
+	for( int i = 0; i < count; i++ )
+		samples[i] = static_cast<float>( first + i );
+	return samples;
+}
+
+static DataStream^ MemoryTrack( int first, int count )
+{
+	return gcnew DataStream( Sequence( first, count ), true, false );
+}
+
+static WaveStream^ StreamedTrack( int first, int count )
+{
+	MemoryStream^ file = gcnew MemoryStream();
+	BinaryWriter^ writer = gcnew BinaryWriter( file );
+
+	writer->Write( Text::Encoding::ASCII->GetBytes( "RIFF" ) );
+	writer->Write( 4 + 26 + 8 + count * 4 );
+	writer->Write( Text::Encoding::ASCII->GetBytes( "WAVEfmt " ) );
+	writer->Write( 18 );
+	writer->Write( static_cast<short>( 3 ) );
+	writer->Write( static_cast<short>( 1 ) );
+	writer->Write( SampleRate );
+	writer->Write( SampleRate * 4 );
+	writer->Write( static_cast<short>( 4 ) );
+	writer->Write( static_cast<short>( 32 ) );
+	writer->Write( static_cast<short>( 0 ) );
+	writer->Write( Text::Encoding::ASCII->GetBytes( "data" ) );
+	writer->Write( count * 4 );
+	for each( float sample in Sequence( first, count ) )
+		writer->Write( sample );
+
+	writer->Flush();
+	file->Position = 0;
+	return gcnew WaveStream( file, 64, 4 );
+}
+
+// Plays the mocked voice through an offline source voice, so that buffers are only consumed, and their
+// ends reported back to the wrapper, when a test renders.
+ref class OfflinePlayback
+{
+public:
+	OfflinePlayback()
+	{
+		Lock = gcnew Object();
+		Contexts = gcnew Queue<IntPtr>();
+		Engine = gcnew OfflineEngine( QuantumFrames );
+		gcnew OfflineMasteringVoice( Engine, 1, SampleRate );
+		Voice = gcnew OfflineSourceVoice( Engine, FloatFormat() );
+		Voice->BufferEnd += gcnew EventHandler<ContextEventArgs^>( this, &OfflinePlayback::OnBufferEnd );
+		Voice->Start();
+	}
+
+	Object^ Lock;
+	OfflineEngine^ Engine;
+	OfflineSourceVoice^ Voice;
+	IXAudio2VoiceCallback *Callback;
+	bool EndOfStreamSubmitted;
+
+	void Submit( const XAUDIO2_BUFFER *native )
+	{
+		AudioBuffer^ buffer = gcnew AudioBuffer();
+		buffer->AudioData = gcnew DataStream( native->pAudioData, native->AudioBytes, true, false );
+		buffer->AudioBytes = static_cast<int>( native->AudioBytes );
+		buffer->PlayBegin = static_cast<int>( native->PlayBegin );
+		buffer->PlayLength = static_cast<int>( native->PlayLength );
+		buffer->LoopBegin = static_cast<int>( native->LoopBegin );
+		buffer->LoopLength = static_cast<int>( native->LoopLength );
+		buffer->LoopCount = static_cast<int>( native->LoopCount );
+		buffer->Flags = static_cast<SlimDX::XAudio2::BufferFlags>( native->Flags );
+		buffer->Context = IntPtr( native->pContext );
+
+		Monitor::Enter( Lock );
+		try
+		{
+			Voice->SubmitSourceBuffer( buffer );
+			Contexts->Enqueue( buffer->Context );
+			if( ( native->Flags & XAUDIO2_END_OF_STREAM ) != 0 )
+				EndOfStreamSubmitted = true;
+		}
+		finally
+		{
+			Monitor::Exit( Lock );
+		}
+	}
+
+	void Flush()
+	{
+		Monitor::Enter( Lock );
+		try
+		{
+			// the offline voice reports flushed buffers on its next pass, but the wrapper needs them back now
+			Voice->FlushSourceBuffers();
+			FlushedEnds += Contexts->Count;
+			while( Contexts->Count > 0 )
+				Callback->OnBufferEnd( Contexts->Dequeue().ToPointer() );
+		}
+		finally
+		{
+			Monitor::Exit( Lock );
+		}
+	}
+
+	void ExitLoop()
+	{
+		Monitor::Enter( Lock );
+		try
+		{
+			Voice->ExitLoop();
+		}
+		finally
+		{
+			Monitor::Exit( Lock );
+		}
+	}
+
+	void GetState( XAUDIO2_VOICE_STATE *state )
+	{
+		Monitor::Enter( Lock );
+		try
+		{
+			VoiceState current = Voice->State;
+			state->pCurrentBufferContext = current.Context.ToPointer();
+			state->BuffersQueued = current.BuffersQueued;
+			state->SamplesPlayed = current.SamplesPlayed;
+		}
+		finally
+		{
+			Monitor::Exit( Lock );
+		}
+	}
+
+	property int BuffersQueued
+	{
+		int get()
+		{
+			XAUDIO2_VOICE_STATE state;
+			GetState( &state );
+			return state.BuffersQueued;
+		}
+	}
+
+	// Keeps the pump away from the voice, so that several tracks can be enqueued before it sees any of them.
+	void Pause()
+	{
+		Monitor::Enter( Lock );
+	}
+
+	void Resume()
+	{
+		Monitor::Exit( Lock );
+	}
+
+	array<float>^ Render( int frames )
+	{
+		DataStream^ output = gcnew DataStream( frames * 4, true, true );
+
+		Monitor::Enter( Lock );
+		try
+		{
+			Engine->Render( output, frames );
+		}
+		finally
+		{
+			Monitor::Exit( Lock );
+		}
+
+		output->Position = 0;
+		return output->ReadRange<float>( frames );
+	}
+
+	// Waits until the pump has filled the voice, or has submitted the last of its audio.
+	bool WaitForPump()
+	{
+		for( int i = 0; i < 5000; i++ )
+		{
+			Monitor::Enter( Lock );
+			try
+			{
+				if( Voice->State.BuffersQueued >= BufferCount || EndOfStreamSubmitted )
+					return true;
+			}
+			finally
+			{
+				Monitor::Exit( Lock );
+			}
+
+			Thread::Sleep( 1 );
+		}
+
+		return false;
+	}
+
+	// Renders a quantum at a time, letting the pump refill the voice between passes as the engine thread would.
+	array<float>^ Play( int quanta )
+	{
+		List<float>^ output = gcnew List<float>();
+		for( int i = 0; i < quanta; i++ )
+		{
+			EXPECT_TRUE( WaitForPump() );
+			output->AddRange( Render( QuantumFrames ) );
+		}
+
+		return output->ToArray();
+	}
+
+private:
+	Queue<IntPtr>^ Contexts;
+	int FlushedEnds;
+
+	void OnBufferEnd( Object^, ContextEventArgs^ e )
+	{
+		if( FlushedEnds > 0 )
+		{
+			FlushedEnds--;
+			return;
+		}
+
+		Contexts->Dequeue();
+		Callback->OnBufferEnd( e->Context.ToPointer() );
+	}
+};
+
+// Hands the mocked engine's source voice to the offline playback.
+class MockedVoiceRouting
+{
+public:
+	MockedVoiceRouting( IXAudio2Mock &device, IXAudio2SourceVoiceMock &voice, OfflinePlayback^ playback )
+	: m_Voice( &voice ), m_Playback( playback )
+	{
+		ON_CALL( device, CreateSourceVoice( _, _, _, _, _, _, _ ) ).WillByDefault( Invoke( this, &MockedVoiceRouting::CreateSourceVoice ) );
+		ON_CALL( voice, SubmitSourceBuffer( _, _ ) ).WillByDefault( Invoke( this, &MockedVoiceRouting::SubmitSourceBuffer ) );
+		ON_CALL( voice, FlushSourceBuffers() ).WillByDefault( Invoke( this, &MockedVoiceRouting::FlushSourceBuffers ) );
+		ON_CALL( voice, ExitLoop( _ ) ).WillByDefault( Invoke( this, &MockedVoiceRouting::ExitLoop ) );
+		ON_CALL( voice, GetState( _ ) ).WillByDefault( Invoke( this, &MockedVoiceRouting::GetState ) );
+	}
+
+	HRESULT CreateSourceVoice( IXAudio2SourceVoice **voice, const WAVEFORMATEX*, UINT32, float, IXAudio2VoiceCallback *callback, const XAUDIO2_VOICE_SENDS*, const XAUDIO2_EFFECT_CHAIN* )
+	{
+		m_Playback->Callback = callback;
+		*voice = m_Voice;
+		return S_OK;
+	}
+
+	HRESULT SubmitSourceBuffer( const XAUDIO2_BUFFER *buffer, const XAUDIO2_BUFFER_WMA* )
+	{
+		m_Playback->Submit( buffer );
+		return S_OK;
+	}
+
+	HRESULT FlushSourceBuffers()
+	{
+		m_Playback->Flush();
+		return S_OK;
+	}
+
+	HRESULT ExitLoop( UINT32 )
+	{
+		m_Playback->ExitLoop();
+		return S_OK;
+	}
+
+	void GetState( XAUDIO2_VOICE_STATE *state )
+	{
+		m_Playback->GetState( state );
+	}
+
+private:
+	IXAudio2SourceVoice *m_Voice;
+	gcroot<OfflinePlayback^> m_Playback;
+};
+
+class StreamingVoicePumpTest : public testing::Test
+{
+protected:
+	StreamingVoicePumpTest()
+	: playback( gcnew OfflinePlayback() ), routing( mockDevice, mockVoice, playback )
+	{
+	}
+
+	virtual void SetUp()
+	{
+		device = AudioDevice::FromPointer( IntPtr( &mockDevice ) );
+		voice = gcnew SourceVoice( device, FloatFormat() );
+	}
+
+	virtual void TearDown()
+	{
+		SourceVoice^ sourceVoice = voice;
+		AudioDevice^ audioDevice = device;
+		OfflinePlayback^ offline = playback;
+
+		delete sourceVoice;
+		delete audioDevice;
+		delete offline->Engine;
+	}
+
+	NiceMock<IXAudio2Mock> mockDevice;
+	NiceMock<IXAudio2SourceVoiceMock> mockVoice;
+	gcroot<OfflinePlayback^> playback;
+	MockedVoiceRouting routing;
+	gcroot<AudioDevice^> device;
+	gcroot<SourceVoice^> voice;
+};
+
+// Kept out of line so that nothing on the test's stack refers to the pump once it returns.
+[Runtime::CompilerServices::MethodImpl( Runtime::CompilerServices::MethodImplOptions::NoInlining )]
+static void AbandonPump( SourceVoice^ voice )
+{
+	gcnew StreamingVoicePump( voice, FloatFormat(), BufferCount, BufferMilliseconds );
+}
+
+TEST_F( StreamingVoicePumpTest, ChainsTracksWithoutGaps )
+{
+	StreamingVoicePump^ pump = gcnew StreamingVoicePump( voice, FloatFormat(), BufferCount, BufferMilliseconds );
+	ASSERT_EQ( BufferFrames * 4, pump->BufferSize );
+
+	// the in-memory track goes in a buffer of its own, between the buffers of the streamed ones
+	playback->Pause();
+	pump->Enqueue( StreamedTrack( 1, 100 ) );
+	pump->Enqueue( MemoryTrack( 101, 50 ) );
+	pump->Enqueue( StreamedTrack( 151, 130 ) );
+	ASSERT_EQ( 3, pump->PendingTrackCount );
+	playback->Resume();
+
+	ASSERT_TRUE( playback->WaitForPump() );
+	pump->ResetStatistics();
+
+	array<float>^ output = playback->Play( 20 );
+	for( int i = 0; i < 280; i++ )
+		ASSERT_EQ( static_cast<float>( i + 1 ), output[i] );
+	for( int i = 280; i < output->Length; i++ )
+		ASSERT_EQ( 0.0f, output[i] );
+
+	ASSERT_EQ( 5, pump->SubmittedBufferCount );
+	ASSERT_EQ( 0, pump->PendingTrackCount );
+	ASSERT_EQ( 0, pump->UnderrunCount );
+
+	// the pump refills after every buffer end, so the voice never gets below one buffer short
+	ASSERT_EQ( BufferCount - 1, pump->LowestQueueDepth );
+
+	delete pump;
+}
+
+TEST_F( StreamingVoicePumpTest, PlaysLoopRegions )
+{
+	StreamingVoicePump^ pump = gcnew StreamingVoicePump( voice, FloatFormat(), BufferCount, BufferMilliseconds );
+
+	// the streamed track is looped by seeking it, the in-memory one by the voice
+	playback->Pause();
+	pump->Enqueue( StreamedTrack( 1, 60 ), 10, 20, 2 );
+	pump->Enqueue( MemoryTrack( 101, 40 ), 20, 0, 1 );
+	playback->Resume();
+
+	List<float>^ expected = gcnew List<float>();
+	expected->AddRange( Sequence( 1, 30 ) );
+	expected->AddRange( Sequence( 11, 20 ) );
+	expected->AddRange( Sequence( 11, 50 ) );
+	expected->AddRange( Sequence( 101, 40 ) );
+	expected->AddRange( Sequence( 121, 20 ) );
+
+	array<float>^ output = playback->Play( 12 );
+	for( int i = 0; i < expected->Count; i++ )
+		ASSERT_EQ( expected[i], output[i] );
+	for( int i = expected->Count; i < output->Length; i++ )
+		ASSERT_EQ( 0.0f, output[i] );
+
+	ASSERT_EQ( 3, pump->SubmittedBufferCount );
+
+	ASSERT_MANAGED_THROW( pump->Enqueue( MemoryTrack( 1, 40 ), 40, 0, 1 ), ArgumentOutOfRangeException );
+	ASSERT_MANAGED_THROW( pump->Enqueue( MemoryTrack( 1, 40 ), 20, 30, 1 ), ArgumentOutOfRangeException );
+
+	delete pump;
+}
+
+TEST_F( StreamingVoicePumpTest, CountsUnderruns )
+{
+	StreamingVoicePump^ pump = gcnew StreamingVoicePump( voice, FloatFormat(), BufferCount, BufferMilliseconds );
+
+	pump->Enqueue( StreamedTrack( 1, 4000 ) );
+	ASSERT_TRUE( playback->WaitForPump() );
+	pump->ResetStatistics();
+	ASSERT_EQ( BufferCount, pump->LowestQueueDepth );
+
+	// one long pass plays everything that was queued and more, as if the pump had been kept off the CPU
+	playback->Render( BufferCount * BufferFrames + QuantumFrames );
+	ASSERT_TRUE( playback->WaitForPump() );
+	ASSERT_EQ( 1, pump->UnderrunCount );
+	ASSERT_EQ( 0, pump->LowestQueueDepth );
+
+	// keeping up again does not add to the count
+	playback->Play( 10 );
+	ASSERT_EQ( 1, pump->UnderrunCount );
+	ASSERT_EQ( 1, pump->PendingTrackCount );
+
+	pump->Clear();
+	for( int i = 0; i < 5000 && ( pump->PendingTrackCount > 0 || playback->BuffersQueued > 0 ); i++ )
+		Thread::Sleep( 1 );
+
+	ASSERT_EQ( 0, pump->PendingTrackCount );
+	ASSERT_EQ( 0, playback->BuffersQueued );
+
+	// running dry with nothing left to play is not an underrun
+	playback->Render( 2 * QuantumFrames );
+	Thread::Sleep( 20 );
+	ASSERT_EQ( 1, pump->UnderrunCount );
+
+	delete pump;
+}
+
+TEST_F( StreamingVoicePumpTest, UndisposedPumpDetachesFromVoice )
+{
+	AbandonPump( voice );
+	ASSERT_TRUE( voice->bufferEndSignal != nullptr );
+	ASSERT_MANAGED_THROW( gcnew StreamingVoicePump( voice, FloatFormat(), BufferCount, BufferMilliseconds ), InvalidOperationException );
+
+	// the pump thread holds the pump while it works, so a collection may have to wait for it to go idle
+	for( int i = 0; i < 100 && voice->bufferEndSignal != nullptr; i++ )
+	{
+		GC::Collect();
+		GC::WaitForPendingFinalizers();
+		Thread::Sleep( 10 );
+	}
+
+	ASSERT_TRUE( voice->bufferEndSignal == nullptr );
+
+	StreamingVoicePump^ pump = gcnew StreamingVoicePump( voice, FloatFormat(), BufferCount, BufferMilliseconds );
+	delete pump;
+	ASSERT_TRUE( voice->bufferEndSignal == nullptr );
+}
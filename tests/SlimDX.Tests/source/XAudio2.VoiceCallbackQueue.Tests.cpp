@@ -0,0 +1,273 @@
+#include "stdafx.h"
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Asserts.h"
+
+using namespace testing;
+using namespace System;
+using namespace System::Threading;
+using namespace SlimDX;
+using namespace SlimDX::XAudio2;
+
+ref class CallbackCounter
+{
+public:
+	int Count;
+	Int64 ContextSum;
+
+	void Handle( VoiceCallbackRecord record )
+	{
+		Count++;
+		ContextSum += record.Context.ToInt64();
+	}
+};
+
+TEST( VoiceCallbackQueueTests, CapacityIsRoundedUpToPowerOfTwo )
+{
+	VoiceCallbackQueue^ queue = gcnew VoiceCallbackQueue( 100 );
+	ASSERT_EQ( 128, queue->Capacity );
+	ASSERT_EQ( 0, queue->Count );
+	delete queue;
+
+	ASSERT_MANAGED_THROW( gcnew VoiceCallbackQueue( 0 ), ArgumentOutOfRangeException );
+}
+
+TEST( VoiceCallbackQueueTests, RecordsComeOutInOrder )
+{
+	VoiceCallbackQueue^ queue = gcnew VoiceCallbackQueue( 16 );
+	int token = queue->Register( nullptr );
+
+	ASSERT_TRUE( queue->Post( token, VoiceCallbackKind::BufferStart, reinterpret_cast<void*>( 7 ), 0 ) );
+	ASSERT_TRUE( queue->Post( token, VoiceCallbackKind::VoiceError, reinterpret_cast<void*>( 8 ), E_FAIL ) );
+	ASSERT_TRUE( queue->Post( token, VoiceCallbackKind::VoiceProcessingPassStart, NULL, 4096 ) );
+	ASSERT_EQ( 3, queue->Count );
+
+	VoiceCallbackRecord record;
+	ASSERT_TRUE( queue->TryDequeue( record ) );
+	ASSERT_TRUE( record.Kind == VoiceCallbackKind::BufferStart );
+	ASSERT_EQ( 7, record.Context.ToInt32() );
+	ASSERT_TRUE( record.Error.IsSuccess );
+
+	ASSERT_TRUE( queue->TryDequeue( record ) );
+	ASSERT_TRUE( record.Kind == VoiceCallbackKind::VoiceError );
+	ASSERT_EQ( 8, record.Context.ToInt32() );
+	ASSERT_EQ( E_FAIL, record.Error.Code );
+
+	ASSERT_TRUE( queue->TryDequeue( record ) );
+	ASSERT_TRUE( record.Kind == VoiceCallbackKind::VoiceProcessingPassStart );
+	ASSERT_EQ( 4096, record.BytesRequired );
+
+	ASSERT_FALSE( queue->TryDequeue( record ) );
+	ASSERT_EQ( 3, queue->PostedCount );
+
+	delete queue;
+}
+
+TEST( VoiceCallbackQueueTests, FullQueueDropsCallbacks )
+{
+	VoiceCallbackQueue^ queue = gcnew VoiceCallbackQueue( 4 );
+	int token = queue->Register( nullptr );
+
+	for( int i = 0; i < 4; i++ )
+		ASSERT_TRUE( queue->Post( token, VoiceCallbackKind::BufferEnd, NULL, 0 ) );
+
+	ASSERT_FALSE( queue->Post( token, VoiceCallbackKind::BufferEnd, NULL, 0 ) );
+	ASSERT_EQ( 4, queue->PostedCount );
+	ASSERT_EQ( 1, queue->DroppedCount );
+
+	CallbackCounter^ counter = gcnew CallbackCounter();
+	ASSERT_EQ( 4, queue->Drain( gcnew VoiceCallbackHandler( counter, &CallbackCounter::Handle ) ) );
+	ASSERT_TRUE( queue->Post( token, VoiceCallbackKind::BufferEnd, NULL, 0 ) );
+
+	queue->ResetStatistics();
+	ASSERT_EQ( 0, queue->DroppedCount );
+
+	delete queue;
+}
+
+TEST( VoiceCallbackQueueTests, UnregisteredVoicesAreSkipped )
+{
+	VoiceCallbackQueue^ queue = gcnew VoiceCallbackQueue( 16 );
+	int first = queue->Register( nullptr );
+	queue->Post( first, VoiceCallbackKind::BufferEnd, reinterpret_cast<void*>( 1 ), 0 );
+	queue->Unregister( first );
+
+	// the slot is reused, but the stale record must not be attributed to the new voice
+	int second = queue->Register( nullptr );
+	ASSERT_NE( first, second );
+	queue->Post( second, VoiceCallbackKind::BufferEnd, reinterpret_cast<void*>( 2 ), 0 );
+
+	VoiceCallbackRecord record;
+	ASSERT_TRUE( queue->TryDequeue( record ) );
+	ASSERT_EQ( 2, record.Context.ToInt32() );
+	ASSERT_FALSE( queue->TryDequeue( record ) );
+
+	delete queue;
+}
+
+ref class CallbackProducer
+{
+public:
+	VoiceCallbackQueue^ Queue;
+	int Token;
+	int Index;
+	int Count;
+
+	void Run()
+	{
+		for( int i = 1; i <= Count; i++ )
+		{
+			INT_PTR context = (static_cast<INT_PTR>( Index ) << 20) | i;
+			while( !Queue->Post( Token, VoiceCallbackKind::BufferEnd, reinterpret_cast<void*>( context ), 0 ) )
+				Thread::Yield();
+		}
+	}
+};
+
+TEST( VoiceCallbackQueueTests, ConcurrentProducersLoseNothing )
+{
+	const int producerCount = 4;
+	const int postCount = 50000;
+	VoiceCallbackQueue^ queue = gcnew VoiceCallbackQueue( 256 );
+	array<Thread^>^ threads = gcnew array<Thread^>( producerCount );
+	array<int>^ last = gcnew array<int>( producerCount );
+
+	for( int i = 0; i < producerCount; i++ )
+	{
+		CallbackProducer^ producer = gcnew CallbackProducer();
+		producer->Queue = queue;
+		producer->Token = queue->Register( nullptr );
+		producer->Index = i;
+		producer->Count = postCount;
+		threads[i] = gcnew Thread( gcnew ThreadStart( producer, &CallbackProducer::Run ) );
+	}
+
+	for each( Thread^ thread in threads )
+		thread->Start();
+
+	int received = 0;
+	VoiceCallbackRecord record;
+	while( received < producerCount * postCount )
+	{
+		if( !queue->TryDequeue( record ) )
+			continue;
+
+		// every producer's callbacks must arrive complete and in the order it posted them
+		int context = record.Context.ToInt32();
+		int producer = context >> 20;
+		ASSERT_EQ( last[producer] + 1, context & 0xfffff );
+		last[producer]++;
+		received++;
+	}
+
+	for each( Thread^ thread in threads )
+		thread->Join();
+
+	ASSERT_EQ( producerCount * postCount, queue->PostedCount );
+	ASSERT_FALSE( queue->TryDequeue( record ) );
+
+	delete queue;
+}
+
+ref class PostingLoop
+{
+public:
+	VoiceCallbackQueue^ Queue;
+	int Token;
+	int Posts;
+	volatile bool Stop;
+
+	void Run()
+	{
+		while( !Stop )
+		{
+			Queue->Post( Token, VoiceCallbackKind::BufferEnd, NULL, 0 );
+			Posts++;
+		}
+	}
+};
+
+TEST( VoiceCallbackQueueTests, DisposeWhilePosting )
+{
+	for( int round = 0; round < 20; round++ )
+	{
+		VoiceCallbackQueue^ queue = gcnew VoiceCallbackQueue( 8 );
+		PostingLoop^ poster = gcnew PostingLoop();
+		poster->Queue = queue;
+		poster->Token = queue->Register( nullptr );
+
+		Thread^ thread = gcnew Thread( gcnew ThreadStart( poster, &PostingLoop::Run ) );
+		thread->Start();
+
+		// drain for a bit so the poster is running flat out when the ring goes away
+		VoiceCallbackRecord record;
+		for( int i = 0; i < 1000; i++ )
+			queue->TryDequeue( record );
+
+		// the poster keeps going across the dispose, as an engine thread would for a voice that is still attached
+		delete queue;
+		Thread::Sleep( 1 );
+		poster->Stop = true;
+		ASSERT_TRUE( thread->Join( 10000 ) );
+		ASSERT_GT( poster->Posts, 0 );
+
+		ASSERT_FALSE( queue->Post( poster->Token, VoiceCallbackKind::BufferEnd, NULL, 0 ) );
+		ASSERT_EQ( 0, queue->Count );
+		ASSERT_MANAGED_THROW( queue->TryDequeue( record ), ObjectDisposedException );
+	}
+}
+
+TEST( VoiceCallbackQueueTests, PostAndDrainDoNotAllocate )
+{
+	VoiceCallbackQueue^ queue = gcnew VoiceCallbackQueue( 64 );
+	int token = queue->Register( nullptr );
+	CallbackCounter^ counter = gcnew CallbackCounter();
+	VoiceCallbackHandler^ handler = gcnew VoiceCallbackHandler( counter, &CallbackCounter::Handle );
+
+	// warm up so any one-time JIT or lazy initialization is out of the way
+	queue->Post( token, VoiceCallbackKind::BufferEnd, NULL, 0 );
+	queue->Drain( handler );
+
+	GC::Collect();
+	GC::WaitForPendingFinalizers();
+	GC::Collect();
+
+	int collections = GC::CollectionCount( 0 );
+	Int64 before = GC::GetTotalMemory( false );
+
+	for( int frame = 0; frame < 10000; frame++ )
+	{
+		for( int i = 0; i < 32; i++ )
+			queue->Post( token, VoiceCallbackKind::BufferEnd, reinterpret_cast<void*>( 1 ), 0 );
+
+		queue->Drain( handler );
+	}
+
+	Int64 after = GC::GetTotalMemory( false );
+	ASSERT_EQ( collections, GC::CollectionCount( 0 ) );
+	ASSERT_EQ( before, after );
+	ASSERT_EQ( 320001, counter->Count );
+	ASSERT_EQ( 320000, counter->ContextSum );
+
+	delete queue;
+}
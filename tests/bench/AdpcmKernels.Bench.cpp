@@ -0,0 +1,131 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+// Throughput benchmark for the ADPCM block codecs. It has no Windows dependencies and builds with
+//
+//     cl /O2 /EHsc /I. /I../../source/multimedia /FIstdafx.h AdpcmKernels.Bench.cpp ../../source/multimedia/AdpcmKernels.cpp
+//     g++ -O2 -I. -I../../source/multimedia -include stdafx.h AdpcmKernels.Bench.cpp ../../source/multimedia/AdpcmKernels.cpp
+//
+// where stdafx.h is an empty file on the include path. The figures are for one thread; AdpcmCodec spreads
+// blocks across the thread pool, so decoding scales with the number of cores.
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+
+#include "AdpcmKernels.h"
+
+using namespace SlimDX::Multimedia::Adpcm;
+
+static const unsigned int Channels = 2;
+static const unsigned int BlockSize = 2048;
+static const unsigned int Seconds = 60;
+static const unsigned int SampleRate = 44100;
+
+static double Elapsed( clock_t start )
+{
+	return static_cast<double>( clock() - start ) / CLOCKS_PER_SEC;
+}
+
+static void Report( const char *name, double seconds, unsigned int frames )
+{
+	printf( "%-24s %8.1f ms   %8.1f Msamples/s   %6.0fx real time\n", name, seconds * 1000.0,
+		frames * Channels / seconds / 1e6, frames / (seconds * SampleRate) );
+}
+
+template<typename Sample>
+static double DecodeAll( bool ms, const std::vector<unsigned char> &encoded, unsigned int samplesPerBlock, std::vector<Sample> &output )
+{
+	clock_t start = clock();
+	size_t blocks = encoded.size() / BlockSize;
+	for( size_t block = 0; block < blocks; ++block )
+	{
+		Sample *destination = &output[block * samplesPerBlock * Channels];
+		if( ms )
+			DecodeMsBlock( &encoded[block * BlockSize], Channels, samplesPerBlock, StandardCoefficients, StandardCoefficientCount, destination );
+		else
+			DecodeImaBlock( &encoded[block * BlockSize], Channels, samplesPerBlock, destination );
+	}
+
+	return Elapsed( start );
+}
+
+static void Run( bool ms, const std::vector<short> &input, unsigned int frames )
+{
+	unsigned int samplesPerBlock = ms ? MsSamplesPerBlock( BlockSize, Channels ) : ImaSamplesPerBlock( BlockSize, Channels );
+	unsigned int blocks = (frames + samplesPerBlock - 1) / samplesPerBlock;
+	std::vector<unsigned char> encoded( blocks * BlockSize );
+
+	clock_t start = clock();
+	for( unsigned int block = 0; block < blocks; ++block )
+	{
+		unsigned int first = block * samplesPerBlock;
+		unsigned int count = frames - first < samplesPerBlock ? frames - first : samplesPerBlock;
+		if( ms )
+			EncodeMsBlock( &input[first * Channels], count, Channels, samplesPerBlock, StandardCoefficients, StandardCoefficientCount, &encoded[block * BlockSize], BlockSize );
+		else
+			EncodeImaBlock( &input[first * Channels], count, Channels, samplesPerBlock, &encoded[block * BlockSize], BlockSize );
+	}
+	Report( ms ? "MS-ADPCM encode" : "IMA-ADPCM encode", Elapsed( start ), frames );
+
+	std::vector<short> pcm( blocks * samplesPerBlock * Channels );
+	Report( ms ? "MS-ADPCM decode (16)" : "IMA-ADPCM decode (16)", DecodeAll( ms, encoded, samplesPerBlock, pcm ), frames );
+
+	std::vector<float> floats( blocks * samplesPerBlock * Channels );
+	Report( ms ? "MS-ADPCM decode (float)" : "IMA-ADPCM decode (float)", DecodeAll( ms, encoded, samplesPerBlock, floats ), frames );
+
+	double signal = 0.0;
+	double noise = 0.0;
+	for( size_t i = 0; i < input.size(); ++i )
+	{
+		double difference = static_cast<double>( input[i] ) - pcm[i];
+		signal += static_cast<double>( input[i] ) * input[i];
+		noise += difference * difference;
+	}
+	printf( "%-24s %8.1f dB SNR\n\n", "", 10.0 * log10( signal / (noise > 0.0 ? noise : 1.0) ) );
+}
+
+int main()
+{
+	unsigned int frames = Seconds * SampleRate;
+	std::vector<short> input( frames * Channels );
+
+	// a chord with a slow sweep and a little noise, so the encoder has to keep adapting
+	unsigned int seed = 1;
+	for( unsigned int i = 0; i < frames; ++i )
+	{
+		double t = static_cast<double>( i ) / SampleRate;
+		for( unsigned int c = 0; c < Channels; ++c )
+		{
+			seed = seed * 1664525 + 1013904223;
+			double value = 6000.0 * sin( 2.0 * 3.14159265 * (220.0 + 40.0 * c) * t ) + 4000.0 * sin( 2.0 * 3.14159265 * (330.0 + 200.0 * sin( t )) * t )
+				+ ((seed >> 16) & 0x3ff) - 512.0;
+			input[i * Channels + c] = static_cast<short>( value );
+		}
+	}
+
+	printf( "%u s of %u channel audio at %u Hz, %u byte blocks\n\n", Seconds, Channels, SampleRate, BlockSize );
+	Run( true, input, frames );
+	Run( false, input, frames );
+	return 0;
+}
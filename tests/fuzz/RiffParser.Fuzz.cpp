@@ -0,0 +1,162 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+// Fuzz target for the portable RIFF/WAVE parser. It has no Windows dependencies and builds on Linux with
+//
+//     clang++ -g -O1 -fsanitize=fuzzer,address,undefined -I. -I../../source/multimedia -include stdafx.h
+//         RiffParser.Fuzz.cpp ../../source/multimedia/RiffParser.cpp
+//
+// where stdafx.h is an empty file on the include path. Defining RIFF_FUZZ_STANDALONE instead of linking
+// libFuzzer builds a simple mutation driver that works with any compiler that has the sanitizers.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "RiffParser.h"
+
+using namespace SlimDX::Multimedia::Riff;
+
+#define FUZZ_CHECK( condition ) do { if( !(condition) ) { fprintf( stderr, "check failed: %s\n", #condition ); abort(); } } while( 0 )
+
+static void CheckRange( const ChunkRange &range, unsigned long long size )
+{
+	if( !range.Found )
+		return;
+
+	FUZZ_CHECK( range.Offset <= size );
+	FUZZ_CHECK( range.Size <= size - range.Offset );
+}
+
+static void ParseList( const unsigned char *data, const ChunkRange &range )
+{
+	if( !range.Found || range.Size > MaxMetadataSize )
+		return;
+
+	unsigned int size = static_cast<unsigned int>( range.Size );
+	unsigned int cursor = 0;
+	unsigned int steps = 0;
+	SubChunk chunk;
+
+	while( NextSubChunk( data + range.Offset, size, cursor, chunk ) )
+	{
+		FUZZ_CHECK( chunk.Offset <= size && chunk.Size <= size - chunk.Offset );
+		FUZZ_CHECK( ++steps <= size / 8 );
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput( const unsigned char *data, size_t size )
+{
+	MemoryChunkReader reader( data, size );
+	WaveLayout layout;
+
+	FourCC formType = size > 0 && (data[0] & 1) ? MakeFourCC( 'X', 'W', 'M', 'A' ) : MakeFourCC( 'W', 'A', 'V', 'E' );
+	if( ParseWave( reader, formType, layout ) != ParseSucceeded )
+		return 0;
+
+	CheckRange( layout.Format, size );
+	CheckRange( layout.Data, size );
+	CheckRange( layout.Sample, size );
+	CheckRange( layout.Cue, size );
+	CheckRange( layout.Info, size );
+	CheckRange( layout.AssociatedData, size );
+	CheckRange( layout.PacketTable, size );
+
+	if( layout.Format.Size <= MaxMetadataSize )
+	{
+		FormatHeader header;
+		unsigned int formatSize = ParseFormat( data + layout.Format.Offset, static_cast<unsigned int>( layout.Format.Size ), header );
+		FUZZ_CHECK( formatSize == 0 || formatSize <= layout.Format.Size || (layout.Format.Size < 18 && formatSize == 18) );
+	}
+
+	if( layout.Sample.Found && layout.Sample.Size <= MaxMetadataSize )
+	{
+		SampleLoopRecord loops[4];
+		int count = ParseSampleLoops( data + layout.Sample.Offset, static_cast<unsigned int>( layout.Sample.Size ), loops, 4 );
+		FUZZ_CHECK( count >= 0 && 36 + 24ull * count <= (layout.Sample.Size < 36 ? 36 : layout.Sample.Size) );
+	}
+
+	if( layout.Cue.Found && layout.Cue.Size <= MaxMetadataSize )
+	{
+		CuePointRecord points[4];
+		int count = ParseCuePoints( data + layout.Cue.Offset, static_cast<unsigned int>( layout.Cue.Size ), points, 4 );
+		FUZZ_CHECK( count >= 0 && 4 + 24ull * count <= (layout.Cue.Size < 4 ? 4 : layout.Cue.Size) );
+	}
+
+	ParseList( data, layout.Info );
+	ParseList( data, layout.AssociatedData );
+	return 0;
+}
+
+#ifdef RIFF_FUZZ_STANDALONE
+static void Put32( unsigned char *data, unsigned int value )
+{
+	data[0] = static_cast<unsigned char>( value );
+	data[1] = static_cast<unsigned char>( value >> 8 );
+	data[2] = static_cast<unsigned char>( value >> 16 );
+	data[3] = static_cast<unsigned char>( value >> 24 );
+}
+
+int main( int argc, char **argv )
+{
+	unsigned int iterations = argc > 1 ? static_cast<unsigned int>( atoi( argv[1] ) ) : 1000000;
+	srand( argc > 2 ? atoi( argv[2] ) : 1 );
+
+	// a small but complete file with every chunk the parser knows about, mutated from there
+	unsigned char seed[] =
+	{
+		'R','I','F','F', 0,0,0,0, 'W','A','V','E',
+		'f','m','t',' ', 16,0,0,0, 1,0, 2,0, 0x44,0xAC,0,0, 0x10,0xB1,2,0, 4,0, 16,0,
+		's','m','p','l', 60,0,0,0, 0,0,0,0, 0,0,0,0, 0,0,0,0, 60,0,0,0, 0,0,0,0, 0,0,0,0, 0,0,0,0, 1,0,0,0, 0,0,0,0,
+			1,0,0,0, 0,0,0,0, 0,0,0,0, 8,0,0,0, 0,0,0,0, 0,0,0,0,
+		'c','u','e',' ', 28,0,0,0, 1,0,0,0, 1,0,0,0, 0,0,0,0, 'd','a','t','a', 0,0,0,0, 0,0,0,0, 4,0,0,0,
+		'L','I','S','T', 22,0,0,0, 'I','N','F','O', 'I','N','A','M', 5,0,0,0, 't','e','s','t',0, 0,
+		'd','a','t','a', 16,0,0,0, 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16
+	};
+	Put32( seed + 4, sizeof( seed ) - 8 );
+
+	unsigned char buffer[512];
+	for( unsigned int i = 0; i < iterations; i++ )
+	{
+		size_t size = sizeof( seed );
+		memcpy( buffer, seed, size );
+
+		int mutations = 1 + rand() % 8;
+		for( int m = 0; m < mutations; m++ )
+		{
+			switch( rand() % 5 )
+			{
+			case 0: buffer[rand() % size] = static_cast<unsigned char>( rand() ); break;
+			case 1: buffer[rand() % size] ^= static_cast<unsigned char>( 1 << (rand() % 8) ); break;
+			case 2: if( size >= 4 ) Put32( buffer + rand() % (size - 3), rand() % 2 ? 0xFFFFFFFF : static_cast<unsigned int>( rand() % 64 ) ); break;
+			case 3: size = 1 + rand() % size; break;
+			case 4: if( rand() % 4 == 0 ) memcpy( buffer, "RF64\xFF\xFF\xFF\xFF", 8 ); break;
+			}
+		}
+
+		LLVMFuzzerTestOneInput( buffer, size );
+	}
+
+	printf( "%u iterations\n", iterations );
+	return 0;
+}
+#endif
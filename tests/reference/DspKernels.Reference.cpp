@@ -0,0 +1,282 @@
+/*
+* Copyright (c) 2007-2012 SlimDX Group
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+// Checks the vectorized DSP kernels against plain scalar implementations. It has no Windows dependencies and builds with
+//
+//     cl /O2 /EHsc /I. /I../../source/xapo /FIstdafx.h DspKernels.Reference.cpp ../../source/xapo/DspKernels.cpp
+//     g++ -O2 -I. -I../../source/xapo -include stdafx.h DspKernels.Reference.cpp ../../source/xapo/DspKernels.cpp
+//
+// where stdafx.h is an empty file on the include path. Every kernel runs over a range of channel and frame counts so
+// that the vector loops, their scalar tails and the layouts they special-case are all exercised. The program prints
+// the first mismatch of each kernel and returns non-zero if there was one.
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#include "DspKernels.h"
+
+using namespace SlimDX::XAPO::Dsp;
+
+static const unsigned int ChannelCounts[] = { 1, 2, 3, 4, 5, 6, 8, 9 };
+static const unsigned int FrameCounts[] = { 0, 1, 3, 4, 7, 64, 333 };
+static const unsigned int ChannelCountCount = sizeof(ChannelCounts) / sizeof(ChannelCounts[0]);
+static const unsigned int FrameCountCount = sizeof(FrameCounts) / sizeof(FrameCounts[0]);
+
+static unsigned int seed = 1;
+static unsigned int failures = 0;
+
+static float Noise()
+{
+	seed = seed * 1664525 + 1013904223;
+	return static_cast<float>( (seed >> 8) & 0xffff ) / 32768.0f - 1.0f;
+}
+
+static std::vector<float> Noise( size_t count )
+{
+	// one spare element so that &samples[0] is valid for empty buffers
+	std::vector<float> samples( count + 1 );
+	for( size_t i = 0; i < samples.size(); ++i )
+		samples[i] = Noise();
+	return samples;
+}
+
+static bool Compare( const char *kernel, unsigned int channels, unsigned int frames, const float *expected, const float *actual, size_t count, float tolerance )
+{
+	for( size_t i = 0; i < count; ++i )
+	{
+		float scale = fabsf( expected[i] ) > 1.0f ? fabsf( expected[i] ) : 1.0f;
+		if( !(fabsf( expected[i] - actual[i] ) <= tolerance * scale) )
+		{
+			printf( "%-16s %u channels, %u frames: element %u is %g, expected %g\n", kernel, channels, frames, static_cast<unsigned int>( i ),
+				actual[i], expected[i] );
+			++failures;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void CheckGainRamp( unsigned int channels, unsigned int frames )
+{
+	std::vector<float> source = Noise( channels * frames );
+	std::vector<float> mixed = Noise( channels * frames );
+	std::vector<float> applied = source;
+	std::vector<float> expectedMixed = mixed;
+	std::vector<float> expectedApplied = source;
+
+	float step = frames > 0 ? (0.25f - 1.5f) / frames : 0.0f;
+	for( unsigned int frame = 0; frame < frames; ++frame )
+	{
+		float gain = 1.5f + step * frame;
+		for( unsigned int c = 0; c < channels; ++c )
+		{
+			expectedApplied[frame * channels + c] = source[frame * channels + c] * gain;
+			expectedMixed[frame * channels + c] += source[frame * channels + c] * gain;
+		}
+	}
+
+	ApplyGainRamp( &applied[0], channels, frames, 1.5f, 0.25f );
+	MixGainRamp( &source[0], &mixed[0], channels, frames, 1.5f, 0.25f );
+	Compare( "ApplyGainRamp", channels, frames, &expectedApplied[0], &applied[0], channels * frames, 1e-5f );
+	Compare( "MixGainRamp", channels, frames, &expectedMixed[0], &mixed[0], channels * frames, 1e-5f );
+}
+
+static void CheckMixMatrix( unsigned int sourceChannels, unsigned int destinationChannels, unsigned int frames )
+{
+	std::vector<float> source = Noise( sourceChannels * frames );
+	std::vector<float> matrix = Noise( sourceChannels * destinationChannels );
+
+	for( int mix = 0; mix < 2; ++mix )
+	{
+		std::vector<float> destination = Noise( destinationChannels * frames );
+		std::vector<float> expected = destination;
+
+		for( unsigned int frame = 0; frame < frames; ++frame )
+		{
+			for( unsigned int d = 0; d < destinationChannels; ++d )
+			{
+				double sum = mix ? expected[frame * destinationChannels + d] : 0.0;
+				for( unsigned int s = 0; s < sourceChannels; ++s )
+					sum += static_cast<double>( matrix[d * sourceChannels + s] ) * source[frame * sourceChannels + s];
+				expected[frame * destinationChannels + d] = static_cast<float>( sum );
+			}
+		}
+
+		MixMatrix( &source[0], sourceChannels, &destination[0], destinationChannels, frames, &matrix[0], mix != 0 );
+		Compare( mix ? "MixMatrix (mix)" : "MixMatrix", destinationChannels, frames, &expected[0], &destination[0], destinationChannels * frames, 1e-5f );
+	}
+}
+
+static void CheckBiquads( unsigned int channels, unsigned int frames )
+{
+	// a low-pass and a resonant peak, both stable
+	BiquadStage stages[2] = {
+		{ 0.0039160f, 0.0078320f, 0.0039160f, -1.8153396f, 0.8310036f },
+		{ 1.0681930f, -1.6265470f, 0.7176290f, -1.6265470f, 0.7858220f },
+	};
+
+	std::vector<float> input = Noise( channels * frames * 2 );
+	std::vector<float> actual = input;
+	std::vector<float> expected = input;
+	std::vector<float> state( 2 * channels * 2, 0.0f );
+
+	// split across two calls so the carried state is checked too
+	ProcessBiquads( &actual[0], channels, frames, stages, 2, &state[0] );
+	ProcessBiquads( &actual[channels * frames], channels, frames, stages, 2, &state[0] );
+
+	for( unsigned int stage = 0; stage < 2; ++stage )
+	{
+		const BiquadStage &k = stages[stage];
+		for( unsigned int c = 0; c < channels; ++c )
+		{
+			float z1 = 0.0f, z2 = 0.0f;
+			for( unsigned int frame = 0; frame < frames * 2; ++frame )
+			{
+				float x = expected[frame * channels + c];
+				float y = k.B0 * x + z1;
+				z1 = k.B1 * x - k.A1 * y + z2;
+				z2 = k.B2 * x - k.A2 * y;
+				expected[frame * channels + c] = y;
+			}
+		}
+	}
+
+	Compare( "ProcessBiquads", channels, frames, &expected[0], &actual[0], channels * frames * 2, 1e-5f );
+}
+
+static void CheckDelay( unsigned int channels, unsigned int frames )
+{
+	static const unsigned int LineFrames = 37;
+	static const unsigned int Delays[] = { 1, 2, 5, 36 };
+
+	for( unsigned int d = 0; d < sizeof(Delays) / sizeof(Delays[0]); ++d )
+	{
+		std::vector<float> actual = Noise( channels * frames );
+		std::vector<float> expected = actual;
+		std::vector<float> line( LineFrames * channels + 1, 0.0f );
+		std::vector<float> history( LineFrames * channels, 0.0f );
+		unsigned int writeFrame = 5;
+
+		ProcessDelay( &actual[0], channels, frames, &line[0], LineFrames, writeFrame, Delays[d], 0.5f, 0.75f, 0.25f );
+
+		unsigned int write = 5;
+		for( unsigned int frame = 0; frame < frames; ++frame )
+		{
+			unsigned int read = (write + LineFrames - Delays[d]) % LineFrames;
+			for( unsigned int c = 0; c < channels; ++c )
+			{
+				float input = expected[frame * channels + c];
+				float delayed = history[read * channels + c];
+				history[write * channels + c] = input + 0.5f * delayed;
+				expected[frame * channels + c] = 0.75f * input + 0.25f * delayed;
+			}
+			write = (write + 1) % LineFrames;
+		}
+
+		Compare( "ProcessDelay", channels, frames, &expected[0], &actual[0], channels * frames, 1e-6f );
+		Compare( "ProcessDelay line", channels, frames, &history[0], &line[0], LineFrames * channels, 1e-6f );
+		if( writeFrame != write )
+		{
+			printf( "%-16s %u channels, %u frames: write frame is %u, expected %u\n", "ProcessDelay", channels, frames, writeFrame, write );
+			++failures;
+		}
+	}
+}
+
+static void CheckLevels( unsigned int channels, unsigned int frames )
+{
+	std::vector<float> input = Noise( channels * frames );
+	std::vector<float> peaks( channels ), rms( channels );
+	std::vector<float> expectedPeaks( channels ), expectedRms( channels );
+
+	for( unsigned int c = 0; c < channels; ++c )
+	{
+		double peak = 0.0, sum = 0.0;
+		for( unsigned int frame = 0; frame < frames; ++frame )
+		{
+			double x = fabs( input[frame * channels + c] );
+			peak = x > peak ? x : peak;
+			sum += x * x;
+		}
+
+		expectedPeaks[c] = static_cast<float>( peak );
+		expectedRms[c] = frames > 0 ? static_cast<float>( sqrt( sum / frames ) ) : 0.0f;
+	}
+
+	MeasureLevels( &input[0], channels, frames, &peaks[0], &rms[0] );
+	Compare( "MeasureLevels peak", channels, frames, &expectedPeaks[0], &peaks[0], channels, 0.0f );
+	Compare( "MeasureLevels rms", channels, frames, &expectedRms[0], &rms[0], channels, 1e-5f );
+}
+
+static void CheckInterleave( unsigned int channels, unsigned int frames )
+{
+	std::vector<float> input = Noise( channels * frames );
+	std::vector<float> output( channels * frames + 1 );
+	std::vector< std::vector<float> > planes( channels, std::vector<float>( frames + 1 ) );
+	std::vector<float*> pointers( channels );
+	std::vector<float> expected( channels * frames + 1 );
+
+	for( unsigned int c = 0; c < channels; ++c )
+		pointers[c] = &planes[c][0];
+
+	Deinterleave( &input[0], channels, frames, &pointers[0] );
+	for( unsigned int c = 0; c < channels; ++c )
+	{
+		for( unsigned int frame = 0; frame < frames; ++frame )
+			expected[frame] = input[frame * channels + c];
+		Compare( "Deinterleave", channels, frames, &expected[0], pointers[c], frames, 0.0f );
+	}
+
+	Interleave( &pointers[0], channels, frames, &output[0] );
+	Compare( "Interleave", channels, frames, &input[0], &output[0], channels * frames, 0.0f );
+}
+
+int main()
+{
+	for( unsigned int f = 0; f < FrameCountCount; ++f )
+	{
+		unsigned int frames = FrameCounts[f];
+		for( unsigned int i = 0; i < ChannelCountCount; ++i )
+		{
+			unsigned int channels = ChannelCounts[i];
+			CheckGainRamp( channels, frames );
+			CheckBiquads( channels, frames );
+			CheckDelay( channels, frames );
+			CheckLevels( channels, frames );
+			CheckInterleave( channels, frames );
+
+			for( unsigned int j = 0; j < ChannelCountCount; ++j )
+				CheckMixMatrix( ChannelCounts[j], channels, frames );
+		}
+	}
+
+	if( failures > 0 )
+	{
+		printf( "%u mismatches\n", failures );
+		return 1;
+	}
+
+	printf( "all kernels match the scalar reference\n" );
+	return 0;
+}